@@ -28,6 +28,7 @@
  
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/SourceOctree.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
@@ -66,7 +67,9 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 			  numprocessors_(Parallel::NumCores()),
 			  barrier_("BSV KernelBase Barrier", numprocessors_),
 			  typeOut(t),
-			  matOut(0)
+			  matOut(0),
+			  treeTolerance(-1.0),
+			  treeScale(1.0)
 			{
 			}
 			
@@ -78,6 +81,12 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 			virtual bool Integrate(FieldHandle& mesh, FieldHandle& coil, MatrixHandle& outdata) = 0;
 
 	
+			//! Sum the sources through a SourceOctree with the given tolerance, a negative one sums them directly
+			void SetTreeCodeTolerance(double tolerance)
+			{
+				treeTolerance = tolerance;
+			}
+
 			//! Global reference counting
 			int ref_cnt;
 			
@@ -106,6 +115,38 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 			DenseMatrix *matOut;
 			MatrixHandle matOutHandle;
 
+			//! tree-code summation, the kernels fill the tree instead of summing directly
+			double treeTolerance;
+			double treeScale;
+			std::unique_ptr<SourceOctree> tree;
+
+			bool UseTreeCode() const
+			{
+				return treeTolerance >= 0.0;
+			}
+
+			//! Complexity O(M*log(N)), the model nodes are handed out dynamically as their cost varies
+			bool EvaluateTree(MatrixHandle& outdata)
+			{
+				tree->build();
+
+				Parallel::For(0, modelSize, [this](size_t first, size_t last)
+				{
+					Point modelNode;
+					for (size_t iM = first; iM < last; iM++)
+					{
+						vmesh->get_node(modelNode, VMesh::Node::index_type(iM));
+						const Vector F = treeScale * tree->evaluate(modelNode);
+
+						matOut->put(iM,0, F[0]);
+						matOut->put(iM,1, F[1]);
+						matOut->put(iM,2, F[2]);
+					}
+				});
+
+				return PostIntegration(outdata);
+			}
+
 			bool PreIntegration( FieldHandle& mesh, FieldHandle& coil )
 			{
 					this->vmesh = mesh->vmesh();
@@ -224,6 +265,15 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 						coilNodes.push_back(Vector(enode2));
 					}
 
+					if (UseTreeCode())
+					{
+						//! the constants are the ones of ParallelKernel
+						tree.reset(new SourceOctree(typeOut == 1 ? SourceOctree::CROSS_R3 : SourceOctree::INVERSE_R1, treeTolerance));
+						treeScale = 1.0e-7;
+						AddSegmentSources();
+						return EvaluateTree(outdata);
+					}
+
 					//! Start the multi threaded
 					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 					
@@ -252,6 +302,57 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
 				//! keep nodes on the coil cached
 				std::vector<Vector> coilNodes;
+
+				//! every integration step of the coil becomes a source, discretized as in ParallelKernel
+				void AddSegmentSources()
+				{
+					double current = 1.0;
+					double prevSegLen = 123456789.12345678;
+					int nips = 0;
+					std::vector<Vector> integrPoints;
+
+					for( size_t iC0 = 0, iC1 =1, iCV = 0;
+						iC0 < coilNodes.size();
+						iC0+=2, iC1+=2, iCV++)
+					{
+						vcoilField->get_value(current,iCV);
+						current = current == 0.0 ? 1.0 : current;
+
+						const Vector& coilNodeThis = current >= 0.0 ? coilNodes[iC0] : coilNodes[iC1];
+						const Vector& coilNodeNext = current >= 0.0 ? coilNodes[iC1] : coilNodes[iC0];
+
+						double newSegLen = (coilNodeNext - coilNodeThis).length();
+
+						if(extstep > 0)
+						{
+							nips = newSegLen / extstep;
+						}
+						else if( Abs(prevSegLen - newSegLen ) > 0.00000001 )
+						{
+							prevSegLen = newSegLen;
+							nips =  AdjustNumberOfIntegrationPoints(newSegLen);
+						}
+
+						if( nips < 3 )
+						{
+							algo_->warning("integration step too big");
+						}
+
+						integrPoints.clear();
+						for(int iip = 0; iip < nips; iip++)
+						{
+							double interpolant = static_cast<double>(iip) / static_cast<double>(nips);
+							integrPoints.push_back( Interpolate( coilNodeThis, coilNodeNext, interpolant ) );
+						}
+
+						for(int iip = 0; iip < nips -1; iip++)
+						{
+							Vector center = (integrPoints[iip] + integrPoints[iip+1] ) / 2;
+							Vector dLxyz = integrPoints[iip+1] - integrPoints[iip];
+							tree->insert(Point(center), dLxyz * Abs(current));
+						}
+					}
+				}
 				
 				//! execute in parallel
 				void ParallelKernel(int proc_num)
@@ -478,6 +579,23 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 					
 					vmesh->synchronize(Mesh::NODES_E | Mesh::EDGES_E);					
 
+					if (UseTreeCode())
+					{
+						tree.reset(new SourceOctree(typeOut == 1 ? SourceOctree::CROSS_R1 : SourceOctree::INVERSE_R1, treeTolerance));
+						//! ParallelKernel sums current x (center - node), the tree uses node - center
+						treeScale = (typeOut == 1 ? -1.0 : 1.0) / (4.0 * M_PI);
+
+						Point coilCenter;
+						Vector current;
+						for(VMesh::Elem::index_type  iC = 0; iC < coilSize; iC++)
+						{
+							vcoilField->get_value(current,iC);
+							vcoilField->get_center(coilCenter, iC);
+							tree->insert(coilCenter, current * vcoil->get_volume(iC));
+						}
+						return EvaluateTree(outdata);
+					}
+
 					//! Start the multi threaded
 					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 					
@@ -606,6 +724,22 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 					//needed?
 					vmesh->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 										
+					if (UseTreeCode())
+					{
+						tree.reset(new SourceOctree(typeOut == 1 ? SourceOctree::DIPOLE_FIELD : SourceOctree::CROSS_R3, treeTolerance));
+						//! ParallelKernel sums moment x (location - node), the tree uses node - location
+						treeScale = typeOut == 1 ? 1.0e-7 : -1.0e-7;
+
+						Point dipoleLocation;
+						Vector dipoleMoment;
+						for(VMesh::Elem::index_type  iC = 0; iC < coilSize; iC++)
+						{
+							vcoilField->get_value(dipoleMoment,iC);
+							vcoilField->get_center(dipoleLocation, iC);
+							tree->insert(dipoleLocation, dipoleMoment);
+						}
+						return EvaluateTree(outdata);
+					}
 
 					//! Start the multi threaded
 					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
@@ -722,12 +856,15 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
    return (false);
   }
 	  
+  const double treeTolerance = get(Parameters::UseTreeCode).toBool() ? get(Parameters::TreeCodeTolerance).toDouble() : -1.0;
+
   if( coil->vmesh()->is_curvemesh() )
   {
     if(coil->vfield()->is_constantdata() && coil->vfield()->is_scalar())
     {
       auto pwk = std::unique_ptr<KernelBase>(new PieceWiseKernel(this, outtype));
       //pwk->SetIntegrationStep(this->istep);
+      pwk->SetTreeCodeTolerance(treeTolerance);
       if( !pwk->Integrate(mesh,coil,outdata) )
       {
        error("Aborted during integration");
@@ -745,6 +882,7 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
    if((coil->vfield()->is_lineardata() || coil->vfield()->is_constantdata() ) && coil->vfield()->is_vector())
    {
     auto dp = std::unique_ptr<KernelBase>(new DipolesKernel(this, outtype));
+    dp->SetTreeCodeTolerance(treeTolerance);
     if( !dp->Integrate(mesh,coil,outdata) )
       {
        error("Aborted during integration");
@@ -762,6 +900,7 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
    if(  coil->vfield()->is_constantdata() && coil->vfield()->is_vector() )
    {
    auto vp = std::unique_ptr<KernelBase>(new VolumetricKernel(this, outtype));
+   vp->SetTreeCodeTolerance(treeTolerance);
    if( !vp->Integrate(mesh,coil,outdata) )
       {
        error("Aborted during integration");
@@ -41,9 +41,11 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/Logging/ScopedTimeRemarker.h>
 #include <Core/Logging/Log.h>
 #include <Core/Algorithms/BrainStimulator/SimulateForwardMagneticFieldAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/SourceOctree.h>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -60,12 +62,18 @@ AlgorithmInputName SimulateForwardMagneticFieldAlgo::DetectorLocations("Detector
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticField("MagneticField");
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticFieldMagnitudes("MagneticFieldMagnitudes");
 
+SimulateForwardMagneticFieldAlgo::SimulateForwardMagneticFieldAlgo()
+{
+  addParameter(Parameters::UseTreeCode, false);
+  addParameter(Parameters::TreeCodeTolerance, 0.3);
+}
+
 class CalcFMField
 {
   public:
 
-    CalcFMField(const AlgorithmBase* algo) : algo_(algo),
-      np_(-1),efld_(0),ctfld_(0),dipfld_(0),detfld_(0),emsh_(0),ctmsh_(0),dipmsh_(0),detmsh_(0),magfld_(0),magmagfld_(0)
+    CalcFMField(const AlgorithmBase* algo, bool use_tree, double tolerance) : algo_(algo),
+      np_(-1),use_tree_(use_tree),tolerance_(tolerance),efld_(0),ctfld_(0),dipfld_(0),detfld_(0),emsh_(0),ctmsh_(0),dipmsh_(0),detmsh_(0),magfld_(0),magmagfld_(0)
     {
     }
 
@@ -77,6 +85,7 @@ class CalcFMField
   private:
     void interpolate(int proc, Point p);
     void set_up_cell_cache();
+    void set_up_source_tree();
     void calc_parallel(int proc);
 
     const AlgorithmBase* algo_;
@@ -93,6 +102,11 @@ class CalcFMField
 
     std::vector<per_cell_cache>  cell_cache_;
 
+    // cells and dipoles summed through an octree instead of one by one
+    bool use_tree_;
+    double tolerance_;
+    std::unique_ptr<SourceOctree> tree_;
+
     VField* efld_; // Electric Field
     VField* ctfld_; // Conductivity Field
     VField* dipfld_; // Dipole Field
@@ -186,6 +200,38 @@ void CalcFMField::set_up_cell_cache()
   }
 }
 
+void CalcFMField::set_up_source_tree()
+{
+  tree_.reset(new SourceOctree(SourceOctree::CROSS_R3, tolerance_));
+
+  VMesh::size_type num_elems = emsh_->num_elems();
+  VMesh::Node::array_type nodes;
+  Point pt;
+  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+  {
+    const per_cell_cache &c = cell_cache_[idx];
+    double radius = 0.0;
+    emsh_->get_nodes(nodes,idx);
+    for (size_t k=0; k<nodes.size(); k++)
+    {
+      emsh_->get_point(pt,nodes[k]);
+      radius = std::max(radius, (pt - c.center_).length());
+    }
+    tree_->insert(c.center_, c.cur_density_ * c.volume_, radius);
+  }
+
+  VMesh::size_type num_dipoles = dipmsh_->num_nodes();
+  Vector P;
+  for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+  {
+    dipmsh_->get_center(pt, dip_idx);
+    dipfld_->value(P,dip_idx);
+    tree_->insert(pt, P);
+  }
+
+  tree_->build();
+}
+
 void CalcFMField::calc_parallel(int proc)
 {
 
@@ -211,26 +257,36 @@ void CalcFMField::calc_parallel(int proc)
 
     detmsh_->get_center(pt, idx);
 
-    // init the interp val to 0
-    interp_value_[proc] = Vector(0,0,0);
-    interpolate(proc, pt);
-
-    mag_field = interp_value_[proc];
-
     Vector normal;
     detfld_->get_value(normal,idx);
 
-    // iterate over the dipoles.
-    for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+    if (tree_)
+    {
+      // the cell holding the detector is left out, as in interpolate()
+      VMesh::Elem::index_type inside_cell = 0;
+      bool outside = !(emsh_->locate(inside_cell, pt));
+      mag_field = tree_->evaluate(pt, outside ? -1 : static_cast<index_type>(inside_cell));
+    }
+    else
     {
-      dipmsh_->get_center(pt2, dip_idx);
-      dipfld_->value(P,dip_idx);
+      // init the interp val to 0
+      interp_value_[proc] = Vector(0,0,0);
+      interpolate(proc, pt);
 
-      Vector radius = pt - pt2; // detector - source
-      Vector valuePXR = Cross(P, radius);
-      double length = radius.length();
+      mag_field = interp_value_[proc];
 
-      mag_field += valuePXR / (length * length * length);
+      // iterate over the dipoles.
+      for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+      {
+        dipmsh_->get_center(pt2, dip_idx);
+        dipfld_->value(P,dip_idx);
+
+        Vector radius = pt - pt2; // detector - source
+        Vector valuePXR = Cross(P, radius);
+        double length = radius.length();
+
+        mag_field += valuePXR / (length * length * length);
+      }
     }
 
     mag_field *= one_over_4_pi;
@@ -303,6 +359,12 @@ boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(F
   // cache per cell calculations that are used over and over again.
   set_up_cell_cache();
 
+  if (use_tree_)
+  {
+    emsh_->synchronize(Mesh::ELEM_LOCATE_E);
+    set_up_source_tree();
+  }
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // do the parallel work.
   Thread::parallel(this, &CalcFMField::calc_parallel, np_, mod);
@@ -336,7 +398,7 @@ boost::tuple<FieldHandle, FieldHandle> SimulateForwardMagneticFieldAlgo::run(Fie
     THROW_ALGORITHM_INPUT_ERROR("Must have Vector field as Detector Locations input");
   }
 
-  CalcFMField algo(this);
+  CalcFMField algo(this, get(Parameters::UseTreeCode).toBool(), get(Parameters::TreeCodeTolerance).toDouble());
   FieldHandle MField, MFieldMagnitudes;
 
   boost::tie(MField,MFieldMagnitudes) = algo.calc_forward_magnetic_field(ElectricField, ConductivityTensors, DipoleSources, DetectorLocations);
@@ -36,6 +36,7 @@
 ///  The modules has four inputs: an electric field distribution (first) for mesh elements with defnied conductivity tensors (second), dipole sources (third)
 ///  within that mesh and detector locations (fourth) to compute the magnetic field at. All inputs are of Field datatype. The algorithm/module is multi-threaded and
 ///  outputs the magnetic vector potential and its magnitudes as first and second output.
+///  With UseTreeCode set the cells and dipoles are summed through a SourceOctree, TreeCodeTolerance trades accuracy for speed.
 
 #ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_SIMULATEFORWARDMAGNETICFIELD_H
 #define CORE_ALGORITHMS_BRAINSTIMULATOR_SIMULATEFORWARDMAGNETICFIELD_H 1
@@ -53,7 +54,8 @@ namespace SCIRun {
 class SCISHARE SimulateForwardMagneticFieldAlgo : public AlgorithmBase
 {
   public:
-    
+    SimulateForwardMagneticFieldAlgo();
+
     static AlgorithmInputName ElectricField;
     static AlgorithmInputName ConductivityTensor;
     static AlgorithmInputName DipoleSources;
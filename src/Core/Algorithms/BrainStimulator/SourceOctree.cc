@@ -0,0 +1,303 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVEN09/17T SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/BrainStimulator/SourceOctree.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+ALGORITHM_PARAMETER_DEF(BrainStimulator, UseTreeCode);
+ALGORITHM_PARAMETER_DEF(BrainStimulator, TreeCodeTolerance);
+
+namespace
+{
+  /// Deeper than this only coincident sources are left
+  const int max_depth = 32;
+}
+
+SourceOctree::SourceOctree(Kernel kernel, double tolerance) :
+  kernel_(kernel), tolerance_(std::min(std::max(tolerance, 0.0), 1.0))
+{
+}
+
+void SourceOctree::insert(const Point& position, const Vector& weight, double radius)
+{
+  position_.push_back(Vector(position));
+  weight_.push_back(weight);
+  radius_.push_back(radius);
+}
+
+void SourceOctree::build(size_type leafSize)
+{
+  cells_.clear();
+  const size_type num = num_sources();
+  index_.resize(num);
+  for (index_type i = 0; i < num; i++) index_[i] = i;
+  if (num == 0) return;
+  if (leafSize < 1) leafSize = 1;
+
+  Vector lo = position_[0], hi = position_[0];
+  for (index_type i = 1; i < num; i++)
+  {
+    lo = Min(lo, position_[i]);
+    hi = Max(hi, position_[i]);
+  }
+  const double width = std::max(std::max(hi.x() - lo.x(), hi.y() - lo.y()), hi.z() - lo.z());
+
+  // Boxes are kept next to the cells while building, every cell is split in eight at the middle of its box
+  struct Box { Vector lo; double width; int depth; };
+  std::vector<Box> boxes;
+
+  Cell root;
+  root.first = 0;
+  root.count = num;
+  root.child = -1;
+  root.num_children = 0;
+  cells_.push_back(root);
+  Box rootBox = { lo, width, 0 };
+  boxes.push_back(rootBox);
+
+  std::vector<index_type> order(num);
+  std::vector<int> octant(num);
+  for (size_t c = 0; c < cells_.size(); c++)
+  {
+    const Box box = boxes[c];
+    const index_type first = cells_[c].first;
+    const size_type count = cells_[c].count;
+    if (count <= leafSize || box.depth >= max_depth) continue;
+
+    const Vector mid = box.lo + Vector(1, 1, 1) * (0.5 * box.width);
+    size_type per_octant[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    for (index_type i = first; i < first + count; i++)
+    {
+      const Vector& p = position_[index_[i]];
+      octant[i] = (p.x() > mid.x() ? 1 : 0) + (p.y() > mid.y() ? 2 : 0) + (p.z() > mid.z() ? 4 : 0);
+      per_octant[octant[i]]++;
+    }
+
+    index_type start[8];
+    start[0] = first;
+    for (int o = 1; o < 8; o++) start[o] = start[o - 1] + per_octant[o - 1];
+
+    index_type next[8];
+    std::copy(start, start + 8, next);
+    for (index_type i = first; i < first + count; i++) order[next[octant[i]]++] = index_[i];
+    std::copy(order.begin() + first, order.begin() + first + count, index_.begin() + first);
+
+    // Children are stored next to each other, a leaf has no children
+    cells_[c].child = static_cast<index_type>(cells_.size());
+    for (int o = 0; o < 8; o++)
+    {
+      if (per_octant[o] == 0) continue;
+      Cell cell;
+      cell.first = start[o];
+      cell.count = per_octant[o];
+      cell.child = -1;
+      cell.num_children = 0;
+      cells_.push_back(cell);
+      cells_[c].num_children++;
+
+      const double half = 0.5 * box.width;
+      Box child = { box.lo + Vector((o & 1) ? half : 0.0, (o & 2) ? half : 0.0, (o & 4) ? half : 0.0), half, box.depth + 1 };
+      boxes.push_back(child);
+    }
+  }
+
+  // Store the sources in leaf order so a cell reads contiguous memory
+  std::vector<Vector> position(num), weight(num);
+  std::vector<double> radius(num);
+  for (index_type i = 0; i < num; i++)
+  {
+    position[i] = position_[index_[i]];
+    weight[i] = weight_[index_[i]];
+    radius[i] = radius_[index_[i]];
+  }
+  position_.swap(position);
+  weight_.swap(weight);
+  radius_.swap(radius);
+
+  index_type grid = 0;
+  for (auto& cell : cells_)
+  {
+    cell.grid = cell.count > grid_size ? grid : -1;
+    if (cell.grid >= 0) grid += grid_size;
+  }
+  grid_weight_.assign(grid, Vector(0, 0, 0));
+
+  Parallel::For(0, cells_.size(), [this](size_t first, size_t last)
+  {
+    for (size_t c = first; c < last; c++) setUpCell(cells_[c]);
+  });
+}
+
+void SourceOctree::gridPoints(const Cell& cell, double points[3][grid_points]) const
+{
+  const Vector half = 0.5 * (cell.hi - cell.lo);
+  for (int k = 0; k < grid_points; k++)
+  {
+    const double c = std::cos(k * M_PI / (grid_points - 1));
+    for (int d = 0; d < 3; d++) points[d][k] = cell.center[d] + c * half[d];
+  }
+}
+
+void SourceOctree::setUpCell(Cell& cell)
+{
+  Vector lo = position_[cell.first], hi = position_[cell.first];
+  for (index_type i = cell.first + 1; i < cell.first + cell.count; i++)
+  {
+    lo = Min(lo, position_[i]);
+    hi = Max(hi, position_[i]);
+  }
+
+  // Keep the grid from collapsing along an axis on which all sources line up
+  const Vector width = hi - lo;
+  const double min_width = 1e-3 * std::max(std::max(std::max(width.x(), width.y()), width.z()), 1e-9);
+  for (int d = 0; d < 3; d++)
+  {
+    if (width[d] < min_width)
+    {
+      lo[d] -= 0.5 * min_width;
+      hi[d] += 0.5 * min_width;
+    }
+  }
+
+  cell.lo = lo;
+  cell.hi = hi;
+  cell.center = 0.5 * (lo + hi);
+  cell.size = 0.0;
+  for (index_type i = cell.first; i < cell.first + cell.count; i++)
+    cell.size = std::max(cell.size, (position_[i] - cell.center).length() + radius_[i]);
+
+  if (cell.grid < 0) return;
+
+  // Spread every weight over the grid with the Lagrange polynomials through the grid points, in barycentric form
+  double points[3][grid_points];
+  gridPoints(cell, points);
+
+  double barycentric[grid_points];
+  for (int k = 0; k < grid_points; k++)
+    barycentric[k] = ((k % 2) ? -1.0 : 1.0) * ((k == 0 || k == grid_points - 1) ? 0.5 : 1.0);
+
+  Vector* grid_weight = &grid_weight_[cell.grid];
+  double L[3][grid_points];
+  for (index_type i = cell.first; i < cell.first + cell.count; i++)
+  {
+    for (int d = 0; d < 3; d++)
+    {
+      const double x = position_[i][d];
+      double sum = 0.0;
+      int exact = -1;
+      for (int k = 0; k < grid_points; k++)
+      {
+        if (x == points[d][k]) exact = k;
+        L[d][k] = barycentric[k] / (x - points[d][k]);
+        sum += L[d][k];
+      }
+      for (int k = 0; k < grid_points; k++)
+        L[d][k] = exact < 0 ? L[d][k] / sum : (k == exact ? 1.0 : 0.0);
+    }
+
+    const Vector& m = weight_[i];
+    for (int a = 0; a < grid_points; a++)
+      for (int b = 0; b < grid_points; b++)
+      {
+        const double Lab = L[0][a] * L[1][b];
+        for (int c = 0; c < grid_points; c++)
+          grid_weight[(a * grid_points + b) * grid_points + c] += (Lab * L[2][c]) * m;
+      }
+  }
+}
+
+Vector SourceOctree::field(const Vector& r, const Vector& m) const
+{
+  const double s2 = r.length2();
+  const double s = std::sqrt(s2);
+  switch (kernel_)
+  {
+    case CROSS_R3: return Cross(m, r) / (s2 * s);
+    case CROSS_R1: return Cross(m, r) / s;
+    case INVERSE_R1: return m / s;
+    case DIPOLE_FIELD: return 3 * r * Dot(m, r) / (s2 * s2 * s) - m / (s2 * s);
+  }
+  return Vector(0, 0, 0);
+}
+
+Vector SourceOctree::evaluate(const Point& target, index_type skip) const
+{
+  Vector result(0, 0, 0);
+  if (cells_.empty()) return result;
+
+  const Vector t(target);
+  index_type stack[8 * max_depth + 8];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const Cell& cell = cells_[stack[--top]];
+    const double distance = (t - cell.center).length();
+
+    if (cell.grid >= 0 && cell.size < tolerance_ * distance)
+    {
+      double points[3][grid_points];
+      gridPoints(cell, points);
+      const Vector* grid_weight = &grid_weight_[cell.grid];
+      for (int a = 0; a < grid_points; a++)
+        for (int b = 0; b < grid_points; b++)
+          for (int c = 0; c < grid_points; c++)
+          {
+            const Vector p(points[0][a], points[1][b], points[2][c]);
+            result += field(t - p, grid_weight[(a * grid_points + b) * grid_points + c]);
+          }
+    }
+    else if (cell.num_children == 0)
+    {
+      for (index_type i = cell.first; i < cell.first + cell.count; i++)
+        if (index_[i] != skip) result += field(t - position_[i], weight_[i]);
+    }
+    else
+    {
+      for (int c = 0; c < cell.num_children; c++) stack[top++] = cell.child + c;
+    }
+  }
+  return result;
+}
+
+Vector SourceOctree::evaluateDirect(const Point& target, index_type skip) const
+{
+  Vector result(0, 0, 0);
+  const Vector t(target);
+  for (index_type i = 0; i < num_sources(); i++)
+    if (index_[i] != skip) result += field(t - position_[i], weight_[i]);
+  return result;
+}
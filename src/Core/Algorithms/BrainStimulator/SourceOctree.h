@@ -0,0 +1,118 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVEN09/17T SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+///@file SourceOctree.h
+///@brief Tree-code summation of the fields of many point sources.
+///
+///@details
+///  The sources are sorted into an octree. The sources of a cell are interpolated onto a grid of Chebyshev points
+///  spanning the cell, so that a cell that is far from the target can stand in for all of its sources through the
+///  weights on its grid points (a barycentric Lagrange tree-code). A cell is far when its size is less than the
+///  tolerance times its distance to the target; the error falls off quickly with the tolerance. Only the kernel
+///  itself is needed, so the same tree serves every kernel. A tolerance of zero opens every cell and gives the
+///  direct sum.
+
+#ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_SOURCEOCTREE_H
+#define CORE_ALGORITHMS_BRAINSTIMULATOR_SOURCEOCTREE_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <vector>
+#include <Core/Algorithms/BrainStimulator/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace BrainStimulator {
+
+  /// Shared by the algorithms that can evaluate their sources through a SourceOctree
+  ALGORITHM_PARAMETER_DECL(UseTreeCode);
+  ALGORITHM_PARAMETER_DECL(TreeCodeTolerance);
+
+  class SCISHARE SourceOctree
+  {
+  public:
+    /// Field of a source with weight m, seen from r = target - source
+    enum Kernel
+    {
+      CROSS_R3,     ///< m x r / |r|^3: field of a current element, vector potential of a magnetic dipole
+      CROSS_R1,     ///< m x r / |r|
+      INVERSE_R1,   ///< m / |r|: vector potential of a current element
+      DIPOLE_FIELD  ///< 3 r (m.r) / |r|^5 - m / |r|^3: field of a magnetic dipole
+    };
+
+    SourceOctree(Kernel kernel, double tolerance);
+
+    /// radius bounds the extent of the source around its position, targets within it never see the source
+    /// through a cell
+    void insert(const Geometry::Point& position, const Geometry::Vector& weight, double radius = 0.0);
+    void build(size_type leafSize = grid_size);
+
+    /// Sum of the fields of all sources but the one inserted as number skip
+    Geometry::Vector evaluate(const Geometry::Point& target, index_type skip = -1) const;
+    Geometry::Vector evaluateDirect(const Geometry::Point& target, index_type skip = -1) const;
+
+    size_type num_sources() const { return static_cast<size_type>(position_.size()); }
+
+  private:
+    /// Chebyshev points per axis of the interpolation grid of a cell
+    static const int grid_points = 4;
+    static const int grid_size = grid_points * grid_points * grid_points;
+
+    struct Cell
+    {
+      index_type first;
+      size_type count;
+      index_type child;
+      int num_children;
+      Geometry::Vector lo, hi;
+      Geometry::Vector center;
+      double size;
+      /// offset into grid_weight_, cells with fewer sources than grid points are always summed directly
+      index_type grid;
+    };
+
+    Geometry::Vector field(const Geometry::Vector& r, const Geometry::Vector& m) const;
+    void gridPoints(const Cell& cell, double points[3][grid_points]) const;
+    void setUpCell(Cell& cell);
+
+    Kernel kernel_;
+    double tolerance_;
+    std::vector<Geometry::Vector> position_;
+    std::vector<Geometry::Vector> weight_;
+    std::vector<double> radius_;
+    std::vector<index_type> index_;
+    std::vector<Cell> cells_;
+    std::vector<Geometry::Vector> grid_weight_;
+  };
+
+}}}}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVEN09/17T SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Circular loop of radius 0.5 above the [-1,1] cube
+  FieldHandle LoopCoil(int segments)
+  {
+    FieldInformation fi("CurveMesh", 0, "double");
+    FieldHandle coil = CreateField(fi);
+    VMesh* mesh = coil->vmesh();
+    for (int i = 0; i < segments; i++)
+    {
+      const double a = 2 * M_PI * i / segments;
+      mesh->add_point(Point(0.5 * cos(a), 0.5 * sin(a), 1.5));
+    }
+
+    VMesh::Node::array_type edge(2);
+    for (int i = 0; i < segments; i++)
+    {
+      edge[0] = i;
+      edge[1] = (i + 1) % segments;
+      mesh->add_elem(edge);
+    }
+
+    coil->vfield()->resize_values();
+    coil->vfield()->set_all_values(1.0);
+    return coil;
+  }
+
+  // Grid of magnetic dipoles above the cube, all pointing down
+  FieldHandle DipoleCoil(int n)
+  {
+    FieldInformation fi("PointCloudMesh", 1, "vector");
+    FieldHandle coil = CreateField(fi);
+    VMesh* mesh = coil->vmesh();
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        mesh->add_point(Point(-0.5 + i / (n - 1.0), -0.5 + j / (n - 1.0), 1.5));
+
+    coil->vfield()->resize_values();
+    coil->vfield()->set_all_values(Vector(0, 0, -1));
+    return coil;
+  }
+
+  double RelativeDifference(const MatrixHandle& a, const MatrixHandle& b)
+  {
+    auto da = castMatrix::toDense(a);
+    auto db = castMatrix::toDense(b);
+    return (*da - *db).norm() / db->norm();
+  }
+
+  void ExpectTreeCodeMatchesDirectSum(FieldHandle coil)
+  {
+    FieldHandle head = CreateEmptyLatVol(8, 8, 8);
+
+    for (int outtype = 1; outtype <= 2; outtype++)
+    {
+      BiotSavartSolverAlgorithm algo;
+      MatrixHandle direct, tree;
+      ASSERT_TRUE(algo.run(head, coil, direct, outtype));
+
+      algo.set(Parameters::UseTreeCode, true);
+      algo.set(Parameters::TreeCodeTolerance, 0.3);
+      ASSERT_TRUE(algo.run(head, coil, tree, outtype));
+
+      ASSERT_EQ(direct->nrows(), tree->nrows());
+      EXPECT_LT(RelativeDifference(tree, direct), 1e-3);
+
+      algo.set(Parameters::TreeCodeTolerance, 0.0);
+      ASSERT_TRUE(algo.run(head, coil, tree, outtype));
+      EXPECT_LT(RelativeDifference(tree, direct), 1e-12);
+    }
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTests, TreeCodeMatchesDirectSumForACurrentLoop)
+{
+  ExpectTreeCodeMatchesDirectSum(LoopCoil(32));
+}
+
+TEST(BiotSavartSolverAlgorithmTests, TreeCodeMatchesDirectSumForDipoles)
+{
+  ExpectTreeCodeMatchesDirectSum(DipoleCoil(20));
+}
@@ -34,6 +34,7 @@ last change: 09/17/2014
 #include <Core/Algorithms/Legacy/Fields/FieldData/SetFieldData.h>
 #include <Core/Algorithms/Legacy/Fields/FieldData/GetFieldData.h>
 #include <Core/Algorithms/BrainStimulator/SimulateForwardMagneticFieldAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/SourceOctree.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -45,6 +46,7 @@ last change: 09/17/2014
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
@@ -128,3 +130,55 @@ TEST(SimulateForwardMagneticFieldAlgoTest, TestOnLatVol)
   EXPECT_MATRIX_EQ_TOLERANCE(*MField_matrix, *MField_expected_matrix, 1e-16);
   EXPECT_MATRIX_EQ_TOLERANCE(*MFieldMagnitudes_matrix, *MFieldMagnitudes_expected_matrix, 1e-16);
 }
+
+TEST(SimulateForwardMagneticFieldAlgoTest, TreeCodeMatchesDirectSum)
+{
+  FieldHandle latVol = CreateEmptyLatVol(12, 12, 12);
+
+  FieldInformation efi(LATVOLMESH_E, CONSTANTDATA_E, VECTOR_E);
+  FieldHandle efield = CreateField(efi, latVol->mesh());
+  efield->vfield()->resize_values();
+  for (VMesh::index_type idx = 0; idx < efield->vfield()->num_values(); idx++)
+    efield->vfield()->set_value(Core::Geometry::Vector(sin(0.1 * idx), cos(0.3 * idx), 1.0), idx);
+
+  FieldInformation cfi(LATVOLMESH_E, CONSTANTDATA_E, DOUBLE_E);
+  FieldHandle conductivity = CreateField(cfi, latVol->mesh());
+  conductivity->vfield()->resize_values();
+  conductivity->vfield()->set_all_values(0.33);
+
+  FieldInformation pfi(POINTCLOUDMESH_E, LINEARDATA_E, VECTOR_E);
+  FieldHandle dipoles = CreateField(pfi);
+  for (int k = 0; k < 20; k++)
+    dipoles->vmesh()->add_point(Core::Geometry::Point(-0.5 + 0.05 * k, 0.2, 0.1 * (k % 3)));
+  dipoles->vfield()->resize_values();
+  dipoles->vfield()->set_all_values(Core::Geometry::Vector(0, 1, 0));
+
+  // Detectors on a sphere around the cube and a few inside it, where the cell holding them is left out
+  FieldHandle detectors = CreateField(pfi);
+  for (int k = 0; k < 50; k++)
+  {
+    const double a = 0.7 * k, b = 0.13 * k;
+    detectors->vmesh()->add_point(Core::Geometry::Point(2.5 * cos(a) * sin(b), 2.5 * sin(a) * sin(b), 2.5 * cos(b)));
+  }
+  for (int k = 0; k < 5; k++)
+    detectors->vmesh()->add_point(Core::Geometry::Point(0.13 * k, -0.21 * k, 0.5));
+  detectors->vfield()->resize_values();
+  detectors->vfield()->set_all_values(Core::Geometry::Vector(0, 0, 1));
+
+  FieldHandle direct, tree, magnitudes;
+  SimulateForwardMagneticFieldAlgo algo;
+  boost::tie(direct, magnitudes) = algo.run(efield, conductivity, dipoles, detectors);
+  algo.set(Algorithms::BrainStimulator::Parameters::UseTreeCode, true);
+  boost::tie(tree, magnitudes) = algo.run(efield, conductivity, dipoles, detectors);
+
+  double error = 0.0, norm = 0.0;
+  Core::Geometry::Vector d, t;
+  for (VMesh::index_type idx = 0; idx < direct->vfield()->num_values(); idx++)
+  {
+    direct->vfield()->get_value(d, idx);
+    tree->vfield()->get_value(t, idx);
+    error += (t - d).length2();
+    norm += d.length2();
+  }
+  EXPECT_LT(std::sqrt(error / norm), 1e-3);
+}
@@ -0,0 +1,120 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVEN09/17T SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/SourceOctree.h>
+#include <Core/Math/MusilRNG.h>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+namespace
+{
+  // Sources in the unit cube with weights that mostly point along z, as from a coil or a dipole layer
+  void FillSources(SourceOctree& tree, int num)
+  {
+    MusilRNG rng(42);
+    for (int i = 0; i < num; i++)
+    {
+      Point p(rng(), rng(), rng());
+      Vector m(rng() - 0.5, rng() - 0.5, 1.0);
+      tree.insert(p, m);
+    }
+  }
+
+  // Targets on a sphere around the cube, the way detectors or head nodes lie outside the sources
+  std::vector<Point> Targets()
+  {
+    std::vector<Point> targets;
+    for (int i = 0; i < 40; i++)
+    {
+      const double a = 0.7 * i, b = 0.3 * i;
+      targets.push_back(Point(0.5, 0.5, 0.5) + 1.5 * Vector(cos(a) * sin(b), sin(a) * sin(b), cos(b)));
+    }
+    return targets;
+  }
+
+  double RelativeError(SourceOctree::Kernel kernel, double tolerance)
+  {
+    SourceOctree tree(kernel, tolerance);
+    FillSources(tree, 5000);
+    tree.build();
+
+    double error = 0.0, norm = 0.0;
+    for (const auto& t : Targets())
+    {
+      const Vector direct = tree.evaluateDirect(t);
+      error += (tree.evaluate(t) - direct).length2();
+      norm += direct.length2();
+    }
+    return std::sqrt(error / norm);
+  }
+}
+
+TEST(SourceOctreeTests, ZeroToleranceGivesTheDirectSum)
+{
+  SourceOctree tree(SourceOctree::CROSS_R3, 0.0);
+  FillSources(tree, 1000);
+  tree.build();
+  for (const auto& t : Targets())
+  {
+    const Vector direct = tree.evaluateDirect(t);
+    const Vector approx = tree.evaluate(t);
+    EXPECT_NEAR(0.0, (approx - direct).length(), 1e-12 * direct.length());
+  }
+}
+
+TEST(SourceOctreeTests, ErrorFallsWithTheTolerance)
+{
+  const SourceOctree::Kernel kernels[] = { SourceOctree::CROSS_R3, SourceOctree::CROSS_R1, SourceOctree::INVERSE_R1, SourceOctree::DIPOLE_FIELD };
+  for (auto kernel : kernels)
+  {
+    const double coarse = RelativeError(kernel, 0.5);
+    const double fine = RelativeError(kernel, 0.2);
+    EXPECT_LT(coarse, 1e-3);
+    EXPECT_LT(10 * fine, coarse);
+  }
+}
+
+TEST(SourceOctreeTests, SkippedSourceIsLeftOut)
+{
+  // A source with a large extent among many small ones, targets inside it must not see it through a cell
+  SourceOctree tree(SourceOctree::CROSS_R3, 0.5);
+  FillSources(tree, 2000);
+  tree.insert(Point(0.5, 0.5, 0.5), Vector(0, 0, 100), 0.2);
+  tree.build();
+
+  const Point target(0.6, 0.45, 0.5);
+  const Vector direct = tree.evaluateDirect(target, 2000);
+  const Vector with = tree.evaluateDirect(target);
+  EXPECT_GT((with - direct).length(), 0.5 * direct.length());
+  EXPECT_NEAR(0.0, (tree.evaluate(target, 2000) - direct).length(), 1e-3 * direct.length());
+  EXPECT_NEAR(0.0, (tree.evaluate(target) - with).length(), 1e-3 * with.length());
+}
@@ -0,0 +1,100 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Describe/EstimateDatatypeMemory.h>
+#include <Core/Datatypes/String.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::General;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  template <typename T>
+  size_t matrixBytes(const MatrixBase<T>& m)
+  {
+    auto sparse = dynamic_cast<const SparseRowMatrixGeneric<T>*>(&m);
+    if (sparse)
+    {
+      return static_cast<size_t>(sparse->nonZeros()) * (sizeof(T) + sizeof(index_type))
+        + (sparse->nrows() + 1) * sizeof(index_type);
+    }
+    return m.get_dense_size() * sizeof(T);
+  }
+
+  size_t fieldBytes(const Field& field)
+  {
+    size_t total = 0;
+    auto mesh = field.vmesh();
+    if (mesh && !mesh->is_regularmesh())
+    {
+      total += static_cast<size_t>(mesh->num_nodes()) * sizeof(Point);
+      if (mesh->is_unstructuredmesh())
+        total += static_cast<size_t>(mesh->num_elems()) * mesh->num_nodes_per_elem() * sizeof(index_type);
+    }
+
+    auto vfield = field.vfield();
+    if (vfield)
+    {
+      size_t valueSize = sizeof(double);
+      if (vfield->is_vector())
+        valueSize = sizeof(Vector);
+      else if (vfield->is_tensor())
+        valueSize = sizeof(Tensor);
+      total += static_cast<size_t>(vfield->num_values() + vfield->num_evalues()) * valueSize;
+    }
+    return total;
+  }
+}
+
+size_t EstimateDatatypeMemory::bytes(const DatatypeHandle& data) const
+{
+  if (!data)
+    return 0;
+
+  if (auto str = boost::dynamic_pointer_cast<String>(data))
+    return str->value().size();
+
+  if (auto mat = boost::dynamic_pointer_cast<Matrix>(data))
+    return matrixBytes(*mat);
+
+  if (auto cmat = boost::dynamic_pointer_cast<MatrixBase<complex>>(data))
+    return matrixBytes(*cmat);
+
+  if (auto field = boost::dynamic_pointer_cast<Field>(data))
+    return fieldBytes(*field);
+
+  return 0;
+}
@@ -39,7 +39,6 @@
    Requirements      : if dealing with refined Cleaver1 meshes this implementation requires lots of RAM memory (>= 16 GB).
    */
 #include <Core/Algorithms/Legacy/Fields/DomainFields/SplitFieldByDomainAlgo.h>
-#include <Core/Algorithms/Legacy/Fields/MergeFields/JoinFieldsAlgo.h>
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/GetFieldBoundaryAlgo.h>
 #include <Core/Algorithms/Field/RefineTetMeshLocallyAlgorithm.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -52,8 +51,10 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Utils/StringUtil.h>
 #include <Core/Logging/Log.h>
+#include <Core/Thread/Parallel.h>
 #include <vector>
 #include <iterator>
+#include <numeric>
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
@@ -62,6 +63,7 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun;
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Fields, RefineTetMeshLocallyIsoValue);
 ALGORITHM_PARAMETER_DEF(Fields, RefineTetMeshLocallyEdgeLength);
@@ -773,17 +775,54 @@ SparseRowMatrixHandle RefineTetMeshLocallyAlgorithm::ChoseEdgesToCut(FieldHandle
   return cut_edges;
 }
 
-/// TODO (DAN): this function should run in parallel too
+int RefineTetMeshLocallyAlgorithm::ChildTetNode(int main_case, int tet, int node)
+{
+  switch (main_case)
+  {
+    case 1: return Case1Lookup[tet][node];
+    case 2: return Case2aLookup[tet][node];
+    case 3: return Case2bLookup[tet][node];
+    case 4: return Case3aLookup[tet][node];
+    case 5: return Case3bLookup[tet][node];
+    case 6: return Case3cLookup[tet][node];
+    case 7: return Case4aLookup[tet][node];
+    case 8: return Case4bLookup[tet][node];
+    case 9: return Case5Lookup[tet][node];
+    case 10: return Case6Lookup[tet][node];
+    case 11: return Case3cNonNegativeLookup[tet][node];
+    case 12: return Case4aNonNegativeLookup[tet][node];
+  }
+  return 0;
+}
+
+namespace
+{
+  /// A node added by the refinement: the midpoint of the edge (a,b) with a < b, or the center of element b when a is -1.
+  /// slot is the position at which a new tet refers to it.
+  struct NewNodeKey
+  {
+    long a, b, slot;
+    bool operator<(const NewNodeKey& other) const
+    {
+      if (a != other.a) return a < other.a;
+      if (b != other.b) return b < other.b;
+      return slot < other.slot;
+    }
+  };
+}
+
+/// The tets are refined in two parallel passes: the first counts the new tets and the new nodes they refer to, the
+/// second writes them into preallocated arrays. New nodes are identified by their edge (or element) and sorting these
+/// keys gives each new node one index, even though neighboring tets add it independently. Nodes are numbered in the
+/// order the new tets first use them, which is the numbering JoinFields produced when it was used to merge the
+/// duplicated nodes.
 FieldHandle RefineTetMeshLocallyAlgorithm::RefineMesh(FieldHandle input, SparseRowMatrixHandle cut_edges) const
 {
-  FieldHandle output, result;
-  double fld_val;
-  DenseMatrixHandle two_new_tets(new DenseMatrix(2, 4));
+  FieldHandle output;
   VMesh* input_vmesh = input->vmesh();
   VField* input_vfield = input->vfield();
   input_vmesh->synchronize(Mesh::NODES_E);
   long number_elem = input_vmesh->num_elems(), node_count = input_vmesh->num_nodes();
-  VMesh::Node::array_type onodes(4), onodes2(4);
 
   if (cut_edges->nrows() != node_count)
   {
@@ -797,137 +836,207 @@ FieldHandle RefineTetMeshLocallyAlgorithm::RefineMesh(FieldHandle input, SparseR
     return output;
   }
 
-  FieldInformation fieldinfo("TetVolMesh", 0, "double");
-  result = CreateField(fieldinfo);
-  VMesh* result_vmesh = result->vmesh();
-  VField* result_vfld = result->vfield();
-
-  ///count how many tets and nodes are needed now 
-  long tet_count = 0;
+  ///count how many tets and nodes are needed now
+  std::vector<int> case_codes(number_elem, 0);
+  std::vector<long> tet_offsets(number_elem + 1, 0), slot_offsets(number_elem + 1, 0);
 
-  Point p1, p2, p3, p4;
-
-  for (long idx = 0; idx < node_count; idx++)
+  Parallel::For(0, number_elem, [&](size_t first, size_t last)
   {
-    input_vmesh->get_center(p1, static_cast<VMesh::Node::index_type>(idx));
-    result_vmesh->add_point(Point(p1.x(), p1.y(), p1.z()));
-  }
+    VMesh::Node::array_type onodes(4);
+    for (size_t idx = first; idx < last; idx++)
+    {
+      input_vmesh->get_nodes(onodes, static_cast<VMesh::Elem::index_type>(idx));
 
-  for (long idx = 0; idx < number_elem; idx++)
-  {
-    input_vfield->get_value(fld_val, idx);
-    input_vmesh->get_nodes(onodes, static_cast<VMesh::Elem::index_type>(idx));
+      int case_code = 0;
+      for (int k = 0; k < number_edges; k++)
+      {
+        long e1 = onodes[EdgeLookup[k][1]], e2 = onodes[EdgeLookup[k][2]];
 
-    int main_case, case_code = 0, nr_tets;
-    int recode[4];
-    for (int k = 0; k < number_edges; k++)
-    {
-      long e1 = onodes[EdgeLookup[k][1]], e2 = onodes[EdgeLookup[k][2]];
+        if ((*cut_edges).coeff(e1 < e2 ? e1 : e2, e2 >= e1 ? e2 : e1) == 1)
+        {
+          case_code += pow(2.0, 9 - (EdgeLookup[k][0]));
+        }
+      }
+      case_codes[idx] = case_code;
 
-      if ((*cut_edges).coeff(e1 < e2 ? e1 : e2, e2 >= e1 ? e2 : e1) == 1)
+      if (case_code <= 0 || case_code > number_cases - 1)
       {
-        case_code += pow(2.0, 9 - (EdgeLookup[k][0]));
+        tet_offsets[idx + 1] = 1;
+        continue;
       }
+
+      /// out of 64 (2^6) theoretical cases to split a tetrahedron, there are only 10 that are actually relavant because of symmetry
+      const int main_case = CaseLookup[case_code - 1][5];
+      const int nr_tets = NumberTets[main_case - 1];
+      long slots = 0;
+      for (int k = 0; k < nr_tets; k++)
+        for (int l = 0; l < number_nodes; l++)
+          if (ChildTetNode(main_case, k, l) > 3) slots++;
+
+      tet_offsets[idx + 1] = nr_tets;
+      slot_offsets[idx + 1] = slots;
     }
+  });
 
-    /// no cutting edge was found but that should actually not happen
-    if (case_code<0 || case_code>number_cases - 1)
+  /// no cutting edge was found but that should actually not happen
+  for (long idx = 0; idx < number_elem; idx++)
+  {
+    if (case_codes[idx]<0 || case_codes[idx]>number_cases - 1)
     {
       std::ostringstream ostr;
-      ostr << " Case " << case_code << " is not specified (range: 1.." << number_cases << ") in the code and therefore appears to be broken. " << std::endl;
+      ostr << " Case " << case_codes[idx] << " is not specified (range: 1.." << number_cases << ") in the code and therefore appears to be broken. " << std::endl;
       error(ostr.str());
+      number_elem = idx;
       break;
     }
+  }
+
+  std::partial_sum(tet_offsets.begin(), tet_offsets.begin() + number_elem + 1, tet_offsets.begin());
+  std::partial_sum(slot_offsets.begin(), slot_offsets.begin() + number_elem + 1, slot_offsets.begin());
+  const long tet_count = tet_offsets[number_elem], slot_count = slot_offsets[number_elem];
+
+  /// new nodes are written as -(slot+1) until they have an index
+  std::vector<VMesh::index_type> tets(4 * tet_count);
+  std::vector<double> tet_values(tet_count);
+  std::vector<NewNodeKey> keys(slot_count);
 
-    if (case_code != 0) /// start refining here
+  Parallel::For(0, number_elem, [&](size_t first, size_t last)
+  {
+    VMesh::Node::array_type onodes(4);
+    for (size_t idx = first; idx < last; idx++)
     {
+      double fld_val;
+      input_vfield->get_value(fld_val, idx);
+      input_vmesh->get_nodes(onodes, static_cast<VMesh::Elem::index_type>(idx));
+
+      long tet = tet_offsets[idx], slot = slot_offsets[idx];
+      const int case_code = case_codes[idx];
+
+      if (case_code == 0)
+      { /// current tet is not selected to be cut -> just add it as it is to the output mesh
+        std::copy(onodes.begin(), onodes.end(), tets.begin() + 4 * tet);
+        tet_values[tet] = fld_val;
+        continue;
+      }
 
+      int recode[4];
       for (int k = 0; k < number_nodes; k++)
         recode[k] = CaseLookup[case_code - 1][k + 1];
 
-      main_case = CaseLookup[case_code - 1][5];
-      /// out of 64 (2^6) theoretical cases to split a tetrahedron, there are only 10 that are actually relavant because of symmetry
+      const int main_case = CaseLookup[case_code - 1][5];
+      const int nr_tets = NumberTets[main_case - 1];
 
-      nr_tets = NumberTets[main_case - 1];
-
-      for (int k = 0; k < nr_tets; k++)
+      for (int k = 0; k < nr_tets; k++, tet++)
       {
         for (int l = 0; l < number_nodes; l++)
         {
-          int node = 0;
-
-          if (main_case == 1)
-            node = Case1Lookup[k][l]; else
-            if (main_case == 2)
-              node = Case2aLookup[k][l]; else
-              if (main_case == 3)
-                node = Case2bLookup[k][l]; else
-                if (main_case == 4)
-                  node = Case3aLookup[k][l]; else
-                  if (main_case == 5)
-                    node = Case3bLookup[k][l]; else
-                    if (main_case == 6)
-                      node = Case3cLookup[k][l]; else
-                      if (main_case == 7)
-                        node = Case4aLookup[k][l]; else
-                        if (main_case == 8)
-                          node = Case4bLookup[k][l]; else
-                          if (main_case == 9)
-                            node = Case5Lookup[k][l]; else
-                            if (main_case == 10)
-                              node = Case6Lookup[k][l]; else
-                              if (main_case == 11)
-                                node = Case3cNonNegativeLookup[k][l]; else
-                                if (main_case == 12)
-                                  node = Case4aNonNegativeLookup[k][l];
+          const int node = ChildTetNode(main_case, k, l);
+          VMesh::index_type& tet_node = tets[4 * tet + l];
 
           if (node > 3 && node <= 9)
           {
-            input_vmesh->get_center(p1, static_cast<VMesh::Node::index_type>(onodes[recode[EdgeLookup[node - 4][1]]]));
-            input_vmesh->get_center(p2, static_cast<VMesh::Node::index_type>(onodes[recode[EdgeLookup[node - 4][2]]]));
-            onodes2[l] = node_count;
-            result_vmesh->add_point(Point((p1.x() + p2.x()) / 2, (p1.y() + p2.y()) / 2, (p1.z() + p2.z()) / 2));
-            node_count++;
+            const long e1 = onodes[recode[EdgeLookup[node - 4][1]]], e2 = onodes[recode[EdgeLookup[node - 4][2]]];
+            NewNodeKey key = { std::min(e1, e2), std::max(e1, e2), slot };
+            keys[slot] = key;
+            tet_node = -(slot++ + 1);
+          }
+          else if (node == 10)
+          /// this is an addition to the splitting algorithm proposed in Thompson, all edges of the new tets should have smaller edges (in case every edge of the
+          /// original tet needs to be split)
+          {
+            NewNodeKey key = { -1, static_cast<long>(idx), slot };
+            keys[slot] = key;
+            tet_node = -(slot++ + 1);
           }
           else
-            if (node == 10)
-              /// this is an addition to the splitting algorithm proposed in Thompson, all edges of the new tets should have smaller edges (in case every edge of the
-              /// original tet needs to be split)  
-            {
-              input_vmesh->get_center(p1, static_cast<VMesh::Node::index_type>(onodes[0]));
-              input_vmesh->get_center(p2, static_cast<VMesh::Node::index_type>(onodes[1]));
-              input_vmesh->get_center(p3, static_cast<VMesh::Node::index_type>(onodes[2]));
-              input_vmesh->get_center(p4, static_cast<VMesh::Node::index_type>(onodes[3]));
-              onodes2[l] = node_count;
-              result_vmesh->add_point(Point((p1.x() + p2.x() + p3.x() + p4.x()) / 4, (p1.y() + p2.y() + p3.y() + p4.y()) / 4, (p1.z() + p2.z() + p3.z() + p4.z()) / 4));
-              node_count++;
-            }
-            else
-            {
-              onodes2[l] = onodes[recode[node]];
-            }
+          {
+            tet_node = onodes[recode[node]];
+          }
         }
-        result_vmesh->add_elem(onodes2);
-        result_vfld->resize_values();
-        result_vfld->set_value(fld_val, tet_count++);
+        tet_values[tet] = fld_val;
       }
     }
-    else
-    { /// current tet is not selected to be cut -> just add it as it is to the output mesh
-      result_vmesh->add_elem(onodes);
-      result_vfld->resize_values();
-      result_vfld->set_value(fld_val, tet_count++);
+  });
+
+  /// give every distinct new node one index after the nodes of the input mesh
+  Parallel::Sort(keys.begin(), keys.end());
+
+  std::vector<long> slot_node(slot_count);
+  std::vector<NewNodeKey> new_nodes;
+  for (long k = 0; k < slot_count; k++)
+  {
+    if (new_nodes.empty() || keys[k].a != new_nodes.back().a || keys[k].b != new_nodes.back().b)
+      new_nodes.push_back(keys[k]);
+    slot_node[keys[k].slot] = node_count + new_nodes.size() - 1;
+  }
+
+  /// number the nodes in the order the new tets use them
+  std::vector<VMesh::index_type> renumber(node_count + new_nodes.size(), -1);
+  std::vector<long> node_order;
+  node_order.reserve(renumber.size());
+  for (size_t k = 0; k < tets.size(); k++)
+  {
+    const long node = tets[k] >= 0 ? tets[k] : slot_node[-tets[k] - 1];
+    if (renumber[node] < 0)
+    {
+      renumber[node] = node_order.size();
+      node_order.push_back(node);
     }
+    tets[k] = renumber[node];
   }
 
-  JoinFieldsAlgo joinfields_algo; /// use joinfields to get rid of extra nodes and duplicated elements
+  std::vector<Point> points(node_order.size());
+  Parallel::For(0, node_order.size(), [&](size_t first, size_t last)
+  {
+    VMesh::Node::array_type onodes(4);
+    Point p1, p2, p3, p4;
+    for (size_t k = first; k < last; k++)
+    {
+      const long node = node_order[k];
+      if (node < node_count)
+      {
+        input_vmesh->get_center(points[k], static_cast<VMesh::Node::index_type>(node));
+        continue;
+      }
+
+      const NewNodeKey& key = new_nodes[node - node_count];
+      if (key.a >= 0)
+      {
+        input_vmesh->get_center(p1, static_cast<VMesh::Node::index_type>(key.a));
+        input_vmesh->get_center(p2, static_cast<VMesh::Node::index_type>(key.b));
+        points[k] = Point((p1.x() + p2.x()) / 2, (p1.y() + p2.y()) / 2, (p1.z() + p2.z()) / 2);
+      }
+      else
+      {
+        input_vmesh->get_nodes(onodes, static_cast<VMesh::Elem::index_type>(key.b));
+        input_vmesh->get_center(p1, static_cast<VMesh::Node::index_type>(onodes[0]));
+        input_vmesh->get_center(p2, static_cast<VMesh::Node::index_type>(onodes[1]));
+        input_vmesh->get_center(p3, static_cast<VMesh::Node::index_type>(onodes[2]));
+        input_vmesh->get_center(p4, static_cast<VMesh::Node::index_type>(onodes[3]));
+        points[k] = Point((p1.x() + p2.x() + p3.x() + p4.x()) / 4, (p1.y() + p2.y() + p3.y() + p4.y()) / 4, (p1.z() + p2.z() + p3.z() + p4.z()) / 4);
+      }
+    }
+  });
+
+  FieldInformation fieldinfo("TetVolMesh", 0, "double");
+  output = CreateField(fieldinfo);
+  VMesh* result_vmesh = output->vmesh();
+  VField* result_vfld = output->vfield();
+
+  result_vmesh->node_reserve(points.size());
+  for (size_t k = 0; k < points.size(); k++)
+    result_vmesh->add_point(points[k]);
+
+  VMesh::Node::array_type onodes2(4);
+  result_vmesh->elem_reserve(tet_count);
+  for (long k = 0; k < tet_count; k++)
+  {
+    std::copy(tets.begin() + 4 * k, tets.begin() + 4 * k + 4, onodes2.begin());
+    result_vmesh->add_elem(onodes2);
+  }
 
-  joinfields_algo.set(JoinFieldsAlgo::MergeNodes, true);
-  joinfields_algo.set(JoinFieldsAlgo::MergeElems, true);
-  FieldList input_list; /// need input_list only for joinfields
-  input_list.push_back(result);
-  input_list.push_back(result);
-  joinfields_algo.runImpl(input_list, output);
+  result_vfld->resize_values();
+  result_vfld->set_values(tet_values);
 
   return output;
 }
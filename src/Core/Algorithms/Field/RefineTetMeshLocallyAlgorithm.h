@@ -93,6 +93,7 @@ class SCISHARE RefineTetMeshLocallyAlgorithm : public AlgorithmBase
     std::vector<int> maxi(const std::vector<double>& input_vec) const;
     std::vector<int> getEdgeCoding(int pos) const;
     std::vector<double> getEdgeLengths(Geometry::Point p1, Geometry::Point p2, Geometry::Point p3, Geometry::Point p4) const;
+    static int ChildTetNode(int main_case, int tet, int node);
 };
 }}}}
 
@@ -0,0 +1,293 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateIsInsideField.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <boost/thread/thread.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Closed unit sphere with outward facing triangles
+  FieldHandle UnitSphere(int rings, int segments)
+  {
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    mesh->add_point(Point(0, 0, 1));
+    for (int i = 1; i < rings; i++)
+    {
+      const double theta = M_PI*i/rings;
+      for (int j = 0; j < segments; j++)
+      {
+        const double phi = 2.0*M_PI*j/segments;
+        mesh->add_point(Point(sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta)));
+      }
+    }
+    mesh->add_point(Point(0, 0, -1));
+
+    const index_type south = 1 + (rings-1)*segments;
+    auto node = [segments](int i, int j) { return index_type(1 + (i-1)*segments + (j % segments)); };
+    VMesh::Node::array_type tri(3);
+    for (int j = 0; j < segments; j++)
+    {
+      tri[0] = 0; tri[1] = node(1,j); tri[2] = node(1,j+1);
+      mesh->add_elem(tri);
+      for (int i = 1; i < rings-1; i++)
+      {
+        tri[0] = node(i,j); tri[1] = node(i+1,j); tri[2] = node(i+1,j+1);
+        mesh->add_elem(tri);
+        tri[0] = node(i,j); tri[1] = node(i+1,j+1); tri[2] = node(i,j+1);
+        mesh->add_elem(tri);
+      }
+      tri[0] = node(rings-1,j); tri[1] = south; tri[2] = node(rings-1,j+1);
+      mesh->add_elem(tri);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // Distance from every node of lattice to object found through the
+  // object mesh's own search grid
+  std::vector<double> MeshSearchDistances(FieldHandle lattice, FieldHandle object)
+  {
+    VMesh* imesh = lattice->vmesh();
+    VMesh* objmesh = object->vmesh();
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+    std::vector<double> dist(imesh->num_nodes());
+    Point p, r;
+    VMesh::Elem::index_type elem;
+    for (VMesh::Node::index_type n = 0; n < imesh->num_nodes(); n++)
+    {
+      imesh->get_center(p, n);
+      EXPECT_TRUE(objmesh->find_closest_elem(dist[n], r, elem, p));
+    }
+    return dist;
+  }
+}
+
+TEST(CalculateDistanceFieldTests, SurfaceDistanceMatchesMeshSearch)
+{
+  auto sphere = UnitSphere(12, 24);
+  auto lattice = CreateEmptyLatVol(12, 12, 12, DOUBLE_E, Point(-2,-2,-2), Point(2,2,2));
+
+  CalculateDistanceFieldAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(lattice, sphere, output));
+
+  const auto expected = MeshSearchDistances(lattice, sphere);
+  VField* ofield = output->vfield();
+  ASSERT_EQ(expected.size(), ofield->num_values());
+  for (VMesh::Node::index_type n = 0; n < ofield->num_values(); n++)
+  {
+    double val;
+    ofield->get_value(val, n);
+    EXPECT_NEAR(expected[n], val, 1e-10);
+  }
+}
+
+TEST(CalculateDistanceFieldTests, SignedDistanceIsNegativeInside)
+{
+  auto sphere = UnitSphere(12, 24);
+  auto lattice = CreateEmptyLatVol(12, 12, 12, DOUBLE_E, Point(-2,-2,-2), Point(2,2,2));
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.run(lattice, sphere, output));
+
+  const auto expected = MeshSearchDistances(lattice, sphere);
+  VMesh* imesh = lattice->vmesh();
+  VField* ofield = output->vfield();
+  Point p;
+  for (VMesh::Node::index_type n = 0; n < ofield->num_values(); n++)
+  {
+    double val;
+    ofield->get_value(val, n);
+    imesh->get_center(p, n);
+    EXPECT_NEAR(expected[n], std::fabs(val), 1e-10);
+    if (Vector(p).length() < 0.9)
+    {
+      EXPECT_LT(val, 0.0);
+    }
+    if (Vector(p).length() > 1.1)
+    {
+      EXPECT_GT(val, 0.0);
+    }
+  }
+}
+
+TEST(CalculateDistanceFieldTests, FastSweepingApproximatesExactDistance)
+{
+  auto sphere = UnitSphere(24, 48);
+  const size_type size = 25;
+  const double h = 4.0/(size-1);
+  auto lattice = CreateEmptyLatVol(size, size, size, DOUBLE_E, Point(-2,-2,-2), Point(2,2,2));
+  const auto expected = MeshSearchDistances(lattice, sphere);
+
+  CalculateDistanceFieldAlgo algo;
+  algo.set(Parameters::UseFastSweeping, true);
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(lattice, sphere, output));
+
+  CalculateSignedDistanceFieldAlgo signed_algo;
+  signed_algo.set(Parameters::UseFastSweeping, true);
+  FieldHandle signed_output;
+  ASSERT_TRUE(signed_algo.run(lattice, sphere, signed_output));
+
+  VMesh* imesh = lattice->vmesh();
+  Point p;
+  double maxerr = 0.0;
+  for (VMesh::Node::index_type n = 0; n < imesh->num_nodes(); n++)
+  {
+    double val, signed_val;
+    output->vfield()->get_value(val, n);
+    signed_output->vfield()->get_value(signed_val, n);
+    imesh->get_center(p, n);
+
+    // Nodes in the band are exact, the rest is first order in the spacing.
+    // Some nodes lie on the sphere, where the mesh search is only accurate
+    // to its epsilon.
+    if (expected[n] <= 2.0*h)
+    {
+      EXPECT_NEAR(expected[n], val, 1e-5);
+    }
+    maxerr = std::max(maxerr, std::fabs(expected[n] - val));
+    EXPECT_DOUBLE_EQ(val, std::fabs(signed_val));
+    if (Vector(p).length() < 0.9)
+    {
+      EXPECT_LT(signed_val, 0.0);
+    }
+    if (Vector(p).length() > 1.1)
+    {
+      EXPECT_GT(signed_val, 0.0);
+    }
+  }
+  EXPECT_LT(maxerr, h);
+}
+
+TEST(CalculateDistanceFieldTests, FastSweepingFallsBackForUnstructuredDestination)
+{
+  auto sphere = UnitSphere(12, 24);
+  auto tets = CubeTetVolLinearBasis(DOUBLE_E);
+
+  CalculateDistanceFieldAlgo exact;
+  FieldHandle expected;
+  ASSERT_TRUE(exact.runImpl(tets, sphere, expected));
+
+  CalculateDistanceFieldAlgo algo;
+  algo.set(Parameters::UseFastSweeping, true);
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(tets, sphere, output));
+
+  for (VMesh::Node::index_type n = 0; n < output->vfield()->num_values(); n++)
+  {
+    double a, b;
+    expected->vfield()->get_value(a, n);
+    output->vfield()->get_value(b, n);
+    EXPECT_EQ(a, b);
+  }
+}
+
+TEST(CalculateDistanceFieldTests, FastSweepingStopsWhenInterrupted)
+{
+  auto sphere = UnitSphere(24, 48);
+  auto lattice = CreateEmptyLatVol(25, 25, 25, DOUBLE_E, Point(-2,-2,-2), Point(2,2,2));
+
+  // the interrupt is requested before the thread reaches its first check, so
+  // only a check on the thread that called the algorithm can observe it
+  bool interrupted = false;
+  boost::thread worker([&]()
+  {
+    CalculateDistanceFieldAlgo algo;
+    algo.set(Parameters::UseFastSweeping, true);
+    FieldHandle output;
+    try
+    {
+      algo.runImpl(lattice, sphere, output);
+    }
+    catch (boost::thread_interrupted&)
+    {
+      interrupted = true;
+    }
+  });
+  worker.interrupt();
+  worker.join();
+  EXPECT_TRUE(interrupted);
+}
+
+TEST(CalculateIsInsideFieldTests, ClosedSurfaceEnclosesElements)
+{
+  auto sphere = UnitSphere(24, 48);
+  auto lattice = CreateEmptyLatVol(10, 10, 10, DOUBLE_E, Point(-1.8,-1.8,-1.8), Point(1.8,1.8,1.8));
+
+  CalculateIsInsideFieldAlgo algo;
+  algo.setOption(Parameters::CalcInsideMethod, "all");
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(lattice, sphere, output));
+
+  VMesh* omesh = output->vmesh();
+  VField* ofield = output->vfield();
+  VMesh::Node::array_type nodes;
+  Point p;
+  int num_inside = 0;
+  for (VMesh::Elem::index_type e = 0; e < omesh->num_elems(); e++)
+  {
+    omesh->get_nodes(nodes, e);
+    double rmax = 0.0;
+    for (size_t k = 0; k < nodes.size(); k++)
+    {
+      omesh->get_center(p, nodes[k]);
+      rmax = std::max(rmax, Vector(p).length());
+    }
+
+    double val;
+    ofield->get_value(val, e);
+    if (rmax < 0.95) { EXPECT_EQ(1.0, val); num_inside++; }
+    if (rmax > 1.05)
+    {
+      EXPECT_EQ(0.0, val);
+    }
+  }
+  EXPECT_GT(num_inside, 0);
+}
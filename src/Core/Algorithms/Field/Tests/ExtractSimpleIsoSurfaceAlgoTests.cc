@@ -35,15 +35,22 @@ last change: 04/21/2015
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/ExtractSimpleIsosurfaceAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <Core/Datatypes/MatrixComparison.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <boost/thread/thread.hpp>
+#include <atomic>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::TestUtils;
 
@@ -101,3 +108,228 @@ TEST(ExtractSimpleIsoSurfaceAlgoTest, ExtractSimpleIsoSurf_LatVol_DataOnNodes)
   EXPECT_EQ(output->vmesh()->num_elems(),3);
   EXPECT_EQ(output->vfield()->num_values(),5);
 }
+
+namespace
+{
+  // Distance from the center of a 40^3 lattice, so that isosurfaces are spheres
+  FieldHandle SphereDistanceLatVol()
+  {
+    auto field = CreateEmptyLatVol(40, 40, 40, DOUBLE_E, Point(-1, -1, -1), Point(1, 1, 1));
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+    Point p;
+    for (VMesh::Node::index_type n(0); n < mesh->num_nodes(); ++n)
+    {
+      mesh->get_center(p, n);
+      vfield->set_value(Vector(p).length(), n);
+    }
+    return field;
+  }
+
+  // The same distance stored on the cells of a 20^3 lattice
+  FieldHandle SphereDistanceLatVolOnCells()
+  {
+    FieldInformation fi(LATVOLMESH_E, CONSTANTDATA_E, DOUBLE_E);
+    auto field = CreateField(fi, CreateMesh(fi, 20, 20, 20, Point(-1, -1, -1), Point(1, 1, 1)));
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+    vfield->resize_values();
+    Point p;
+    for (VMesh::Elem::index_type e(0); e < mesh->num_elems(); ++e)
+    {
+      mesh->get_center(p, e);
+      vfield->set_value(Vector(p).length(), e);
+    }
+    return field;
+  }
+
+  // Distance from the center of an n^3 lattice of cubes in [-1,1]^3, each cube
+  // stored as one unstructured hex or split into six tets
+  FieldHandle SphereDistanceVolume(const std::string& meshType, int n)
+  {
+    FieldInformation fi(meshType, 1, "double");
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    for (int k = 0; k <= n; k++)
+      for (int j = 0; j <= n; j++)
+        for (int i = 0; i <= n; i++)
+          mesh->add_point(Point(2.0*i/n - 1.0, 2.0*j/n - 1.0, 2.0*k/n - 1.0));
+
+    const bool tets = (meshType == "TetVolMesh");
+    const int split[6][4] = { {0,1,2,6}, {0,2,3,6}, {0,3,7,6}, {0,7,4,6}, {0,4,5,6}, {0,5,1,6} };
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+        {
+          auto node = [n](int a, int b, int c) { return static_cast<VMesh::index_type>((c*(n+1)+b)*(n+1)+a); };
+          const VMesh::index_type cube[8] = {
+            node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+            node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+          if (tets)
+          {
+            for (int t = 0; t < 6; t++)
+            {
+              VMesh::Node::array_type nodes(4);
+              for (int v = 0; v < 4; v++) nodes[v] = cube[split[t][v]];
+              mesh->add_elem(nodes);
+            }
+          }
+          else
+          {
+            VMesh::Node::array_type nodes(8);
+            for (int v = 0; v < 8; v++) nodes[v] = cube[v];
+            mesh->add_elem(nodes);
+          }
+        }
+
+    VField* vfield = field->vfield();
+    vfield->resize_values();
+    Point p;
+    for (VMesh::Node::index_type n(0); n < mesh->num_nodes(); ++n)
+    {
+      mesh->get_center(p, n);
+      vfield->set_value(Vector(p).length(), n);
+    }
+    return field;
+  }
+
+  void expectSameMesh(FieldHandle expected, FieldHandle actual)
+  {
+    ASSERT_TRUE(expected != nullptr);
+    ASSERT_TRUE(actual != nullptr);
+    VMesh* emesh = expected->vmesh();
+    VMesh* amesh = actual->vmesh();
+    ASSERT_GT(emesh->num_elems(), 0);
+    ASSERT_EQ(emesh->num_nodes(), amesh->num_nodes());
+    ASSERT_EQ(emesh->num_elems(), amesh->num_elems());
+
+    Point pe, pa;
+    for (VMesh::Node::index_type n(0); n < emesh->num_nodes(); ++n)
+    {
+      emesh->get_center(pe, n);
+      amesh->get_center(pa, n);
+      ASSERT_EQ(pe, pa);
+    }
+    VMesh::Node::array_type enodes, anodes;
+    for (VMesh::Elem::index_type e(0); e < emesh->num_elems(); ++e)
+    {
+      emesh->get_nodes(enodes, e);
+      amesh->get_nodes(anodes, e);
+      ASSERT_EQ(enodes, anodes);
+    }
+  }
+
+  FieldHandle extractSpheres(FieldHandle input, int threads, MatrixHandle& interpolant, MatrixHandle& parents)
+  {
+    MarchingCubesAlgo algo;
+    algo.set(MarchingCubesAlgo::build_field, true);
+    algo.set(MarchingCubesAlgo::build_node_interpolant, true);
+    algo.set(MarchingCubesAlgo::build_elem_interpolant, true);
+    algo.set(MarchingCubesAlgo::num_threads, threads);
+    FieldHandle output;
+    algo.run(input, { 0.3, 0.75 }, output, interpolant, parents);
+    return output;
+  }
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ParallelExtractionWeldsToSingleThreadedSurface)
+{
+  auto input = SphereDistanceLatVol();
+  MatrixHandle interpolant1, parents1, interpolant4, parents4;
+  auto serial = extractSpheres(input, 1, interpolant1, parents1);
+  auto parallel = extractSpheres(input, 4, interpolant4, parents4);
+
+  expectSameMesh(serial, parallel);
+  if (HasFatalFailure())
+    return;
+  VMesh* pmesh = parallel->vmesh();
+
+  ASSERT_TRUE(interpolant4 != nullptr);
+  ASSERT_TRUE(parents4 != nullptr);
+  EXPECT_EQ(pmesh->num_nodes(), interpolant4->nrows());
+  EXPECT_EQ(input->vmesh()->num_nodes(), interpolant4->ncols());
+  EXPECT_EQ(pmesh->num_elems(), parents4->nrows());
+  EXPECT_EQ(input->vmesh()->num_elems(), parents4->ncols());
+  EXPECT_TRUE(*castMatrix::toSparse(interpolant1) == *castMatrix::toSparse(interpolant4));
+  EXPECT_TRUE(*castMatrix::toSparse(parents1) == *castMatrix::toSparse(parents4));
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, CellDataExtractsIsovaluesInParallel)
+{
+  auto input = SphereDistanceLatVolOnCells();
+  MatrixHandle interpolant1, parents1, interpolant4, parents4;
+  auto serial = extractSpheres(input, 1, interpolant1, parents1);
+  auto parallel = extractSpheres(input, 4, interpolant4, parents4);
+
+  expectSameMesh(serial, parallel);
+  if (HasFatalFailure())
+    return;
+
+  VField* sfield = serial->vfield();
+  VField* pfield = parallel->vfield();
+  ASSERT_EQ(sfield->num_values(), pfield->num_values());
+  double sv, pv;
+  for (VMesh::index_type i = 0; i < sfield->num_values(); ++i)
+  {
+    sfield->get_value(sv, i);
+    pfield->get_value(pv, i);
+    EXPECT_EQ(sv, pv);
+  }
+}
+
+namespace
+{
+  void expectParallelMatchesSerial(FieldHandle input)
+  {
+    // enough cells for four ranges per isovalue
+    ASSERT_GE(input->vmesh()->num_elems(), 4*4096);
+    MatrixHandle interpolant1, parents1, interpolant4, parents4;
+    auto serial = extractSpheres(input, 1, interpolant1, parents1);
+    auto parallel = extractSpheres(input, 4, interpolant4, parents4);
+
+    expectSameMesh(serial, parallel);
+    if (::testing::Test::HasFatalFailure())
+      return;
+    ASSERT_TRUE(interpolant4 != nullptr);
+    ASSERT_TRUE(parents4 != nullptr);
+    EXPECT_TRUE(*castMatrix::toSparse(interpolant1) == *castMatrix::toSparse(interpolant4));
+    EXPECT_TRUE(*castMatrix::toSparse(parents1) == *castMatrix::toSparse(parents4));
+  }
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ParallelTetExtractionMatchesSingleThreaded)
+{
+  expectParallelMatchesSerial(SphereDistanceVolume("TetVolMesh", 16));
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ParallelHexExtractionMatchesSingleThreaded)
+{
+  expectParallelMatchesSerial(SphereDistanceVolume("HexVolMesh", 28));
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ProgressIsReportedFromCallingThreadOnly)
+{
+  auto input = SphereDistanceVolume("HexVolMesh", 28);
+  MarchingCubesAlgo algo;
+  algo.set(MarchingCubesAlgo::build_field, true);
+  algo.set(MarchingCubesAlgo::num_threads, 4);
+
+  const auto caller = boost::this_thread::get_id();
+  std::atomic<size_t> updates(0), otherThreads(0);
+  double last = 0.0;
+  algo.setUpdaterFunc([&](double progress)
+  {
+    updates++;
+    if (boost::this_thread::get_id() != caller)
+      otherThreads++;
+    EXPECT_GE(progress, last);
+    EXPECT_LE(progress, 1.0);
+    last = progress;
+  });
+
+  FieldHandle output;
+  algo.run(input, { 0.3, 0.75 }, output);
+  EXPECT_GT(updates.load(), 0u);
+  EXPECT_EQ(0u, otherThreads.load());
+}
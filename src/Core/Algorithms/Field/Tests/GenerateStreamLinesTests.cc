@@ -0,0 +1,168 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/StreamLines/GenerateStreamLines.h>
+#include <Core/Algorithms/Legacy/Fields/ConvertMeshType/ConvertMeshToTetVolMesh.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Unit x-direction flow on a tetrahedral version of the [-1,1] cube
+  FieldHandle UniformFlowTetVol()
+  {
+    FieldHandle latVol = CreateEmptyLatVol(6, 6, 6, VECTOR_E);
+    ConvertMeshToTetVolMeshAlgo convert;
+    FieldHandle tetVol;
+    convert.run(latVol, tetVol);
+
+    VField* field = tetVol->vfield();
+    for (VMesh::index_type idx = 0; idx < field->num_values(); idx++)
+      field->set_value(Vector(1, 0, 0), idx);
+    return tetVol;
+  }
+
+  // Seeds on a grid inside the cube, every seventh one is moved outside
+  FieldHandle SeedPoints(int n, std::set<index_type>& inside)
+  {
+    FieldInformation fi(POINTCLOUDMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    for (int k = 0; k < n; k++)
+    {
+      const double y = -0.9 + 1.8*(k % 5)/4.0;
+      const double z = -0.9 + 1.8*(k / 5 % 5)/4.0;
+      const double x = (k % 7 == 3) ? 1.5 : -0.8 + 0.05*(k % 11);
+      const index_type idx = mesh->add_point(Point(x, y, z));
+      if (x < 1.0) inside.insert(idx);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+}
+
+TEST(GenerateStreamLinesTests, TracesEverySeedInsideTheField)
+{
+  std::set<index_type> inside;
+  auto seeds = SeedPoints(60, inside);
+  auto flow = UniformFlowTetVol();
+
+  GenerateStreamLinesAlgo algo;
+  algo.set(Parameters::StreamlineStepSize, 0.05);
+  algo.set(Parameters::StreamlineMaxSteps, 100);
+  algo.setOption(Parameters::StreamlineDirection, "Positive");
+  algo.setOption(Parameters::StreamlineMethod, "RungeKutta");
+  algo.setOption(Parameters::StreamlineValue, "Seed index");
+
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(flow, seeds, output));
+
+  VMesh* omesh = output->vmesh();
+  VField* ofield = output->vfield();
+  ASSERT_EQ(omesh->num_nodes(), ofield->num_values());
+
+  // Streamlines come out in seed order and each one runs straight to the
+  // x = 1 face of the cube
+  std::set<index_type> traced;
+  size_t lines = 0;
+  double previous = -1.0;
+  Point start, p, last;
+  for (VMesh::Node::index_type n = 0; n < omesh->num_nodes(); n++)
+  {
+    double seed;
+    ofield->get_value(seed, n);
+    omesh->get_point(p, n);
+    EXPECT_GE(seed, previous);
+    if (seed != previous)
+    {
+      if (lines > 0)
+      {
+        EXPECT_GT(last.x(), 1.0 - 0.05 - 1e-8);
+      }
+      start = p;
+      lines++;
+      traced.insert(static_cast<index_type>(seed));
+    }
+    EXPECT_NEAR(start.y(), p.y(), 1e-8);
+    EXPECT_NEAR(start.z(), p.z(), 1e-8);
+    previous = seed;
+    last = p;
+  }
+  EXPECT_GT(last.x(), 1.0 - 0.05 - 1e-8);
+
+  EXPECT_EQ(inside, traced);
+  EXPECT_EQ(omesh->num_nodes() - lines, omesh->num_elems());
+}
+
+TEST(GenerateStreamLinesTests, SameOutputWithAndWithoutThreads)
+{
+  std::set<index_type> inside;
+  auto seeds = SeedPoints(200, inside);
+  auto flow = UniformFlowTetVol();
+
+  FieldHandle outputs[2];
+  for (int threaded = 0; threaded < 2; threaded++)
+  {
+    GenerateStreamLinesAlgo algo;
+    algo.set(Parameters::StreamlineStepSize, 0.1);
+    algo.setOption(Parameters::StreamlineDirection, "Both");
+    algo.setOption(Parameters::StreamlineValue, "Integration index");
+    algo.set(Parameters::UseMultithreading, threaded == 1);
+    ASSERT_TRUE(algo.runImpl(flow, seeds, outputs[threaded]));
+  }
+
+  VMesh* mesh0 = outputs[0]->vmesh();
+  VMesh* mesh1 = outputs[1]->vmesh();
+  ASSERT_GT(mesh0->num_nodes(), 0);
+  ASSERT_EQ(mesh0->num_nodes(), mesh1->num_nodes());
+  ASSERT_EQ(mesh0->num_elems(), mesh1->num_elems());
+
+  Point p0, p1;
+  double v0, v1;
+  for (VMesh::Node::index_type n = 0; n < mesh0->num_nodes(); n++)
+  {
+    mesh0->get_point(p0, n);
+    mesh1->get_point(p1, n);
+    EXPECT_EQ(p0, p1);
+    outputs[0]->vfield()->get_value(v0, n);
+    outputs[1]->vfield()->get_value(v1, n);
+    EXPECT_EQ(v0, v1);
+  }
+}
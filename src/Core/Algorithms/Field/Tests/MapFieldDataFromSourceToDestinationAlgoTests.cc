@@ -36,6 +36,7 @@
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 #include <Core/Datatypes/DenseMatrix.h>
 
 using namespace SCIRun;
@@ -53,3 +54,51 @@ TEST(MapFieldDataFromSourceToDestinationAlgoTests, ThrowsOnNullInput)
   AlgorithmInput empty;
   EXPECT_THROW(algo.run(empty), AlgorithmProcessingException);
 }
+
+namespace
+{
+  FieldHandle LinearLatVol(size_type size, const Point& minb, const Point& maxb)
+  {
+    auto field = CreateEmptyLatVol(size, size, size, DOUBLE_E, minb, maxb);
+    VMesh* mesh = field->vmesh();
+    Point p;
+    for (VMesh::Node::index_type n(0); n < mesh->num_nodes(); ++n)
+    {
+      mesh->get_center(p, n);
+      field->vfield()->set_value(p.x() + 2*p.y() + 3*p.z(), n);
+    }
+    return field;
+  }
+
+  FieldHandle mapLinearData(FieldHandle source, FieldHandle destination, bool tiled)
+  {
+    MapFieldDataFromSourceToDestinationAlgo algo;
+    algo.set(Parameters::TiledMapping, tiled);
+    FieldHandle output;
+    EXPECT_TRUE(algo.runImpl(source, destination, output));
+    return output;
+  }
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, TiledMappingInterpolatesLikeIndexOrder)
+{
+  auto source = LinearLatVol(20, Point(-1, -1, -1), Point(1, 1, 1));
+  auto destination = LinearLatVol(23, Point(-0.9, -0.9, -0.9), Point(0.9, 0.9, 0.9));
+
+  auto tiled = mapLinearData(source, destination, true);
+  auto ordered = mapLinearData(source, destination, false);
+  ASSERT_TRUE(tiled != nullptr);
+  ASSERT_TRUE(ordered != nullptr);
+
+  VMesh* mesh = tiled->vmesh();
+  Point p;
+  for (VMesh::Node::index_type n(0); n < mesh->num_nodes(); ++n)
+  {
+    mesh->get_center(p, n);
+    double a, b;
+    tiled->vfield()->get_value(a, n);
+    ordered->vfield()->get_value(b, n);
+    ASSERT_NEAR(p.x() + 2*p.y() + 3*p.z(), a, 1e-10);
+    ASSERT_NEAR(b, a, 1e-10);
+  }
+}
@@ -0,0 +1,210 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrixFromMap.h>
+#include <Core/Algorithms/Legacy/Fields/RefineMesh/RefineMeshTetVolAlgoV.h>
+#include <Core/Algorithms/Field/RefineTetMeshLocallyAlgorithm.h>
+#include <Core/Algorithms/Legacy/Fields/ConvertMeshType/ConvertMeshToTetVolMesh.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Tetrahedral version of the [-1,1] cube with the x coordinate as node data
+  FieldHandle XRampTetVol()
+  {
+    FieldHandle latVol = CreateEmptyLatVol(5, 5, 5);
+    ConvertMeshToTetVolMeshAlgo convert;
+    FieldHandle tetVol;
+    convert.run(latVol, tetVol);
+
+    VMesh* mesh = tetVol->vmesh();
+    VField* field = tetVol->vfield();
+    Point p;
+    for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); idx++)
+    {
+      mesh->get_point(p, idx);
+      field->set_value(p.x(), idx);
+    }
+    return tetVol;
+  }
+
+  double TotalVolume(VMesh* mesh)
+  {
+    double volume = 0.0;
+    for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); idx++)
+      volume += std::fabs(mesh->get_size(idx));
+    return volume;
+  }
+
+  // FNV-1a over the raw bytes, to compare arrays against recorded output
+  void HashBytes(uint64_t& hash, const void* data, size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t k = 0; k < size; k++)
+    {
+      hash ^= bytes[k];
+      hash *= 1099511628211ULL;
+    }
+  }
+}
+
+TEST(RefineMeshTetVolAlgoTests, SplitsEveryTetIntoEight)
+{
+  auto input = XRampTetVol();
+  VMesh* imesh = input->vmesh();
+  imesh->synchronize(Mesh::EDGES_E);
+
+  RefineMeshTetVolAlgoV algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(input, output, "all", 0.0));
+
+  VMesh* omesh = output->vmesh();
+  VField* ofield = output->vfield();
+  EXPECT_EQ(imesh->num_nodes() + imesh->num_edges(), omesh->num_nodes());
+  EXPECT_EQ(8 * imesh->num_elems(), omesh->num_elems());
+  EXPECT_NEAR(TotalVolume(imesh), TotalVolume(omesh), 1e-10);
+
+  // The input nodes come first, followed by the edge midpoints with the
+  // interpolated ramp
+  Point ip, op;
+  for (VMesh::Node::index_type idx = 0; idx < imesh->num_nodes(); idx++)
+  {
+    imesh->get_point(ip, idx);
+    omesh->get_point(op, idx);
+    EXPECT_EQ(ip, op);
+  }
+  double value;
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); idx++)
+  {
+    omesh->get_point(op, idx);
+    ofield->get_value(value, idx);
+    EXPECT_NEAR(op.x(), value, 1e-12);
+  }
+}
+
+TEST(RefineMeshTetVolAlgoTests, KeepsTheMeshConformingWhenRefiningPartOfIt)
+{
+  auto input = XRampTetVol();
+  VMesh* imesh = input->vmesh();
+
+  RefineMeshTetVolAlgoV algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(input, output, "greaterthan", 0.2));
+
+  VMesh* omesh = output->vmesh();
+  EXPECT_GT(omesh->num_elems(), imesh->num_elems());
+  EXPECT_LT(omesh->num_elems(), 8 * imesh->num_elems());
+  EXPECT_NEAR(TotalVolume(imesh), TotalVolume(omesh), 1e-10);
+
+  // A split edge that one of its tets does not know about would leave
+  // unmatched faces inside the cube, adding to the area of the boundary
+  omesh->synchronize(Mesh::FACES_E | Mesh::ELEM_NEIGHBORS_E);
+  VMesh::Elem::index_type neighbor;
+  VMesh::DElem::array_type faces;
+  double boundary = 0.0;
+  for (VMesh::Elem::index_type idx = 0; idx < omesh->num_elems(); idx++)
+  {
+    omesh->get_delems(faces, idx);
+    for (size_t k = 0; k < faces.size(); k++)
+      if (!omesh->get_neighbor(neighbor, idx, faces[k])) boundary += omesh->get_size(VMesh::Face::index_type(faces[k]));
+  }
+  EXPECT_NEAR(24.0, boundary, 1e-10);
+}
+
+TEST(RefineTetMeshLocallyAlgoTests, RefineMeshMatchesJoinFieldsNumbering)
+{
+  FieldHandle latVol = CreateEmptyLatVol(4, 4, 4);
+  ConvertMeshToTetVolMeshAlgo convert;
+  FieldHandle tetVol;
+  convert.run(latVol, tetVol);
+  FieldInformation fi(tetVol);
+  fi.make_constantdata();
+  FieldHandle input = CreateField(fi, tetVol->mesh());
+  input->vfield()->resize_values();
+
+  // Cut a scattered set of edges so that the tets go through most of the
+  // splitting cases
+  VMesh* imesh = input->vmesh();
+  imesh->synchronize(Mesh::EDGES_E);
+  SparseRowMatrixFromMap::Values cuts;
+  VMesh::Node::array_type nodes;
+  for (VMesh::Edge::index_type idx = 0; idx < imesh->num_edges(); idx++)
+  {
+    imesh->get_nodes(nodes, idx);
+    if ((nodes[0] + nodes[1]) % 3 == 0)
+      cuts[std::min(nodes[0], nodes[1])][std::max(nodes[0], nodes[1])] = 1;
+  }
+  auto cutEdges = SparseRowMatrixFromMap::make(imesh->num_nodes(), imesh->num_nodes(), cuts);
+
+  RefineTetMeshLocallyAlgorithm algo;
+  FieldHandle output = algo.RefineMesh(input, cutEdges);
+  ASSERT_TRUE(output != nullptr);
+
+  // Recorded from the version that added a point for every use of a new node
+  // and welded them with JoinFields
+  VMesh* omesh = output->vmesh();
+  ASSERT_EQ(148, omesh->num_nodes());
+  ASSERT_EQ(432, omesh->num_elems());
+
+  uint64_t pointHash = 14695981039346656037ULL;
+  Point p;
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); idx++)
+  {
+    omesh->get_point(p, idx);
+    const double coords[3] = { p.x(), p.y(), p.z() };
+    HashBytes(pointHash, coords, sizeof(coords));
+  }
+  EXPECT_EQ(2130395914894658452ULL, pointHash);
+
+  uint64_t elemHash = 14695981039346656037ULL;
+  for (VMesh::Elem::index_type idx = 0; idx < omesh->num_elems(); idx++)
+  {
+    omesh->get_nodes(nodes, idx);
+    for (size_t k = 0; k < nodes.size(); k++)
+    {
+      const long long node = nodes[k];
+      HashBytes(elemHash, &node, sizeof(node));
+    }
+  }
+  EXPECT_EQ(17591034836783873668ULL, elemHash);
+}
@@ -27,6 +27,9 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/FastSweeping.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceDistanceQuery.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingTiles.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -34,6 +37,7 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Logging/Log.h>
 #include <Core/Thread/Parallel.h>
+#include <boost/scoped_ptr.hpp>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -48,6 +52,7 @@ ALGORITHM_PARAMETER_DEF(Fields, Truncate);
 ALGORITHM_PARAMETER_DEF(Fields, TruncateDistance);
 ALGORITHM_PARAMETER_DEF(Fields, OutputFieldDatatype);
 ALGORITHM_PARAMETER_DEF(Fields, OutputValueField);
+ALGORITHM_PARAMETER_DEF(Fields, UseFastSweeping);
 
 CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
 {
@@ -55,6 +60,7 @@ CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
   addParameter(Truncate, false);
   addParameter(TruncateDistance, 1.0);
   addParameter(OutputValueField, false);
+  addParameter(UseFastSweeping, false);
   addOption(BasisType, "same as input","same as input|constant|linear");
   addOption(OutputFieldDatatype, "double","char|unsigned char|short|unsigned short|int|unsigned int|float|double");
 }
@@ -65,283 +71,133 @@ namespace detail
 class CalculateDistanceFieldP : public Interruptible
 {
   public:
-    CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField*  ofield, const AlgorithmBase* algo) :
-      imesh(imesh), objmesh(objmesh), objfield(0), ofield(ofield), vfield(0), algo_(algo) {}
+    CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, const SurfaceDistanceQuery* surface, VField*  ofield, const AlgorithmBase* algo) :
+      imesh(imesh), objmesh(objmesh), surface(surface), objfield(0), ofield(ofield), vfield(0), algo_(algo) {}
 
-    CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField* objfield, VField*  ofield, VField* vfield, const AlgorithmBase* algo) :
-      imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), algo_(algo)  {}
+    CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, const SurfaceDistanceQuery* surface, VField* objfield, VField*  ofield, VField* vfield, const AlgorithmBase* algo) :
+      imesh(imesh), objmesh(objmesh), surface(surface), objfield(objfield), ofield(ofield), vfield(vfield), algo_(algo)  {}
 
-    void parallel(int proc, int nproc)
+    void setup(int nproc)
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
+      // Values are handed out in tiles, in Morton order where there is one,
+      // so neighboring queries walk the same branches of the search structure
+      if (ofield->basis_order() > 1)
+        tiles_.setup(ofield->num_evalues(), 256);
+      else
+        tiles_.setup(ofield, imesh, true, nproc);
+    }
 
+    void parallel(int proc)
+    {
       double max = DBL_MAX;
       if (algo_->get(Parameters::Truncate).toBool())
       {
         max = algo_->get(Parameters::TruncateDistance).toDouble();
       }
 
-      double val = 0.0;
-      int cnt = 0;
-
       if (ofield->basis_order() == 0)
-      {
-        VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
-        {
-          checkForInterruption();
-          Point p, p2;
-          imesh->get_center(p,idx);
-          if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
-          ofield->set_value(val,idx);
-
-          if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
+        distances<VMesh::Elem::index_type>(proc,max);
       else if (ofield->basis_order() == 1)
-      {
-        VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Node::index_type idx=start; idx<end; idx++)
-        {
-          checkForInterruption();
-          Point p, p2;
-          imesh->get_center(p,idx);
-          if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
-          ofield->set_value(val,idx);
-
-          if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
+        distances<VMesh::Node::index_type>(proc,max);
       else if (ofield->basis_order() > 1)
-      {
-        VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_evalues);
-
-        for (VMesh::ENode::index_type idx=start; idx<end; idx++)
-        {
-          checkForInterruption();
-          Point p, p2;
-          imesh->get_center(p,idx);
-          if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
-          ofield->set_value(val,idx);
-
-          if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
+        distances<VMesh::ENode::index_type>(proc,max);
     }
 
-    void parallel2(int proc, int nproc)
+    void parallel2(int proc)
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
-
       if (algo_->get(Parameters::Truncate).toBool())
       {
         // Cannot do both at the same time
         if (proc == 0) algo_->warning("Closest value has been requested, disabling truncated distance map.");
       }
 
-      double val = 0.0;
-      int cnt = 0;
-
       if (ofield->basis_order() == 0)
-      {
-        VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        VMesh::coords_type coords;
-        Point p, p2;
-        range(proc,nproc,start,end,num_values);
-
-        if (objfield->is_scalar())
-        {
-          double scalar;
-
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(scalar,coords,fidx);
-            vfield->set_value(scalar,idx);
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-        else if (objfield->is_vector())
-        {
-          Vector vec;
-
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(vec,coords,fidx);
-            vfield->set_value(vec,idx);
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-        else if (objfield->is_tensor())
-        {
-          Tensor tensor;
-
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(tensor,coords,fidx);
-            vfield->set_value(tensor,idx);
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-      }
+        values<VMesh::Elem::index_type>(proc);
       else if (ofield->basis_order() == 1)
-      {
-        VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        VMesh::coords_type coords;
-        range(proc,nproc,start,end,num_values);
-        Point p, p2;
-
-        if (objfield->is_scalar())
-        {
-          double scalar;
-
-          for (VMesh::Node::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(scalar,coords,fidx);
-            vfield->set_value(scalar,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-        else if (objfield->is_vector())
-        {
-          Vector vec;
-
-          for (VMesh::Node::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(vec,coords,fidx);
-            vfield->set_value(vec,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-        else if (objfield->is_tensor())
-        {
-          Tensor tensor;
-
-          for (VMesh::Node::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(tensor,coords,fidx);
-            vfield->set_value(tensor,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-      }
+        values<VMesh::Node::index_type>(proc);
       else if (ofield->basis_order() > 1)
+        values<VMesh::ENode::index_type>(proc);
+    }
+
+  private:
+    bool find_closest(double& val, Point& p2, VMesh::coords_type& coords,
+                      VMesh::Elem::index_type& fidx, const Point& p, double max) const
+    {
+      if (!surface) return (objmesh->find_closest_elem(val,p2,coords,fidx,p,max));
+      if (!surface->find_closest_elem(val,p2,fidx,p,max)) return (false);
+      if (objfield) objmesh->get_coords(coords,p2,fidx);
+      return (true);
+    }
+
+    template<class INDEX>
+    void distances(int proc, double max)
+    {
+      MappingTiles::Cursor cursor(tiles_);
+      VMesh::Elem::index_type fidx;
+      VMesh::coords_type coords;
+      Point p, p2;
+      double val = 0.0;
+      int cnt = 0;
+
+      INDEX idx;
+      while (cursor.next(idx))
       {
-        VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        VMesh::coords_type coords;
-        range(proc,nproc,start,end,num_evalues);
-        Point p, p2;
-
-        if (objfield->is_scalar())
-        {
-          double scalar;
-          for (VMesh::ENode::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(scalar,coords,fidx);
-            vfield->set_value(scalar,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-        else if (objfield->is_vector())
-        {
-          Vector vec;
-          for (VMesh::ENode::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(vec,coords,fidx);
-            vfield->set_value(vec,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
-        else if (objfield->is_tensor())
-        {
-          Tensor tensor;
-          for (VMesh::ENode::index_type idx=start; idx<end; idx++)
-          {
-            checkForInterruption();
-            imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
-            ofield->set_value(val,idx);
-            objfield->interpolate(tensor,coords,fidx);
-            vfield->set_value(tensor,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
-          }
-        }
+        checkForInterruption();
+        imesh->get_center(p,idx);
+        if(!(find_closest(val,p2,coords,fidx,p,max))) val = max;
+        ofield->set_value(val,idx);
+
+        if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(cursor.position(),tiles_.size()); cnt = 0; } }
       }
     }
 
+    template<class INDEX>
+    void values(int proc)
+    {
+      if (objfield->is_scalar())
+        values<INDEX,double>(proc);
+      else if (objfield->is_vector())
+        values<INDEX,Vector>(proc);
+      else if (objfield->is_tensor())
+        values<INDEX,Tensor>(proc);
+    }
 
-    void range(int proc, int nproc,
-               VMesh::index_type& start, VMesh::index_type& end,
-               VMesh::size_type size)
+    template<class INDEX, class T>
+    void values(int proc)
     {
-      VMesh::size_type m = size/nproc;
-      start = proc*m;
-      end = (proc+1)*m;
-      if (proc == nproc-1) end = size;
+      MappingTiles::Cursor cursor(tiles_);
+      VMesh::Elem::index_type fidx;
+      VMesh::coords_type coords;
+      Point p, p2;
+      double val = 0.0;
+      T value;
+      int cnt = 0;
+
+      INDEX idx;
+      while (cursor.next(idx))
+      {
+        checkForInterruption();
+        imesh->get_center(p,idx);
+        find_closest(val,p2,coords,fidx,p,-1.0);
+        ofield->set_value(val,idx);
+        objfield->interpolate(value,coords,fidx);
+        vfield->set_value(value,idx);
+
+        if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(cursor.position(),tiles_.size()); cnt = 0; } }
+      }
     }
 
-  private:
     VMesh*   imesh;
     VMesh*   objmesh;
+    const SurfaceDistanceQuery* surface;
     VField*  objfield;
     VField*  ofield;
     VField*  vfield;
     const AlgorithmBase* algo_;
+    MappingTiles tiles_;
 };
 }
 
-//TODO refactor duplication
-
 bool
 CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, FieldHandle& output) const
 {
@@ -396,17 +252,56 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
-
   if (ofield->basis_order() > 2)
   {
     error("Cannot add distance data to field");
     return (false);
   }
 
-  detail::CalculateDistanceFieldP palgo(imesh,objmesh,ofield,this);
-  auto task_i = [&palgo,this](int i) { palgo.parallel(i, Parallel::NumCores()); };
-  Parallel::RunTasks(task_i, Parallel::NumCores());
+  // Triangle and quadrilateral surfaces are searched through a bounding
+  // volume hierarchy, other meshes through their own search grid
+  boost::scoped_ptr<SurfaceDistanceQuery> surface;
+  if (SurfaceDistanceQuery::supports(objmesh))
+    surface.reset(new SurfaceDistanceQuery(objmesh));
+  else
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+  if (get(Parameters::UseFastSweeping).toBool())
+  {
+    double max = DBL_MAX;
+    if (get(Parameters::Truncate).toBool())
+      max = get(Parameters::TruncateDistance).toDouble();
+
+    FastSweeping sweeping;
+    if (surface && ofield->basis_order() == 1 && sweeping.setup(imesh))
+    {
+      const double band = sweeping.band_width();
+      const size_type seeded = sweeping.seed([&surface,band](const Point& p, double& dist)
+      {
+        Point r;
+        VMesh::Elem::index_type fidx;
+        return (surface->find_closest_elem(dist,r,fidx,p,band));
+      });
+
+      // Without nodes near the object there is nothing to sweep from
+      if (seeded > 0)
+      {
+        sweeping.sweep();
+        sweeping.get_values(ofield,max);
+        return (true);
+      }
+    }
+    else
+    {
+      warning("Fast sweeping needs a LatVol with data on the nodes and a surface object, computing exact distances instead.");
+    }
+  }
+
+  const int np = Parallel::NumCores();
+  detail::CalculateDistanceFieldP palgo(imesh,objmesh,surface.get(),ofield,this);
+  palgo.setup(np);
+  auto task_i = [&palgo](int i) { palgo.parallel(i); };
+  Parallel::RunTasks(task_i, np);
 
   return (true);
 }
@@ -481,17 +376,23 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
-
   if (distance->basis_order() > 2)
   {
     error("Cannot add distance data to field");
     return (false);
   }
 
-  detail::CalculateDistanceFieldP palgo(imesh,objmesh,objfield,dfield,vfield,this);
-  auto task_i = [&palgo,this](int i) { palgo.parallel2(i, Parallel::NumCores()); };
-  Parallel::RunTasks(task_i, Parallel::NumCores());
+  boost::scoped_ptr<SurfaceDistanceQuery> surface;
+  if (SurfaceDistanceQuery::supports(objmesh))
+    surface.reset(new SurfaceDistanceQuery(objmesh));
+  else
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+  const int np = Parallel::NumCores();
+  detail::CalculateDistanceFieldP palgo(imesh,objmesh,surface.get(),objfield,dfield,vfield,this);
+  palgo.setup(np);
+  auto task_i = [&palgo](int i) { palgo.parallel2(i); };
+  Parallel::RunTasks(task_i, np);
 
   return (true);
 }
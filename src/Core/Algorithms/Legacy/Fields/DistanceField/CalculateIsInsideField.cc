@@ -27,16 +27,21 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateIsInsideField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceDistanceQuery.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 
@@ -126,14 +131,22 @@ CalculateIsInsideFieldAlgo::runImpl(FieldHandle input, FieldHandle objfield, Fie
 
   ofield->set_all_values(outside_value);
 
-  objmesh->synchronize(Mesh::ELEM_LOCATE_E);
+  // A closed triangle or quadrilateral surface encloses the points inside
+  // it, other objects contain the points that fall in one of their elements
+  boost::scoped_ptr<SurfaceDistanceQuery> surface;
+  if (SurfaceDistanceQuery::supports(objmesh))
+    surface.reset(new SurfaceDistanceQuery(objmesh));
+  else
+    objmesh->synchronize(Mesh::ELEM_LOCATE_E);
 
-  VMesh::size_type num_elems = omesh->num_elems();
-  VMesh::Node::array_type nodes;
-  VMesh::Elem::index_type cidx;
+  auto point_inside = [&surface,objmesh](const Point& p)
+  {
+    if (surface) return (surface->inside(p));
+    VMesh::Elem::index_type cidx;
+    return (objmesh->locate(cidx,p));
+  };
 
-  std::vector<Point> points;
-  std::vector<Point> points2;
+  VMesh::size_type num_elems = omesh->num_elems();
 
   std::vector<VMesh::coords_type> coords;
   std::vector<double> weights;
@@ -146,94 +159,45 @@ CalculateIsInsideFieldAlgo::runImpl(FieldHandle input, FieldHandle objfield, Fie
   else if (sampling_scheme == "regular5") omesh->get_regular_scheme(coords,weights,5);
 
   std::string method = getOption(Parameters::CalcInsideMethod);
+  const bool method_one = (method == "one");
+  const bool method_all = (method == "all");
 
-  if (method == "one")
+  // Elements are independent, each chunk keeps its own sample buffers
+  Parallel::For(0, num_elems, [&](size_t first, size_t last)
   {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-    {
-      omesh->get_nodes(nodes,idx);
-      omesh->get_centers(points,nodes);
-      omesh->minterpolate(points2,coords,idx);
+    VMesh::Node::array_type nodes;
+    std::vector<Point> points;
+    std::vector<Point> points2;
 
-      bool is_inside = false;
-
-      for (size_t r=0; r< points2.size(); r++)
-      {
-        if (objmesh->locate(cidx,points2[r]))
-        {
-          is_inside = true; break;
-        }
-      }
-
-      if (!is_inside)
-      {
-        for (size_t r=0; r< points.size(); r++)
-        {
-          if (objmesh->locate(cidx,points[r]))
-          {
-            is_inside = true; break;
-          }
-        }
-      }
-
-      if (is_inside) ofield->set_value(inside_value,idx);
-    }
-  }
-  else if (method == "all")
-  {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
+    for (VMesh::Elem::index_type idx = first; idx < static_cast<VMesh::index_type>(last); idx++)
     {
       omesh->get_nodes(nodes,idx);
       omesh->get_centers(points,nodes);
       omesh->minterpolate(points2,coords,idx);
 
-      bool is_inside = true;
-
-      for (size_t r=0; r< points2.size(); r++)
+      bool is_inside;
+      if (method_one)
       {
-        if (!(objmesh->locate(cidx,points2[r])))
-        {
-          is_inside = false; break;
-        }
+        is_inside = std::any_of(points2.begin(),points2.end(),point_inside) ||
+                    std::any_of(points.begin(),points.end(),point_inside);
       }
-
-      if (is_inside)
-      {
-        for (size_t r=0; r< points.size(); r++)
-        {
-          if (!(objmesh->locate(cidx,points[r])))
-          {
-            is_inside = false; break;
-          }
-        }
-      }
-
-      if (is_inside) ofield->set_value(inside_value,idx);
-    }
-  }
-  else
-  {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-    {
-      omesh->get_nodes(nodes,idx);
-      omesh->get_centers(points,nodes);
-      omesh->minterpolate(points2,coords,idx);
-
-      int outside = 0;
-      int inside = 0;
-      for (size_t r=0; r< points2.size(); r++)
+      else if (method_all)
       {
-        if (objmesh->locate(cidx,points2[r])) inside++; else outside++;
+        is_inside = std::all_of(points2.begin(),points2.end(),point_inside) &&
+                    std::all_of(points.begin(),points.end(),point_inside);
       }
-
-      for (size_t r=0; r< points.size(); r++)
+      else
       {
-        if (objmesh->locate(cidx,points[r])) inside++; else outside++;
+        const size_t total = points2.size() + points.size();
+        const size_t inside =
+          std::count_if(points2.begin(),points2.end(),point_inside) +
+          std::count_if(points.begin(),points.end(),point_inside);
+        is_inside = (2*inside >= total);
       }
 
-      if (inside >= outside) ofield->set_value(inside_value,idx);
+      if (is_inside) ofield->set_value(inside_value,idx);
     }
-  }
+  });
 
   return (true);
 }
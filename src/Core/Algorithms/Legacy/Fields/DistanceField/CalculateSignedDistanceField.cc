@@ -27,12 +27,17 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/FastSweeping.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceDistanceQuery.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingTiles.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Thread/Parallel.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/GeometryPrimitives/CompGeom.h>
+#include <boost/scoped_ptr.hpp>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -45,622 +50,178 @@ using namespace SCIRun::Core::Algorithms::Fields;
 class CalculateSignedDistanceFieldP : public Interruptible
 {
   public:
-    CalculateSignedDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField*  ofield, const ProgressReporter* pr) :
-      imesh(imesh), objmesh(objmesh), ofield(ofield), pr_(pr) {}
+    CalculateSignedDistanceFieldP(VMesh* imesh, VMesh* objmesh, const SurfaceDistanceQuery* surface,
+            VField*  ofield, const ProgressReporter* pr) :
+      imesh(imesh), objmesh(objmesh), surface(surface), objfield(0), ofield(ofield), vfield(0), pr_(pr),
+      epsilon_(objmesh->get_epsilon()) {}
 
-    CalculateSignedDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField* objfield,
+    CalculateSignedDistanceFieldP(VMesh* imesh, VMesh* objmesh, const SurfaceDistanceQuery* surface, VField* objfield,
             VField* ofield, VField* vfield, const ProgressReporter* pr) :
-      imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), pr_(pr) {}
+      imesh(imesh), objmesh(objmesh), surface(surface), objfield(objfield), ofield(ofield), vfield(vfield), pr_(pr),
+      epsilon_(objmesh->get_epsilon()) {}
 
-    void parallel(int proc, int nproc)
+    void setup(int nproc)
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
+      // Values are handed out in tiles, in Morton order where there is one,
+      // so neighboring queries walk the same branches of the search structure
+      if (ofield->basis_order() > 1)
+        tiles_.setup(ofield->num_evalues(), 256);
+      else
+        tiles_.setup(ofield, imesh, true, nproc);
+    }
 
-      double val = 0.0;
-      double epsilon = objmesh->get_epsilon();
-      int cnt = 0;
+    void parallel(int proc)
+    {
+      if (ofield->basis_order() == 0)
+        distances<VMesh::Elem::index_type>(proc);
+      else if (ofield->basis_order() == 1)
+        distances<VMesh::Node::index_type>(proc);
+      else if (ofield->basis_order() > 1)
+        distances<VMesh::ENode::index_type>(proc);
+    }
 
+    void parallel2(int proc)
+    {
       if (ofield->basis_order() == 0)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Elem::index_type idx = start; idx < end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-
-          objmesh->find_closest_elem(val,p2,fidx,p);
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2); k.normalize();
-
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
+        values<VMesh::Elem::index_type>(proc);
       else if (ofield->basis_order() == 1)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Node::index_type idx =start; idx <end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
+        values<VMesh::Node::index_type>(proc);
       else if (ofield->basis_order() > 1)
+        values<VMesh::ENode::index_type>(proc);
+    }
+
+    // Give the distance val from p to its closest point p2 on element fidx
+    // a negative sign when p lies behind the element
+    double signed_distance(double val, const Point& p, const Point& p2,
+                           VMesh::Elem::index_type fidx) const
+    {
+      Vector k(p-p2);
+      k.normalize();
+
+      double angle = Dot(normal(fidx),k);
+      if (angle < -epsilon_) return (-val);
+      if (angle > epsilon_ || val == 0.0) return (val);
+
+      // p lies in the plane of the element, so its closest point is on an
+      // edge: the element on the other side of the nearest edge decides
+      VMesh::DElem::array_type delems;
+      VMesh::Node::array_type nodes;
+      Point p0, p1;
+      objmesh->get_delems(delems,fidx);
+      double mindist = DBL_MAX;
+      size_t edgeidx = 0;
+      for (size_t r=0; r<delems.size(); r++)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_evalues);
-
-        for (VMesh::ENode::index_type idx=start; idx < end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_evalue(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
+        objmesh->get_nodes(nodes,delems[r]);
+        objmesh->get_center(p0,nodes[0]);
+        objmesh->get_center(p1,nodes[1]);
+        const double dist = distance_to_line2(p,p0,p1);
+        if (dist < mindist) { mindist = dist; edgeidx = r; }
       }
+
+      VMesh::Elem::index_type fidx_n;
+      if (objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]))
+        angle = Dot(normal(fidx_n),k);
+      return ((angle < 0.0) ? -val : val);
     }
 
-    void parallel2(int proc, int nproc)
+  private:
+    Vector normal(VMesh::Elem::index_type fidx) const
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
+      VMesh::Node::array_type nodes;
+      Point n0, n1, n2;
+      objmesh->get_nodes(nodes,fidx);
+      objmesh->get_center(n0,nodes[0]);
+      objmesh->get_center(n1,nodes[1]);
+      objmesh->get_center(n2,nodes[2]);
+      return (Cross(Vector(n1-n0),Vector(n2-n1)));
+    }
 
+    void find_closest(double& val, Point& p2, VMesh::coords_type& coords,
+                      VMesh::Elem::index_type& fidx, const Point& p) const
+    {
+      if (!surface)
+      {
+        objmesh->find_closest_elem(val,p2,coords,fidx,p);
+        return;
+      }
+      surface->find_closest_elem(val,p2,fidx,p);
+      if (objfield) objmesh->get_coords(coords,p2,fidx);
+    }
+
+    template<class INDEX>
+    void distances(int proc)
+    {
+      MappingTiles::Cursor cursor(tiles_);
+      VMesh::Elem::index_type fidx;
+      VMesh::coords_type coords;
+      Point p, p2;
       double val = 0.0;
-      double epsilon = objmesh->get_epsilon();
       int cnt = 0;
 
-      if (ofield->basis_order() == 0)
+      INDEX idx;
+      while (cursor.next(idx))
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        VMesh::coords_type coords;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Elem::index_type idx = start; idx < end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-
-          objmesh->find_closest_elem(val,p2,coords,fidx,p);
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2); k.normalize();
-
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (objfield->is_scalar())
-          {
-            double val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_vector())
-          {
-            Vector val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_tensor())
-          {
-            Tensor val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
-      else if (ofield->basis_order() == 1)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        VMesh::coords_type coords;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Node::index_type idx =start; idx <end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,coords,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 Point p1, p2;
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (objfield->is_scalar())
-          {
-            double val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_vector())
-          {
-            Vector val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_tensor())
-          {
-            Tensor val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
-      else if (ofield->basis_order() > 1)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        VMesh::coords_type coords;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_evalues);
-
-        for (VMesh::ENode::index_type idx=start; idx < end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,coords,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_evalue(val,idx);
-          if (objfield->is_scalar())
-          {
-            double val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_vector())
-          {
-            Vector val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_tensor())
-          {
-            Tensor val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
+        checkForInterruption();
+        imesh->get_center(p,idx);
+        find_closest(val,p2,coords,fidx,p);
+        ofield->set_value(signed_distance(val,p,p2,fidx),idx);
+
+        if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(cursor.position(),tiles_.size()); cnt = 0; } }
       }
     }
 
+    template<class INDEX>
+    void values(int proc)
+    {
+      if (objfield->is_scalar())
+        values<INDEX,double>(proc);
+      else if (objfield->is_vector())
+        values<INDEX,Vector>(proc);
+      else if (objfield->is_tensor())
+        values<INDEX,Tensor>(proc);
+    }
 
-    void range(int proc, int nproc,
-               VMesh::index_type& start, VMesh::index_type& end,
-               VMesh::size_type size)
+    template<class INDEX, class T>
+    void values(int proc)
     {
-      VMesh::size_type m = size/nproc;
-      start = proc*m;
-      end = (proc+1)*m;
-      if (proc == nproc-1) end = size;
+      MappingTiles::Cursor cursor(tiles_);
+      VMesh::Elem::index_type fidx;
+      VMesh::coords_type coords;
+      Point p, p2;
+      double val = 0.0;
+      T value;
+      int cnt = 0;
+
+      INDEX idx;
+      while (cursor.next(idx))
+      {
+        checkForInterruption();
+        imesh->get_center(p,idx);
+        find_closest(val,p2,coords,fidx,p);
+        ofield->set_value(signed_distance(val,p,p2,fidx),idx);
+        objfield->interpolate(value,coords,fidx);
+        vfield->set_value(value,idx);
+
+        if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(cursor.position(),tiles_.size()); cnt = 0; } }
+      }
     }
 
-  private:
     VMesh*   imesh;
     VMesh*   objmesh;
+    const SurfaceDistanceQuery* surface;
     VField*  objfield;
     VField*  ofield;
     VField*  vfield;
-
     const ProgressReporter* pr_;
+    double epsilon_;
+    MappingTiles tiles_;
 };
 
 CalculateSignedDistanceFieldAlgo::CalculateSignedDistanceFieldAlgo()
 {
   addParameter(OutputValueField, false);
+  addParameter(Parameters::UseFastSweeping, false);
 }
 
 bool
@@ -718,10 +279,53 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
-  CalculateSignedDistanceFieldP palgo(imesh, objmesh, ofield, this);
+  // Triangle and quadrilateral surfaces are searched through a bounding
+  // volume hierarchy, other meshes through their own search grid
+  boost::scoped_ptr<SurfaceDistanceQuery> surface;
+  if (SurfaceDistanceQuery::supports(objmesh))
+  {
+    surface.reset(new SurfaceDistanceQuery(objmesh));
+    objmesh->synchronize(Mesh::EDGES_E);
+  }
+  else
+  {
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+  }
+
+  CalculateSignedDistanceFieldP palgo(imesh, objmesh, surface.get(), ofield, this);
+
+  if (get(Parameters::UseFastSweeping).toBool())
+  {
+    FastSweeping sweeping;
+    if (surface && ofield->basis_order() == 1 && sweeping.setup(imesh))
+    {
+      const double band = sweeping.band_width();
+      const size_type seeded = sweeping.seed([&surface,&palgo,band](const Point& p, double& dist)
+      {
+        Point r;
+        VMesh::Elem::index_type fidx;
+        if (!surface->find_closest_elem(dist,r,fidx,p,band)) return (false);
+        dist = palgo.signed_distance(dist,p,r,fidx);
+        return (true);
+      });
+
+      // Without nodes near the object there is nothing to sweep from
+      if (seeded > 0)
+      {
+        sweeping.sweep();
+        sweeping.get_values(ofield,DBL_MAX);
+        return (true);
+      }
+    }
+    else
+    {
+      warning("Fast sweeping needs a LatVol with data on the nodes and a surface object, computing exact distances instead.");
+    }
+  }
+
   const int numThreads = Parallel::NumCores();
-  auto task_i = [&palgo,numThreads,this](int i) { palgo.parallel(i, numThreads); };
+  palgo.setup(numThreads);
+  auto task_i = [&palgo](int i) { palgo.parallel(i); };
   Parallel::RunTasks(task_i, numThreads);
 
   return (true);
@@ -800,18 +404,28 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
-
   if (distance->basis_order() > 2)
   {
     error("Cannot add distance data to field");
     return (false);
   }
 
-  CalculateSignedDistanceFieldP palgo(imesh, objmesh, objfield, dfield, vfield, this);
+  boost::scoped_ptr<SurfaceDistanceQuery> surface;
+  if (SurfaceDistanceQuery::supports(objmesh))
+  {
+    surface.reset(new SurfaceDistanceQuery(objmesh));
+    objmesh->synchronize(Mesh::EDGES_E);
+  }
+  else
+  {
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+  }
 
-  auto task_i = [&palgo,this](int i) { palgo.parallel2(i, Parallel::NumCores()); };
-  Parallel::RunTasks(task_i, Parallel::NumCores());
+  const int numThreads = Parallel::NumCores();
+  CalculateSignedDistanceFieldP palgo(imesh, objmesh, surface.get(), objfield, dfield, vfield, this);
+  palgo.setup(numThreads);
+  auto task_i = [&palgo](int i) { palgo.parallel2(i); };
+  Parallel::RunTasks(task_i, numThreads);
 
   return (true);
 }
@@ -0,0 +1,203 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/FastSweeping.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+
+#include <algorithm>
+#include <cfloat>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+FastSweeping::FastSweeping() :
+  ni_(0), nj_(0), nk_(0), band_(0.0)
+{
+  h_[0] = h_[1] = h_[2] = 0.0;
+}
+
+bool
+FastSweeping::setup(VMesh* mesh)
+{
+  if (!mesh->is_latvolmesh()) return (false);
+
+  VMesh::dimension_type dims;
+  mesh->get_dimensions(dims);
+  if (dims.size() != 3 || dims[0] < 2 || dims[1] < 2 || dims[2] < 2) return (false);
+  ni_ = dims[0]; nj_ = dims[1]; nk_ = dims[2];
+
+  Point p;
+  mesh->get_center(origin_,VMesh::Node::index_type(0));
+  mesh->get_center(p,VMesh::Node::index_type(1));
+  axis_[0] = p - origin_;
+  mesh->get_center(p,VMesh::Node::index_type(ni_));
+  axis_[1] = p - origin_;
+  mesh->get_center(p,VMesh::Node::index_type(ni_*nj_));
+  axis_[2] = p - origin_;
+
+  for (int d = 0; d < 3; d++)
+  {
+    h_[d] = axis_[d].length();
+    if (h_[d] <= 0.0) return (false);
+  }
+
+  // The update below assumes the lattice directions are perpendicular
+  for (int d = 0; d < 3; d++)
+  {
+    const int e = (d+1)%3;
+    if (std::fabs(Dot(axis_[d],axis_[e])) > 1e-6*h_[d]*h_[e]) return (false);
+  }
+
+  // Two cell diagonals, so every node next to the band has neighbors with
+  // exact values on all sides the characteristics come from
+  band_ = 2.0*std::sqrt(h_[0]*h_[0]+h_[1]*h_[1]+h_[2]*h_[2]);
+
+  const size_type num = ni_*nj_*nk_;
+  dist_.assign(num,DBL_MAX);
+  sign_.assign(num,0);
+  fixed_.assign(num,0);
+  return (true);
+}
+
+Point
+FastSweeping::node_center(index_type n) const
+{
+  const index_type i = n % ni_;
+  const index_type jk = n / ni_;
+  const index_type j = jk % nj_;
+  const index_type k = jk / nj_;
+  return (origin_ + axis_[0]*static_cast<double>(i) +
+          axis_[1]*static_cast<double>(j) + axis_[2]*static_cast<double>(k));
+}
+
+double
+FastSweeping::update(index_type n, index_type i, index_type j, index_type k, signed char& sign) const
+{
+  // Smallest neighbor value along each axis, the upwind direction
+  double a[3];
+  double h[3];
+  signed char s[3];
+  const index_type stride[3] = { 1, ni_, ni_*nj_ };
+  const index_type pos[3] = { i, j, k };
+  const size_type size[3] = { ni_, nj_, nk_ };
+
+  for (int d = 0; d < 3; d++)
+  {
+    a[d] = DBL_MAX; s[d] = 0; h[d] = h_[d];
+    if (pos[d] > 0 && dist_[n-stride[d]] < a[d])
+    {
+      a[d] = dist_[n-stride[d]]; s[d] = sign_[n-stride[d]];
+    }
+    if (pos[d] < size[d]-1 && dist_[n+stride[d]] < a[d])
+    {
+      a[d] = dist_[n+stride[d]]; s[d] = sign_[n+stride[d]];
+    }
+  }
+
+  // Sort the axes on their neighbor value
+  for (int p = 1; p < 3; p++)
+  {
+    for (int q = p; q > 0 && a[q] < a[q-1]; q--)
+    {
+      std::swap(a[q],a[q-1]); std::swap(h[q],h[q-1]); std::swap(s[q],s[q-1]);
+    }
+  }
+  if (a[0] == DBL_MAX) return (DBL_MAX);
+  sign = s[0];
+
+  // Godunov upwind solution, add axes while they are upwind of the result
+  double u = a[0] + h[0];
+  double A = 0.0, B = 0.0, C = -1.0;
+  for (int d = 0; d < 3; d++)
+  {
+    if (d > 0 && u <= a[d]) break;
+    const double w = 1.0/(h[d]*h[d]);
+    A += w; B += a[d]*w; C += a[d]*a[d]*w;
+    if (d == 0) continue;
+    const double disc = B*B - A*C;
+    if (disc < 0.0) break;
+    u = (B + std::sqrt(disc))/A;
+  }
+  return (u);
+}
+
+void
+FastSweeping::sweep()
+{
+  const double tolerance = 1e-9*std::min(h_[0],std::min(h_[1],h_[2]));
+  const int max_iterations = 16;
+
+  for (int iter = 0; iter < max_iterations; iter++)
+  {
+    double change = 0.0;
+    for (int order = 0; order < 8; order++)
+    {
+      Core::Thread::Interruptible::checkForInterruption();
+      const bool ri = (order & 1) != 0;
+      const bool rj = (order & 2) != 0;
+      const bool rk = (order & 4) != 0;
+      for (index_type kk = 0; kk < nk_; kk++)
+      {
+        const index_type k = rk ? nk_-1-kk : kk;
+        for (index_type jj = 0; jj < nj_; jj++)
+        {
+          const index_type j = rj ? nj_-1-jj : jj;
+          for (index_type ii = 0; ii < ni_; ii++)
+          {
+            const index_type i = ri ? ni_-1-ii : ii;
+            const index_type n = i + ni_*(j + nj_*k);
+            if (fixed_[n]) continue;
+
+            signed char sign = 0;
+            const double u = update(n,i,j,k,sign);
+            if (u < dist_[n])
+            {
+              change = std::max(change,dist_[n]-u);
+              dist_[n] = u;
+              sign_[n] = sign;
+            }
+          }
+        }
+      }
+    }
+    if (change <= tolerance) break;
+  }
+}
+
+void
+FastSweeping::get_values(VField* field, double max) const
+{
+  const size_type num = static_cast<size_type>(dist_.size());
+  for (VMesh::Node::index_type n = 0; n < num; n++)
+  {
+    const double val = std::min(dist_[n],max);
+    field->set_value((sign_[n] < 0) ? -val : val,n);
+  }
+}
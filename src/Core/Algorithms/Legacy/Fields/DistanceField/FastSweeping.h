@@ -0,0 +1,125 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_FASTSWEEPING_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_FASTSWEEPING_H 1
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Thread/Interruptible.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+// Distance on the nodes of a LatVol mesh, computed exactly only in a narrow
+// band around the object. The rest of the lattice is filled in by solving
+// |grad d| = 1 with Gauss-Seidel sweeps in the eight diagonal orderings of the
+// lattice (fast sweeping), which costs a few passes over the nodes instead of
+// a closest point search per node. Outside the band the result is first order
+// accurate in the lattice spacing. The sign of the band values is carried
+// along by the sweeps, so a signed distance stays signed.
+
+class SCISHARE FastSweeping
+{
+  public:
+    FastSweeping();
+
+    // Take the geometry of the lattice, returns false when mesh is not a
+    // LatVol with orthogonal axes
+    bool setup(VMesh* mesh);
+
+    // Width of the band that has to be seeded with exact distances
+    double band_width() const { return (band_); }
+
+    // Call exact(p,dist) for every node; it returns false if the node is
+    // further than band_width() from the object and otherwise the (signed)
+    // distance. Nodes are evaluated in parallel, a slab of lattice layers at
+    // a time, and the calling thread checks for interruption between slabs:
+    // the pool threads running exact do not see an interrupt. The number of
+    // nodes in the band is returned.
+    template<class EXACT>
+    size_type seed(EXACT exact)
+    {
+      const size_t num = dist_.size();
+      const size_t slab = std::max<size_t>(1, static_cast<size_t>(ni_*nj_)) * 8;
+      size_type seeded = 0;
+      for (size_t begin = 0; begin < num; begin += slab)
+      {
+        Core::Thread::Interruptible::checkForInterruption();
+        seeded += Core::Thread::Parallel::Reduce(begin, std::min(begin + slab, num), size_type(0),
+          [&](size_t first, size_t last, size_type count)
+          {
+            for (size_t n = first; n < last; n++)
+            {
+              double d;
+              if (exact(node_center(static_cast<index_type>(n)),d))
+              {
+                dist_[n] = std::fabs(d);
+                sign_[n] = (d < 0.0) ? -1 : 1;
+                fixed_[n] = 1;
+                count++;
+              }
+            }
+            return (count);
+          },
+          [](size_type a, size_type b) { return (a+b); });
+      }
+      return (seeded);
+    }
+
+    // Fill in the nodes outside the band
+    void sweep();
+
+    // Store the distances in field, which has its values on the nodes of the
+    // lattice. Values are clamped to max.
+    void get_values(VField* field, double max) const;
+
+  private:
+    Core::Geometry::Point node_center(index_type n) const;
+    double update(index_type n, index_type i, index_type j, index_type k, signed char& sign) const;
+
+    size_type ni_, nj_, nk_;
+    Core::Geometry::Point origin_;
+    Core::Geometry::Vector axis_[3];
+    double h_[3];
+    double band_;
+
+    std::vector<double> dist_;
+    std::vector<signed char> sign_;
+    std::vector<char> fixed_;
+};
+
+}}}}
+
+#endif
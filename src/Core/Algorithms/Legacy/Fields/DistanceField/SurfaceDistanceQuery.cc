@@ -0,0 +1,327 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceDistanceQuery.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/GeometryPrimitives/CompGeom.h>
+
+#include <cfloat>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+namespace
+{
+  inline double dot3(const double* a, const double* b)
+    { return (a[0]*b[0]+a[1]*b[1]+a[2]*b[2]); }
+
+  inline void cross3(double* r, const double* a, const double* b)
+  {
+    r[0] = a[1]*b[2]-a[2]*b[1];
+    r[1] = a[2]*b[0]-a[0]*b[2];
+    r[2] = a[0]*b[1]-a[1]*b[0];
+  }
+
+  // Ray directions for the inside test, chosen away from the coordinate
+  // axes and planes so rays rarely run along the edges of structured meshes
+  const double ray_directions[5][3] =
+  {
+    {  0.6123,  0.4578,  0.6446 },
+    { -0.3711,  0.7853,  0.4951 },
+    {  0.5329, -0.2817, -0.7981 },
+    { -0.7071, -0.5213,  0.4779 },
+    {  0.2531, -0.8662,  0.4307 }
+  };
+}
+
+bool
+SurfaceDistanceQuery::supports(VMesh* mesh)
+{
+  return (mesh && (mesh->is_trisurfmesh() || mesh->is_quadsurfmesh()));
+}
+
+SurfaceDistanceQuery::SurfaceDistanceQuery(VMesh* mesh) :
+  epsilon_(0.0)
+{
+  const VMesh::size_type num_elems = mesh->num_elems();
+  const bool quads = mesh->is_quadsurfmesh();
+  triangles_.reserve(quads ? 2*num_elems : num_elems);
+
+  VMesh::Node::array_type nodes;
+  Point p0, p1, p2, p3;
+  for (VMesh::Elem::index_type idx = 0; idx < num_elems; idx++)
+  {
+    mesh->get_nodes(nodes,idx);
+    mesh->get_center(p0,nodes[0]);
+    mesh->get_center(p1,nodes[1]);
+    mesh->get_center(p2,nodes[2]);
+    add_triangle(p0,p1,p2,idx);
+    if (quads)
+    {
+      mesh->get_center(p3,nodes[3]);
+      add_triangle(p0,p2,p3,idx);
+    }
+  }
+
+  BBox bbox;
+  for (index_type i = 0; i < num_triangles(); i++)
+  {
+    const Triangle& t = triangles_[i];
+    const Point v0(t.v0[0],t.v0[1],t.v0[2]);
+    const Point v1 = v0 + Vector(t.e0[0],t.e0[1],t.e0[2]);
+    const Point v2 = v0 + Vector(t.e1[0],t.e1[1],t.e1[2]);
+    BBox box(v0,v1,v2);
+    bvh_.insert(i,box);
+    bbox.extend(box);
+  }
+  bvh_.build();
+
+  if (bbox.valid()) epsilon_ = bbox.diagonal().length()*1e-8;
+}
+
+void
+SurfaceDistanceQuery::add_triangle(const Point& p0, const Point& p1,
+                                   const Point& p2, VMesh::Elem::index_type elem)
+{
+  Triangle t;
+  for (int d = 0; d < 3; d++)
+  {
+    t.v0[d] = p0[d];
+    t.e0[d] = p1[d]-p0[d];
+    t.e1[d] = p2[d]-p0[d];
+  }
+  t.a00 = dot3(t.e0,t.e0);
+  t.a01 = dot3(t.e0,t.e1);
+  t.a11 = dot3(t.e1,t.e1);
+  t.det = t.a00*t.a11-t.a01*t.a01;
+  t.elem = elem;
+  triangles_.push_back(t);
+}
+
+double
+SurfaceDistanceQuery::closest_point(const Triangle& t, const double* q, double* r) const
+{
+  double diff[3] = { t.v0[0]-q[0], t.v0[1]-q[1], t.v0[2]-q[2] };
+  const double b0 = dot3(diff,t.e0);
+  const double b1 = dot3(diff,t.e1);
+  const double a00 = t.a00, a01 = t.a01, a11 = t.a11, det = t.det;
+
+  if (!(det > 0.0))
+  {
+    // Degenerate triangle, leave it to the general purpose test
+    Point result;
+    const Point v0(t.v0[0],t.v0[1],t.v0[2]);
+    closest_point_on_tri(result,Point(q[0],q[1],q[2]),v0,
+      v0+Vector(t.e0[0],t.e0[1],t.e0[2]),v0+Vector(t.e1[0],t.e1[1],t.e1[2]));
+    for (int d = 0; d < 3; d++) r[d] = result[d];
+  }
+  else
+  {
+    // Minimize the distance over the parameters (s,t) of the triangle,
+    // the region of the parameter plane decides which edge or corner
+    // clamps the unconstrained minimum
+    double s = a01*b1-a11*b0;
+    double u = a01*b0-a00*b1;
+
+    if (s+u <= det)
+    {
+      if (s < 0.0)
+      {
+        if (u < 0.0 && b0 < 0.0)
+        {
+          u = 0.0;
+          s = (-b0 >= a00) ? 1.0 : -b0/a00;
+        }
+        else
+        {
+          s = 0.0;
+          u = (b1 >= 0.0) ? 0.0 : ((-b1 >= a11) ? 1.0 : -b1/a11);
+        }
+      }
+      else if (u < 0.0)
+      {
+        u = 0.0;
+        s = (b0 >= 0.0) ? 0.0 : ((-b0 >= a00) ? 1.0 : -b0/a00);
+      }
+      else
+      {
+        s /= det;
+        u /= det;
+      }
+    }
+    else
+    {
+      const double denom = a00-2.0*a01+a11;
+      if (s < 0.0)
+      {
+        const double tmp0 = a01+b0, tmp1 = a11+b1;
+        if (tmp1 > tmp0)
+        {
+          const double numer = tmp1-tmp0;
+          s = (numer >= denom) ? 1.0 : numer/denom;
+          u = 1.0-s;
+        }
+        else
+        {
+          s = 0.0;
+          u = (tmp1 <= 0.0) ? 1.0 : ((b1 >= 0.0) ? 0.0 : -b1/a11);
+        }
+      }
+      else if (u < 0.0)
+      {
+        const double tmp0 = a01+b1, tmp1 = a00+b0;
+        if (tmp1 > tmp0)
+        {
+          const double numer = tmp1-tmp0;
+          u = (numer >= denom) ? 1.0 : numer/denom;
+          s = 1.0-u;
+        }
+        else
+        {
+          u = 0.0;
+          s = (tmp1 <= 0.0) ? 1.0 : ((b0 >= 0.0) ? 0.0 : -b0/a00);
+        }
+      }
+      else
+      {
+        const double numer = a11+b1-a01-b0;
+        if (numer <= 0.0)
+        {
+          s = 0.0;
+          u = 1.0;
+        }
+        else
+        {
+          s = (numer >= denom) ? 1.0 : numer/denom;
+          u = 1.0-s;
+        }
+      }
+    }
+
+    for (int d = 0; d < 3; d++) r[d] = t.v0[d]+s*t.e0[d]+u*t.e1[d];
+  }
+
+  diff[0] = r[0]-q[0]; diff[1] = r[1]-q[1]; diff[2] = r[2]-q[2];
+  return (dot3(diff,diff));
+}
+
+bool
+SurfaceDistanceQuery::find_closest_elem(double& dist, Point& result,
+                                        VMesh::Elem::index_type& elem,
+                                        const Point& p, double maxdist) const
+{
+  const double q[3] = { p.x(), p.y(), p.z() };
+  const double max_dist2 = (maxdist < 0.0) ? DBL_MAX : maxdist*maxdist;
+
+  double r[3];
+  index_type idx;
+  double dist2;
+  if (!bvh_.closest(idx,dist2,p,
+        [&](index_type i) { return (closest_point(triangles_[i],q,r)); },
+        max_dist2))
+  {
+    return (false);
+  }
+
+  closest_point(triangles_[idx],q,r);
+  result = Point(r[0],r[1],r[2]);
+  elem = triangles_[idx].elem;
+  dist = std::sqrt(dist2);
+  return (true);
+}
+
+int
+SurfaceDistanceQuery::crossings(const Point& q, const Vector& dir,
+                                bool& ambiguous, bool& on_surface) const
+{
+  const double o[3] = { q.x(), q.y(), q.z() };
+  const double d[3] = { dir.x(), dir.y(), dir.z() };
+  // Barycentric margin below which a crossing counts as hitting an edge
+  const double margin = 1e-9;
+
+  int count = 0;
+  ambiguous = false;
+  on_surface = false;
+  bvh_.intersect_ray(q,dir,[&](index_type i)
+  {
+    const Triangle& t = triangles_[i];
+    double pvec[3], qvec[3], normal[3];
+    const double tvec[3] = { o[0]-t.v0[0], o[1]-t.v0[1], o[2]-t.v0[2] };
+    cross3(pvec,d,t.e1);
+    const double det = dot3(t.e0,pvec);
+
+    cross3(normal,t.e0,t.e1);
+    const double area = std::sqrt(dot3(normal,normal));
+    if (std::fabs(det) <= margin*area)
+    {
+      // Ray parallel to the triangle, it only matters if it lies in its plane
+      if (area > 0.0 && std::fabs(dot3(tvec,normal)) > epsilon_*area) return (true);
+      ambiguous = true;
+      return (true);
+    }
+
+    const double inv = 1.0/det;
+    const double u = dot3(tvec,pvec)*inv;
+    if (u < -margin || u > 1.0+margin) return (true);
+    cross3(qvec,tvec,t.e0);
+    const double v = dot3(d,qvec)*inv;
+    if (v < -margin || u+v > 1.0+margin) return (true);
+    const double s = dot3(t.e1,qvec)*inv;
+
+    if (std::fabs(s) <= epsilon_)
+    {
+      on_surface = true;
+      return (false);
+    }
+    if (s < 0.0) return (true);
+    if (u < margin || v < margin || u+v > 1.0-margin) ambiguous = true;
+    count++;
+    return (true);
+  });
+  return (count);
+}
+
+bool
+SurfaceDistanceQuery::inside(const Point& p) const
+{
+  const int num_directions = 5;
+  int votes = 0;
+  for (int k = 0; k < num_directions; k++)
+  {
+    const Vector dir(ray_directions[k][0],ray_directions[k][1],ray_directions[k][2]);
+    bool ambiguous, on_surface;
+    const int count = crossings(p,dir,ambiguous,on_surface);
+    if (on_surface) return (true);
+    if (!ambiguous) return (count % 2 == 1);
+    if (count % 2 == 1) votes++;
+  }
+  // Every ray grazed an edge, go with the majority
+  return (2*votes > num_directions);
+}
@@ -0,0 +1,106 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_SURFACEDISTANCEQUERY_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_SURFACEDISTANCEQUERY_H 1
+
+#include <vector>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/SearchBVHT.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+// Closest point and inside queries against a triangle or quadrilateral
+// surface, used by the distance field algorithms. The triangles are stored
+// in one flat array together with the dot products the closest point test
+// needs, and are searched through a bounding volume hierarchy: a query only
+// evaluates the triangles in the boxes that can still beat the best match,
+// independent of how strongly the surface is graded. Quadrilaterals are
+// split in two triangles that report the index of the original element.
+
+class SCISHARE SurfaceDistanceQuery
+{
+  public:
+    // Whether the query can be built for the elements of mesh
+    static bool supports(VMesh* mesh);
+
+    explicit SurfaceDistanceQuery(VMesh* mesh);
+
+    // Same contract as VMesh::find_closest_elem: only elements within
+    // maxdist are considered, a negative maxdist means no limit
+    bool find_closest_elem(double& dist, Core::Geometry::Point& result,
+                           VMesh::Elem::index_type& elem,
+                           const Core::Geometry::Point& p,
+                           double maxdist = -1.0) const;
+
+    // Whether p is enclosed by the surface, decided by the parity of the
+    // number of crossings of a ray. Rays that graze an edge or a node are
+    // cast again in another direction. The surface should be closed.
+    bool inside(const Core::Geometry::Point& p) const;
+
+    size_type num_triangles() const
+      { return (static_cast<size_type>(triangles_.size())); }
+
+  private:
+    struct Triangle
+    {
+      double v0[3];
+      double e0[3];
+      double e1[3];
+      // Dot products of the edges and the determinant of their Gram matrix
+      double a00, a01, a11, det;
+      VMesh::Elem::index_type elem;
+    };
+
+    void add_triangle(const Core::Geometry::Point& p0,
+                      const Core::Geometry::Point& p1,
+                      const Core::Geometry::Point& p2,
+                      VMesh::Elem::index_type elem);
+
+    // Squared distance from q to triangle t, the closest point goes in r
+    double closest_point(const Triangle& t, const double* q, double* r) const;
+
+    // Number of crossings of the ray from q along dir. ambiguous is set when
+    // a crossing is too close to an edge to be counted reliably, on_surface
+    // when q lies on one of the triangles.
+    int crossings(const Core::Geometry::Point& q,
+                  const Core::Geometry::Vector& dir,
+                  bool& ambiguous, bool& on_surface) const;
+
+    std::vector<Triangle> triangles_;
+    SearchBVHT<index_type> bvh_;
+    double epsilon_;
+};
+
+}}}}
+
+#endif
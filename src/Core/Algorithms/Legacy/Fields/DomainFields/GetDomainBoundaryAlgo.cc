@@ -199,6 +199,10 @@ GetDomainBoundaryAlgo::runImpl(FieldHandle input, SparseRowMatrixHandle domainli
     isdomlink = true;
   }
 
+  // Linked faces are found through the elements around their first node
+  VMesh::adjacency_type node_elems;
+  if (isdomlink) imesh->get_elem_adjacency(node_elems);
+
   if (disconnect)
   {
     pointhash_map_type node_map;
@@ -237,15 +241,14 @@ GetDomainBoundaryAlgo::runImpl(FieldHandle input, SparseRowMatrixHandle domainli
         {
           VMesh::DElem::index_type idx = domlinkcc[rr];
           VMesh::Node::array_type nodes;
-          VMesh::Elem::array_type elems;
           VMesh::DElem::array_type delems2;
 
           imesh->get_nodes(nodes,idx);
-          imesh->get_elems(elems,nodes[0]);
+          const VMesh::adjacency_type::Row elems = node_elems[nodes[0]];
 
           for (size_t r=0; r<elems.size(); r++)
           {
-            imesh->get_delems(delems2,elems[r]);
+            imesh->get_delems(delems2,VMesh::Elem::index_type(elems[r]));
 
             for (size_t s=0; s<delems2.size(); s++)
             {
@@ -424,15 +427,14 @@ GetDomainBoundaryAlgo::runImpl(FieldHandle input, SparseRowMatrixHandle domainli
         {
           VMesh::DElem::index_type idx = domlinkcc[rr];
           VMesh::Node::array_type nodes;
-          VMesh::Elem::array_type elems;
           VMesh::DElem::array_type delems2;
 
           imesh->get_nodes(nodes,idx);
-          imesh->get_elems(elems,nodes[0]);
+          const VMesh::adjacency_type::Row elems = node_elems[nodes[0]];
 
           for (size_t r=0; r<elems.size(); r++)
           {
-            imesh->get_delems(delems2,elems[r]);
+            imesh->get_delems(delems2,VMesh::Elem::index_type(elems[r]));
 
             for (size_t s=0; s<delems2.size(); s++)
             {
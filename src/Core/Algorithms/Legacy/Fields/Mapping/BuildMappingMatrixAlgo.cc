@@ -27,6 +27,7 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/Mapping/BuildMappingMatrixAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingTiles.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
@@ -52,6 +53,7 @@ BuildMappingMatrixAlgo::BuildMappingMatrixAlgo()
 {
   addParameter(Parameters::MaxDistance, -1.0);
   addOption(Parameters::MappingMethod, "interpolateddata","interpolateddata|closestdata|singledestination");
+  addParameter(Parameters::TiledMapping, true);
 }
 
 namespace detail
@@ -78,6 +80,7 @@ namespace detail
 
     double  maxdist_;
     const AlgorithmBase* algo_;
+    MappingTiles tiles_;
 
   protected:
     int nproc_;
@@ -95,12 +98,9 @@ namespace detail
 
   void BuildMappingMatrixClosestDataPAlgo::parallel(int proc)
   {
-    // Determine which ones to run
+    // Values are handed out in tiles, see MappingTiles
     VField::size_type num_values = dfield_->num_values();
-    VField::size_type localsize = num_values/nproc_;
-    VField::index_type start = localsize*proc;
-    VField::index_type end = localsize*(proc+1);
-    if (proc == nproc_-1) end = num_values;
+    MappingTiles::Cursor cursor(tiles_);
 
     barrier_.wait();
 
@@ -112,7 +112,8 @@ namespace detail
       VMesh::coords_type coords;
       VMesh::Elem::index_type didx;
 
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      VMesh::Elem::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -124,7 +125,7 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
@@ -132,7 +133,8 @@ namespace detail
       Point p, r;
       VMesh::coords_type coords;
       VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      VMesh::Node::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -144,14 +146,15 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
     {
       Point p, r;
       VMesh::Node::index_type didx;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      VMesh::Elem::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -163,14 +166,15 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
     {
       Point p, r;
       VMesh::Node::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      VMesh::Node::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -182,7 +186,7 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
 
@@ -226,12 +230,9 @@ namespace detail
   void
     BuildMappingMatrixSingleDestinationPAlgo::parallel(int proc)
   {
-    // Determine which ones to run
+    // Values are handed out in tiles, see MappingTiles
     VField::size_type num_values = sfield_->num_values();
-    VField::size_type localsize = num_values/nproc_;
-    VField::index_type start = localsize*proc;
-    VField::index_type end = localsize*(proc+1);
-    if (proc == nproc_-1) end = num_values;
+    MappingTiles::Cursor cursor(tiles_);
 
     if (proc == 0)
     {
@@ -247,7 +248,8 @@ namespace detail
       Point p, r;
       VMesh::coords_type coords;
       VMesh::Elem::index_type didx;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      VMesh::Elem::index_type idx;
+      while (cursor.next(idx))
       {
         smesh_->get_center(p,idx);
         double dist;
@@ -259,7 +261,7 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 0)
@@ -267,7 +269,8 @@ namespace detail
       Point p, r;
       VMesh::coords_type coords;
       VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      VMesh::Node::index_type idx;
+      while (cursor.next(idx))
       {
         smesh_->get_center(p,idx);
         double dist;
@@ -279,14 +282,15 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (sfield_->basis_order() == 0 && dfield_->basis_order() == 1)
     {
       Point p, r;
       VMesh::Node::index_type didx;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      VMesh::Elem::index_type idx;
+      while (cursor.next(idx))
       {
         smesh_->get_center(p,idx);
         double dist;
@@ -298,14 +302,15 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 1)
     {
       Point p, r;
       VMesh::Node::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      VMesh::Node::index_type idx;
+      while (cursor.next(idx))
       {
         smesh_->get_center(p,idx);
         double dist;
@@ -317,7 +322,7 @@ namespace detail
           }
           else cc_[idx] = -1;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
 
@@ -369,12 +374,9 @@ namespace detail
 
   void BuildMappingMatrixInterpolatedDataPAlgo::parallel(int proc)
   {
-    // Determine which ones to run
+    // Values are handed out in tiles, see MappingTiles
     VField::size_type num_values = dfield_->num_values();
-    VField::size_type localsize = num_values/nproc_;
-    VField::index_type start = localsize*proc;
-    VField::index_type end = localsize*(proc+1);
-    if (proc == nproc_-1) end = num_values;
+    MappingTiles::Cursor cursor(tiles_);
 
     barrier_.wait();
 
@@ -385,7 +387,8 @@ namespace detail
       Point p, r;
       VMesh::Elem::index_type didx;
 
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      VMesh::Elem::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
 
@@ -403,14 +406,15 @@ namespace detail
             vv_[idx] = 1.0;
           }
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
     {
       Point p, r;
       VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      VMesh::Node::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -427,7 +431,7 @@ namespace detail
             vv_[idx] = 1.0;
           }
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
@@ -436,7 +440,8 @@ namespace detail
       VMesh::coords_type coords;
       VMesh::Elem::index_type didx;
       VMesh::ElemInterpolate interp;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      VMesh::Elem::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -460,7 +465,7 @@ namespace detail
             }
           }
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
@@ -469,7 +474,8 @@ namespace detail
       VMesh::coords_type coords;
       VMesh::Elem::index_type didx;
       VMesh::ElemInterpolate interp;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      VMesh::Node::index_type idx;
+      while (cursor.next(idx))
       {
         dmesh_->get_center(p,idx);
         double dist;
@@ -493,7 +499,7 @@ namespace detail
             }
           }
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
       }
     }
 
@@ -617,6 +623,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
   const SparseRowMatrix::Storage& vv = legacySparseData.data().get();
 
   double maxdist = get(Parameters::MaxDistance).toDouble();
+  const bool tiled = get(Parameters::TiledMapping).toBool();
 
   const int np = Parallel::NumCores();
   if (method == "closestdata")
@@ -631,6 +638,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     algo.vv_ = vv;
     algo.maxdist_ = maxdist;
     algo.algo_ = this;
+    algo.tiles_.setup(dfield, dmesh, tiled, np);
 
     auto task_i = [&algo,this](int i) { algo.parallel(i); };
     Parallel::RunTasks(task_i, np);
@@ -647,6 +655,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     algo.vv_ = vv;
     algo.maxdist_ = maxdist;
     algo.algo_ = this;
+    algo.tiles_.setup(sfield, smesh, tiled, np);
 
     auto task_i = [&algo,this](int i) { algo.parallel(i); };
     Parallel::RunTasks(task_i, np);
@@ -664,6 +673,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     algo.e_ = e;
     algo.maxdist_ = maxdist;
     algo.algo_ = this;
+    algo.tiles_.setup(dfield, dmesh, tiled, np);
 
     auto task_i = [&algo,this](int i) { algo.parallel(i); };
     Parallel::RunTasks(task_i, np);
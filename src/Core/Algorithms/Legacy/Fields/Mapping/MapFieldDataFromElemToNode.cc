@@ -77,6 +77,17 @@ bool
 
   index_type cnt = 0, c = 0;
 
+  // Read the element data directly when it is stored as DATA, otherwise
+  // convert it in one bulk call; results are written back in one go as well
+  std::vector<DATA> evalues;
+  FieldDataSpan<DATA> edata = ifield->values_span<DATA>();
+  if (edata.empty())
+  {
+    ifield->get_values(evalues);
+    if (!evalues.empty()) edata = FieldDataSpan<DATA>(&(evalues[0]), evalues.size());
+  }
+  std::vector<DATA> nvalues(sz);
+
   if (method == "Interpolation")
   {
     algo->remark("Interpolation of piecewise constant data is done by averaging adjoining values");
@@ -93,11 +104,11 @@ bool
       DATA tval;
       for (size_t p = 0; p < nsize; p++)
       {
-        ifield->get_value(tval, elems[p]);
+        tval = edata[elems[p]];
         val += tval;
       }
       val = static_cast<DATA>(val*(1.0 / static_cast<double>(nsize)));
-      ofield->set_value(val, *(it));
+      nvalues[*(it)] = val;
       ++it;
       cnt++;
       if (cnt == 1000)
@@ -118,14 +129,14 @@ bool
       DATA tval(0);
       if (nsize > 0)
       {
-        ifield->get_value(val, elems[0]);
+        val = edata[elems[0]];
         for (size_t p = 1; p < nsize; p++)
         {
-          ifield->get_value(tval, elems[p]);
+          tval = edata[elems[p]];
           if (tval > val) val = tval;
         }
       }
-      ofield->set_value(val, *(it));
+      nvalues[*(it)] = val;
       ++it;
       cnt++;
       if (cnt == 1000)
@@ -146,14 +157,14 @@ bool
       DATA tval(0);
       if (nsize > 0)
       {
-        ifield->get_value(val, elems[0]);
+        val = edata[elems[0]];
         for (size_t p = 1; p < nsize; p++)
         {
-          ifield->value(tval, elems[p]);
+          tval = edata[elems[p]];
           if (tval < val) val = tval;
         }
       }
-      ofield->set_value(val, *(it));
+      nvalues[*(it)] = val;
       ++it;
       cnt++;
       if (cnt == 1000)
@@ -174,10 +185,10 @@ bool
       DATA tval(0);
       for (size_t p = 0; p < nsize; p++)
       {
-        ifield->get_value(tval, elems[p]);
+        tval = edata[elems[p]];
         val += tval;
       }
-      ofield->set_value(val, *(it));
+      nvalues[*(it)] = val;
       ++it;
       cnt++;
       if (cnt == 1000)
@@ -198,11 +209,11 @@ bool
       valarray.resize(nsize);
       for (size_t p = 0; p < nsize; p++)
       {
-        ifield->get_value(valarray[p], elems[p]);
+        valarray[p] = edata[elems[p]];
       }
       sort(valarray.begin(), valarray.end());
       int idx = static_cast<int>((valarray.size() / 2));
-      ofield->set_value(valarray[idx], *(it));
+      nvalues[*(it)] = valarray[idx];
       ++it;
       cnt++;
       if (cnt == 1000)
@@ -218,6 +229,8 @@ bool
     return false;
   }
 
+  ofield->set_values(nvalues);
+
   return true;
 }
 
@@ -27,6 +27,7 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/Mapping/MapFieldDataFromSourceToDestination.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingTiles.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
@@ -52,6 +53,7 @@ using namespace SCIRun;
 
 ALGORITHM_PARAMETER_DEF(Fields, DefaultValue);
 ALGORITHM_PARAMETER_DEF(Fields, MappingMethod);
+ALGORITHM_PARAMETER_DEF(Fields, TiledMapping);
 
 const AlgorithmOutputName MapFieldDataFromSourceToDestinationAlgo::Remapped_Destination("Remapped_Destination");
 
@@ -61,6 +63,7 @@ MapFieldDataFromSourceToDestinationAlgo::MapFieldDataFromSourceToDestinationAlgo
   addParameter(DefaultValue, 0.0);
   addParameter(MaxDistance, -1.0);
   addOption(MappingMethod, "interpolateddata", "interpolateddata|closestdata|singledestination");
+  addParameter(TiledMapping, true);
 }
 
 namespace detail
@@ -81,6 +84,7 @@ namespace detail
 
     double  maxdist_;
     const AlgorithmBase* algo_;
+    MappingTiles tiles_;
 
   protected:
     Barrier barrier_;
@@ -103,12 +107,9 @@ class MapFieldDataFromSourceToDestinationClosestDataPAlgo : public MapFieldDataF
 void
 MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
 {
-  // Determine which ones to run
+  // Values are handed out in tiles, see MappingTiles
   VField::size_type num_values = dfield_->num_values();
-  VField::size_type localsize = num_values/nproc_;
-  VField::index_type start = localsize*proc;
-  VField::index_type end = localsize*(proc+1);
-  if (proc == nproc_-1) end = num_values;
+  MappingTiles::Cursor cursor(tiles_);
 
   barrier_.wait();
 
@@ -119,7 +120,8 @@ MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
     Point p, r;
     VMesh::Elem::index_type didx;
 
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+    VMesh::Elem::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -131,14 +133,15 @@ MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
           dfield_->copy_value(sfield_,didx,idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
   {
     Point p, r;
     VMesh::Elem::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    VMesh::Node::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -150,14 +153,15 @@ MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
           dfield_->copy_value(sfield_,didx,idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
   {
     Point p, r;
     VMesh::Node::index_type didx;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+    VMesh::Elem::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -169,14 +173,15 @@ MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
           dfield_->copy_value(sfield_,didx,idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
   {
     Point p, r;
     VMesh::Node::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    VMesh::Node::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -188,7 +193,7 @@ MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
           dfield_->copy_value(sfield_,didx,idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
 
@@ -215,12 +220,9 @@ class MapFieldDataFromSourceToDestinationSingleDestinationPAlgo : public MapFiel
 void
 MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
 {
-  // Determine which ones to run
+  // Values are handed out in tiles, see MappingTiles
   VField::size_type num_values = sfield_->num_values();
-  VField::size_type localsize = num_values/nproc_;
-  VField::index_type start = localsize*proc;
-  VField::index_type end = localsize*(proc+1);
-  if (proc == nproc_-1) end = num_values;
+  MappingTiles::Cursor cursor(tiles_);
 
   if (proc == 0)
   {
@@ -236,7 +238,8 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
     Point p, r;
     VMesh::coords_type coords;
     VMesh::Elem::index_type didx;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+    VMesh::Elem::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       smesh_->get_center(p,idx);
@@ -249,7 +252,7 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
         }
         else cc_[idx] = -1;
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 0)
@@ -257,7 +260,8 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
     Point p, r;
     VMesh::coords_type coords;
     VMesh::Elem::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    VMesh::Node::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       smesh_->get_center(p,idx);
@@ -270,14 +274,15 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
         }
         else cc_[idx] = -1;
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (sfield_->basis_order() == 0 && dfield_->basis_order() == 1)
   {
     Point p, r;
     VMesh::Node::index_type didx;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+    VMesh::Elem::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       smesh_->get_center(p,idx);
@@ -290,14 +295,15 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
         }
         else cc_[idx] = -1;
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 1)
   {
     Point p, r;
     VMesh::Node::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    VMesh::Node::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       smesh_->get_center(p,idx);
@@ -310,7 +316,7 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
         }
         else cc_[idx] = -1;
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
 
@@ -353,12 +359,9 @@ class MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo : public MapField
 void
 MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
 {
-  // Determine which ones to run
+  // Values are handed out in tiles, see MappingTiles
   VField::size_type num_values = dfield_->num_values();
-  VField::size_type localsize = num_values/nproc_;
-  VField::index_type start = localsize*proc;
-  VField::index_type end = localsize*(proc+1);
-  if (proc == nproc_-1) end = num_values;
+  MappingTiles::Cursor cursor(tiles_);
 
   barrier_.wait();
 
@@ -368,7 +371,8 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
     Point p, r;
     VMesh::Elem::index_type didx;
 
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+    VMesh::Elem::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -381,14 +385,15 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
           dfield_->copy_value(sfield_,didx,idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
   {
     Point p, r;
     VMesh::Elem::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    VMesh::Node::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -400,7 +405,7 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
           dfield_->copy_value(sfield_,didx,idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
@@ -409,7 +414,8 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
     VMesh::coords_type coords;
     VMesh::Elem::index_type didx;
     VMesh::ElemInterpolate interp;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+    VMesh::Elem::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -423,7 +429,7 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
               &(interp.weights[0]),interp.node_index.size(),idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
   else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
@@ -432,7 +438,8 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
     VMesh::coords_type coords;
     VMesh::Elem::index_type didx;
     VMesh::ElemInterpolate interp;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    VMesh::Node::index_type idx;
+    while (cursor.next(idx))
     {
       checkForInterruption();
       dmesh_->get_center(p,idx);
@@ -446,7 +453,7 @@ MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
               &(interp.weights[0]),interp.node_index.size(),idx);
         }
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(cursor.position(),num_values); } }
     }
   }
 
@@ -565,6 +572,10 @@ MapFieldDataFromSourceToDestinationAlgo::runImpl(FieldHandle source, FieldHandle
   algoP->dmesh_ = dmesh;
   algoP->maxdist_ = maxdist;
   algoP->algo_ = this;
+  if (method == "singledestination")
+    algoP->tiles_.setup(sfield, smesh, get(TiledMapping).toBool(), np);
+  else
+    algoP->tiles_.setup(dfield, dmesh, get(TiledMapping).toBool(), np);
 
   auto task_i = [&algoP,this](int i) { algoP->parallel(i); };
   Parallel::RunTasks(task_i, np);
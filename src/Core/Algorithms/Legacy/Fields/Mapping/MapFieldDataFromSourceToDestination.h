@@ -42,6 +42,7 @@ namespace SCIRun {
 
         ALGORITHM_PARAMETER_DECL(DefaultValue);
         ALGORITHM_PARAMETER_DECL(MappingMethod);
+        ALGORITHM_PARAMETER_DECL(TiledMapping);
 
         class SCISHARE MapFieldDataFromSourceToDestinationAlgo : public AlgorithmBase, public Thread::Interruptible
         {
@@ -0,0 +1,139 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingTiles.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/BBox.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Spread the lower 21 bits of v so there are two zero bits between each
+  std::uint64_t spread_bits(std::uint64_t v)
+  {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+    v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2)  & 0x1249249249249249ULL;
+    return v;
+  }
+
+  std::uint64_t morton_code(const Point& p, const Point& min, const Vector& scale)
+  {
+    const Vector r = p - min;
+    std::uint64_t x = static_cast<std::uint64_t>(std::max(0.0, r.x()*scale.x()));
+    std::uint64_t y = static_cast<std::uint64_t>(std::max(0.0, r.y()*scale.y()));
+    std::uint64_t z = static_cast<std::uint64_t>(std::max(0.0, r.z()*scale.z()));
+    return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+  }
+
+  // Small enough to balance uneven lookups, large enough that claiming a
+  // tile is negligible compared to the searches inside it
+  const size_type spatial_tile_size = 256;
+}
+
+MappingTiles::MappingTiles() :
+  size_(0), tile_size_(1), next_(0)
+{
+}
+
+void
+MappingTiles::setup(VField* field, VMesh* mesh, bool spatial_order, int nproc)
+{
+  size_ = field->num_values();
+  next_ = 0;
+  order_.clear();
+
+  if (!spatial_order || size_ < 2*spatial_tile_size)
+  {
+    // One contiguous range per thread, as the plain partitioning does
+    tile_size_ = std::max<size_type>(1, (size_ + nproc - 1)/std::max(nproc,1));
+    return;
+  }
+
+  tile_size_ = spatial_tile_size;
+
+  BBox bbox = mesh->get_bounding_box();
+  const Point min = bbox.get_min();
+  const Vector diag = bbox.diagonal();
+  const double cells = static_cast<double>((1 << 21) - 1);
+  Vector scale(diag.x() > 0.0 ? cells/diag.x() : 0.0,
+               diag.y() > 0.0 ? cells/diag.y() : 0.0,
+               diag.z() > 0.0 ? cells/diag.z() : 0.0);
+
+  std::vector<std::pair<std::uint64_t,index_type> > keys(size_);
+  Point p;
+  if (field->basis_order() == 0)
+  {
+    for (VMesh::Elem::index_type idx = 0; idx < size_; ++idx)
+    {
+      mesh->get_center(p,idx);
+      keys[idx] = std::make_pair(morton_code(p,min,scale),index_type(idx));
+    }
+  }
+  else
+  {
+    for (VMesh::Node::index_type idx = 0; idx < size_; ++idx)
+    {
+      mesh->get_center(p,idx);
+      keys[idx] = std::make_pair(morton_code(p,min,scale),index_type(idx));
+    }
+  }
+  std::sort(keys.begin(),keys.end());
+
+  order_.resize(size_);
+  for (index_type k = 0; k < size_; ++k) order_[k] = keys[k].second;
+}
+
+void
+MappingTiles::setup(size_type size, size_type tile_size)
+{
+  size_ = size;
+  next_ = 0;
+  order_.clear();
+  tile_size_ = std::max<size_type>(1, tile_size);
+}
+
+bool
+MappingTiles::next_tile(index_type& begin, index_type& end)
+{
+  begin = next_.fetch_add(tile_size_);
+  if (begin >= size_) return (false);
+  end = std::min<index_type>(begin + tile_size_, size_);
+  return (true);
+}
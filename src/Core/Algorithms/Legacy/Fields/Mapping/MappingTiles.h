@@ -0,0 +1,109 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORTIHMS_FIELDS_MAPPING_MAPPINGTILES_H__
+#define CORE_ALGORTIHMS_FIELDS_MAPPING_MAPPINGTILES_H__
+
+#include <atomic>
+#include <vector>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Datatypes/Legacy/Field/FieldFwd.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+// Work distribution for the mapping and distance field algorithms. The values
+// of the field that is iterated over are handed out to the threads in tiles,
+// so a thread that finishes early picks up the remaining work. In spatial order
+// the values are first sorted along a Morton curve through the bounding box of
+// the mesh: consecutive lookups then land in nearby cells of the search grid
+// and the element found for the previous value is usually the right starting
+// guess.
+
+class SCISHARE MappingTiles
+{
+  public:
+    MappingTiles();
+
+    // Set up the tiles for all the values of field, nproc is used to size the
+    // tiles when the values are kept in index order
+    void setup(VField* field, VMesh* mesh, bool spatial_order, int nproc);
+
+    // Set up tiles over the indices [0,size) in index order, for loops that
+    // are not over the values of a field such as the edge values of a
+    // quadratic field
+    void setup(size_type size, size_type tile_size);
+
+    // Number of values that are handed out
+    size_type size() const { return (size_); }
+
+    // Value handed out at position k of the ordering
+    index_type operator[](index_type k) const
+      { return (order_.empty() ? k : order_[k]); }
+
+    // Claim the next range [begin,end) of positions, returns false once all
+    // tiles have been handed out
+    bool next_tile(index_type& begin, index_type& end);
+
+    // Per thread iterator over the values of the tiles claimed by that thread
+    class Cursor
+    {
+      public:
+        explicit Cursor(MappingTiles& tiles) :
+          tiles_(tiles), k_(0), end_(0) {}
+
+        template<class INDEX>
+        bool next(INDEX& idx)
+        {
+          if (k_ == end_ && !tiles_.next_tile(k_,end_)) return (false);
+          idx = INDEX(tiles_[k_++]);
+          return (true);
+        }
+
+        // Position in the ordering, used for progress reporting
+        index_type position() const { return (k_); }
+
+      private:
+        MappingTiles& tiles_;
+        index_type k_;
+        index_type end_;
+    };
+
+  private:
+    std::vector<index_type> order_;
+    size_type size_;
+    size_type tile_size_;
+    std::atomic<index_type> next_;
+};
+
+}}}}
+
+#endif
@@ -27,9 +27,13 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/BaseMC.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
 
 MatrixHandle BaseMC::get_interpolant()
 {
@@ -122,3 +126,157 @@ MatrixHandle BaseMC::get_parent_cells()
     return MatrixHandle();
 }
 
+
+
+std::vector<BaseMC::edgepair_t> BaseMC::node_sources(size_type num_nodes) const
+{
+  std::vector<edgepair_t> sources(num_nodes);
+  if (basis_order_ == 0)
+  {
+    // Cell data copies mesh nodes
+    for (size_t n = 0; n < node_map_.size(); n++)
+    {
+      if (node_map_[n] >= 0)
+      {
+        edgepair_t& source = sources[node_map_[n]];
+        source.first = n;
+        source.second = -1;
+        source.dfirst = 1.0;
+      }
+    }
+  }
+  else
+  {
+    // Node data cuts mesh edges
+    for (const auto& edge : edge_map_)
+      sources[edge.second] = edge.first;
+  }
+  return sources;
+}
+
+FieldHandle BaseMC::merge(const std::vector<BaseMC*>& parts, double val,
+  MatrixHandle* interpolant, MatrixHandle* parent_cells)
+{
+  if (parts.empty())
+    return FieldHandle();
+
+  std::vector<FieldHandle> fields(parts.size());
+  for (size_t p = 0; p < parts.size(); p++)
+    fields[p] = parts[p]->get_field(val);
+
+  FieldHandle output = fields[0];
+  const BaseMC* first = parts[0];
+  const bool cell_data = first->basis_order_ == 0;
+
+  std::vector<edgepair_t> sources;
+
+  if (parts.size() == 1)
+  {
+    if (interpolant && !cell_data)
+      sources = first->node_sources(output->vmesh()->num_nodes());
+  }
+  else
+  {
+    FieldInformation fi(fields[0]);
+    output = CreateField(fi);
+    VMesh* omesh = output->vmesh();
+
+    size_type num_nodes = 0, num_elems = 0;
+    for (const auto& field : fields)
+    {
+      num_nodes += field->vmesh()->num_nodes();
+      num_elems += field->vmesh()->num_elems();
+    }
+    omesh->node_reserve(num_nodes);
+    omesh->elem_reserve(num_elems);
+
+    // Walking the parts in order and their nodes in creation order adds every
+    // shared node where a single pass over all cells would have created it
+    edge_hash_type welded;
+    Point point;
+    for (size_t p = 0; p < parts.size(); p++)
+    {
+      VMesh* pmesh = fields[p]->vmesh();
+      const auto part_sources = parts[p]->node_sources(pmesh->num_nodes());
+      std::vector<index_type> node_map(part_sources.size());
+      for (size_t n = 0; n < part_sources.size(); n++)
+      {
+        auto loc = welded.find(part_sources[n]);
+        if (loc == welded.end())
+        {
+          pmesh->get_point(point, VMesh::Node::index_type(n));
+          node_map[n] = omesh->add_point(point);
+          welded[part_sources[n]] = node_map[n];
+          sources.push_back(part_sources[n]);
+        }
+        else
+        {
+          node_map[n] = loc->second;
+        }
+      }
+
+      VMesh::Node::array_type nodes;
+      VMesh::Elem::size_type part_elems = pmesh->num_elems();
+      for (VMesh::Elem::index_type e(0); e < part_elems; ++e)
+      {
+        pmesh->get_nodes(nodes, e);
+        for (auto& node : nodes)
+          node = node_map[node];
+        omesh->add_elem(nodes);
+      }
+    }
+
+    output->vfield()->resize_values();
+    output->vfield()->set_all_values(val);
+  }
+
+  typedef SparseRowMatrix::Triplet T;
+
+  if (interpolant)
+  {
+    // Rows are the output nodes for node data and the output faces for cell data
+    std::vector<T> entries;
+    size_type nrows = 0;
+    auto add_row = [&entries](index_type row, const edgepair_t& source)
+    {
+      if (source.first >= 0) entries.push_back(T(row, source.first, source.second >= 0 ? 1.0 - source.dfirst : 1.0));
+      if (source.second >= 0) entries.push_back(T(row, source.second, source.first >= 0 ? source.dfirst : 1.0));
+    };
+
+    if (cell_data)
+    {
+      for (size_t p = 0; p < parts.size(); p++)
+      {
+        for (const auto& face : parts[p]->edge_map_)
+          add_row(nrows + face.second, face.first);
+        nrows += fields[p]->vmesh()->num_elems();
+      }
+    }
+    else
+    {
+      nrows = sources.size();
+      for (size_t n = 0; n < sources.size(); n++)
+        add_row(n, sources[n]);
+    }
+
+    auto matrix = boost::make_shared<SparseRowMatrix>(nrows, cell_data ? first->ncells_ : first->nnodes_);
+    matrix->setFromTriplets(entries.begin(), entries.end());
+    *interpolant = matrix;
+  }
+
+  if (parent_cells)
+  {
+    std::vector<T> entries;
+    size_type nrows = 0;
+    for (const auto* part : parts)
+    {
+      for (auto cell : part->cell_map_)
+        entries.push_back(T(nrows++, cell, 1.0));
+    }
+    auto matrix = boost::make_shared<SparseRowMatrix>(nrows, first->ncells_);
+    matrix->setFromTriplets(entries.begin(), entries.end());
+    *parent_cells = matrix;
+  }
+
+  return output;
+}
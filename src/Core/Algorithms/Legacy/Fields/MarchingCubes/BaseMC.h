@@ -77,6 +77,14 @@ namespace SCIRun {
     Core::Datatypes::MatrixHandle get_interpolant();
     Core::Datatypes::MatrixHandle get_parent_cells();
 
+    /// Welds the fields that tesselators built from consecutive ranges of cells, in
+    /// range order, into one field. Nodes cut from the same mesh edge (or copied from
+    /// the same mesh node for cell data) become one node, so the result is identical
+    /// to what a single tesselator would have produced for all cells. The interpolant
+    /// and parent cell matrices of the parts are merged to match when requested.
+    static FieldHandle merge(const std::vector<BaseMC*>& parts, double val,
+      Core::Datatypes::MatrixHandle* interpolant, Core::Datatypes::MatrixHandle* parent_cells);
+
     bool build_field_;
     bool build_geom_;
     int basis_order_;
@@ -99,6 +107,9 @@ namespace SCIRun {
 
     typedef boost::unordered_map<edgepair_t, SCIRun::index_type, edgepairhash> edge_hash_type;
 
+    /// Source of every node of the extracted field, indexed by field node
+    std::vector<edgepair_t> node_sources(SCIRun::size_type num_nodes) const;
+
     std::vector<SCIRun::index_type> cell_map_;  // Unique cells when surfacing node data.
     std::vector<SCIRun::index_type> node_map_;  // Unique nodes when surfacing cell data.
 
@@ -47,6 +47,9 @@
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/QuadMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/EdgeMC.h>
 
+#include <boost/thread/thread.hpp>
+#include <atomic>
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
  #include <Core/Geom/GeomGroup.h>
  #include <Core/Geom/GeomMaterial.h>
@@ -95,16 +98,10 @@ class MarchingCubesAlgoP {
      input_(input),
      iso_values_(iso_values) { }
 
-    ~MarchingCubesAlgoP()
-    {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       delete_all_items(tesselator_);
-      #endif
-    }
-
     FieldHandle    input_;
 
-    std::vector<TESSELATOR*>   tesselator_;
+    /// One tesselator per isovalue and cell range, indexed iso*nproc+proc
+    std::vector<boost::shared_ptr<TESSELATOR>> tesselator_;
     std::vector<FieldHandle>  output_field_;
     std::vector<MatrixHandle> output_interpolant_matrix_;
     std::vector<MatrixHandle> output_parent_cell_matrix_;
@@ -121,10 +118,16 @@ class MarchingCubesAlgoP {
     const std::vector<double>& iso_values_;
     const AlgorithmBase* algo_;
 
+    /// The progress reporter is not thread safe: every task counts the cells
+    /// it extracted, but only the thread that called run() reports them
+    boost::thread::id caller_;
+    std::atomic<size_t> extracted_;
+
     bool run(const AlgorithmBase* algo, FieldHandle& output,
              MatrixHandle& node_interpolant,MatrixHandle& elem_interpolant );
 
     void parallel(int proc, int nproc, size_t iso);
+    void merge(int nproc, size_t iso);
 
   private:
     AppendFieldsAlgorithm append_fields_;
@@ -148,6 +151,18 @@ MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isovalues,
   return run(input,isovalues,field,dummy1,dummy2);
 }
 
+namespace
+{
+  /// Below this many cells per thread the merge costs more than the threads save
+  const VMesh::size_type minCellsPerThread = 4096;
+
+  MatrixHandle appendRows(const AppendMatrixAlgorithm& append, const std::vector<MatrixHandle>& matrices)
+  {
+    std::vector<MatrixHandle> rest(matrices.begin()+1, matrices.end());
+    return append.ConcatenateMatrices(matrices[0], rest, AppendMatrixAlgorithm::ROWS);
+  }
+}
+
 template <class TESSELATOR>
 bool
 MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
@@ -156,29 +171,27 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
                         MatrixHandle& elem_interpolant)
 {
   algo_ = algo;
+  caller_ = boost::this_thread::get_id();
+  extracted_ = 0;
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  int np = algo->get_int("num_threads");
   /// By default (-1) choose number of processors
-  if (np < 1) np = Thread::numProcessors();
-  /// Cap the number of threads
-  if (np > 4*Thread::numProcessors()) np = 4*Thread::numProcessors();
-  */
-  /// @todo: FIX MULTI THREADING OF MARCHING CUBES FIELDS ARE NOT PROPORLY LINKED
- #endif
-  int np = Parallel::NumCores();
+  int num_threads = algo->get(MarchingCubesAlgo::num_threads).toInt();
+  if (num_threads < 1) num_threads = Parallel::NumCores();
+  int np = num_threads;
 
-  np = 1;
-  size_t num_values = iso_values_.size();
+  VMesh::size_type num_elems = input_->vmesh()->num_elems();
+  if (np > num_elems/minCellsPerThread) np = static_cast<int>(num_elems/minCellsPerThread);
+  if (np < 1) np = 1;
 
-  tesselator_.resize(np);
-  for (size_t j=0; j<tesselator_.size(); j++)
-    tesselator_[j] = new TESSELATOR(input_);
+  /// Cell data keeps a node map the size of the input mesh in every
+  /// tesselator, so its cells are not split; the isovalues still get a
+  /// tesselator and a thread each
+  if (input_->vfield()->basis_order() == 0) np = 1;
 
-  output_field_.resize(np*num_values);
-  output_interpolant_matrix_.resize(np*num_values);
-  output_parent_cell_matrix_.resize(np*num_values);
-  //output_geometry_.resize(np*num_values);
+  size_t num_values = iso_values_.size();
+
+  /// With a single thread one tesselator is reused for every isovalue
+  const bool serial = (np == 1) && (num_values == 1 || num_threads == 1);
 
   build_field_ = algo->get(MarchingCubesAlgo::build_field).toBool();
   build_geometry_ = algo->get(MarchingCubesAlgo::build_geometry).toBool();
@@ -186,25 +199,54 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   build_elem_interpolant_ = algo->get(MarchingCubesAlgo::build_elem_interpolant).toBool();
   transparency_ = algo->get(MarchingCubesAlgo::transparency).toBool();
 
+  /// Set up every tesselator up front: reset() synchronizes the input mesh
+  /// and creates the output fields, which is not safe to do concurrently
+  size_t num_tesselators = serial ? 1 : np*num_values;
+  tesselator_.resize(num_tesselators);
+  for (size_t j=0; j<tesselator_.size(); j++)
+  {
+    tesselator_[j] = boost::make_shared<TESSELATOR>(input_);
+    if (!serial)
+      tesselator_[j]->reset(0, build_field_, build_geometry_, transparency_);
+  }
+
+  output_field_.resize(num_values);
+  output_interpolant_matrix_.resize(num_values);
+  output_parent_cell_matrix_.resize(num_values);
+  //output_geometry_.resize(np*num_values);
+
  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   append_fields_.set_progress_reporter(algo->get_progress_reporter());
   append_matrices_.set_progress_reporter(algo->get_progress_reporter());
   append_matrices_.setOption("method","append_rows");
  #endif
 
-  for (size_t j=0; j<iso_values_.size(); j++)
+  if (serial)
   {
-    if (np == 1)
+    for (size_t j=0; j<num_values; j++)
     {
+      tesselator_[0]->reset(0, build_field_, build_geometry_, transparency_);
       parallel(0,1,j);
+      merge(1,j);
     }
-    else
+  }
+  else
+  {
+    /// All isovalues and cell ranges are independent tasks; each isovalue
+    /// is welded as soon as its ranges are extracted
+    Parallel::For(0, np*num_values, [this, np](size_t first, size_t last)
     {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       Thread::parallel(this,&MarchingCubesAlgoP<TESSELATOR>::parallel,np,np,j);
-      #endif
-    }
+      for (size_t t=first; t<last; t++)
+        parallel(static_cast<int>(t % np), np, t / np);
+    }, 1);
+    Parallel::For(0, num_values, [this, np](size_t first, size_t last)
+    {
+      for (size_t j=first; j<last; j++)
+        merge(np, j);
+    }, 1);
   }
+  tesselator_.clear();
+
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (output_geometry_.size() == 0)
   {
@@ -227,21 +269,13 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   {
    if (!(append_fields_.run(output_field_,output)))
       return (false);
-  }
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (build_node_interpolant_)
-  {
-    if (!(append_matrices_.run(output_interpolant_matrix_,node_interpolant)))
-      return (false);
-  }
+    if (build_node_interpolant_)
+      node_interpolant = appendRows(append_matrices_, output_interpolant_matrix_);
 
-  if (build_elem_interpolant_)
-  {
-    if (!(append_matrices_.run(output_parent_cell_matrix_,elem_interpolant)))
-      return (false);
+    if (build_elem_interpolant_)
+      elem_interpolant = appendRows(append_matrices_, output_parent_cell_matrix_);
   }
- #endif
 
   return (true);
 }
@@ -308,7 +342,7 @@ bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isoval
 template<class TESSELATOR>
 void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
 {
-  tesselator_[proc]->reset(0, build_field_, build_geometry_, transparency_);
+  auto& tesselator = (tesselator_.size() == 1) ? tesselator_[0] : tesselator_[iso*nproc+proc];
 
   VMesh*  imesh  = input_->vmesh();
 
@@ -318,45 +352,22 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   index_type end = (proc < nproc-1) ? (proc+1)*(num_elems/nproc) : num_elems;
 
   index_type cnt = 0;
-  size_type total = (num_elems*iso_values_.size()/nproc);
-  index_type offset = (num_elems*iso/nproc);
   double isoval = iso_values_[iso];
+  const size_t num_cells = static_cast<size_t>(num_elems)*iso_values_.size();
 
   for(VMesh::Elem::index_type idx= start ; idx<end; idx++)
   {
-    tesselator_[proc]->extract(idx, isoval);
-    if (proc == 0)
+    tesselator->extract(idx, isoval);
+    cnt++;
+    if (cnt == 300)
     {
-      cnt++;
-      if (cnt == 300)
-      {
-        cnt = 0;
-        algo_->update_progress(idx+offset/total);
-      }
+      cnt = 0;
+      const size_t extracted = (extracted_ += 300);
+      if (boost::this_thread::get_id() == caller_)
+        algo_->update_progress_max(extracted, num_cells);
     }
   }
 
-  output_field_[iso*nproc+proc] = 0;
-  output_interpolant_matrix_[iso*nproc+proc] = 0;
-  output_parent_cell_matrix_[iso*nproc+proc] = 0;
-
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-   output_geometry_[iso*nproc+proc] = 0;
-  #endif
-
-  if (build_field_)
-  {
-    output_field_[iso*nproc+proc] = tesselator_[proc]->get_field(isoval);
-  }
-  if (build_node_interpolant_)
-  {
-    output_interpolant_matrix_[iso*nproc+proc] = tesselator_[proc]->get_interpolant();
-  }
-  if (build_elem_interpolant_)
-  {
-    output_parent_cell_matrix_[iso*nproc+proc] = tesselator_[proc]->get_parent_cells();
-  }
-
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (build_geometry_)
   {
@@ -374,7 +385,7 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
     }
     if (mathandle.get_rep())
     {
-      GeomHandle geom = tesselator_[proc]->get_geom();
+      GeomHandle geom = tesselator->get_geom();
       output_geometry_[iso*nproc+proc] = new GeomMaterial(geom,mathandle);
     }
     else
@@ -385,3 +396,25 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   #endif
 
 }
+
+template<class TESSELATOR>
+void MarchingCubesAlgoP<TESSELATOR>::merge(int nproc, size_t iso)
+{
+  output_field_[iso].reset();
+  output_interpolant_matrix_[iso].reset();
+  output_parent_cell_matrix_[iso].reset();
+
+  if (!build_field_)
+    return;
+
+  std::vector<BaseMC*> parts;
+  if (tesselator_.size() == 1)
+    parts.push_back(tesselator_[0].get());
+  else
+    for (int proc=0; proc<nproc; proc++)
+      parts.push_back(tesselator_[iso*nproc+proc].get());
+
+  output_field_[iso] = BaseMC::merge(parts, iso_values_[iso],
+    build_node_interpolant_ ? &output_interpolant_matrix_[iso] : nullptr,
+    build_elem_interpolant_ ? &output_parent_cell_matrix_[iso] : nullptr);
+}
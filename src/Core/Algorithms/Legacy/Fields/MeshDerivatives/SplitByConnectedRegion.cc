@@ -139,8 +139,10 @@ std::vector<FieldHandle> SplitFieldByConnectedRegionAlgo::run(FieldHandle input)
   std::vector<index_type> renumber(num_nodes,0);
   std::vector<short> visited(num_elems, 0);
 
+  VMesh::adjacency_type node_elems;
+  imesh->get_elem_adjacency(node_elems);
+
   VMesh::Node::array_type nnodes;
-  VMesh::Elem::array_type neighbors;
  
   for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
   {
@@ -161,7 +163,7 @@ std::vector<FieldHandle> SplitFieldByConnectedRegionAlgo::run(FieldHandle input)
         imesh->get_nodes(nnodes,buffer[i]);
         for (size_t q=0; q<nnodes.size(); q++)
         {
-          imesh->get_elems(neighbors,nnodes[q]);
+          const VMesh::adjacency_type::Row neighbors = node_elems[nnodes[q]];
           for (size_t p=0; p<neighbors.size(); p++)
           {
             if(visited[neighbors[p]] == 0)
@@ -534,28 +534,33 @@ runImpl(FieldHandle input, FieldHandle& output, bool convex,
   VMesh::Node::array_type onodes(8);
   VMesh::Node::array_type nnodes(8);
   
+  VMesh::size_type num_nodes = mesh->num_nodes();
+  VMesh::size_type num_elems = mesh->num_elems();
+
   // Copy all of the nodes from mesh to refined.  They won't change,
-  // we only add nodes.
-  
-  VMesh::Node::iterator bni, eni;
-  mesh->begin(bni); mesh->end(eni);
-  while (bni != eni)
+  // we only add nodes. Every element adds at least one element.
+  // New nodes are looked up by the indices of nodes created by earlier
+  // elements, hence the elements themselves are refined in order.
+  // Refining them in parallel would first need the new nodes numbered by
+  // the edge or face they split, as RefineMeshTetVolAlgoV does.
+
+  refined->node_reserve(num_nodes);
+  refined->elem_reserve(num_elems);
+  for (VMesh::Node::index_type i=0; i<num_nodes; i++)
   {
     Point p;
-    mesh->get_point(p, *bni);
+    mesh->get_point(p, i);
     refined->add_point(p);
-    ++bni;
   }
 
   std::vector<double> ivalues;
   std::vector<double> evalues;
+  evalues.reserve(num_elems);
 
   //maxnode = mesh->num_nodes();
   init_pattern_table();
 
   // get all values, make computation easier
-  VMesh::size_type num_nodes = mesh->num_nodes();
-  VMesh::size_type num_elems = mesh->num_elems();
 
   // get all values, make computation easier
   std::vector<bool> values(num_nodes,false);
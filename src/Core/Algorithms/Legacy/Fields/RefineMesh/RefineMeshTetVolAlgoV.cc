@@ -41,7 +41,10 @@
 
 //STL classes needed
 //#include <sci_hash_map.h>
+#include <Core/Thread/Parallel.h>
+
 #include <algorithm>
+#include <numeric>
 #include <set>
 
 /////////////////////////////////////////////////////
@@ -52,6 +55,561 @@ using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Thread;
+
+namespace {
+
+// Split one tetrahedron. n[0..3] are its nodes and n[4..9] the nodes added on
+// its six edges, 0 when an edge is not split. The children are written to
+// tets, four nodes each, and their number is returned. A null tets only
+// counts the children.
+int split_tet(const VMesh::index_type n[10], VMesh::index_type* tets)
+{
+  const VMesh::index_type i0 = n[0];
+  const VMesh::index_type i1 = n[1];
+  const VMesh::index_type i2 = n[2];
+  const VMesh::index_type i3 = n[3];
+  const VMesh::index_type i4 = n[4];
+  const VMesh::index_type i5 = n[5];
+  const VMesh::index_type i6 = n[6];
+  const VMesh::index_type i7 = n[7];
+  const VMesh::index_type i8 = n[8];
+  const VMesh::index_type i9 = n[9];
+
+  VMesh::index_type nnodes[4];
+  int count = 0;
+  auto emit = [&](const VMesh::index_type* tet)
+  {
+    if (tets) std::copy(tet, tet+4, tets+4*count);
+    count++;
+  };
+
+  if (i4==0 && i5 == 0 && i6 == 0 && i7==0 && i8 == 0 && i9 == 0)
+  {
+    emit(n);
+  }
+  else if (i4 > 0 && i5 > 0 && i6 > 0 && i7 > 0 && i8 > 0 && i9 > 0)
+  {
+    nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i8;
+    emit(nnodes);
+    nnodes[0] =i4; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i7;
+    emit(nnodes);
+    nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i9;
+    emit(nnodes);
+    nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i5; nnodes[3] = i7;
+    emit(nnodes);
+    nnodes[0] =i6; nnodes[1] = i7; nnodes[2] = i5; nnodes[3] = i9;
+    emit(nnodes);
+    nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+    emit(nnodes);
+    nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
+    emit(nnodes);
+    nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
+    emit(nnodes);
+  }
+  else if (i5 == 0 && i8 == 0 && i9 == 0)
+  {
+    if ( i1 < i2 && i2 <i3)
+    { //Checked orientation
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i1 < i3 && i3 < i2)
+    { // checked orientation
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i2< i1 && i1 < i3)
+    { // checked orientation
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i1;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i2 < i3 && i3 < i1)
+    { // checked orientation
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i1;
+      emit(nnodes);
+    }
+    else if (i3 < i1 && i1 < i2)
+    { // checked orientation
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i4; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i1; nnodes[1] = i2; nnodes[2] = i6; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else
+    { // checked orientation
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i6; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
+      emit(nnodes);
+    }
+  }
+  else if (i4 == 0 && i7 == 0 && i8 == 0)
+  {
+    if ( i0 < i1 && i1 <i3)
+    { //Checked orientation
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i0 < i3 && i3 < i1)
+    { // checked orientation
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i1< i0 && i0 < i3)
+    { // checked orientation
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i1 < i3 && i3 < i0)
+    { // checked orientation
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+    }
+    else if (i3 < i0 && i0 < i1)
+    { // checked orientation
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i6; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i0; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else
+    { // checked orientation
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
+      emit(nnodes);
+    }
+  }
+  else if (i6 == 0 && i9 == 0 && i7 == 0)
+  {
+    if ( i2 < i0 && i0 <i3)
+    { //Checked orientation
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i2 < i3 && i3 < i0)
+    { // checked orientation
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i0< i2 && i2 < i3)
+    { // checked orientation
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i2;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else if (i0 < i3 && i3 < i2)
+    { // checked orientation
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i2;
+      emit(nnodes);
+    }
+    else if (i3 < i2 && i2 < i0)
+    { // checked orientation
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i5; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i2; nnodes[1] = i0; nnodes[2] = i4; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else
+    { // checked orientation
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i4; nnodes[3] = i3;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
+      emit(nnodes);
+    }
+  }
+  else if (i5 == 0 && i6 == 0 && i4 == 0)
+  {
+    if ( i2 < i1 && i1 <i0)
+    { //Checked orientation
+      nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+    }
+    else if (i2 < i0 && i0 < i1)
+    { // checked orientation
+      nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+    }
+    else if (i1< i2 && i2 < i0)
+    { // checked orientation
+      nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i2;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+    }
+    else if (i1 < i0 && i0 < i2)
+    { // checked orientation
+      nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i0; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i2;
+      emit(nnodes);
+    }
+    else if (i0 < i2 && i2 < i1)
+    { // checked orientation
+      nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i2; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i2; nnodes[1] = i1; nnodes[2] = i8; nnodes[3] = i0;
+      emit(nnodes);
+    }
+    else
+    { // checked orientation
+      nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i1; nnodes[2] = i8; nnodes[3] = i0;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
+      emit(nnodes);
+    }
+  }
+  else if (i8 == 0)
+  {
+    if (i1 < i3)
+    {
+      nnodes[0] =i2; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i1; nnodes[2] = i3; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i1; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i7; nnodes[2] = i6; nnodes[3] = i0;
+      emit(nnodes);
+    }
+    else
+    {
+      nnodes[0] =i2; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i1; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i3; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i7; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i6; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i7; nnodes[3] = i0;
+      emit(nnodes);
+    }
+  }
+  else if (i9 == 0)
+  {
+    if (i2 < i3)
+    {
+      nnodes[0] =i0; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i3; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i2; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i8; nnodes[2] = i4; nnodes[3] = i1;
+      emit(nnodes);
+    }
+    else
+    {
+      nnodes[0] =i0; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i2; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i3; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i8; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i4; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i8; nnodes[3] = i1;
+      emit(nnodes);
+    }
+  }
+  else if (i7 == 0)
+  {
+    if (i0 < i3)
+    {
+      nnodes[0] =i1; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i0; nnodes[2] = i3; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i0; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i9; nnodes[2] = i5; nnodes[3] = i2;
+      emit(nnodes);
+    }
+    else
+    {
+      nnodes[0] =i1; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i0; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i3; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i9; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i5; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i9; nnodes[3] = i2;
+      emit(nnodes);
+    }
+  }
+  else if (i6 == 0)
+  {
+    if (i2 < i0)
+    {
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i2; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i4;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else
+    {
+      nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i7; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i3;
+      emit(nnodes);
+    }
+  }
+  else if (i5 == 0)
+  {
+    if (i1 < i2)
+    {
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i7; nnodes[2] = i4; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i1; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i6;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else
+    {
+      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i9; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
+      emit(nnodes);
+    }
+  }
+  else if (i4 == 0)
+  {
+    if (i0 < i1)
+    {
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i9; nnodes[2] = i6; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i0; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i8; nnodes[1] = i7; nnodes[2] = i9; nnodes[3] = i5;
+      emit(nnodes);
+      nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
+      emit(nnodes);
+    }
+    else
+    {
+      nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i8;
+      emit(nnodes);
+      nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i8; nnodes[3] = i9;
+      emit(nnodes);
+      nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i7;
+      emit(nnodes);
+      nnodes[0] =i9; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i3;
+      emit(nnodes);
+    }
+  }
+
+  return (count);
+}
+
+}
 
 RefineMeshTetVolAlgoV::RefineMeshTetVolAlgoV()
 {
@@ -179,636 +737,112 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
     for (size_t j=0;j<values.size();j++) values[j] = true;
   }
   
-  // Copy all of the nodes from mesh to refined.  They won't change,
-  // we only add nodes.
-  
-  VMesh::Node::iterator bni, eni;
-  mesh->begin(bni); mesh->end(eni);
-  while (bni != eni)
+  // Nodes added on the split edges are numbered in edge order after the
+  // nodes of the input mesh. The elements are split in two passes, one to
+  // count the children and one to write them into preallocated arrays, so
+  // the output does not depend on the number of threads.
+
+  const VMesh::size_type num_edges = mesh->num_edges();
+  std::vector<VMesh::index_type> enodes(num_edges,0);
+
+  Parallel::For(0, num_edges, [&](size_t first, size_t last)
   {
-    Point p;
-    mesh->get_point(p, *bni);
-    refined->add_point(p);
-    ++bni;
+    VMesh::Node::array_type nodes(2);
+    for (size_t e = first; e < last; e++)
+    {
+      mesh->get_nodes(nodes,VMesh::Edge::index_type(e));
+      if ((values[nodes[0]] == true) || (values[nodes[1]] == true)) enodes[e] = 1;
+    }
+  });
+
+  std::vector<VMesh::Edge::index_type> split_edges;
+  VMesh::index_type next_node = num_nodes;
+  for (VMesh::index_type e = 0; e < num_edges; e++)
+  {
+    if (enodes[e])
+    {
+      enodes[e] = next_node++;
+      split_edges.push_back(VMesh::Edge::index_type(e));
+    }
   }
 
-  std::vector<VMesh::index_type> enodes(mesh->num_edges(),0);
+  std::vector<Point> points(next_node);
+  if (field->basis_order() == 1) ivalues.resize(next_node);
 
-  VMesh::Node::array_type nodes(2);
-  Point p0, p1,p2, p3, p;
-  VMesh::Edge::iterator be, ee;
-  mesh->begin(be); mesh->end(ee);
+  Parallel::For(0, num_nodes, [&](size_t first, size_t last)
+  {
+    for (size_t k = first; k < last; k++)
+      mesh->get_point(points[k],VMesh::Node::index_type(k));
+  });
 
-  // add all additional nodes we need
-  while (be != ee)
+  Parallel::For(0, split_edges.size(), [&](size_t first, size_t last)
   {
-    mesh->get_nodes(nodes,*be);
-    if ((values[nodes[0]] == true) || (values[nodes[1]] == true))
+    VMesh::Node::array_type nodes(2);
+    Point p0, p1;
+    for (size_t k = first; k < last; k++)
     {
+      mesh->get_nodes(nodes,split_edges[k]);
       mesh->get_center(p0,nodes[0]);
       mesh->get_center(p1,nodes[1]);
-    
-      p = (p0 + p1).asPoint()*0.5;
-    
-      enodes[*be] = refined->add_point(p);
-      if(field->basis_order() == 1)
-      {
-        ivalues.push_back(0.5*(ivalues[nodes[0]]+ivalues[nodes[1]]));
-      }
+      points[num_nodes+k] = (p0 + p1).asPoint()*0.5;
+      if (field->basis_order() == 1)
+        ivalues[num_nodes+k] = 0.5*(ivalues[nodes[0]]+ivalues[nodes[1]]);
     }
-    ++be;
-  }
-
+  });
 
-  VMesh::Edge::array_type oedges(6);
-  VMesh::Node::array_type nnodes(4);
+  auto elem_nodes = [&](VMesh::Elem::index_type idx, VMesh::index_type n[10],
+                        VMesh::Node::array_type& nodes, VMesh::Edge::array_type& edges)
+  {
+    mesh->get_nodes(nodes,idx);
+    mesh->get_edges(edges,idx);
+    for (int j = 0; j < 4; j++) n[j] = nodes[j];
+    for (int j = 0; j < 6; j++) n[4+j] = enodes[edges[j]];
+  };
 
-  VMesh::Elem::iterator bi, ei;
-  mesh->begin(bi); mesh->end(ei);
+  std::vector<VMesh::index_type> offsets(num_elems+1,0);
 
-  unsigned int cnt = 0;
-  unsigned int loopcnt = 0;
+  Parallel::For(0, num_elems, [&](size_t first, size_t last)
+  {
+    VMesh::Node::array_type nodes(4);
+    VMesh::Edge::array_type edges(6);
+    VMesh::index_type n[10];
+    for (size_t k = first; k < last; k++)
+    {
+      elem_nodes(VMesh::Elem::index_type(k),n,nodes,edges);
+      offsets[k+1] = split_tet(n,0);
+    }
+  });
 
-  VMesh::Elem::size_type sz; mesh->size(sz);
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
 
+  const VMesh::size_type num_tets = offsets[num_elems];
+  std::vector<VMesh::index_type> tets(4*num_tets);
+  if (field->basis_order() == 0) evalues.resize(num_tets);
 
-  while (bi != ei)
+  Parallel::For(0, num_elems, [&](size_t first, size_t last)
   {
-			cnt++; if (cnt == 100) { loopcnt +=cnt; cnt = 0;}// algo->update_progress(loopcnt,sz);  }
-    mesh->get_nodes(onodes, *bi);
-    mesh->get_edges(oedges, *bi);
-
-    VMesh::index_type i0 = onodes[0];
-    VMesh::index_type i1 = onodes[1];
-    VMesh::index_type i2 = onodes[2];
-    VMesh::index_type i3 = onodes[3];
-    VMesh::index_type i4 = enodes[oedges[0]];
-    VMesh::index_type i5 = enodes[oedges[1]];
-    VMesh::index_type i6 = enodes[oedges[2]];
-    VMesh::index_type i7 = enodes[oedges[3]];
-    VMesh::index_type i8 = enodes[oedges[4]];
-    VMesh::index_type i9 = enodes[oedges[5]];
-
-    if (i4==0 && i5 == 0 && i6 == 0 && i7==0 && i8 == 0 && i9 == 0)
-    {
-      refined->add_elem(onodes);
-      if(field->basis_order() == 0) evalues.push_back(ivalues[*bi]);
-    }
-    else if (i4 > 0 && i5 > 0 && i6 > 0 && i7 > 0 && i8 > 0 && i9 > 0)
+    VMesh::Node::array_type nodes(4);
+    VMesh::Edge::array_type edges(6);
+    VMesh::index_type n[10];
+    for (size_t k = first; k < last; k++)
     {
-      nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i8;
-      refined->add_elem(nnodes);
-      nnodes[0] =i4; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i7;
-      refined->add_elem(nnodes);
-      nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i9;
-      refined->add_elem(nnodes);
-      nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i5; nnodes[3] = i7;
-      refined->add_elem(nnodes);
-      nnodes[0] =i6; nnodes[1] = i7; nnodes[2] = i5; nnodes[3] = i9;
-      refined->add_elem(nnodes);
-      nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-      refined->add_elem(nnodes);
-      nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
-      refined->add_elem(nnodes);
-      nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
-      refined->add_elem(nnodes);
-      if(field->basis_order() == 0) evalues.insert(evalues.end(),8,ivalues[*bi]);
+      elem_nodes(VMesh::Elem::index_type(k),n,nodes,edges);
+      split_tet(n,&tets[4*offsets[k]]);
+      if (field->basis_order() == 0)
+        std::fill(evalues.begin()+offsets[k], evalues.begin()+offsets[k+1], ivalues[k]);
     }
-    else if (i5 == 0 && i8 == 0 && i9 == 0)
-    {
-      if ( i1 < i2 && i2 <i3)
-      { //Checked orientation
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i1 < i3 && i3 < i2)
-      { // checked orientation
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i2< i1 && i1 < i3)
-      { // checked orientation
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i1;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i2 < i3 && i3 < i1)
-      { // checked orientation
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i1;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i3 < i1 && i1 < i2)
-      { // checked orientation
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i1; nnodes[1] = i2; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else
-      { // checked orientation
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-    }
-    else if (i4 == 0 && i7 == 0 && i8 == 0)
-    {
-      if ( i0 < i1 && i1 <i3)
-      { //Checked orientation
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i0 < i3 && i3 < i1)
-      { // checked orientation
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i1< i0 && i0 < i3)
-      { // checked orientation
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i1 < i3 && i3 < i0)
-      { // checked orientation
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i3 < i0 && i0 < i1)
-      { // checked orientation
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i0; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else
-      { // checked orientation
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-    }
-    else if (i6 == 0 && i9 == 0 && i7 == 0)
-    {
-      if ( i2 < i0 && i0 <i3)
-      { //Checked orientation
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i2 < i3 && i3 < i0)
-      { // checked orientation
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i0< i2 && i2 < i3)
-      { // checked orientation
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i2;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i0 < i3 && i3 < i2)
-      { // checked orientation
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i2;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i3 < i2 && i2 < i0)
-      { // checked orientation
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i2; nnodes[1] = i0; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else
-      { // checked orientation
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-    }
-    else if (i5 == 0 && i6 == 0 && i4 == 0)
-    {
-      if ( i2 < i1 && i1 <i0)
-      { //Checked orientation
-        nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i2 < i0 && i0 < i1)
-      { // checked orientation
-        nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i1< i2 && i2 < i0)
-      { // checked orientation
-        nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i2;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i1 < i0 && i0 < i2)
-      { // checked orientation
-        nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i0; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i2;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else if (i0 < i2 && i2 < i1)
-      { // checked orientation
-        nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i2; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i2; nnodes[1] = i1; nnodes[2] = i8; nnodes[3] = i0;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-      else
-      { // checked orientation
-        nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i1; nnodes[2] = i8; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
-      }
-    }
-    else if (i8 == 0)
-    {
-      if (i1 < i3)
-      {
-        nnodes[0] =i2; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i1; nnodes[2] = i3; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i1; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i4;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i9; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i7; nnodes[2] = i6; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-      else
-      {
-        nnodes[0] =i2; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i1; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i3; nnodes[3] = i7;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i7; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i6; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i7; nnodes[3] = i0;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-    }
-    else if (i9 == 0)
-    {
-      if (i2 < i3)
-      {
-        nnodes[0] =i0; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i3; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i2; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i5;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i7; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i8; nnodes[2] = i4; nnodes[3] = i1;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-      else
-      {
-        nnodes[0] =i0; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i2; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i3; nnodes[3] = i8;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i8; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i4; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i8; nnodes[3] = i1;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-    }
-    else if (i7 == 0)
-    {
-      if (i0 < i3)
-      {
-        nnodes[0] =i1; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i0; nnodes[2] = i3; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i0; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i6;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i8; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i9; nnodes[2] = i5; nnodes[3] = i2;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-      else
-      {
-        nnodes[0] =i1; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i0; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i3; nnodes[3] = i9;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i9; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i5; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i9; nnodes[3] = i2;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-    }
-    else if (i6 == 0)
-    {
-      if (i2 < i0)
-      {
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i4;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-      else
-      {
-        nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i7; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-    }
-    else if (i5 == 0)
-    {
-      if (i1 < i2)
-      {
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i7; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i6;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-      else
-      {
-        nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i9; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-    }
-    else if (i4 == 0)
-    {
-      if (i0 < i1)
-      {
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i9; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i8; nnodes[1] = i7; nnodes[2] = i9; nnodes[3] = i5;
-        refined->add_elem(nnodes);
-        nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-      else
-      {
-        nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i8;
-        refined->add_elem(nnodes);
-        nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);                              
-        nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i8; nnodes[3] = i9;
-        refined->add_elem(nnodes);
-        nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i7;
-        refined->add_elem(nnodes);
-        nnodes[0] =i9; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
-      }
-    }
-    ++bi;
+  });
+
+  refined->node_reserve(points.size());
+  for (size_t k = 0; k < points.size(); k++)
+    refined->add_point(points[k]);
+
+  VMesh::Node::array_type nnodes(4);
+  refined->elem_reserve(num_tets);
+  for (VMesh::index_type k = 0; k < num_tets; k++)
+  {
+    std::copy(&tets[4*k], &tets[4*k]+4, nnodes.begin());
+    refined->add_elem(nnodes);
   }
 
   rfield->resize_values();
@@ -91,13 +91,9 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
   if (method == "fast")
   {
     // Fast neighborhoods
-    std::vector<VMesh::Node::array_type > neighborhoods(num_nodes);
+    VMesh::adjacency_type neighborhoods;
     mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
-
-    for (VMesh::Node::index_type idx=0; idx<num_nodes; idx++)
-    {
-      mesh->get_neighbors(neighborhoods[idx],idx);
-    }
+    mesh->get_node_adjacency(neighborhoods);
 
     std::vector<Vector> disp(num_nodes);
     Point*  point = mesh->get_points_pointer();
@@ -108,7 +104,7 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
       {
         p0 = point[idx];
         Vector d(0.0,0.0,0.0);
-        VMesh::Node::array_type &neighbors = neighborhoods[idx];
+        const VMesh::adjacency_type::Row neighbors = neighborhoods[idx];
         double w = 1.0/(neighbors.size());
         for (size_t j=0; j<neighbors.size(); j++)
         {
@@ -133,19 +129,22 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
   else
   {
     // desbrun method
-    std::vector<std::vector<std::pair<VMesh::index_type,VMesh::index_type> > > neighborhoods(num_nodes);
+    MeshAdjacency<std::pair<VMesh::index_type,VMesh::index_type> > neighborhoods;
     mesh->synchronize(Mesh::NODE_NEIGHBORS_E|Mesh::EPSILON_E);
 
-    VMesh::Elem::array_type elems;
+    VMesh::adjacency_type node_elems;
+    mesh->get_elem_adjacency(node_elems);
+
     VMesh::Node::array_type nodes;
+    std::vector<std::pair<VMesh::index_type,VMesh::index_type> > neighborhood;
 
     for (VMesh::Node::index_type idx=0; idx<num_nodes; idx++)
     {
-      std::vector<std::pair<VMesh::index_type,VMesh::index_type> > &neighborhood = neighborhoods[idx];
-      mesh->get_elems(elems,idx);
+      const VMesh::adjacency_type::Row elems = node_elems[idx];
+      neighborhood.clear();
       for (size_t j = 0; j<elems.size(); j++)
       {
-        mesh->get_nodes(nodes,elems[j]);
+        mesh->get_nodes(nodes,VMesh::Elem::index_type(elems[j]));
         // make it circular
         nodes.push_back(nodes[0]);
  
@@ -158,6 +157,7 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
           }
         }
       }
+      neighborhoods.add_row(neighborhood.begin(), neighborhood.end());
     }
     
     std::vector<Vector> disp(num_nodes);
@@ -180,7 +180,7 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
         Vector p12;
         
         // get local neighborhood pairs
-        const std::vector<std::pair<VMesh::index_type,VMesh::index_type> > &neighborhood = neighborhoods[idx];
+        const MeshAdjacency<std::pair<VMesh::index_type,VMesh::index_type> >::Row neighborhood = neighborhoods[idx];
         
         // if no neighborhood continue
         if (neighborhood.empty()) continue;
@@ -33,14 +33,15 @@
 #include <Core/Algorithms/Legacy/Fields/StreamLines/GenerateStreamLines.h>
 #include <Core/Algorithms/Legacy/Fields/StreamLines/StreamLineIntegrators.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
-#include <Core/Algorithms/Legacy/Fields/MergeFields/JoinFieldsAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingTiles.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Thread/Interruptible.h>
-#include <Core/Thread/Barrier.h>
 #include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <atomic>
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
@@ -81,6 +82,9 @@ GenerateStreamLinesAlgo::GenerateStreamLinesAlgo()
 namespace detail
 {
 
+// Number of seeds a thread claims at a time
+const VMesh::size_type seeds_per_tile = 16;
+
 void CleanupStreamLinePoints(const std::vector<Point> &input, std::vector<Point> &output, double e2)
 {
   // Removes colinear points from the list of points.
@@ -161,14 +165,133 @@ StreamlineValue convertValue(const std::string& option)
 }
 
 
+// Streamlines traced by one thread. The points are kept in flat arrays until
+// all threads are done, so the output mesh is built once and in seed order.
+class StreamLineBuffer
+{
+  public:
+    void add(index_type seed, int first_index, const std::vector<Point>& nodes)
+    {
+      if (nodes.empty()) return;
+      seeds_.push_back(seed);
+      first_index_.push_back(first_index);
+      offsets_.push_back(points_.size());
+      points_.insert(points_.end(), nodes.begin(), nodes.end());
+    }
+
+    size_t num_lines() const { return (seeds_.size()); }
+    size_t line_end(size_t line) const
+      { return (line+1 < offsets_.size() ? offsets_[line+1] : points_.size()); }
+    size_t num_points() const { return (points_.size()); }
+
+    std::vector<index_type> seeds_;       // seed of each streamline
+    std::vector<int>        first_index_; // integration index of its first point
+    std::vector<size_t>     offsets_;     // start of each streamline in points_
+    std::vector<Point>      points_;
+};
+
+// Build the output curve mesh from the buffers of all threads. The values
+// follow the streamline value option, seed values are copied from value_field.
+void MergeStreamLines(const std::vector<StreamLineBuffer>& buffers,
+                      StreamlineValue value, VField* value_field,
+                      FieldHandle& output)
+{
+  struct LineRef
+  {
+    index_type seed;
+    size_t buffer;
+    size_t line;
+    bool operator<(const LineRef& other) const { return (seed < other.seed); }
+  };
+
+  std::vector<LineRef> lines;
+  size_t num_points = 0;
+  for (size_t b = 0; b < buffers.size(); b++)
+  {
+    for (size_t l = 0; l < buffers[b].num_lines(); l++)
+    {
+      LineRef ref = { buffers[b].seeds_[l], b, l };
+      lines.push_back(ref);
+    }
+    num_points += buffers[b].num_points();
+  }
+  std::sort(lines.begin(), lines.end());
+
+  VField* ofield = output->vfield();
+  VMesh*  omesh = output->vmesh();
+
+  omesh->node_reserve(num_points);
+  omesh->elem_reserve(num_points - lines.size());
+
+  std::vector<double> values;
+  values.reserve(num_points);
+
+  VMesh::Node::array_type newnodes(2);
+
+  for (size_t r = 0; r < lines.size(); r++)
+  {
+    const StreamLineBuffer& buffer = buffers[lines[r].buffer];
+    const size_t line = lines[r].line;
+    const size_t begin = buffer.offsets_[line];
+    const size_t end = buffer.line_end(line);
+    const Point& p1 = buffer.points_[begin];
+
+    double length = 0.0;
+    if (value == StreamlineLength)
+    {
+      for (size_t k = begin+1; k < end; k++)
+        length += Vector(buffer.points_[k]-buffer.points_[k-1]).length();
+    }
+
+    int cc = buffer.first_index_[line];
+    double distance = 0.0;
+
+    for (size_t k = begin; k < end; k++, cc++)
+    {
+      newnodes[1] = omesh->add_point(buffer.points_[k]);
+      if (k > begin)
+        omesh->add_elem(newnodes);
+      newnodes[0] = newnodes[1];
+
+      const double step = (k > begin) ? Vector(buffer.points_[k]-p1).length() : 0.0;
+      distance += step;
+
+      if (value == SeedIndex) values.push_back(static_cast<double>(lines[r].seed));
+      else if (value == IntegrationIndex) values.push_back(abs(cc));
+      else if (value == IntegrationStep) values.push_back(step);
+      else if (value == DistanceFromSeed) values.push_back(distance);
+      else if (value == StreamlineLength) values.push_back(length);
+    }
+  }
+
+  ofield->resize_values();
+
+  if (value == SeedValue)
+  {
+    VMesh::Node::index_type n = 0;
+    for (size_t r = 0; r < lines.size(); r++)
+    {
+      const StreamLineBuffer& buffer = buffers[lines[r].buffer];
+      const size_t line = lines[r].line;
+      for (size_t k = buffer.offsets_[line]; k < buffer.line_end(line); k++, ++n)
+        ofield->copy_value(value_field, lines[r].seed, n);
+    }
+  }
+  else
+  {
+    ofield->set_values(values);
+  }
+}
+
+
 class GenerateStreamLinesAlgoP : public Core::Thread::Interruptible
 {
 
   public:
      GenerateStreamLinesAlgoP(const AlgorithmBase* algo) :
-      algo_(algo), numprocessors_(Parallel::NumCores()), barrier_("FEMVolRHSBuilder Barrier", numprocessors_),
+      algo_(algo), numprocessors_(Parallel::NumCores()),
       tolerance_(0), step_size_(0), max_steps_(0), direction_(0), value_(SeedIndex), remove_colinear_pts_(false),
-      method_(AdamsBashforth), seed_field_(0), seed_mesh_(0), field_(0), mesh_(0), ofield_(0), omesh_(0)
+      method_(AdamsBashforth), seed_field_(0), seed_mesh_(0), field_(0), mesh_(0), failed_(false)
     {}
 
     bool run(FieldHandle input,
@@ -176,10 +299,8 @@ class GenerateStreamLinesAlgoP : public Core::Thread::Interruptible
              IntegrationMethod method);
 
   private:
-    void runImpl();
     const AlgorithmBase* algo_;
     int numprocessors_;
-    Barrier barrier_;
     double tolerance_;
     double step_size_;
     int    max_steps_;
@@ -194,51 +315,37 @@ class GenerateStreamLinesAlgoP : public Core::Thread::Interruptible
     VField* field_;
     VMesh*  mesh_;
 
-    VField* ofield_;
-    VMesh*  omesh_;
-
-    FieldHandle input_;
-    std::vector<bool> success_;
-    FieldList outputs_;
-    VMesh::Node::index_type global_dimension_;
+    MappingTiles tiles_;
+    std::vector<StreamLineBuffer> buffers_;
+    std::atomic<bool> failed_;
     void parallel(int proc);
-    FieldHandle StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num);
 };
 
-FieldHandle GenerateStreamLinesAlgoP::StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num)
+void GenerateStreamLinesAlgoP::parallel(int proc_num)
 {
-  FieldHandle out;
   try
   {
-    VMesh::Node::index_type n1, n2;
-    Vector test;
-    FieldInformation fi(input_);
-    fi.make_curvemesh();
-    fi.make_lineardata();
-    fi.make_linearmesh();
-    fi.make_double();
-    out = CreateField(fi);
-    VField* ofield=out->vfield();
-    VMesh*  omesh=out->vmesh();
-
     StreamLineIntegrators BI;
     BI.nodes_.reserve(max_steps_);                  // storage for points
     BI.tolerance2_  = tolerance_ * tolerance_;      // square error tolerance
     BI.max_steps_    = max_steps_;                  // max number of steps
     BI.vfield_      = field_;                       // the vector field
-    std::vector<Point>::iterator node_iter;
+    Vector test;
 
-    // Try to find the streamline for each seed point.
-    //VMesh::size_type num_seeds = seed_mesh_->num_nodes();
-    VMesh::Node::array_type newnodes(2);
+    StreamLineBuffer& buffer = buffers_[proc_num];
+
+    // Seeds are claimed a tile at a time, so threads that trace short
+    // streamlines pick up the remaining seeds of the others.
+    MappingTiles::Cursor cursor(tiles_);
+    VMesh::Node::index_type idx;
 
-    for (VMesh::Node::index_type idx=from; idx<to; ++idx)
+    while (!failed_ && cursor.next(idx))
     {
       checkForInterruption();
       seed_mesh_->get_point(BI.seed_, idx);
 
        // Is the seed point inside the field?
-      if (!field_->interpolate(test, BI.seed_))
+      if (!BI.interpolate(BI.seed_, test))
         continue;
 
       BI.nodes_.clear();
@@ -269,126 +376,27 @@ FieldHandle GenerateStreamLinesAlgoP::StreamLinesForCertainSeeds(VMesh::Node::in
         BI.integrate( method_ );
       }
 
-      double length = 0;
-      Point p1;
-
-      if (value_ == StreamlineLength)
-      {
-        node_iter = BI.nodes_.begin();
-        if (node_iter != BI.nodes_.end())
-        {
-          p1 = *node_iter;
-          ++node_iter;
-
-          while (node_iter != BI.nodes_.end())
-          {
-            length += Vector( *node_iter-p1 ).length();
-            p1 = *node_iter;
-            ++node_iter;
-          }
-        }
-      }
-
-      node_iter = BI.nodes_.begin();
-
-      if (node_iter != BI.nodes_.end())
-      {
-        p1 = *node_iter;
-        n1 = omesh->add_point(p1);
-
-	// Record the streamline point indexes. Used downstream.
-	//std::ostringstream str;
-	//str << "Streamline " << (unsigned int) idx << " Node Index";
-	//ofield->set_property( str.str(), (unsigned int) n1, false );
-
-        ofield->resize_values();
-
-        if (value_ == SeedValue) ofield->copy_value(seed_field_, idx, n1);
-        else if (value_ == SeedIndex) ofield->set_value(index_type(idx), n1);
-        else if (value_ == IntegrationIndex) ofield->set_value(abs(cc), n1);
-        else if (value_ == IntegrationStep) ofield->set_value(0, n1);
-        else if (value_ == DistanceFromSeed) ofield->set_value(0, n1);
-        else if (value_ == StreamlineLength) ofield->set_value(length, n1);
-
-        ++node_iter;
-        cc++;
+      buffer.add(idx, cc, BI.nodes_);
 
-        while (node_iter != BI.nodes_.end())
-        {
-          n2 = omesh->add_point(*node_iter);
-          ofield->resize_fdata();
-
-          if (value_ == SeedValue) ofield->copy_value(seed_field_, idx, n2);
-          else if (value_ == SeedIndex) ofield->set_value(index_type(idx), n2);
-          else if (value_ == IntegrationIndex) ofield->set_value(abs(cc), n2);
-          else if (value_ == IntegrationStep)
-          {
-            length = Vector( *node_iter-p1 ).length();
-            ofield->set_value(length,n2);
-          }
-          else if (value_ == DistanceFromSeed)
-          {
-            length += Vector( *node_iter-p1 ).length();
-            ofield->set_value(length,n2);
-          }
-          else if (value_ == StreamlineLength)
-	        {
-	           ofield->set_value(length,n2);
-          }
-
-          newnodes[0] = n1;
-          newnodes[1] = n2;
-
-          omesh->add_elem(newnodes);
-          n1 = n2;
-          ++node_iter;
-
-          cc++;
-        }
-      }
-
-	  if(proc_num==0)
-	    algo_->update_progress_max(idx,to);
+      if (proc_num == 0)
+        algo_->update_progress_max(cursor.position(), tiles_.size());
     }
-
-    #ifdef NEEDS_ADDITIONAL_ALGO_OUTPUT
-    algo_->set_int("num_streamlines", num_seeds);
-    #endif
-
-    // Record the number of streamline. Used downstream.
-    //ofield->set_property( "Streamline Count", (unsigned int) num_seeds, false );
-   }
-
+  }
   catch (const Exception &e)
   {
     algo_->error(std::string("Crashed with the following exception:\n")+e.message());
-    success_[proc_num] = false;
+    failed_ = true;
   }
   catch (const std::string& a)
   {
     algo_->error(a);
-    success_[proc_num] = false;
+    failed_ = true;
   }
   catch (const char *a)
   {
     algo_->error(a);
-    success_[proc_num] = false;
+    failed_ = true;
   }
-
-  return out;
-}
-
-void GenerateStreamLinesAlgoP::parallel(int proc_num)
-{
- success_[proc_num] = true;
-
- for (int q=0; q<numprocessors_;q++)
-   if (success_[q] == false) return;
-
- const index_type start_gd = (global_dimension_ * proc_num)/numprocessors_+1;
- const index_type end_gd  = (global_dimension_ * (proc_num+1))/numprocessors_;
-
- outputs_[proc_num]=StreamLinesForCertainSeeds(start_gd, end_gd, proc_num);
 }
 
 bool GenerateStreamLinesAlgoP::run(FieldHandle input,
@@ -400,8 +408,6 @@ bool GenerateStreamLinesAlgoP::run(FieldHandle input,
   seed_mesh_ = seeds->vmesh();
   field_ = input->vfield();
   mesh_ = input->vmesh();
-  ofield_ = output->vfield();
-  omesh_ = output->vmesh();
   tolerance_ = algo_->get(Parameters::StreamlineTolerance).toDouble();
   step_size_ = algo_->get(Parameters::StreamlineStepSize).toDouble();
   max_steps_ = algo_->get(Parameters::StreamlineMaxSteps).toInt();
@@ -409,24 +415,24 @@ bool GenerateStreamLinesAlgoP::run(FieldHandle input,
   value_ = convertValue(algo_->getOption(Parameters::StreamlineValue));
   remove_colinear_pts_ = algo_->get(Parameters::RemoveColinearPoints).toBool();
   method_ = method;
-  input_=input;
-  global_dimension_=seed_mesh_->num_nodes();
-  if (global_dimension_<numprocessors_ || numprocessors_<1) numprocessors_=1;
+
+  const VMesh::size_type num_seeds = seed_mesh_->num_nodes();
+  if (num_seeds<numprocessors_ || numprocessors_<1) numprocessors_=1;
   if (numprocessors_>16) numprocessors_=16;  // request from Dan White to limit the number of threads
   if (!algo_->get(Parameters::UseMultithreading).toBool())
     numprocessors_ = 1;
-  success_.resize(numprocessors_,true);
-  outputs_.resize(numprocessors_, nullptr);
+
+  tiles_.setup(num_seeds, seeds_per_tile);
+  buffers_.resize(numprocessors_);
 
   Parallel::RunTasks([this](int i) { parallel(i); }, numprocessors_);
-  for (size_t j=0; j<success_.size(); j++)
-  {
-    if (success_[j] == false) return false;
-    if (outputs_[j]  == nullptr) return false;
-  }
-  JoinFieldsAlgo algo;
-  algo.set(JoinFieldsAlgo::MergeNodes,false);
-  algo.runImpl(outputs_, output);
+  if (failed_) return false;
+
+  MergeStreamLines(buffers_, value_, seed_field_, output);
+
+  #ifdef NEEDS_ADDITIONAL_ALGO_OUTPUT
+  algo_->set_int("num_streamlines", num_seeds);
+  #endif
 
   return true;
 }
@@ -440,9 +446,9 @@ class GenerateStreamLinesAccAlgo {
 
   public:
     GenerateStreamLinesAccAlgo() :
-      numprocessors_(Parallel::NumCores()), barrier_("FEMVolRHSBuilder Barrier", numprocessors_),
+      numprocessors_(Parallel::NumCores()),
       max_steps_(0), direction_(0), value_(SeedIndex), remove_colinear_pts_(false),
-      seed_field_(0), seed_mesh_(0)
+      seed_field_(0), seed_mesh_(0), field_(0), mesh_(0), failed_(false), algo_(0)
       {}
 
     bool run(const AlgorithmBase* algo, FieldHandle input, FieldHandle seeds, FieldHandle& output);
@@ -450,7 +456,6 @@ class GenerateStreamLinesAccAlgo {
     void find_nodes(std::vector<Point>& v, Point seed, bool back);
   private:
     int numprocessors_;
-    Barrier barrier_;
     int    max_steps_;
     int    direction_;
     StreamlineValue    value_;
@@ -463,48 +468,27 @@ class GenerateStreamLinesAccAlgo {
     VMesh*  mesh_;
 
     void parallel(int proc_num);
-    FieldHandle StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num);
-    std::vector<bool> success_;
-    FieldList outputs_;
-    FieldHandle input_;
-    VMesh::Node::index_type global_dimension_;
+    MappingTiles tiles_;
+    std::vector<StreamLineBuffer> buffers_;
+    std::atomic<bool> failed_;
     const AlgorithmBase* algo_;
 };
 
 void GenerateStreamLinesAccAlgo::parallel(int proc_num)
 {
- success_[proc_num] = true;
- for (int q=0; q<numprocessors_;q++)
-   if (success_[q] == false) return;
- const index_type start_gd = (global_dimension_ * proc_num)/numprocessors_;
- const index_type end_gd  = (global_dimension_ * (proc_num+1))/numprocessors_;
- outputs_[proc_num]=StreamLinesForCertainSeeds(start_gd, end_gd, proc_num);
-}
-
-
-FieldHandle GenerateStreamLinesAccAlgo::StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num)
-{
-  FieldInformation fi(input_);
-  fi.make_curvemesh();
-  fi.make_lineardata();
-  fi.make_linearmesh();
-  fi.make_double();
-  FieldHandle out;// = CreateField(fi);
   try
   {
-    out = CreateField(fi);
-    VField* ofield=out->vfield();
-    VMesh*  omesh=out->vmesh();
     Point seed;
     VMesh::Elem::index_type elem;
     std::vector<Point> nodes;
     nodes.reserve(max_steps_);
-    std::vector<Point>::iterator node_iter;
-    VMesh::Node::index_type n1, n2;
-    VMesh::Node::array_type newnodes(2);
+
+    StreamLineBuffer& buffer = buffers_[proc_num];
+    MappingTiles::Cursor cursor(tiles_);
+    VMesh::Node::index_type idx;
 
     // Try to find the streamline for each seed point.
-    for(VMesh::Node::index_type idx=from; idx<to; ++idx)
+    while (!failed_ && cursor.next(idx))
     {
       seed_mesh_->get_center(seed, idx);
 
@@ -535,114 +519,27 @@ FieldHandle GenerateStreamLinesAccAlgo::StreamLinesForCertainSeeds(VMesh::Node::
         find_nodes(nodes, seed, false);
       }
 
-      double length = 0;
-      Point p1;
-
-      if (value_ == StreamlineLength)
-      {
-        node_iter = nodes.begin();
-        if (node_iter != nodes.end())
-        {
-          p1 = *node_iter;
-          ++node_iter;
-
-          while (node_iter != nodes.end())
-          {
-            length += Vector( *node_iter-p1 ).length();
-            p1 = *node_iter;
-            ++node_iter;
-          }
-        }
-      }
-
-      node_iter = nodes.begin();
-
-      if (node_iter != nodes.end())
-      {
-        p1 = *node_iter;
-        n1 = omesh->add_point(*node_iter);
-
-	// Record the streamline point indexes. Used downstream.
-	//std::ostringstream str;
-	//str << "Streamline " << (unsigned int) idx << " Node Index";
-	//ofield_->set_property( str.str(), (unsigned int) n1, false );
-
-        ofield->resize_values();
-
-        if (value_ == SeedValue) ofield->copy_value(field_, idx, n1);
-        else if (value_ == SeedIndex) ofield->set_value(static_cast<int>(idx), n1);
-        else if (value_ == IntegrationIndex) ofield->set_value(abs(cc), n1);
-        else if (value_ == IntegrationStep) ofield->set_value(0, n1);
-        else if (value_ == DistanceFromSeed) ofield->set_value(0, n1);
-        else if (value_ == StreamlineLength) ofield->set_value(length, n1);
-        ++node_iter;
-
-        cc++;
-
-        while (node_iter != nodes.end())
-        {
-          n2 = omesh->add_point(*node_iter);
-          ofield->resize_values();
-
-          if (value_ == SeedValue) ofield->copy_value(field_, idx, n2);
-          else if (value_ == SeedIndex) ofield->set_value(static_cast<int>(idx), n2);
-          else if (value_ == IntegrationIndex) ofield->set_value(abs(cc), n2);
-          else if (value_ == IntegrationStep)
-          {
-            length = Vector( *node_iter-p1 ).length();
-            ofield->set_value(length,n2);
-          }
-          else if (value_ == DistanceFromSeed)
-          {
-            length += Vector( *node_iter-p1 ).length();
-            ofield->set_value(length,n2);
-          }
-          else if (value_ == StreamlineLength)
-	       {
-	          ofield->set_value(length,n2);
-          }
-
-          newnodes[0] = n1;
-          newnodes[1] = n2;
-
-          omesh->add_elem(newnodes);
-
-          n1 = n2;
-          ++node_iter;
-
-          cc++;
-        }
-      }
+      buffer.add(idx, cc, nodes);
 
       if (proc_num==0)
-        algo_->update_progress_max(from, to);
+        algo_->update_progress_max(cursor.position(), tiles_.size());
     }
-
-#ifdef NEED_ADDITIONAL_ALGO_OUTPUT
-    algo->set_int("num_streamlines", num_seeds);
-    #endif
-
-    // Record the number of streamline. Used downstream.
-    //ofield_->set_property( "Streamline Count", (unsigned int) num_seeds, false );
   }
-
   catch (const Exception &e)
   {
     algo_->error(std::string("Crashed with the following exception:\n")+e.message());
-    success_[proc_num] = false;
+    failed_ = true;
   }
   catch (const std::string& a)
   {
     algo_->error(a);
-    success_[proc_num] = false;
+    failed_ = true;
   }
   catch (const char *a)
   {
     algo_->error(a);
-    success_[proc_num] = false;
+    failed_ = true;
   }
-
-  return out;
 }
 
 
@@ -652,7 +549,6 @@ bool GenerateStreamLinesAccAlgo::run(const AlgorithmBase* algo, FieldHandle inpu
 {
   seed_field_ = seeds->vfield();
   seed_mesh_ = seeds->vmesh();
-  input_=input;
   field_ = input->vfield();
   mesh_ = input->vmesh();
   algo_=algo;
@@ -660,25 +556,23 @@ bool GenerateStreamLinesAccAlgo::run(const AlgorithmBase* algo, FieldHandle inpu
   direction_ = convertDirectionOption(algo_->getOption(Parameters::StreamlineDirection));
   value_ = convertValue(algo_->getOption(Parameters::StreamlineValue));
   remove_colinear_pts_ = algo_->get(Parameters::RemoveColinearPoints).toBool();
-  global_dimension_=seed_mesh_->num_nodes();
-  if (global_dimension_<numprocessors_)
+
+  const VMesh::size_type num_seeds = seed_mesh_->num_nodes();
+  if (num_seeds<numprocessors_)
     numprocessors_ = 1;
   if (!algo_->get(Parameters::UseMultithreading).toBool())
     numprocessors_ = 1;
   if (numprocessors_ > 16)
     numprocessors_ = 16;
-  success_.resize(numprocessors_,true);
-  outputs_.resize(numprocessors_, nullptr);
+
+  tiles_.setup(num_seeds, seeds_per_tile);
+  buffers_.resize(numprocessors_);
+
   Parallel::RunTasks([this](int i) { parallel(i); }, numprocessors_);
-  for (size_t j=0; j<success_.size(); j++)
-  {
-    if (success_[j] == false) return false;
-    if (outputs_[j]  == nullptr) return false;
-  }
-  JoinFieldsAlgo JFalgo;
-  JFalgo.set(JoinFieldsAlgo::Tolerance,1e-8);
-  JFalgo.set(JoinFieldsAlgo::MergeNodes,false);
-  JFalgo.runImpl(outputs_, output);
+  if (failed_) return false;
+
+  // Seed values are taken from the vector field, as the cell walk always did
+  MergeStreamLines(buffers_, value_, field_, output);
 
   return true;
 }
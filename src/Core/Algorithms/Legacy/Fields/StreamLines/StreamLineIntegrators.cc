@@ -42,6 +42,11 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Algorithms::Fields;
 
+StreamLineIntegrators::StreamLineIntegrators() :
+  tolerance2_(0.0), step_size_(0.0), max_steps_(0), vfield_(0), elem_hint_(-1)
+{
+}
+
 /// interpolate using the generic linear interpolator
 bool
 StreamLineIntegrators::interpolate( const Point &p,
@@ -52,7 +57,15 @@ StreamLineIntegrators::interpolate( const Point &p,
   //  vfield_->interpolate(v, p);
   //  return (v.safe_normalize() > 0.0);
 
-  return vfield_->interpolate(v, p);
+  // Consecutive points of a streamline are close together, so the element
+  // of the previous point is tested first before searching the mesh.
+  VMesh::ElemInterpolate ei;
+  ei.elem_index = elem_hint_;
+  if (!vfield_->interpolate(v, p, Vector(0.0,0.0,0.0), ei))
+    return (false);
+
+  elem_hint_ = ei.elem_index;
+  return (true);
 }
 
 
@@ -35,6 +35,7 @@
 #ifndef CORE_ALGORITHMS_FIELDS_STREAMLINES_STREAMLINEINTEGRATORS_H
 #define CORE_ALGORITHMS_FIELDS_STREAMLINES_STREAMLINEINTEGRATORS_H 1
 
+#include <Core/Datatypes/Legacy/Base/Types.h>
 #include <Core/Datatypes/Legacy/Field/FieldFwd.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/Vector.h>
@@ -68,6 +69,8 @@ namespace SCIRun {
         class SCISHARE StreamLineIntegrators
         {
         public:
+          StreamLineIntegrators();
+
           void FindAdamsBashforth();
           void FindHeun();
           void FindRK4();
@@ -75,6 +78,10 @@ namespace SCIRun {
 
           void integrate(IntegrationMethod method);
 
+          // Interpolate the vector field at p, returns false outside the field.
+          // The element found is kept as the starting guess for the next call.
+          bool interpolate(const Geometry::Point &p, Geometry::Vector &v);
+
           //TODO: make private
           Geometry::Point seed_;                         // initial point
           double tolerance2_;                  // square error tolerance
@@ -89,7 +96,7 @@ namespace SCIRun {
             const Geometry::Point &p,    // previous point
             double s);        // current step size
 
-          bool interpolate(const Geometry::Point &p, Geometry::Vector &v);
+          index_type elem_hint_;                // element of the last interpolation
         };
 
       }
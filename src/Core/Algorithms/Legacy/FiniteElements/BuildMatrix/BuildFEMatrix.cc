@@ -111,6 +111,9 @@ private:
   VMesh* mesh_;
   VField *field_;
 
+  // Elements around every node, shared by all threads
+  VMesh::adjacency_type node_elems_;
+
   matrix_pointer_type<T> fematrix_;
 
   std::vector<bool> success_;
@@ -663,6 +666,7 @@ FEMBuilder<T>::setup()
       mesh_->synchronize(Mesh::EDGES_E|Mesh::NODE_NEIGHBORS_E);
     else
       mesh_->synchronize(Mesh::NODE_NEIGHBORS_E);
+    mesh_->get_elem_adjacency(node_elems_);
   }
   else
   {
@@ -720,6 +724,8 @@ FEMBuilder<T>::parallel(int proc_num)
   VMesh::Elem::array_type ca;
   VMesh::Node::array_type na;
   VMesh::Edge::array_type ea;
+  VMesh::array_type edge_elems;
+  VMesh::adjacency_type::Row elems(nullptr, nullptr);
   std::vector<index_type> neib_dofs;
 
   /// loop over system dofs for this thread
@@ -739,7 +745,7 @@ FEMBuilder<T>::parallel(int proc_num)
       if (i < global_dimension_nodes)
       {
         /// get neighboring cells for node
-        mesh_->get_elems(ca, i);
+        elems = node_elems_[i];
       }
       else if (i < global_dimension_nodes+global_dimension_add_nodes)
       {
@@ -747,6 +753,8 @@ FEMBuilder<T>::parallel(int proc_num)
         /// get neighboring cells for node
         VMesh::Edge::index_type ii(i-global_dimension_nodes);
         mesh_->get_elems(ca,ii);
+        edge_elems.assign(ca.begin(), ca.end());
+        elems = VMesh::adjacency_type::Row(edge_elems.data(), edge_elems.data() + edge_elems.size());
       }
       else
       {
@@ -755,10 +763,11 @@ FEMBuilder<T>::parallel(int proc_num)
         algo_->warning("BuildFEMatrix only supports linear basis functions.");
       }
 
-      for(size_t j = 0; j < ca.size(); j++)
+      for(size_t j = 0; j < elems.size(); j++)
       {
+        const VMesh::Elem::index_type elem(elems[j]);
         /// get neighboring nodes
-        mesh_->get_nodes(na, ca[j]);
+        mesh_->get_nodes(na, elem);
 
         for(size_t k = 0; k < na.size(); k++)
         {
@@ -769,7 +778,7 @@ FEMBuilder<T>::parallel(int proc_num)
         if (global_dimension_add_nodes)
         {
           /// get neighboring edges
-          mesh_->get_edges(ea, ca[j]);
+          mesh_->get_edges(ea, elem);
 
           for(size_t k = 0; k < ea.size(); k++)
             neib_dofs.push_back(global_dimension + ea[k]);
@@ -943,7 +952,7 @@ FEMBuilder<T>::parallel(int proc_num)
       {
         /// check for nodes
         /// get neighboring cells for node
-        mesh_->get_elems(ca,i);
+        elems = node_elems_[i];
       }
       else if (i < global_dimension_nodes + global_dimension_add_nodes)
       {
@@ -951,6 +960,8 @@ FEMBuilder<T>::parallel(int proc_num)
         /// get neighboring cells for additional nodes
         VMesh::Edge::index_type ii(i-global_dimension_nodes);
         mesh_->get_elems(ca,ii);
+        edge_elems.assign(ca.begin(), ca.end());
+        elems = VMesh::adjacency_type::Row(edge_elems.data(), edge_elems.data() + edge_elems.size());
       }
       else
       {
@@ -963,9 +974,10 @@ FEMBuilder<T>::parallel(int proc_num)
 
       if (mesh_->is_regularmesh())
       {
-        for (size_t j = 0; j < ca.size(); j++)
+        for (size_t j = 0; j < elems.size(); j++)
         {
-          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
+          const VMesh::Elem::index_type elem(elems[j]);
+          mesh_->get_nodes(na, elem); ///< get neighboring nodes
           neib_dofs.resize(na.size());
           for(size_t k = 0; k < na.size(); k++)
           {
@@ -976,7 +988,7 @@ FEMBuilder<T>::parallel(int proc_num)
           {
             if (na[k] == i)
             {
-              build_local_matrix_regular(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives,precompute);
+              build_local_matrix_regular(elem, k , lsml, ni_points, ni_weights, ni_derivatives,precompute);
               add_lcl_gbl(i, neib_dofs, lsml);
             }
           }
@@ -984,10 +996,11 @@ FEMBuilder<T>::parallel(int proc_num)
       }
       else
       {
-        for (size_t j = 0; j < ca.size(); j++)
+        for (size_t j = 0; j < elems.size(); j++)
         {
+          const VMesh::Elem::index_type elem(elems[j]);
           neib_dofs.clear();
-          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
+          mesh_->get_nodes(na, elem); ///< get neighboring nodes
           for(size_t k = 0; k < na.size(); k++)
           {
             neib_dofs.push_back(na[k]); // Must cast to (int) for SGI compiler :-(
@@ -995,7 +1008,7 @@ FEMBuilder<T>::parallel(int proc_num)
           /// check for additional nodes at edges
           if (global_dimension_add_nodes)
           {
-            mesh_->get_edges(ea, ca[j]); ///< get neighboring edges
+            mesh_->get_edges(ea, elem); ///< get neighboring edges
             for(size_t k = 0; k < ea.size(); k++)
             {
               neib_dofs.push_back(global_dimension + ea[k]);
@@ -1008,7 +1021,7 @@ FEMBuilder<T>::parallel(int proc_num)
           {
             if (na[k] == i)
             {
-              build_local_matrix(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives);
+              build_local_matrix(elem, k , lsml, ni_points, ni_weights, ni_derivatives);
               add_lcl_gbl(i, neib_dofs, lsml);
             }
           }
@@ -1019,7 +1032,7 @@ FEMBuilder<T>::parallel(int proc_num)
             {
               if (global_dimension + static_cast<int>(ea[k]) == i)
               {
-                build_local_matrix(ca[j], k+na.size(), lsml, ni_points, ni_weights, ni_derivatives);
+                build_local_matrix(elem, k+na.size(), lsml, ni_points, ni_weights, ni_derivatives);
                 add_lcl_gbl(i, neib_dofs, lsml);
               }
             }
@@ -55,11 +55,13 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
@@ -71,7 +73,7 @@ void BuildBEMatrixBase::getOmega(
   const Vector& y1,
   const Vector& y2,
   const Vector& y3,
-  DenseMatrix& coef)
+  VertexValues& coef)
 {
   /*
   This function deals with the analytical solutions of the various integrals in the stiffness matrix
@@ -90,31 +92,26 @@ void BuildBEMatrixBase::getOmega(
   Vector Ny( y1.length() , y2.length() , y3.length() );
 
   Vector Nyij( y21.length() , y32.length() , y13.length() );
-  
+
   Vector gamma( 0 , 0 , 0 );
   double NomGamma , DenomGamma;
 
   NomGamma = Ny[0]*Nyij[0] + Dot(y1,y21);
   DenomGamma = Ny[1]*Nyij[0] + Dot(y2,y21);
-  if (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0 ){
-    gamma[0] = -1/Nyij[0] * log(NomGamma/DenomGamma);
-  }
+  gamma[0] = (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0) ?
+    -1/Nyij[0] * log(NomGamma/DenomGamma) : 0.0;
   NomGamma = Ny[1]*Nyij[1] + Dot(y2,y32);
   DenomGamma = Ny[2]*Nyij[1] + Dot(y3,y32);
-  if (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0 ){
-    gamma[1] = -1/Nyij[1] * log(NomGamma/DenomGamma);
-  }
+  gamma[1] = (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0) ?
+    -1/Nyij[1] * log(NomGamma/DenomGamma) : 0.0;
   NomGamma = Ny[2]*Nyij[2] + Dot(y3,y13);
   DenomGamma = Ny[0]*Nyij[2] + Dot(y1,y13);
-  if (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0 ){
-    gamma[2] = -1/Nyij[2] * log(NomGamma/DenomGamma);
-  }
+  gamma[2] = (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0) ?
+    -1/Nyij[2] * log(NomGamma/DenomGamma) : 0.0;
 
   double d = Dot( y1, Cross(y2, y3) );
 
   Vector OmegaVec = (gamma[2]-gamma[0])*y1 + (gamma[0]-gamma[1])*y2 + (gamma[1]-gamma[2])*y3;
-  
-  
 
   /*
   In order to avoid problems with the arctan used in de Muncks paper
@@ -127,18 +124,12 @@ void BuildBEMatrixBase::getOmega(
   triangle. These cases are rare but existing.
   */
 
-  double Nn=0 , Omega=0 ;
-  Nn = Ny[0]*Ny[1]*Ny[2] + Ny[0]*Dot(y2,y3) + Ny[2]*Dot(y1,y2) + Ny[1]*Dot(y3,y1);
-  
-  if (Nn > 0)  Omega = 2 * atan( d / Nn );
-  if (Nn < 0)  Omega = 2 * atan( d / Nn ) + 2*M_PI ;
-  if (Nn == 0)
-  {
-    if ( d > 0 )
-      Omega = M_PI;
-    else
-      Omega = -M_PI;
-  }
+  double Nn = Ny[0]*Ny[1]*Ny[2] + Ny[0]*Dot(y2,y3) + Ny[2]*Dot(y1,y2) + Ny[1]*Dot(y3,y1);
+  double arc = 2 * atan( d / Nn );
+
+  double Omega = Nn > 0 ? arc :
+    Nn < 0 ? arc + 2*M_PI :
+    Nn == 0 ? ( d > 0 ? M_PI : -M_PI ) : 0.0;
 
   Vector N = Cross(y21, -y13);
   double Zn1 = Dot(Cross(y2, y3) , N);
@@ -146,10 +137,9 @@ void BuildBEMatrixBase::getOmega(
   double Zn3 = Dot(Cross(y1, y2) , N);
 
   double A2 = N.length2();
-  coef(0,0) = (1/A2) * ( Zn1*Omega + d * Dot(y32, OmegaVec) );
-  coef(0,1) = (1/A2) * ( Zn2*Omega + d * Dot(y13, OmegaVec) );
-  coef(0,2) = (1/A2) * ( Zn3*Omega + d * Dot(y21, OmegaVec) );
-  
+  coef(0) = (1/A2) * ( Zn1*Omega + d * Dot(y32, OmegaVec) );
+  coef(1) = (1/A2) * ( Zn2*Omega + d * Dot(y13, OmegaVec) );
+  coef(2) = (1/A2) * ( Zn3*Omega + d * Dot(y21, OmegaVec) );
 }
 
 void  BuildBEMatrixBase::get_cruse_weights(
@@ -159,7 +149,7 @@ void  BuildBEMatrixBase::get_cruse_weights(
   double s,
   double r,
   double area,
-  DenseMatrix& cruse_weights)
+  CruseWeights& cruse_weights)
 {
   /*
   Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ;
@@ -191,48 +181,45 @@ void  BuildBEMatrixBase::get_cruse_weights(
   Vector locp2(fg3_length , 0 , 0);
   Vector locp3(fg2_length * cos_alpha , fg2_length * sin_alpha , 0);
 
-  DenseMatrix Fx(3, 1);
+  VertexValues Fx;
   Fx << locp3[0] - locp2[0],
     locp1[0] - locp3[0],
     locp2[0] - locp1[0];
 
-  DenseMatrix Fy(3, 1);
+  VertexValues Fy;
   Fy << locp3[1] - locp2[1],
     locp1[1] - locp3[1],
     locp2[1] - locp1[1];
 
   Vector centroid = (locp1 + locp2 + locp3) / 3;
-  DenseMatrix loc_radpt_x(1, 7);
-  DenseMatrix loc_radpt_y(1, 7);
-  loc_radpt_x(0,0) = centroid[0];
-  loc_radpt_y(0,0) = centroid[1];
+  RadonPointValues loc_radpt_x;
+  RadonPointValues loc_radpt_y;
+  loc_radpt_x(0) = centroid[0];
+  loc_radpt_y(0) = centroid[1];
   Vector temp = (1-s) * centroid;
-  loc_radpt_x(0,1) = temp[0] + locp1[0]*s;
-  loc_radpt_y(0,1) = temp[1] + locp1[1]*s;
-  loc_radpt_x(0,2) = temp[0] + locp2[0]*s;
-  loc_radpt_y(0,2) = temp[1] + locp2[1]*s;
-  loc_radpt_x(0,3) = temp[0] + locp3[0]*s;
-  loc_radpt_y(0,3) = temp[1] + locp3[1]*s;
+  loc_radpt_x(1) = temp[0] + locp1[0]*s;
+  loc_radpt_y(1) = temp[1] + locp1[1]*s;
+  loc_radpt_x(2) = temp[0] + locp2[0]*s;
+  loc_radpt_y(2) = temp[1] + locp2[1]*s;
+  loc_radpt_x(3) = temp[0] + locp3[0]*s;
+  loc_radpt_y(3) = temp[1] + locp3[1]*s;
   temp = (1-r) * centroid;
-  loc_radpt_x(0,4) = temp[0] + locp1[0]*r;
-  loc_radpt_y(0,4) = temp[1] + locp1[1]*r;
-  loc_radpt_x(0,5) = temp[0] + locp2[0]*r;
-  loc_radpt_y(0,5) = temp[1] + locp2[1]*r;
-  loc_radpt_x(0,6) = temp[0] + locp3[0]*r;
-  loc_radpt_y(0,6) = temp[1] + locp3[1]*r;
-
-  auto A = (0.5/area) * (Fy * loc_radpt_x - Fx * loc_radpt_y);
+  loc_radpt_x(4) = temp[0] + locp1[0]*r;
+  loc_radpt_y(4) = temp[1] + locp1[1]*r;
+  loc_radpt_x(5) = temp[0] + locp2[0]*r;
+  loc_radpt_y(5) = temp[1] + locp2[1]*r;
+  loc_radpt_x(6) = temp[0] + locp3[0]*r;
+  loc_radpt_y(6) = temp[1] + locp3[1]*r;
 
-  DenseMatrix ones(1, 7, 1.0);
-  DenseMatrix E(3, 1);
   /*
   E is a 1X3 matrix: [1st vertex  ;  2nd vertex  ;  3rd vertex]
   E = [1/3 ; 1/3 ; 1/3] + (0.5/area)*(Fy*xmid - Fx*ymid);
   but there is no need to compute the E because by our choice of the
   local coordinates, it is easy to show that the E is always [1 ; 0 ; 0]!
+  So the weights are E * ones(1,7) - A.
   */
-  E << 1,0,0;
-  cruse_weights = (E * ones) - A;
+  cruse_weights = -(0.5/area) * (Fy * loc_radpt_x - Fx * loc_radpt_y);
+  cruse_weights.row(0).array() += 1.0;
 }
 
 void BuildBEMatrixBase::get_g_coef(
@@ -243,28 +230,28 @@ void BuildBEMatrixBase::get_g_coef(
   double s,
   double r,
   const Vector& centroid,
-  DenseMatrix& g_coef)
+  RadonPointValues& g_coef)
 {
   // Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ; op= Observation Point
   // Output: g_coef = G Values (Coefficients) at 7 Radon's points = 1/r
   Vector radpt = centroid - op;
-  g_coef(0,0) = 1 / radpt.length();
+  g_coef(0) = 1 / radpt.length();
 
   Vector temp = centroid * (1-s) - op;
   radpt = temp + p1 * s;
-  g_coef(0,1) = 1 / radpt.length();
+  g_coef(1) = 1 / radpt.length();
   radpt = temp + p2 * s;
-  g_coef(0,2) = 1 / radpt.length();
+  g_coef(2) = 1 / radpt.length();
   radpt = temp + p3 * s;
-  g_coef(0,3) = 1 / radpt.length();
+  g_coef(3) = 1 / radpt.length();
 
   temp = centroid * (1-r) - op;
   radpt = temp + p1 * r;
-  g_coef(0,4) = 1 / radpt.length();
+  g_coef(4) = 1 / radpt.length();
   radpt = temp + p2 * r;
-  g_coef(0,5) = 1 / radpt.length();
+  g_coef(5) = 1 / radpt.length();
   radpt = temp + p3 * r;
-  g_coef(0,6) = 1 / radpt.length();
+  g_coef(6) = 1 / radpt.length();
 }
 
 void BuildBEMatrixBase::bem_sing(
@@ -272,17 +259,17 @@ void BuildBEMatrixBase::bem_sing(
   const Vector& p2,
   const Vector& p3,
   unsigned int op_n,
-  DenseMatrix& g_values,
+  VertexValues& g_values,
   double s,
   double r,
-  DenseMatrix& R_W)
+  const RadonPointValues& R_W)
 {
   /*
   This is Jeroen's method, converted from his Matlab code, for dealing with weightings corresponding to singular triangles
   */
   Vector A,B,C,P,BC,BA,AC,AP;
-  DenseMatrix WAPB(3,1);
-  DenseMatrix WAPC(3,1);
+  VertexValues WAPB;
+  VertexValues WAPC;
   int one=0,two=1,three=2;
 
   switch(op_n)
@@ -318,44 +305,44 @@ void BuildBEMatrixBase::bem_sing(
   {
     a=lAP; b=lBP; c=lAB;
     log_term=log( (b+c)/a );
-    WAPB(0,0)=a/2 * log_term;
+    WAPB(0)=a/2 * log_term;
     w=1-RL;
-    WAPB(1,0)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
+    WAPB(1)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
     w=RL;
-    WAPB(2,0)=a*w *( a-c  +  b*log_term )/(2*b);
+    WAPB(2)=a*w *( a-c  +  b*log_term )/(2*b);
   }
   else
   {
-    WAPB(0,0)=0; WAPB(1,0)=0; WAPB(2,0)=0;
+    WAPB.setZero();
   }
 
   if(fabs(RL-1) > 0)
   {
     a = lAP; b = lCP; c = lAC;
     log_term = log( (b+c)/a );
-    WAPC(0,0)=a/2 * log_term;
+    WAPC(0)=a/2 * log_term;
     w = 1-RL;
-    WAPC(1,0)=a*w *( a-c  +  b*log_term )/(2*b);
+    WAPC(1)=a*w *( a-c  +  b*log_term )/(2*b);
     w = RL;
-    WAPC(2,0)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
+    WAPC(2)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
   }
   else
   {
-    WAPC(0,0)=0; WAPC(1,0)=0; WAPC(2,0)=0;
+    WAPC.setZero();
   }
 
   if(RL<0)
   {
-    WAPB(0,0)*=-1.0; WAPB(1,0)*=-1.0; WAPB(2,0)*=-1.0;
+    WAPB *= -1.0;
   }
   if(RL>1)
   {
-    WAPC(0,0)*=-1.0; WAPC(1,0)*=-1.0; WAPC(2,0)*=-1.0;
+    WAPC *= -1.0;
   }
 
-  g_values(one,0) = WAPB(0,0) + WAPC(0,0);
-  g_values(two,0) = WAPB(1,0) + WAPC(1,0);
-  g_values(three,0) = WAPB(2,0) + WAPC(2,0);
+  g_values(one) = WAPB(0) + WAPC(0);
+  g_values(two) = WAPB(1) + WAPC(1);
+  g_values(three) = WAPB(2) + WAPC(2);
 }
 
 void BuildBEMatrixBase::get_auto_g(
@@ -363,10 +350,10 @@ void BuildBEMatrixBase::get_auto_g(
   const Vector& p2,
   const Vector& p3,
   unsigned int op_n,
-  DenseMatrix& g_values,
+  VertexValues& g_values,
   double s,
   double r,
-  DenseMatrix& R_W)
+  const RadonPointValues& R_W)
 {
   /*
   A routine to solve the Auto G-parameter integral for a triangle from
@@ -396,21 +383,21 @@ void BuildBEMatrixBase::get_auto_g(
   {
   case 0:
     op = p1;
-    g_values(0,0) = get_new_auto_g(op, p5, p4) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
-    g_values(1,0) = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
-    g_values(2,0) = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
+    g_values(0) = get_new_auto_g(op, p5, p4) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
+    g_values(1) = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
+    g_values(2) = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
     break;
   case 1:
     op = p2;
-    g_values(0,0) = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
-    g_values(1,0) = get_new_auto_g(op, p6, p5) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
-    g_values(2,0) = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
+    g_values(0) = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
+    g_values(1) = get_new_auto_g(op, p6, p5) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
+    g_values(2) = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
     break;
   case 2:
     op = p3;
-    g_values(0,0) = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
-    g_values(1,0) = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
-    g_values(2,0) = get_new_auto_g(op, p4, p6) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
+    g_values(0) = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
+    g_values(1) = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
+    g_values(2) = get_new_auto_g(op, p4, p6) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
     break;
   }
 }
@@ -476,7 +463,7 @@ double BuildBEMatrixBase::do_radon_g(
   const Vector& op,
   double s,
   double r,
-  DenseMatrix& R_W)
+  const RadonPointValues& R_W)
 {
   //  Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ; op= Observation Point
   //  Output: g2 = G value for the triangle for "auto_g"
@@ -484,11 +471,11 @@ double BuildBEMatrixBase::do_radon_g(
 
   Vector centroid = (p1 + p2 + p3) / 3;
 
-  DenseMatrix g_coef(1, 7);
+  RadonPointValues g_coef;
   get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
 
   double g2 = 0;
-  for (int i=0; i<7; i++)   g2 = g2 + g_coef(0,i)*R_W(0,i);
+  for (int i=0; i<7; i++)   g2 = g2 + g_coef(i)*R_W(i);
 
   Vector aV = Cross(p2 - p1, p3 - p2)*0.5;
 
@@ -515,8 +502,354 @@ public:
   double,
   double,
   const std::vector<double>& );
+
+private:
+  /// Node positions and triangles copied out of a VMesh, so the threads below read
+  /// plain arrays instead of sharing virtual mesh calls.
+  struct SurfaceArrays
+  {
+    explicit SurfaceArrays(VMesh* mesh);
+    size_t numFaces() const { return faceNodes.size() / 3; }
+    const Vector& vertex(size_t face, int corner) const { return points[faceNodes[3*face + corner]]; }
+
+    std::vector<Vector> points;
+    std::vector<VMesh::index_type> faceNodes;
+
+    /// The same corners one array per coordinate, corners[corner][axis], and the terms of
+    /// getOmega that depend only on the face, for the solid angle kernel.
+    std::vector<double> corners[3][3];
+    std::vector<double> edgeLength[3], negInvEdgeLength[3];
+    std::vector<double> normal[3];
+    std::vector<double> invNormalLength2;
+  };
+
+  /// Scratch arrays of getOmegaBlock, one entry per face of a block. Vectors are stored
+  /// one array per axis: y[corner][axis], with the corners relative to the observation point.
+  struct OmegaBlock
+  {
+    OmegaBlock();
+    Eigen::ArrayXd y[3][3], edge[3][3], cross[3][3];
+    Eigen::ArrayXd length[3], gamma[3], denom[3], d, omega, coef[3];
+  };
+
+  /// Weights and abscissae of the 7-point Radon quadrature.
+  struct RadonRule
+  {
+    RadonRule();
+    double s, r;
+    RadonPointValues weights;
+  };
+
+  /// Faces are visited in blocks of this size so a block's data stays in cache
+  /// while every observation node of a chunk is processed against it.
+  static const size_t faceBlockSize = 256;
+
+  /// getOmega for the faces [first, last) of surface seen from pp; face f's coefficients go
+  /// to out.coef[i](f - offset). The arithmetic is done with Eigen array expressions over
+  /// the whole range, so it runs on SIMD registers; only log and atan are called per face.
+  static void getOmegaBlock(const SurfaceArrays& surface, size_t first, size_t last, const Vector& pp, OmegaBlock& out, size_t offset);
+
+  template <class MatrixType>
+  static void assemble_P(const SurfaceArrays& observers, const SurfaceArrays& surface, bool sameSurface, MatrixType& P, double mult);
+
+  template <class MatrixType>
+  static void assemble_G(const SurfaceArrays& observers, const SurfaceArrays& surface, bool sameSurface, MatrixType& G, double mult, const std::vector<double>& avInn);
 };
 
+BuildBEMatrixBaseCompute::SurfaceArrays::SurfaceArrays(VMesh* mesh)
+{
+  VMesh::Node::size_type nsize;
+  mesh->size(nsize);
+  points.reserve(nsize);
+
+  VMesh::Node::iterator ni, nie;
+  mesh->begin(ni); mesh->end(nie);
+  for (; ni != nie; ++ni)
+    points.push_back(Vector(mesh->get_point(*ni)));
+
+  VMesh::Face::size_type fsize;
+  mesh->size(fsize);
+  faceNodes.reserve(3*fsize);
+
+  VMesh::Node::array_type nodes;
+  VMesh::Face::iterator fi, fie;
+  mesh->begin(fi); mesh->end(fie);
+  for (; fi != fie; ++fi)
+  {
+    mesh->get_nodes(nodes, *fi);
+    for (int i=0; i<3; ++i)
+      faceNodes.push_back(nodes[i]);
+  }
+
+  const size_t nfaces = numFaces();
+  for (int i=0; i<3; ++i)
+  {
+    for (int axis=0; axis<3; ++axis)
+      corners[i][axis].resize(nfaces);
+    edgeLength[i].resize(nfaces);
+    negInvEdgeLength[i].resize(nfaces);
+    normal[i].resize(nfaces);
+  }
+  invNormalLength2.resize(nfaces);
+
+  for (size_t f = 0; f < nfaces; ++f)
+  {
+    for (int c=0; c<3; ++c)
+    {
+      for (int axis=0; axis<3; ++axis)
+        corners[c][axis][f] = vertex(f, c)[axis];
+    }
+    // edges in getOmega's order: y21, y32, y13
+    const Vector y21 = vertex(f, 1) - vertex(f, 0);
+    const Vector y32 = vertex(f, 2) - vertex(f, 1);
+    const Vector y13 = vertex(f, 0) - vertex(f, 2);
+    const Vector edges[3] = { y21, y32, y13 };
+    for (int e=0; e<3; ++e)
+    {
+      edgeLength[e][f] = edges[e].length();
+      negInvEdgeLength[e][f] = -1/edgeLength[e][f];
+    }
+    const Vector N = Cross(y21, -y13);
+    for (int axis=0; axis<3; ++axis)
+      normal[axis][f] = N[axis];
+    invNormalLength2[f] = 1/N.length2();
+  }
+}
+
+BuildBEMatrixBaseCompute::OmegaBlock::OmegaBlock() :
+  d(faceBlockSize), omega(faceBlockSize)
+{
+  for (int i=0; i<3; ++i)
+  {
+    for (int axis=0; axis<3; ++axis)
+    {
+      y[i][axis].resize(faceBlockSize);
+      edge[i][axis].resize(faceBlockSize);
+      cross[i][axis].resize(faceBlockSize);
+    }
+    length[i].resize(faceBlockSize);
+    gamma[i].resize(faceBlockSize);
+    denom[i].resize(faceBlockSize);
+    coef[i].resize(faceBlockSize);
+  }
+}
+
+void BuildBEMatrixBaseCompute::getOmegaBlock(const SurfaceArrays& surface, size_t first, size_t last,
+  const Vector& pp, OmegaBlock& out, size_t offset)
+{
+  // The formulas of getOmega, evaluated in the same order for a range of faces.
+  if (last <= first)
+    return;
+  typedef Eigen::Map<const Eigen::ArrayXd> FaceArray;
+  const Eigen::Index n = last - first, o = first - offset;
+  const auto faces = [&](const std::vector<double>& values) { return FaceArray(&values[first], n); };
+  const auto seg = [&](Eigen::ArrayXd& values) { return values.segment(o, n); };
+
+  auto& y = out.y;
+  auto& edge = out.edge;
+  auto& cross = out.cross;
+  for (int c=0; c<3; ++c)
+  {
+    for (int axis=0; axis<3; ++axis)
+      seg(y[c][axis]) = faces(surface.corners[c][axis]) - pp[axis];
+  }
+  // y21, y32, y13
+  for (int e=0; e<3; ++e)
+  {
+    for (int axis=0; axis<3; ++axis)
+      seg(edge[e][axis]) = seg(y[(e+1)%3][axis]) - seg(y[e][axis]);
+  }
+  // y2 x y3, y3 x y1, y1 x y2
+  for (int k=0; k<3; ++k)
+  {
+    auto& u = y[(k+1)%3];
+    auto& v = y[(k+2)%3];
+    seg(cross[k][0]) = seg(u[1])*seg(v[2]) - seg(u[2])*seg(v[1]);
+    seg(cross[k][1]) = seg(u[2])*seg(v[0]) - seg(u[0])*seg(v[2]);
+    seg(cross[k][2]) = seg(u[0])*seg(v[1]) - seg(u[1])*seg(v[0]);
+  }
+  for (int c=0; c<3; ++c)
+    seg(out.length[c]) = (seg(y[c][0]).square() + seg(y[c][1]).square() + seg(y[c][2]).square()).sqrt();
+
+  // Edge e runs from corner e to corner e+1: NomGamma and DenomGamma of getOmega
+  for (int e=0; e<3; ++e)
+  {
+    auto& from = y[e];
+    auto& to = y[(e+1)%3];
+    auto& yij = edge[e];
+    seg(out.gamma[e]) = seg(out.length[e])*faces(surface.edgeLength[e])
+      + (seg(from[0])*seg(yij[0]) + seg(from[1])*seg(yij[1]) + seg(from[2])*seg(yij[2]));
+    seg(out.denom[e]) = seg(out.length[(e+1)%3])*faces(surface.edgeLength[e])
+      + (seg(to[0])*seg(yij[0]) + seg(to[1])*seg(yij[1]) + seg(to[2])*seg(yij[2]));
+  }
+
+  seg(out.d) = seg(y[0][0])*seg(cross[0][0]) + seg(y[0][1])*seg(cross[0][1]) + seg(y[0][2])*seg(cross[0][2]);
+  auto Ny = [&](int c) { return seg(out.length[c]); };
+  auto dot = [&](int a, int b) { return seg(y[a][0])*seg(y[b][0]) + seg(y[a][1])*seg(y[b][1]) + seg(y[a][2])*seg(y[b][2]); };
+  seg(out.omega) = Ny(0)*Ny(1)*Ny(2) + Ny(0)*dot(1,2) + Ny(2)*dot(0,1) + Ny(1)*dot(2,0);
+
+  // log and atan have no SIMD version here; see getOmega for the 2*pi correction
+  const double epsilon  = 1e-12;
+  for (Eigen::Index i = o; i < o + n; ++i)
+  {
+    const size_t f = first + (i - o);
+    for (int e=0; e<3; ++e)
+    {
+      const double NomGamma = out.gamma[e](i), DenomGamma = out.denom[e](i);
+      out.gamma[e](i) = (fabs(DenomGamma-NomGamma) > epsilon && (DenomGamma != 0) && NomGamma != 0) ?
+        surface.negInvEdgeLength[e][f] * log(NomGamma/DenomGamma) : 0.0;
+    }
+    const double d = out.d(i), Nn = out.omega(i);
+    const double arc = 2 * atan( d / Nn );
+    out.omega(i) = Nn > 0 ? arc :
+      Nn < 0 ? arc + 2*M_PI :
+      Nn == 0 ? ( d > 0 ? M_PI : -M_PI ) : 0.0;
+  }
+
+  // Zn1..Zn3 go to the denominator arrays, and OmegaVec =
+  // (gamma[2]-gamma[0])*y1 + (gamma[0]-gamma[1])*y2 + (gamma[1]-gamma[2])*y3 to cross[0]
+  auto g = [&](int e) { return seg(out.gamma[e]); };
+  auto& Zn = out.denom;
+  for (int k=0; k<3; ++k)
+    seg(Zn[k]) = seg(cross[k][0])*faces(surface.normal[0]) + seg(cross[k][1])*faces(surface.normal[1]) + seg(cross[k][2])*faces(surface.normal[2]);
+  auto& omegaVec = cross[0];
+  for (int axis=0; axis<3; ++axis)
+    seg(omegaVec[axis]) = (g(2)-g(0))*seg(y[0][axis]) + (g(0)-g(1))*seg(y[1][axis]) + (g(1)-g(2))*seg(y[2][axis]);
+
+  // coef(0) pairs with y32, coef(1) with y13 and coef(2) with y21
+  for (int i=0; i<3; ++i)
+  {
+    auto& yij = edge[(i+1)%3];
+    seg(out.coef[i]) = faces(surface.invNormalLength2) * ( seg(Zn[i])*seg(out.omega)
+      + seg(out.d) * (seg(yij[0])*seg(omegaVec[0]) + seg(yij[1])*seg(omegaVec[1]) + seg(yij[2])*seg(omegaVec[2])) );
+  }
+}
+
+BuildBEMatrixBaseCompute::RadonRule::RadonRule()
+{
+  double sqrt15 = sqrt(15.0);
+  weights(0) = 9.0/40.0;
+  weights(1) = (155 + sqrt15) / 1200;
+  weights(2) = weights(1);
+  weights(3) = weights(1);
+  weights(4) = (155 - sqrt15) / 1200;
+  weights(5) = weights(4);
+  weights(6) = weights(4);
+
+  s = (1 - sqrt15) / 7;
+  r = (1 + sqrt15) / 7;
+}
+
+template <class MatrixType>
+void BuildBEMatrixBaseCompute::assemble_G(const SurfaceArrays& observers, const SurfaceArrays& surface, bool sameSurface,
+  MatrixType& G, double mult, const std::vector<double>& avInn)
+{
+  const RadonRule radon;
+  const size_t nfaces = surface.numFaces();
+
+  std::vector<CruseWeights> cruse_weights(nfaces);
+  std::vector<Vector> centroids(nfaces);
+  Parallel::For(0, nfaces, [&](size_t first, size_t last)
+  {
+    for (size_t f = first; f < last; ++f)
+    {
+      const Vector& p1 = surface.vertex(f, 0);
+      const Vector& p2 = surface.vertex(f, 1);
+      const Vector& p3 = surface.vertex(f, 2);
+      get_cruse_weights(p1, p2, p3, radon.s, radon.r, avInn[f], cruse_weights[f]);
+      centroids[f] = (p1 + p2 + p3) / 3.0;
+    }
+  });
+
+  //! Each chunk owns a band of rows, so threads never write the same entry, and
+  //! every entry still accumulates its faces in mesh order.
+  Parallel::For(0, observers.points.size(), [&](size_t firstNode, size_t lastNode)
+  {
+    RadonPointValues g_coef;
+    VertexValues g_values;
+
+    for (size_t blockStart = 0; blockStart < nfaces; blockStart += faceBlockSize)
+    {
+      const size_t blockEnd = std::min(nfaces, blockStart + faceBlockSize);
+      for (size_t ppi = firstNode; ppi < lastNode; ++ppi)
+      { //! for every node
+        const Vector& op = observers.points[ppi];
+        for (size_t f = blockStart; f < blockEnd; ++f)
+        { //! find contributions from every triangle
+          const VMesh::index_type* nodes = &surface.faceNodes[3*f];
+          const Vector& p1 = surface.vertex(f, 0);
+          const Vector& p2 = surface.vertex(f, 1);
+          const Vector& p3 = surface.vertex(f, 2);
+
+          if (sameSurface && ppi == static_cast<size_t>(nodes[0]))       bem_sing(p1, p2, p3, 0, g_values, radon.s, radon.r, radon.weights);
+          else if (sameSurface && ppi == static_cast<size_t>(nodes[1]))  bem_sing(p1, p2, p3, 1, g_values, radon.s, radon.r, radon.weights);
+          else if (sameSurface && ppi == static_cast<size_t>(nodes[2]))  bem_sing(p1, p2, p3, 2, g_values, radon.s, radon.r, radon.weights);
+          else
+          {
+            get_g_coef(p1, p2, p3, op, radon.s, radon.r, centroids[f], g_coef);
+            g_values = avInn[f] * (cruse_weights[f] * g_coef.cwiseProduct(radon.weights).transpose());
+          }
+
+          for (int i=0; i<3; ++i)
+            G(ppi, nodes[i]) += g_values(i)*mult;
+        }
+      }
+    }
+  });
+}
+
+template <class MatrixType>
+void BuildBEMatrixBaseCompute::assemble_P(const SurfaceArrays& observers, const SurfaceArrays& surface, bool sameSurface,
+  MatrixType& P, double mult)
+{
+  const size_t nfaces = surface.numFaces();
+
+  //! Row bands as in assemble_G. The solid angles of a face block are computed into
+  //! contiguous buffers first and scattered into the row afterwards, which keeps the
+  //! kernel loop free of indirect stores.
+  Parallel::For(0, observers.points.size(), [&](size_t firstNode, size_t lastNode)
+  {
+    OmegaBlock omega;
+
+    for (size_t blockStart = 0; blockStart < nfaces; blockStart += faceBlockSize)
+    {
+      const size_t blockEnd = std::min(nfaces, blockStart + faceBlockSize);
+      for (size_t ppi = firstNode; ppi < lastNode; ++ppi)
+      { //! for every node
+        //! faces that have the node as a corner contribute nothing, so the kernel runs
+        //! on the stretches of the block between them
+        auto singular = [&](size_t f)
+        {
+          const VMesh::index_type* nodes = &surface.faceNodes[3*f];
+          return sameSurface && (ppi == static_cast<size_t>(nodes[0]) || ppi == static_cast<size_t>(nodes[1]) || ppi == static_cast<size_t>(nodes[2]));
+        };
+
+        const Vector& pp = observers.points[ppi];
+        size_t runStart = blockStart;
+        for (size_t f = blockStart; f < blockEnd; ++f)
+        {
+          if (singular(f))
+          {
+            getOmegaBlock(surface, runStart, f, pp, omega, blockStart);
+            runStart = f + 1;
+          }
+        }
+        getOmegaBlock(surface, runStart, blockEnd, pp, omega, blockStart);
+
+        for (size_t f = blockStart; f < blockEnd; ++f)
+        { //! find contributions from every triangle
+          if (singular(f))
+            continue;
+
+          const VMesh::index_type* nodes = &surface.faceNodes[3*f];
+          for (int i=0; i<3; ++i)
+            P(ppi, nodes[i]) -= omega.coef[i](f - blockStart)*mult;
+        }
+      }
+    }
+  });
+}
+
 void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
 {
   auto nnodes = numNodes(hsurf);
@@ -537,66 +870,8 @@ void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& aut
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values, s, r, R_W);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values, s, r, R_W);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values, s, r, R_W);
-      else
-      {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
-
-      for (int i=0; i<3; ++i)
-        auto_G(ppi, nodes[i])+=g_values(i,0)*mult;
-    }
-  }
+  const SurfaceArrays surface(hsurf);
+  assemble_G(surface, surface, true, auto_G, mult, avInn);
 }
 
 void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
@@ -618,60 +893,9 @@ void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-      g_values = area * (cruse_weights * temp.transpose());
-
-      for (int i=0; i<3; ++i)
-        cross_G(ppi, nodes[i])+=g_values(i,0)*mult;
-    }
-  }
+  const SurfaceArrays observers(hsurf1);
+  const SurfaceArrays surface(hsurf2);
+  assemble_G(observers, surface, false, cross_G, mult, avInn);
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -691,32 +915,10 @@ void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
 
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
-
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
-
-      getOmega(v1, v2, v3, coef);
-
-      for (i=0; i<3; ++i)
-        cross_P(ppi, nodes[i])-=coef(0,i)*mult;
-    }
-  }
+  const SurfaceArrays observers(hsurf1);
+  const SurfaceArrays surface(hsurf2);
+  assemble_P(observers, surface, false, cross_P, mult);
 }
 
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
@@ -741,47 +943,16 @@ template <class MatrixType>
 void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond)
 {
   auto nnodes = auto_P.rows();
-  
-  
 
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-
-  unsigned int i;
-
-  hsurf->begin(ni); hsurf->end(nie);
-
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
-
-    hsurf->begin(fi); hsurf->end(fie);
-    
-    for (; fi != fie; ++fi) { //! find contributions from every triangle
-
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2]){
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
-        
-        getOmega(v1, v2, v3, coef);
-
-        for (i=0; i<3; ++i)
-          auto_P(ppi, nodes[i])-=coef(0,i)*mult;
-      }
-    }
-  }
+  const SurfaceArrays surface(hsurf);
+  assemble_P(surface, surface, true, auto_P, mult);
 
   //! accounting for autosolid angle
   auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
+  for (int i=0; i<nnodes; ++i)
   {
     auto_P(i,i) = out_cond - sumOfRows(i);
   }
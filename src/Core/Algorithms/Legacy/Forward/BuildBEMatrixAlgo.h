@@ -43,6 +43,7 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/GeomFwd.h>
 #include <Core/Datatypes/Legacy/Field/FieldFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Eigen/Core>
 #include <Core/Algorithms/Legacy/Forward/share.h>
 
 namespace SCIRun {
@@ -61,6 +62,11 @@ namespace SCIRun {
         class SCISHARE BuildBEMatrixBase
         {
         protected:
+          /// Fixed-size storage for the 7-point Radon quadrature, so the assembly loops never allocate.
+          typedef Eigen::Matrix<double, 1, 7> RadonPointValues;
+          typedef Eigen::Matrix<double, 3, 7> CruseWeights;
+          typedef Eigen::Matrix<double, 3, 1> VertexValues;
+
           static void get_g_coef( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
@@ -68,7 +74,7 @@ namespace SCIRun {
             double,
             double,
             const Geometry::Vector&,
-            Datatypes::DenseMatrix&);
+            RadonPointValues&);
 
           static void get_cruse_weights( const Geometry::Vector&,
             const Geometry::Vector&,
@@ -76,12 +82,12 @@ namespace SCIRun {
             double,
             double,
             double,
-            Datatypes::DenseMatrix& );
+            CruseWeights& );
 
           static void getOmega( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
-            Datatypes::DenseMatrix& );
+            VertexValues& );
 
           static double do_radon_g( const Geometry::Vector&,
             const Geometry::Vector&,
@@ -89,25 +95,25 @@ namespace SCIRun {
             const Geometry::Vector&,
             double,
             double,
-            Datatypes::DenseMatrix& );
+            const RadonPointValues& );
 
           static void get_auto_g( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
             unsigned int,
-            Datatypes::DenseMatrix&,
+            VertexValues&,
             double,
             double,
-            Datatypes::DenseMatrix& );
+            const RadonPointValues& );
 
           static void bem_sing( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
             unsigned int,
-            Datatypes::DenseMatrix&,
+            VertexValues&,
             double,
             double,
-            Datatypes::DenseMatrix& );
+            const RadonPointValues& );
 
           static double get_new_auto_g( const Geometry::Vector&,
             const Geometry::Vector&,
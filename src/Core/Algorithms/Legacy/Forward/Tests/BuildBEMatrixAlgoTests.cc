@@ -0,0 +1,229 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Parallel.h>
+#include <map>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Forward;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  // octahedron refined levels times, with every node pushed out onto the sphere
+  FieldHandle makeSphere(double radius, int levels)
+  {
+    std::vector<Vector> points = { Vector(1,0,0), Vector(-1,0,0), Vector(0,1,0), Vector(0,-1,0), Vector(0,0,1), Vector(0,0,-1) };
+    std::vector<int> faces = { 0,2,4, 2,1,4, 1,3,4, 3,0,4, 2,0,5, 1,2,5, 3,1,5, 0,3,5 };
+
+    for (int level = 0; level < levels; ++level)
+    {
+      std::map<std::pair<int, int>, int> midpoints;
+      auto midpoint = [&](int a, int b)
+      {
+        auto key = std::make_pair(std::min(a, b), std::max(a, b));
+        auto found = midpoints.find(key);
+        if (found != midpoints.end())
+          return found->second;
+        points.push_back(0.5 * (points[a] + points[b]));
+        return midpoints[key] = static_cast<int>(points.size()) - 1;
+      };
+
+      std::vector<int> refined;
+      for (size_t f = 0; f < faces.size(); f += 3)
+      {
+        int a = faces[f], b = faces[f+1], c = faces[f+2];
+        int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+        refined.insert(refined.end(), { a,ab,ca, ab,b,bc, ca,bc,c, ab,bc,ca });
+      }
+      faces.swap(refined);
+    }
+
+    FieldInformation fi("TriSurfMesh", LINEARDATA_E, "double");
+    auto field = CreateField(fi);
+    auto mesh = field->vmesh();
+    for (auto& p : points)
+    {
+      p.normalize();
+      mesh->add_point(Point(radius * p));
+    }
+    VMesh::Node::array_type nodes(3);
+    for (size_t f = 0; f < faces.size(); f += 3)
+    {
+      for (int i = 0; i < 3; ++i)
+        nodes[i] = faces[f+i];
+      mesh->add_elem(nodes);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // The assembly as it was before it ran in parallel: faces in the outer loop,
+  // nodes in the inner one, and every point read through the VMesh.
+  class SerialAssembly : public BuildBEMatrixBase
+  {
+  public:
+    static DenseMatrix G(VMesh* observers, VMesh* surface, bool sameSurface, double mult, const std::vector<double>& areas)
+    {
+      const double sqrt15 = sqrt(15.0);
+      const double s = (1 - sqrt15) / 7;
+      const double r = (1 + sqrt15) / 7;
+      RadonPointValues weights;
+      weights << 9.0/40.0, (155 + sqrt15) / 1200, (155 + sqrt15) / 1200, (155 + sqrt15) / 1200,
+        (155 - sqrt15) / 1200, (155 - sqrt15) / 1200, (155 - sqrt15) / 1200;
+
+      DenseMatrix result(numNodes(observers), numNodes(surface), 0.0);
+      CruseWeights cruse;
+      RadonPointValues g_coef;
+      VertexValues g_values;
+      VMesh::Node::array_type nodes;
+      VMesh::Face::iterator fi, fie;
+      surface->begin(fi); surface->end(fie);
+      for (; fi != fie; ++fi)
+      {
+        surface->get_nodes(nodes, *fi);
+        Vector p1(surface->get_point(nodes[0]));
+        Vector p2(surface->get_point(nodes[1]));
+        Vector p3(surface->get_point(nodes[2]));
+        get_cruse_weights(p1, p2, p3, s, r, areas[*fi], cruse);
+        Vector centroid = (p1 + p2 + p3) / 3.0;
+
+        VMesh::Node::iterator ni, nie;
+        observers->begin(ni); observers->end(nie);
+        for (; ni != nie; ++ni)
+        {
+          if (sameSurface && *ni == nodes[0])      bem_sing(p1, p2, p3, 0, g_values, s, r, weights);
+          else if (sameSurface && *ni == nodes[1]) bem_sing(p1, p2, p3, 1, g_values, s, r, weights);
+          else if (sameSurface && *ni == nodes[2]) bem_sing(p1, p2, p3, 2, g_values, s, r, weights);
+          else
+          {
+            get_g_coef(p1, p2, p3, Vector(observers->get_point(*ni)), s, r, centroid, g_coef);
+            g_values = areas[*fi] * (cruse * g_coef.cwiseProduct(weights).transpose());
+          }
+          for (int i = 0; i < 3; ++i)
+            result(*ni, nodes[i]) += g_values(i) * mult;
+        }
+      }
+      return result;
+    }
+
+    static DenseMatrix P(VMesh* observers, VMesh* surface, bool sameSurface, double mult)
+    {
+      DenseMatrix result(numNodes(observers), numNodes(surface), 0.0);
+      VertexValues coef;
+      VMesh::Node::array_type nodes;
+      VMesh::Face::iterator fi, fie;
+      surface->begin(fi); surface->end(fie);
+      for (; fi != fie; ++fi)
+      {
+        surface->get_nodes(nodes, *fi);
+        Vector p1(surface->get_point(nodes[0]));
+        Vector p2(surface->get_point(nodes[1]));
+        Vector p3(surface->get_point(nodes[2]));
+
+        VMesh::Node::iterator ni, nie;
+        observers->begin(ni); observers->end(nie);
+        for (; ni != nie; ++ni)
+        {
+          if (sameSurface && (*ni == nodes[0] || *ni == nodes[1] || *ni == nodes[2]))
+            continue;
+          Vector op(observers->get_point(*ni));
+          getOmega(p1 - op, p2 - op, p3 - op, coef);
+          for (int i = 0; i < 3; ++i)
+            result(*ni, nodes[i]) -= coef(i) * mult;
+        }
+      }
+      return result;
+    }
+  };
+
+  double relativeDifference(const DenseMatrix& actual, const DenseMatrix& expected)
+  {
+    return (actual - expected).lpNorm<Eigen::Infinity>() / expected.lpNorm<Eigen::Infinity>();
+  }
+}
+
+TEST(BuildBEMatrixAlgoTests, ParallelAssemblyMatchesSerialAssembly)
+{
+  // 258 and 66 nodes, so the 512 faces of the outer surface span more than one face block
+  auto outer = makeSphere(1.0, 3);
+  auto inner = makeSphere(0.5, 2);
+  auto outerMesh = outer->vmesh();
+  auto innerMesh = inner->vmesh();
+  const double inCond = 1.0, outCond = 0.2;
+  const double mult = 1 / (4 * M_PI) * (outCond - inCond);
+
+  std::vector<double> outerAreas, innerAreas;
+  BuildBEMatrixBase::pre_calc_tri_areas(outerMesh, outerAreas);
+  BuildBEMatrixBase::pre_calc_tri_areas(innerMesh, innerAreas);
+
+  auto autoG = SerialAssembly::G(outerMesh, outerMesh, true, mult, outerAreas);
+  auto crossG = SerialAssembly::G(innerMesh, outerMesh, false, mult, outerAreas);
+  auto crossP = SerialAssembly::P(innerMesh, outerMesh, false, mult);
+  auto autoP = SerialAssembly::P(outerMesh, outerMesh, true, mult);
+  DenseColumnMatrix sumOfRows = autoP.rowwise().sum();
+  for (int i = 0; i < autoP.rows(); ++i)
+    autoP(i, i) = outCond - sumOfRows(i);
+
+  DenseMatrixHandle firstAutoG, firstAutoP;
+  for (unsigned int threads : { 1u, 2u, 3u, 8u })
+  {
+    Parallel::SetMaximumCores(threads);
+
+    DenseMatrixHandle G, P, cG, cP;
+    BuildBEMatrixBase::make_auto_G(outerMesh, G, inCond, outCond, outCond, outerAreas);
+    BuildBEMatrixBase::make_auto_P(outerMesh, P, inCond, outCond, outCond);
+    BuildBEMatrixBase::make_cross_G(innerMesh, outerMesh, cG, inCond, outCond, outCond, outerAreas);
+    BuildBEMatrixBase::make_cross_P(innerMesh, outerMesh, cP, inCond, outCond, outCond);
+
+    EXPECT_LT(relativeDifference(*G, autoG), 1e-13) << threads << " threads";
+    EXPECT_LT(relativeDifference(*P, autoP), 1e-13) << threads << " threads";
+    EXPECT_LT(relativeDifference(*cG, crossG), 1e-13) << threads << " threads";
+    EXPECT_LT(relativeDifference(*cP, crossP), 1e-13) << threads << " threads";
+
+    // each entry sums its faces in mesh order whatever the row bands are
+    if (!firstAutoG)
+    {
+      firstAutoG = G;
+      firstAutoP = P;
+    }
+    EXPECT_EQ(0.0, (*G - *firstAutoG).norm()) << threads << " threads";
+    EXPECT_EQ(0.0, (*P - *firstAutoP).norm()) << threads << " threads";
+  }
+  Parallel::SetMaximumCores(0);
+}
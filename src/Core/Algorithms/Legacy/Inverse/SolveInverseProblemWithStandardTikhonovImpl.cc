@@ -41,6 +41,7 @@
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Eigen/Eigenvalues>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 
@@ -79,6 +80,14 @@ using namespace SCIRun::Core::Algorithms::Inverse;
         DenseMatrix solution(sizeSolution,numTimeSamples);
         DenseMatrix G;
 
+        if (spectralSweep_)
+        {
+            // G^-1 = V * (D + lambda^2 * I)^-1 * V^T, with V^T * y and M3 * V precomputed
+            DenseColumnMatrix filterFactors = (sweepEigenvalues_.array() + lambda * lambda).inverse().matrix();
+            solution = sweepSolutionBasis_ * ( filterFactors.asDiagonal() * sweepProjectedData_ );
+            return solution;
+        }
+
         G = M1 + lambda * lambda * M2;
 
         b = G.lu().solve(y).eval();
@@ -96,6 +105,45 @@ using namespace SCIRun::Core::Algorithms::Inverse;
 //////// fi compute inverse solution
 ////////////////////////
 
+/////////////////////////
+///////// prepare lambda sweep
+    void SolveInverseProblemWithStandardTikhonovImpl::prepareLambdaSweep()
+    {
+        //............................
+        //  When M2 is positive definite, the generalized eigenproblem M1 * V = M2 * V * D
+        //  with V^T * M2 * V = I diagonalizes G for every lambda at once:
+        //
+        //      G^-1 = V * (D + lambda^2 * I)^-1 * V^T
+        //      x    = (M3 * V) * (D + lambda^2 * I)^-1 * (V^T * y)
+        //
+        //  so each lambda of an L-curve costs one diagonal scaling and one product instead of an LU.
+        //  A singular M2 (e.g. a Laplacian source weighting) keeps the LU path, and so does
+        //  an M1 that is not symmetric: the solver only reads one triangle of it.
+        //............................
+        spectralSweep_ = false;
+
+        Eigen::LLT<DenseMatrix::EigenBase> choleskyM2(M2);
+        if (choleskyM2.info() != Eigen::Success)
+            return;
+
+        const double symmetryTolerance = 1e-10;
+        if ((M1 - M1.transpose()).norm() > symmetryTolerance * M1.norm())
+            return;
+
+        // only removes the rounding left over from forming M1 out of products
+        DenseMatrix::EigenBase symmetricM1 = 0.5 * (M1 + M1.transpose());
+        Eigen::GeneralizedSelfAdjointEigenSolver<DenseMatrix::EigenBase> eigenSolver(symmetricM1, M2);
+        if (eigenSolver.info() != Eigen::Success)
+            return;
+
+        sweepEigenvalues_ = eigenSolver.eigenvalues();
+        sweepSolutionBasis_ = M3 * eigenSolver.eigenvectors();
+        sweepProjectedData_ = eigenSolver.eigenvectors().transpose() * y;
+        spectralSweep_ = true;
+    }
+//////// fi prepare lambda sweep
+////////////////////////
+
 /////// precomputeInverseMatrices
 ///////////////
     void SolveInverseProblemWithStandardTikhonovImpl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const int regularizationChoice_, const int regularizationSolutionSubcase_, const int regularizationResidualSubcase_)
@@ -66,9 +66,16 @@ namespace SCIRun {
 			        SCIRun::Core::Datatypes::DenseMatrix M4;
 			        SCIRun::Core::Datatypes::DenseMatrix y;
 
+			        // Spectral form of G = M1 + lambda^2 * M2 for lambda sweeps (see prepareLambdaSweep)
+			        bool spectralSweep_ = false;
+			        SCIRun::Core::Datatypes::DenseColumnMatrix sweepEigenvalues_;
+			        SCIRun::Core::Datatypes::DenseMatrix sweepSolutionBasis_;
+			        SCIRun::Core::Datatypes::DenseMatrix sweepProjectedData_;
+
 							void preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const int regularizationChoice_, const int regularizationSolutionSubcase_, const int regularizationResidualSubcase_ );
 
 			        virtual SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double lambda, bool inverseCalculation) const;
+			        virtual void prepareLambdaSweep() override;
 			    };
 			}
 		}
@@ -113,33 +113,15 @@ void SolveInverseProblemWithTSVD_impl::preAlocateInverseMatrices(const SCIRun::C
 SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTSVD_impl::computeInverseSolution( double lambda, bool inverseCalculation ) const
 {
 
-    // prealocate matrices
-        const int N = svd_MatrixV.cols();
-        const int M = svd_MatrixU.rows();
-        const int numTimeSamples = Uy.ncols();
-        DenseMatrix solution(DenseMatrix::Zero(N,numTimeSamples));
-        DenseMatrix tempInverse(DenseMatrix::Zero(N,M));
-
 		const int truncationPoint = Min( int(lambda), rank, int(9999999999999) );
+		if (truncationPoint <= 0)
+			return DenseMatrix(DenseMatrix::Zero(svd_MatrixV.cols(), Uy.ncols()));
 
-    // Compute inverse SolveInverseProblemWithTSVD
-        for (int rr=0; rr < truncationPoint ; rr++)
-        {
-            // evaluate filter factor
-                double singVal = svd_SingularValues[rr];
-                auto filterFactor_i =  1 / ( singVal );
-
-            // update solution
-                solution += filterFactor_i * svd_MatrixV.col(rr) * Uy.row(rr);
-
-            // update inverse operator
-                if (inverseCalculation)
-                    tempInverse += filterFactor_i * ( svd_MatrixV.col(rr) *  svd_MatrixU.col(rr).transpose() );
-        }
+    // evaluate filter factors
+        DenseColumnMatrix filterFactors = svd_SingularValues.head(truncationPoint).cwiseInverse();
 
-    // output solutions
-    //   if (inverseCalculation)
-    //       inverseMatrix_.reset( new SCIRun::Core::Datatypes::DenseMatrix(tempInverse) );
+    // Compute inverse SolveInverseProblemWithTSVD as V * diag(f) * U^T y, without forming rank-one updates
+        DenseMatrix solution = svd_MatrixV.leftCols(truncationPoint) * ( filterFactors.asDiagonal() * Uy.topRows(truncationPoint) );
 
         return solution;
 }
@@ -84,6 +84,7 @@ namespace Inverse {
 
 		        virtual SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double truncationPoint, bool inverseCalculation) const;
 				std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
+				virtual bool hasContinuousLambda() const override { return false; }
 		        //      bool checkInputMatrixSizes(); // DEFINED IN PARENT, MIGHT WANT TO OVERRIDE SOME OTHER TIME
 
 
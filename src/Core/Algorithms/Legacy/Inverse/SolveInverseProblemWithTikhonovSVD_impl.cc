@@ -112,31 +112,16 @@ void SolveInverseProblemWithTikhonovSVD_impl::preAlocateInverseMatrices(const SC
 SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTikhonovSVD_impl::computeInverseSolution( double lambda, bool inverseCalculation ) const
 {
 
-    // prealocate matrices
-        const int N = svd_MatrixV.cols();
-        const int M = svd_MatrixU.rows();
-        const int numTimeSamples = Uy.ncols();
-        DenseMatrix solution(DenseMatrix::Zero(N,numTimeSamples));
-        DenseMatrix tempInverse(DenseMatrix::Zero(N,M));
-
-    // Compute inverse solution
+    // evaluate filter factors
+        DenseColumnMatrix filterFactors(rank);
         for (int rr=0; rr<rank ; rr++)
         {
-            // evaluate filter factor
-                double singVal = svd_SingularValues[rr];
-                double filterFactor_i =  singVal / ( lambda * lambda + singVal * singVal );
-
-            // u[date solution
-                solution += filterFactor_i * svd_MatrixV.col(rr) * Uy.row(rr);
-
-            // update inverse operator
-                if (inverseCalculation)
-                    tempInverse += filterFactor_i * ( svd_MatrixV.col(rr) *  svd_MatrixU.col(rr).transpose() );
+            double singVal = svd_SingularValues[rr];
+            filterFactors[rr] =  singVal / ( lambda * lambda + singVal * singVal );
         }
 
-    // output solutions
-    //   if (inverseCalculation)
-    //       inverseMatrix_.reset( new SCIRun::Core::Datatypes::DenseMatrix(tempInverse) );
+    // Compute inverse solution as V * diag(f) * U^T y, without forming rank-one updates
+        DenseMatrix solution = svd_MatrixV.leftCols(rank) * ( filterFactors.asDiagonal() * Uy.topRows(rank) );
 
         return solution;
 }
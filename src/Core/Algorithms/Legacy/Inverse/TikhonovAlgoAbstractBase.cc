@@ -31,6 +31,7 @@
 
 #include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 
 // Tikhonov specific headers
 #include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
@@ -54,6 +55,7 @@
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/Logging/Log.h>
 #include <Core/Utils/Exception.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
@@ -61,6 +63,7 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Logging;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Inverse;
+using namespace SCIRun::Core::Thread;
 
 // shared inputs
 const AlgorithmInputName TikhonovAlgoAbstractBase::ForwardMatrix("ForwardMatrix");
@@ -89,6 +92,7 @@ ALGORITHM_PARAMETER_DEF( Inverse, LambdaMax);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaNum);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaResolution);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaSliderValue);
+ALGORITHM_PARAMETER_DEF( Inverse, LambdaCornerSearch);
 //ALGORITHM_PARAMETER_DEF( Inverse, LambdaCorner);
 //ALGORITHM_PARAMETER_DEF( Inverse, LCurveText);
 ALGORITHM_PARAMETER_DEF( Inverse, regularizationSolutionSubcase);
@@ -105,6 +109,7 @@ TikhonovAlgoAbstractBase::TikhonovAlgoAbstractBase()
 	addParameter(Parameters::LambdaNum,200);
 	addParameter(Parameters::LambdaResolution,1e-6);
 	addParameter(Parameters::LambdaSliderValue,0);
+	addOption(Parameters::LambdaCornerSearch, "grid", "grid|golden");
 	addParameter(Parameters::regularizationSolutionSubcase,solution_constrained);
 	addParameter(Parameters::regularizationResidualSubcase,residual_constrained);
 }
@@ -273,19 +278,68 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 	return output;
 }
 
-double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input , DenseMatrixHandle& lambdamatrix, int& lambda_index) const
+namespace
+{
+	// rho = ||C (A x - y)|| and eta = ||R x|| of the solution x for one lambda, with C and R only applied when given
+	class LcurvePointEvaluator
+	{
+	public:
+		LcurvePointEvaluator(const TikhonovImpl& algoImpl, const AlgorithmInput& input) : algoImpl_(algoImpl)
+		{
+			forward_ = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix));
+			measured_ = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::MeasuredPotentials));
+			sourceWeighting_ = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSourceSpace));
+			sensorWeighting_ = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSensorSpace));
+		}
+
+		void operator()(double lambda, double& rho, double& eta) const
+		{
+			auto solution = algoImpl_.computeInverseSolution( lambda, false);
+
+			// if using source regularization matrix, apply it to compute Rx (for the eta computations)
+			if (sourceWeighting_)
+			{
+				if (solution.nrows() != sourceWeighting_->ncols()) // check that regularization matrix and solution match sizes
+					BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Solution weighting matrix unexpectedly does not fit to compute the weighted solution norm. "));
+				eta = ((*sourceWeighting_) * solution).norm();
+			}
+			else
+				eta = solution.norm();
+
+			DenseMatrix residualSolution = (*forward_) * solution - (*measured_);
+
+			// compute rho and eta. Using Frobenious norm when using matrices
+			if (sensorWeighting_)
+				rho = ((*sensorWeighting_) * residualSolution).norm();
+			else
+				rho = residualSolution.norm();
+		}
+
+	private:
+		const TikhonovImpl& algoImpl_;
+		DenseMatrixHandle forward_, measured_, sourceWeighting_, sensorWeighting_;
+	};
+}
+
+double TikhonovAlgoAbstractBase::computeLcurve( TikhonovImpl& algoImpl, const AlgorithmInput & input , DenseMatrixHandle& lambdamatrix, int& lambda_index) const
 {
-	// get inputs
-	auto forwardMatrix = input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix);
-	auto measuredData = input.get<Matrix>(TikhonovAlgoAbstractBase::MeasuredPotentials);
-	auto sourceWeighting = input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSourceSpace);
-	auto sensorWeighting = input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSensorSpace);
   // define the step size of the lambda vector to be computed  (distance between min and max divided by number of desired lambdas in log scale)
   const int nLambda = get(Parameters::LambdaNum).toInt();
 	const double lambdaMin = get(Parameters::LambdaMin).toDouble();
 	const double lambdaMax = get(Parameters::LambdaMax).toDouble();
 	double lambda = 0;
 
+	// factor the system once; every lambda below reuses the factorization
+	algoImpl.prepareLambdaSweep();
+	const LcurvePointEvaluator evaluateLcurvePoint(algoImpl, input);
+
+	if (getOption(Parameters::LambdaCornerSearch) == "golden" && algoImpl.hasContinuousLambda())
+	{
+		lambda = FindCornerGoldenSection( boost::cref(evaluateLcurvePoint), lambdaMin, lambdaMax, get(Parameters::LambdaResolution).toDouble(), lambdamatrix, lambda_index);
+		LOG_DEBUG("Lambda: {}", lambda);
+		return lambda;
+	}
+
 	// prealocate vector of lambdas and eta and rho
   std::vector<double> rho(nLambda, 0.0);
   std::vector<double> eta(nLambda, 0.0);
@@ -294,50 +348,18 @@ double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::
 
   auto lambdaArray = algoImpl.computeLambdaArray( lambdaMin, lambdaMax, nLambda );
 
-  DenseMatrix CAx, Rx;
-  DenseMatrix solution;
-
   lambdaArray[0] = lambdaMin;
 
-  // for all lambdas
+  // for all lambdas. The points are independent, so they are evaluated concurrently.
+  Parallel::For(0, nLambda, [&](size_t first, size_t last)
+  {
+    for (size_t j = first; j < last; ++j)
+      evaluateLcurvePoint(lambdaArray[j], rho[j], eta[j]);
+  }, 1);
+
   for (int j = 0; j < nLambda; j++)
   {
-    solution = algoImpl.computeInverseSolution( lambdaArray[j], false);
     lambdamatrix->put(j,0,lambdaArray[j]);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sourceWeighting)
-    {
-      if (solution.nrows() == sourceWeighting->ncols()) // check that regularization matrix and solution match sizes
-      {
-        auto sw = castMatrix::toDense(sourceWeighting);
-        Rx = (*sw) * solution;
-      }
-      else
-      {
-        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Solution weighting matrix unexpectedly does not fit to compute the weighted solution norm. "));
-      }
-    }
-    else
-      Rx = solution;
-
-    auto forward = castMatrix::toDense(forwardMatrix);
-    auto Ax = (*forward) * solution;
-    auto measured = castMatrix::toDense(measuredData);
-    auto residualSolution = Ax - (*measured);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sensorWeighting)
-    {
-      auto sw = castMatrix::toDense(sensorWeighting);
-      CAx = (*sw) * residualSolution;
-    }
-    else
-      CAx = residualSolution;
-
-    // compute rho and eta. Using Frobenious norm when using matrices
-    rho[j] = CAx.norm();
-    eta[j] = Rx.norm();
     lambdamatrix->put(j,1,rho[j]);
     lambdamatrix->put(j,2,eta[j]);
   }
@@ -351,6 +373,103 @@ double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::
   return lambda;
 }
 
+///// Golden-section corner search, following Cultrera & Callegaro (2020): four lambdas in golden-ratio
+///// positions on a log scale bracket the corner, and the side whose three points have the larger Menger
+///// curvature in log(rho)-log(eta) space is kept. Each step costs one new L-curve point.
+double TikhonovAlgoAbstractBase::FindCornerGoldenSection( const LcurvePointFunction& evaluate, double lambdaMin, double lambdaMax, double resolution, DenseMatrixHandle& lambdamatrix, int& lambda_index )
+{
+	if (lambdaMin <= 0 || lambdaMax <= lambdaMin)
+		BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Golden-section L-curve search needs 0 < LambdaMin < LambdaMax."));
+
+	struct LcurveSample
+	{
+		double logLambda, lambda, rho, eta;
+		double x() const { return std::log10(rho); }
+		double y() const { return std::log10(eta); }
+	};
+
+	const double goldenRatio = (1 + std::sqrt(5.0)) / 2;
+	const int maxIterations = 100;
+	std::vector<LcurveSample> evaluated;
+
+	auto sampleAt = [&](double logLambda)
+	{
+		LcurveSample p;
+		p.logLambda = logLambda;
+		p.lambda = std::pow(10.0, logLambda);
+		evaluate(p.lambda, p.rho, p.eta);
+		return p;
+	};
+	auto record = [&](const LcurveSample& p) { evaluated.push_back(p); return p; };
+	auto innerLeft = [&](double left, double right) { return (right + goldenRatio * left) / (1 + goldenRatio); };
+	auto mengerCurvature = [](const LcurveSample& a, const LcurveSample& b, const LcurveSample& c)
+	{
+		const double twiceArea = (b.x() - a.x()) * (c.y() - a.y()) - (c.x() - a.x()) * (b.y() - a.y());
+		const double sides = std::hypot(b.x() - a.x(), b.y() - a.y()) * std::hypot(c.x() - b.x(), c.y() - b.y()) * std::hypot(a.x() - c.x(), a.y() - c.y());
+		return sides > 0 ? 2 * twiceArea / sides : 0.0;
+	};
+
+	// the four starting points are independent
+	LcurveSample p[4];
+	p[0].logLambda = std::log10(lambdaMin);
+	p[3].logLambda = std::log10(lambdaMax);
+	p[1].logLambda = innerLeft(p[0].logLambda, p[3].logLambda);
+	p[2].logLambda = p[0].logLambda + (p[3].logLambda - p[1].logLambda);
+	Parallel::For(0, 4, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+			p[i] = sampleAt(p[i].logLambda);
+	}, 1);
+	evaluated.assign(p, p + 4);
+
+	LcurveSample corner = p[1];
+	for (int iteration = 0; iteration < maxIterations && (p[3].lambda - p[0].lambda) / p[3].lambda > resolution; ++iteration)
+	{
+		auto c2 = mengerCurvature(p[0], p[1], p[2]);
+		auto c3 = mengerCurvature(p[1], p[2], p[3]);
+
+		// a concave right triple means the corner lies further left: shrink from the right until it is convex
+		for (int shrink = 0; c3 < 0 && shrink < maxIterations; ++shrink)
+		{
+			p[3] = p[2];
+			p[2] = p[1];
+			p[1] = record(sampleAt(innerLeft(p[0].logLambda, p[3].logLambda)));
+			c2 = mengerCurvature(p[0], p[1], p[2]);
+			c3 = mengerCurvature(p[1], p[2], p[3]);
+		}
+
+		if (c2 > c3)
+		{
+			corner = p[1];
+			p[3] = p[2];
+			p[2] = p[1];
+			p[1] = record(sampleAt(innerLeft(p[0].logLambda, p[3].logLambda)));
+		}
+		else
+		{
+			corner = p[2];
+			p[0] = p[1];
+			p[1] = p[2];
+			p[2] = record(sampleAt(p[0].logLambda + (p[3].logLambda - p[1].logLambda)));
+		}
+	}
+
+	std::sort(evaluated.begin(), evaluated.end(), [](const LcurveSample& a, const LcurveSample& b) { return a.lambda < b.lambda; });
+
+	lambdamatrix.reset(new DenseMatrix(evaluated.size(), 3, 0.0));
+	lambda_index = 0;
+	for (size_t j = 0; j < evaluated.size(); j++)
+	{
+		lambdamatrix->put(j,0,evaluated[j].lambda);
+		lambdamatrix->put(j,1,evaluated[j].rho);
+		lambdamatrix->put(j,2,evaluated[j].eta);
+		if (evaluated[j].lambda == corner.lambda)
+			lambda_index = static_cast<int>(j);
+	}
+
+	return corner.lambda;
+}
+
 ///// Find Corner, find the maximal curvature which corresponds to the L-curve corner
 double TikhonovAlgoAbstractBase::FindCorner( const std::vector<double>& rho, const std::vector<double>& eta, const std::vector<double>& lambdaArray, const int nLambda, int& lambda_index )
 {
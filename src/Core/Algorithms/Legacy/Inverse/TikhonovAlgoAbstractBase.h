@@ -31,6 +31,7 @@
 #ifndef BioPSE_TikhonovAlgoAbstractBase_H__
 #define BioPSE_TikhonovAlgoAbstractBase_H__
 
+#include <boost/function.hpp>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
 #include <Core/Algorithms/Legacy/Inverse/TikhonovImpl.h>
 #include <Core/Algorithms/Legacy/Inverse/share.h>
@@ -53,6 +54,7 @@ namespace Inverse {
 	ALGORITHM_PARAMETER_DECL(LambdaNum);
 	ALGORITHM_PARAMETER_DECL(LambdaResolution);
 	ALGORITHM_PARAMETER_DECL(LambdaSliderValue);
+	ALGORITHM_PARAMETER_DECL(LambdaCornerSearch);
 	//ALGORITHM_PARAMETER_DECL(LambdaCorner);
 	//ALGORITHM_PARAMETER_DECL(LCurveText);
 
@@ -96,7 +98,14 @@ namespace Inverse {
 		virtual AlgorithmOutput run(const AlgorithmInput &) const override;
 
 		static double FindCorner( const std::vector<double>& rho, const std::vector<double>& eta, const std::vector<double>& lambdaArray, const int nLambda,int& lambda_index );
-    double computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input,  SCIRun::Core::Datatypes::DenseMatrixHandle& lambdamatrix, int& lambda_index ) const;
+    double computeLcurve( SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input,  SCIRun::Core::Datatypes::DenseMatrixHandle& lambdamatrix, int& lambda_index ) const;
+
+		// computes rho (residual norm) and eta (solution norm) of the L-curve for one lambda
+		typedef boost::function<void(double lambda, double& rho, double& eta)> LcurvePointFunction;
+
+		// Golden-section search for the L-curve corner in [lambdaMin, lambdaMax] that stops once the bracket is
+		// narrower than resolution (relative). Fills lambdamatrix with the evaluated (lambda, rho, eta) rows sorted by lambda.
+		static double FindCornerGoldenSection( const LcurvePointFunction& evaluate, double lambdaMin, double lambdaMax, double resolution, SCIRun::Core::Datatypes::DenseMatrixHandle& lambdamatrix, int& lambda_index );
 
 		bool checkInputMatrixSizes( const AlgorithmInput & input ) const;
 
@@ -55,6 +55,14 @@ namespace Inverse {
 		// default lambda step. Can ve overriden if necessary (see TSVD as reference)
 		virtual std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
 
+		// Called once before an L-curve sweep evaluates computeInverseSolution for many lambdas, so an
+		// implementation can factor the system once and make each lambda cheap. During the sweep
+		// computeInverseSolution is called from several threads at once.
+		virtual void prepareLambdaSweep() {}
+
+		// False when lambda is a discrete index (see TSVD), which rules out a golden-section corner search.
+		virtual bool hasContinuousLambda() const { return true; }
+
 	};
 
 	}}}}
@@ -33,27 +33,34 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <memory>
+#include <chrono>
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
 
+ALGORITHM_PARAMETER_DEF(Math, NumberOfThreads);
+
 SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 {
   // For solver
-  addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Method,"cg","jacobi|cg|pipecg|bicg|minres");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|IC0|ILU0|AMG");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
 
   addParameter(Variables::BuildConvergence, true);
+  // 0 uses one thread per core
+  addParameter(Parameters::NumberOfThreads, 0);
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // for callback
@@ -78,16 +85,66 @@ public:
   bool run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
             DenseColumnMatrixHandle& convergence) const;
+  /// Block solve: x receives one solution column per column of b.
+  bool run(SparseRowMatrixHandle a, DenseMatrixHandle b,
+            DenseMatrixHandle x0, DenseMatrixHandle& x,
+            DenseColumnMatrixHandle& convergence) const;
 protected:
+  /// Collective; times the setup and reports it from the first thread. A solver that is
+  /// run again on the same matrix and thread count keeps the preconditioner it already built.
+  bool setup_preconditioner(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelMatrix& A) const;
+  /// Runs parallel() on all threads and reports the solve time.
+  bool solve(SolverInputs& matrices) const;
+
   const AlgorithmBase* algo_;
   std::string pre_conditioner_;
+  ParallelPreconditionerHandle preconditioner_;
   DenseColumnMatrixHandle convergence_;
+  mutable double setup_seconds_;
+  mutable const double* preconditioned_;
+  mutable int preconditioned_threads_;
 };
 
+namespace
+{
+  double secondsSince(const std::chrono::steady_clock::time_point& start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
 SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base) : algo_(base),
   pre_conditioner_(base->getOption(Variables::Preconditioner)),
-  convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt()))
+  preconditioner_(makeParallelPreconditioner(pre_conditioner_)),
+  convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt())),
+  setup_seconds_(0),
+  preconditioned_(nullptr),
+  preconditioned_threads_(0)
+{
+}
+
+bool
+SolveLinearSystemParallelAlgo::setup_preconditioner(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelMatrix& A) const
 {
+  PLA.wait();
+  // IC0 and ILU0 factor per-thread blocks, so a setup only fits runs with the same partitioning
+  if (preconditioned_ == A.data_ && preconditioned_threads_ == PLA.nproc())
+    return true;
+
+  auto start = std::chrono::steady_clock::now();
+  bool success = preconditioner_->setup(PLA, A);
+  PLA.wait();
+
+  if (PLA.first() && success)
+  {
+    preconditioned_ = A.data_;
+    preconditioned_threads_ = PLA.nproc();
+    setup_seconds_ = secondsSince(start);
+    std::ostringstream ostr;
+    ostr << "Preconditioner " << pre_conditioner_ << " setup took " << setup_seconds_ << " s";
+    algo_->remark(ostr.str());
+  }
+  return success;
 }
 
 bool
@@ -115,13 +172,43 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
   algo->set_handle("convergence", convergence);
 #endif
 
-  if(!start_parallel(matrices))
+  return solve(matrices);
+}
+
+bool
+SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseMatrixHandle b,
+                                   DenseMatrixHandle x0, DenseMatrixHandle& x,
+                                   DenseColumnMatrixHandle& convergence) const
+{
+  SolverInputs matrices;
+  matrices.A = a;
+  matrices.B = b;
+  matrices.X0 = x0;
+  x = boost::make_shared<DenseMatrix>(x0->nrows(), x0->ncols());
+  matrices.X = x;
+
+  convergence = convergence_;
+
+  return solve(matrices);
+}
+
+bool
+SolveLinearSystemParallelAlgo::solve(SolverInputs& matrices) const
+{
+  auto start = std::chrono::steady_clock::now();
+  setup_seconds_ = 0;
+  const int numThreads = algo_->get(Parameters::NumberOfThreads).toInt();
+  if(!start_parallel(matrices, numThreads > 0 ? numThreads : -1))
   {
     const std::string msg = "Encountered an error while running parallel linear algebra";
     algo_->error(msg);
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(msg));
   }
 
+  std::ostringstream ostr;
+  ostr << "Solve phase took " << secondsSince(start) - setup_seconds_ << " s";
+  algo_->remark(ostr.str());
+
   return (true);
 }
 
@@ -138,7 +225,7 @@ class SolveLinearSystemCGAlgo : public SolveLinearSystemParallelAlgo
 bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 {
   ParallelLinearAlgebra::ParallelMatrix A;
-  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, Z, P;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, R, Z, P;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -167,7 +254,6 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
     return (false);
   }
   if ( !PLA.new_vector(X) ||
-       !PLA.new_vector(DIAG) ||
        !PLA.new_vector(R) ||
        !PLA.new_vector(Z) ||
        !PLA.new_vector(P))
@@ -189,15 +275,12 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
+  if (!setup_preconditioner(PLA,A))
   {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
+    if (PLA.first())
+      algo_->error("Could not build the " + pre_conditioner_ + " preconditioner");
+    PLA.wait();
+    return (false);
   }
 
   PLA.mult(A,X,R);
@@ -234,6 +317,9 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
   double log_orig =  log(orig);
   double log_scale = log_orig - log_target;
 
+  preconditioner_->apply(PLA,R,Z);
+  double bknum = PLA.dot(Z,R);
+
   while (niter < max_iter)
   {
     if (error <= tolerance)
@@ -256,9 +342,6 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
-    double bknum = PLA.dot(Z,R);
-
     if (niter == 0)
     {
       PLA.copy(Z,P);
@@ -268,16 +351,19 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       double bk = bknum/bkden;
       PLA.scale_add(bk,P,Z,P);
     }
-    PLA.mult(A,P,Z);
+    double akden = PLA.mult_dot(A,P,Z,P);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P);
     double ak=bknum/akden;
 
-    PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
+    PLA.scale_add_2(ak,P,X,-ak,Z,R);
+
+    // Precondition the new residual now so its dot product shares a reduction with the norm
+    preconditioner_->apply(PLA,R,Z);
+    double rnorm2;
+    PLA.dot_2(Z,R,R,R,bknum,rnorm2);
 
-    error = PLA.norm(R)/bnorm;
+    error = sqrt(rnorm2)/bnorm;
     if (error < xmin)
     {
       PLA.copy(X,XMIN);
@@ -338,6 +424,380 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 }
 
 
+//------------------------------------------------------------------
+// Pipelined CG (Ghysels & Vanroose, Parallel Computing 40, 2014)
+// The dot products of an iteration are reduced while the preconditioner and the
+// matrix-vector product run, so each iteration synchronizes once (in the SpMV)
+// instead of three times. The recurrences drift slightly more than plain CG in
+// finite precision, so prefer cg when very small target errors are needed.
+
+class SolveLinearSystemPipelinedCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    explicit SolveLinearSystemPipelinedCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
+};
+
+bool SolveLinearSystemPipelinedCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, R, U, W, M0, M1, N, Z, Q, S, P;
+
+  double tolerance =     algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A, A) ||
+       !PLA.add_vector(matrices.b, B) ||
+       !PLA.add_vector(matrices.x0, X0) ||
+       !PLA.add_vector(matrices.x, XMIN))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+  if ( !PLA.new_vector(X) ||
+       !PLA.new_vector(R) ||
+       !PLA.new_vector(U) ||
+       !PLA.new_vector(W) ||
+       !PLA.new_vector(M0) ||
+       !PLA.new_vector(M1) ||
+       !PLA.new_vector(N) ||
+       !PLA.new_vector(Z) ||
+       !PLA.new_vector(Q) ||
+       !PLA.new_vector(S) ||
+       !PLA.new_vector(P))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.copy(X0,X);
+  PLA.copy(X0,XMIN);
+  // The first update scales these by beta = 0, which only clears them if they hold numbers
+  PLA.zeros(Z);
+  PLA.zeros(Q);
+  PLA.zeros(S);
+  PLA.zeros(P);
+
+  // Build a preconditioner
+  if (!setup_preconditioner(PLA,A))
+  {
+    if (PLA.first())
+      algo_->error("Could not build the " + pre_conditioner_ + " preconditioner");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.mult(A,X,R);
+  PLA.sub(B,R,R);
+
+  double bnorm = PLA.norm(B);
+  double error = PLA.norm(R)/bnorm;
+
+  double xmin = error;
+  double orig = error;
+
+  if (error <= tolerance)
+  {
+    if (PLA.first())
+    {
+      std::ostringstream ostr;
+      ostr << "Solver found solution with error = " << error;
+      algo_->remark(ostr.str());
+    }
+    PLA.wait();
+    return (true);
+  }
+
+  // u = M r, w = A u
+  preconditioner_->apply(PLA,R,U);
+  PLA.mult(A,U,W);
+
+  double partials[3], sums[3];
+  PLA.pipelined_cg_sums(R,U,W,partials);
+
+  double gamma_old = 0.0, alpha_old = 0.0;
+
+  int cnt = 0;
+  double log_target = log(tolerance);
+  double log_orig =  log(orig);
+  double log_scale = log_orig - log_target;
+
+  while (niter < max_iter)
+  {
+    // m = M w alternates between two vectors: without a barrier after the SpMV, a thread
+    // may start the next iteration while others still read this one's m.
+    ParallelLinearAlgebra::ParallelVector& M = (niter % 2) ? M1 : M0;
+
+    // The barrier at the start of the SpMV completes the reduction
+    PLA.post_sums(partials,3);
+    preconditioner_->apply(PLA,W,M);
+    PLA.mult(A,M,N);
+    PLA.collect_sums(sums,3);
+
+    const double gamma = sums[0], delta = sums[1];
+    error = sqrt(sums[2])/bnorm;
+
+    if (niter > 0)
+    {
+      if (error < xmin)
+      {
+        PLA.copy(X,XMIN);
+        xmin = error;
+      }
+      if (PLA.first())
+        (*convergence_)[niter-1] = xmin;
+    }
+
+    if (error <= tolerance)
+    {
+      if (PLA.first())
+      {
+        std::ostringstream ostr;
+        ostr << "Solver converged after " << niter << " iterations with error " << error;
+        algo_->remark(ostr.str());
+      }
+      PLA.wait();
+      return true;
+    }
+
+    double alpha, beta;
+    if (niter == 0)
+    {
+      beta = 0.0;
+      alpha = gamma/delta;
+    }
+    else
+    {
+      beta = gamma/gamma_old;
+      alpha = gamma/(delta - beta*gamma/alpha_old);
+    }
+    gamma_old = gamma;
+    alpha_old = alpha;
+
+    PLA.pipelined_cg_update(alpha,beta,N,M,Z,Q,S,P,X,R,U,W,partials);
+    niter++;
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress((log_orig-log(error))/log_scale);
+    }
+  }
+
+  // The last update has not been measured yet
+  PLA.post_sums(partials,3);
+  PLA.wait();
+  PLA.collect_sums(sums,3);
+  error = sqrt(sums[2])/bnorm;
+  if (error < xmin)
+  {
+    PLA.copy(X,XMIN);
+    xmin = error;
+  }
+
+  if (PLA.first())
+  {
+    if (niter > 0)
+      (*convergence_)[niter-1] = xmin;
+    std::ostringstream ostr;
+    ostr << "Solver stopped after " << niter << " iterations. Error was " << error;
+    algo_->remark(ostr.str());
+  }
+
+  PLA.wait();
+
+  return true;
+}
+
+
+//------------------------------------------------------------------
+// Block CG for several right-hand sides
+// Runs one preconditioned CG recurrence per column of B, but every iteration
+// multiplies A with all search directions in a single traversal of A and
+// reduces the dot products of all columns together. Columns that have
+// converged stop moving; the solve ends when all of them have.
+
+class SolveLinearSystemBlockCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    explicit SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
+  private:
+    void precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelBlockVector& R,
+      ParallelLinearAlgebra::ParallelBlockVector& Z, ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, const std::vector<char>& active) const;
+};
+
+void SolveLinearSystemBlockCGAlgo::precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelBlockVector& R,
+  ParallelLinearAlgebra::ParallelBlockVector& Z, ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z, const std::vector<char>& active) const
+{
+  for (size_t j = 0; j < R.cols_; ++j)
+  {
+    if (!active[j])
+      continue;
+    PLA.get_column(R,j,r);
+    preconditioner_->apply(PLA,r,z);
+    PLA.set_column(z,j,Z);
+  }
+}
+
+namespace
+{
+  // Relative residual of every column; returns the largest one
+  double blockErrors(const std::vector<double>& rr, const std::vector<double>& bnorm, double tolerance, std::vector<char>& active)
+  {
+    double maxerror = 0.0;
+    for (size_t j = 0; j < rr.size(); ++j)
+    {
+      double error = sqrt(rr[j])/bnorm[j];
+      active[j] = error > tolerance;
+      maxerror = std::max(maxerror, error);
+    }
+    return maxerror;
+  }
+}
+
+bool SolveLinearSystemBlockCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelBlockVector B, X, X0, R, Z, P, Q;
+  ParallelLinearAlgebra::ParallelVector r, z;
+
+  double tolerance =     algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A, A) ||
+       !PLA.add_block(matrices.B, B) ||
+       !PLA.add_block(matrices.X0, X0) ||
+       !PLA.add_block(matrices.X, X))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+
+  const size_t k = B.cols_;
+  if ( !PLA.new_block(k,R) ||
+       !PLA.new_block(k,Z) ||
+       !PLA.new_block(k,P) ||
+       !PLA.new_block(k,Q) ||
+       !PLA.new_vector(r) ||
+       !PLA.new_vector(z))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.copy(X0,X);
+
+  if (!setup_preconditioner(PLA,A))
+  {
+    if (PLA.first())
+      algo_->error("Could not build the " + pre_conditioner_ + " preconditioner");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.mult(A,X,R);
+  PLA.sub(B,R,R);
+
+  std::vector<double> bnorm(k), rz(k), rzold(k), rr(k), pq(k), alpha(k), nalpha(k), beta(k);
+  std::vector<char> active(k, 1);
+
+  PLA.norms(B,&bnorm[0]);
+  // A zero right-hand side has the zero solution; measure its residual in absolute terms
+  for (auto& n : bnorm)
+    if (n == 0.0) n = 1.0;
+
+  precondition(PLA,R,Z,r,z,active);
+  PLA.dots_2(Z,R,R,R,&rz[0],&rr[0]);
+  double error = blockErrors(rr,bnorm,tolerance,active);
+
+  if (error <= tolerance)
+  {
+    if (PLA.first())
+    {
+      std::ostringstream ostr;
+      ostr << "Solver found solution with error = " << error;
+      algo_->remark(ostr.str());
+    }
+    PLA.wait();
+    return (true);
+  }
+
+  int cnt = 0;
+  double log_target = log(tolerance);
+  double log_orig =  log(error);
+  double log_scale = log_orig - log_target;
+
+  PLA.copy(Z,P);
+
+  while (niter < max_iter)
+  {
+    PLA.mult_dots(A,P,Q,P,&pq[0]);
+    for (size_t j = 0; j < k; ++j)
+    {
+      alpha[j] = (active[j] && pq[j] != 0.0) ? rz[j]/pq[j] : 0.0;
+      nalpha[j] = -alpha[j];
+    }
+    PLA.scale_add_2(&alpha[0],P,X,&nalpha[0],Q,R);
+
+    precondition(PLA,R,Z,r,z,active);
+    rzold.swap(rz);
+    PLA.dots_2(Z,R,R,R,&rz[0],&rr[0]);
+    error = blockErrors(rr,bnorm,tolerance,active);
+
+    if (PLA.first())
+      (*convergence_)[niter] = error;
+    niter++;
+
+    if (error <= tolerance)
+    {
+      if (PLA.first())
+      {
+        std::ostringstream ostr;
+        ostr << "Solver converged after " << niter << " iterations with error " << error << " for " << k << " right-hand sides";
+        algo_->remark(ostr.str());
+      }
+      PLA.wait();
+      return true;
+    }
+
+    for (size_t j = 0; j < k; ++j)
+      beta[j] = active[j] ? rz[j]/rzold[j] : 0.0;
+    PLA.scale_add(&beta[0],P,Z,P);
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress((log_orig-log(error))/log_scale);
+    }
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Solver stopped after " << niter << " iterations. Largest error was " << error;
+    algo_->remark(ostr.str());
+  }
+
+  PLA.wait();
+
+  return true;
+}
+
 //------------------------------------------------------------------
 // BICG Solver with simple preconditioner
 class SolveLinearSystemBICGAlgo : public SolveLinearSystemParallelAlgo
@@ -357,7 +817,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   // Define matrices and vectors to be used in the algorithm
   ParallelLinearAlgebra::ParallelMatrix A;
   ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN;
-  ParallelLinearAlgebra::ParallelVector DIAG, R, R1, Z, Z1, P, P1;
+  ParallelLinearAlgebra::ParallelVector R, R1, Z, Z1, P, P1;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -373,7 +833,6 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
        !PLA.add_vector(matrices.x0,X0) ||
        !PLA.add_vector(matrices.x,XMIN) ||
        !PLA.new_vector(X) ||
-       !PLA.new_vector(DIAG) ||
        !PLA.new_vector(R) ||
        !PLA.new_vector(R1) ||
        !PLA.new_vector(Z) ||
@@ -399,15 +858,12 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
+  if (!setup_preconditioner(PLA,A))
   {
-    PLA.ones(DIAG);
+    if (PLA.first())
+      algo_->error("Could not build the " + pre_conditioner_ + " preconditioner");
+    PLA.wait();
+    return (false);
   }
 
   PLA.mult(A,X,R);
@@ -443,6 +899,10 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   double log_orig =  log(orig);
   double log_scale = log_orig - log_target;
 
+  preconditioner_->apply(PLA,R,Z);
+  preconditioner_->apply_trans(PLA,R1,Z1);
+  double bknum = PLA.dot(Z,R1);
+
   while (niter < max_iter)
   {
     if (error <= tolerance)
@@ -460,11 +920,6 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       return (true);
     }
 
-    PLA.mult(R,DIAG,Z);
-    PLA.mult(R1,DIAG,Z1);
-
-    double bknum = PLA.dot(Z,R1);
-
     if (bknum == 0.0)
     {
       if (PLA.first())
@@ -491,18 +946,20 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       PLA.scale_add(bk,P1,Z1,P1);
     }
 
-    PLA.mult(A,P,Z);
     PLA.mult_trans(A,P1,Z1);
+    double akden = PLA.mult_dot(A,P,Z,P1);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P1);
     double ak=bknum/akden;
 
-    PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
-
+    PLA.scale_add_2(ak,P,X,-ak,Z,R);
     PLA.scale_add(-ak,Z1,R1,R1);
-    error = PLA.norm(R)/bnorm;
+
+    preconditioner_->apply(PLA,R,Z);
+    preconditioner_->apply_trans(PLA,R1,Z1);
+    double rnorm2;
+    PLA.dot_2(Z,R1,R,R,bknum,rnorm2);
+    error = sqrt(rnorm2)/bnorm;
 
     if (error < xmin) { PLA.copy(X,XMIN); xmin = error; }
     if (PLA.first()) (*convergence_)[niter] = xmin;
@@ -572,7 +1029,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   // Define matrices and vectors to be used in the algorithm
   ParallelLinearAlgebra::ParallelMatrix A;
   ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN;
-  ParallelLinearAlgebra::ParallelVector DIAG, R, V, VOLD, VV;
+  ParallelLinearAlgebra::ParallelVector R, V, VOLD, VV;
   ParallelLinearAlgebra::ParallelVector VOLDER, M, MOLD, MOLDER, XCG;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
@@ -590,7 +1047,6 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
        !PLA.add_vector(matrices.x,XMIN) ||
        !PLA.new_vector(X) ||
        !PLA.new_vector(R) ||
-       !PLA.new_vector(DIAG) ||
        !PLA.new_vector(V) ||
        !PLA.new_vector(VV) ||
        !PLA.new_vector(VOLD) ||
@@ -618,15 +1074,12 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
+  if (!setup_preconditioner(PLA,A))
   {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
+    if (PLA.first())
+      algo_->error("Could not build the " + pre_conditioner_ + " preconditioner");
+    PLA.wait();
+    return (false);
   }
 
   PLA.mult(A,X,R);
@@ -656,7 +1109,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(R,VOLD);
   PLA.copy(R,V);
 
-  PLA.mult(DIAG,V,V);
+  preconditioner_->apply(PLA,V,V);
 
   double beta1   = sqrt(PLA.dot(V,VOLD));
   double snprod  = beta1;
@@ -673,7 +1126,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(VOLD,VOLDER);
   PLA.copy(V,VOLD);
 
-  PLA.mult(DIAG,V,V);
+  preconditioner_->apply(PLA,V,V);
 
   double betaold = beta1;
   double beta = sqrt(PLA.dot(VOLD,V));
@@ -734,7 +1187,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.copy(VOLD,VOLDER);
     PLA.copy(V,VOLD);
 
-    PLA.mult(DIAG,V,V);
+    preconditioner_->apply(PLA,V,V);
 
     betaold = beta;
     beta = sqrt(PLA.dot(VOLD,V));
@@ -766,8 +1219,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (cnt == 6 || niter == 0)
     {
       PLA.mult(A,X,R);
-      PLA.sub(B,R,R);
-      error = PLA.norm(R)/bnorm;
+      error = PLA.scale_add_norm(-1.0,R,B,R)/bnorm;
       cnt = 0;
       didnormr = true;
     }
@@ -802,8 +1254,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       }
 
       PLA.mult(A,X,R);
-      PLA.sub(B,R,R);
-      error = PLA.norm(R)/bnorm;
+      error = PLA.scale_add_norm(-1.0,R,B,R)/bnorm;
 
       if (error < tolerance)
       {
@@ -831,9 +1282,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       PLA.scale_add(snprod*(sn/cs),M,XCG,XCG);
 
       PLA.mult(A,XCG,R);
-      PLA.sub(B,R,R);
-
-      error = PLA.norm(R);
+      error = PLA.scale_add_norm(-1.0,R,B,R);
 
       if (error < tolerance)
       {
@@ -1015,8 +1464,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.mult(DIAG,Z,Z);
     PLA.sub(Z,X,X);
     PLA.mult(A,X,Z);
-    PLA.sub(Z,B,Z);
-    error = PLA.norm(Z) / bnorm;
+    error = PLA.scale_add_norm(-1.0,B,Z,Z) / bnorm;
     if (error < xmin) { PLA.copy(X,XMIN); xmin = error; }
     if (PLA.first()) (*convergence_)[niter] = xmin;
 
@@ -1067,6 +1515,40 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   return (true);
 }
 
+namespace
+{
+  /// Single right-hand side solver for method; failure receives the message to report if it fails.
+  std::unique_ptr<SolveLinearSystemParallelAlgo> makeSolver(const std::string& method, const AlgorithmBase* algo, std::string& failure)
+  {
+    if (method == "cg")
+    {
+      failure = "Conjugate Gradient method failed";
+      return std::unique_ptr<SolveLinearSystemParallelAlgo>(new SolveLinearSystemCGAlgo(algo));
+    }
+    if (method == "pipecg")
+    {
+      failure = "Pipelined Conjugate Gradient method failed";
+      return std::unique_ptr<SolveLinearSystemParallelAlgo>(new SolveLinearSystemPipelinedCGAlgo(algo));
+    }
+    if (method == "bicg")
+    {
+      failure = "BiConjugate Gradient method failed";
+      return std::unique_ptr<SolveLinearSystemParallelAlgo>(new SolveLinearSystemBICGAlgo(algo));
+    }
+    if (method == "jacobi")
+    {
+      failure = "Jacobi method failed";
+      return std::unique_ptr<SolveLinearSystemParallelAlgo>(new SolveLinearSystemJACOBIAlgo(algo));
+    }
+    if (method == "minres")
+    {
+      failure = "MINRES method failed";
+      return std::unique_ptr<SolveLinearSystemParallelAlgo>(new SolveLinearSystemMINRESAlgo(algo));
+    }
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage("Unknown solver method"));
+  }
+}
+
 bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
                            DenseColumnMatrixHandle b,
                            DenseColumnMatrixHandle x0,
@@ -1146,57 +1628,114 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
 
   std::string method = getOption(Variables::Method);
+  // MINRES applies the preconditioner as a symmetric operator; the ILU0 factors are not
+  if (method == "minres" && getOption(Variables::Preconditioner) == "ILU0")
+  {
+    THROW_ALGORITHM_INPUT_ERROR("MINRES needs a symmetric preconditioner; use Jacobi, IC0 or AMG instead of ILU0");
+  }
 
   DenseColumnMatrixHandle conv;
-  if (method == "cg")
+  std::string failure;
+  auto algo = makeSolver(method, this, failure);
+  if (!algo->run(A,b,x0,x,conv))
   {
-    SolveLinearSystemCGAlgo algo(this);
-    if(!algo.run(A,b,x0,x,conv))
-    {
-      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
-    }
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(failure));
   }
-  else if (method == "bicg")
+
+#ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
+  if (get_bool("build_convergence"))
   {
-    SolveLinearSystemBICGAlgo algo(this);
-    if(!(algo.run(A,b,x0,x,conv)))
+    if (conv)
     {
-      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("BiConjugate Gradient method failed"));
+      int iteration = get_int("iteration");
+      convergence = conv->clone();
     }
-  }
-  else if (method == "jacobi")
-  {
-    SolveLinearSystemJACOBIAlgo algo(this);
-    if(!(algo.run(A,b,x0,x,conv)))
+    else
     {
-      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Jacobi method failed"));
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("No convergence matrix"));
     }
   }
-  else if (method == "minres")
+#endif
+  return true;
+}
+
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle B,
+                           DenseMatrixHandle X0,
+                           DenseMatrixHandle& X) const
+{
+  ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(B, "No matrix b is given");
+
+  double tolerance = get(Variables::TargetError).toDouble();
+  int maxIterations = get(Variables::MaxIterations).toInt();
+  ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+  ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+  if (!X0)
+  {
+    X0 = boost::make_shared<DenseMatrix>(DenseMatrix::Zero(B->nrows(), B->ncols()));
+  }
+
+  if (X0->nrows() != B->nrows() || X0->ncols() != B->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix x0 and b need to have the same dimensions");
+  }
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != B->nrows())
   {
-    SolveLinearSystemMINRESAlgo algo(this);
-    if(!(algo.run(A,b,x0,x,conv)))
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and b do not have the same number of rows");
+  }
+
+  std::string method = getOption(Variables::Method);
+  // MINRES applies the preconditioner as a symmetric operator; the ILU0 factors are not
+  if (method == "minres" && getOption(Variables::Preconditioner) == "ILU0")
+  {
+    THROW_ALGORITHM_INPUT_ERROR("MINRES needs a symmetric preconditioner; use Jacobi, IC0 or AMG instead of ILU0");
+  }
+
+  if (method == "cg" || method == "pipecg")
+  {
+    SolveLinearSystemBlockCGAlgo algo(this);
+    DenseColumnMatrixHandle conv;
+    if (!algo.run(A,B,X0,X,conv))
     {
-      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("MINRES method failed"));
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Block Conjugate Gradient method failed"));
     }
+    return true;
   }
-  else
-    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
 
-#ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (get_bool("build_convergence"))
+  std::ostringstream ostr;
+  ostr << "Method " << method << " has no block variant; solving the " << B->ncols() << " right-hand sides one at a time";
+  remark(ostr.str());
+
+  // One solver for all columns, so the preconditioner is set up once
+  std::string failure;
+  auto algo = makeSolver(method, this, failure);
+  X = boost::make_shared<DenseMatrix>(B->nrows(), B->ncols());
+  for (size_t j = 0; j < B->ncols(); ++j)
   {
-    if (conv)
+    // A zero right-hand side has the zero solution; its relative error would be 0/0
+    if (B->col(j).isZero(0.0))
     {
-      int iteration = get_int("iteration");
-      convergence = conv->clone();
+      X->col(j).setZero();
+      continue;
     }
-    else
+    auto b = boost::make_shared<DenseColumnMatrix>(B->col(j));
+    auto x0 = boost::make_shared<DenseColumnMatrix>(X0->col(j));
+    DenseColumnMatrixHandle x, conv;
+    if (!algo->run(A,b,x0,x,conv))
     {
-      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("No convergence matrix"));
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(failure));
     }
+    X->col(j) = *x;
   }
-#endif
   return true;
 }
 
@@ -1205,6 +1744,21 @@ AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
+  // Several right-hand sides arrive as the columns of a dense matrix
+  auto rhsBlock = input.get<DenseMatrix>(Variables::RHS);
+  if (!rhs && rhsBlock)
+  {
+    DenseMatrixHandle solutions;
+    if (!run(lhs, rhsBlock, DenseMatrixHandle(), solutions) || !solutions)
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("SolveLinearSystem could not solve for the right-hand side columns"));
+    }
+
+    AlgorithmOutput output;
+    output[Variables::Solution] = solutions;
+    return output;
+  }
+
   DenseColumnMatrixHandle solution;
 
   bool success = run(lhs, rhs, DenseColumnMatrixHandle(), solution);
@@ -42,6 +42,8 @@ namespace Core {
 namespace Algorithms {
 namespace Math {
 
+  ALGORITHM_PARAMETER_DECL(NumberOfThreads);
+
 // Solve a linear system in parallel using a standard iterative method
 // Method solves A*x = b, with x0 being the initializer for the solution
 
@@ -61,6 +63,14 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0, 
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    // Solves A*X = B for every column of B at once. The cg and pipecg methods
+    // run a block CG that shares each pass over A between all columns; the
+    // other methods solve the columns one after another.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle B,
+             Datatypes::DenseMatrixHandle X0,
+             Datatypes::DenseMatrixHandle& X) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const;
 };
 
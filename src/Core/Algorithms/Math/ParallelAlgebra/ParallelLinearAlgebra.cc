@@ -59,15 +59,12 @@ ParallelLinearAlgebra::ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& da
   proc_(proc),
   nproc_(data.numProcs())
 {
-  // Compute local size
-  size_ = data.getSize();
-  local_size_ = size_/nproc_;
-
   // Compute start and end index for this thread
-  start_ = proc*local_size_;
-  end_   = (proc+1)*local_size_;
-  if (proc == nproc_-1) end_ = size_;
-  if (proc == nproc_-1) local_size_ = end_ - start_;
+  size_ = data.getSize();
+  auto range = partition(size_, proc, nproc_);
+  start_ = range.first;
+  end_   = range.second;
+  local_size_ = end_ - start_;
   local_size16_ = (local_size_&(~0xf));
 
   // Set reduction buffers
@@ -76,6 +73,15 @@ ParallelLinearAlgebra::ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& da
   reduce_[1] = data.reduceBuffer2();
 
   reduce_buffer_ = 0;
+  posted_buffer_ = 0;
+}
+
+std::pair<size_t, size_t> ParallelLinearAlgebra::partition(size_t size, int proc, int nproc)
+{
+  size_t local_size = size/nproc;
+  size_t start = proc*local_size;
+  size_t end = (proc == nproc-1) ? size : (proc+1)*local_size;
+  return std::make_pair(start, end);
 }
 
 void ParallelLinearAlgebra::wait()
@@ -143,6 +149,47 @@ bool ParallelLinearAlgebra::add_matrix(SparseRowMatrixHandle mat, ParallelMatrix
   return (true);
 }
 
+bool ParallelLinearAlgebra::add_block(DenseMatrixHandle mat, ParallelBlockVector& V)
+{
+  if (!mat) { return (false); }
+  if (mat->nrows() != size_) { return (false); }
+
+  V.data_ = mat->data();
+  V.size_ = size_;
+  V.cols_ = mat->ncols();
+
+  return true;
+}
+
+bool ParallelLinearAlgebra::new_block(size_t cols, ParallelBlockVector& V)
+{
+  wait();
+
+  data_.setSuccess(proc_);
+  if (proc_ == 0)
+  {
+    try
+    {
+      DenseMatrixHandle mat(boost::make_shared<DenseMatrix>(data_.getSize(), cols));
+      data_.addBlock(mat);
+    }
+    catch (...)
+    {
+      data_.setFail(0);
+    }
+  }
+
+  wait();
+
+  if (!data_.isSuccess(0))
+    return false;
+
+  auto mat = data_.getCurrentBlock();
+  wait();
+
+  return(add_block(mat,V));
+}
+
 /// @todo: refactor duplication
 
 void ParallelLinearAlgebra::mult(const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
@@ -625,30 +672,318 @@ double ParallelLinearAlgebra::absmax(const ParallelVector& a)
   return(reduce_max(m));
 }
 
+namespace
+{
+  // Four independent accumulators let the compiler overlap the gathered loads of a row
+  inline double sparse_row_dot(const double* data, const SCIRun::index_type* columns,
+                               SCIRun::index_type begin, SCIRun::index_type end, const double* x)
+  {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    SCIRun::index_type j = begin;
+    for (; j+4 <= end; j+=4)
+    {
+      s0 += data[j]*x[columns[j]];
+      s1 += data[j+1]*x[columns[j+1]];
+      s2 += data[j+2]*x[columns[j+2]];
+      s3 += data[j+3]*x[columns[j+3]];
+    }
+    for (; j < end; j++)
+      s0 += data[j]*x[columns[j]];
+    return (s0+s1)+(s2+s3);
+  }
+}
+
 void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
 {
   wait();
 
-  double* idata = b.data_;
+  const double* idata = b.data_;
   double* odata = r.data_;
 
-  double* data = a.data_;
+  const double* data = a.data_;
   auto rows = a.rows_;
   auto columns = a.columns_;
 
   for(size_t i=start_;i<end_;i++)
   {
-    double sum = 0.0;
-    index_type row_idx = rows[i];
-    index_type next_idx = rows[i+1];
-    for(index_type j=row_idx;j<next_idx;j++)
+    odata[i] = sparse_row_dot(data, columns, rows[i], rows[i+1], idata);
+  }
+}
+
+double ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r, const ParallelVector& c)
+{
+  wait();
+
+  const double* idata = b.data_;
+  const double* cdata = c.data_;
+  double* odata = r.data_;
+
+  const double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  double val = 0.0;
+  for(size_t i=start_;i<end_;i++)
+  {
+    double sum = sparse_row_dot(data, columns, rows[i], rows[i+1], idata);
+    odata[i] = sum;
+    val += sum*cdata[i];
+  }
+
+  return(reduce_sum(val));
+}
+
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  const double* a_ptr = a.data_+start_;
+  const double* b_ptr = b.data_+start_;
+  double* r_ptr = r.data_+start_;
+
+  double val = 0.0;
+  for (size_t j=0; j<local_size_; j++)
+  {
+    const double rj = s*a_ptr[j] + b_ptr[j];
+    r_ptr[j] = rj;
+    val += rj*rj;
+  }
+
+  return(sqrt(reduce_sum(val)));
+}
+
+void ParallelLinearAlgebra::scale_add_2(double s1, const ParallelVector& a1, ParallelVector& r1, double s2, const ParallelVector& a2, ParallelVector& r2)
+{
+  const double* a1_ptr = a1.data_+start_;
+  const double* a2_ptr = a2.data_+start_;
+  double* r1_ptr = r1.data_+start_;
+  double* r2_ptr = r2.data_+start_;
+
+  for (size_t j=0; j<local_size_; j++)
+  {
+    r1_ptr[j] += s1*a1_ptr[j];
+    r2_ptr[j] += s2*a2_ptr[j];
+  }
+}
+
+void ParallelLinearAlgebra::dot_2(const ParallelVector& a, const ParallelVector& b, const ParallelVector& c, const ParallelVector& d, double& ab, double& cd)
+{
+  const double* a_ptr = a.data_+start_;
+  const double* b_ptr = b.data_+start_;
+  const double* c_ptr = c.data_+start_;
+  const double* d_ptr = d.data_+start_;
+
+  double vals[2] = { 0.0, 0.0 };
+  for (size_t j=0; j<local_size_; j++)
+  {
+    vals[0] += a_ptr[j]*b_ptr[j];
+    vals[1] += c_ptr[j]*d_ptr[j];
+  }
+
+  double totals[2];
+  post_sums(vals, 2);
+  wait();
+  collect_sums(totals, 2);
+  ab = totals[0];
+  cd = totals[1];
+}
+
+void ParallelLinearAlgebra::pipelined_cg_update(double alpha, double beta, const ParallelVector& n, const ParallelVector& m,
+  ParallelVector& z, ParallelVector& q, ParallelVector& s, ParallelVector& p,
+  ParallelVector& x, ParallelVector& r, ParallelVector& u, ParallelVector& w, double* partials)
+{
+  double ru = 0.0, wu = 0.0, rr = 0.0;
+  for (size_t i=start_; i<end_; i++)
+  {
+    double zi = n.data_[i] + beta*z.data_[i];
+    double qi = m.data_[i] + beta*q.data_[i];
+    double si = w.data_[i] + beta*s.data_[i];
+    double pi = u.data_[i] + beta*p.data_[i];
+    z.data_[i] = zi;
+    q.data_[i] = qi;
+    s.data_[i] = si;
+    p.data_[i] = pi;
+
+    x.data_[i] += alpha*pi;
+    double ri = r.data_[i] - alpha*si;
+    double ui = u.data_[i] - alpha*qi;
+    double wi = w.data_[i] - alpha*zi;
+    r.data_[i] = ri;
+    u.data_[i] = ui;
+    w.data_[i] = wi;
+
+    ru += ri*ui;
+    wu += wi*ui;
+    rr += ri*ri;
+  }
+  partials[0] = ru;
+  partials[1] = wu;
+  partials[2] = rr;
+}
+
+void ParallelLinearAlgebra::pipelined_cg_sums(const ParallelVector& r, const ParallelVector& u, const ParallelVector& w, double* partials)
+{
+  double ru = 0.0, wu = 0.0, rr = 0.0;
+  for (size_t i=start_; i<end_; i++)
+  {
+    ru += r.data_[i]*u.data_[i];
+    wu += w.data_[i]*u.data_[i];
+    rr += r.data_[i]*r.data_[i];
+  }
+  partials[0] = ru;
+  partials[1] = wu;
+  partials[2] = rr;
+}
+
+void ParallelLinearAlgebra::copy(const ParallelBlockVector& a, ParallelBlockVector& r)
+{
+  const size_t k = a.cols_;
+  std::copy(a.data_+start_*k, a.data_+end_*k, r.data_+start_*k);
+}
+
+void ParallelLinearAlgebra::sub(const ParallelBlockVector& a, const ParallelBlockVector& b, ParallelBlockVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t j=start_*k; j<end_*k; j++)
+    r.data_[j] = a.data_[j] - b.data_[j];
+}
+
+void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelBlockVector& b, ParallelBlockVector& r)
+{
+  wait();
+
+  const size_t k = b.cols_;
+  const double* idata = b.data_;
+  const double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  for (size_t i=start_; i<end_; i++)
+  {
+    double* out = r.data_ + i*k;
+    std::fill(out, out+k, 0.0);
+    for (auto j=rows[i]; j<rows[i+1]; j++)
     {
-	    sum+=data[j]*idata[columns[j]];
+      const double v = data[j];
+      const double* in = idata + columns[j]*k;
+      for (size_t c=0; c<k; c++) out[c] += v*in[c];
     }
-    odata[i]=sum;
   }
 }
 
+void ParallelLinearAlgebra::mult_dots(const ParallelMatrix& a, const ParallelBlockVector& b, ParallelBlockVector& r, const ParallelBlockVector& c, double* dots)
+{
+  wait();
+
+  const size_t k = b.cols_;
+  const double* idata = b.data_;
+  const double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  std::vector<double> vals(k, 0.0);
+  for (size_t i=start_; i<end_; i++)
+  {
+    double* out = r.data_ + i*k;
+    std::fill(out, out+k, 0.0);
+    for (auto j=rows[i]; j<rows[i+1]; j++)
+    {
+      const double v = data[j];
+      const double* in = idata + columns[j]*k;
+      for (size_t col=0; col<k; col++) out[col] += v*in[col];
+    }
+    const double* c_row = c.data_ + i*k;
+    for (size_t col=0; col<k; col++) vals[col] += out[col]*c_row[col];
+  }
+
+  post_sums(&vals[0], static_cast<int>(k));
+  wait();
+  collect_sums(dots, static_cast<int>(k));
+}
+
+void ParallelLinearAlgebra::scale_add(const double* s, const ParallelBlockVector& a, const ParallelBlockVector& b, ParallelBlockVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_row = a.data_ + i*k;
+    const double* b_row = b.data_ + i*k;
+    double* r_row = r.data_ + i*k;
+    for (size_t c=0; c<k; c++) r_row[c] = s[c]*a_row[c] + b_row[c];
+  }
+}
+
+void ParallelLinearAlgebra::scale_add_2(const double* s1, const ParallelBlockVector& a1, ParallelBlockVector& r1,
+  const double* s2, const ParallelBlockVector& a2, ParallelBlockVector& r2)
+{
+  const size_t k = a1.cols_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a1_row = a1.data_ + i*k;
+    const double* a2_row = a2.data_ + i*k;
+    double* r1_row = r1.data_ + i*k;
+    double* r2_row = r2.data_ + i*k;
+    for (size_t c=0; c<k; c++)
+    {
+      r1_row[c] += s1[c]*a1_row[c];
+      r2_row[c] += s2[c]*a2_row[c];
+    }
+  }
+}
+
+void ParallelLinearAlgebra::dots_2(const ParallelBlockVector& a, const ParallelBlockVector& b, const ParallelBlockVector& c, const ParallelBlockVector& d, double* ab, double* cd)
+{
+  const size_t k = a.cols_;
+  std::vector<double> vals(2*k, 0.0);
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_row = a.data_ + i*k;
+    const double* b_row = b.data_ + i*k;
+    const double* c_row = c.data_ + i*k;
+    const double* d_row = d.data_ + i*k;
+    for (size_t col=0; col<k; col++)
+    {
+      vals[col] += a_row[col]*b_row[col];
+      vals[k+col] += c_row[col]*d_row[col];
+    }
+  }
+
+  std::vector<double> totals(2*k);
+  post_sums(&vals[0], static_cast<int>(2*k));
+  wait();
+  collect_sums(&totals[0], static_cast<int>(2*k));
+  std::copy(totals.begin(), totals.begin()+k, ab);
+  std::copy(totals.begin()+k, totals.end(), cd);
+}
+
+void ParallelLinearAlgebra::norms(const ParallelBlockVector& a, double* norms)
+{
+  const size_t k = a.cols_;
+  std::vector<double> vals(k, 0.0);
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_row = a.data_ + i*k;
+    for (size_t c=0; c<k; c++) vals[c] += a_row[c]*a_row[c];
+  }
+
+  post_sums(&vals[0], static_cast<int>(k));
+  wait();
+  collect_sums(norms, static_cast<int>(k));
+  for (size_t c=0; c<k; c++) norms[c] = sqrt(norms[c]);
+}
+
+void ParallelLinearAlgebra::get_column(const ParallelBlockVector& a, size_t j, ParallelVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t i=start_; i<end_; i++)
+    r.data_[i] = a.data_[i*k+j];
+}
+
+void ParallelLinearAlgebra::set_column(const ParallelVector& a, size_t j, ParallelBlockVector& r)
+{
+  const size_t k = r.cols_;
+  for (size_t i=start_; i<end_; i++)
+    r.data_[i*k+j] = a.data_[i];
+}
+
 void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
 {
   wait();
@@ -720,6 +1055,24 @@ void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
   }
 }
 
+void ParallelLinearAlgebra::post_sums(const double* vals, int count)
+{
+  double* buffer = reduce_[reduce_buffer_];
+  for (int k=0; k<count; k++) buffer[k*nproc_+proc_] = vals[k];
+  posted_buffer_ = reduce_buffer_;
+  reduce_buffer_ = 1 - reduce_buffer_;
+}
+
+void ParallelLinearAlgebra::collect_sums(double* totals, int count)
+{
+  const double* buffer = reduce_[posted_buffer_];
+  for (int k=0; k<count; k++)
+  {
+    double ret = 0.0; for (int j=0; j<nproc_; j++) ret += buffer[k*nproc_+j];
+    totals[k] = ret;
+  }
+}
+
 double ParallelLinearAlgebra::reduce_sum(double val)
 {
   int buffer = reduce_buffer_;
@@ -766,12 +1119,26 @@ double ParallelLinearAlgebra::reduce_min(double val)
 
 
 
+namespace
+{
+  bool rowsMatch(const SolverInputs& inputs, size_t size)
+  {
+    if (inputs.B)
+      return inputs.B->nrows() == size && inputs.X->nrows() == size && inputs.X0->nrows() == size
+        && inputs.X->ncols() == inputs.B->ncols() && inputs.X0->ncols() == inputs.B->ncols();
+    return inputs.b->nrows() == size && inputs.x->nrows() == size && inputs.x0->nrows() == size;
+  }
+}
+
+size_t SolverInputs::numRightHandSides() const
+{
+  return B ? B->ncols() : 1;
+}
+
 bool ParallelLinearAlgebraBase::start_parallel(SolverInputs& matrices, int nproc) const
 {
   size_t size = matrices.A->nrows();
-  if (matrices.b->nrows() != size
-    || matrices.x->nrows() != size
-    || matrices.x0->nrows() != size)
+  if (!rowsMatch(matrices, size))
     return false;
 
   /// Require a minimum of 50 variables per processor
@@ -805,11 +1172,10 @@ ParallelLinearAlgebraSharedData::ParallelLinearAlgebraSharedData(const SolverInp
   imatrices_(inputs),
   barrier_("Parallel Linear Algebra", numProcs),
   numProcs_(numProcs),
-  reduce1_(numProcs),
-  reduce2_(numProcs)
+  reduceWidth_(std::max(maxReduceWidth, 2*static_cast<int>(inputs.numRightHandSides()))),
+  reduce1_(numProcs*reduceWidth_),
+  reduce2_(numProcs*reduceWidth_)
 {
-  if (inputs.b->nrows() != size_
-    || inputs.x->nrows() != size_
-    || inputs.x0->nrows() != size_)
+  if (!rowsMatch(inputs, size_))
     BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Dimension mismatch")); /// @todo: use new DimensionMismatch exception type
 }
@@ -55,12 +55,23 @@ namespace Math {
     Datatypes::DenseColumnMatrixHandle x0;
     Datatypes::DenseColumnMatrixHandle x;
 
+    /// Block solves: one right-hand side per column of B, solved together
+    /// so that every pass over A serves all of them. Used instead of b, x0 and x.
+    Datatypes::DenseMatrixHandle B;
+    Datatypes::DenseMatrixHandle X0;
+    Datatypes::DenseMatrixHandle X;
+
+    size_t numRightHandSides() const;
+
     void clear()
     {
       A.reset();
       b.reset();
       x0.reset();
       x.reset();
+      B.reset();
+      X0.reset();
+      X.reset();
     }
   };
 
@@ -72,6 +83,8 @@ namespace Math {
     Datatypes::DenseColumnMatrixHandle getCurrentMatrix() const { return current_matrix_; }
     void setCurrentMatrix(Datatypes::DenseColumnMatrixHandle mat) { current_matrix_ = mat; }
     void addVector(Datatypes::DenseColumnMatrixHandle mat) { vectors_.push_back(mat); }
+    Datatypes::DenseMatrixHandle getCurrentBlock() const { return current_block_; }
+    void addBlock(Datatypes::DenseMatrixHandle mat) { current_block_ = mat; blocks_.push_back(mat); }
     void setFlag(size_t i, bool b) { success_[i] = b; }
     void setSuccess(size_t i) { success_[i] = true; }
     void setFail(size_t i) { success_[i] = false; } 
@@ -93,6 +106,10 @@ namespace Math {
 
     SolverInputs& inputs() { return imatrices_; }
 
+    /// Reduction buffers hold reduceWidth() slots of numProcs() partials each:
+    /// at least maxReduceWidth, and two per right-hand side for block solves.
+    static const int maxReduceWidth = 3;
+    int reduceWidth() const { return reduceWidth_; }
     double* reduceBuffer1() { return &reduce1_[0]; }
     double* reduceBuffer2() { return &reduce2_[0]; }
 
@@ -100,10 +117,13 @@ namespace Math {
     size_t size_;
     Datatypes::DenseColumnMatrixHandle current_matrix_;
     std::list<Datatypes::DenseColumnMatrixHandle> vectors_;
+    Datatypes::DenseMatrixHandle current_block_;
+    std::list<Datatypes::DenseMatrixHandle> blocks_;
     std::vector<bool> success_;
     SolverInputs imatrices_;
     SCIRun::Core::Thread::Barrier barrier_;
     int numProcs_;
+    int reduceWidth_;
     /// classes for communication
     std::vector<double> reduce1_;
     std::vector<double> reduce2_;
@@ -136,6 +156,15 @@ public:
       size_t size_;
   };
     
+  /// size_ rows of cols_ values, stored row by row so that a sparse
+  /// matrix entry multiplies all columns from one cache line.
+  class ParallelBlockVector {
+    public:
+      double* data_;
+      size_t size_;
+      size_t cols_;
+  };
+
   class ParallelMatrix {
     public:
       index_type* rows_;
@@ -153,6 +182,8 @@ public:
   bool add_vector(Datatypes::DenseColumnMatrixHandle mat, ParallelVector& V);
   bool new_vector(ParallelVector& V);
   bool add_matrix(Datatypes::SparseRowMatrixHandle mat, ParallelMatrix& M);
+  bool add_block(Datatypes::DenseMatrixHandle mat, ParallelBlockVector& V);
+  bool new_block(size_t cols, ParallelBlockVector& V);
 
   void mult(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
   void sub(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
@@ -184,13 +215,68 @@ public:
   double max(const ParallelVector& a);
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
-  
+
+  // Fused kernels: one pass over memory and at most one reduction each
+
+  // r = a*b, returns dot(r,c)
+  double mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r, const ParallelVector& c);
+  // r = s*a + b, returns norm(r)
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+  // r1 = s1*a1 + r1 and r2 = s2*a2 + r2
+  void scale_add_2(double s1, const ParallelVector& a1, ParallelVector& r1, double s2, const ParallelVector& a2, ParallelVector& r2);
+  // ab = dot(a,b) and cd = dot(c,d) with a single reduction
+  void dot_2(const ParallelVector& a, const ParallelVector& b, const ParallelVector& c, const ParallelVector& d, double& ab, double& cd);
+
+  // Pipelined CG recurrences (Ghysels & Vanroose 2014) in one pass over this thread's rows:
+  // z = n + beta*z, q = m + beta*q, s = w + beta*s, p = u + beta*p,
+  // x = x + alpha*p, r = r - alpha*s, u = u - alpha*q, w = w - alpha*z.
+  // partials receives this thread's share of dot(r,u), dot(w,u) and dot(r,r) for the updated vectors.
+  void pipelined_cg_update(double alpha, double beta, const ParallelVector& n, const ParallelVector& m,
+    ParallelVector& z, ParallelVector& q, ParallelVector& s, ParallelVector& p,
+    ParallelVector& x, ParallelVector& r, ParallelVector& u, ParallelVector& w, double* partials);
+  // This thread's share of dot(r,u), dot(w,u) and dot(r,r)
+  void pipelined_cg_sums(const ParallelVector& r, const ParallelVector& u, const ParallelVector& w, double* partials);
+
+  // Block kernels: every operation applies column by column, with per-column
+  // scalars and results, and at most one reduction for all columns.
+
+  void copy(const ParallelBlockVector& a, ParallelBlockVector& r);
+  void sub(const ParallelBlockVector& a, const ParallelBlockVector& b, ParallelBlockVector& r);
+  // r = a*b with one traversal of a for all columns of b
+  void mult(const ParallelMatrix& a, const ParallelBlockVector& b, ParallelBlockVector& r);
+  // r = a*b, dots[j] = dot(r_j,c_j)
+  void mult_dots(const ParallelMatrix& a, const ParallelBlockVector& b, ParallelBlockVector& r, const ParallelBlockVector& c, double* dots);
+  // r_j = s[j]*a_j + b_j
+  void scale_add(const double* s, const ParallelBlockVector& a, const ParallelBlockVector& b, ParallelBlockVector& r);
+  // r1_j = s1[j]*a1_j + r1_j and r2_j = s2[j]*a2_j + r2_j
+  void scale_add_2(const double* s1, const ParallelBlockVector& a1, ParallelBlockVector& r1,
+    const double* s2, const ParallelBlockVector& a2, ParallelBlockVector& r2);
+  // ab[j] = dot(a_j,b_j) and cd[j] = dot(c_j,d_j)
+  void dots_2(const ParallelBlockVector& a, const ParallelBlockVector& b, const ParallelBlockVector& c, const ParallelBlockVector& d, double* ab, double* cd);
+  void norms(const ParallelBlockVector& a, double* norms);
+  // Local rows of column j, so that vector operations such as preconditioners can be applied per column
+  void get_column(const ParallelBlockVector& a, size_t j, ParallelVector& r);
+  void set_column(const ParallelVector& a, size_t j, ParallelBlockVector& r);
+
+  // Split-phase sum reduction of up to ParallelLinearAlgebraSharedData::reduceWidth() values: post_sums() publishes this thread's
+  // partial sums and collect_sums() adds them up after the next barrier, such as the one that starts
+  // mult(ParallelMatrix...). Work placed in between overlaps the reduction instead of adding a barrier.
+  void post_sums(const double* vals, int count);
+  void collect_sums(double* totals, int count);
+
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
   
   void ones(ParallelVector& r);
     
   int  proc() { return proc_; }
   int  nproc() { return nproc_; }
+
+  /// Rows [start(), end()) of every vector are owned by this thread.
+  size_t start() const { return start_; }
+  size_t end() const { return end_; }
+
+  /// Row range owned by thread proc when size rows are split over nproc threads.
+  static std::pair<size_t, size_t> partition(size_t size, int proc, int nproc);
     
   bool first() { return proc_ == 0; }
   void wait();
@@ -213,6 +299,7 @@ private:
     
   double* reduce_[2];
   int     reduce_buffer_;
+  int     posted_buffer_;
 
  
 };
@@ -0,0 +1,711 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <boost/make_shared.hpp>
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+
+typedef ParallelLinearAlgebra::ParallelMatrix ParallelMatrix;
+typedef ParallelLinearAlgebra::ParallelVector ParallelVector;
+
+ParallelPreconditioner::~ParallelPreconditioner()
+{}
+
+namespace
+{
+  double diagonalEntry(const ParallelMatrix& A, size_t i)
+  {
+    for (index_type p = A.rows_[i]; p < A.rows_[i+1]; ++p)
+      if (A.columns_[p] == static_cast<index_type>(i))
+        return A.data_[p];
+    return 0.0;
+  }
+
+  void multRows(const ParallelMatrix& A, const double* x, double* y, size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      double sum = 0.0;
+      for (index_type p = A.rows_[i]; p < A.rows_[i+1]; ++p)
+        sum += A.data_[p]*x[A.columns_[p]];
+      y[i] = sum;
+    }
+  }
+
+  class IdentityPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    virtual bool setup(ParallelLinearAlgebra&, const ParallelMatrix&) override { return true; }
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      PLA.copy(r, z);
+    }
+  };
+
+  class JacobiPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    virtual bool setup(ParallelLinearAlgebra& PLA, const ParallelMatrix& A) override
+    {
+      // Owned here rather than by PLA, so a solver can keep it for its next run
+      if (PLA.first())
+      {
+        values_.resize(A.m_);
+        diag_.data_ = values_.data();
+        diag_.size_ = values_.size();
+      }
+      PLA.wait();
+
+      PLA.absdiag(A, diag_);
+      double max = PLA.max(diag_);
+      PLA.absthreshold_invert(diag_, diag_, 1e-18*max);
+      return true;
+    }
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      PLA.mult(r, diag_, z);
+    }
+
+  private:
+    std::vector<double> values_;
+    ParallelVector diag_;
+  };
+
+  /// Factorization of one thread's diagonal block [begin, end) of A, in CSR form with
+  /// block-local column indices.
+  struct BlockFactor
+  {
+    size_t begin, end;
+    std::vector<index_type> rows, columns, diag;
+    std::vector<double> values;
+
+    /// Copies the block's entries (only the lower triangle if lowerOnly), adding an explicit
+    /// zero where a row has no diagonal entry so every row has a pivot slot.
+    void extract(const ParallelMatrix& A, size_t rowBegin, size_t rowEnd, bool lowerOnly)
+    {
+      begin = rowBegin;
+      end = rowEnd;
+      const size_t n = end - begin;
+      rows.assign(1, 0);
+      rows.reserve(n+1);
+      diag.resize(n);
+      columns.clear();
+      values.clear();
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        const index_type row = static_cast<index_type>(begin + i);
+        bool haveDiag = false;
+        for (index_type p = A.rows_[row]; p < A.rows_[row+1]; ++p)
+        {
+          const index_type c = A.columns_[p];
+          if (c < static_cast<index_type>(begin) || c >= static_cast<index_type>(end))
+            continue;
+          if (lowerOnly && c > row)
+            break;
+          if (!haveDiag && c >= row)
+          {
+            diag[i] = columns.size();
+            haveDiag = true;
+            if (c > row)
+            {
+              columns.push_back(i);
+              values.push_back(0.0);
+            }
+          }
+          columns.push_back(c - begin);
+          values.push_back(A.data_[p]);
+        }
+        if (!haveDiag)
+        {
+          diag[i] = columns.size();
+          columns.push_back(i);
+          values.push_back(0.0);
+        }
+        rows.push_back(columns.size());
+      }
+    }
+  };
+
+  /// Replacement for a pivot that vanished during an incomplete factorization.
+  double safePivot(double original)
+  {
+    return original != 0.0 ? std::abs(original) : 1.0;
+  }
+
+  class BlockIncompleteCholeskyPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    virtual bool setup(ParallelLinearAlgebra& PLA, const ParallelMatrix& A) override
+    {
+      if (PLA.first())
+        blocks_.resize(PLA.nproc());
+      PLA.wait();
+
+      auto& L = blocks_[PLA.proc()];
+      L.extract(A, PLA.start(), PLA.end(), true);
+
+      const size_t n = L.end - L.begin;
+      std::vector<index_type> pos(n, -1);
+      for (size_t i = 0; i < n; ++i)
+      {
+        const index_type dpos = L.diag[i];
+        for (index_type p = L.rows[i]; p < dpos; ++p)
+          pos[L.columns[p]] = p;
+
+        double d = L.values[dpos];
+        for (index_type p = L.rows[i]; p < dpos; ++p)
+        {
+          const index_type k = L.columns[p];
+          double s = L.values[p];
+          for (index_type q = L.rows[k]; q < L.diag[k]; ++q)
+          {
+            const index_type j = pos[L.columns[q]];
+            if (j >= 0)
+              s -= L.values[j]*L.values[q];
+          }
+          L.values[p] = s / L.values[L.diag[k]];
+          d -= L.values[p]*L.values[p];
+        }
+
+        const double original = L.values[dpos];
+        if (!(d > 1e-12*std::abs(original)))
+          d = safePivot(original);
+        L.values[dpos] = std::sqrt(d);
+
+        for (index_type p = L.rows[i]; p < dpos; ++p)
+          pos[L.columns[p]] = -1;
+      }
+      PLA.wait();
+      return true;
+    }
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      const auto& L = blocks_[PLA.proc()];
+      const double* rb = r.data_ + L.begin;
+      double* zb = z.data_ + L.begin;
+      const index_type n = static_cast<index_type>(L.end - L.begin);
+
+      // L y = r
+      for (index_type i = 0; i < n; ++i)
+      {
+        double s = rb[i];
+        for (index_type p = L.rows[i]; p < L.diag[i]; ++p)
+          s -= L.values[p]*zb[L.columns[p]];
+        zb[i] = s / L.values[L.diag[i]];
+      }
+      // L^T z = y, column by column since L is stored by rows
+      for (index_type i = n-1; i >= 0; --i)
+      {
+        zb[i] /= L.values[L.diag[i]];
+        const double zi = zb[i];
+        for (index_type p = L.rows[i]; p < L.diag[i]; ++p)
+          zb[L.columns[p]] -= L.values[p]*zi;
+      }
+    }
+
+  private:
+    std::vector<BlockFactor> blocks_;
+  };
+
+  class BlockIncompleteLUPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    virtual bool setup(ParallelLinearAlgebra& PLA, const ParallelMatrix& A) override
+    {
+      if (PLA.first())
+        blocks_.resize(PLA.nproc());
+      PLA.wait();
+
+      auto& LU = blocks_[PLA.proc()];
+      LU.extract(A, PLA.start(), PLA.end(), false);
+
+      const size_t n = LU.end - LU.begin;
+      std::vector<index_type> pos(n, -1);
+      for (size_t i = 0; i < n; ++i)
+      {
+        const index_type rowEnd = LU.rows[i+1];
+        for (index_type p = LU.rows[i]; p < rowEnd; ++p)
+          pos[LU.columns[p]] = p;
+
+        const index_type dpos = LU.diag[i];
+        const double original = LU.values[dpos];
+        for (index_type p = LU.rows[i]; p < dpos; ++p)
+        {
+          const index_type k = LU.columns[p];
+          const double lik = LU.values[p] / LU.values[LU.diag[k]];
+          LU.values[p] = lik;
+          for (index_type q = LU.diag[k] + 1; q < LU.rows[k+1]; ++q)
+          {
+            const index_type j = pos[LU.columns[q]];
+            if (j >= 0)
+              LU.values[j] -= lik*LU.values[q];
+          }
+        }
+
+        if (!(std::abs(LU.values[dpos]) > 1e-12*std::abs(original)))
+          LU.values[dpos] = original != 0.0 ? original : 1.0;
+
+        for (index_type p = LU.rows[i]; p < rowEnd; ++p)
+          pos[LU.columns[p]] = -1;
+      }
+      PLA.wait();
+      return true;
+    }
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      const auto& LU = blocks_[PLA.proc()];
+      const double* rb = r.data_ + LU.begin;
+      double* zb = z.data_ + LU.begin;
+      const index_type n = static_cast<index_type>(LU.end - LU.begin);
+
+      // L y = r, L has a unit diagonal
+      for (index_type i = 0; i < n; ++i)
+      {
+        double s = rb[i];
+        for (index_type p = LU.rows[i]; p < LU.diag[i]; ++p)
+          s -= LU.values[p]*zb[LU.columns[p]];
+        zb[i] = s;
+      }
+      // U z = y
+      for (index_type i = n-1; i >= 0; --i)
+      {
+        double s = zb[i];
+        for (index_type p = LU.diag[i] + 1; p < LU.rows[i+1]; ++p)
+          s -= LU.values[p]*zb[LU.columns[p]];
+        zb[i] = s / LU.values[LU.diag[i]];
+      }
+    }
+
+    virtual void apply_trans(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      const auto& LU = blocks_[PLA.proc()];
+      const double* rb = r.data_ + LU.begin;
+      double* zb = z.data_ + LU.begin;
+      const index_type n = static_cast<index_type>(LU.end - LU.begin);
+
+      if (zb != rb)
+        std::copy(rb, rb + n, zb);
+      // U^T y = r, column by column
+      for (index_type i = 0; i < n; ++i)
+      {
+        zb[i] /= LU.values[LU.diag[i]];
+        const double zi = zb[i];
+        for (index_type p = LU.diag[i] + 1; p < LU.rows[i+1]; ++p)
+          zb[LU.columns[p]] -= LU.values[p]*zi;
+      }
+      // L^T z = y
+      for (index_type i = n-1; i >= 0; --i)
+      {
+        const double zi = zb[i];
+        for (index_type p = LU.rows[i]; p < LU.diag[i]; ++p)
+          zb[LU.columns[p]] -= LU.values[p]*zi;
+      }
+    }
+
+  private:
+    std::vector<BlockFactor> blocks_;
+  };
+
+  /// Smoothed aggregation (Vanek, Mandel & Brezina 1996) with a constant near-nullspace vector.
+  /// The hierarchy is built by the first thread; the V-cycle splits every level's rows over
+  /// all threads the same way ParallelLinearAlgebra splits the finest one.
+  class SmoothedAggregationPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    SmoothedAggregationPreconditioner() : ok_(false) {}
+
+    virtual bool setup(ParallelLinearAlgebra& PLA, const ParallelMatrix& A) override
+    {
+      if (PLA.first())
+      {
+        try
+        {
+          build(A);
+          ok_ = true;
+        }
+        catch (...)
+        {
+          levels_.clear();
+          ok_ = false;
+        }
+      }
+      PLA.wait();
+      return ok_;
+    }
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      auto& fine = levels_.front();
+      const size_t begin = PLA.start(), end = PLA.end();
+      std::copy(r.data_ + begin, r.data_ + end, fine.b.begin() + begin);
+      cycle(PLA, 0);
+      std::copy(fine.x.begin() + begin, fine.x.begin() + end, z.data_ + begin);
+    }
+
+  private:
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor, index_type> SparseMatrix;
+    typedef Eigen::Map<const SparseMatrix> SparseMap;
+
+    struct Level
+    {
+      SparseMatrix A;      // empty on the finest level, which uses the solver's matrix
+      SparseMatrix P, R;   // prolongation from and restriction to the next coarser level
+      ParallelMatrix Aview, Pview, Rview;
+      std::vector<double> weightedInvDiag, x, b, r;
+      size_t size() const { return x.size(); }
+    };
+
+    static const size_t coarsestSize = 256;
+    static const size_t maxLevels = 12;
+    static const int coarseSmoothingSweeps = 4;
+    // Drop tolerance of the strength-of-connection filter
+    static constexpr double strengthThreshold = 0.08;
+
+    std::vector<Level> levels_;
+    Eigen::SparseLU<Eigen::SparseMatrix<double>> coarseSolver_;
+    bool directCoarseSolve_;
+    bool ok_;
+
+    static ParallelMatrix view(SparseMatrix& M)
+    {
+      M.makeCompressed();
+      ParallelMatrix v;
+      v.rows_ = M.outerIndexPtr();
+      v.columns_ = M.innerIndexPtr();
+      v.data_ = M.valuePtr();
+      v.m_ = M.rows();
+      v.n_ = M.cols();
+      v.nnz_ = M.nonZeros();
+      return v;
+    }
+
+    /// Largest eigenvalue of D^-1 A by power iteration; slightly overestimated on purpose.
+    static double estimateSpectralRadius(const ParallelMatrix& A, const std::vector<double>& invDiag)
+    {
+      const size_t n = invDiag.size();
+      std::vector<double> v(n), w(n);
+      for (size_t i = 0; i < n; ++i)
+        v[i] = 1.0 + (i % 7);
+      double lambda = 1.0;
+      for (int iter = 0; iter < 15; ++iter)
+      {
+        double norm = 0.0;
+        for (size_t i = 0; i < n; ++i)
+          norm += v[i]*v[i];
+        norm = std::sqrt(norm);
+        if (norm == 0.0)
+          break;
+        for (size_t i = 0; i < n; ++i)
+          v[i] /= norm;
+        multRows(A, &v[0], &w[0], 0, n);
+        lambda = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+          w[i] *= invDiag[i];
+          lambda += v[i]*w[i];
+        }
+        v.swap(w);
+      }
+      return 1.1*std::abs(lambda);
+    }
+
+    /// Greedy three-pass aggregation of the strong-connection graph. Returns the number of
+    /// aggregates; rows without strong neighbours stay unaggregated (-1) and are left to the smoother.
+    static size_t aggregate(const ParallelMatrix& A, const std::vector<double>& diag, std::vector<index_type>& aggregates)
+    {
+      const size_t n = A.m_;
+      std::vector<index_type> strongRows(1, 0), strong;
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (index_type p = A.rows_[i]; p < A.rows_[i+1]; ++p)
+        {
+          const index_type j = A.columns_[p];
+          if (j != static_cast<index_type>(i) &&
+              std::abs(A.data_[p]) > strengthThreshold*std::sqrt(std::abs(diag[i]*diag[j])))
+            strong.push_back(j);
+        }
+        strongRows.push_back(strong.size());
+      }
+
+      const index_type unvisited = -2, isolated = -1;
+      aggregates.assign(n, unvisited);
+      index_type count = 0;
+
+      // Pass 1: a row whose strong neighbours are all free seeds an aggregate with them
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (aggregates[i] != unvisited)
+          continue;
+        if (strongRows[i] == strongRows[i+1])
+        {
+          aggregates[i] = isolated;
+          continue;
+        }
+        bool free = true;
+        for (index_type p = strongRows[i]; p < strongRows[i+1] && free; ++p)
+          free = aggregates[strong[p]] == unvisited;
+        if (!free)
+          continue;
+        aggregates[i] = count;
+        for (index_type p = strongRows[i]; p < strongRows[i+1]; ++p)
+          aggregates[strong[p]] = count;
+        ++count;
+      }
+
+      // Pass 2: attach leftovers to a neighbouring aggregate from pass 1
+      std::vector<index_type> seeded(aggregates);
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (aggregates[i] != unvisited)
+          continue;
+        for (index_type p = strongRows[i]; p < strongRows[i+1]; ++p)
+        {
+          if (seeded[strong[p]] >= 0)
+          {
+            aggregates[i] = seeded[strong[p]];
+            break;
+          }
+        }
+      }
+
+      // Pass 3: whatever is still free forms new aggregates with its free neighbours
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (aggregates[i] != unvisited)
+          continue;
+        aggregates[i] = count;
+        for (index_type p = strongRows[i]; p < strongRows[i+1]; ++p)
+          if (aggregates[strong[p]] == unvisited)
+            aggregates[strong[p]] = count;
+        ++count;
+      }
+      return count;
+    }
+
+    template <class Matrix>
+    static void coarsen(const Matrix& A, const ParallelMatrix& view, Level& level, SparseMatrix& coarse)
+    {
+      const size_t n = view.m_;
+      std::vector<double> diag(n), invDiag(n);
+      for (size_t i = 0; i < n; ++i)
+      {
+        diag[i] = diagonalEntry(view, i);
+        invDiag[i] = diag[i] != 0.0 ? 1.0/diag[i] : 0.0;
+      }
+      const double omega = (4.0/3.0) / estimateSpectralRadius(view, invDiag);
+
+      level.weightedInvDiag.resize(n);
+      for (size_t i = 0; i < n; ++i)
+        level.weightedInvDiag[i] = omega*invDiag[i];
+
+      std::vector<index_type> aggregates;
+      const size_t numAggregates = aggregate(view, diag, aggregates);
+      if (numAggregates == 0 || numAggregates >= n)
+        return;
+
+      // Tentative prolongator: one orthonormal column per aggregate
+      std::vector<double> aggregateSize(numAggregates, 0.0);
+      for (size_t i = 0; i < n; ++i)
+        if (aggregates[i] >= 0)
+          aggregateSize[aggregates[i]] += 1.0;
+      std::vector<Eigen::Triplet<double, index_type>> entries;
+      entries.reserve(n);
+      for (size_t i = 0; i < n; ++i)
+        if (aggregates[i] >= 0)
+          entries.emplace_back(i, aggregates[i], 1.0/std::sqrt(aggregateSize[aggregates[i]]));
+      SparseMatrix T(n, numAggregates);
+      T.setFromTriplets(entries.begin(), entries.end());
+
+      // P = (I - omega D^-1 A) T
+      Eigen::VectorXd scale(n);
+      for (size_t i = 0; i < n; ++i)
+        scale[i] = level.weightedInvDiag[i];
+      SparseMatrix AT = A*T;
+      level.P = T - scale.asDiagonal()*AT;
+      level.R = level.P.transpose();
+      SparseMatrix RA = level.R*A;
+      coarse = RA*level.P;
+    }
+
+    void build(const ParallelMatrix& A)
+    {
+      levels_.clear();
+      levels_.reserve(maxLevels);
+      directCoarseSolve_ = false;
+
+      levels_.emplace_back();
+      levels_.back().Aview = A;
+      SparseMap fine(A.m_, A.n_, A.nnz_, A.rows_, A.columns_, A.data_);
+
+      while (levels_.size() < maxLevels)
+      {
+        auto& level = levels_.back();
+        const auto current = level.Aview;
+        if (current.m_ <= coarsestSize)
+          break;
+
+        SparseMatrix coarse;
+        if (levels_.size() == 1)
+          coarsen(fine, current, level, coarse);
+        else
+          coarsen(level.A, current, level, coarse);
+        if (coarse.rows() == 0)
+          break;
+
+        level.Pview = view(level.P);
+        level.Rview = view(level.R);
+        levels_.emplace_back();
+        levels_.back().A.swap(coarse);
+        levels_.back().Aview = view(levels_.back().A);
+      }
+
+      for (auto& level : levels_)
+      {
+        const size_t n = level.Aview.m_;
+        level.x.assign(n, 0.0);
+        level.b.assign(n, 0.0);
+        level.r.assign(n, 0.0);
+      }
+
+      auto& coarsest = levels_.back();
+      if (coarsest.size() <= coarsestSize)
+      {
+        Eigen::SparseMatrix<double> M = levels_.size() == 1
+          ? Eigen::SparseMatrix<double>(fine)
+          : Eigen::SparseMatrix<double>(coarsest.A);
+        coarseSolver_.compute(M);
+        directCoarseSolve_ = coarseSolver_.info() == Eigen::Success;
+      }
+      if (!directCoarseSolve_ && coarsest.weightedInvDiag.empty())
+      {
+        std::vector<double> invDiag(coarsest.size());
+        for (size_t i = 0; i < invDiag.size(); ++i)
+        {
+          const double d = diagonalEntry(coarsest.Aview, i);
+          invDiag[i] = d != 0.0 ? 1.0/d : 0.0;
+        }
+        const double omega = (4.0/3.0) / estimateSpectralRadius(coarsest.Aview, invDiag);
+        coarsest.weightedInvDiag.resize(invDiag.size());
+        for (size_t i = 0; i < invDiag.size(); ++i)
+          coarsest.weightedInvDiag[i] = omega*invDiag[i];
+      }
+    }
+
+    /// One damped Jacobi sweep x += w D^-1 (b - A x) on this thread's rows.
+    static void smooth(ParallelLinearAlgebra& PLA, Level& level, size_t begin, size_t end)
+    {
+      PLA.wait();
+      multRows(level.Aview, &level.x[0], &level.r[0], begin, end);
+      PLA.wait();
+      for (size_t i = begin; i < end; ++i)
+        level.x[i] += level.weightedInvDiag[i]*(level.b[i] - level.r[i]);
+    }
+
+    void cycle(ParallelLinearAlgebra& PLA, size_t l)
+    {
+      auto& level = levels_[l];
+      const auto range = ParallelLinearAlgebra::partition(level.size(), PLA.proc(), PLA.nproc());
+      const size_t begin = range.first, end = range.second;
+
+      if (l + 1 == levels_.size())
+      {
+        if (directCoarseSolve_)
+        {
+          PLA.wait();
+          if (PLA.first())
+          {
+            Eigen::Map<Eigen::VectorXd> b(&level.b[0], level.size()), x(&level.x[0], level.size());
+            x = coarseSolver_.solve(b);
+          }
+          PLA.wait();
+        }
+        else
+        {
+          for (size_t i = begin; i < end; ++i)
+            level.x[i] = level.weightedInvDiag[i]*level.b[i];
+          for (int sweep = 1; sweep < coarseSmoothingSweeps; ++sweep)
+            smooth(PLA, level, begin, end);
+        }
+        return;
+      }
+
+      // Pre-smoothing from a zero initial guess
+      for (size_t i = begin; i < end; ++i)
+        level.x[i] = level.weightedInvDiag[i]*level.b[i];
+
+      PLA.wait();
+      multRows(level.Aview, &level.x[0], &level.r[0], begin, end);
+      for (size_t i = begin; i < end; ++i)
+        level.r[i] = level.b[i] - level.r[i];
+
+      auto& coarse = levels_[l+1];
+      const auto coarseRange = ParallelLinearAlgebra::partition(coarse.size(), PLA.proc(), PLA.nproc());
+      PLA.wait();
+      multRows(level.Rview, &level.r[0], &coarse.b[0], coarseRange.first, coarseRange.second);
+
+      cycle(PLA, l+1);
+
+      PLA.wait();
+      multRows(level.Pview, &coarse.x[0], &level.r[0], begin, end);
+      for (size_t i = begin; i < end; ++i)
+        level.x[i] += level.r[i];
+
+      smooth(PLA, level, begin, end);
+    }
+  };
+}
+
+ParallelPreconditionerHandle SCIRun::Core::Algorithms::Math::makeParallelPreconditioner(const std::string& name)
+{
+  if (name == "None")
+    return boost::make_shared<IdentityPreconditioner>();
+  if (name == "Jacobi")
+    return boost::make_shared<JacobiPreconditioner>();
+  if (name == "IC0")
+    return boost::make_shared<BlockIncompleteCholeskyPreconditioner>();
+  if (name == "ILU0")
+    return boost::make_shared<BlockIncompleteLUPreconditioner>();
+  if (name == "AMG")
+    return boost::make_shared<SmoothedAggregationPreconditioner>();
+
+  BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Unknown preconditioner: " + name));
+}
@@ -0,0 +1,75 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Preconditioner for the solvers built on ParallelLinearAlgebra. setup() and apply() are
+  /// collective: every solver thread calls them with its own PLA, in the same order. apply()
+  /// only reads and writes the rows of r and z owned by the calling thread, so z may alias r.
+  class SCISHARE ParallelPreconditioner : boost::noncopyable
+  {
+  public:
+    virtual ~ParallelPreconditioner();
+
+    /// Returns the same value on every thread. The result must not live in vectors allocated
+    /// from PLA: a solver reuses it in later runs with the same matrix and thread count.
+    virtual bool setup(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelMatrix& A) = 0;
+
+    /// z = M^-1 r
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) = 0;
+
+    /// z = M^-T r, used by BiCG for the shadow residual. Symmetric preconditioners need not override.
+    virtual void apply_trans(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z)
+    {
+      apply(PLA, r, z);
+    }
+  };
+
+  typedef boost::shared_ptr<ParallelPreconditioner> ParallelPreconditionerHandle;
+
+  /// name is one of the SolveLinearSystemAlgo Preconditioner options: None|Jacobi|IC0|ILU0|AMG.
+  /// IC0 and ILU0 factor the diagonal block of each thread's rows, so setup and the triangular
+  /// solves run without synchronization. AMG builds a smoothed-aggregation hierarchy and applies
+  /// one V(1,1) cycle with damped Jacobi smoothing, which keeps it symmetric for CG and MINRES.
+  SCISHARE ParallelPreconditionerHandle makeParallelPreconditioner(const std::string& name);
+
+}}}}
+
+#endif
@@ -976,3 +976,170 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+TEST(ParallelArithmeticTests, CanMultiplyMatrixByVectorAndDotInOnePass)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1;
+  auto vec1 = vector1();
+  pla.add_vector(vec1, v1);
+
+  ParallelLinearAlgebra::ParallelVector v2;
+  auto vec2 = vector2();
+  pla.add_vector(vec2, v2);
+
+  ParallelLinearAlgebra::ParallelVector v3;
+  auto vec3 = vector3();
+  pla.add_vector(vec3, v3);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  auto mat1 = matrix1();
+  pla.add_matrix(mat1, m1);
+
+  double d = pla.mult_dot(m1,v1,v2,v3);
+
+  EXPECT_EQ(1,v2.data_[0]);
+  EXPECT_EQ(-4,v2.data_[1]);
+  EXPECT_EQ(-2,v2.data_[size-1]);
+  EXPECT_EQ(pla.dot(v2,v3), d);
+  EXPECT_EQ(-4 + 14, d);
+}
+
+TEST(ParallelArithmeticTests, CanScaleAddTwoVectorPairsInOnePass)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1, v2, v3, v4;
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vec3 = vector3();
+  auto vec4 = vector1();
+  pla.add_vector(vec1, v1);
+  pla.add_vector(vec2, v2);
+  pla.add_vector(vec3, v3);
+  pla.add_vector(vec4, v4);
+
+  pla.scale_add_2(2, v1, v2, -1, v3, v4);
+
+  EXPECT_EQ(1, v2.data_[0]);
+  EXPECT_EQ(2, v2.data_[1]);
+  EXPECT_EQ(-300, v2.data_[300]);
+  EXPECT_EQ(-1, v2.data_[size-1]);
+  EXPECT_EQ(1, v4.data_[0]);
+  EXPECT_EQ(1, v4.data_[1]);
+  EXPECT_EQ(6, v4.data_[size-1]);
+}
+
+TEST(ParallelArithmeticTests, CanScaleAddAndComputeNormInOnePass)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1, v3;
+  auto vec1 = vector1();
+  auto vec3 = vector3();
+  pla.add_vector(vec1, v1);
+  pla.add_vector(vec3, v3);
+
+  double norm = pla.scale_add_norm(-1, v1, v3, v3);
+
+  EXPECT_EQ(-1, v3.data_[0]);
+  EXPECT_EQ(-1, v3.data_[1]);
+  EXPECT_EQ(-4, v3.data_[2]);
+  EXPECT_EQ(-6, v3.data_[size-1]);
+  EXPECT_DOUBLE_EQ(sqrt(54.0), norm);
+}
+
+TEST(ParallelArithmeticTests, CanComputeTwoDotProductsWithOneReduction)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1, v2, v3;
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vec3 = vector3();
+  pla.add_vector(vec1, v1);
+  pla.add_vector(vec2, v2);
+  pla.add_vector(vec3, v3);
+
+  double v12, v23;
+  pla.dot_2(v1, v2, v2, v3, v12, v23);
+
+  EXPECT_EQ(-22, v12);
+  EXPECT_EQ(-9, v23);
+}
+
+namespace
+{
+  // Columns are vector1() and vector2()
+  DenseMatrixHandle block1()
+  {
+    DenseMatrixHandle m(boost::make_shared<DenseMatrix>(size, 2));
+    m->col(0) = *vector1();
+    m->col(1) = *vector2();
+    return m;
+  }
+
+  SolverInputs getDummyBlockSystem()
+  {
+    SolverInputs system;
+    system.A = matrix1();
+    system.B = block1();
+    system.X = block1();
+    system.X0 = block1();
+    return system;
+  }
+}
+
+TEST(ParallelArithmeticTests, CanMultiplyMatrixByBlockOfVectorsInOnePass)
+{
+  ParallelLinearAlgebraSharedData data(getDummyBlockSystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  auto mat1 = matrix1();
+  pla.add_matrix(mat1, m1);
+
+  ParallelLinearAlgebra::ParallelBlockVector b, r;
+  auto blk = block1();
+  EXPECT_TRUE(pla.add_block(blk, b));
+  EXPECT_TRUE(pla.new_block(2, r));
+  EXPECT_EQ(2, r.cols_);
+
+  double dots[2];
+  pla.mult_dots(m1, b, r, b, dots);
+
+  ParallelLinearAlgebra::ParallelVector v1, v2, r1, r2;
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  pla.add_vector(vec1, v1);
+  pla.add_vector(vec2, v2);
+  pla.new_vector(r1);
+  pla.new_vector(r2);
+  pla.mult(m1, v1, r1);
+  pla.mult(m1, v2, r2);
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(r1.data_[i], r.data_[2*i]);
+    EXPECT_EQ(r2.data_[i], r.data_[2*i+1]);
+  }
+  EXPECT_EQ(pla.dot(r1, v1), dots[0]);
+  EXPECT_EQ(pla.dot(r2, v2), dots[1]);
+
+  double ab[2], cd[2];
+  pla.dots_2(b, b, r, b, ab, cd);
+  EXPECT_EQ(pla.dot(v1, v1), ab[0]);
+  EXPECT_EQ(pla.dot(v2, v2), ab[1]);
+  EXPECT_EQ(dots[0], cd[0]);
+  EXPECT_EQ(dots[1], cd[1]);
+
+  ParallelLinearAlgebra::ParallelVector column;
+  pla.new_vector(column);
+  pla.get_column(b, 1, column);
+  EXPECT_EQ(-300, column.data_[300]);
+}
@@ -29,6 +29,7 @@
 #include <Testing/Utils/SCIRunUnitTests.h>
 
 #include <fstream>
+#include <cmath>
 #include <boost/filesystem.hpp>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
@@ -40,6 +41,7 @@
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/MatrixIO.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 
 using namespace SCIRun::Core::Datatypes;
@@ -147,3 +149,253 @@ TEST(SolveLinearSystemTests, DISABLED_CanSolveDarrell_MINRES)
   double solutionError = 2.4;
   CanSolveDarrellWithMethod("minres", solutionError);
 }
+
+namespace
+{
+  // 5-point Laplacian on an n x n grid with Dirichlet boundary
+  SparseRowMatrixHandle laplacian2D(int n)
+  {
+    std::vector<SparseRowMatrix::Triplet> entries;
+    for (int i = 0; i < n; ++i)
+    {
+      for (int j = 0; j < n; ++j)
+      {
+        const int row = i*n + j;
+        entries.emplace_back(row, row, 4.0);
+        if (i > 0) entries.emplace_back(row, row - n, -1.0);
+        if (i < n-1) entries.emplace_back(row, row + n, -1.0);
+        if (j > 0) entries.emplace_back(row, row - 1, -1.0);
+        if (j < n-1) entries.emplace_back(row, row + 1, -1.0);
+      }
+    }
+    auto A = boost::make_shared<SparseRowMatrix>(n*n, n*n);
+    A->setFromTriplets(entries.begin(), entries.end());
+    return A;
+  }
+
+  double relativeResidual(const SparseRowMatrix& A, const DenseColumnMatrix& b, const DenseColumnMatrix& x)
+  {
+    DenseColumnMatrix r = b - A*x;
+    return r.norm() / b.norm();
+  }
+
+  double solveLaplacian(const std::string& method, const std::string& preconditioner, int maxIterations, double targetError,
+    int numThreads = 0)
+  {
+    auto A = laplacian2D(64);
+    auto b = boost::make_shared<DenseColumnMatrix>(A->nrows());
+    for (size_t i = 0; i < b->nrows(); ++i)
+      (*b)[i] = 1.0 + (i % 5);
+
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, maxIterations);
+    algo.set(Variables::TargetError, targetError);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.set(Parameters::NumberOfThreads, numThreads);
+    algo.setUpdaterFunc([](double x) {});
+
+    DenseColumnMatrixHandle x;
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    return relativeResidual(*A, *b, *x);
+  }
+}
+
+TEST(SolveLinearSystemTests, PreconditionedSolversConvergeOnLaplacian)
+{
+  for (const auto& method : { "cg", "pipecg", "bicg", "minres" })
+  {
+    for (const auto& preconditioner : { "None", "Jacobi", "IC0", "ILU0", "AMG" })
+    {
+      // MINRES needs a symmetric preconditioner
+      if (std::string(method) == "minres" && std::string(preconditioner) == "ILU0")
+        continue;
+      EXPECT_LT(solveLaplacian(method, preconditioner, 2000, 1e-8), 1e-6) << method << " with " << preconditioner;
+    }
+  }
+}
+
+TEST(SolveLinearSystemTests, StrongerPreconditionersReduceResidualFaster)
+{
+  const int iterations = 25;
+  double jacobi = solveLaplacian("cg", "Jacobi", iterations, 1e-14);
+  double ic0 = solveLaplacian("cg", "IC0", iterations, 1e-14);
+  double amg = solveLaplacian("cg", "AMG", iterations, 1e-14);
+
+  EXPECT_LT(ic0, jacobi);
+  EXPECT_LT(amg, ic0);
+  EXPECT_LT(amg, 1e-6);
+}
+
+TEST(SolveLinearSystemTests, PipelinedCGMatchesCG)
+{
+  for (const auto& preconditioner : { "None", "Jacobi", "IC0", "AMG" })
+  {
+    double cg = solveLaplacian("cg", preconditioner, 15, 1e-14);
+    double pipelined = solveLaplacian("pipecg", preconditioner, 15, 1e-14);
+    EXPECT_NEAR(1.0, pipelined/cg, 0.05) << preconditioner;
+  }
+}
+
+TEST(SolveLinearSystemTests, PipelinedCGMatchesCGOnSeveralThreads)
+{
+  for (int threads : { 2, 3 })
+  {
+    for (const auto& preconditioner : { "None", "Jacobi", "IC0", "AMG" })
+    {
+      double cg = solveLaplacian("cg", preconditioner, 15, 1e-14, threads);
+      double pipelined = solveLaplacian("pipecg", preconditioner, 15, 1e-14, threads);
+      ASSERT_TRUE(std::isfinite(pipelined)) << preconditioner << " on " << threads << " threads";
+      EXPECT_NEAR(1.0, pipelined/cg, 0.05) << preconditioner << " on " << threads << " threads";
+    }
+  }
+}
+
+TEST(SolveLinearSystemTests, BlockSolveMatchesColumnSolves)
+{
+  auto A = laplacian2D(32);
+  const int columns = 4;
+  auto B = boost::make_shared<DenseMatrix>(A->nrows(), columns);
+  for (size_t i = 0; i < B->nrows(); ++i)
+  {
+    (*B)(i, 0) = 1.0;
+    (*B)(i, 1) = 1.0 + (i % 5);
+    (*B)(i, 2) = (i % 7) - 3.0;
+    (*B)(i, 3) = 0.0;
+  }
+
+  for (const auto& method : { "cg", "bicg" })
+  {
+    for (const auto& preconditioner : { "Jacobi", "AMG" })
+    {
+      SolveLinearSystemAlgo algo;
+      algo.set(Variables::MaxIterations, 2000);
+      algo.set(Variables::TargetError, 1e-10);
+      algo.setOption(Variables::Method, method);
+      algo.setOption(Variables::Preconditioner, preconditioner);
+      algo.setUpdaterFunc([](double x) {});
+
+      DenseMatrixHandle X;
+      ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X));
+      ASSERT_EQ(columns, X->ncols());
+
+      for (int j = 0; j < columns; ++j)
+      {
+        auto b = boost::make_shared<DenseColumnMatrix>(B->col(j));
+        DenseColumnMatrixHandle x;
+        ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+        DenseColumnMatrix fromBlock(X->col(j));
+        EXPECT_NEAR(0.0, (fromBlock - *x).norm(), 1e-7 * (1.0 + x->norm())) << method << " with " << preconditioner << ", column " << j;
+      }
+      EXPECT_EQ(0.0, X->col(3).norm());
+    }
+  }
+}
+
+TEST(SolveLinearSystemTests, SolvesRightHandSideColumnsFromAlgorithmInput)
+{
+  auto A = laplacian2D(16);
+  auto B = boost::make_shared<DenseMatrix>(A->nrows(), 2);
+  for (size_t i = 0; i < B->nrows(); ++i)
+  {
+    (*B)(i, 0) = 1.0 + (i % 3);
+    (*B)(i, 1) = 0.0;
+  }
+
+  // These methods have no block variant and solve the columns one at a time
+  for (const auto& method : { "bicg", "minres" })
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 2000);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, "Jacobi");
+    algo.setUpdaterFunc([](double x) {});
+
+    AlgorithmInput input;
+    input[Variables::LHS] = A;
+    input[Variables::RHS] = B;
+    auto X = algo.run(input).get<DenseMatrix>(Variables::Solution);
+    ASSERT_TRUE(X != nullptr) << method;
+    ASSERT_EQ(2, X->ncols());
+
+    DenseColumnMatrix b(B->col(0)), x(X->col(0));
+    EXPECT_LT(relativeResidual(*A, b, x), 1e-6) << method;
+    EXPECT_EQ(0.0, X->col(1).norm()) << method;
+  }
+}
+
+TEST(SolveLinearSystemTests, MINRESRejectsILU0)
+{
+  auto A = laplacian2D(8);
+  auto b = boost::make_shared<DenseColumnMatrix>(A->nrows());
+  b->setOnes();
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "minres");
+  algo.setOption(Variables::Preconditioner, "ILU0");
+  algo.setUpdaterFunc([](double x) {});
+
+  DenseColumnMatrixHandle x;
+  EXPECT_THROW(algo.run(A, b, DenseColumnMatrixHandle(), x), AlgorithmInputException);
+
+  auto B = boost::make_shared<DenseMatrix>(DenseMatrix::Ones(A->nrows(), 2));
+  DenseMatrixHandle X;
+  EXPECT_THROW(algo.run(A, B, DenseMatrixHandle(), X), AlgorithmInputException);
+}
+
+namespace
+{
+  class SetupCounter : public Core::Logging::LegacyLoggerInterface
+  {
+  public:
+    SetupCounter() : setups(0) {}
+    virtual void error(const std::string&) const override {}
+    virtual void warning(const std::string&) const override {}
+    virtual void remark(const std::string& msg) const override
+    {
+      if (msg.find("setup took") != std::string::npos)
+        ++setups;
+    }
+    virtual void status(const std::string&) const override {}
+    mutable int setups;
+  };
+}
+
+TEST(SolveLinearSystemTests, ColumnSolvesShareOnePreconditionerSetup)
+{
+  auto A = laplacian2D(32);
+  auto B = boost::make_shared<DenseMatrix>(A->nrows(), 3);
+  for (size_t i = 0; i < B->nrows(); ++i)
+  {
+    (*B)(i, 0) = 1.0;
+    (*B)(i, 1) = 1.0 + (i % 3);
+    (*B)(i, 2) = (i % 7) - 3.0;
+  }
+
+  for (const auto& method : { "bicg", "minres" })
+  {
+    for (const auto& preconditioner : { "Jacobi", "IC0", "AMG" })
+    {
+      SolveLinearSystemAlgo algo;
+      auto counter = boost::make_shared<SetupCounter>();
+      algo.setLogger(counter);
+      algo.set(Variables::MaxIterations, 2000);
+      algo.set(Variables::TargetError, 1e-10);
+      algo.setOption(Variables::Method, method);
+      algo.setOption(Variables::Preconditioner, preconditioner);
+      algo.set(Parameters::NumberOfThreads, 2);
+      algo.setUpdaterFunc([](double x) {});
+
+      DenseMatrixHandle X;
+      ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X));
+      EXPECT_EQ(1, counter->setups) << method << " with " << preconditioner;
+
+      for (size_t j = 0; j < B->ncols(); ++j)
+      {
+        DenseColumnMatrix b(B->col(j)), x(X->col(j));
+        EXPECT_LT(relativeResidual(*A, b, x), 1e-6) << method << " with " << preconditioner << ", column " << j;
+      }
+    }
+  }
+}
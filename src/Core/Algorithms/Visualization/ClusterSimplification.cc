@@ -0,0 +1,191 @@
+/*
+For more information, please see: http://software.sci.utah.edu
+
+The MIT License
+
+Copyright (c) 2015 Scientific Computing and Imaging Institute,
+University of Utah.
+
+License for the specific language governing rights and limitations under
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Visualization/ClusterSimplification.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+
+using namespace SCIRun::Core::Algorithms::Visualization;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const int CellBits = 21;
+
+  uint64_t packCell(uint64_t x, uint64_t y, uint64_t z)
+  {
+    return x | (y << CellBits) | (z << (2 * CellBits));
+  }
+
+  uint64_t coarsenCell(uint64_t cell, int shift)
+  {
+    const uint64_t mask = (uint64_t(1) << CellBits) - 1;
+    return packCell((cell & mask) >> shift, ((cell >> CellBits) & mask) >> shift,
+      ((cell >> (2 * CellBits)) & mask) >> shift);
+  }
+}
+
+std::vector<ClusterLevel> SCIRun::Core::Algorithms::Visualization::buildClusterLevels(
+  const float* positions, size_t numVertices, const uint32_t* indices, size_t numIndices,
+  size_t finestResolution, size_t coarsestResolution)
+{
+  std::vector<ClusterLevel> levels;
+  const size_t numTriangles = numIndices / 3;
+  finestResolution = std::min(finestResolution, size_t(1) << CellBits);
+  if (numVertices == 0 || numTriangles == 0 || finestResolution == 0)
+    return levels;
+
+  float lo[3], hi[3];
+  for (int k = 0; k < 3; ++k)
+    lo[k] = hi[k] = positions[k];
+  for (size_t v = 1; v < numVertices; ++v)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      lo[k] = std::min(lo[k], positions[3 * v + k]);
+      hi[k] = std::max(hi[k], positions[3 * v + k]);
+    }
+  }
+  float extent = std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+  if (extent <= 0.0f)
+    extent = 1.0f;
+
+  // Cells of the finest grid; the coarser grids drop low bits, so the levels nest.
+  std::vector<uint64_t> fineCells(numVertices);
+  Parallel::For(0, numVertices, [&](size_t first, size_t last)
+  {
+    const float scale = finestResolution / extent;
+    for (size_t v = first; v < last; ++v)
+    {
+      uint64_t c[3];
+      for (int k = 0; k < 3; ++k)
+      {
+        float f = (positions[3 * v + k] - lo[k]) * scale;
+        c[k] = std::min(static_cast<uint64_t>(std::max(f, 0.0f)), static_cast<uint64_t>(finestResolution - 1));
+      }
+      fineCells[v] = packCell(c[0], c[1], c[2]);
+    }
+  });
+
+  size_t previousTriangles = numTriangles;
+  for (int shift = 0; (finestResolution >> shift) >= std::max<size_t>(coarsestResolution, 1); ++shift)
+  {
+    std::vector<std::pair<uint64_t, uint32_t>> keyed(numVertices);
+    Parallel::For(0, numVertices, [&](size_t first, size_t last)
+    {
+      for (size_t v = first; v < last; ++v)
+        keyed[v] = std::make_pair(coarsenCell(fineCells[v], shift), static_cast<uint32_t>(v));
+    });
+    Parallel::Sort(keyed.begin(), keyed.end());
+
+    std::vector<size_t> clusterStarts;
+    std::vector<uint32_t> clusterOf(numVertices);
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+      if (i == 0 || keyed[i].first != keyed[i - 1].first)
+        clusterStarts.push_back(i);
+      clusterOf[keyed[i].second] = static_cast<uint32_t>(clusterStarts.size() - 1);
+    }
+    const size_t numClusters = clusterStarts.size();
+    clusterStarts.push_back(numVertices);
+
+    ClusterLevel level;
+    level.resolution = finestResolution >> shift;
+    level.vertices.resize(numClusters);
+    Parallel::For(0, numClusters, [&](size_t first, size_t last)
+    {
+      for (size_t c = first; c < last; ++c)
+      {
+        double mean[3] = { 0, 0, 0 };
+        for (size_t i = clusterStarts[c]; i < clusterStarts[c + 1]; ++i)
+          for (int k = 0; k < 3; ++k)
+            mean[k] += positions[3 * keyed[i].second + k];
+        const double count = static_cast<double>(clusterStarts[c + 1] - clusterStarts[c]);
+
+        double best = std::numeric_limits<double>::max();
+        for (size_t i = clusterStarts[c]; i < clusterStarts[c + 1]; ++i)
+        {
+          double dist = 0;
+          for (int k = 0; k < 3; ++k)
+          {
+            double d = positions[3 * keyed[i].second + k] - mean[k] / count;
+            dist += d * d;
+          }
+          if (dist < best)
+          {
+            best = dist;
+            level.vertices[c] = keyed[i].second;
+          }
+        }
+      }
+    });
+
+    // Remap the triangles, rotating each so its smallest index comes first. That keeps the
+    // winding and makes repeated triangles equal, so sorting finds them.
+    std::vector<std::array<uint32_t, 3>> triangles(numTriangles);
+    std::vector<char> keep(numTriangles);
+    Parallel::For(0, numTriangles, [&](size_t first, size_t last)
+    {
+      for (size_t t = first; t < last; ++t)
+      {
+        uint32_t a = clusterOf[indices[3 * t]];
+        uint32_t b = clusterOf[indices[3 * t + 1]];
+        uint32_t c = clusterOf[indices[3 * t + 2]];
+        keep[t] = a != b && b != c && c != a;
+        if (b < a && b < c)
+          triangles[t] = {{ b, c, a }};
+        else if (c < a && c < b)
+          triangles[t] = {{ c, a, b }};
+        else
+          triangles[t] = {{ a, b, c }};
+      }
+    });
+    size_t numKept = 0;
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+      if (keep[t])
+        triangles[numKept++] = triangles[t];
+    }
+    triangles.resize(numKept);
+    Parallel::Sort(triangles.begin(), triangles.end());
+    triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+
+    if (triangles.empty() || 2 * triangles.size() > previousTriangles)
+      continue;
+    previousTriangles = triangles.size();
+
+    level.indices.reserve(3 * triangles.size());
+    for (const auto& triangle : triangles)
+      level.indices.insert(level.indices.end(), triangle.begin(), triangle.end());
+    levels.push_back(std::move(level));
+  }
+
+  return levels;
+}
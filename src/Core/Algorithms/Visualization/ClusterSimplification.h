@@ -0,0 +1,67 @@
+/*
+For more information, please see: http://software.sci.utah.edu
+
+The MIT License
+
+Copyright (c) 2015 Scientific Computing and Imaging Institute,
+University of Utah.
+
+License for the specific language governing rights and limitations under
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_VISUALIZATION_CLUSTERSIMPLIFICATION_H
+#define CORE_ALGORITHMS_VISUALIZATION_CLUSTERSIMPLIFICATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <Core/Algorithms/Visualization/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Algorithms
+    {
+      namespace Visualization
+      {
+        /// One level of a simplified triangle mesh. Its vertices are a subset of the input
+        /// vertices, so per-vertex attributes can be gathered from the full resolution data.
+        struct SCISHARE ClusterLevel
+        {
+          size_t resolution = 0;          ///< Grid cells along the longest side of the bounding box.
+          std::vector<uint32_t> vertices; ///< Input vertex used for each vertex of the level.
+          std::vector<uint32_t> indices;  ///< Triangles, indexing into vertices.
+        };
+
+        /// Simplifies an indexed triangle mesh by vertex clustering on nested grids over its
+        /// bounding box. Each occupied cell is replaced by the member vertex nearest to the mean
+        /// of its members, and triangles that collapse or repeat another are dropped.
+        /// Levels go from finest to coarsest, halving the resolution each time; a level is only
+        /// kept if it has at most half the triangles of the previous one.
+        /// positions holds xyz for each of numVertices vertices.
+        SCISHARE std::vector<ClusterLevel> buildClusterLevels(const float* positions, size_t numVertices,
+          const uint32_t* indices, size_t numIndices, size_t finestResolution, size_t coarsestResolution);
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,164 @@
+/*
+For more information, please see: http://software.sci.utah.edu
+
+The MIT License
+
+Copyright (c) 2015 Scientific Computing and Imaging Institute,
+University of Utah.
+
+License for the specific language governing rights and limitations under
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/Visualization/ClusterSimplification.h>
+#include <Core/Thread/Parallel.h>
+#include <cmath>
+
+using namespace SCIRun::Core::Algorithms::Visualization;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  // A wavy height field over the unit square, triangulated counterclockwise seen from +z.
+  struct HeightField
+  {
+    explicit HeightField(uint32_t n)
+    {
+      for (uint32_t j = 0; j < n; ++j)
+      {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+          float x = i / float(n - 1), y = j / float(n - 1);
+          positions.insert(positions.end(), { x, y, 0.05f * std::sin(6 * x) * std::cos(5 * y) });
+        }
+      }
+      for (uint32_t j = 0; j + 1 < n; ++j)
+      {
+        for (uint32_t i = 0; i + 1 < n; ++i)
+        {
+          uint32_t v = j * n + i;
+          indices.insert(indices.end(), { v, v + 1, v + n + 1, v, v + n + 1, v + n });
+        }
+      }
+    }
+
+    std::vector<ClusterLevel> levels(size_t finest = 64, size_t coarsest = 4) const
+    {
+      return buildClusterLevels(positions.data(), positions.size() / 3, indices.data(), indices.size(), finest, coarsest);
+    }
+
+    /// z of the normal of triangle abc, which is twice its area projected onto the xy plane.
+    float normalZ(uint32_t a, uint32_t b, uint32_t c) const
+    {
+      const float* p = &positions[3 * a];
+      const float* q = &positions[3 * b];
+      const float* r = &positions[3 * c];
+      return (q[0] - p[0]) * (r[1] - p[1]) - (q[1] - p[1]) * (r[0] - p[0]);
+    }
+
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+  };
+}
+
+TEST(ClusterSimplificationTests, IndicesStayInRange)
+{
+  HeightField mesh(128);
+  auto levels = mesh.levels();
+  ASSERT_FALSE(levels.empty());
+
+  for (const auto& level : levels)
+  {
+    ASSERT_FALSE(level.indices.empty());
+    EXPECT_EQ(0u, level.indices.size() % 3);
+    for (auto index : level.indices)
+      ASSERT_LT(index, level.vertices.size());
+    for (auto vertex : level.vertices)
+      ASSERT_LT(vertex, mesh.positions.size() / 3);
+  }
+}
+
+TEST(ClusterSimplificationTests, EachLevelAtLeastHalvesTheTriangles)
+{
+  HeightField mesh(128);
+  auto levels = mesh.levels();
+  ASSERT_GE(levels.size(), 2u);
+
+  size_t previousIndices = mesh.indices.size();
+  size_t previousResolution = 64 * 2;
+  for (const auto& level : levels)
+  {
+    EXPECT_LE(2 * level.indices.size(), previousIndices);
+    EXPECT_LT(level.resolution, previousResolution);
+    EXPECT_GE(level.resolution, 4u);
+    previousIndices = level.indices.size();
+    previousResolution = level.resolution;
+  }
+}
+
+TEST(ClusterSimplificationTests, KeepsTheWinding)
+{
+  HeightField mesh(128);
+  auto levels = mesh.levels();
+  ASSERT_FALSE(levels.empty());
+
+  // Triangles between collinear cluster vertices have no area, but none may turn over. The
+  // vertices nearest the cluster means pull in from the border, so coarse levels cover less.
+  for (const auto& level : levels)
+  {
+    double area = 0;
+    for (size_t t = 0; t < level.indices.size(); t += 3)
+    {
+      auto a = level.vertices[level.indices[t]];
+      auto b = level.vertices[level.indices[t + 1]];
+      auto c = level.vertices[level.indices[t + 2]];
+      auto twiceArea = mesh.normalZ(a, b, c);
+      ASSERT_GT(twiceArea, -1e-6f) << "resolution " << level.resolution << " triangle " << t / 3;
+      area += 0.5 * twiceArea;
+    }
+    EXPECT_GT(area, 0.5) << "resolution " << level.resolution;
+    EXPECT_LT(area, 1.0 + 1e-4) << "resolution " << level.resolution;
+  }
+}
+
+TEST(ClusterSimplificationTests, SameLevelsForAnyThreadCount)
+{
+  HeightField mesh(128);
+  auto expected = mesh.levels();
+
+  for (unsigned int threads : { 1u, 2u, 3u, 8u })
+  {
+    Parallel::SetMaximumCores(threads);
+    auto levels = mesh.levels();
+    ASSERT_EQ(expected.size(), levels.size()) << threads << " threads";
+    for (size_t l = 0; l < levels.size(); ++l)
+    {
+      EXPECT_EQ(expected[l].resolution, levels[l].resolution) << threads << " threads";
+      EXPECT_EQ(expected[l].vertices, levels[l].vertices) << threads << " threads";
+      EXPECT_EQ(expected[l].indices, levels[l].indices) << threads << " threads";
+    }
+  }
+  Parallel::SetMaximumCores(0);
+}
+
+TEST(ClusterSimplificationTests, EmptyMeshHasNoLevels)
+{
+  EXPECT_TRUE(buildClusterLevels(nullptr, 0, nullptr, 0, 64, 4).empty());
+}
@@ -49,6 +49,8 @@
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <boost/algorithm/string.hpp>
 #include <Core/Thread/Parallel.h>
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
 
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Logging;
@@ -160,6 +162,13 @@ void Application::readCommandLine(int argc, const char* argv[])
     auto maxCoresOption = private_->parameters_->developerParameters()->maxCores();
     if (maxCoresOption)
       Thread::Parallel::SetMaximumCores(*maxCoresOption);
+
+    auto portCacheOption = private_->parameters_->developerParameters()->portCacheMegabytes();
+    if (portCacheOption)
+      PortDataCache::Instance().setMemoryBudget(static_cast<size_t>(*portCacheOption) * 1024 * 1024);
+
+    if (private_->parameters_->developerParameters()->contentHashing())
+      SimpleSink::setGlobalContentHashFlag(true);
       
     LogSettings::Instance().setVerbose(parameters()->verboseMode());
   }
@@ -68,6 +68,8 @@ public:
       //("frameInitLimit", po::value<int>(), "ViewScene frame init limit--increase if renderer fails")
       ("guiExpandFactor", po::value<double>(), "Expansion factor for high resolution displays")
       ("max-cores", po::value<unsigned int>(), "Limit the number of cores used by multithreaded algorithms")
+      ("port-cache-mb", po::value<unsigned int>(), "Memory budget for cached port data; older data spills to disk")
+      ("content-hash", "Skip modules whose new inputs are equal by value to the previous ones")
       ("list-modules", "print list of available modules")
       ;
 
@@ -117,9 +119,12 @@ public:
     const boost::optional<int>& frameInitLimit,
     const boost::optional<int>& regressionTimeout,
     const boost::optional<unsigned int>& maxCores,
-    const boost::optional<double>& guiExpandFactor
+    const boost::optional<double>& guiExpandFactor,
+    const boost::optional<unsigned int>& portCacheMegabytes,
+    bool contentHashing
     ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), frameInitLimit_(frameInitLimit),
-    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor)
+    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor),
+    portCacheMegabytes_(portCacheMegabytes), contentHashing_(contentHashing)
   {}
   boost::optional<int> regressionTimeoutSeconds() const override
   {
@@ -145,11 +150,21 @@ public:
   {
     return guiExpandFactor_;
   }
+  boost::optional<unsigned int> portCacheMegabytes() const override
+  {
+    return portCacheMegabytes_;
+  }
+  bool contentHashing() const override
+  {
+    return contentHashing_;
+  }
 private:
   boost::optional<std::string> threadMode_, reexecuteMode_;
   boost::optional<int> frameInitLimit_, regressionTimeout_;
   boost::optional<unsigned int> maxCores_;
   boost::optional<double> guiExpandFactor_;
+  boost::optional<unsigned int> portCacheMegabytes_;
+  bool contentHashing_;
 };
 
 class ApplicationParametersImpl : public ApplicationParameters
@@ -342,7 +357,9 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
         parseOptionalArg<int>(parsed, "frameInitLimit"),
         parseOptionalArg<int>(parsed, "regression"),
         parseOptionalArg<unsigned int>(parsed, "max-cores"),
-        parseOptionalArg<double>(parsed, "guiExpandFactor")
+        parseOptionalArg<double>(parsed, "guiExpandFactor"),
+        parseOptionalArg<unsigned int>(parsed, "port-cache-mb"),
+        parsed.count("content-hash") != 0
       ),
       ApplicationParametersImpl::Flags(
         parsed.count("help") != 0,
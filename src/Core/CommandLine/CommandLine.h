@@ -76,6 +76,8 @@ namespace SCIRun {
         virtual boost::optional<int> frameInitLimit() const = 0;
         virtual boost::optional<unsigned int> maxCores() const = 0;
         virtual boost::optional<double> guiExpandFactor() const = 0;
+        virtual boost::optional<unsigned int> portCacheMegabytes() const = 0;
+        virtual bool contentHashing() const = 0;
       };
 
       typedef boost::shared_ptr<ApplicationParameters> ApplicationParametersHandle;
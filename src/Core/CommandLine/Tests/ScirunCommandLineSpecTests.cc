@@ -57,6 +57,10 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     "  --guiExpandFactor arg   Expansion factor for high resolution displays\n"
     "  --max-cores arg         Limit the number of cores used by multithreaded \n"
     "                          algorithms\n"
+    "  --port-cache-mb arg     Memory budget for cached port data; older data spills\n"
+    "                          to disk\n"
+    "  --content-hash          Skip modules whose new inputs are equal by value to \n"
+    "                          the previous ones\n"
     "  --list-modules          print list of available modules\n";
 
   EXPECT_EQ(expectedHelp, parser.describe());
@@ -187,4 +191,13 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     EXPECT_EQ("scr1.py", *aph->pythonScriptFile());
     EXPECT_TRUE(aph->quitAfterOneScriptedExecution());
   }
+
+  {
+    const char* argv[] = { "scirun.exe", "--content-hash" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    EXPECT_TRUE(aph->developerParameters()->contentHashing());
+  }
 }
@@ -0,0 +1,108 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_DATATYPES_CONTENTHASH_H
+#define CORE_DATATYPES_CONTENTHASH_H
+
+#include <boost/cstdint.hpp>
+#include <cstring>
+#include <string>
+
+namespace SCIRun {
+namespace Core {
+namespace Datatypes {
+
+  /// Incremental 64-bit hash over raw memory, fed a block at a time by Datatype::computeContentHash
+  /// overrides. Murmur3-style word mixing: not cryptographic, but strong enough that two different
+  /// matrices or fields will not plausibly compare equal.
+  class ContentHasher
+  {
+  public:
+    ContentHasher() : state_(0x9e3779b97f4a7c15ULL), length_(0) {}
+
+    void add(const void* data, size_t bytes)
+    {
+      auto bytePtr = static_cast<const unsigned char*>(data);
+      const size_t words = bytes / sizeof(boost::uint64_t);
+      for (size_t i = 0; i < words; ++i)
+      {
+        boost::uint64_t word;
+        std::memcpy(&word, bytePtr + i * sizeof(word), sizeof(word));
+        mix(word);
+      }
+      const size_t remainder = bytes - words * sizeof(boost::uint64_t);
+      if (remainder > 0)
+      {
+        boost::uint64_t tail = 0;
+        std::memcpy(&tail, bytePtr + words * sizeof(tail), remainder);
+        mix(tail);
+      }
+      length_ += bytes;
+    }
+
+    template <typename T>
+    void add(const T& value)
+    {
+      add(&value, sizeof(T));
+    }
+
+    void add(const std::string& str)
+    {
+      add(str.data(), str.size());
+    }
+
+    boost::uint64_t value() const
+    {
+      auto h = state_ ^ length_;
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+  private:
+    static boost::uint64_t rotl(boost::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    void mix(boost::uint64_t k)
+    {
+      k *= 0x87c37b91114253d5ULL;
+      k = rotl(k, 31);
+      k *= 0x4cf5ad432745937fULL;
+      state_ ^= k;
+      state_ = rotl(state_, 27) * 5 + 0x52dce729;
+    }
+
+    boost::uint64_t state_;
+    boost::uint64_t length_;
+  };
+
+}}}
+
+#endif
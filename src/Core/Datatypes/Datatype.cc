@@ -31,15 +31,54 @@
 
 using namespace SCIRun::Core::Datatypes;
 
-Datatype::Datatype() {}
+Datatype::Datatype() : hashState_(HASH_UNKNOWN), hash_(0) {}
 
 Datatype::~Datatype() {}
 
-Datatype::Datatype(const Datatype& other)
+Datatype::Datatype(const Datatype& other) : hashState_(HASH_UNKNOWN), hash_(0)
 {
 }
 
 Datatype& Datatype::operator=(const Datatype& rhs) 
 {
+  hashState_ = HASH_UNKNOWN;
   return *this;
 }
+
+boost::optional<Datatype::content_hash_type> Datatype::contentHash() const
+{
+  switch (hashState_.load(boost::memory_order_acquire))
+  {
+  case HASH_CACHED:
+    return content_hash_type(hash_.load(boost::memory_order_relaxed));
+  case HASH_UNSUPPORTED:
+    return boost::none;
+  default:
+    break;
+  }
+
+  // Racing first requests compute the same value, so no lock is needed.
+  auto hash = computeContentHash();
+  if (hash)
+  {
+    hash_.store(*hash, boost::memory_order_relaxed);
+    hashState_.store(HASH_CACHED, boost::memory_order_release);
+  }
+  else
+    hashState_.store(HASH_UNSUPPORTED, boost::memory_order_release);
+  return hash;
+}
+
+bool SCIRun::Core::Datatypes::sameContent(const DatatypeHandle& lhs, const DatatypeHandle& rhs)
+{
+  if (lhs == rhs)
+    return true;
+  if (!lhs || !rhs)
+    return false;
+  if (lhs->id() == rhs->id())
+    return true;
+  if (lhs->dynamic_type_name() != rhs->dynamic_type_name())
+    return false;
+  auto lhsHash = lhs->contentHash();
+  return lhsHash && lhsHash == rhs->contentHash();
+}
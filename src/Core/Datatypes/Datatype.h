@@ -32,6 +32,9 @@
 #include <Core/Persistent/Persistent.h>
 #include <Core/Datatypes/DatatypeFwd.h>
 #include <Core/Datatypes/HasId.h>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/optional.hpp>
 #include <Core/Datatypes/share.h>
 
 namespace SCIRun {
@@ -47,6 +50,7 @@ namespace Datatypes {
     Datatype& operator=(const Datatype& rhs);
 
     typedef HasIntegerId::id_type id_type;
+    typedef boost::uint64_t content_hash_type;
 
     /// @todo
     template <typename T>
@@ -58,8 +62,24 @@ namespace Datatypes {
     virtual Datatype* clone() const = 0;
 
     virtual std::string dynamic_type_name() const = 0;
+
+    /// Hash of the object's contents, for change detection by value rather than by id().
+    /// Empty if the type does not support hashing. Computed on first request and cached,
+    /// so an object must not be modified once it has been sent downstream.
+    boost::optional<content_hash_type> contentHash() const;
+
+  protected:
+    virtual boost::optional<content_hash_type> computeContentHash() const { return boost::none; }
+
+  private:
+    enum HashState { HASH_UNKNOWN, HASH_UNSUPPORTED, HASH_CACHED };
+    mutable boost::atomic<int> hashState_;
+    mutable boost::atomic<content_hash_type> hash_;
   };
 
+  /// True if both handles point at the same object, or at objects with equal content hashes.
+  SCISHARE bool sameContent(const DatatypeHandle& lhs, const DatatypeHandle& rhs);
+
 }}}
 
 
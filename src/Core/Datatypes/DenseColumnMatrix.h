@@ -31,6 +31,7 @@
 #define CORE_DATATYPES_DENSE_COLUMN_MATRIX_H 
 
 #include <Core/Datatypes/Matrix.h>
+#include <Core/Datatypes/ContentHash.h>
 #define register
 #include <Eigen/Dense>
 #undef register
@@ -89,6 +90,16 @@ namespace Datatypes {
     virtual void io(Piostream&) override;
     static PersistentTypeID type_id;
 
+  protected:
+    virtual boost::optional<Datatype::content_hash_type> computeContentHash() const override
+    {
+      ContentHasher hasher;
+      hasher.add(dynamic_type_name());
+      hasher.add(this->rows());
+      hasher.add(this->data(), sizeof(T) * this->size());
+      return hasher.value();
+    }
+
   private:
     virtual void print(std::ostream& o) const override
     {
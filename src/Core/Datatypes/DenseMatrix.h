@@ -31,6 +31,7 @@
 #define CORE_DATATYPES_DENSE_MATRIX_H
 
 #include <Core/Datatypes/Matrix.h>
+#include <Core/Datatypes/ContentHash.h>
 #include <Core/GeometryPrimitives/Transform.h> /// @todo
 #define register
 #include <Eigen/Dense>
@@ -126,6 +127,17 @@ namespace Datatypes {
       (*this)(i,j) = val;
     }
 
+  protected:
+    virtual boost::optional<Datatype::content_hash_type> computeContentHash() const override
+    {
+      ContentHasher hasher;
+      hasher.add(dynamic_type_name());
+      hasher.add(this->rows());
+      hasher.add(this->cols());
+      hasher.add(this->data(), sizeof(T) * this->size());
+      return hasher.value();
+    }
+
   private:
     virtual void print(std::ostream& o) const override
     {
@@ -104,6 +104,8 @@ public:
   static PersistentTypeID type_id;
   virtual std::string dynamic_type_name() const { return type_id.type; }
 
+  const T& value() const { return obj_; }
+
   virtual bool operator==(PropertyBase &pb) const {
     const Property<T> *prop = dynamic_cast<Property<T> *>(&pb);
 
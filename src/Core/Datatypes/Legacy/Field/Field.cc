@@ -30,6 +30,8 @@
 
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/ContentHash.h>
 #include <Core/Datatypes/Legacy/Base/PropertyManager.h>
 #include <Core/Utils/Legacy/Debug.h>
 #include <Core/Thread/Mutex.h>
@@ -38,6 +40,8 @@
 #include <map>
 
 using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Thread;
 
 Field::Field()
@@ -114,6 +118,112 @@ Field::io(Piostream& stream)
 
 std::string Field::type_name() const { return type_id.type; }   
 
+namespace
+{
+  // Byte size of one stored value, or 0 when the storage is not plain data.
+  size_t plainValueBytes(VField* vfield)
+  {
+    if (vfield->is_char() || vfield->is_unsigned_char()) return sizeof(char);
+    if (vfield->is_short() || vfield->is_unsigned_short()) return sizeof(short);
+    if (vfield->is_int() || vfield->is_unsigned_int()) return sizeof(int);
+    if (vfield->is_long() || vfield->is_unsigned_long()) return sizeof(long);
+    if (vfield->is_longlong() || vfield->is_unsigned_longlong()) return sizeof(long long);
+    if (vfield->is_float()) return sizeof(float);
+    if (vfield->is_double()) return sizeof(double);
+    if (vfield->is_vector()) return sizeof(Vector);
+    return 0;
+  }
+
+  template <typename T>
+  bool addPropertyValue(ContentHasher& hasher, const PropertyBaseHandle& prop)
+  {
+    auto typed = boost::dynamic_pointer_cast<const Property<T>>(prop);
+    if (!typed)
+      return false;
+    hasher.add(typed->value());
+    return true;
+  }
+
+  // Properties ride along with the field and downstream modules read them, so they
+  // take part in the hash. Only plain value types can be hashed; any other property
+  // makes the whole field unhashable rather than letting two fields collide.
+  bool addProperties(ContentHasher& hasher, const PropertyManager& properties)
+  {
+    for (const auto& prop : properties.properties())
+    {
+      if (!prop.second)
+        continue;
+      hasher.add(prop.first);
+      hasher.add(prop.second->dynamic_type_name());
+      if (!(addPropertyValue<std::string>(hasher, prop.second)
+        || addPropertyValue<bool>(hasher, prop.second)
+        || addPropertyValue<int>(hasher, prop.second)
+        || addPropertyValue<unsigned int>(hasher, prop.second)
+        || addPropertyValue<long>(hasher, prop.second)
+        || addPropertyValue<unsigned long>(hasher, prop.second)
+        || addPropertyValue<float>(hasher, prop.second)
+        || addPropertyValue<double>(hasher, prop.second)))
+        return false;
+    }
+    return true;
+  }
+}
+
+boost::optional<Datatype::content_hash_type> Field::computeContentHash() const
+{
+  auto mesh = vmesh();
+  auto field = vfield();
+  if (!mesh || !field || mesh->is_nonlinearmesh() || field->basis_order() > 1)
+    return boost::none;
+
+  ContentHasher hasher;
+  hasher.add(dynamic_type_name());
+  hasher.add(field->basis_order());
+
+  if (mesh->is_regularmesh())
+  {
+    VMesh::dimension_type dims;
+    mesh->get_dimensions(dims);
+    for (auto dim : dims)
+      hasher.add(dim);
+    double trans[16];
+    mesh->get_transform().get(trans);
+    hasher.add(trans, sizeof(trans));
+  }
+  else if (mesh->is_unstructuredmesh())
+  {
+    auto points = mesh->get_points_pointer();
+    if (!points && mesh->num_nodes() > 0)
+      return boost::none;
+    if (points)
+      hasher.add(points, sizeof(Point) * mesh->num_nodes());
+    // point clouds have implicit connectivity and return no element storage
+    auto elems = mesh->get_elems_pointer();
+    if (elems)
+      hasher.add(elems, sizeof(VMesh::index_type) * mesh->num_elems() * mesh->num_nodes_per_elem());
+  }
+  else
+  {
+    // structured meshes do not expose their node storage directly
+    return boost::none;
+  }
+
+  if (field->basis_order() >= 0)
+  {
+    auto valueBytes = plainValueBytes(field);
+    if (0 == valueBytes)
+      return boost::none;
+    if (field->num_values() > 0)
+      hasher.add(field->fdata_pointer(), valueBytes * field->num_values());
+    if (field->num_evalues() > 0)
+      hasher.add(field->efdata_pointer(), valueBytes * field->num_evalues());
+  }
+
+  if (!addProperties(hasher, properties()))
+    return boost::none;
+  return hasher.value();
+}
+
 // initialize the static member type_id
 PersistentTypeID Field::type_id("Field", "Datatype", 0);
 
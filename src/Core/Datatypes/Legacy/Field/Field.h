@@ -83,6 +83,12 @@ class SCISHARE Field : public Core::Datatypes::Datatype, public Core::Datatypes:
     static  PersistentTypeID type_id;
     virtual void io(Piostream &stream);
     virtual std::string type_name() const;
+
+  protected:
+    /// Hashes mesh geometry/topology and field values through the virtual interfaces.
+    /// Properties with plain value types are hashed too; structured-mesh, tensor, complex and
+    /// non-linear fields, and fields carrying other property types, are not hashed.
+    virtual boost::optional<content_hash_type> computeContentHash() const override;
 };
 
 
@@ -138,6 +138,9 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_adjacency(VMesh::adjacency_type& table) const;
+  virtual void get_node_adjacency(VMesh::adjacency_type& table) const;
+
   virtual bool get_elem(VMesh::Elem::index_type& elem, 
                         VMesh::Node::array_type& nodes) const;
   virtual bool get_delem(VMesh::DElem::index_type& delem, 
@@ -494,6 +497,22 @@ VHexVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
   this->mesh_->get_faces_from_cell(delems,idx);
 }
 
+template <class MESH>
+void
+VHexVolMesh<MESH>::get_elem_adjacency(VMesh::adjacency_type& table) const
+{
+  build_node_table(this->mesh_->points_.size(), table,
+    [this](VMesh::index_type n, VMesh::array_type& row) { this->mesh_->get_cells_from_node(row, n); });
+}
+
+template <class MESH>
+void
+VHexVolMesh<MESH>::get_node_adjacency(VMesh::adjacency_type& table) const
+{
+  build_node_table(this->mesh_->points_.size(), table,
+    [this](VMesh::index_type n, VMesh::array_type& row) { this->mesh_->get_node_neighbors(row, n); });
+}
+
 template <class MESH>
 void
 VHexVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
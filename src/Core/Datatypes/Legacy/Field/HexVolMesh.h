@@ -37,6 +37,7 @@
 #include <Core/Containers/StackVector.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/GeometryPrimitives/SearchBVHT.h>
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/CompGeom.h>
 #include <Core/GeometryPrimitives/Point.h>
@@ -52,6 +53,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateCache.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTables.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -1202,22 +1205,15 @@ public:
               "HexVolMesh: need to synchronize FACES_E first");
 
     // First check are we inside an element
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          pdist = 0.0;
-          result = p;
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      pdist = 0.0;
+      result = p;
+      elem = static_cast<INDEX>(inside_idx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
 
     // If not start searching for the closest outer boundary
@@ -1794,10 +1790,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "HexVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>3);
+    const typename node_table_type::Row neighbors = node_neighbors_[idx];
+    array.resize(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]>>3);
   }
 
   template<class ARRAY, class INDEX>
@@ -1809,7 +1805,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_table_type::Row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1891,7 +1887,7 @@ protected:
       "HexVolMesh: Must call synchronize FACES_E first");
 
     array.clear();
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_table_type::Row neighbors = node_neighbors_[idx];
 
     // Iterate through all those edges
     for (size_t n = 0; n < neighbors.size(); n++)
@@ -2091,21 +2087,21 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on HexVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const typename node_table_type::Row neighbors = node_neighbors_[node];
 
-    std::set<index_type> inserted;
-    for (size_t i = 0; i < sz; i++)
+    array.clear();
+    array.reserve(7*neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x7));
+      const index_type base = (neighbors[i]&(~0x7));
       for (index_type c = base; c < base+8; ++c)
       {
-        if (cells_[c] != node) inserted.insert(cells_[c]);
+        if (cells_[c] != node) array.push_back(cells_[c]);
       }
     }
 
-    array.clear();
-    array.reserve(inserted.size());
-    array.insert(array.begin(), inserted.begin(), inserted.end());
+    std::sort(array.begin(), array.end());
+    array.erase(std::unique(array.begin(), array.end()), array.end());
   }
 
   template <class INDEX>
@@ -2274,18 +2270,11 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "HexVolMesh: need to synchronize ELEM_LOCATE_E first");
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(*it, p))
-        {
-          elem = static_cast<INDEX>(*it);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(inside_idx);
+      return (true);
     }
     return (false);
   }
@@ -2347,20 +2336,13 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "HexVolMesh: need to synchronize ELEM_LOCATE_E first");
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(*it, p))
-        {
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(inside_idx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
     return (false);
   }
@@ -2442,6 +2424,32 @@ protected:
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
+  Core::Geometry::BBox elem_locate_box(index_type ci) const;
+
+  /// Find the element containing p among the candidates of the element
+  /// BVH when it was built, or of the element grid otherwise
+  inline bool search_elem(index_type &elem, const Core::Geometry::Point &p) const
+  {
+    if (elem_bvh_)
+      return (elem_bvh_->lookup(elem, p, [this, &p](index_type idx) { return (inside(typename Elem::index_type(idx), p)); }));
+
+    typename SearchGridT<index_type>::iterator it, eit;
+    if (elem_grid_->lookup(it, eit, p))
+    {
+      while (it != eit)
+      {
+        const index_type idx = *it;
+        if (inside(typename Elem::index_type(idx), p))
+        {
+          elem = idx;
+          return (true);
+        }
+        ++it;
+      }
+    }
+    return (false);
+  }
+
   const Core::Geometry::Point &point(typename Node::index_type i) const { return points_[i]; }
 
   template<class INDEX>
@@ -2757,9 +2765,7 @@ protected:
     }
   };
 
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
   using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
   using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
@@ -2775,15 +2781,6 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2853,7 +2850,9 @@ protected:
     typename Node::array_type   nodes_;
   };
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  typedef MeshAdjacency<index_type> node_table_type;
+  /// Positions in cells_ that refer to each node
+  node_table_type node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2863,6 +2862,7 @@ protected:
   ///  then search just those tets that overlap that grid cell.
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
   boost::shared_ptr<SearchGridT<index_type> >  elem_grid_;
+  boost::shared_ptr<SearchBVHT<index_type> >  elem_bvh_; /// Built for graded meshes, see MeshLocateCache
 
   // Lock and Condition Variable for hand shaking
   Core::Thread::Mutex                         synchronize_lock_;
@@ -3206,6 +3206,11 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
     synchronized_ |= Mesh::BOUNDING_BOX_E;
   }
 
+  // The grids may be shared with other meshes; the element hierarchy is
+  // dropped and lookups fall back to the transformed grid
+  MeshLocateCache::detach(node_grid_);
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
   synchronize_lock_.unlock();
@@ -3213,107 +3218,73 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
+HexVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
+  face_table_.clear();
 
+  // Every cell writes its 6 faces, each entered CCW from outside looking in,
+  // into its own slots; sorting then brings the cells sharing a face together
+  typedef MeshTopologyEntry<index_type,4> face_entry;
+  static const int face_nodes[6][4] = { {0,1,2,3}, {7,6,5,4}, {0,4,5,1},
+                                        {2,6,7,3}, {3,7,4,0}, {1,5,6,2} };
 
-  typename face_ht::iterator iter = table.find(f);
+  const size_t num_cells = cells_.size() >> 3;
+  std::vector<face_entry> entries(6*num_cells);
 
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  Core::Thread::Parallel::For(0, num_cells, [&](size_t first, size_t last)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
+    for (size_t c = first; c < last; c++)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const under_type* nodes = &cells_[8*c];
+      for (int f = 0; f < 6; f++)
+      {
+        face_entry& e = entries[6*c+f];
+        for (int k = 0; k < 4; k++) e.nodes_[k] = nodes[face_nodes[f][k]];
+        e.code_ = static_cast<index_type>((c<<3)+f);
+
+        // Reorder nodes while maintaining CCW or CW orientation; degenerate
+        // faces (opposite corners equal, or more than two nodes equal) are
+        // dropped
+        if (order_face_nodes(e.nodes_[0],e.nodes_[1],e.nodes_[2],e.nodes_[3]))
+          orient_face_key(e.nodes_);
+        else
+          e.nodes_[0] = MESH_NO_NEIGHBOR;
+      }
     }
-  }
-}
-
-template <class Basis>
-void
-HexVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
+  });
 
-  face_ht table;
+  const std::vector<size_t> runs = group_topology_entries(entries);
+  const size_t num_faces = runs.size() - 1;
+  faces_.resize(num_faces);
 
-  while (ci != cie)
+  Core::Thread::Parallel::For(0, num_faces, [&](size_t first, size_t last)
   {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
+    for (size_t f = first; f < last; f++)
+    {
+      // Only the first two different cells are kept; a third one, or a cell
+      // listing the same face twice, means the mesh is broken
+      index_type* cells = faces_[f].cells_;
+      cells[0] = entries[runs[f]].code_;
+      cells[1] = MESH_NO_NEIGHBOR;
+      for (size_t i = runs[f]+1; i < runs[f+1] && cells[1] == MESH_NO_NEIGHBOR; i++)
+        if ((entries[i].code_>>3) != (cells[0]>>3)) cells[1] = entries[i].code_;
+    }
+  });
 
-  faces_.resize(table.size());
   boundary_faces_.resize(cells_.size()>>3);
+  face_table_.reserve(num_faces);
 
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  for (size_t f = 0; f < num_faces; f++)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
+    const face_entry& e = entries[runs[f]];
+    face_table_[PFaceNode(e.nodes_[0],e.nodes_[1],e.nodes_[2],e.nodes_[3])] = static_cast<index_type>(f);
 
-    if (pface.cells_[1] == -1)
+    if (faces_[f].cells_[1] == -1)
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
+      index_type cell = (faces_[f].cells_[0]) >> 3;
+      index_type face = (faces_[f].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
@@ -3321,73 +3292,56 @@ HexVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
-
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
+  typedef MeshTopologyEntry<index_type,2> edge_entry;
+  static const int edge_nodes[12][2] = { {0,1}, {1,2}, {2,3}, {3,0},
+                                         {4,5}, {5,6}, {6,7}, {7,4},
+                                         {0,4}, {5,1}, {2,6}, {7,3} };
 
-  // dump edges into the edges_ container.
+  const size_t num_cells = cells_.size() >> 3;
+  std::vector<edge_entry> entries(12*num_cells);
 
-  edges_.resize(table.size());
+  Core::Thread::Parallel::For(0, num_cells, [&](size_t first, size_t last)
+  {
+    for (size_t c = first; c < last; c++)
+    {
+      const under_type* nodes = &cells_[8*c];
+      for (int k = 0; k < 12; k++)
+      {
+        const index_type n1 = nodes[edge_nodes[k][0]];
+        const index_type n2 = nodes[edge_nodes[k][1]];
+        edge_entry& e = entries[12*c+k];
+        // collapsed edges are dropped
+        e.nodes_[0] = (n1 == n2) ? MESH_NO_NEIGHBOR : std::min(n1,n2);
+        e.nodes_[1] = std::max(n1,n2);
+        e.code_ = static_cast<index_type>((c<<4)+k);
+      }
+    }
+  });
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  // dump edges into the edges_ container.
+  const std::vector<size_t> runs = group_topology_entries(entries);
+  const size_t num_edges = runs.size() - 1;
+  edges_.resize(num_edges);
+
+  Core::Thread::Parallel::For(0, num_edges, [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; i++)
+    {
+      edges_[i].cells_.clear();
+      for (size_t j = runs[i]; j < runs[i+1]; j++)
+        edges_[i].cells_.push_back(entries[j].code_);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  edge_table_.reserve(num_edges);
+  for (size_t i = 0; i < num_edges; i++)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
+    const edge_entry& e = entries[runs[i]];
+    edge_table_[PEdgeNode(e.nodes_[0],e.nodes_[1])] = static_cast<index_type>(i);
   }
 
   synchronize_lock_.lock();
@@ -3540,6 +3494,7 @@ HexVolMesh<Basis>::clear_synchronization()
 
   node_grid_.reset();
   elem_grid_.reset();
+  elem_bvh_.reset();
 
   synchronize_lock_.unlock();
   return (true);
@@ -3678,13 +3633,16 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
+  // Each node lists the positions in cells_ that refer to it
+  std::vector<std::pair<index_type,index_type> > corners(cells_.size());
+  Core::Thread::Parallel::For(0, cells_.size(), [&](size_t first, size_t last)
   {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+    for (size_t i = first; i < last; i++)
+      corners[i] = std::make_pair(static_cast<index_type>(cells_[i]), static_cast<index_type>(i));
+  });
+
+  fill_node_table(corners, points_.size(), node_neighbors_,
+                  [](index_type i) { return i; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3727,12 +3685,9 @@ HexVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::ar
 }
 
 template <class Basis>
-void
-HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+HexVolMesh<Basis>::elem_locate_box(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*8;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3744,26 +3699,27 @@ HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+6]]);
   box.extend(points_[cells_[idx+7]]);
   box.extend(epsilon_);
+  return (box);
+}
 
-  elem_grid_->insert(ci, box);
+template <class Basis>
+void
+HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
+  elem_grid_->insert(ci, elem_locate_box(ci));
 }
 
 template <class Basis>
 void
 HexVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*8;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(points_[cells_[idx+6]]);
-  box.extend(points_[cells_[idx+7]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
+  elem_grid_->remove(ci, elem_locate_box(ci));
 }
 
 template <class Basis>
@@ -3772,6 +3728,7 @@ HexVolMesh<Basis>::insert_node_into_grid(typename Node::index_type ni)
 {
   /// @todo:  This can crash if you insert a new cell outside of the grid.
   // Need to recompute grid at that point.
+  MeshLocateCache::detach(node_grid_);
   node_grid_->insert(ni,points_[ni]);
 }
 
@@ -3779,6 +3736,7 @@ template <class Basis>
 void
 HexVolMesh<Basis>::remove_node_from_grid(typename Node::index_type ni)
 {
+  MeshLocateCache::detach(node_grid_);
   node_grid_->remove(ni,points_[ni]);
 }
 
@@ -3802,14 +3760,44 @@ HexVolMesh<Basis>::compute_elem_grid()
     size_type sz = static_cast<size_type>(ceil(0.5+diag.z()/trace*s));
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
-    elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+    const MeshLocateCache::key_type key =
+      MeshLocateCache::geometry_key("HexVolMesh", points_, cells_, epsilon_);
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
+    elem_grid_ = MeshLocateCache::find<SearchGridT<index_type> >(key, "elem grid");
+    if (!elem_grid_)
     {
-      insert_elem_into_grid(*ci);
-      ++ci;
+      elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+
+      typename Elem::iterator ci, cie;
+      begin(ci); end(cie);
+      while(ci != cie)
+      {
+        insert_elem_into_grid(*ci);
+        ++ci;
+      }
+      MeshLocateCache::insert(key, "elem grid", elem_grid_);
+    }
+
+    elem_bvh_.reset();
+    const int method = MeshLocateCache::elem_locate_method();
+    if (method == MeshLocateCache::BVH_E || (method == MeshLocateCache::AUTO_E &&
+        elem_grid_->max_bin_size() > MeshLocateCache::bvh_bin_threshold()))
+    {
+      elem_bvh_ = MeshLocateCache::find<SearchBVHT<index_type> >(key, "elem bvh");
+      if (!elem_bvh_)
+      {
+        elem_bvh_.reset(new SearchBVHT<index_type>);
+
+        typename Elem::iterator ci, cie;
+        begin(ci); end(cie);
+        while(ci != cie)
+        {
+          elem_bvh_->insert(*ci, elem_locate_box(*ci));
+          ++ci;
+        }
+        elem_bvh_->build();
+        MeshLocateCache::insert(key, "elem bvh", elem_bvh_);
+      }
     }
   }
 
@@ -3839,14 +3827,22 @@ HexVolMesh<Basis>::compute_node_grid()
     size_type sz = static_cast<size_type>(ceil(0.5+diag.z()/trace*s));
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
-    node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+    const MeshLocateCache::key_type key =
+      MeshLocateCache::geometry_key("HexVolMesh", points_, cells_, epsilon_);
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
+    node_grid_ = MeshLocateCache::find<SearchGridT<index_type> >(key, "node grid");
+    if (!node_grid_)
     {
-      insert_node_into_grid(*ni);
-      ++ni;
+      node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+
+      typename Node::iterator ni, nie;
+      begin(ni); end(nie);
+      while(ni != nie)
+      {
+        insert_node_into_grid(*ni);
+        ++ni;
+      }
+      MeshLocateCache::insert(key, "node grid", node_grid_);
     }
   }
 
@@ -0,0 +1,180 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_DATATYPES_MESHADJACENCY_H
+#define CORE_DATATYPES_MESHADJACENCY_H 1
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace SCIRun {
+
+/// Compact adjacency table with one row of indices per node, stored as a
+/// single flat array instead of a vector per node. A row is described by the
+/// offsets of its first and one past its last entry, so it can grow or shrink
+/// without touching the other rows: a row that is not the last one in the
+/// array is moved to the end before it grows. Moves leave stale entries
+/// behind; once they outnumber the live ones the array is rebuilt in row order.
+template <class INDEX>
+class MeshAdjacency
+{
+  public:
+    MeshAdjacency() : live_(0) {}
+
+    typedef INDEX value_type;
+    typedef const INDEX* const_iterator;
+
+    /// Read-only view of one row
+    class Row
+    {
+      public:
+        Row(const INDEX* first, const INDEX* last) : first_(first), last_(last) {}
+
+        const_iterator begin() const { return (first_); }
+        const_iterator end() const { return (last_); }
+        size_t size() const { return (static_cast<size_t>(last_ - first_)); }
+        bool empty() const { return (first_ == last_); }
+        const INDEX& operator[](size_t i) const { return (first_[i]); }
+
+      private:
+        const INDEX* first_;
+        const INDEX* last_;
+    };
+
+    /// Number of rows
+    size_t size() const { return (begin_.size()); }
+    bool empty() const { return (begin_.empty()); }
+
+    Row operator[](size_t r) const
+      { return (Row(values_.data() + begin_[r], values_.data() + end_[r])); }
+
+    void clear()
+    {
+      begin_.clear(); end_.clear(); values_.clear();
+      live_ = 0;
+    }
+
+    /// Takes over a table in compressed row layout: row r holds
+    /// values[offsets[r]] up to values[offsets[r+1]]. Both arrays are consumed.
+    void assign(std::vector<size_t>& offsets, std::vector<INDEX>& values)
+    {
+      begin_.assign(offsets.begin(), offsets.end() - 1);
+      end_.assign(offsets.begin() + 1, offsets.end());
+      values_.swap(values);
+      live_ = values_.size();
+      std::vector<size_t>().swap(offsets);
+      std::vector<INDEX>().swap(values);
+    }
+
+    /// Adds an empty row at the end
+    void add_row()
+    {
+      begin_.push_back(values_.size());
+      end_.push_back(values_.size());
+    }
+
+    /// Adds a row at the end holding the values of [first,last)
+    template <class ITERATOR>
+    void add_row(ITERATOR first, ITERATOR last)
+    {
+      begin_.push_back(values_.size());
+      values_.insert(values_.end(), first, last);
+      live_ += values_.size() - begin_.back();
+      end_.push_back(values_.size());
+    }
+
+    /// Appends a value to row r
+    void push_back(size_t r, INDEX value)
+    {
+      if (end_[r] != values_.size())
+      {
+        // grow geometrically: an exact reserve would reallocate on every move
+        const size_t first = values_.size();
+        const size_t needed = first + (end_[r] - begin_[r]) + 1;
+        if (needed > values_.capacity())
+          values_.reserve(std::max(needed, 2 * values_.capacity()));
+        for (size_t i = begin_[r]; i < end_[r]; i++) values_.push_back(values_[i]);
+        begin_[r] = first;
+      }
+      values_.push_back(value);
+      end_[r] = values_.size();
+      live_++;
+      if (worth_compacting()) compact();
+    }
+
+    /// Removes the first occurrence of value from row r, keeping the order
+    /// of the others. Returns false if the row does not hold the value.
+    bool erase(size_t r, INDEX value)
+    {
+      typename std::vector<INDEX>::iterator first = values_.begin() + begin_[r];
+      typename std::vector<INDEX>::iterator last = values_.begin() + end_[r];
+      typename std::vector<INDEX>::iterator it = std::find(first, last, value);
+      if (it == last) return (false);
+      std::copy(it + 1, last, it);
+      end_[r]--;
+      live_--;
+      if (end_[r] + 1 == values_.size()) values_.pop_back();
+      else if (worth_compacting()) compact();
+      return (true);
+    }
+
+    /// Number of entries in the value array that no row refers to
+    size_t stale() const { return (values_.size() - live_); }
+
+    bool worth_compacting() const
+      { return (stale() > live_ && stale() > minimum_stale_); }
+
+    /// Rewrites the value array with the rows back to back in row order
+    void compact()
+    {
+      std::vector<INDEX> values;
+      values.reserve(live_);
+      for (size_t r = 0; r < begin_.size(); r++)
+      {
+        const size_t first = values.size();
+        values.insert(values.end(), values_.begin() + begin_[r], values_.begin() + end_[r]);
+        begin_[r] = first;
+        end_[r] = values.size();
+      }
+      values_.swap(values);
+    }
+
+  private:
+    /// Small tables are not worth rebuilding
+    static const size_t minimum_stale_ = 1024;
+
+    std::vector<size_t> begin_;
+    std::vector<size_t> end_;
+    std::vector<INDEX>  values_;
+    size_t live_;
+};
+
+} // end namespace SCIRun
+
+#endif
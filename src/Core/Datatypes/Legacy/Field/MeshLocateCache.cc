@@ -0,0 +1,107 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Datatypes/Legacy/Field/MeshLocateCache.h>
+#include <Core/Thread/Mutex.h>
+#include <boost/weak_ptr.hpp>
+#include <atomic>
+#include <map>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  std::atomic<int> elemLocateMethod(MeshLocateCache::AUTO_E);
+
+  typedef std::pair<MeshLocateCache::key_type, std::string> StructureKey;
+
+  Mutex& registryLock()
+  {
+    static Mutex lock("MeshLocateCache lock");
+    return lock;
+  }
+
+  std::map<StructureKey, boost::weak_ptr<void> >& registry()
+  {
+    static std::map<StructureKey, boost::weak_ptr<void> > structures;
+    return structures;
+  }
+}
+
+void
+MeshLocateCache::set_elem_locate_method(int method)
+{
+  elemLocateMethod = method;
+}
+
+int
+MeshLocateCache::elem_locate_method()
+{
+  return elemLocateMethod;
+}
+
+boost::shared_ptr<void>
+MeshLocateCache::find_structure(key_type key, const std::string& name)
+{
+  Guard g(registryLock().get());
+  auto it = registry().find(StructureKey(key, name));
+  if (it == registry().end())
+    return boost::shared_ptr<void>();
+  return it->second.lock();
+}
+
+void
+MeshLocateCache::insert(key_type key, const std::string& name, boost::shared_ptr<void> structure)
+{
+  Guard g(registryLock().get());
+  auto& structures = registry();
+
+  // Drop the entries of meshes that no longer exist
+  for (auto it = structures.begin(); it != structures.end();)
+  {
+    if (it->second.expired()) it = structures.erase(it);
+    else ++it;
+  }
+  structures[StructureKey(key, name)] = structure;
+}
+
+void
+MeshLocateCache::unregister(const void* structure)
+{
+  // Once the entry is gone find() cannot hand the structure out again, so the
+  // caller's use count can only drop from here on
+  Guard g(registryLock().get());
+  auto& structures = registry();
+  for (auto it = structures.begin(); it != structures.end();)
+  {
+    auto entry = it->second.lock();
+    if (!entry || entry.get() == structure) it = structures.erase(it);
+    else ++it;
+  }
+}
@@ -0,0 +1,112 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_DATATYPES_MESHLOCATECACHE_H
+#define CORE_DATATYPES_MESHLOCATECACHE_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Datatypes/ContentHash.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+#include <Core/Datatypes/Legacy/Field/share.h>
+
+namespace SCIRun {
+
+/// The search grids and hierarchies that unstructured meshes build in
+/// synchronize(NODE_LOCATE_E|ELEM_LOCATE_E) are registered here under a
+/// hash of the geometry they index. A copy of a mesh, or the same mesh
+/// generated or read again, picks up the existing structures instead of
+/// building new ones. The registry only holds weak references, and shared
+/// structures are read-only: a mesh that needs to modify one calls detach()
+/// to get its own copy first.
+class SCISHARE MeshLocateCache
+{
+public:
+  typedef boost::uint64_t key_type;
+
+  /// How the element containing a point is found. AUTO_E adds a bounding
+  /// volume hierarchy when the search grid resolves the mesh poorly, which
+  /// happens in strongly graded meshes.
+  enum { GRID_E = 0, BVH_E = 1, AUTO_E = 2 };
+
+  static void set_elem_locate_method(int method);
+  static int elem_locate_method();
+
+  /// AUTO_E threshold on the number of elements in the fullest grid cell
+  static size_type bvh_bin_threshold() { return (128); }
+
+  /// Key for the structures of a mesh of the given type with these nodes
+  /// and element connectivity
+  template<class ELEMS>
+  static key_type geometry_key(const std::string& type,
+                               const std::vector<Core::Geometry::Point>& points,
+                               const std::vector<ELEMS>& elems,
+                               double epsilon)
+  {
+    Core::Datatypes::ContentHasher hasher;
+    hasher.add(type);
+    hasher.add(epsilon);
+    hasher.add(points.size());
+    if (!points.empty()) hasher.add(&(points[0]), points.size()*sizeof(Core::Geometry::Point));
+    hasher.add(elems.size());
+    if (!elems.empty()) hasher.add(&(elems[0]), elems.size()*sizeof(ELEMS));
+    return (hasher.value());
+  }
+
+  template<class T>
+  static boost::shared_ptr<T> find(key_type key, const std::string& name)
+  {
+    return (boost::static_pointer_cast<T>(find_structure(key,name)));
+  }
+
+  static void insert(key_type key, const std::string& name, boost::shared_ptr<void> structure);
+
+  /// Make sure a structure is not shared before it is modified. The
+  /// structure is first taken out of the registry, so a mesh built later
+  /// with the original geometry cannot pick up the modified one; if another
+  /// mesh still holds it, the caller gets its own copy.
+  template<class T>
+  static void detach(boost::shared_ptr<T>& structure)
+  {
+    if (!structure) return;
+    unregister(structure.get());
+    if (!structure.unique()) structure.reset(new T(*structure));
+  }
+
+private:
+  static boost::shared_ptr<void> find_structure(key_type key, const std::string& name);
+  static void unregister(const void* structure);
+};
+
+} // end namespace SCIRun
+
+#endif
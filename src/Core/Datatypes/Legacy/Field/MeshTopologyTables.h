@@ -0,0 +1,184 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_DATATYPES_MESHTOPOLOGYTABLES_H
+#define CORE_DATATYPES_MESHTOPOLOGYTABLES_H 1
+
+#include <Core/Datatypes/Mesh/MeshTraits.h>
+#include <Core/Datatypes/Legacy/Field/MeshAdjacency.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace SCIRun {
+
+/// Helpers for building the edge, face and node neighbor tables of the
+/// unstructured meshes in synchronize(). Instead of inserting every element
+/// face or edge into a hash table one at a time, each element writes its
+/// entries into its own slots of a flat array, the array is sorted in
+/// parallel, and each run of equal node keys becomes one table entry.
+
+/// One face or edge as seen from one element: the node key that is the same
+/// for every element sharing it, and the combined element/local index that
+/// the mesh stores in its tables.
+template <class INDEX, int N>
+struct MeshTopologyEntry
+{
+  INDEX nodes_[N];
+  INDEX code_;
+
+  bool same_nodes(const MeshTopologyEntry& e) const
+  {
+    for (int k = 0; k < N; k++)
+      if (nodes_[k] != e.nodes_[k]) return (false);
+    return (true);
+  }
+
+  /// Sorts by node key first, so that entries within a run keep element order
+  bool operator<(const MeshTopologyEntry& e) const
+  {
+    for (int k = 0; k < N; k++)
+      if (nodes_[k] != e.nodes_[k]) return (nodes_[k] < e.nodes_[k]);
+    return (code_ < e.code_);
+  }
+};
+
+/// Reorders the nodes of an already rotated quadrilateral face so that both
+/// elements sharing it produce the same key. The first and third node stay
+/// in place and the second and fourth are swapped when the face is seen from
+/// the other side; a face collapsed to a triangle has its last node repeated.
+template <class INDEX>
+inline void orient_face_key(INDEX nodes[4])
+{
+  if (nodes[2] == nodes[3])
+  {
+    if (nodes[2] < nodes[1]) { nodes[3] = nodes[1]; nodes[1] = nodes[2]; nodes[2] = nodes[3]; }
+  }
+  else if (nodes[3] < nodes[1])
+  {
+    std::swap(nodes[1], nodes[3]);
+  }
+}
+
+/// Sorts the entries and returns the offset of every run of equal node keys,
+/// followed by the number of entries. Entries whose first node is
+/// MESH_NO_NEIGHBOR mark degenerate faces or edges and are dropped.
+template <class ENTRY>
+std::vector<size_t> group_topology_entries(std::vector<ENTRY>& entries)
+{
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+    [](const ENTRY& e) { return (e.nodes_[0] == MESH_NO_NEIGHBOR); }), entries.end());
+
+  Core::Thread::Parallel::Sort(entries.begin(), entries.end());
+
+  const auto chunks = Core::Thread::Parallel::Partition(0, entries.size());
+  std::vector<std::vector<size_t> > starts(chunks.size());
+  Core::Thread::Parallel::For(0, chunks.size(), [&](size_t first, size_t last)
+  {
+    for (size_t c = first; c < last; c++)
+      for (size_t i = chunks[c].first; i < chunks[c].second; i++)
+        if (i == 0 || !entries[i].same_nodes(entries[i-1])) starts[c].push_back(i);
+  }, 1);
+
+  std::vector<size_t> runs;
+  for (const auto& s : starts) runs.insert(runs.end(), s.begin(), s.end());
+  runs.push_back(entries.size());
+  return (runs);
+}
+
+/// Fills a per node adjacency table from (node, value) pairs. The pairs are
+/// sorted into a compressed row layout, in increasing value order within a
+/// row, and converted by value_of in parallel.
+template <class INDEX, class VALUE>
+void fill_node_table(std::vector<std::pair<INDEX, INDEX> >& pairs, size_t num_nodes,
+                     MeshAdjacency<INDEX>& table, VALUE value_of)
+{
+  Core::Thread::Parallel::Sort(pairs.begin(), pairs.end());
+
+  // Every position where the node changes opens the rows of that node and of
+  // any nodes skipped since the previous one, so chunks write disjoint rows
+  std::vector<size_t> offsets(num_nodes + 1, pairs.size());
+  Core::Thread::Parallel::For(0, pairs.size(), [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; i++)
+    {
+      if (i > 0 && pairs[i-1].first == pairs[i].first) continue;
+      const size_t prev = (i == 0) ? 0 : static_cast<size_t>(pairs[i-1].first) + 1;
+      for (size_t n = prev; n <= static_cast<size_t>(pairs[i].first); n++) offsets[n] = i;
+    }
+  });
+
+  std::vector<INDEX> values(pairs.size());
+  Core::Thread::Parallel::For(0, pairs.size(), [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; i++) values[i] = value_of(pairs[i].second);
+  });
+  std::vector<std::pair<INDEX, INDEX> >().swap(pairs);
+
+  table.assign(offsets, values);
+}
+
+/// Builds a per node adjacency table in parallel from a function that
+/// fills the row of one node, row_of(node, row), such as one of the per node
+/// accessors of a mesh. Each chunk of nodes collects its rows separately and
+/// the chunks are concatenated in node order.
+template <class INDEX, class ROW>
+void build_node_table(size_t num_nodes, MeshAdjacency<INDEX>& table, ROW row_of)
+{
+  const auto chunks = Core::Thread::Parallel::Partition(0, num_nodes);
+  std::vector<std::vector<INDEX> > values(chunks.size());
+  std::vector<size_t> offsets(num_nodes + 1, 0);
+  Core::Thread::Parallel::For(0, chunks.size(), [&](size_t first, size_t last)
+  {
+    std::vector<INDEX> row;
+    for (size_t c = first; c < last; c++)
+      for (size_t n = chunks[c].first; n < chunks[c].second; n++)
+      {
+        row.clear();
+        row_of(static_cast<INDEX>(n), row);
+        values[c].insert(values[c].end(), row.begin(), row.end());
+        offsets[n+1] = row.size();
+      }
+  }, 1);
+
+  for (size_t n = 0; n < num_nodes; n++) offsets[n+1] += offsets[n];
+  std::vector<INDEX> flat;
+  flat.reserve(offsets[num_nodes]);
+  for (auto& v : values)
+  {
+    flat.insert(flat.end(), v.begin(), v.end());
+    std::vector<INDEX>().swap(v);
+  }
+
+  table.assign(offsets, flat);
+}
+
+} // end namespace SCIRun
+
+#endif
@@ -53,6 +53,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTables.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
 
@@ -1719,9 +1720,10 @@ protected:
                 "Edge not found in PrismVolMesh::edge_table_");
       // Insert all cells that share this edge into
       // the unique set of cell indices
-      for (size_t c = 0; c < (iter->first).cells_.size(); c++)
+      const PEdge& edge = edges_[iter->second];
+      for (size_t c = 0; c < edge.cells_.size(); c++)
         unique_cells.insert(static_cast<typename ARRAY::value_type>(
-                                                    (iter->first).cells_[c]));
+                                                    edge.cells_[c]));
     }
 
     // Copy the unique set of cells to our Cells array return argument
@@ -1834,11 +1836,11 @@ protected:
   {
     ASSERTMSG(synchronized_ & NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on PrismVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
-    array.resize(sz);
-    for (size_t i=0; i< sz; i++)
+    const typename node_table_type::Row neighbors = node_neighbors_[node];
+    array.resize(neighbors.size());
+    for (size_t i=0; i< neighbors.size(); i++)
     {
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[node][i]);
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]);
     }
   }
 
@@ -2498,15 +2500,6 @@ protected:
   std::vector<PEdge>            edges_;
   edge_ht                  edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2559,31 +2552,13 @@ protected:
     return (true);
   }
 
-  /// useful functors
-  struct FillNodeNeighbors {
-    FillNodeNeighbors(std::vector<std::vector<typename Node::index_type> > &n,
-                      const PrismVolMesh &m) :
-      nbor_vec_(n),
-      mesh_(m)
-    {}
-
-    void operator()(typename Edge::index_type e) {
-      mesh_.get_nodes(nodes_, e);
-      nbor_vec_[nodes_[0]].push_back(nodes_[1]);
-      nbor_vec_[nodes_[1]].push_back(nodes_[0]);
-    }
-
-    std::vector<std::vector<typename Node::index_type> > &nbor_vec_;
-    const PrismVolMesh            &mesh_;
-    typename Node::array_type   nodes_;
-  };
-
   /// This grid is used as an acceleration structure to expedite calls
   ///  to locate.  For each cell in the grid, we store a list of which
   ///  tets overlap that grid cell -- to find the tet which contains a
   ///  point, we simply find which grid cell contains that point, and
   ///  then search just those tets that overlap that grid cell.
-  std::vector<std::vector<typename Node::index_type> > node_neighbors_;
+  typedef MeshAdjacency<index_type> node_table_type;
+  node_table_type node_neighbors_;
 
   std::vector<unsigned char> boundary_faces_;
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
@@ -2888,99 +2863,77 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
+PrismVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
+  face_table_.clear();
 
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
+  // Every cell writes its 5 faces, each entered CCW from outside looking in,
+  // into its own slots; sorting then brings the cells sharing a face together
+  typedef MeshTopologyEntry<index_type,4> face_entry;
+  static const int face_nodes[5][4] = { {0,1,2,-1}, {5,4,3,-1}, {1,4,5,2},
+                                        {2,5,3,0}, {0,3,4,1} };
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  const size_t num_cells = cells_.size() / 6;
+  std::vector<face_entry> entries(5*num_cells);
+
+  Core::Thread::Parallel::For(0, num_cells, [&](size_t first, size_t last)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
+    for (size_t c = first; c < last; c++)
     {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const under_type* nodes = &cells_[6*c];
+      for (int f = 0; f < 5; f++)
+      {
+        face_entry& e = entries[5*c+f];
+        for (int k = 0; k < 4; k++)
+          e.nodes_[k] = (face_nodes[f][k] < 0) ?
+            static_cast<index_type>(PRISM_DUMMY_NODE_INDEX) : nodes[face_nodes[f][k]];
+        e.code_ = static_cast<index_type>((c<<3)+f);
+
+        // Reorder nodes while maintaining CCW or CW orientation; degenerate
+        // faces (opposite corners equal, or more than two nodes equal) are
+        // dropped
+        if (order_face_nodes(e.nodes_[0],e.nodes_[1],e.nodes_[2],e.nodes_[3]))
+          orient_face_key(e.nodes_);
+        else
+          e.nodes_[0] = MESH_NO_NEIGHBOR;
+      }
     }
-  }
-}
+  });
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
+  // dump faces into the faces_ container.
+  const std::vector<size_t> runs = group_topology_entries(entries);
+  const size_t num_faces = runs.size() - 1;
+  faces_.resize(num_faces);
 
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
+  Core::Thread::Parallel::For(0, num_faces, [&](size_t first, size_t last)
   {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
-
-    ++ci;
-  }
+    for (size_t f = first; f < last; f++)
+    {
+      const face_entry& e = entries[runs[f]];
+      faces_[f] = PFace(e.nodes_[0],e.nodes_[1],e.nodes_[2],e.nodes_[3]);
 
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
+      // Only the first two different cells are kept; a third one, or a cell
+      // listing the same face twice, means the mesh is broken
+      typename Cell::index_type* cells = faces_[f].cells_;
+      cells[0] = e.code_;
+      for (size_t i = runs[f]+1; i < runs[f+1] && cells[1] == MESH_NO_NEIGHBOR; i++)
+        if ((entries[i].code_>>3) != (cells[0]>>3)) cells[1] = entries[i].code_;
+    }
+  });
 
   boundary_faces_.resize(cells_.size() /6);
+  face_table_.reserve(num_faces);
 
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
+  for (size_t f = 0; f < num_faces; f++)
   {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
+    face_table_[faces_[f]] = static_cast<index_type>(f);
 
-    if ((*f_iter).cells_[1] == -1)
+    if (faces_[f].cells_[1] == -1)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
+      index_type cell = (faces_[f].cells_[0]) >> 3;
+      index_type face = (faces_[f].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++f_iter; ++ht_iter; i++;
   }
 
   synchronize_lock_.lock();
@@ -2988,65 +2941,57 @@ PrismVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
+  typedef MeshTopologyEntry<index_type,2> edge_entry;
+  static const int edge_nodes[9][2] = { {0,1}, {1,2}, {2,0},
+                                        {3,4}, {4,5}, {5,3},
+                                        {0,3}, {4,1}, {2,5} };
 
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
+  const size_t num_cells = cells_.size() / 6;
+  std::vector<edge_entry> entries(9*num_cells);
 
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
+  Core::Thread::Parallel::For(0, num_cells, [&](size_t first, size_t last)
+  {
+    for (size_t c = first; c < last; c++)
+    {
+      const under_type* nodes = &cells_[6*c];
+      for (int k = 0; k < 9; k++)
+      {
+        const index_type n1 = nodes[edge_nodes[k][0]];
+        const index_type n2 = nodes[edge_nodes[k][1]];
+        edge_entry& e = entries[9*c+k];
+        // collapsed edges are dropped
+        e.nodes_[0] = (n1 == n2) ? MESH_NO_NEIGHBOR : std::min(n1,n2);
+        e.nodes_[1] = std::max(n1,n2);
+        e.code_ = static_cast<index_type>(c);
+      }
+    }
+  });
 
   // dump edges into the edges_ container.
+  const std::vector<size_t> runs = group_topology_entries(entries);
+  const size_t num_edges = runs.size() - 1;
+  edges_.resize(num_edges);
 
-  edges_.resize(edge_table_.size());
+  Core::Thread::Parallel::For(0, num_edges, [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; i++)
+    {
+      const edge_entry& e = entries[runs[i]];
+      edges_[i] = PEdge(e.nodes_[0],e.nodes_[1]);
+      for (size_t j = runs[i]; j < runs[i+1]; j++)
+        edges_[i].cells_.push_back(entries[j].code_);
+    }
+  });
 
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
+  edge_table_.reserve(num_edges);
+  for (size_t i = 0; i < num_edges; i++)
+  {
+    edge_table_[PEdge(edges_[i].nodes_[0],edges_[i].nodes_[1])] =
+      static_cast<typename Edge::index_type>(i);
   }
 
   synchronize_lock_.lock();
@@ -3339,11 +3284,19 @@ template <class Basis>
 void
 PrismVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  typename Edge::iterator ei, eie;
-  begin(ei); end(eie);
-  std::for_each(ei, eie, FillNodeNeighbors(node_neighbors_, *this));
+  // Both ends of every edge list the other end, in edge order
+  std::vector<std::pair<index_type,index_type> > ends(2*edges_.size());
+  Core::Thread::Parallel::For(0, edges_.size(), [&](size_t first, size_t last)
+  {
+    for (size_t e = first; e < last; e++)
+    {
+      ends[2*e] = std::make_pair(static_cast<index_type>(edges_[e].nodes_[0]), static_cast<index_type>(2*e));
+      ends[2*e+1] = std::make_pair(static_cast<index_type>(edges_[e].nodes_[1]), static_cast<index_type>(2*e+1));
+    }
+  });
+
+  fill_node_table(ends, points_.size(), node_neighbors_,
+    [this](index_type end) { return edges_[end>>1].nodes_[(end&1)^1]; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -32,8 +32,12 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateCache.h>
+#include <Core/Datatypes/Legacy/Field/MeshAdjacency.h>
 
 #include <gtest/gtest.h>
+#include <map>
+#include <set>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -70,3 +74,388 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
 }
 
 
+
+namespace
+{
+  // Lattice of n^3 cubes, each split into six tets, with nodes pulled
+  // towards the origin so the cells there are far smaller than elsewhere
+  FieldHandle GradedTetVol(int n)
+  {
+    FieldInformation fi("TetVolMesh", 1, "double");
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    for (int k = 0; k <= n; k++)
+      for (int j = 0; j <= n; j++)
+        for (int i = 0; i <= n; i++)
+        {
+          const double x = static_cast<double>(i)/n, y = static_cast<double>(j)/n, z = static_cast<double>(k)/n;
+          mesh->add_point(Point(x*x*x*x, y*y*y*y, z*z*z*z));
+        }
+
+    const int tets[6][4] = { {0,1,2,6}, {0,2,3,6}, {0,3,7,6}, {0,7,4,6}, {0,4,5,6}, {0,5,1,6} };
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+        {
+          auto node = [n](int a, int b, int c) { return static_cast<VMesh::index_type>((c*(n+1)+b)*(n+1)+a); };
+          const VMesh::index_type cube[8] = {
+            node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+            node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+          for (int t = 0; t < 6; t++)
+          {
+            VMesh::Node::array_type nodes(4);
+            for (int v = 0; v < 4; v++) nodes[v] = cube[tets[t][v]];
+            mesh->add_elem(nodes);
+          }
+        }
+    field->vfield()->resize_values();
+    return field;
+  }
+}
+
+TEST(TetVolMeshTest, LocateWithBVHMatchesGrid)
+{
+  FieldHandle gridField = GradedTetVol(8);
+  FieldHandle bvhField = GradedTetVol(8);
+
+  MeshLocateCache::set_elem_locate_method(MeshLocateCache::GRID_E);
+  gridField->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+  MeshLocateCache::set_elem_locate_method(MeshLocateCache::BVH_E);
+  bvhField->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+  MeshLocateCache::set_elem_locate_method(MeshLocateCache::AUTO_E);
+
+  VMesh* gridMesh = gridField->vmesh();
+  VMesh* bvhMesh = bvhField->vmesh();
+  for (int t = 0; t < 500; t++)
+  {
+    // Half of the samples fall in the refined corner, a few lie outside
+    const double s = (t % 2 == 0) ? 0.01 : 1.05;
+    Point p(s*((t*37)%101)/100.0, s*((t*53)%103)/102.0, s*((t*71)%107)/106.0);
+
+    VMesh::Elem::index_type gridElem = -1, bvhElem = -1;
+    const bool inGrid = gridMesh->locate(gridElem, p);
+    const bool inBVH = bvhMesh->locate(bvhElem, p);
+    ASSERT_EQ(inGrid, inBVH) << p;
+    if (inBVH)
+    {
+      VMesh::coords_type coords;
+      EXPECT_TRUE(bvhMesh->get_coords(coords, p, bvhElem));
+    }
+  }
+}
+
+TEST(TetVolMeshTest, CopyLocatesAfterItsNodesMove)
+{
+  FieldHandle field = GradedTetVol(4);
+  field->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+
+  // A copy must not reuse the search grid of the original once it differs
+  MeshHandle copy(field->mesh()->clone());
+  VMesh* mesh = copy->vmesh();
+  VMesh::Node::size_type num_nodes;
+  mesh->size(num_nodes);
+  for (VMesh::Node::index_type i(0); i < num_nodes; ++i)
+  {
+    Point p;
+    mesh->get_center(p, i);
+    mesh->set_point(p + Vector(2.0, 0.0, 0.0), i);
+  }
+  mesh->clear_synchronization();
+  copy->synchronize(Mesh::ELEM_LOCATE_E);
+
+  VMesh::Elem::index_type elem = -1;
+  EXPECT_TRUE(mesh->locate(elem, Point(2.5, 0.5, 0.5)));
+  elem = -1;
+  EXPECT_FALSE(mesh->locate(elem, Point(0.5, 0.5, 0.5)));
+  elem = -1;
+  EXPECT_TRUE(field->vmesh()->locate(elem, Point(0.5, 0.5, 0.5)));
+}
+
+namespace
+{
+  // Splits the six tets of the last cube at a point next to their first
+  // node. The split keeps the first three nodes in the original tet, whose
+  // box then no longer reaches the far corner of the cube, so the search grid
+  // is edited in place
+  void SplitLastCube(VMesh* mesh)
+  {
+    const VMesh::size_type num_elems = mesh->num_elems();
+    for (VMesh::Elem::index_type e(num_elems - 6); e < num_elems; ++e)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, e);
+      Point p(0.0, 0.0, 0.0);
+      for (size_t n = 0; n < nodes.size(); n++)
+      {
+        Point q;
+        mesh->get_center(q, nodes[n]);
+        p += (n == 0 ? 0.97 : 0.01) * Vector(q);
+      }
+      VMesh::Elem::array_type newelems;
+      VMesh::Node::index_type newnode;
+      mesh->insert_node_into_elem(newelems, newnode, e, p);
+    }
+  }
+
+  // Locates points close to each corner of every tet and checks that the tet is found
+  void ExpectLocatesOwnElems(VMesh* mesh)
+  {
+    const VMesh::size_type num_elems = mesh->num_elems();
+    for (VMesh::Elem::index_type e(0); e < num_elems; ++e)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, e);
+      for (size_t corner = 0; corner < nodes.size(); corner++)
+      {
+        Point p(0.0, 0.0, 0.0);
+        for (size_t n = 0; n < nodes.size(); n++)
+        {
+          Point q;
+          mesh->get_center(q, nodes[n]);
+          p += (n == corner ? 0.7 : 0.1) * Vector(q);
+        }
+        VMesh::Elem::index_type found;
+        ASSERT_TRUE(mesh->locate(found, p)) << p;
+        EXPECT_EQ(e, found) << p;
+      }
+    }
+  }
+}
+
+TEST(TetVolMeshTest, EditingAMeshLeavesTheGridOfAnIdenticalMeshAlone)
+{
+  // A hierarchy would be rebuilt from the mesh itself; the grid is what is shared
+  MeshLocateCache::set_elem_locate_method(MeshLocateCache::GRID_E);
+
+  // Identical mesh built after the edit, when the edited mesh held the only
+  // reference to the registered grid
+  {
+    FieldHandle edited = GradedTetVol(3);
+    edited->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+    SplitLastCube(edited->vmesh());
+
+    FieldHandle after = GradedTetVol(3);
+    after->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+    ExpectLocatesOwnElems(after->vmesh());
+  }
+
+  // Identical mesh sharing the grid while the other one is edited
+  {
+    FieldHandle edited = GradedTetVol(3);
+    edited->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+    FieldHandle before = GradedTetVol(3);
+    before->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+    SplitLastCube(edited->vmesh());
+
+    ExpectLocatesOwnElems(before->vmesh());
+  }
+  MeshLocateCache::set_elem_locate_method(MeshLocateCache::AUTO_E);
+}
+
+TEST(TetVolMeshTest, TopologyTablesMatchBruteForce)
+{
+  FieldHandle field = GradedTetVol(5);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E | Mesh::ELEM_NEIGHBORS_E);
+
+  std::set<std::vector<VMesh::index_type> > edges;
+  std::map<std::vector<VMesh::index_type>, std::vector<VMesh::index_type> > faces;
+  std::map<VMesh::index_type, size_t> nodeUse;
+
+  VMesh::Elem::size_type num_elems;
+  mesh->size(num_elems);
+  for (VMesh::Elem::index_type e(0); e < num_elems; ++e)
+  {
+    VMesh::Node::array_type nodes;
+    mesh->get_nodes(nodes, e);
+    for (size_t i = 0; i < 4; i++)
+    {
+      nodeUse[nodes[i]]++;
+      for (size_t j = i + 1; j < 4; j++)
+        edges.insert({ std::min(nodes[i], nodes[j]), std::max(nodes[i], nodes[j]) });
+      std::vector<VMesh::index_type> face;
+      for (size_t j = 0; j < 4; j++)
+        if (j != i) face.push_back(nodes[j]);
+      std::sort(face.begin(), face.end());
+      faces[face].push_back(e);
+    }
+  }
+
+  VMesh::Edge::size_type num_edges;
+  mesh->size(num_edges);
+  EXPECT_EQ(edges.size(), num_edges);
+  VMesh::Face::size_type num_faces;
+  mesh->size(num_faces);
+  EXPECT_EQ(faces.size(), num_faces);
+
+  for (const auto& use : nodeUse)
+  {
+    VMesh::Elem::array_type elems;
+    mesh->get_elems(elems, VMesh::Node::index_type(use.first));
+    EXPECT_EQ(use.second, elems.size());
+  }
+
+  for (VMesh::Face::index_type f(0); f < num_faces; ++f)
+  {
+    VMesh::Node::array_type nodes;
+    mesh->get_nodes(nodes, f);
+    std::vector<VMesh::index_type> face(nodes.begin(), nodes.end());
+    std::sort(face.begin(), face.end());
+    const auto& cells = faces[face];
+    ASSERT_FALSE(cells.empty());
+
+    VMesh::Elem::index_type neighbor;
+    const bool shared = mesh->get_neighbor(neighbor, VMesh::Elem::index_type(cells[0]), VMesh::DElem::index_type(f));
+    ASSERT_EQ(cells.size() == 2, shared);
+    if (shared)
+    {
+      EXPECT_EQ(cells[1], neighbor);
+    }
+  }
+}
+
+namespace
+{
+  // Elements around every node, collected from the element nodes
+  std::vector<std::vector<VMesh::index_type> > NodeElemsFromElems(VMesh* mesh)
+  {
+    std::vector<std::vector<VMesh::index_type> > node_elems(mesh->num_nodes());
+    VMesh::Elem::size_type num_elems;
+    mesh->size(num_elems);
+    for (VMesh::Elem::index_type e(0); e < num_elems; ++e)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, e);
+      for (size_t i = 0; i < nodes.size(); i++)
+        node_elems[nodes[i]].push_back(e);
+    }
+    return node_elems;
+  }
+}
+
+TEST(TetVolMeshTest, AdjacencyTablesMatchPerNodeCalls)
+{
+  FieldHandle field = GradedTetVol(4);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  VMesh::adjacency_type elems, nodes;
+  mesh->get_elem_adjacency(elems);
+  mesh->get_node_adjacency(nodes);
+  ASSERT_EQ(mesh->num_nodes(), elems.size());
+  ASSERT_EQ(mesh->num_nodes(), nodes.size());
+
+  for (VMesh::Node::index_type n(0); n < mesh->num_nodes(); ++n)
+  {
+    VMesh::Elem::array_type e;
+    mesh->get_elems(e, n);
+    EXPECT_EQ(std::vector<VMesh::index_type>(e.begin(), e.end()),
+              std::vector<VMesh::index_type>(elems[n].begin(), elems[n].end()));
+
+    VMesh::Node::array_type nn;
+    mesh->get_neighbors(nn, n);
+    EXPECT_EQ(std::vector<VMesh::index_type>(nn.begin(), nn.end()),
+              std::vector<VMesh::index_type>(nodes[n].begin(), nodes[n].end()));
+  }
+}
+
+TEST(TetVolMeshTest, NodeNeighborsFollowInsertedNodes)
+{
+  FieldHandle field = GradedTetVol(3);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  // Every insertion rewrites one tet and adds three, editing the rows of the
+  // nodes involved in place
+  for (VMesh::Elem::index_type e(0); e < 20; e += 3)
+  {
+    const VMesh::size_type num_elems = mesh->num_elems();
+    Point center;
+    mesh->get_center(center, e);
+    VMesh::Elem::array_type newelems;
+    VMesh::Node::index_type newnode;
+    mesh->insert_node_into_elem(newelems, newnode, e, center);
+    ASSERT_EQ(num_elems + 3, mesh->num_elems());
+  }
+
+  const auto expected = NodeElemsFromElems(mesh);
+  for (VMesh::Node::index_type n(0); n < mesh->num_nodes(); ++n)
+  {
+    VMesh::Elem::array_type e;
+    mesh->get_elems(e, n);
+    std::vector<VMesh::index_type> found(e.begin(), e.end());
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(expected[n], found);
+  }
+}
+
+TEST(TetVolMeshTest, AdjacencyCompactsAfterManyRowMoves)
+{
+  // Growing rows in turn moves every row to the end of the array again and again
+  const size_t num_rows = 200;
+  MeshAdjacency<VMesh::index_type> table;
+  std::vector<std::vector<VMesh::index_type>> expected(num_rows);
+  for (size_t r = 0; r < num_rows; r++)
+    table.add_row();
+
+  for (VMesh::index_type v = 0; v < 50; v++)
+  {
+    for (size_t r = 0; r < num_rows; r++)
+    {
+      table.push_back(r, v);
+      expected[r].push_back(v);
+    }
+    for (size_t r = 0; v > 0 && r < num_rows; r += 7)
+    {
+      ASSERT_TRUE(table.erase(r, v - 1));
+      expected[r].erase(std::find(expected[r].begin(), expected[r].end(), v - 1));
+    }
+
+    size_t live = 0;
+    for (const auto& row : expected)
+      live += row.size();
+    EXPECT_LE(table.stale(), std::max<size_t>(live, 1024));
+  }
+
+  ASSERT_EQ(num_rows, table.size());
+  for (size_t r = 0; r < num_rows; r++)
+    EXPECT_EQ(expected[r], std::vector<VMesh::index_type>(table[r].begin(), table[r].end()));
+
+  table.compact();
+  EXPECT_EQ(0, table.stale());
+  for (size_t r = 0; r < num_rows; r++)
+    EXPECT_EQ(expected[r], std::vector<VMesh::index_type>(table[r].begin(), table[r].end()));
+}
+
+TEST(TetVolMeshTest, AdjacencyRowMovesReallocateRarely)
+{
+  // Row 0 is never edited, so its storage only moves when the value array is
+  // reallocated or compacted; both have to stay rare while the other rows grow
+  const size_t num_rows = 200;
+  MeshAdjacency<VMesh::index_type> table;
+  const VMesh::index_type fixed = 7;
+  table.add_row(&fixed, &fixed + 1);
+  for (size_t r = 0; r < num_rows; r++)
+    table.add_row();
+
+  size_t pushes = 0, moves = 0;
+  const VMesh::index_type* storage = table[0].begin();
+  for (VMesh::index_type v = 0; v < 50; v++)
+  {
+    for (size_t r = 1; r <= num_rows; r++)
+    {
+      table.push_back(r, v);
+      pushes++;
+      if (table[0].begin() != storage)
+      {
+        moves++;
+        storage = table[0].begin();
+      }
+    }
+  }
+
+  EXPECT_EQ(fixed, table[0][0]);
+  EXPECT_EQ(50, table[num_rows].size());
+  EXPECT_LT(moves, pushes / 10);
+}
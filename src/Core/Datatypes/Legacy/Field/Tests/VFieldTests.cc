@@ -30,6 +30,7 @@
 
 #include <Core/Datatypes/Legacy/Field/Field.h> 
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Base/PropertyManager.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Testing/Utils/SCIRunFieldSamples.h>
 
@@ -97,6 +98,41 @@ TEST(VFieldTest, EmptyFieldAddValuesLinearBasis)
   ASSERT_EQ(vfield->num_values(), 0);
 }
 
+TEST(VFieldTest, ContentHashComparesMeshAndValues)
+{
+  FieldHandle field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  FieldHandle same = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  FieldHandle other = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  std::vector<double> values(4, 1.0);
+  field->vfield()->set_values(values);
+  same->vfield()->set_values(values);
+  values[2] = 2.0;
+  other->vfield()->set_values(values);
+
+  ASSERT_TRUE(!!field->contentHash());
+  EXPECT_EQ(*field->contentHash(), *same->contentHash());
+  EXPECT_NE(*field->contentHash(), *other->contentHash());
+  EXPECT_NE(*field->contentHash(), *TetrahedronTetVolConstantBasis(DOUBLE_E)->contentHash());
+}
+
+TEST(VFieldTest, ContentHashComparesProperties)
+{
+  FieldHandle field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  FieldHandle same = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  FieldHandle other = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  FieldHandle unhashable = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  field->properties().set_property("units", std::string("mm"), false);
+  same->properties().set_property("units", std::string("mm"), false);
+  other->properties().set_property("units", std::string("cm"), false);
+  unhashable->properties().set_property("units", std::vector<double>(1, 1.0), false);
+
+  ASSERT_TRUE(!!field->contentHash());
+  EXPECT_EQ(*field->contentHash(), *same->contentHash());
+  EXPECT_NE(*field->contentHash(), *other->contentHash());
+  EXPECT_NE(*field->contentHash(), *TetrahedronTetVolLinearBasis(DOUBLE_E)->contentHash());
+  EXPECT_FALSE(!!unhashable->contentHash());
+}
+
 TEST(VFieldTest, TetVolMeshAddValuesConstantBasis)
 {
   FieldHandle field = TetrahedronTetVolConstantBasis(DOUBLE_E);
@@ -192,3 +228,62 @@ TEST(VFieldTest, TetVolMeshSetFieldValueTest2)
 }
 
 
+
+TEST(VFieldTest, ValuesSpanMatchesStoredType)
+{
+  FieldHandle field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  VField *vfield = field->vfield();
+  std::vector<double> values = { 1.0, 2.0, 3.0, 4.0 };
+  vfield->set_values(values);
+
+  FieldDataSpan<double> span = vfield->values_span<double>();
+  ASSERT_EQ(span.size(), 4);
+  EXPECT_EQ(span.stride(), 1);
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(span[i], values[i]);
+
+  span[2] = 7.0;
+  double val;
+  vfield->get_value(val, 2);
+  EXPECT_EQ(val, 7.0);
+
+  EXPECT_TRUE(vfield->values_span<float>().empty());
+  EXPECT_TRUE(vfield->vector_component_span(0).empty());
+}
+
+TEST(VFieldTest, VectorComponentSpanIsStrided)
+{
+  FieldHandle field = TetrahedronTetVolLinearBasis(VECTOR_E);
+  VField *vfield = field->vfield();
+  for (int i = 0; i < 4; i++)
+    vfield->set_value(SCIRun::Core::Geometry::Vector(i, 10*i, 100*i), i);
+
+  FieldDataSpan<double> y = vfield->vector_component_span(1);
+  ASSERT_EQ(y.size(), 4);
+  EXPECT_EQ(y.stride(), 3);
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(y[i], 10.0*i);
+  EXPECT_TRUE(vfield->values_span<double>().empty());
+}
+
+TEST(VFieldTest, BatchWeightedValuesMatchSingleCalls)
+{
+  FieldHandle field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  VField *vfield = field->vfield();
+  std::vector<double> values = { 1.0, 2.0, 4.0, 8.0 };
+  vfield->set_values(values);
+
+  std::vector<VField::index_type> idx = { 0, 1, 2,  1, 2, 3,  3, 0, 2 };
+  std::vector<VField::weight_type> w = { 0.2, 0.3, 0.5,  1.0, 0.0, 0.0,  0.25, 0.25, 0.5 };
+  std::vector<double> batch;
+  vfield->get_weighted_values(batch, idx, w, 3);
+  ASSERT_EQ(batch.size(), 3);
+
+  for (size_t j = 0; j < batch.size(); j++)
+  {
+    double single;
+    vfield->get_weighted_value(single, &idx[3*j], &w[3*j], 3);
+    EXPECT_DOUBLE_EQ(batch[j], single);
+  }
+  EXPECT_DOUBLE_EQ(batch[0], 0.2*1.0 + 0.3*2.0 + 0.5*4.0);
+}
@@ -0,0 +1,286 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Thread/Parallel.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  typedef std::vector<VMesh::index_type> NodeSet;
+
+  NodeSet SortedNodes(NodeSet set)
+  {
+    std::sort(set.begin(), set.end());
+    set.erase(std::unique(set.begin(), set.end()), set.end());
+    return set;
+  }
+
+  // PrismVolMesh keys its triangular faces by orientation, so the cap shared
+  // by two stacked prisms is listed once for each of them
+  NodeSet FaceKey(const NodeSet& nodes, bool orientedTriangles)
+  {
+    NodeSet key(nodes);
+    if (orientedTriangles && key.size() == 3)
+      std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+    else
+      std::sort(key.begin(), key.end());
+    return key;
+  }
+
+  // Local element faces and edges, independent of the tables in the meshes
+  struct ElemTopology
+  {
+    std::vector<std::vector<int> > faces;
+    std::vector<std::vector<int> > edges;
+    bool orientedTriangles;
+  };
+
+  const ElemTopology& HexTopology()
+  {
+    static const ElemTopology hex = {
+      { {0,1,2,3}, {4,5,6,7}, {0,1,5,4}, {1,2,6,5}, {2,3,7,6}, {3,0,4,7} },
+      { {0,1}, {1,2}, {2,3}, {3,0}, {4,5}, {5,6}, {6,7}, {7,4}, {0,4}, {1,5}, {2,6}, {3,7} },
+      false };
+    return hex;
+  }
+
+  // Caps are listed the way the mesh enters them, CCW from outside
+  const ElemTopology& PrismTopology()
+  {
+    static const ElemTopology prism = {
+      { {0,1,2}, {5,4,3}, {0,1,4,3}, {1,2,5,4}, {2,0,3,5} },
+      { {0,1}, {1,2}, {2,0}, {3,4}, {4,5}, {5,3}, {0,3}, {1,4}, {2,5} },
+      true };
+    return prism;
+  }
+
+  // Lattice of n^3 graded cubes, each one hex or split into two prisms
+  FieldHandle GradedVolume(const std::string& type, int n)
+  {
+    FieldInformation fi(type, 1, "double");
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    for (int k = 0; k <= n; k++)
+      for (int j = 0; j <= n; j++)
+        for (int i = 0; i <= n; i++)
+        {
+          const double x = static_cast<double>(i)/n, y = static_cast<double>(j)/n, z = static_cast<double>(k)/n;
+          mesh->add_point(Point(x*x, y*y*y, z));
+        }
+
+    const bool prisms = (type == "PrismVolMesh");
+    const int split[2][6] = { {0,1,2,4,5,6}, {0,2,3,4,6,7} };
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+        {
+          auto node = [n](int a, int b, int c) { return static_cast<VMesh::index_type>((c*(n+1)+b)*(n+1)+a); };
+          const VMesh::index_type cube[8] = {
+            node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+            node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+          if (prisms)
+          {
+            for (int p = 0; p < 2; p++)
+            {
+              VMesh::Node::array_type nodes(6);
+              for (int v = 0; v < 6; v++) nodes[v] = cube[split[p][v]];
+              mesh->add_elem(nodes);
+            }
+          }
+          else
+          {
+            VMesh::Node::array_type nodes(8);
+            for (int v = 0; v < 8; v++) nodes[v] = cube[v];
+            mesh->add_elem(nodes);
+          }
+        }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // Compares the edge, face and node tables with ones collected serially from
+  // the element nodes
+  void ExpectTopologyTablesMatchBruteForce(VMesh* mesh, const ElemTopology& topology)
+  {
+    mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E | Mesh::ELEM_NEIGHBORS_E);
+
+    std::set<NodeSet> edges;
+    std::map<NodeSet, std::vector<VMesh::index_type> > faces;
+    std::map<VMesh::index_type, size_t> nodeUse;
+
+    VMesh::Elem::size_type num_elems;
+    mesh->size(num_elems);
+    for (VMesh::Elem::index_type e(0); e < num_elems; ++e)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, e);
+      for (size_t i = 0; i < nodes.size(); i++)
+        nodeUse[nodes[i]]++;
+
+      std::set<NodeSet> elemFaces;
+      for (const auto& local : topology.edges)
+      {
+        NodeSet edge = { nodes[local[0]], nodes[local[1]] };
+        std::sort(edge.begin(), edge.end());
+        edges.insert(edge);
+      }
+      for (const auto& local : topology.faces)
+      {
+        NodeSet face;
+        for (size_t v = 0; v < local.size(); v++)
+          face.push_back(nodes[local[v]]);
+        faces[FaceKey(face, topology.orientedTriangles)].push_back(e);
+        elemFaces.insert(SortedNodes(face));
+      }
+
+      // The face table must hand every element exactly its own faces
+      VMesh::Face::array_type fv;
+      mesh->get_faces(fv, e);
+      std::set<NodeSet> foundFaces;
+      for (size_t i = 0; i < fv.size(); i++)
+      {
+        VMesh::Node::array_type fn;
+        mesh->get_nodes(fn, fv[i]);
+        foundFaces.insert(SortedNodes(NodeSet(fn.begin(), fn.end())));
+      }
+      EXPECT_EQ(elemFaces, foundFaces);
+    }
+
+    VMesh::Edge::size_type num_edges;
+    mesh->size(num_edges);
+    std::set<NodeSet> foundEdges;
+    for (VMesh::Edge::index_type i(0); i < num_edges; ++i)
+    {
+      VMesh::Node::array_type en;
+      mesh->get_nodes(en, i);
+      foundEdges.insert(SortedNodes(NodeSet(en.begin(), en.end())));
+    }
+    EXPECT_EQ(edges.size(), num_edges);
+    EXPECT_EQ(edges, foundEdges);
+    VMesh::Face::size_type num_faces;
+    mesh->size(num_faces);
+    EXPECT_EQ(faces.size(), num_faces);
+
+    for (const auto& use : nodeUse)
+    {
+      VMesh::Elem::array_type elems;
+      mesh->get_elems(elems, VMesh::Node::index_type(use.first));
+      EXPECT_EQ(use.second, elems.size());
+    }
+
+    for (VMesh::Face::index_type f(0); f < num_faces; ++f)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, f);
+      const auto& cells = faces[FaceKey(NodeSet(nodes.begin(), nodes.end()), topology.orientedTriangles)];
+      ASSERT_FALSE(cells.empty());
+
+      VMesh::Elem::index_type neighbor;
+      const bool shared = mesh->get_neighbor(neighbor, VMesh::Elem::index_type(cells[0]), VMesh::DElem::index_type(f));
+      ASSERT_EQ(cells.size() == 2, shared);
+      if (shared)
+      {
+        EXPECT_EQ(cells[1], neighbor);
+      }
+    }
+  }
+
+  // The numbering of edges and faces must not depend on how the work was split
+  void ExpectTopologyTablesMatchSerialBuild(const std::string& type)
+  {
+    Parallel::SetMaximumCores(1);
+    FieldHandle serial = GradedVolume(type, 4);
+    serial->vmesh()->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E);
+    Parallel::SetMaximumCores(0);
+
+    FieldHandle parallel = GradedVolume(type, 4);
+    parallel->vmesh()->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E);
+
+    VMesh* smesh = serial->vmesh();
+    VMesh* pmesh = parallel->vmesh();
+    ASSERT_EQ(smesh->num_edges(), pmesh->num_edges());
+    ASSERT_EQ(smesh->num_faces(), pmesh->num_faces());
+
+    for (VMesh::Elem::index_type e(0); e < smesh->num_elems(); ++e)
+    {
+      VMesh::Edge::array_type se, pe;
+      smesh->get_edges(se, e);
+      pmesh->get_edges(pe, e);
+      EXPECT_EQ(NodeSet(se.begin(), se.end()), NodeSet(pe.begin(), pe.end()));
+
+      VMesh::Face::array_type sf, pf;
+      smesh->get_faces(sf, e);
+      pmesh->get_faces(pf, e);
+      EXPECT_EQ(NodeSet(sf.begin(), sf.end()), NodeSet(pf.begin(), pf.end()));
+    }
+
+    for (VMesh::Node::index_type n(0); n < smesh->num_nodes(); ++n)
+    {
+      VMesh::Elem::array_type se, pe;
+      smesh->get_elems(se, n);
+      pmesh->get_elems(pe, n);
+      EXPECT_EQ(NodeSet(se.begin(), se.end()), NodeSet(pe.begin(), pe.end()));
+    }
+  }
+}
+
+TEST(HexVolMeshTest, TopologyTablesMatchBruteForce)
+{
+  FieldHandle field = GradedVolume("HexVolMesh", 5);
+  ExpectTopologyTablesMatchBruteForce(field->vmesh(), HexTopology());
+}
+
+TEST(HexVolMeshTest, TopologyTablesMatchSerialBuild)
+{
+  ExpectTopologyTablesMatchSerialBuild("HexVolMesh");
+}
+
+TEST(PrismVolMeshTest, TopologyTablesMatchBruteForce)
+{
+  FieldHandle field = GradedVolume("PrismVolMesh", 5);
+  ExpectTopologyTablesMatchBruteForce(field->vmesh(), PrismTopology());
+}
+
+TEST(PrismVolMeshTest, TopologyTablesMatchSerialBuild)
+{
+  ExpectTopologyTablesMatchSerialBuild("PrismVolMesh");
+}
@@ -134,6 +134,9 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_adjacency(VMesh::adjacency_type& table) const;
+  virtual void get_node_adjacency(VMesh::adjacency_type& table) const;
+
   virtual void set_nodes(VMesh::Node::array_type&,
                          VMesh::Elem::index_type);
   
@@ -492,6 +495,22 @@ VTetVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
   this->mesh_->get_faces_from_cell(delems,idx);
 }
 
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_elem_adjacency(VMesh::adjacency_type& table) const
+{
+  build_node_table(this->mesh_->points_.size(), table,
+    [this](VMesh::index_type n, VMesh::array_type& row) { this->mesh_->get_cells_from_node(row, n); });
+}
+
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_node_adjacency(VMesh::adjacency_type& table) const
+{
+  build_node_table(this->mesh_->points_.size(), table,
+    [this](VMesh::index_type n, VMesh::array_type& row) { this->mesh_->get_node_neighbors(row, n); });
+}
+
 template <class MESH>
 void
 VTetVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
@@ -38,6 +38,7 @@
 #include <Core/Persistent/PersistentSTL.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/GeometryPrimitives/SearchBVHT.h>
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/CompGeom.h>
 #include <Core/GeometryPrimitives/Point.h>
@@ -52,6 +53,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateCache.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTables.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -1189,22 +1192,15 @@ public:
               "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
     // First check are we inside an element
-    SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          pdist = 0.0;
-          result = p;
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      pdist = 0.0;
+      result = p;
+      elem = static_cast<INDEX>(inside_idx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
 
     // If not start searching for the closest outer boundary
@@ -1706,10 +1702,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "TetVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>2);
+    const typename node_table_type::Row neighbors = node_neighbors_[idx];
+    array.resize(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]>>2);
   }
 
   template<class ARRAY, class INDEX>
@@ -1721,7 +1717,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_table_type::Row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1797,7 +1793,7 @@ protected:
       "TetVolMesh: Must call synchronize FACES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_table_type::Row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1933,21 +1929,21 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on TetVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const typename node_table_type::Row neighbors = node_neighbors_[node];
 
-    std::set<index_type> inserted;
-    for (size_t i = 0; i < sz; i++)
+    array.clear();
+    array.reserve(3*neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x3));
+      const index_type base = (neighbors[i]&(~0x3));
       for (index_type c = base; c < base+4; ++c)
       {
-        if (cells_[c] != node) inserted.insert(cells_[c]);
+        if (cells_[c] != node) array.push_back(cells_[c]);
       }
     }
 
-    array.clear();
-    array.reserve(inserted.size());
-    array.insert(array.begin(), inserted.begin(), inserted.end());
+    std::sort(array.begin(), array.end());
+    array.erase(std::unique(array.begin(), array.end()), array.end());
   }
 
   template <class INDEX>
@@ -2116,18 +2112,11 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          elem = static_cast<INDEX>(*it);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(inside_idx);
+      return (true);
     }
     return (false);
   }
@@ -2189,20 +2178,13 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(inside_idx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
 
     return (false);
@@ -2270,6 +2252,32 @@ protected:
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
+  Core::Geometry::BBox elem_locate_box(index_type ci) const;
+
+  /// Find the element containing p among the candidates of the element
+  /// BVH when it was built, or of the element grid otherwise
+  inline bool search_elem(index_type &elem, const Core::Geometry::Point &p) const
+  {
+    if (elem_bvh_)
+      return (elem_bvh_->lookup(elem, p, [this, &p](index_type idx) { return (inside(typename Elem::index_type(idx), p)); }));
+
+    typename SearchGridT<index_type>::iterator it, eit;
+    if (elem_grid_->lookup(it, eit, p))
+    {
+      while (it != eit)
+      {
+        const index_type idx = *it;
+        if (inside(typename Elem::index_type(idx), p))
+        {
+          elem = idx;
+          return (true);
+        }
+        ++it;
+      }
+    }
+    return (false);
+  }
+
   const Core::Geometry::Point &point(typename Node::index_type i) { return points_[i]; }
 
   template<class INDEX>
@@ -2550,9 +2558,7 @@ protected:
     }
   };
 
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
   using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
   using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
@@ -2574,11 +2580,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2588,16 +2589,14 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
                        index_type combined_index);
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  typedef MeshAdjacency<index_type> node_table_type;
+  /// Positions in cells_ that refer to each node
+  node_table_type node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2607,6 +2606,7 @@ protected:
   ///  then search just those tets that overlap that grid cell.
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
   boost::shared_ptr<SearchGridT<index_type> >  elem_grid_;
+  boost::shared_ptr<SearchBVHT<index_type> >  elem_bvh_; /// Built for graded meshes, see MeshLocateCache
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex                 synchronize_lock_;
@@ -2899,6 +2899,11 @@ TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
     synchronized_ |= BOUNDING_BOX_E;
   }
 
+  // The grids may be shared with other meshes; the element hierarchy is
+  // dropped and lookups fall back to the transformed grid
+  MeshLocateCache::detach(node_grid_);
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
 
@@ -2951,101 +2956,69 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
+TetVolMesh<Basis>::compute_faces()
 {
-  PFace f(n1, n2, n3);
+  // Every cell writes its 4 faces, each entered CCW from outside looking in,
+  // into its own slots; sorting then brings the cells sharing a face together
+  typedef MeshTopologyEntry<index_type,3> face_entry;
+  static const int face_nodes[4][3] = { {0,2,1}, {1,2,3}, {0,1,3}, {0,3,2} };
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  const size_t num_cells = cells_.size() >> 2;
+  std::vector<face_entry> entries(4*num_cells);
+
+  Core::Thread::Parallel::For(0, num_cells, [&](size_t first, size_t last)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
+    for (size_t c = first; c < last; c++)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const under_type* nodes = &cells_[4*c];
+      for (int f = 0; f < 4; f++)
+      {
+        PFaceNode key(nodes[face_nodes[f][0]], nodes[face_nodes[f][1]],
+                      nodes[face_nodes[f][2]]);
+        face_entry& e = entries[4*c+f];
+        for (int k = 0; k < 3; k++) e.nodes_[k] = static_cast<index_type>(key.nodes_[k]);
+        e.code_ = static_cast<index_type>(4*c+f);
+      }
     }
-  }
-}
-
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_faces()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
+  });
 
-  face_ht table;
+  const std::vector<size_t> runs = group_topology_entries(entries);
+  const size_t num_faces = runs.size() - 1;
+  faces_.resize(num_faces);
 
-  while (ci != cie)
+  Core::Thread::Parallel::For(0, num_faces, [&](size_t first, size_t last)
   {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
+    for (size_t f = first; f < last; f++)
+    {
+      // Only the first two different cells are kept; a third one, or a cell
+      // listing the same face twice, means the mesh is broken
+      index_type* cells = faces_[f].cells_;
+      cells[0] = entries[runs[f]].code_;
+      cells[1] = MESH_NO_NEIGHBOR;
+      for (size_t i = runs[f]+1; i < runs[f+1] && cells[1] == MESH_NO_NEIGHBOR; i++)
+        if ((entries[i].code_>>2) != (cells[0]>>2)) cells[1] = entries[i].code_;
+    }
+  });
 
   boundary_faces_.resize(cells_.size() >> 2);
+  face_table_.reserve(num_faces);
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  for (size_t f = 0; f < num_faces; f++)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
+    const face_entry& e = entries[runs[f]];
+    face_table_[PFaceNode(e.nodes_[0],e.nodes_[1],e.nodes_[2])] = static_cast<index_type>(f);
 
-    if (pface.cells_[1] == -1)
+    if (faces_[f].cells_[1] == -1)
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
+      index_type cell = (faces_[f].cells_[0]) >> 2;
+      index_type face = (faces_[f].cells_[0]) & 0x3;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
-
-
 }
 
 
@@ -3083,65 +3056,53 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
+  typedef MeshTopologyEntry<index_type,2> edge_entry;
+  static const int edge_nodes[6][2] = { {0,1}, {1,2}, {2,0}, {3,0}, {3,1}, {3,2} };
 
-  typename Node::array_type arr;
-  while (ci != cie)
+  const size_t num_cells = cells_.size() >> 2;
+  std::vector<edge_entry> entries(6*num_cells);
+
+  Core::Thread::Parallel::For(0, num_cells, [&](size_t first, size_t last)
   {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
+    for (size_t c = first; c < last; c++)
+    {
+      const under_type* nodes = &cells_[4*c];
+      for (int k = 0; k < 6; k++)
+      {
+        const index_type n1 = nodes[edge_nodes[k][0]];
+        const index_type n2 = nodes[edge_nodes[k][1]];
+        edge_entry& e = entries[6*c+k];
+        // collapsed edges are dropped
+        e.nodes_[0] = (n1 == n2) ? MESH_NO_NEIGHBOR : std::min(n1,n2);
+        e.nodes_[1] = std::max(n1,n2);
+        e.code_ = static_cast<index_type>((c<<3)+k);
+      }
+    }
+  });
 
-  edges_.resize(table.size());
+  const std::vector<size_t> runs = group_topology_entries(entries);
+  const size_t num_edges = runs.size() - 1;
+  edges_.resize(num_edges);
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  Core::Thread::Parallel::For(0, num_edges, [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; i++)
+    {
+      edges_[i].cells_.clear();
+      for (size_t j = runs[i]; j < runs[i+1]; j++)
+        edges_[i].cells_.push_back(entries[j].code_);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  edge_table_.reserve(num_edges);
+  for (size_t i = 0; i < num_edges; i++)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
+    const edge_entry& e = entries[runs[i]];
+    edge_table_[PEdgeNode(e.nodes_[0],e.nodes_[1])] = static_cast<index_type>(i);
   }
 
   synchronize_lock_.lock();
@@ -3316,6 +3277,7 @@ TetVolMesh<Basis>::clear_synchronization()
 
   node_grid_.reset();
   elem_grid_.reset();
+  elem_bvh_.reset();
 
   synchronize_lock_.unlock();
 
@@ -3543,7 +3505,7 @@ TetVolMesh<Basis>::create_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    node_neighbors_[cells_[i]].push_back(i);
+    node_neighbors_.push_back(cells_[i], i);
   }
 }
 
@@ -3554,17 +3516,9 @@ TetVolMesh<Basis>::delete_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    const index_type n = cells_[i];
-    typename std::vector<typename Cell::index_type>::iterator node_cells_end =
-      node_neighbors_[n].end();
-    typename std::vector<typename Cell::index_type>::iterator cell =
-      node_neighbors_[n].begin();
-    while (cell != node_cells_end && (*cell) != i) ++cell;
-
     /// ASSERT that the node_neighbors_ structure contains this cell
-    ASSERT(cell != node_cells_end);
-
-    node_neighbors_[n].erase(cell);
+    if (!node_neighbors_.erase(cells_[i], i))
+      ASSERTFAIL("TetVolMesh: node_neighbors_ does not contain this cell");
   }
 }
 
@@ -3672,13 +3626,16 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
+  // Each node lists the positions in cells_ that refer to it
+  std::vector<std::pair<index_type,index_type> > corners(cells_.size());
+  Core::Thread::Parallel::For(0, cells_.size(), [&](size_t first, size_t last)
   {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+    for (size_t i = first; i < last; i++)
+      corners[i] = std::make_pair(static_cast<index_type>(cells_[i]), static_cast<index_type>(i));
+  });
+
+  fill_node_table(corners, points_.size(), node_neighbors_,
+                  [](index_type i) { return i; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3721,12 +3678,9 @@ TetVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Node::ar
 }
 
 template <class Basis>
-void
-TetVolMesh<Basis>::insert_elem_into_grid(typename Cell::index_type ci)
+Core::Geometry::BBox
+TetVolMesh<Basis>::elem_locate_box(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3734,7 +3688,18 @@ TetVolMesh<Basis>::insert_elem_into_grid(typename Cell::index_type ci)
   box.extend(points_[cells_[idx+2]]);
   box.extend(points_[cells_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return (box);
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::insert_elem_into_grid(typename Cell::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
+  elem_grid_->insert(ci, elem_locate_box(ci));
 }
 
 
@@ -3742,14 +3707,9 @@ template <class Basis>
 void
 TetVolMesh<Basis>::remove_elem_from_grid(typename Cell::index_type ci)
 {
-  const index_type idx = ci*4;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
+  elem_grid_->remove(ci, elem_locate_box(ci));
 }
 
 template <class Basis>
@@ -3758,6 +3718,7 @@ TetVolMesh<Basis>::insert_node_into_grid(typename Node::index_type ni)
 {
   /// @todo:  This can crash if you insert a new cell outside of the grid.
   // Need to recompute grid at that point.
+  MeshLocateCache::detach(node_grid_);
   node_grid_->insert(ni,points_[ni]);
 }
 
@@ -3765,6 +3726,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::remove_node_from_grid(typename Node::index_type ni)
 {
+  MeshLocateCache::detach(node_grid_);
   node_grid_->remove(ni,points_[ni]);
 }
 
@@ -3788,14 +3750,44 @@ TetVolMesh<Basis>::compute_elem_grid()
     size_type sz = static_cast<size_type>(ceil(0.5+diag.z()/trace*s));
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
-    elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+    const MeshLocateCache::key_type key =
+      MeshLocateCache::geometry_key("TetVolMesh", points_, cells_, epsilon_);
+
+    elem_grid_ = MeshLocateCache::find<SearchGridT<index_type> >(key, "elem grid");
+    if (!elem_grid_)
+    {
+      elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+
+      typename Elem::iterator ci, cie;
+      begin(ci); end(cie);
+      while(ci != cie)
+      {
+        insert_elem_into_grid(*ci);
+        ++ci;
+      }
+      MeshLocateCache::insert(key, "elem grid", elem_grid_);
+    }
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
+    elem_bvh_.reset();
+    const int method = MeshLocateCache::elem_locate_method();
+    if (method == MeshLocateCache::BVH_E || (method == MeshLocateCache::AUTO_E &&
+        elem_grid_->max_bin_size() > MeshLocateCache::bvh_bin_threshold()))
     {
-      insert_elem_into_grid(*ci);
-      ++ci;
+      elem_bvh_ = MeshLocateCache::find<SearchBVHT<index_type> >(key, "elem bvh");
+      if (!elem_bvh_)
+      {
+        elem_bvh_.reset(new SearchBVHT<index_type>);
+
+        typename Elem::iterator ci, cie;
+        begin(ci); end(cie);
+        while(ci != cie)
+        {
+          elem_bvh_->insert(*ci, elem_locate_box(*ci));
+          ++ci;
+        }
+        elem_bvh_->build();
+        MeshLocateCache::insert(key, "elem bvh", elem_bvh_);
+      }
     }
   }
 
@@ -3825,14 +3817,22 @@ TetVolMesh<Basis>::compute_node_grid()
     size_type sz = static_cast<size_type>(ceil(0.5+diag.z()/trace*s));
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
-    node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+    const MeshLocateCache::key_type key =
+      MeshLocateCache::geometry_key("TetVolMesh", points_, cells_, epsilon_);
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
+    node_grid_ = MeshLocateCache::find<SearchGridT<index_type> >(key, "node grid");
+    if (!node_grid_)
     {
-      insert_node_into_grid(*ni);
-      ++ni;
+      node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+
+      typename Node::iterator ni, nie;
+      begin(ni); end(nie);
+      while(ni != nie)
+      {
+        insert_node_into_grid(*ni);
+        ++ni;
+      }
+      MeshLocateCache::insert(key, "node grid", node_grid_);
     }
   }
 
@@ -3890,7 +3890,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
       synchronize_lock_.lock();
-      node_neighbors_.push_back(std::vector<typename Cell::index_type>());
+      node_neighbors_.add_row();
       synchronize_lock_.unlock();
     }
     return static_cast<typename Node::index_type>(points_.size() - 1);
@@ -3917,6 +3917,12 @@ typename TetVolMesh<Basis>::Node::index_type
 TetVolMesh<Basis>::add_point(const Core::Geometry::Point &p)
 {
   points_.push_back(p);
+  if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
+  {
+    synchronize_lock_.lock();
+    node_neighbors_.add_row();
+    synchronize_lock_.unlock();
+  }
   return static_cast<typename Node::index_type>(points_.size() - 1);
 }
 
@@ -107,6 +107,9 @@ public:
                           VMesh::Face::index_type i) const;
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
+
+  virtual void get_elem_adjacency(VMesh::adjacency_type& table) const;
+  virtual void get_node_adjacency(VMesh::adjacency_type& table) const;
                           
   virtual void set_nodes(VMesh::Node::array_type&,
                          VMesh::Elem::index_type);
@@ -365,6 +368,22 @@ VTriSurfMesh<MESH>::get_delems(VMesh::DElem::array_type& delems,
   this->mesh_->get_edges_from_face(delems,i);
 }
 
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_elem_adjacency(VMesh::adjacency_type& table) const
+{
+  build_node_table(this->mesh_->points_.size(), table,
+    [this](VMesh::index_type n, VMesh::array_type& row) { this->mesh_->get_faces_from_node(row, n); });
+}
+
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_node_adjacency(VMesh::adjacency_type& table) const
+{
+  build_node_table(this->mesh_->points_.size(), table,
+    [this](VMesh::index_type n, VMesh::array_type& row) { this->mesh_->get_node_neighbors(row, n); });
+}
+
 template <class MESH>
 void 
 VTriSurfMesh<MESH>::set_nodes(VMesh::Node::array_type& nodes, 
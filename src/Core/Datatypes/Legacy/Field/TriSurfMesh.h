@@ -32,6 +32,8 @@
 /// Include what kind of support we want to have
 /// Need to fix this and couple it sci-defs
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateCache.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTables.h>
 
 #include <Core/Containers/StackVector.h>
 
@@ -42,6 +44,7 @@
 #include <Core/GeometryPrimitives/CompGeom.h>
 #include <Core/Containers/StackVector.h>
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/GeometryPrimitives/SearchBVHT.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
 #include <Core/Basis/Locate.h>
@@ -1547,9 +1550,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
 	      "TriSurfMesh: Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[idx][i]);
+    const typename node_table_type::Row faces = node_neighbors_[idx];
+    array.resize(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(faces[i]);
   }
 
 
@@ -1582,7 +1586,7 @@ protected:
               "Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
     // Get the table of faces that are connected to the two nodes
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const typename node_table_type::Row faces = node_neighbors_[idx];
     array.clear();
 
     typename ARRAY::value_type edge;
@@ -1710,7 +1714,7 @@ protected:
     array.clear();
 
     // Get all the neighboring elements
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const typename node_table_type::Row faces = node_neighbors_[idx];
     // Make a conservative estimate of the number of node neighbors
     array.reserve(2*faces.size());
 
@@ -1876,18 +1880,11 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
               "TriSurfMesh::locate_elem requires synchronize(ELEM_LOCATE_E).")
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside3_p((*it) * 3, p))
-        {
-          elem = static_cast<INDEX>(*it);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(inside_idx);
+      return (true);
     }
     return (false);
   }
@@ -1946,20 +1943,13 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
               "TriSurfMesh::locate_node requires synchronize(ELEM_LOCATE_E).")
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type inside_idx;
+    if (search_elem(inside_idx, p))
     {
-      while (it != eit)
-      {
-        if (inside3_p((*it) * 3, p))
-        {
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(inside_idx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
     return (false);
   }
@@ -2019,6 +2009,32 @@ protected:
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
+  Core::Geometry::BBox elem_locate_box(index_type ci) const;
+
+  /// Find the element containing p among the candidates of the element
+  /// BVH when it was built, or of the element grid otherwise
+  inline bool search_elem(index_type &elem, const Core::Geometry::Point &p) const
+  {
+    if (elem_bvh_)
+      return (elem_bvh_->lookup(elem, p, [this, &p](index_type idx) { return (inside3_p(idx*3, p)); }));
+
+    typename SearchGridT<index_type>::iterator it, eit;
+    if (elem_grid_->lookup(it, eit, p))
+    {
+      while (it != eit)
+      {
+        const index_type idx = *it;
+        if (inside3_p(idx*3, p))
+        {
+          elem = idx;
+          return (true);
+        }
+        ++it;
+      }
+    }
+    return (false);
+  }
+
   void debug_test_edge_neighbors();
 
   bool inside3_p(index_type face_times_three, const Core::Geometry::Point &p) const;
@@ -2033,11 +2049,13 @@ protected:
   std::vector<index_type>    faces_;               // Connectivity of this mesh
   std::vector<index_type>    edge_neighbors_;      // Neighbor connectivity
   std::vector<Core::Geometry::Vector>        normals_;             // normalized per node normal.
-  std::vector<std::vector<index_type> > node_neighbors_; // Node neighbor connectivity
+  typedef MeshAdjacency<index_type> node_table_type;
+  node_table_type            node_neighbors_;      // Node neighbor connectivity
   std::vector<std::vector<index_type> > edge_on_node_; // Edges emanating from a node
 
   boost::shared_ptr<SearchGridT<index_type> > node_grid_; // Lookup table for nodes
   boost::shared_ptr<SearchGridT<index_type> > elem_grid_; // Lookup table for elements
+  boost::shared_ptr<SearchBVHT<index_type> >  elem_bvh_; /// Built for graded meshes, see MeshLocateCache
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex         synchronize_lock_;
@@ -2109,7 +2127,7 @@ TriSurfMesh<Basis>::TriSurfMesh()
   : points_(0),
     faces_(0),
     edge_neighbors_(0),
-    node_neighbors_(0),
+    node_neighbors_(),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2133,7 +2151,7 @@ TriSurfMesh<Basis>::TriSurfMesh(const TriSurfMesh &copy)
     faces_(0),
     edge_neighbors_(0),
     normals_(0),
-    node_neighbors_(0),
+    node_neighbors_(),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2262,6 +2280,11 @@ TriSurfMesh<Basis>::transform(const Core::Geometry::Transform &t)
     synchronized_ |= Mesh::BOUNDING_BOX_E;
   }
 
+  // The grids may be shared with other meshes; the element hierarchy is
+  // dropped and lookups fall back to the transformed grid
+  MeshLocateCache::detach(node_grid_);
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
 
@@ -2569,6 +2592,7 @@ TriSurfMesh<Basis>::clear_synchronization()
   edges_.clear();
   node_grid_.reset();
   elem_grid_.reset();
+  elem_bvh_.reset();
 
   synchronize_lock_.unlock();
   return (true);
@@ -3172,13 +3196,16 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  size_type nfaces = static_cast<size_type>(faces_.size());
-  for (index_type f = 0; f < nfaces; ++f)
+  // Each node lists the faces that refer to it, in increasing order
+  std::vector<std::pair<index_type,index_type> > corners(faces_.size());
+  Core::Thread::Parallel::For(0, faces_.size(), [&](size_t first, size_t last)
   {
-    node_neighbors_[faces_[f]].push_back(f/3);
-  }
+    for (size_t i = first; i < last; i++)
+      corners[i] = std::make_pair(static_cast<index_type>(faces_[i]), static_cast<index_type>(i));
+  });
+
+  fill_node_table(corners, points_.size(), node_neighbors_,
+                  [](index_type i) { return i/3; });
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
   synchronize_lock_.unlock();
@@ -3296,7 +3323,7 @@ TriSurfMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double err)
   {
     synchronize_lock_.lock();
     points_.push_back(p);
-    node_neighbors_.push_back(std::vector<under_type>());
+    node_neighbors_.add_row();
     synchronize_lock_.unlock();
     return static_cast<typename Node::index_type>(points_.size() - 1);
   }
@@ -3586,18 +3613,27 @@ TriSurfMesh<Basis>::compute_edge_neighbors()
 
 
 template <class Basis>
-void
-TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TriSurfMesh<Basis>::elem_locate_box(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
   const index_type idx = ci*3;
   Core::Geometry::BBox box;
   box.extend(points_[faces_[idx]]);
   box.extend(points_[faces_[idx+1]]);
   box.extend(points_[faces_[idx+2]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return (box);
+}
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
+  elem_grid_->insert(ci, elem_locate_box(ci));
 }
 
 
@@ -3605,13 +3641,9 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*3;
-  Core::Geometry::BBox box;
-  box.extend(points_[faces_[idx]]);
-  box.extend(points_[faces_[idx+1]]);
-  box.extend(points_[faces_[idx+2]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  MeshLocateCache::detach(elem_grid_);
+  elem_bvh_.reset();
+  elem_grid_->remove(ci, elem_locate_box(ci));
 }
 
 
@@ -3621,6 +3653,7 @@ TriSurfMesh<Basis>::insert_node_into_grid(typename Node::index_type ni)
 {
   /// @todo:  This can crash if you insert a new cell outside of the grid.
   // Need to recompute grid at that point.
+  MeshLocateCache::detach(node_grid_);
   node_grid_->insert(ni,points_[ni]);
 }
 
@@ -3629,6 +3662,7 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::remove_node_from_grid(typename Node::index_type ni)
 {
+  MeshLocateCache::detach(node_grid_);
   node_grid_->remove(ni,points_[ni]);
 }
 
@@ -3653,14 +3687,44 @@ TriSurfMesh<Basis>::compute_elem_grid()
     size_type sz = static_cast<size_type>(ceil(0.5+diag.z()/trace*s));
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
-    elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+    const MeshLocateCache::key_type key =
+      MeshLocateCache::geometry_key("TriSurfMesh", points_, faces_, epsilon_);
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
+    elem_grid_ = MeshLocateCache::find<SearchGridT<index_type> >(key, "elem grid");
+    if (!elem_grid_)
     {
-      insert_elem_into_grid(*ci);
-      ++ci;
+      elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+
+      typename Elem::iterator ci, cie;
+      begin(ci); end(cie);
+      while(ci != cie)
+      {
+        insert_elem_into_grid(*ci);
+        ++ci;
+      }
+      MeshLocateCache::insert(key, "elem grid", elem_grid_);
+    }
+
+    elem_bvh_.reset();
+    const int method = MeshLocateCache::elem_locate_method();
+    if (method == MeshLocateCache::BVH_E || (method == MeshLocateCache::AUTO_E &&
+        elem_grid_->max_bin_size() > MeshLocateCache::bvh_bin_threshold()))
+    {
+      elem_bvh_ = MeshLocateCache::find<SearchBVHT<index_type> >(key, "elem bvh");
+      if (!elem_bvh_)
+      {
+        elem_bvh_.reset(new SearchBVHT<index_type>);
+
+        typename Elem::iterator ci, cie;
+        begin(ci); end(cie);
+        while(ci != cie)
+        {
+          elem_bvh_->insert(*ci, elem_locate_box(*ci));
+          ++ci;
+        }
+        elem_bvh_->build();
+        MeshLocateCache::insert(key, "elem bvh", elem_bvh_);
+      }
     }
   }
 
@@ -3690,15 +3754,22 @@ TriSurfMesh<Basis>::compute_node_grid()
     size_type sz = static_cast<size_type>(ceil(0.5+diag.z()/trace*s));
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
-    node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
-
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
+    const MeshLocateCache::key_type key =
+      MeshLocateCache::geometry_key("TriSurfMesh", points_, faces_, epsilon_);
 
-    while(ni != nie)
+    node_grid_ = MeshLocateCache::find<SearchGridT<index_type> >(key, "node grid");
+    if (!node_grid_)
     {
-      insert_node_into_grid(*ni);
-      ++ni;
+      node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+
+      typename Node::iterator ni, nie;
+      begin(ni); end(nie);
+      while(ni != nie)
+      {
+        insert_node_into_grid(*ni);
+        ++ni;
+      }
+      MeshLocateCache::insert(key, "node grid", node_grid_);
     }
   }
 
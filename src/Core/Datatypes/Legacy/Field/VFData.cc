@@ -67,6 +67,9 @@ void VFData::get_weighted_value(type &, const VMesh::index_type*, const VMesh::w
 void VFData::get_weighted_evalue(type &, const VMesh::index_type*, const VMesh::weight_type*, VMesh::size_type) const \
 { ASSERTFAIL("VFData interface has no virtual function implementation for get_weighted_values"); } \
 \
+void VFData::get_weighted_values(type *, const VMesh::index_type*, const VMesh::weight_type*, VMesh::size_type, VMesh::size_type) const \
+{ ASSERTFAIL("VFData interface has no virtual function implementation for get_weighted_values"); } \
+\
 void VFData::get_values(type *, VMesh::Node::array_type&) const \
 { ASSERTFAIL("VFData interface has no virtual function implementation for get_values"); } \
 \
@@ -106,6 +106,10 @@ void VFDataT<FDATA,EFDATA,HFDATA>::get_weighted_evalue(type &val, const VMesh::i
 { typename EFDATA::value_type tval = typename EFDATA::value_type(0); for(size_type i=0; i<sz; i++) { TESTRANGE(idx[i],0,efdata_.size()) tval = tval + static_cast<typename EFDATA::value_type>(w[i]*efdata_[idx[i]]); } val = CastFData<type>(tval); } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
+void VFDataT<FDATA,EFDATA,HFDATA>::get_weighted_values(type *vals, const VMesh::index_type* idx, const VMesh::weight_type* w, VMesh::size_type sz, VMesh::size_type num) const \
+{ for(size_type j=0; j<num; j++, idx += sz, w += sz) { typename FDATA::value_type tval = typename FDATA::value_type(0); for(size_type i=0; i<sz; i++) { TESTRANGE(idx[i],0,fdata_.size()) tval = tval + static_cast<typename FDATA::value_type>(w[i]*fdata_[idx[i]]); } vals[j] = CastFData<type>(tval); } } \
+\
+template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_values(type *ptr, VMesh::Node::array_type& nodes) const \
 { for(size_t j=0; j<nodes.size(); j++) { TESTRANGE(nodes[j],0,fdata_.size()) ptr[j] = CastFData<type>(fdata_[nodes[j]]); } } \
 \
@@ -34,12 +34,41 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/VFData.h>
 #include <Core/Datatypes/Legacy/Base/PropertyManager.h>
+#include <type_traits>
 
 
 #include <Core/Datatypes/Legacy/Field/share.h>
 
 namespace SCIRun {
 
+/// Typed view on the data array of a field. Value i is found at
+/// data()[i*stride()], so a span can also address one component of a
+/// Vector array. An empty span means the field does not store this type
+/// and the data needs to be accessed through get_values() instead.
+template<class T>
+class FieldDataSpan
+{
+public:
+  typedef VMesh::index_type index_type;
+  typedef VMesh::size_type  size_type;
+
+  FieldDataSpan() : data_(0), size_(0), stride_(1) {}
+  FieldDataSpan(T* data, size_type size, size_type stride = 1) :
+    data_(data), size_(data ? size : 0), stride_(stride) {}
+
+  inline T* data() const        { return (data_); }
+  inline size_type size() const   { return (size_); }
+  inline size_type stride() const { return (stride_); }
+  inline bool empty() const       { return (size_ == 0); }
+
+  inline T& operator[](index_type idx) const { return (data_[idx*stride_]); }
+
+private:
+  T*        data_;
+  size_type size_;
+  size_type stride_;
+};
+
 // Define a handle to the virtual interface
 
 class SCISHARE VField {
@@ -214,6 +243,12 @@ public:
   { vfdata_->get_weighted_value(val,idx,w,sz); }
   template<class T> inline void get_weighted_value(T& val, index_array_type idx, weight_array_type w) const
   { vfdata_->get_weighted_value(val,&(idx[0]),&(w[0]),idx.size()); }
+  /// Batch version: num values, each the weighted sum over sz entries of idx
+  /// and w, which hold the stencils of all values back to back
+  template<class T> inline void get_weighted_values(T* vals, const index_type* idx, const weight_type* w, size_type sz, size_type num) const
+  { vfdata_->get_weighted_values(vals,idx,w,sz,num); }
+  template<class T> inline void get_weighted_values(std::vector<T>& vals, const std::vector<index_type>& idx, const std::vector<weight_type>& w, size_type sz) const
+  { vals.resize(sz > 0 ? idx.size()/sz : 0); if (vals.size()) vfdata_->get_weighted_values(&(vals[0]),&(idx[0]),&(w[0]),sz,vals.size()); }
   template<class T> inline void get_weighted_evalue(T& val, const index_type* idx, const weight_type* w, size_type sz) const
   { vfdata_->get_weighted_evalue(val,idx,w,sz); }
   template<class T> inline void get_weighted_evalue(T& val, index_array_type idx, weight_array_type w) const
@@ -251,6 +286,28 @@ public:
   template<class T> inline void get_values(T* data, size_type sz, index_type offset = 0) const
   { vfdata_->get_values(data,sz,offset); }
 
+  /// Typed spans on the data arrays. These avoid a virtual call per value
+  /// but are only available when T is the type stored in the field, e.g.
+  /// values_span<double>() on double data; otherwise the span is empty.
+  template<class T> inline FieldDataSpan<T> values_span()
+  {
+    if (!is_type(static_cast<typename std::remove_const<T>::type*>(0))) return (FieldDataSpan<T>());
+    return (FieldDataSpan<T>(static_cast<T*>(vfdata_->fdata_pointer()),vfdata_->fdata_size()));
+  }
+  template<class T> inline FieldDataSpan<T> evalues_span()
+  {
+    if (!is_type(static_cast<typename std::remove_const<T>::type*>(0))) return (FieldDataSpan<T>());
+    return (FieldDataSpan<T>(static_cast<T*>(vfdata_->efdata_pointer()),vfdata_->efdata_size()));
+  }
+  /// Strided span on one component (0..2) of a Vector field
+  inline FieldDataSpan<double> vector_component_span(int component)
+  {
+    static_assert(sizeof(Core::Geometry::Vector) == 3*sizeof(double), "Vector is expected to be three packed doubles");
+    if (!is_vector() || component < 0 || component > 2) return (FieldDataSpan<double>());
+    double* data = static_cast<double*>(vfdata_->fdata_pointer());
+    return (FieldDataSpan<double>(data ? data+component : 0,vfdata_->fdata_size(),3));
+  }
+
   // Set/Get values per element array or node array
   template<class T> inline void set_values(const std::vector<T>& values, VMesh::Node::array_type nodes)
   { if (values.size() > 0) vfdata_->set_values(&(values[0]),nodes); }
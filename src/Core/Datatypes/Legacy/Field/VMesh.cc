@@ -732,6 +732,32 @@ VMesh::get_neighbors(Node::array_type&, Node::index_type) const
   ASSERTFAIL("VMesh interface: get_neighbors(Node::index_type,Node::index_type) has not been implemented");  
 }
 
+void
+VMesh::get_elem_adjacency(adjacency_type& table) const
+{
+  Node::size_type num_nodes; size(num_nodes);
+  Elem::array_type elems;
+  table.clear();
+  for (Node::index_type i(0); i < num_nodes; ++i)
+  {
+    get_elems(elems, i);
+    table.add_row(elems.begin(), elems.end());
+  }
+}
+
+void
+VMesh::get_node_adjacency(adjacency_type& table) const
+{
+  Node::size_type num_nodes; size(num_nodes);
+  Node::array_type nodes;
+  table.clear();
+  for (Node::index_type i(0); i < num_nodes; ++i)
+  {
+    get_neighbors(nodes, i);
+    table.add_row(nodes.begin(), nodes.end());
+  }
+}
+
 void 
 VMesh::pwl_approx_edge(std::vector<coords_type >&, Elem::index_type, unsigned int , unsigned int) const
 {
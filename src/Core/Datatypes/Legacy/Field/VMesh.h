@@ -36,6 +36,7 @@
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldVIndex.h>
 #include <Core/Datatypes/Legacy/Field/FieldVIterator.h>
+#include <Core/Datatypes/Legacy/Field/MeshAdjacency.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
 
@@ -68,6 +69,8 @@ public:
   typedef Mesh::size_type                         size_type;
   /// Array of indices
   typedef std::vector<index_type>                 array_type;
+  /// Table with one row of indices per node
+  typedef MeshAdjacency<index_type>               adjacency_type;
   /// Array of points
   typedef std::vector<Core::Geometry::Point>                      points_type;
   /// Dimensions of a mesh, these are used for the regular grids
@@ -884,6 +887,12 @@ public:
   virtual void get_neighbors(Node::array_type &nodes,
                              Node::index_type i) const;
 
+  /// Get get_elems(Node) or get_neighbors(Node) for all nodes at once, row i
+  /// of the table holding the result for node i. Algorithms that visit every
+  /// node should walk these tables instead of filling an array per node.
+  virtual void get_elem_adjacency(adjacency_type& table) const;
+  virtual void get_node_adjacency(adjacency_type& table) const;
+
   /// Draw non linear elements
   virtual void pwl_approx_edge(coords_array_type &coords,
                                Elem::index_type ci, unsigned int which_edge,
@@ -31,6 +31,7 @@
 #define CORE_DATATYPES_SPARSE_MATRIX_H
 
 #include <Core/Datatypes/Matrix.h>
+#include <Core/Datatypes/ContentHash.h>
 #include <Core/Math/MiscMath.h>
 #define register
 #include <Eigen/SparseCore>
@@ -329,6 +330,30 @@ namespace Datatypes {
 
     static Persistent* SparseRowMatrixGenericMaker();
 
+  protected:
+    virtual boost::optional<Datatype::content_hash_type> computeContentHash() const override
+    {
+      ContentHasher hasher;
+      hasher.add(dynamic_type_name());
+      hasher.add(this->rows());
+      hasher.add(this->cols());
+      // row by row, so compressed and uncompressed (gapped) storage hash the same
+      const index_type* outer = this->outerIndexPtr();
+      const index_type* rowCounts = this->innerNonZeroPtr();
+      for (index_type row = 0; row < this->outerSize(); ++row)
+      {
+        const index_type start = outer[row];
+        const index_type count = rowCounts ? rowCounts[row] : outer[row + 1] - start;
+        hasher.add(count);
+        if (count > 0)
+        {
+          hasher.add(this->innerIndexPtr() + start, sizeof(index_type) * count);
+          hasher.add(this->valuePtr() + start, sizeof(T) * count);
+        }
+      }
+      return hasher.value();
+    }
+
   private:
     virtual void print(std::ostream& o) const override
     {
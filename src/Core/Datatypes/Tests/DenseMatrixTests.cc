@@ -90,6 +90,24 @@ TEST(DenseMatrixTest, CanAssign)
   EXPECT_NE(m, m2);
 }
 
+TEST(DenseMatrixTest, ContentHashComparesValues)
+{
+  auto m = boost::make_shared<DenseMatrix>(matrixNonSquare());
+  auto same = boost::make_shared<DenseMatrix>(matrixNonSquare());
+  auto different = boost::make_shared<DenseMatrix>(matrixNonSquare());
+  (*different)(1,2) += 1;
+  auto reshaped = boost::make_shared<DenseMatrix>(4, 3);
+  *reshaped << 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12;
+
+  ASSERT_TRUE(!!m->contentHash());
+  EXPECT_NE(m->id(), same->id());
+  EXPECT_EQ(*m->contentHash(), *same->contentHash());
+  EXPECT_NE(*m->contentHash(), *different->contentHash());
+  EXPECT_TRUE(sameContent(m, same));
+  EXPECT_FALSE(sameContent(m, different));
+  EXPECT_FALSE(sameContent(m, reshaped));
+}
+
 TEST(DenseMatrixUnaryOperationTests, CanNegate)
 {
   DenseMatrix m(matrix1());
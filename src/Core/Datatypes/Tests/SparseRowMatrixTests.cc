@@ -272,6 +272,19 @@ TEST(SparseRowMatrixTest, CanAssign)
   EXPECT_NE(m, m2);
 }
 
+TEST(SparseRowMatrixTest, ContentHashComparesValues)
+{
+  auto m = boost::make_shared<SparseRowMatrix>(matrix1());
+  auto same = boost::make_shared<SparseRowMatrix>(matrix1());
+  auto different = boost::make_shared<SparseRowMatrix>(matrix1());
+  different->coeffRef(1,2) += 1;
+  auto dense = convertMatrix::toDense(m);
+
+  EXPECT_TRUE(sameContent(m, same));
+  EXPECT_FALSE(sameContent(m, different));
+  EXPECT_FALSE(sameContent(m, dense));
+}
+
 TEST(SparseRowMatrixUnaryOperationTests, CanNegate)
 {
   SparseRowMatrix m(matrix1());
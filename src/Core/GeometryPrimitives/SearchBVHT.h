@@ -0,0 +1,349 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_DATATYPES_SEARCHBVHT_H
+#define CORE_DATATYPES_SEARCHBVHT_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <utility>
+#include <vector>
+
+#include <Core/GeometryPrimitives/share.h>
+
+namespace SCIRun {
+
+/// Bounding volume hierarchy over the bounding boxes of mesh elements.
+/// Unlike SearchGridT its cells adapt to the element density, so a lookup
+/// in a strongly graded mesh tests a handful of candidates instead of every
+/// element that overlaps one grid cell. Entries are added with insert()
+/// and the hierarchy is created with build(); it is not updated afterwards.
+/// Besides point lookups it answers closest entry and ray queries, which
+/// only descend into boxes that can still hold a better or a hit entry.
+template<class INDEX>
+class SearchBVHT
+{
+  public:
+    /// Include the types defined in Types into this class
+    typedef SCIRun::index_type                    index_type;
+    typedef SCIRun::size_type                     size_type;
+
+    void insert(INDEX val, const Core::Geometry::BBox &bbox)
+    {
+      items_.push_back(val);
+      boxes_.push_back(Box(bbox));
+    }
+
+    /// Split the entries at the median of their box centers along the
+    /// longest axis until a node holds no more than leaf_size entries
+    void build(size_type leaf_size = 4)
+    {
+      nodes_.clear();
+      const size_type num = static_cast<size_type>(items_.size());
+      if (num == 0) return;
+      if (leaf_size < 1) leaf_size = 1;
+
+      std::vector<index_type> order(num);
+      std::vector<double> center(3*num);
+      for (index_type i = 0; i < num; i++)
+      {
+        order[i] = i;
+        for (int d = 0; d < 3; d++)
+          center[3*i+d] = 0.5*(boxes_[i].min[d]+boxes_[i].max[d]);
+      }
+
+      nodes_.reserve(2*(num/leaf_size)+1);
+      nodes_.push_back(Node(0,num));
+
+      std::vector<index_type> todo(1,0);
+      while (!todo.empty())
+      {
+        const index_type n = todo.back(); todo.pop_back();
+        const index_type first = nodes_[n].first;
+        const size_type count = nodes_[n].count;
+
+        Box box(boxes_[order[first]]);
+        double cmin[3], cmax[3];
+        for (int d = 0; d < 3; d++) cmin[d] = cmax[d] = center[3*order[first]+d];
+        for (index_type i = first+1; i < first+count; i++)
+        {
+          box.extend(boxes_[order[i]]);
+          for (int d = 0; d < 3; d++)
+          {
+            const double c = center[3*order[i]+d];
+            if (c < cmin[d]) cmin[d] = c;
+            if (c > cmax[d]) cmax[d] = c;
+          }
+        }
+        nodes_[n].box = box;
+
+        if (count <= leaf_size) continue;
+
+        int axis = 0;
+        for (int d = 1; d < 3; d++)
+          if (cmax[d]-cmin[d] > cmax[axis]-cmin[axis]) axis = d;
+
+        const index_type mid = first + count/2;
+        std::nth_element(order.begin()+first, order.begin()+mid, order.begin()+first+count,
+          [&center,axis](index_type a, index_type b)
+          { return (center[3*a+axis] < center[3*b+axis]); });
+
+        // Children are stored next to each other, an inner node has count 0
+        const index_type child = static_cast<index_type>(nodes_.size());
+        nodes_.push_back(Node(first,mid-first));
+        nodes_.push_back(Node(mid,first+count-mid));
+        nodes_[n].first = child;
+        nodes_[n].count = 0;
+        todo.push_back(child);
+        todo.push_back(child+1);
+      }
+
+      // Store the entries in leaf order so a leaf reads contiguous memory
+      std::vector<INDEX> items(num);
+      std::vector<Box> boxes(num);
+      for (index_type i = 0; i < num; i++)
+      {
+        items[i] = items_[order[i]];
+        boxes[i] = boxes_[order[i]];
+      }
+      items_.swap(items);
+      boxes_.swap(boxes);
+    }
+
+    /// Test the entries whose box contains p with pred and return the first
+    /// one that is accepted in val
+    template<class PREDICATE>
+    bool lookup(INDEX &val, const Core::Geometry::Point &p, PREDICATE pred) const
+    {
+      if (nodes_.empty()) return (false);
+      const double q[3] = { p.x(), p.y(), p.z() };
+
+      // Median splits keep the depth at log2 of the number of entries, so
+      // the traversal stack never holds more than 64 nodes
+      index_type stack[64];
+      int top = 0;
+      stack[top++] = 0;
+      while (top > 0)
+      {
+        const Node& node = nodes_[stack[--top]];
+        if (!node.box.inside(q)) continue;
+        if (node.count == 0)
+        {
+          stack[top++] = node.first+1;
+          stack[top++] = node.first;
+          continue;
+        }
+        for (index_type i = node.first; i < node.first+node.count; i++)
+        {
+          if (boxes_[i].inside(q) && pred(items_[i]))
+          {
+            val = items_[i];
+            return (true);
+          }
+        }
+      }
+      return (false);
+    }
+
+    /// Find the entry closest to p. dist2(item) returns the squared
+    /// distance from p to the entry itself; it is only called for entries
+    /// whose box is closer than the best match so far. Children are visited
+    /// nearest first so the bound tightens quickly. Entries further away
+    /// than max_dist2 are not reported.
+    template<class DISTANCE>
+    bool closest(INDEX &val, double &best_dist2, const Core::Geometry::Point &p,
+                 DISTANCE dist2, double max_dist2 = DBL_MAX) const
+    {
+      if (nodes_.empty()) return (false);
+      const double q[3] = { p.x(), p.y(), p.z() };
+
+      bool found = false;
+      best_dist2 = max_dist2;
+
+      // Every push replaces the popped node by its two children, so the
+      // stack stays within the depth of the hierarchy
+      std::pair<double,index_type> stack[64];
+      int top = 0;
+      stack[top++] = std::make_pair(nodes_[0].box.distance2(q),index_type(0));
+      while (top > 0)
+      {
+        const std::pair<double,index_type> entry = stack[--top];
+        if (entry.first > best_dist2) continue;
+        const Node& node = nodes_[entry.second];
+        if (node.count == 0)
+        {
+          const index_type c0 = node.first, c1 = node.first+1;
+          const double d0 = nodes_[c0].box.distance2(q);
+          const double d1 = nodes_[c1].box.distance2(q);
+          if (d0 <= d1)
+          {
+            if (d1 <= best_dist2) stack[top++] = std::make_pair(d1,c1);
+            if (d0 <= best_dist2) stack[top++] = std::make_pair(d0,c0);
+          }
+          else
+          {
+            if (d0 <= best_dist2) stack[top++] = std::make_pair(d0,c0);
+            if (d1 <= best_dist2) stack[top++] = std::make_pair(d1,c1);
+          }
+          continue;
+        }
+        for (index_type i = node.first; i < node.first+node.count; i++)
+        {
+          if (boxes_[i].distance2(q) > best_dist2) continue;
+          const double d = dist2(items_[i]);
+          if (d < best_dist2 || (!found && d <= best_dist2))
+          {
+            best_dist2 = d;
+            val = items_[i];
+            found = true;
+          }
+        }
+      }
+      return (found);
+    }
+
+    /// Call visit(item) for every entry whose box is hit by the ray
+    /// origin + t*dir with t >= 0. The traversal stops as soon as visit
+    /// returns false, in which case false is returned.
+    template<class VISITOR>
+    bool intersect_ray(const Core::Geometry::Point &origin,
+                       const Core::Geometry::Vector &dir, VISITOR visit) const
+    {
+      if (nodes_.empty()) return (true);
+      const double o[3] = { origin.x(), origin.y(), origin.z() };
+      const double d[3] = { dir.x(), dir.y(), dir.z() };
+
+      index_type stack[64];
+      int top = 0;
+      stack[top++] = 0;
+      while (top > 0)
+      {
+        const Node& node = nodes_[stack[--top]];
+        if (!node.box.hit(o,d)) continue;
+        if (node.count == 0)
+        {
+          stack[top++] = node.first+1;
+          stack[top++] = node.first;
+          continue;
+        }
+        for (index_type i = node.first; i < node.first+node.count; i++)
+        {
+          if (boxes_[i].hit(o,d) && !visit(items_[i])) return (false);
+        }
+      }
+      return (true);
+    }
+
+    inline size_type size() const { return (static_cast<size_type>(items_.size())); }
+    inline size_type num_nodes() const { return (static_cast<size_type>(nodes_.size())); }
+
+  private:
+    struct Box
+    {
+      Box() {}
+      explicit Box(const Core::Geometry::BBox &b)
+      {
+        const Core::Geometry::Point bmin = b.get_min(), bmax = b.get_max();
+        min[0] = bmin.x(); min[1] = bmin.y(); min[2] = bmin.z();
+        max[0] = bmax.x(); max[1] = bmax.y(); max[2] = bmax.z();
+      }
+
+      inline void extend(const Box &b)
+      {
+        for (int d = 0; d < 3; d++)
+        {
+          if (b.min[d] < min[d]) min[d] = b.min[d];
+          if (b.max[d] > max[d]) max[d] = b.max[d];
+        }
+      }
+
+      inline bool inside(const double* q) const
+      {
+        return (q[0] >= min[0] && q[0] <= max[0] &&
+                q[1] >= min[1] && q[1] <= max[1] &&
+                q[2] >= min[2] && q[2] <= max[2]);
+      }
+
+      inline double distance2(const double* q) const
+      {
+        double d2 = 0.0;
+        for (int d = 0; d < 3; d++)
+        {
+          const double v = (q[d] < min[d]) ? min[d]-q[d] : ((q[d] > max[d]) ? q[d]-max[d] : 0.0);
+          d2 += v*v;
+        }
+        return (d2);
+      }
+
+      // Slab test for the ray o + t*dir, t >= 0
+      inline bool hit(const double* o, const double* dir) const
+      {
+        double tmin = 0.0, tmax = DBL_MAX;
+        for (int d = 0; d < 3; d++)
+        {
+          if (dir[d] == 0.0)
+          {
+            if (o[d] < min[d] || o[d] > max[d]) return (false);
+            continue;
+          }
+          double t0 = (min[d]-o[d])/dir[d];
+          double t1 = (max[d]-o[d])/dir[d];
+          if (t0 > t1) std::swap(t0,t1);
+          if (t0 > tmin) tmin = t0;
+          if (t1 < tmax) tmax = t1;
+          if (tmin > tmax) return (false);
+        }
+        return (true);
+      }
+
+      double min[3];
+      double max[3];
+    };
+
+    struct Node
+    {
+      Node(index_type f, size_type c) : first(f), count(c) {}
+      Box        box;
+      index_type first;
+      size_type  count;
+    };
+
+    std::vector<Node>  nodes_;
+    std::vector<INDEX> items_;
+    std::vector<Box>   boxes_;
+};
+
+
+} // namespace SCIRun
+
+#endif
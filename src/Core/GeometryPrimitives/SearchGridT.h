@@ -237,6 +237,16 @@ class SearchGridT
       return (p - q).length2();
     }
   
+    /// Largest number of entries stored in one cell, a measure for how
+    /// well the grid resolves the density of the inserted entries
+    size_type max_bin_size() const
+    {
+      size_type max = 0;
+      for (size_t q = 0; q < bin_.size(); q++)
+        if (static_cast<size_type>(bin_[q].size()) > max) max = static_cast<size_type>(bin_[q].size());
+      return (max);
+    }
+
   private:
     index_type linearize(index_type i, index_type j, index_type k) const
       { return (((i * nj_) + j) * nk_ + k); }
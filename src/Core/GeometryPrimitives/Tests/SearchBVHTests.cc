@@ -0,0 +1,173 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/GeometryPrimitives/SearchBVHT.h>
+
+#include <cstdlib>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  double random01() { return std::rand() / static_cast<double>(RAND_MAX); }
+}
+
+TEST(SearchBVHTests, EmptyHierarchyFindsNothing)
+{
+  SearchBVHT<index_type> bvh;
+  bvh.build();
+  index_type found = -1;
+  EXPECT_FALSE(bvh.lookup(found, Point(0,0,0), [](index_type) { return true; }));
+  EXPECT_EQ(0, bvh.size());
+}
+
+TEST(SearchBVHTests, LookupVisitsEveryBoxContainingThePoint)
+{
+  std::srand(7);
+  // Boxes clustered near the origin, like elements in a refinement zone
+  std::vector<BBox> boxes;
+  SearchBVHT<index_type> bvh;
+  for (index_type i = 0; i < 2000; i++)
+  {
+    const double s = (i % 10 == 0) ? 1.0 : 0.01;
+    Point c(s*random01(), s*random01(), s*random01());
+    BBox b(c, c + Vector(0.1*s, 0.1*s, 0.1*s));
+    boxes.push_back(b);
+    bvh.insert(i, b);
+  }
+  bvh.build();
+  EXPECT_EQ(2000, bvh.size());
+  EXPECT_GT(bvh.num_nodes(), 1);
+
+  for (int t = 0; t < 200; t++)
+  {
+    const double s = (t % 2 == 0) ? 1.1 : 0.011;
+    Point p(s*random01(), s*random01(), s*random01());
+
+    std::vector<index_type> expected;
+    for (index_type i = 0; i < 2000; i++)
+      if (boxes[i].inside(p)) expected.push_back(i);
+
+    std::vector<index_type> visited;
+    index_type found = -1;
+    EXPECT_FALSE(bvh.lookup(found, p, [&visited](index_type idx) { visited.push_back(idx); return false; }));
+    std::sort(visited.begin(), visited.end());
+    EXPECT_EQ(expected, visited);
+
+    if (!expected.empty())
+    {
+      const index_type wanted = expected.back();
+      ASSERT_TRUE(bvh.lookup(found, p, [wanted](index_type idx) { return idx == wanted; }));
+      EXPECT_EQ(wanted, found);
+    }
+  }
+}
+
+TEST(SearchBVHTests, ClosestMatchesBruteForce)
+{
+  std::srand(11);
+  std::vector<Point> points;
+  SearchBVHT<index_type> bvh;
+  for (index_type i = 0; i < 3000; i++)
+  {
+    const double s = (i % 5 == 0) ? 1.0 : 0.05;
+    Point c(s*random01(), s*random01(), s*random01());
+    points.push_back(c);
+    bvh.insert(i, BBox(c, c));
+  }
+  bvh.build();
+
+  for (int t = 0; t < 200; t++)
+  {
+    Point p(2.0*random01()-0.5, 2.0*random01()-0.5, 2.0*random01()-0.5);
+
+    index_type expected = -1;
+    double mind2 = DBL_MAX;
+    for (index_type i = 0; i < 3000; i++)
+    {
+      const double d2 = (points[i]-p).length2();
+      if (d2 < mind2) { mind2 = d2; expected = i; }
+    }
+
+    index_type found = -1;
+    double d2 = 0.0;
+    int calls = 0;
+    ASSERT_TRUE(bvh.closest(found, d2, p,
+      [&](index_type idx) { calls++; return (points[idx]-p).length2(); }));
+    EXPECT_EQ(expected, found);
+    EXPECT_DOUBLE_EQ(mind2, d2);
+    EXPECT_LT(calls, 3000);
+
+    // Nothing is reported beyond the search radius
+    EXPECT_FALSE(bvh.closest(found, d2, p,
+      [&](index_type idx) { return (points[idx]-p).length2(); }, 0.5*mind2));
+  }
+}
+
+TEST(SearchBVHTests, RayVisitsEveryBoxItHits)
+{
+  std::srand(13);
+  std::vector<BBox> boxes;
+  SearchBVHT<index_type> bvh;
+  for (index_type i = 0; i < 1000; i++)
+  {
+    Point c(random01(), random01(), random01());
+    BBox b(c, c + Vector(0.05, 0.05, 0.05));
+    boxes.push_back(b);
+    bvh.insert(i, b);
+  }
+  bvh.build();
+
+  for (int t = 0; t < 100; t++)
+  {
+    Point o(random01(), random01(), random01());
+    Vector dir(random01()-0.5, random01()-0.5, (t % 4 == 0) ? 0.0 : random01()-0.5);
+
+    std::vector<index_type> expected;
+    for (index_type i = 0; i < 1000; i++)
+    {
+      // Sample the ray densely, the boxes are large compared to the step
+      for (int k = 0; k < 4000; k++)
+      {
+        if (boxes[i].inside(o + dir*(0.001*k))) { expected.push_back(i); break; }
+      }
+    }
+
+    std::vector<index_type> visited;
+    EXPECT_TRUE(bvh.intersect_ray(o, dir, [&visited](index_type idx) { visited.push_back(idx); return true; }));
+    std::sort(visited.begin(), visited.end());
+    for (auto idx : expected)
+      EXPECT_TRUE(std::binary_search(visited.begin(), visited.end(), idx)) << idx;
+
+    int count = 0;
+    EXPECT_EQ(visited.empty(), bvh.intersect_ray(o, dir, [&count](index_type) { return ++count < 1; }));
+  }
+}
@@ -32,12 +32,82 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Thread/Mutex.h>
+
+#include <list>
+#include <sstream>
 
 #include <sci_debug.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace {
+
+// A parsed program only depends on the expression and on the names, types
+// and flags of its inputs and outputs; the data itself is bound later when
+// the program is translated. Translation only reads the parsed program, so
+// modules that execute the same expression over and over share one copy.
+class ParsedProgramCache
+{
+  public:
+    static ParsedProgramCache& instance()
+    {
+      static ParsedProgramCache cache;
+      return cache;
+    }
+
+    static std::string signature(ParserProgramHandle program,
+                                 const std::string& expression)
+    {
+      std::ostringstream key;
+      key << expression << '\n';
+      if (program)
+      {
+        ParserVariableList inputs, outputs;
+        program->get_input_variables(inputs);
+        program->get_output_variables(outputs);
+        for (auto& var : inputs)
+          key << "<" << var.first << ":" << var.second->get_type() << ":" << var.second->get_flags();
+        for (auto& var : outputs)
+          key << ">" << var.first << ":" << var.second->get_type() << ":" << var.second->get_flags();
+      }
+      return key.str();
+    }
+
+    ParserProgramHandle find(const std::string& key)
+    {
+      Guard g(lock_.get());
+      for (auto it = programs_.begin(); it != programs_.end(); ++it)
+      {
+        if (it->first == key)
+        {
+          // Keep the most recently used programs at the front
+          programs_.splice(programs_.begin(), programs_, it);
+          return programs_.front().second;
+        }
+      }
+      return ParserProgramHandle();
+    }
+
+    void insert(const std::string& key, ParserProgramHandle program)
+    {
+      Guard g(lock_.get());
+      programs_.emplace_front(key, program);
+      if (programs_.size() > max_programs_) programs_.pop_back();
+    }
+
+  private:
+    ParsedProgramCache() : lock_("ParsedProgramCache") {}
+
+    static const size_t max_programs_ = 64;
+    Mutex lock_;
+    std::list<std::pair<std::string,ParserProgramHandle> > programs_;
+};
+
+}
 
 bool
 NewArrayMathEngine::add_input_fielddata(const std::string& name, 
@@ -1519,28 +1589,41 @@ NewArrayMathEngine::run()
   // Link everything together
   std::string full_expression = pre_expression_+";"+expression_+";"+post_expression_;
 
-  // Parse the full expression
-  if(!(parse(pprogram_,full_expression,error_str)))
-  {   
-    pr_->error(error_str);
-    return (false);
+  // Reuse the program if this expression was compiled before with the
+  // same inputs and outputs
+  std::string signature = ParsedProgramCache::signature(pprogram_,full_expression);
+  ParserProgramHandle cached = ParsedProgramCache::instance().find(signature);
+  if (cached)
+  {
+    pprogram_ = cached;
   }
-  
-  // Get the catalog with all possible functions
-  ParserFunctionCatalogHandle catalog = ArrayMathFunctionCatalog::get_catalog();
+  else
+  {
+    // Parse the full expression
+    if(!(parse(pprogram_,full_expression,error_str)))
+    {   
+      pr_->error(error_str);
+      return (false);
+    }
+    
+    // Get the catalog with all possible functions
+    ParserFunctionCatalogHandle catalog = ArrayMathFunctionCatalog::get_catalog();
 
-  // Validate the expressions
-  if (!(validate(pprogram_,catalog,error_str)))
-  {   
-    pr_->error(error_str);
-    return (false);
-  }
-  
-  // Optimize the expressions
-  if (!(optimize(pprogram_,error_str)))
-  {   
-    pr_->error(error_str);
-    return (false);
+    // Validate the expressions
+    if (!(validate(pprogram_,catalog,error_str)))
+    {   
+      pr_->error(error_str);
+      return (false);
+    }
+    
+    // Optimize the expressions
+    if (!(optimize(pprogram_,error_str)))
+    {   
+      pr_->error(error_str);
+      return (false);
+    }
+    
+    ParsedProgramCache::instance().insert(signature,pprogram_);
   }
   
   // DEBUG CALL
@@ -1798,6 +1881,13 @@ NewArrayMathEngine::run()
     }
   }
   // Translate the code
+  if (!(create_program(mprogram_,error_str)))
+  {
+    pr_->error(error_str);
+    return (false);
+  }
+  mprogram_->set_fused_execution(fused_execution_);
+  
   if (!(translate(pprogram_,mprogram_,error_str)))
   {
     pr_->error(error_str);
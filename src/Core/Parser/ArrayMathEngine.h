@@ -92,9 +92,13 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     // THAT THE FUNCTIONS ARE GIVEN HERE
   
     // Make sure it starts with a clean definition file
-    NewArrayMathEngine() { clear(); pr_ = &def_pr_; }
+    NewArrayMathEngine() : fused_execution_(true) { clear(); pr_ = &def_pr_; }
   
     void setLogger(Core::Logging::LegacyLoggerInterface* logger) { pr_ = logger; }
+
+    // Evaluate scalar expressions with the fused kernels of the interpreter
+    // (default), or call the interpreted function of every operation
+    void set_fused_execution(bool fused) { fused_execution_ = fused; }
   
     // Generate inputs for field data and field data properties
     bool add_input_fielddata(const std::string& name, 
@@ -200,6 +204,7 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     ParserProgramHandle    pprogram_;
     // Wrapper around the function calls, this piece actually executes the code
     ArrayMathProgramHandle mprogram_;
+    bool                   fused_execution_;
 
     // Expression to evaluate before the main expression
     // This one is to extract the variables from the data sources
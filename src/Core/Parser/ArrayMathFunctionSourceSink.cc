@@ -39,11 +39,15 @@
 
 #include <Core/Thread/Mutex.h>
 
+#include <algorithm>
+
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
 
+static_assert(sizeof(Vector) == 3*sizeof(double), "Vector field data is accessed as an array of doubles");
+
 namespace ArrayMathFunctions {
 
 //--------------------------------------------------------------------------
@@ -65,14 +69,17 @@ bool get_scalar_fd(ArrayMathProgramCode& pc)
   // Safety check (this one is inline, hence it should be fast)
   if (!(data1->is_scalar())) return (false); 
 
-  double* data0_end = data0 + pc.get_size();
-  VMesh::index_type idx = pc.get_index();
-
-  double val;
-  while(data0 != data0_end) 
+  // Read the whole block at once: straight from the array when the field
+  // stores doubles, otherwise with one conversion call for the block
+  if (data1->is_double())
   {
-    data1->get_value(val,idx); idx++;
-    *data0 = val; data0++;
+    const double* values = static_cast<const double*>(data1->fdata_pointer());
+    if (!values) return (false);
+    std::copy(values+pc.get_index(),values+pc.get_index()+pc.get_size(),data0);
+  }
+  else
+  {
+    data1->get_values(data0,pc.get_size(),pc.get_index());
   }
   
   return (true);
@@ -93,18 +100,13 @@ bool get_vector_fd(ArrayMathProgramCode& pc)
   // Safety check (this one is inline, hence it should be fast)
   if (!(data1->is_vector())) return (false); 
 
-
-  double* data0_end = data0 + 3*(pc.get_size());
-  VMesh::index_type idx = pc.get_index();
-
-  Vector val;
-  while (data0 != data0_end) 
-  {
-    data1->get_value(val,idx); idx++;
-    *data0 = val.x(); data0++;
-    *data0 = val.y(); data0++;
-    *data0 = val.z(); data0++;
-  }
+  // Vectors are stored as three consecutive doubles, so the block can be
+  // copied out of the field array in one go
+  const double* values = static_cast<const double*>(data1->fdata_pointer());
+  if (!values) return (false);
+  
+  const double* begin = values + 3*pc.get_index();
+  std::copy(begin,begin+3*pc.get_size(),data0);
   
   return (true);
 }
@@ -555,12 +557,15 @@ bool to_fielddata_s(ArrayMathProgramCode& pc)
   // Safety check to see whether the output format is OK
   if (!(data0->is_scalar())) return (false);
 
-  double* data1_end = data1 + (pc.get_size());
-  index_type idx = pc.get_index();
-
-  while (data1 != data1_end) 
+  if (data0->is_double())
   {
-    data0->set_value(*data1,idx); idx++; data1++;
+    double* values = static_cast<double*>(data0->fdata_pointer());
+    if (!values) return (false);
+    std::copy(data1,data1+pc.get_size(),values+pc.get_index());
+  }
+  else
+  {
+    data0->set_values(data1,pc.get_size(),pc.get_index());
   }
   
   return (true);
@@ -579,14 +584,10 @@ bool to_fielddata_v(ArrayMathProgramCode& pc)
   // Safety check to see whether the output format is OK
   if (!(data0->is_vector())) return (false);
 
-  double* data1_end = data1 + 3*(pc.get_size());
-  index_type idx = pc.get_index();
+  double* values = static_cast<double*>(data0->fdata_pointer());
+  if (!values) return (false);
 
-  while (data1 != data1_end) 
-  {
-    Vector vec(data1[0],data1[1],data1[2]);
-    data0->set_value(vec,idx); idx++; data1+=3;
-  }
+  std::copy(data1,data1+3*pc.get_size(),values+3*pc.get_index());
   
   return (true);
 }  
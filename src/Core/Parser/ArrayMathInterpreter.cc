@@ -35,6 +35,10 @@
 #include <Core/Thread/Parallel.h>
 #include <boost/bind.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
@@ -1188,6 +1192,244 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
     }
   }
 
+  if (mprogram->get_fused_execution())
+  {
+    if (!(fuse(pprogram,mprogram,error))) return (false);
+  }
+
+  return (true);
+}
+
+// -------------------------------------------------------------------------
+// Fuse the sequential part of the program
+
+namespace {
+
+// Scalar functions that have a fused kernel; the kernels compute exactly
+// what the functions in the catalog compute
+int
+fused_kernel(const std::string& function_id)
+{
+  static const std::map<std::string,int> kernels = {
+    { "index$", FUSED_INDEX_E },
+    { "add$S:S", FUSED_ADD_E },
+    { "sub$S:S", FUSED_SUB_E },
+    { "mult$S:S", FUSED_MULT_E },
+    { "div$S:S", FUSED_DIV_E },
+    { "neg$S", FUSED_NEG_E },
+    { "abs$S", FUSED_ABS_E },
+    { "sqrt$S", FUSED_SQRT_E },
+    { "exp$S", FUSED_EXP_E },
+    { "log$S", FUSED_LOG_E },
+    { "ln$S", FUSED_LOG_E },
+    { "sin$S", FUSED_SIN_E },
+    { "cos$S", FUSED_COS_E },
+    { "pow$S:S", FUSED_POW_E },
+    { "min$S:S", FUSED_MIN_E },
+    { "max$S:S", FUSED_MAX_E },
+    { "eq$S:S", FUSED_EQ_E },
+    { "neq$S:S", FUSED_NEQ_E },
+    { "le$S:S", FUSED_LE_E },
+    { "ge$S:S", FUSED_GE_E },
+    { "ls$S:S", FUSED_LS_E },
+    { "gt$S:S", FUSED_GT_E },
+    { "select$S:S:S", FUSED_SELECT_E }
+  };
+
+  std::map<std::string,int>::const_iterator it = kernels.find(function_id);
+  if (it == kernels.end()) return (FUSED_CALL_E);
+  return (it->second);
+}
+
+// Fields whose data array can be used directly
+bool
+is_fusable_field(ArrayMathProgramSource& ps)
+{
+  return (ps.is_vfield() && ps.get_vfield()->is_scalar() && ps.get_vfield()->is_double());
+}
+
+// A sequential scalar that changes from value to value
+bool
+is_sequential_scalar(const ParserScriptVariableHandle& vhandle)
+{
+  return (vhandle->get_type() == "S" && vhandle->is_sequential_var() && !vhandle->is_const_var());
+}
+
+// A scalar constant that has been copied into a sequential buffer
+bool
+is_const_sequential_scalar(const ParserScriptVariableHandle& vhandle)
+{
+  return (vhandle->get_type() == "S" && vhandle->is_sequential_var() && vhandle->is_const_var());
+}
+
+}
+
+bool
+ArrayMathInterpreter::fuse(ParserProgramHandle& pprogram,
+                           ArrayMathProgramHandle& mprogram,
+                           std::string& error)
+{
+  enum { SOURCE_E = -1, SINK_E = -2 };
+
+  size_t num_sequential_variables = pprogram->num_sequential_variables();
+  size_t num_sequential_functions = pprogram->num_sequential_functions();
+  int num_proc = mprogram->get_num_proc();
+
+  ParserScriptFunctionHandle fhandle;
+  ArrayMathProgramSource ps;
+
+  // Decide which functions get a fused kernel. Field sources and sinks of
+  // scalar doubles are only marked here, as whether they need code depends
+  // on how their variable is used.
+  std::vector<int> kernels(num_sequential_functions,FUSED_CALL_E);
+  std::vector<VField*> fields(num_sequential_functions,0);
+  std::vector<VField*> source_fields;
+  std::vector<VField*> sink_fields;
+
+  for (size_t j=0; j<num_sequential_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    const std::string& function_id = fhandle->get_function()->get_function_id();
+    ParserScriptVariableHandle ohandle = fhandle->get_output_var();
+
+    if (function_id == "get_scalar$FD")
+    {
+      if (mprogram->find_source(fhandle->get_input_var(0)->get_name(),ps) && 
+          is_fusable_field(ps))
+      {
+        kernels[j] = SOURCE_E;
+        fields[j] = ps.get_vfield();
+        source_fields.push_back(fields[j]);
+      }
+    }
+    else if (function_id == "to_fielddata$S")
+    {
+      if (mprogram->find_sink(ohandle->get_name(),ps) && is_fusable_field(ps) &&
+          (is_sequential_scalar(fhandle->get_input_var(0)) ||
+           is_const_sequential_scalar(fhandle->get_input_var(0))))
+      {
+        kernels[j] = SINK_E;
+        fields[j] = ps.get_vfield();
+        sink_fields.push_back(fields[j]);
+      }
+    }
+    else if (is_sequential_scalar(ohandle))
+    {
+      int kernel = fused_kernel(function_id);
+      for (size_t i=0; i<fhandle->num_input_vars(); i++)
+      {
+        ParserScriptVariableHandle ihandle = fhandle->get_input_var(i);
+        if (!(is_sequential_scalar(ihandle) || is_const_sequential_scalar(ihandle)))
+          kernel = FUSED_CALL_E;
+      }
+      kernels[j] = kernel;
+    }
+  }
+
+  // Writing a sink while other values are still to be read from the same
+  // array is not safe, keep the interpreted code in that case
+  for (size_t k=0; k<sink_fields.size(); k++)
+  {
+    if (std::find(source_fields.begin(),source_fields.end(),sink_fields[k]) != source_fields.end())
+      return (true);
+  }
+
+  // Count how every sequential variable is used
+  std::vector<int> call_uses(num_sequential_variables,0);
+  std::vector<int> sink_uses(num_sequential_variables,0);
+  std::vector<size_t> sink_of(num_sequential_variables,0);
+  for (size_t j=0; j<num_sequential_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    for (size_t i=0; i<fhandle->num_input_vars(); i++)
+    {
+      ParserScriptVariableHandle ihandle = fhandle->get_input_var(i);
+      if (!(ihandle->is_sequential_var()) || ihandle->is_const_var()) continue;
+      int inum = ihandle->get_var_number();
+      if (kernels[j] == FUSED_CALL_E) call_uses[inum]++;
+      else if (kernels[j] == SINK_E) { sink_uses[inum]++; sink_of[inum] = j; }
+    }
+  }
+
+  // Sources that are only read by fused kernels are read in place, and
+  // results that only go to one sink are written into the sink directly
+  std::vector<VField*> var_fields(num_sequential_variables,0);
+  std::vector<bool> skip(num_sequential_functions,false);
+  for (size_t j=0; j<num_sequential_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    int onum = fhandle->get_output_var()->get_var_number();
+    if (kernels[j] == SOURCE_E)
+    {
+      if (call_uses[onum] == 0)
+      {
+        var_fields[onum] = fields[j];
+        skip[j] = true;
+      }
+    }
+    else if (kernels[j] > FUSED_CALL_E)
+    {
+      if (call_uses[onum] == 0 && sink_uses[onum] == 1)
+      {
+        var_fields[onum] = fields[sink_of[onum]];
+        skip[sink_of[onum]] = true;
+      }
+    }
+  }
+
+  for (int np=0; np<num_proc; np++)
+  {
+    std::vector<ArrayMathFusedCode> code;
+
+    for (size_t j=0; j<num_sequential_functions; j++)
+    {
+      if (skip[j]) continue;
+      pprogram->get_sequential_function(j,fhandle);
+
+      if (kernels[j] == FUSED_CALL_E)
+      {
+        code.push_back(ArrayMathFusedCode(mprogram->get_sequential_program_code(j,np),j));
+        continue;
+      }
+
+      // Find where the output and the inputs are stored
+      int onum = fhandle->get_output_var()->get_var_number();
+      ArrayMathFusedOperand output;
+      if (kernels[j] == SINK_E)
+        output = ArrayMathFusedOperand::field(fields[j]);
+      else if (var_fields[onum])
+        output = ArrayMathFusedOperand::field(var_fields[onum]);
+      else
+        output = ArrayMathFusedOperand::block(mprogram->get_sequential_variable(onum,np)->get_data());
+
+      int kernel = kernels[j];
+      if (kernel == SOURCE_E || kernel == SINK_E) kernel = FUSED_COPY_E;
+      ArrayMathFusedCode fc(kernel,j,output);
+
+      if (kernels[j] == SOURCE_E)
+      {
+        fc.add_input(ArrayMathFusedOperand::field(fields[j]));
+      }
+      else
+      {
+        for (size_t i=0; i<fhandle->num_input_vars(); i++)
+        {
+          ParserScriptVariableHandle ihandle = fhandle->get_input_var(i);
+          int inum = ihandle->get_var_number();
+          if (ihandle->is_const_var())
+            fc.add_input(ArrayMathFusedOperand::scalar(mprogram->get_sequential_variable(inum,0)->get_data()));
+          else if (var_fields[inum])
+            fc.add_input(ArrayMathFusedOperand::field(var_fields[inum]));
+          else
+            fc.add_input(ArrayMathFusedOperand::block(mprogram->get_sequential_variable(inum,np)->get_data()));
+        }
+      }
+      code.push_back(fc);
+    }
+
+    mprogram->set_fused_program_code(np,code);
+  }
+
   return (true);
 }
 
@@ -1514,6 +1756,17 @@ ArrayMathProgram::run_sequential(size_t& error_line)
 {  
   error_line_.resize(num_proc_,0);
   success_.resize(num_proc_,true);
+
+  // The field arrays are only known now; a field that does not expose one
+  // is read through the interpreted code
+  run_fused_ = is_fused();
+  for (size_t np=0; np<fused_functions_.size() && run_fused_; np++)
+  {
+    for (size_t j=0; j<fused_functions_[np].size(); j++)
+    {
+      if (!(fused_functions_[np][j].bind())) { run_fused_ = false; break; }
+    }
+  }
   
   Parallel::RunTasks(boost::bind(&ArrayMathProgram::run_parallel, this, _1), num_proc_);
  
@@ -1545,6 +1798,21 @@ ArrayMathProgram::run_parallel(int proc)
   {
     sz = buffer_size_;
     if (offset+sz >= end) sz = end-offset;
+
+    if (run_fused_)
+    {
+      std::vector<ArrayMathFusedCode>& code = fused_functions_[proc];
+      for (size_t j=0; j<code.size(); j++)
+      {
+        if(!(code[j].run(offset,sz)))
+        {
+          error_line_[proc] = code[j].get_line();
+          success_[proc] = false;
+        }
+      }
+      offset += sz;
+      continue;
+    }
      
     size_t size = sequential_functions_[proc].size();
     for (size_t j=0; j<size;j++)
@@ -1567,6 +1835,173 @@ ArrayMathProgram::run_parallel(int proc)
 }
 
 
+bool
+ArrayMathFusedOperand::bind()
+{
+  if (kind_ != FIELD_E) return (data_ != 0);
+  if (!vfield_ || !(vfield_->is_scalar()) || !(vfield_->is_double())) return (false);
+  data_ = static_cast<double*>(vfield_->fdata_pointer());
+  return (data_ != 0);
+}
+
+bool
+ArrayMathFusedCode::bind()
+{
+  if (kernel_ == FUSED_CALL_E) return (code_ != 0);
+  if (!(output_.bind())) return (false);
+  for (size_t j=0; j<inputs_.size(); j++)
+  {
+    if (!(inputs_[j].bind())) return (false);
+  }
+  return (true);
+}
+
+namespace {
+
+template <class OP>
+inline void
+fused_unary(double* out, const ArrayMathFusedOperand& in,
+            index_type index, size_type size, OP op)
+{
+  const double* a = in.get_data(index);
+  if (in.is_scalar())
+  {
+    std::fill(out,out+size,op(a[0]));
+  }
+  else
+  {
+    for (size_type k=0; k<size; k++) out[k] = op(a[k]);
+  }
+}
+
+template <class OP>
+inline void
+fused_binary(double* out, const ArrayMathFusedOperand& in1,
+             const ArrayMathFusedOperand& in2,
+             index_type index, size_type size, OP op)
+{
+  const double* a = in1.get_data(index);
+  const double* b = in2.get_data(index);
+  if (in1.is_scalar() && in2.is_scalar())
+  {
+    std::fill(out,out+size,op(a[0],b[0]));
+  }
+  else if (in1.is_scalar())
+  {
+    const double av = a[0];
+    for (size_type k=0; k<size; k++) out[k] = op(av,b[k]);
+  }
+  else if (in2.is_scalar())
+  {
+    const double bv = b[0];
+    for (size_type k=0; k<size; k++) out[k] = op(a[k],bv);
+  }
+  else
+  {
+    for (size_type k=0; k<size; k++) out[k] = op(a[k],b[k]);
+  }
+}
+
+}
+
+bool
+ArrayMathFusedCode::run(index_type index, size_type size)
+{
+  if (kernel_ == FUSED_CALL_E)
+  {
+    code_->set_index(index);
+    code_->set_size(size);
+    return (code_->run());
+  }
+
+  double* out = output_.get_data(index);
+
+  switch (kernel_)
+  {
+    case FUSED_COPY_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return a; });
+      break;
+    case FUSED_INDEX_E:
+      for (size_type k=0; k<size; k++) out[k] = static_cast<double>(index+k);
+      break;
+    case FUSED_ADD_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return a + b; });
+      break;
+    case FUSED_SUB_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return a - b; });
+      break;
+    case FUSED_MULT_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return a * b; });
+      break;
+    case FUSED_DIV_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return a / b; });
+      break;
+    case FUSED_NEG_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return -a; });
+      break;
+    case FUSED_ABS_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return (a < 0 ? -a : a); });
+      break;
+    case FUSED_SQRT_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return ::sqrt(a); });
+      break;
+    case FUSED_EXP_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return ::exp(a); });
+      break;
+    case FUSED_LOG_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return ::log(a); });
+      break;
+    case FUSED_SIN_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return ::sin(a); });
+      break;
+    case FUSED_COS_E:
+      fused_unary(out,inputs_[0],index,size,[](double a) { return ::cos(a); });
+      break;
+    case FUSED_POW_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return ::pow(a,b); });
+      break;
+    case FUSED_MIN_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a < b ? a : b); });
+      break;
+    case FUSED_MAX_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a > b ? a : b); });
+      break;
+    case FUSED_EQ_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a == b ? 1.0 : 0.0); });
+      break;
+    case FUSED_NEQ_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a != b ? 1.0 : 0.0); });
+      break;
+    case FUSED_LE_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a <= b ? 1.0 : 0.0); });
+      break;
+    case FUSED_GE_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a >= b ? 1.0 : 0.0); });
+      break;
+    case FUSED_LS_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a < b ? 1.0 : 0.0); });
+      break;
+    case FUSED_GT_E:
+      fused_binary(out,inputs_[0],inputs_[1],index,size,[](double a, double b) { return (a > b ? 1.0 : 0.0); });
+      break;
+    case FUSED_SELECT_E:
+    {
+      const double* c = inputs_[0].get_data(index);
+      const double* a = inputs_[1].get_data(index);
+      const double* b = inputs_[2].get_data(index);
+      const size_type sc = inputs_[0].is_scalar() ? 0 : 1;
+      const size_type sa = inputs_[1].is_scalar() ? 0 : 1;
+      const size_type sb = inputs_[2].is_scalar() ? 0 : 1;
+      for (size_type k=0; k<size; k++) out[k] = (c[k*sc] ? a[k*sa] : b[k*sb]);
+      break;
+    }
+    default:
+      return (false);
+  }
+
+  return (true);
+}
+
 void
 ArrayMathProgramCode::print() const
 {
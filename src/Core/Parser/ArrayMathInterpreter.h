@@ -309,10 +309,108 @@ class SCISHARE ArrayMathProgramSource {
 };
 
 
+//-----------------------------------------------------------------------------
+// Fused execution of the sequential part of the program. Scalar functions
+// that have a kernel in the interpreter are evaluated inline, reading their
+// operands straight from the field arrays of the sources and writing their
+// results straight into the field arrays of the sinks. Hence a block goes
+// from the input fields to the output fields in one pass over the program,
+// without the copies in and out of the variable buffers. Any other function
+// is run through its ArrayMathProgramCode as before.
+
+enum {
+  FUSED_CALL_E = 0,
+  FUSED_COPY_E,
+  FUSED_INDEX_E,
+  FUSED_ADD_E,
+  FUSED_SUB_E,
+  FUSED_MULT_E,
+  FUSED_DIV_E,
+  FUSED_NEG_E,
+  FUSED_ABS_E,
+  FUSED_SQRT_E,
+  FUSED_EXP_E,
+  FUSED_LOG_E,
+  FUSED_SIN_E,
+  FUSED_COS_E,
+  FUSED_POW_E,
+  FUSED_MIN_E,
+  FUSED_MAX_E,
+  FUSED_EQ_E,
+  FUSED_NEQ_E,
+  FUSED_LE_E,
+  FUSED_GE_E,
+  FUSED_LS_E,
+  FUSED_GT_E,
+  FUSED_SELECT_E
+};
+
+// Location of the values of a variable used by a fused kernel
+class SCISHARE ArrayMathFusedOperand {
+  public:
+    enum { BLOCK_E, FIELD_E, SCALAR_E };
+
+    ArrayMathFusedOperand() : kind_(BLOCK_E), data_(0), vfield_(0) {}
+
+    // A buffer holding the current block of a variable
+    static ArrayMathFusedOperand block(double* data)
+      { ArrayMathFusedOperand op; op.kind_ = BLOCK_E; op.data_ = data; return (op); }
+    // The data array of a scalar double field, bound when the program runs
+    static ArrayMathFusedOperand field(VField* vfield)
+      { ArrayMathFusedOperand op; op.kind_ = FIELD_E; op.vfield_ = vfield; return (op); }
+    // A constant, stored in the first entry of data
+    static ArrayMathFusedOperand scalar(double* data)
+      { ArrayMathFusedOperand op; op.kind_ = SCALAR_E; op.data_ = data; return (op); }
+
+    bool bind();
+
+    // Pointer to the values of the block starting at index
+    inline double* get_data(index_type index) const
+      { return (kind_ == FIELD_E ? data_ + index : data_); }
+    inline bool is_scalar() const { return (kind_ == SCALAR_E); }
+    inline bool is_field() const { return (kind_ == FIELD_E); }
+    inline VField* get_vfield() const { return (vfield_); }
+
+  private:
+    int     kind_;
+    double* data_;
+    VField* vfield_;
+};
+
+class SCISHARE ArrayMathFusedCode {
+  public:
+    ArrayMathFusedCode() : kernel_(FUSED_CALL_E), line_(0) {}
+
+    // Function that has no fused kernel, run as interpreted code
+    ArrayMathFusedCode(ArrayMathProgramCodePtr code, size_t line) :
+      kernel_(FUSED_CALL_E), line_(line), code_(code) {}
+
+    ArrayMathFusedCode(int kernel, size_t line, const ArrayMathFusedOperand& output) :
+      kernel_(kernel), line_(line), output_(output) {}
+
+    void add_input(const ArrayMathFusedOperand& input) { inputs_.push_back(input); }
+
+    // Bind the field arrays, fails if a field does not have one
+    bool bind();
+
+    // Line of the sequential program this code was made from
+    size_t get_line() const { return (line_); }
+
+    bool run(index_type index, size_type size);
+
+  private:
+    int                                kernel_;
+    size_t                             line_;
+    ArrayMathProgramCodePtr            code_;
+    ArrayMathFusedOperand              output_;
+    std::vector<ArrayMathFusedOperand> inputs_;
+};
+
+
   class SCISHARE ArrayMathProgram : boost::noncopyable {
   
   public:
-    ArrayMathProgram() : num_proc_(Core::Thread::Parallel::NumCores()), barrier_("ArrayMathProgram", num_proc_)
+    ArrayMathProgram() : num_proc_(Core::Thread::Parallel::NumCores()), fused_execution_(true), run_fused_(false), barrier_("ArrayMathProgram", num_proc_)
     {
       // Buffer size describes how many values of a sequential variable are
       // grouped together for vectorized execution
@@ -324,6 +422,7 @@ class SCISHARE ArrayMathProgramSource {
     ArrayMathProgram(size_type array_size, 
       size_type buffer_size,int num_proc = -1) : 
       num_proc_(num_proc < 1 ? Core::Thread::Parallel::NumCores() : num_proc),
+      fused_execution_(true), run_fused_(false),
       barrier_("ArrayMathProgram", num_proc_)
     {
       // Buffer size describes how many values of a sequential variable are
@@ -407,6 +506,20 @@ class SCISHARE ArrayMathProgramSource {
       { single_functions_[j] = pc; }
     void set_sequential_program_code(size_t j, size_t np, ArrayMathProgramCodePtr pc)
       { sequential_functions_[np][j] = pc; }
+    ArrayMathProgramCodePtr get_sequential_program_code(size_t j, size_t np) const
+      { return (sequential_functions_[np][j]); }
+
+    // Run the sequential part through fused kernels where possible, this is
+    // the default. It needs to be set before the program is translated.
+    void set_fused_execution(bool fused) { fused_execution_ = fused; }
+    bool get_fused_execution() const { return (fused_execution_); }
+
+    void set_fused_program_code(size_t np, const std::vector<ArrayMathFusedCode>& code)
+      {
+        fused_functions_.resize(num_proc_);
+        fused_functions_[np] = code;
+      }
+    bool is_fused() const { return (!fused_functions_.empty()); }
     
     // Code to find the pointers that are given for sources and sinks  
     bool find_source(const std::string& name,  ArrayMathProgramSource& ps);
@@ -445,6 +558,11 @@ class SCISHARE ArrayMathProgramSource {
     std::vector<ArrayMathProgramCodePtr> const_functions_;
     std::vector<ArrayMathProgramCodePtr> single_functions_;
     std::vector<std::vector<ArrayMathProgramCodePtr> > sequential_functions_;
+
+    // Fused version of the sequential code, empty if it was not made
+    bool fused_execution_;
+    std::vector<std::vector<ArrayMathFusedCode> > fused_functions_;
+    bool run_fused_;
     
     ParserProgramHandle pprogram_;
     
@@ -546,6 +664,11 @@ class SCISHARE ArrayMathInterpreter {
     bool translate(ParserProgramHandle& pprogram,
                    ArrayMathProgramHandle& mprogram,
                    std::string& error);
+
+    // Build the fused version of the sequential code, called by translate
+    bool fuse(ParserProgramHandle& pprogram,
+              ArrayMathProgramHandle& mprogram,
+              std::string& error);
   
   
     //------------------------------------------------------------------------
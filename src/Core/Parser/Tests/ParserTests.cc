@@ -28,6 +28,7 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <cmath>
 
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
@@ -1404,6 +1405,124 @@ TEST_F(BasicParserTests, CreateFieldData_find_normal2)
   EXPECT_NEAR(19.4422, max,1e-4); 
 }
 
+TEST_F(BasicParserTests, RepeatedExpressionIsEvaluatedOnNewData)
+{
+  // The second run reuses the parsed program, but has to read the new field
+  for (double value : { 1.0, 5.0 })
+  {
+    FieldHandle field(CreateEmptyLatVol(30,30,30));
+    field->vfield()->set_all_values(value);
+
+    NewArrayMathEngine engine;
+    ASSERT_TRUE(engine.add_input_fielddata("DATA",field));
+    ASSERT_TRUE(engine.add_output_fielddata("RESULT",field,1,"double"));
+    ASSERT_TRUE(engine.add_expressions("RESULT = 2*DATA + 1;"));
+    ASSERT_TRUE(engine.run());
+
+    FieldHandle ofield;
+    engine.get_field("RESULT",ofield);
+    ASSERT_THAT(ofield, NotNull());
+    double min, max;
+    ofield->vfield()->minmax(min,max);
+    EXPECT_EQ(2*value + 1, min);
+    EXPECT_EQ(2*value + 1, max);
+  }
+}
+
+TEST_F(BasicParserTests, ConvertsNonDoubleFieldDataInBlocks)
+{
+  FieldHandle field(CreateEmptyLatVol(30,30,30));
+  NewArrayMathEngine engine;
+  ASSERT_TRUE(engine.add_input_fielddata_location("POS",field,1));
+  ASSERT_TRUE(engine.add_output_fielddata("RESULT",field,1,"int"));
+  ASSERT_TRUE(engine.add_index("INDEX"));
+  ASSERT_TRUE(engine.add_expressions("RESULT = 3*INDEX;"));
+  ASSERT_TRUE(engine.run());
+
+  FieldHandle ofield;
+  engine.get_field("RESULT",ofield);
+  ASSERT_THAT(ofield, NotNull());
+  VField* ovfield = ofield->vfield();
+  EXPECT_TRUE(ovfield->is_int());
+
+  std::vector<int> values;
+  ovfield->get_values(values);
+  ASSERT_EQ(30*30*30, values.size());
+  for (size_t idx = 0; idx < values.size(); ++idx)
+    ASSERT_EQ(3*static_cast<int>(idx), values[idx]);
+}
+
+TEST_F(BasicParserTests, CopiesVectorFieldDataInBlocks)
+{
+  FieldHandle field(CreateEmptyLatVol(30,30,30));
+  NewArrayMathEngine engine;
+  ASSERT_TRUE(engine.add_input_fielddata_location("POS",field,1));
+  ASSERT_TRUE(engine.add_output_fielddata("RESULT",field,1,"Vector"));
+  ASSERT_TRUE(engine.add_expressions("RESULT = 2*POS;"));
+  ASSERT_TRUE(engine.run());
+
+  FieldHandle ofield;
+  engine.get_field("RESULT",ofield);
+  ASSERT_THAT(ofield, NotNull());
+
+  // Run a second pass that reads the vector field back in
+  NewArrayMathEngine engine2;
+  ASSERT_TRUE(engine2.add_input_fielddata("V",ofield));
+  ASSERT_TRUE(engine2.add_input_fielddata_location("POS",field,1));
+  ASSERT_TRUE(engine2.add_output_fielddata("RESULT",field,1,"double"));
+  ASSERT_TRUE(engine2.add_expressions("RESULT = length(V - 2*POS);"));
+  ASSERT_TRUE(engine2.run());
+
+  FieldHandle diff;
+  engine2.get_field("RESULT",diff);
+  ASSERT_THAT(diff, NotNull());
+  double min, max;
+  diff->vfield()->minmax(min,max);
+  EXPECT_EQ(0, min);
+  EXPECT_EQ(0, max);
+}
+
+TEST_F(BasicParserTests, FusedExecutionMatchesInterpretedExecution)
+{
+  FieldHandle field(CreateEmptyLatVol(30,30,30));
+  VField* vfield = field->vfield();
+  for (VMesh::index_type idx = 0; idx < vfield->num_values(); ++idx)
+    vfield->set_value(2.0*std::sin(0.37*idx), idx);
+
+  // Fused kernels only, fused kernels mixed with interpreted functions, a
+  // source copied straight to a sink and a constant result
+  const std::string expressions[] = {
+    "RESULT = 2*DATA + sin(DATA)/3 - 1;",
+    "RESULT = DATA;",
+    "a = DATA*DATA; RESULT = select(a > 0.5, sqrt(a), -abs(DATA)) + min(DATA, 0.25);",
+    "RESULT = pow(abs(DATA), 1.5)*length(POS) + INDEX;",
+    "RESULT = max(exp(-DATA*DATA), cos(DATA)) - ln(abs(DATA) + 1) + (DATA >= 0) + (DATA != 1);",
+    "RESULT = 7;"
+  };
+
+  for (const auto& expression : expressions)
+  {
+    std::vector<double> results[2];
+    for (int fused = 0; fused < 2; ++fused)
+    {
+      NewArrayMathEngine engine;
+      engine.set_fused_execution(fused == 1);
+      ASSERT_TRUE(engine.add_input_fielddata("DATA",field));
+      ASSERT_TRUE(engine.add_input_fielddata_location("POS",field,1));
+      ASSERT_TRUE(engine.add_index("INDEX"));
+      ASSERT_TRUE(engine.add_output_fielddata("RESULT",field,1,"double"));
+      ASSERT_TRUE(engine.add_expressions(expression));
+      ASSERT_TRUE(engine.run()) << expression;
+
+      FieldHandle ofield;
+      engine.get_field("RESULT",ofield);
+      ASSERT_THAT(ofield, NotNull());
+      ofield->vfield()->get_values(results[fused]);
+    }
+    ASSERT_EQ(30*30*30, results[0].size());
+    EXPECT_EQ(results[0], results[1]) << expression;
+  }
+}
 
 //Run these tests when the functions below are implemented 
 /*
@@ -0,0 +1,664 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef BUILD_WITH_PYTHON
+
+#include <Core/Python/PythonBufferView.h>
+#include <Core/Datatypes/Datatype.h>
+#include <boost/make_shared.hpp>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Python;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  // Memory shared by a view and every view indexed or sliced from it. The first write
+  // copies it, so changes made in Python never reach the SCIRun object.
+  struct BufferViewStorage
+  {
+    BufferViewStorage(boost::shared_ptr<const void> memory, DatatypeHandle datatype, const void* data, size_t bytes, int ndim)
+      : memory(memory), datatype(datatype), data(static_cast<char*>(const_cast<void*>(data))), bytes(bytes), ndim(ndim), copied(false) {}
+
+    void makeWritable()
+    {
+      if (copied)
+        return;
+      copy.assign(data, data + bytes);
+      data = copy.data();
+      copied = true;
+      // The copy no longer is the datatype it came from.
+      datatype.reset();
+    }
+
+    // Still referenced by buffers exported before the copy.
+    boost::shared_ptr<const void> memory;
+    DatatypeHandle datatype;
+    char* data;
+    size_t bytes;
+    int ndim;
+    bool copied;
+    std::vector<char> copy;
+  };
+  typedef boost::shared_ptr<BufferViewStorage> BufferViewStorageHandle;
+
+  struct BufferViewObject
+  {
+    PyObject_HEAD
+    BufferViewStorageHandle* storage;
+    Py_ssize_t offset;
+    char format[2];
+    Py_ssize_t itemsize;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+  };
+
+  BufferViewObject* asView(PyObject* self)
+  {
+    return reinterpret_cast<BufferViewObject*>(self);
+  }
+
+  BufferViewStorage& storageOf(const BufferViewObject* view)
+  {
+    return **view->storage;
+  }
+
+  PyTypeObject* bufferViewType();
+
+  PyObject* newBufferView(const BufferViewStorageHandle& storage, Py_ssize_t offset, char format, Py_ssize_t itemsize,
+    int ndim, const Py_ssize_t* shape, const Py_ssize_t* strides)
+  {
+    auto type = bufferViewType();
+    auto view = reinterpret_cast<BufferViewObject*>(type->tp_alloc(type, 0));
+    if (!view)
+      return nullptr;
+    view->storage = new BufferViewStorageHandle(storage);
+    view->offset = offset;
+    view->format[0] = format;
+    view->format[1] = '\0';
+    view->itemsize = itemsize;
+    view->ndim = ndim;
+    view->shape[0] = shape[0];
+    view->shape[1] = ndim > 1 ? shape[1] : 1;
+    view->strides[0] = strides[0];
+    view->strides[1] = ndim > 1 ? strides[1] : itemsize;
+    return reinterpret_cast<PyObject*>(view);
+  }
+
+  void bufferViewDealloc(PyObject* self)
+  {
+    delete asView(self)->storage;
+    Py_TYPE(self)->tp_free(self);
+  }
+
+  bool isContiguous(const BufferViewObject* view)
+  {
+    return (view->shape[1] <= 1 || view->strides[1] == view->itemsize)
+      && (view->shape[0] <= 1 || view->strides[0] == view->shape[1] * view->itemsize);
+  }
+
+  // True when the view is still the whole of the datatype it was made from.
+  bool coversStorage(const BufferViewObject* view)
+  {
+    auto& storage = storageOf(view);
+    return view->offset == 0 && view->ndim == storage.ndim && isContiguous(view)
+      && static_cast<size_t>(view->shape[0] * view->shape[1] * view->itemsize) == storage.bytes;
+  }
+
+  int bufferViewGetBuffer(PyObject* self, Py_buffer* buffer, int flags)
+  {
+    auto view = asView(self);
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !isContiguous(view))
+    {
+      buffer->obj = nullptr;
+      PyErr_SetString(PyExc_BufferError, "SCIRun buffer view is not contiguous; request strides or copy it.");
+      return -1;
+    }
+    auto& storage = storageOf(view);
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+      storage.makeWritable();
+    buffer->buf = storage.data + view->offset;
+    buffer->obj = self;
+    Py_INCREF(self);
+    buffer->len = view->shape[0] * view->shape[1] * view->itemsize;
+    buffer->readonly = storage.copied ? 0 : 1;
+    buffer->itemsize = view->itemsize;
+    buffer->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? view->format : nullptr;
+    buffer->ndim = view->ndim;
+    buffer->shape = (flags & PyBUF_ND) == PyBUF_ND ? view->shape : nullptr;
+    buffer->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? view->strides : nullptr;
+    buffer->suboffsets = nullptr;
+    buffer->internal = nullptr;
+    return 0;
+  }
+
+  PyObject* readItem(const BufferViewObject* view, Py_ssize_t offset)
+  {
+    auto item = storageOf(view).data + offset;
+    switch (view->format[0])
+    {
+    case 'I':
+      return PyLong_FromUnsignedLong(*reinterpret_cast<const unsigned int*>(item));
+    case 'q':
+      return PyLong_FromLongLong(*reinterpret_cast<const long long*>(item));
+    default:
+      return PyFloat_FromDouble(*reinterpret_cast<const double*>(item));
+    }
+  }
+
+  template <class T>
+  int store(BufferViewObject* view, Py_ssize_t offset, T value)
+  {
+    auto& storage = storageOf(view);
+    storage.makeWritable();
+    std::memcpy(storage.data + offset, &value, sizeof(T));
+    return 0;
+  }
+
+  int writeItem(BufferViewObject* view, Py_ssize_t offset, PyObject* value)
+  {
+    switch (view->format[0])
+    {
+    case 'I':
+    {
+      auto number = PyLong_AsUnsignedLong(value);
+      if (number == static_cast<unsigned long>(-1) && PyErr_Occurred())
+        return -1;
+      if (number > UINT_MAX)
+      {
+        PyErr_SetString(PyExc_OverflowError, "value does not fit an unsigned int");
+        return -1;
+      }
+      return store(view, offset, static_cast<unsigned int>(number));
+    }
+    case 'q':
+    {
+      auto number = PyLong_AsLongLong(value);
+      if (number == -1 && PyErr_Occurred())
+        return -1;
+      return store(view, offset, number);
+    }
+    default:
+    {
+      auto number = PyFloat_AsDouble(value);
+      if (number == -1.0 && PyErr_Occurred())
+        return -1;
+      return store(view, offset, number);
+    }
+    }
+  }
+
+  // Layout of what an index, a slice or a tuple of them selects; ndim 0 is a single item.
+  struct Selection
+  {
+    Py_ssize_t offset;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+  };
+
+  bool select(const BufferViewObject* view, PyObject* key, Selection& selection)
+  {
+    PyObject* keys[2] = { key, nullptr };
+    Py_ssize_t numKeys = 1;
+    if (PyTuple_Check(key))
+    {
+      numKeys = PyTuple_GET_SIZE(key);
+      if (numKeys > view->ndim)
+      {
+        PyErr_SetString(PyExc_IndexError, "too many indices");
+        return false;
+      }
+      for (Py_ssize_t k = 0; k < numKeys; ++k)
+        keys[k] = PyTuple_GET_ITEM(key, k);
+    }
+
+    selection.offset = view->offset;
+    selection.ndim = 0;
+    for (int d = 0; d < view->ndim; ++d)
+    {
+      if (d >= numKeys)
+      {
+        selection.shape[selection.ndim] = view->shape[d];
+        selection.strides[selection.ndim++] = view->strides[d];
+        continue;
+      }
+      if (PySlice_Check(keys[d]))
+      {
+        Py_ssize_t start, stop, step, length;
+        if (PySlice_GetIndicesEx(keys[d], view->shape[d], &start, &stop, &step, &length) < 0)
+          return false;
+        selection.offset += start * view->strides[d];
+        selection.shape[selection.ndim] = length;
+        selection.strides[selection.ndim++] = step * view->strides[d];
+        continue;
+      }
+      auto i = PyNumber_AsSsize_t(keys[d], PyExc_IndexError);
+      if (i == -1 && PyErr_Occurred())
+        return false;
+      if (i < 0)
+        i += view->shape[d];
+      if (i < 0 || i >= view->shape[d])
+      {
+        PyErr_SetString(PyExc_IndexError, "index out of range");
+        return false;
+      }
+      selection.offset += i * view->strides[d];
+    }
+    return true;
+  }
+
+  PyObject* bufferViewSubscript(PyObject* self, PyObject* key)
+  {
+    auto view = asView(self);
+    Selection selection;
+    if (!select(view, key, selection))
+      return nullptr;
+    if (selection.ndim == 0)
+      return readItem(view, selection.offset);
+    return newBufferView(*view->storage, selection.offset, view->format[0], view->itemsize,
+      selection.ndim, selection.shape, selection.strides);
+  }
+
+  // Sequences are assigned item by item and must match the selection's length; a single
+  // number fills the whole selection.
+  int assign(BufferViewObject* view, Py_ssize_t offset, int ndim, const Py_ssize_t* shape, const Py_ssize_t* strides, PyObject* value)
+  {
+    if (ndim == 0)
+      return writeItem(view, offset, value);
+    if (!PySequence_Check(value))
+    {
+      for (Py_ssize_t i = 0; i < shape[0]; ++i)
+      {
+        if (assign(view, offset + i * strides[0], ndim - 1, shape + 1, strides + 1, value) < 0)
+          return -1;
+      }
+      return 0;
+    }
+    auto length = PySequence_Size(value);
+    if (length < 0)
+      return -1;
+    if (length != shape[0])
+    {
+      PyErr_Format(PyExc_ValueError, "cannot assign %zd values to %zd items", length, shape[0]);
+      return -1;
+    }
+    for (Py_ssize_t i = 0; i < length; ++i)
+    {
+      auto item = PySequence_GetItem(value, i);
+      if (!item)
+        return -1;
+      auto result = assign(view, offset + i * strides[0], ndim - 1, shape + 1, strides + 1, item);
+      Py_DECREF(item);
+      if (result < 0)
+        return -1;
+    }
+    return 0;
+  }
+
+  PyObject* toList(const BufferViewObject* view, Py_ssize_t offset, int ndim, const Py_ssize_t* shape, const Py_ssize_t* strides)
+  {
+    if (ndim == 0)
+      return readItem(view, offset);
+    auto list = PyList_New(shape[0]);
+    if (!list)
+      return nullptr;
+    for (Py_ssize_t i = 0; i < shape[0]; ++i)
+    {
+      auto item = toList(view, offset + i * strides[0], ndim - 1, shape + 1, strides + 1);
+      if (!item)
+      {
+        Py_DECREF(list);
+        return nullptr;
+      }
+      PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+  }
+
+  PyObject* bufferViewToList(PyObject* self, PyObject*)
+  {
+    auto view = asView(self);
+    return toList(view, view->offset, view->ndim, view->shape, view->strides);
+  }
+
+  int bufferViewAssign(PyObject* self, PyObject* key, PyObject* value)
+  {
+    if (!value)
+    {
+      PyErr_SetString(PyExc_TypeError, "cannot delete items of a SCIRun buffer view");
+      return -1;
+    }
+    auto view = asView(self);
+    Selection selection;
+    if (!select(view, key, selection))
+      return -1;
+    // Read views first, so an overlapping source is not overwritten while it is copied.
+    boost::python::handle<> source(boost::python::borrowed(value));
+    if (PyObject_TypeCheck(value, bufferViewType()))
+    {
+      source = boost::python::handle<>(boost::python::allow_null(bufferViewToList(value, nullptr)));
+      if (!source)
+        return -1;
+    }
+    return assign(view, selection.offset, selection.ndim, selection.shape, selection.strides, source.get());
+  }
+
+  Py_ssize_t bufferViewLength(PyObject* self)
+  {
+    return asView(self)->shape[0];
+  }
+
+  // Kept for iteration, which goes through the sequence protocol.
+  PyObject* bufferViewItem(PyObject* self, Py_ssize_t i)
+  {
+    boost::python::handle<> index(PyLong_FromSsize_t(i));
+    return bufferViewSubscript(self, index.get());
+  }
+
+  int bufferViewAssignItem(PyObject* self, Py_ssize_t i, PyObject* value)
+  {
+    boost::python::handle<> index(PyLong_FromSsize_t(i));
+    return bufferViewAssign(self, index.get(), value);
+  }
+
+  const Py_ssize_t maxReprItems = 100;
+
+  PyObject* bufferViewRepr(PyObject* self)
+  {
+    auto view = asView(self);
+    if (view->shape[0] * view->shape[1] <= maxReprItems)
+    {
+      boost::python::handle<> list(boost::python::allow_null(bufferViewToList(self, nullptr)));
+      if (!list)
+        return nullptr;
+      return PyUnicode_FromFormat("BufferView(%R)", list.get());
+    }
+    if (view->ndim > 1)
+      return PyUnicode_FromFormat("BufferView(shape=(%zd, %zd), format='%s')", view->shape[0], view->shape[1], view->format);
+    return PyUnicode_FromFormat("BufferView(shape=(%zd,), format='%s')", view->shape[0], view->format);
+  }
+
+  PyTypeObject* bufferViewType()
+  {
+    static PySequenceMethods sequenceMethods;
+    static PyMappingMethods mappingMethods;
+    static PyBufferProcs bufferProcs;
+    static PyMethodDef methods[] =
+    {
+      { "tolist", bufferViewToList, METH_NOARGS, "Copies the values into nested lists." },
+      { nullptr, nullptr, 0, nullptr }
+    };
+    static PyTypeObject type = { PyVarObject_HEAD_INIT(nullptr, 0) };
+    if (!type.tp_name)
+    {
+      sequenceMethods.sq_length = bufferViewLength;
+      sequenceMethods.sq_item = bufferViewItem;
+      sequenceMethods.sq_ass_item = bufferViewAssignItem;
+      mappingMethods.mp_length = bufferViewLength;
+      mappingMethods.mp_subscript = bufferViewSubscript;
+      mappingMethods.mp_ass_subscript = bufferViewAssign;
+      bufferProcs.bf_getbuffer = bufferViewGetBuffer;
+      type.tp_name = "scirun.BufferView";
+      type.tp_basicsize = sizeof(BufferViewObject);
+      type.tp_dealloc = bufferViewDealloc;
+      type.tp_repr = bufferViewRepr;
+      type.tp_as_sequence = &sequenceMethods;
+      type.tp_as_mapping = &mappingMethods;
+      type.tp_as_buffer = &bufferProcs;
+      type.tp_methods = methods;
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+      type.tp_doc = "View of SCIRun data; writing to it first copies the data";
+      PyType_Ready(&type);
+    }
+    return &type;
+  }
+
+  template <class T>
+  char formatOf();
+  template <> char formatOf<double>() { return 'd'; }
+  template <> char formatOf<unsigned int>() { return 'I'; }
+  template <> char formatOf<long long>() { return 'q'; }
+
+  template <class T>
+  boost::python::object makeView(const T* data, int ndim, const Py_ssize_t* shape, boost::shared_ptr<const void> owner, DatatypeHandle datatype)
+  {
+    Py_ssize_t strides[] = { ndim > 1 ? shape[1] * static_cast<Py_ssize_t>(sizeof(T)) : static_cast<Py_ssize_t>(sizeof(T)), sizeof(T) };
+    auto bytes = static_cast<size_t>(shape[0] * (ndim > 1 ? shape[1] : 1)) * sizeof(T);
+    auto storage = boost::make_shared<BufferViewStorage>(owner, datatype, data, bytes, ndim);
+    return boost::python::object(boost::python::handle<>(newBufferView(storage, 0, formatOf<T>(), sizeof(T), ndim, shape, strides)));
+  }
+
+  template <class T>
+  boost::python::object makeView(const T* data, size_t rows, size_t columns, boost::shared_ptr<const void> owner, DatatypeHandle datatype)
+  {
+    Py_ssize_t shape[] = { static_cast<Py_ssize_t>(rows), static_cast<Py_ssize_t>(columns) };
+    return makeView(data, 2, shape, owner, datatype);
+  }
+
+  template <class T>
+  boost::python::object makeView(const T* data, size_t size, boost::shared_ptr<const void> owner)
+  {
+    Py_ssize_t shape[] = { static_cast<Py_ssize_t>(size) };
+    return makeView(data, 1, shape, owner, nullptr);
+  }
+
+  bool sameLayout(const Py_buffer& buffer, const BufferViewObject* view)
+  {
+    if (buffer.buf != storageOf(view).data + view->offset || buffer.ndim != view->ndim || buffer.itemsize != view->itemsize)
+      return false;
+    if (!buffer.format || std::strcmp(buffer.format, view->format) != 0)
+      return false;
+    for (int d = 0; d < view->ndim; ++d)
+    {
+      if (buffer.shape[d] != view->shape[d] || (buffer.shape[d] > 1 && buffer.strides[d] != view->strides[d]))
+        return false;
+    }
+    return true;
+  }
+
+  // Native or little-endian standard single item formats, reduced to the fixed-size codes
+  // readNumber knows; anything else is copied elementwise by Python first. Integer sizes are
+  // taken from the exporter's itemsize, since 'l' is 4 bytes in standard mode and on Windows
+  // but 8 bytes natively on Linux, and some exporters (ctypes) mix the two.
+  char numericFormat(const char* format, Py_ssize_t itemsize)
+  {
+    if (!format)
+      return itemsize == 1 ? 'B' : '\0';
+    if (*format == '@' || *format == '=' || *format == '<')
+      ++format;
+    if (!format[0] || format[1])
+      return '\0';
+    const char* sized;
+    if (std::strchr("bhilq", format[0]))
+      sized = "bh\0i\0\0\0q";
+    else if (std::strchr("BHILQ", format[0]))
+      sized = "BH\0I\0\0\0Q";
+    else if (format[0] == 'd')
+      return itemsize == 8 ? 'd' : '\0';
+    else if (format[0] == 'f')
+      return itemsize == 4 ? 'f' : '\0';
+    else if (format[0] == '?')
+      return itemsize == 1 ? '?' : '\0';
+    else
+      return '\0';
+    return itemsize >= 1 && itemsize <= 8 ? sized[itemsize - 1] : '\0';
+  }
+
+  template <class T>
+  double read(const char* item)
+  {
+    T value;
+    std::memcpy(&value, item, sizeof(T));
+    return static_cast<double>(value);
+  }
+
+  double readNumber(const char* item, char format)
+  {
+    switch (format)
+    {
+    case 'd': return read<double>(item);
+    case 'f': return read<float>(item);
+    case 'b': return read<int8_t>(item);
+    case 'B': return read<uint8_t>(item);
+    case 'h': return read<int16_t>(item);
+    case 'H': return read<uint16_t>(item);
+    case 'i': return read<int32_t>(item);
+    case 'I': return read<uint32_t>(item);
+    case 'q': return read<int64_t>(item);
+    case 'Q': return read<uint64_t>(item);
+    case '?': return read<bool>(item);
+    default: return 0;
+    }
+  }
+}
+
+boost::python::object SCIRun::Core::Python::makeBufferView(const double* data, size_t rows, size_t columns, boost::shared_ptr<const void> owner, DatatypeHandle datatype)
+{
+  return makeView(data, rows, columns, owner, datatype);
+}
+
+boost::python::object SCIRun::Core::Python::makeBufferView(const double* data, size_t size, boost::shared_ptr<const void> owner)
+{
+  return makeView(data, size, owner);
+}
+
+boost::python::object SCIRun::Core::Python::makeBufferView(const unsigned int* data, size_t rows, size_t columns, boost::shared_ptr<const void> owner)
+{
+  return makeView(data, rows, columns, owner, nullptr);
+}
+
+boost::python::object SCIRun::Core::Python::makeBufferView(const unsigned int* data, size_t size, boost::shared_ptr<const void> owner)
+{
+  return makeView(data, size, owner);
+}
+
+boost::python::object SCIRun::Core::Python::makeBufferView(const long long* data, size_t size, boost::shared_ptr<const void> owner)
+{
+  return makeView(data, size, owner);
+}
+
+DatatypeHandle SCIRun::Core::Python::viewedDatatype(const boost::python::object& object)
+{
+  auto type = reinterpret_cast<PyObject*>(bufferViewType());
+  // numpy arrays keep their exporter in .base and memoryviews in .obj
+  boost::python::object exporter = object;
+  for (int depth = 0; depth < 8 && !exporter.is_none(); ++depth)
+  {
+    if (PyObject_TypeCheck(exporter.ptr(), reinterpret_cast<PyTypeObject*>(type)))
+    {
+      auto view = asView(exporter.ptr());
+      auto datatype = storageOf(view).datatype;
+      if (!datatype || !coversStorage(view))
+        return nullptr;
+      Py_buffer buffer;
+      if (PyObject_GetBuffer(object.ptr(), &buffer, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+      {
+        PyErr_Clear();
+        return nullptr;
+      }
+      auto same = sameLayout(buffer, view);
+      PyBuffer_Release(&buffer);
+      return same ? datatype : nullptr;
+    }
+    const char* link = PyObject_HasAttrString(exporter.ptr(), "base") ? "base" :
+      PyMemoryView_Check(exporter.ptr()) ? "obj" : nullptr;
+    if (!link)
+      return nullptr;
+    exporter = exporter.attr(link);
+  }
+  return nullptr;
+}
+
+NumericBuffer::NumericBuffer(const boost::python::object& object) : valid_(false)
+{
+  if (!PyObject_CheckBuffer(object.ptr()))
+    return;
+  if (PyObject_GetBuffer(object.ptr(), &buffer_, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+  {
+    PyErr_Clear();
+    return;
+  }
+  valid_ = (buffer_.ndim == 1 || buffer_.ndim == 2) && !buffer_.suboffsets && numericFormat(buffer_.format, buffer_.itemsize) != '\0';
+  if (!valid_)
+    PyBuffer_Release(&buffer_);
+}
+
+NumericBuffer::~NumericBuffer()
+{
+  if (valid_)
+    PyBuffer_Release(&buffer_);
+}
+
+int NumericBuffer::ndim() const
+{
+  return buffer_.ndim;
+}
+
+size_t NumericBuffer::shape(int dim) const
+{
+  return dim < buffer_.ndim ? static_cast<size_t>(buffer_.shape[dim]) : 1;
+}
+
+size_t NumericBuffer::size() const
+{
+  return shape(0) * shape(1);
+}
+
+void NumericBuffer::copyTo(double* destination) const
+{
+  auto format = numericFormat(buffer_.format, buffer_.itemsize);
+  if (format == 'd' && PyBuffer_IsContiguous(&buffer_, 'C'))
+  {
+    std::memcpy(destination, buffer_.buf, size() * sizeof(double));
+    return;
+  }
+  auto data = static_cast<const char*>(buffer_.buf);
+  // Some exporters (ctypes) leave strides null for C-contiguous data
+  auto rowStride = buffer_.strides ? buffer_.strides[0] : static_cast<Py_ssize_t>(shape(1)) * buffer_.itemsize;
+  auto columnStride = buffer_.ndim > 1 ? (buffer_.strides ? buffer_.strides[1] : buffer_.itemsize) : 0;
+  for (size_t i = 0; i < shape(0); ++i)
+  {
+    auto row = data + i * rowStride;
+    for (size_t j = 0; j < shape(1); ++j)
+      *destination++ = readNumber(row + j * columnStride, format);
+  }
+}
+
+std::vector<double> NumericBuffer::values() const
+{
+  std::vector<double> values(size());
+  copyTo(values.data());
+  return values;
+}
+
+#endif
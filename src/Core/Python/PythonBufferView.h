@@ -0,0 +1,89 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef BUILD_WITH_PYTHON
+#ifndef CORE_PYTHON_PYTHONBUFFERVIEW_H
+#define CORE_PYTHON_PYTHONBUFFERVIEW_H
+
+#include <boost/python.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <Core/Datatypes/DatatypeFwd.h>
+
+#include <Core/Python/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Python
+    {
+      /// Views of SCIRun memory that Python sees through the buffer protocol, so memoryview
+      /// and numpy.asarray share the data instead of copying it. A view also acts as a sequence
+      /// of rows that supports indexing, slicing (m[1:, ::2]), tolist() and item assignment,
+      /// which keeps scripts written against the list conversion working. The first write, or
+      /// the first request for a writable buffer, copies the data: the SCIRun object never
+      /// changes, and the view and the views sliced from it carry on with the copy.
+      /// owner keeps the memory alive while Python holds the view. datatype is the SCIRun
+      /// object the view covers, if any; see viewedDatatype.
+      SCISHARE boost::python::object makeBufferView(const double* data, size_t rows, size_t columns,
+        boost::shared_ptr<const void> owner, Datatypes::DatatypeHandle datatype = nullptr);
+      SCISHARE boost::python::object makeBufferView(const double* data, size_t size, boost::shared_ptr<const void> owner);
+      SCISHARE boost::python::object makeBufferView(const unsigned int* data, size_t rows, size_t columns, boost::shared_ptr<const void> owner);
+      SCISHARE boost::python::object makeBufferView(const unsigned int* data, size_t size, boost::shared_ptr<const void> owner);
+      SCISHARE boost::python::object makeBufferView(const long long* data, size_t size, boost::shared_ptr<const void> owner);
+
+      /// Returns the datatype a view was made from when the object, or the memoryview/numpy
+      /// array chain it was built on, still covers exactly that view. Writes go to a copy, so
+      /// handing the datatype back is safe; a view Python has written to returns null.
+      SCISHARE Datatypes::DatatypeHandle viewedDatatype(const boost::python::object& object);
+
+      /// Numeric contents of any object exporting a one- or two-dimensional buffer.
+      class SCISHARE NumericBuffer : boost::noncopyable
+      {
+      public:
+        explicit NumericBuffer(const boost::python::object& object);
+        ~NumericBuffer();
+        bool valid() const { return valid_; }
+        int ndim() const;
+        size_t shape(int dim) const;
+        size_t size() const;
+        /// Copies the values in row-major order, converting them to double.
+        void copyTo(double* destination) const;
+        std::vector<double> values() const;
+      private:
+        Py_buffer buffer_;
+        bool valid_;
+      };
+    }
+  }
+}
+
+#endif
+#endif
@@ -35,12 +35,14 @@
 #endif
 
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonBufferView.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/String.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Matlab/matlabarray.h>
 #include <Core/Matlab/matlabconverter.h>
+#include <boost/make_shared.hpp>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Python;
@@ -48,48 +50,6 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::MatlabIO;
 
-namespace
-{
-  template <class T>
-  boost::python::list toPythonList(const DenseMatrixGeneric<T>& dense)
-  {
-    boost::python::list list;
-    for (int i = 0; i < dense.nrows(); ++i)
-    {
-      boost::python::list row;
-      for (int j = 0; j < dense.ncols(); ++j)
-        row.append(dense(i, j));
-      list.append(row);
-    }
-    return list;
-  }
-
-  template <class T>
-  boost::python::list toPythonList(const SparseRowMatrixGeneric<T>& sparse)
-  {
-    boost::python::list rows, columns, values;
-
-    for (int i = 0; i < sparse.nonZeros(); ++i)
-    {
-      values.append(sparse.valuePtr()[i]);
-    }
-    for (int i = 0; i < sparse.nonZeros(); ++i)
-    {
-      columns.append(sparse.innerIndexPtr()[i]);
-    }
-    for (int i = 0; i < sparse.outerSize(); ++i)
-    {
-      rows.append(sparse.outerIndexPtr()[i]);
-    }
-
-    boost::python::list list;
-    list.append(rows);
-    list.append(columns);
-    list.append(values);
-    return list;
-  }
-}
-
 boost::python::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field)
 {
   matlabarray ma;
@@ -112,25 +72,23 @@ boost::python::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field
     }
     case matfilebase::miUINT32:
     {
-      std::vector<unsigned int> v;
-      subField.getnumericarray(v);
+      auto v = boost::make_shared<std::vector<unsigned int>>();
+      subField.getnumericarray(*v);
       if (1 != subField.getm() && 1 != subField.getn())
-        matlabStructure[fieldName] = toPythonListOfLists(v, subField.getn(), subField.getm());
+        matlabStructure[fieldName] = makeBufferView(v->data(), subField.getn(), subField.getm(), v);
       else
-        matlabStructure[fieldName] = toPythonList(v);
+        matlabStructure[fieldName] = makeBufferView(v->data(), v->size(), v);
       break;
     }
     case matfilebase::miDOUBLE:
     {
-      std::vector<double> v;
-      subField.getnumericarray(v);
-      // std::cout << "miDOUBLE " << subField.getm() << "x" << subField.getn() << "\n";
-      // std::copy(v.begin(), v.end(), std::ostream_iterator<double>(std::cout, " "));
-      // std::cout << "\n...\n";
+      // matlab arrays are column-major, so an m x n array is viewed as n rows of m values
+      auto v = boost::make_shared<std::vector<double>>();
+      subField.getnumericarray(*v);
       if (1 != subField.getm() && 1 != subField.getn())
-        matlabStructure[fieldName] = toPythonListOfLists(v, subField.getn(), subField.getm());
+        matlabStructure[fieldName] = makeBufferView(v->data(), subField.getn(), subField.getm(), v);
       else
-        matlabStructure[fieldName] = toPythonList(v);
+        matlabStructure[fieldName] = makeBufferView(v->data(), v->size(), v);
       break;
     }
     default:
@@ -141,18 +99,30 @@ boost::python::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field
   return matlabStructure;
 }
 
-boost::python::list SCIRun::Core::Python::convertMatrixToPython(DenseMatrixHandle matrix)
+boost::python::object SCIRun::Core::Python::convertMatrixToPython(DenseMatrixHandle matrix)
 {
   if (matrix)
-    return ::toPythonList(*matrix);
+    return makeBufferView(matrix->data(), matrix->nrows(), matrix->ncols(), matrix, matrix);
   return {};
 }
 
 boost::python::object SCIRun::Core::Python::convertMatrixToPython(SparseRowMatrixHandle matrix)
 {
-  if (matrix)
-    return ::toPythonList(*matrix);
-  return {};
+  if (!matrix)
+    return {};
+
+  auto compressed = matrix;
+  if (!matrix->isCompressed())
+  {
+    compressed = boost::make_shared<SparseRowMatrix>(*matrix);
+    compressed->makeCompressed();
+  }
+
+  boost::python::list list;
+  list.append(makeBufferView(compressed->outerIndexPtr(), compressed->outerSize() + 1, compressed));
+  list.append(makeBufferView(compressed->innerIndexPtr(), compressed->nonZeros(), compressed));
+  list.append(makeBufferView(compressed->valuePtr(), compressed->nonZeros(), compressed));
+  return list;
 }
 
 boost::python::object SCIRun::Core::Python::convertStringToPython(StringHandle str)
@@ -167,6 +137,15 @@ boost::python::object SCIRun::Core::Python::convertStringToPython(StringHandle s
 
 bool DenseMatrixExtractor::check() const
 {
+  if (boost::dynamic_pointer_cast<DenseMatrix>(viewedDatatype(object_)))
+    return true;
+
+  {
+    NumericBuffer buffer(object_);
+    if (buffer.valid())
+      return 2 == buffer.ndim();
+  }
+
   boost::python::extract<boost::python::list> e(object_);
   if (!e.check())
     return false;
@@ -183,7 +162,20 @@ bool DenseMatrixExtractor::check() const
 
 DatatypeHandle DenseMatrixExtractor::operator()() const
 {
-  DenseMatrixHandle dense;
+  DenseMatrixHandle dense = boost::dynamic_pointer_cast<DenseMatrix>(viewedDatatype(object_));
+  if (dense)
+    return dense;
+
+  {
+    NumericBuffer buffer(object_);
+    if (buffer.valid() && 2 == buffer.ndim())
+    {
+      dense.reset(new DenseMatrix(buffer.shape(0), buffer.shape(1)));
+      buffer.copyTo(dense->data());
+      return dense;
+    }
+  }
+
   boost::python::extract<boost::python::list> e(object_);
   if (e.check())
   {
@@ -257,7 +249,7 @@ bool FieldExtractor::check() const
 
     boost::python::extract<std::string> value_i_string(values[i]);
     boost::python::extract<boost::python::list> value_i_list(values[i]);
-    if (!value_i_string.check() && !value_i_list.check())
+    if (!value_i_string.check() && !value_i_list.check() && !PyObject_CheckBuffer(boost::python::object(values[i]).ptr()))
       return false;
   }
 
@@ -266,10 +258,25 @@ bool FieldExtractor::check() const
 
 namespace
 {
-  matlabarray getPythonFieldDictionaryValue(const boost::python::extract<std::string>& strExtract, const boost::python::extract<boost::python::list>& listExtract)
+  matlabarray getPythonFieldDictionaryValue(const boost::python::object& object)
   {
+    boost::python::extract<std::string> strExtract(object);
+    boost::python::extract<boost::python::list> listExtract(object);
+    NumericBuffer buffer(object);
     matlabarray value;
-    if (strExtract.check())
+    if (buffer.valid())
+    {
+      if (1 == buffer.size() && 1 == buffer.ndim())
+        value.createdoublescalar(buffer.values()[0]);
+      else if (2 == buffer.ndim())
+      {
+        std::vector<int> dims = { static_cast<int>(buffer.shape(1)), static_cast<int>(buffer.shape(0)) };
+        value.createdoublematrix(buffer.values(), dims);
+      }
+      else
+        value.createdoublevector(buffer.values());
+    }
+    else if (strExtract.check())
     {
       value.createstringarray();
       auto strData = strExtract();
@@ -329,12 +336,9 @@ DatatypeHandle FieldExtractor::operator()() const
   for (int i = 0; i < length; ++i)
   {
     boost::python::extract<std::string> key_i(keys[i]);
-
-    boost::python::extract<std::string> value_i_string(values[i]);
-    boost::python::extract<boost::python::list> value_i_list(values[i]);
     auto fieldName = key_i();
     //std::cout << "setting field " << fieldName << std::endl;
-    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(value_i_string, value_i_list));
+    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(values[i]));
   }
 
   FieldHandle field;
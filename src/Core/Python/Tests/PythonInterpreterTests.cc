@@ -32,6 +32,9 @@
 #include <gtest/gtest.h>
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonBufferView.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -430,3 +433,209 @@ TEST_F(FieldConversionTests, RejectsIncompatibleDictionary)
 
   ASSERT_FALSE(converter.check());
 }
+
+class MatrixConversionTests : public testing::Test
+{
+protected:
+  virtual void SetUp() override
+  {
+    Py_Initialize();
+  }
+
+  static boost::python::object eval(const std::string& expression)
+  {
+    auto main = boost::python::import("__main__");
+    return boost::python::eval(boost::python::str(expression), main.attr("__dict__"));
+  }
+
+  static Datatypes::DenseMatrixHandle matrix()
+  {
+    auto m = boost::make_shared<Datatypes::DenseMatrix>(3, 4);
+    for (size_t i = 0; i < m->nrows(); ++i)
+      for (size_t j = 0; j < m->ncols(); ++j)
+        (*m)(i, j) = 10 * i + j;
+    return m;
+  }
+};
+
+TEST_F(MatrixConversionTests, DenseMatrixIsSharedNotCopied)
+{
+  auto m = matrix();
+  auto pyMatrix = convertMatrixToPython(m);
+
+  Py_buffer buffer;
+  ASSERT_EQ(0, PyObject_GetBuffer(pyMatrix.ptr(), &buffer, PyBUF_RECORDS_RO));
+  EXPECT_EQ(m->data(), buffer.buf);
+  EXPECT_EQ(2, buffer.ndim);
+  EXPECT_EQ(3, buffer.shape[0]);
+  EXPECT_EQ(4, buffer.shape[1]);
+  EXPECT_TRUE(buffer.readonly);
+  PyBuffer_Release(&buffer);
+
+  // Row indexing still works for scripts written against the list-of-lists conversion
+  EXPECT_EQ(3, len(pyMatrix));
+  EXPECT_EQ(4, len(pyMatrix[1]));
+  EXPECT_EQ(12.0, boost::python::extract<double>(pyMatrix[1][2])());
+}
+
+TEST_F(MatrixConversionTests, UnchangedViewIsHandedBackWithoutCopy)
+{
+  auto m = matrix();
+  auto pyMatrix = convertMatrixToPython(m);
+
+  DenseMatrixExtractor direct(pyMatrix);
+  ASSERT_TRUE(direct.check());
+  EXPECT_EQ(m, direct());
+
+  auto memoryView = boost::python::object(boost::python::handle<>(PyMemoryView_FromObject(pyMatrix.ptr())));
+  DenseMatrixExtractor throughView(memoryView);
+  ASSERT_TRUE(throughView.check());
+  EXPECT_EQ(m, throughView());
+
+  boost::python::object firstRow = pyMatrix[0];
+  DenseMatrixExtractor row(firstRow);
+  EXPECT_FALSE(row.check());
+}
+
+TEST_F(MatrixConversionTests, WritesGoToACopyOfTheMatrix)
+{
+  auto m = matrix();
+  auto pyMatrix = convertMatrixToPython(m);
+  auto row = pyMatrix[1];
+
+  pyMatrix[1][2] = 99.0;
+  EXPECT_EQ(12, (*m)(1, 2));
+  EXPECT_EQ(99.0, boost::python::extract<double>(pyMatrix[1][2])());
+  // Rows taken before the write share the copy
+  EXPECT_EQ(99.0, boost::python::extract<double>(row[2])());
+
+  Py_buffer buffer;
+  ASSERT_EQ(0, PyObject_GetBuffer(pyMatrix.ptr(), &buffer, PyBUF_RECORDS));
+  EXPECT_NE(m->data(), buffer.buf);
+  EXPECT_FALSE(buffer.readonly);
+  PyBuffer_Release(&buffer);
+
+  DenseMatrixExtractor e(pyMatrix);
+  ASSERT_TRUE(e.check());
+  auto changed = boost::dynamic_pointer_cast<Datatypes::DenseMatrix>(e());
+  ASSERT_TRUE(changed != nullptr);
+  EXPECT_NE(m, changed);
+  EXPECT_EQ(99, (*changed)(1, 2));
+  EXPECT_EQ(11, (*changed)(1, 1));
+}
+
+TEST_F(MatrixConversionTests, WritableBufferRequestCopiesFirst)
+{
+  auto m = matrix();
+  auto pyMatrix = convertMatrixToPython(m);
+
+  Py_buffer buffer;
+  ASSERT_EQ(0, PyObject_GetBuffer(pyMatrix.ptr(), &buffer, PyBUF_WRITABLE));
+  EXPECT_NE(m->data(), buffer.buf);
+  static_cast<double*>(buffer.buf)[0] = -1;
+  PyBuffer_Release(&buffer);
+
+  EXPECT_EQ(0, (*m)(0, 0));
+  EXPECT_EQ(-1.0, boost::python::extract<double>(pyMatrix[0][0])());
+  EXPECT_TRUE(viewedDatatype(pyMatrix) == nullptr);
+}
+
+TEST_F(MatrixConversionTests, ViewsSliceAndConvertToLists)
+{
+  auto main = boost::python::import("__main__");
+  main.attr("m") = convertMatrixToPython(matrix());
+
+  EXPECT_EQ(2, len(eval("m[1:]")));
+  EXPECT_EQ(23.0, boost::python::extract<double>(eval("m[-1, 3]"))());
+  EXPECT_TRUE(boost::python::extract<bool>(eval("m[:, 1].tolist() == [1.0, 11.0, 21.0]"))());
+  EXPECT_TRUE(boost::python::extract<bool>(eval("m[::2, ::-1].tolist() == [[3.0, 2.0, 1.0, 0.0], [23.0, 22.0, 21.0, 20.0]]"))());
+  EXPECT_TRUE(boost::python::extract<bool>(eval("memoryview(m[:, 1]).tolist() == [1.0, 11.0, 21.0]"))());
+  EXPECT_TRUE(boost::python::extract<bool>(eval("[list(r) for r in m] == m.tolist()"))());
+  EXPECT_EQ("BufferView([0.0, 1.0, 2.0, 3.0])", boost::python::extract<std::string>(eval("repr(m[0])"))());
+
+  // Strided views are not handed back as the matrix they came from
+  auto strided = eval("m[:, 1:2]");
+  DenseMatrixExtractor column(strided);
+  ASSERT_TRUE(column.check());
+  auto actual = boost::dynamic_pointer_cast<Datatypes::DenseMatrix>(column());
+  ASSERT_TRUE(actual != nullptr);
+  ASSERT_EQ(3, actual->nrows());
+  ASSERT_EQ(1, actual->ncols());
+  EXPECT_EQ(21, (*actual)(2, 0));
+}
+
+TEST_F(MatrixConversionTests, SliceAssignmentCopiesOverlappingSource)
+{
+  auto m = matrix();
+  auto main = boost::python::import("__main__");
+  main.attr("m") = convertMatrixToPython(m);
+
+  boost::python::exec("m[0, 1:] = m[0, :3]\nm[2] = 7", main.attr("__dict__"));
+  EXPECT_TRUE(boost::python::extract<bool>(eval("m.tolist() == [[0.0, 0.0, 1.0, 2.0], [10.0, 11.0, 12.0, 13.0], [7.0, 7.0, 7.0, 7.0]]"))());
+  EXPECT_EQ(1, (*m)(0, 1));
+}
+
+TEST_F(MatrixConversionTests, LongFormatsUseTheExportedItemSize)
+{
+  // ctypes exports c_long as '<l' with the native size, which is 8 bytes on Linux and 4 on Windows
+  NumericBuffer longs(eval("(__import__('ctypes').c_long * 3)(1, -2, 3)"));
+  ASSERT_TRUE(longs.valid());
+  EXPECT_EQ(std::vector<double>({ 1, -2, 3 }), longs.values());
+
+  NumericBuffer unsignedLongs(eval("(__import__('ctypes').c_ulong * 2)(4, 5)"));
+  ASSERT_TRUE(unsignedLongs.valid());
+  EXPECT_EQ(std::vector<double>({ 4, 5 }), unsignedLongs.values());
+
+  NumericBuffer shorts(eval("memoryview(__import__('array').array('h', [-7, 8]))"));
+  ASSERT_TRUE(shorts.valid());
+  EXPECT_EQ(std::vector<double>({ -7, 8 }), shorts.values());
+}
+
+TEST_F(MatrixConversionTests, ForeignBufferIsCopiedIntoNewMatrix)
+{
+  auto pyMatrix = eval("memoryview(__import__('array').array('d', [1, 2, 3, 4, 5, 6])).cast('B').cast('d', [2, 3])");
+
+  DenseMatrixExtractor e(pyMatrix);
+  ASSERT_TRUE(e.check());
+  auto actual = boost::dynamic_pointer_cast<Datatypes::DenseMatrix>(e());
+  ASSERT_TRUE(actual != nullptr);
+  ASSERT_EQ(2, actual->nrows());
+  ASSERT_EQ(3, actual->ncols());
+  EXPECT_EQ(6, (*actual)(1, 2));
+  EXPECT_EQ(2, (*actual)(0, 1));
+}
+
+TEST_F(MatrixConversionTests, ListOfListsIsStillAccepted)
+{
+  auto pyMatrix = eval("[[1, 2], [3, 4], [5, 6]]");
+
+  DenseMatrixExtractor e(pyMatrix);
+  ASSERT_TRUE(e.check());
+  auto actual = boost::dynamic_pointer_cast<Datatypes::DenseMatrix>(e());
+  ASSERT_TRUE(actual != nullptr);
+  ASSERT_EQ(3, actual->nrows());
+  EXPECT_EQ(4, (*actual)(1, 1));
+}
+
+TEST_F(MatrixConversionTests, SparseMatrixBecomesCsrViews)
+{
+  auto sparse = boost::make_shared<Datatypes::SparseRowMatrix>(3, 3);
+  sparse->insert(0, 0) = 1;
+  sparse->insert(1, 2) = 2;
+  sparse->insert(2, 1) = 3;
+  sparse->makeCompressed();
+
+  auto csr = convertMatrixToPython(sparse);
+  ASSERT_EQ(3, len(csr));
+  EXPECT_EQ(4, len(csr[0]));
+  EXPECT_EQ(3, len(csr[1]));
+  EXPECT_EQ(3, len(csr[2]));
+  EXPECT_EQ(3, boost::python::extract<long long>(csr[0][3])());
+  EXPECT_EQ(2, boost::python::extract<long long>(csr[1][1])());
+  EXPECT_EQ(3.0, boost::python::extract<double>(csr[2][2])());
+
+  Py_buffer buffer;
+  ASSERT_EQ(0, PyObject_GetBuffer(boost::python::object(csr[2]).ptr(), &buffer, PyBUF_RECORDS_RO));
+  EXPECT_EQ(sparse->valuePtr(), buffer.buf);
+  PyBuffer_Release(&buffer);
+}
@@ -29,30 +29,263 @@
 #include <Core/Thread/Parallel.h>
 #include <Core/Logging/Log.h>
 #include <boost/thread/thread.hpp>
+#include <boost/enable_shared_from_this.hpp>
 #include <vector>
 #include <iostream>
 
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Logging;
 
+namespace
+{
+  class CachedThread;
+  typedef boost::shared_ptr<CachedThread> CachedThreadHandle;
+
+  /// Keeps finished RunTasks threads parked so the next call reuses them instead of paying
+  /// thread creation and join again.
+  class ThreadCache : boost::noncopyable
+  {
+  public:
+    static ThreadCache& instance()
+    {
+      // never destroyed: parked threads are detached and may still be waiting at exit
+      static ThreadCache* cache = new ThreadCache;
+      return *cache;
+    }
+    CachedThreadHandle acquire();
+    bool release(CachedThreadHandle thread);
+  private:
+    ThreadCache() : maxIdle_(4 * std::max(1u, boost::thread::hardware_concurrency())) {}
+    boost::mutex lock_;
+    std::vector<CachedThreadHandle> idle_;
+    const size_t maxIdle_;
+  };
+
+  class CachedThread : public boost::enable_shared_from_this<CachedThread>, boost::noncopyable
+  {
+  public:
+    void start()
+    {
+      auto self = shared_from_this();
+      thread_ = boost::thread([self]() { self->loop(); });
+    }
+
+    void run(const boost::function<void()>& job)
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      job_ = job;
+      wakeup_.notify_one();
+    }
+
+    void interrupt()
+    {
+      thread_.interrupt();
+    }
+  private:
+    void loop()
+    {
+      do
+      {
+        boost::function<void()> job;
+        {
+          boost::this_thread::disable_interruption parked;
+          boost::unique_lock<boost::mutex> lock(lock_);
+          wakeup_.wait(lock, [this]() { return !job_.empty(); });
+          job.swap(job_);
+        }
+        job();
+        // swallow an interruption aimed at the finished job so it cannot leak into the next one
+        try
+        {
+          boost::this_thread::interruption_point();
+        }
+        catch (boost::thread_interrupted&)
+        {
+        }
+      } while (ThreadCache::instance().release(shared_from_this()));
+      thread_.detach();
+    }
+
+    boost::mutex lock_;
+    boost::condition_variable wakeup_;
+    boost::function<void()> job_;
+    boost::thread thread_;
+  };
+
+  CachedThreadHandle ThreadCache::acquire()
+  {
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      if (!idle_.empty())
+      {
+        auto thread = idle_.back();
+        idle_.pop_back();
+        return thread;
+      }
+    }
+    auto thread = boost::make_shared<CachedThread>();
+    thread->start();
+    return thread;
+  }
+
+  bool ThreadCache::release(CachedThreadHandle thread)
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    if (idle_.size() >= maxIdle_)
+      return false;
+    idle_.push_back(thread);
+    return true;
+  }
+
+  class RunTasksState : boost::noncopyable
+  {
+  public:
+    explicit RunTasksState(int numTasks) : finished_(numTasks, false), remaining_(numTasks - 1) {}
+
+    void runTask(const Parallel::IndexedTask& task, int i)
+    {
+      try
+      {
+        task(i);
+      }
+      catch (boost::thread_interrupted&)
+      {
+      }
+      catch (...)
+      {
+        fail(std::current_exception());
+      }
+      boost::lock_guard<boost::mutex> lock(lock_);
+      finished_[i] = true;
+      if (--remaining_ == 0)
+        done_.notify_all();
+    }
+
+    void fail(std::exception_ptr error)
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      if (!error_)
+        error_ = error;
+    }
+
+    void wait()
+    {
+      boost::unique_lock<boost::mutex> lock(lock_);
+      done_.wait(lock, [this]() { return remaining_ == 0; });
+    }
+
+    void interruptUnfinished(const std::vector<CachedThreadHandle>& helpers)
+    {
+      {
+        boost::lock_guard<boost::mutex> lock(lock_);
+        for (size_t i = 0; i < helpers.size(); ++i)
+          if (!finished_[i + 1])
+            helpers[i]->interrupt();
+      }
+      // tasks may reference the caller's stack, so wait for them before unwinding
+      boost::this_thread::disable_interruption unwinding;
+      wait();
+    }
+
+    void rethrowIfFailed()
+    {
+      if (error_)
+        std::rethrow_exception(error_);
+    }
+  private:
+    boost::mutex lock_;
+    boost::condition_variable done_;
+    std::vector<bool> finished_;
+    int remaining_;
+    std::exception_ptr error_;
+  };
+}
+
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
-  boost::thread_group threads;
+  const int numTasks = numProcs > 0 ? static_cast<int>(capByUserCoreCount(numProcs)) : 0;
+  if (numTasks == 0)
+    return;
+
+  RunTasksState state(numTasks);
+  std::vector<CachedThreadHandle> helpers;
+  helpers.reserve(numTasks - 1);
+
+  for (int i = 1; i < numTasks; ++i)
+  {
+    auto helper = ThreadCache::instance().acquire();
+    helper->run([&state, &task, i]() { state.runTask(task, i); });
+    helpers.push_back(helper);
+  }
 
-  for (int i = 0; i < capByUserCoreCount(numProcs); ++i)
+  try
   {
-    threads.create_thread(boost::bind(task, i));
+    task(0);
+  }
+  catch (boost::thread_interrupted&)
+  {
+    state.interruptUnfinished(helpers);
+    throw;
+  }
+  catch (...)
+  {
+    state.fail(std::current_exception());
   }
 
   try
   {
-    threads.join_all();
+    state.wait();
   }
   catch (boost::thread_interrupted&)
   {
-    threads.interrupt_all();
+    state.interruptUnfinished(helpers);
     throw;
   }
+  state.rethrowIfFailed();
+}
+
+std::vector<Parallel::IndexRange> Parallel::Partition(size_t begin, size_t end, size_t grainSize)
+{
+  std::vector<IndexRange> chunks;
+  if (end <= begin)
+    return chunks;
+
+  const size_t count = end - begin;
+  if (grainSize == 0)
+  {
+    // several chunks per core leaves work to steal when chunk costs are uneven
+    const size_t targetChunks = std::min<size_t>(count, 8 * std::max(1u, NumCores()));
+    grainSize = (count + targetChunks - 1) / targetChunks;
+  }
+
+  chunks.reserve((count + grainSize - 1) / grainSize);
+  for (size_t first = begin; first < end; first += std::min(grainSize, end - first))
+    chunks.push_back(IndexRange(first, std::min(first + grainSize, end)));
+  return chunks;
+}
+
+void Parallel::For(size_t begin, size_t end, const RangeTask& body, size_t grainSize)
+{
+  const auto chunks = Partition(begin, end, grainSize);
+  if (chunks.size() <= 1 || NumCores() <= 1)
+  {
+    for (const auto& chunk : chunks)
+      body(chunk.first, chunk.second);
+    return;
+  }
+
+  TaskGroup group;
+  std::vector<WorkStealingThreadPool::Task> tasks;
+  tasks.reserve(chunks.size() - 1);
+  for (size_t c = 1; c < chunks.size(); ++c)
+  {
+    const auto chunk = chunks[c];
+    tasks.push_back([&body, chunk]() { body(chunk.first, chunk.second); });
+  }
+  group.run(tasks);
+
+  body(chunks[0].first, chunks[0].second);
+  group.wait();
 }
 
 unsigned int Parallel::NumCores()
@@ -72,6 +305,7 @@ void Parallel::SetMaximumCores(unsigned int max)
     logWarning("Maximum cores available for parallel algorithms set to {}", max);
   }
   maximumCoresSetByUser_ = max;
+  WorkStealingThreadPool::instance().setActiveWorkerLimit(NumCores());
 }
 
 unsigned int Parallel::capByUserCoreCount(unsigned int numProcs)
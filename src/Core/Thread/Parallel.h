@@ -31,6 +31,11 @@
 
 #include <boost/noncopyable.hpp>
 #include <boost/function.hpp>
+#include <Core/Thread/ThreadPool.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <Core/Thread/share.h>
 
 namespace SCIRun
@@ -43,9 +48,95 @@ namespace Thread
   {
   public:
     typedef boost::function<void(int)> IndexedTask;
+    /// Runs task(0..numProcs-1) concurrently, all live at once, so tasks may synchronize with a Barrier.
+    /// Task 0 runs on the calling thread; the rest run on cached threads that are reused across calls.
     static void RunTasks(IndexedTask task, int numProcs);
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
+
+    typedef std::pair<size_t, size_t> IndexRange;
+    typedef boost::function<void(size_t, size_t)> RangeTask;
+
+    /// Splits [begin, end) into chunks of about grainSize indices (0 picks a size from NumCores()).
+    static std::vector<IndexRange> Partition(size_t begin, size_t end, size_t grainSize = 0);
+
+    /// Calls body(chunkBegin, chunkEnd) for every chunk of [begin, end) on the shared work-stealing pool.
+    /// Chunks must be independent. Nested calls from inside a chunk reuse the pool's threads.
+    static void For(size_t begin, size_t end, const RangeTask& body, size_t grainSize = 0);
+
+    /// reduceRange(chunkBegin, chunkEnd, identity) produces one partial per chunk; partials are combined
+    /// in index order, so the result does not depend on scheduling.
+    template <typename T, class RangeReduce, class Combine>
+    static T Reduce(size_t begin, size_t end, const T& identity, RangeReduce reduceRange, Combine combine, size_t grainSize = 0)
+    {
+      const auto chunks = Partition(begin, end, grainSize);
+      std::vector<T> partials(chunks.size(), identity);
+      For(0, chunks.size(), [&](size_t first, size_t last)
+      {
+        for (size_t c = first; c < last; ++c)
+          partials[c] = reduceRange(chunks[c].first, chunks[c].second, identity);
+      }, 1);
+
+      T result = identity;
+      for (const auto& partial : partials)
+        result = combine(result, partial);
+      return result;
+    }
+
+    /// Sorts [first, last) by sorting one chunk per task and then merging neighbouring chunks
+    /// pairwise, each round of merges running in parallel. Not stable; give comp a total order
+    /// if equal elements must end up in a reproducible order.
+    template <class RandomIt, class Compare>
+    static void Sort(RandomIt first, RandomIt last, Compare comp, size_t grainSize = 0)
+    {
+      const size_t count = static_cast<size_t>(last - first);
+      const auto chunks = Partition(0, count, grainSize);
+      if (chunks.size() <= 1 || NumCores() <= 1)
+      {
+        std::sort(first, last, comp);
+        return;
+      }
+
+      For(0, chunks.size(), [&](size_t b, size_t e)
+      {
+        for (size_t c = b; c < e; ++c)
+          std::sort(first + chunks[c].first, first + chunks[c].second, comp);
+      }, 1);
+
+      std::vector<size_t> bounds;
+      for (const auto& chunk : chunks)
+        bounds.push_back(chunk.first);
+      bounds.push_back(count);
+
+      while (bounds.size() > 2)
+      {
+        const size_t runs = bounds.size() - 1;
+        For(0, runs / 2, [&](size_t b, size_t e)
+        {
+          for (size_t p = b; p < e; ++p)
+            std::inplace_merge(first + bounds[2 * p], first + bounds[2 * p + 1], first + bounds[2 * p + 2], comp);
+        }, 1);
+
+        std::vector<size_t> merged;
+        for (size_t r = 0; r < runs; r += 2)
+          merged.push_back(bounds[r]);
+        merged.push_back(count);
+        bounds.swap(merged);
+      }
+    }
+
+    template <class RandomIt>
+    static void Sort(RandomIt first, RandomIt last)
+    {
+      Sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+    }
+
+    /// Queues f on the shared pool; TaskFuture::get() helps run queued work while it waits.
+    template <class F>
+    static TaskFuture<typename boost::result_of<F()>::type> Async(F f)
+    {
+      return WorkStealingThreadPool::instance().submit(f);
+    }
   private:
     static unsigned int maximumCoresSetByUser_;
     static unsigned int capByUserCoreCount(unsigned int numProcs);
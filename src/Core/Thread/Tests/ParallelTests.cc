@@ -31,6 +31,8 @@
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/Barrier.h>
+#include <boost/atomic.hpp>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -52,6 +54,151 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, RunTasksAllowsBarrierSynchronization)
+{
+  const int size = 4;
+  Barrier barrier("RunTasks test", size);
+  boost::atomic<int> beforeBarrier(0);
+  std::vector<int> seenAfterBarrier(size, 0);
+
+  for (int round = 0; round < 3; ++round)
+  {
+    beforeBarrier = 0;
+    Parallel::RunTasks([&](int i) { ++beforeBarrier; barrier.wait(); seenAfterBarrier[i] = beforeBarrier; }, size);
+    for (int i = 0; i < size; ++i)
+      EXPECT_EQ(size, seenAfterBarrier[i]);
+  }
+}
+
+TEST(ParallelTests, RunTasksPropagatesExceptions)
+{
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 1) throw std::runtime_error("task failed"); }, 2), std::runtime_error);
+}
+
+TEST(ParallelTests, PartitionCoversRangeExactly)
+{
+  auto chunks = Parallel::Partition(3, 103, 7);
+  ASSERT_EQ(15, chunks.size());
+  EXPECT_EQ(3, chunks.front().first);
+  EXPECT_EQ(103, chunks.back().second);
+  for (size_t c = 1; c < chunks.size(); ++c)
+    EXPECT_EQ(chunks[c - 1].second, chunks[c].first);
+
+  EXPECT_TRUE(Parallel::Partition(5, 5).empty());
+}
+
+TEST(ParallelTests, CanDoubleNumbersWithParallelFor)
+{
+  const size_t size = 100000;
+  std::vector<int> nums(size);
+  std::iota(nums.begin(), nums.end(), 0);
+
+  Parallel::For(0, size, [&](size_t begin, size_t end) { for (size_t i = begin; i < end; ++i) nums[i] *= 2; });
+
+  for (size_t i = 0; i < size; ++i)
+    ASSERT_EQ(2 * static_cast<int>(i), nums[i]);
+}
+
+TEST(ParallelTests, NestedParallelForCompletes)
+{
+  const size_t outer = 64, inner = 1000;
+  std::vector<long long> sums(outer, 0);
+
+  Parallel::For(0, outer, [&](size_t begin, size_t end)
+  {
+    for (size_t o = begin; o < end; ++o)
+    {
+      sums[o] = Parallel::Reduce(0, inner, 0LL,
+        [](size_t b, size_t e, long long init) { for (size_t i = b; i < e; ++i) init += i; return init; },
+        std::plus<long long>());
+    }
+  }, 1);
+
+  for (auto sum : sums)
+    EXPECT_EQ(static_cast<long long>(inner * (inner - 1) / 2), sum);
+}
+
+TEST(ParallelTests, ReduceIsDeterministic)
+{
+  std::vector<double> values(50000);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = 1.0 / (1 + i);
+
+  auto sum = [&]() { return Parallel::Reduce(0, values.size(), 0.0,
+    [&](size_t b, size_t e, double init) { for (size_t i = b; i < e; ++i) init += values[i]; return init; },
+    std::plus<double>(), 1000); };
+
+  const double first = sum();
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(first, sum());
+}
+
+TEST(ParallelTests, SortMatchesStdSort)
+{
+  for (size_t size : { 0, 1, 999, 100003 })
+  {
+    std::vector<int> values(size);
+    for (size_t i = 0; i < size; ++i)
+      values[i] = static_cast<int>((i * 7919) % 1009) - 500;
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    Parallel::Sort(values.begin(), values.end());
+    EXPECT_EQ(expected, values);
+
+    Parallel::Sort(values.begin(), values.end(), std::greater<int>(), 100);
+    std::reverse(expected.begin(), expected.end());
+    EXPECT_EQ(expected, values);
+  }
+}
+
+TEST(ParallelTests, ParallelForPropagatesExceptions)
+{
+  EXPECT_THROW(Parallel::For(0, 100, [](size_t b, size_t) { if (b > 50) throw std::logic_error("chunk failed"); }, 10), std::logic_error);
+}
+
+TEST(ParallelTests, AsyncReturnsFutureValue)
+{
+  auto answer = Parallel::Async([]() { return 42; });
+  auto nothing = Parallel::Async([]() {});
+  EXPECT_EQ(42, answer.get());
+  nothing.get();
+  EXPECT_TRUE(nothing.ready());
+
+  auto failure = Parallel::Async([]() -> int { throw std::runtime_error("async failed"); });
+  EXPECT_THROW(failure.get(), std::runtime_error);
+}
+
+TEST(ParallelTests, ParallelForRespectsMaximumCores)
+{
+  Parallel::SetMaximumCores(1);
+  EXPECT_EQ(1, WorkStealingThreadPool::instance().activeWorkerLimit());
+
+  const auto caller = boost::this_thread::get_id();
+  bool allOnCaller = true;
+  Parallel::For(0, 1000, [&](size_t, size_t) { allOnCaller = allOnCaller && boost::this_thread::get_id() == caller; }, 10);
+  EXPECT_TRUE(allOnCaller);
+
+  Parallel::SetMaximumCores(0);
+  EXPECT_EQ(Parallel::NumCores(), WorkStealingThreadPool::instance().activeWorkerLimit());
+}
+
+TEST(WorkStealingThreadPoolTests, WaitingWorkersHelpInsteadOfDeadlocking)
+{
+  WorkStealingThreadPool pool(1);
+  auto outer = pool.submit([&pool]()
+  {
+    std::vector<TaskFuture<int>> inner;
+    for (int i = 0; i < 10; ++i)
+      inner.push_back(pool.submit([i]() { return i; }));
+    int sum = 0;
+    for (const auto& f : inner)
+      sum += f.get();
+    return sum;
+  });
+  EXPECT_EQ(45, outer.get());
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
@@ -0,0 +1,307 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Core/Thread/ThreadPool.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/Log.h>
+#include <boost/thread/tss.hpp>
+#include <deque>
+
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Thread::PoolDetail;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  struct WorkerIdentity
+  {
+    WorkStealingThreadPool* pool;
+    int index;
+  };
+
+  boost::thread_specific_ptr<WorkerIdentity> currentWorker;
+}
+
+struct WorkStealingThreadPool::WorkQueue
+{
+  boost::mutex lock;
+  std::deque<Task> tasks;
+};
+
+TaskCompletion::TaskCompletion(WorkStealingThreadPool& pool, size_t outstanding) : pool_(pool), outstanding_(outstanding)
+{
+}
+
+void TaskCompletion::addOutstanding(size_t count)
+{
+  outstanding_ += count;
+}
+
+void TaskCompletion::finishOne()
+{
+  if (--outstanding_ == 0)
+    pool_.notifyCompletion();
+}
+
+void TaskCompletion::fail(std::exception_ptr error)
+{
+  boost::lock_guard<boost::mutex> lock(errorLock_);
+  if (!error_)
+    error_ = error;
+}
+
+bool TaskCompletion::ready() const
+{
+  return outstanding_ == 0;
+}
+
+void TaskCompletion::wait() const
+{
+  pool_.helpUntil(*this);
+}
+
+void TaskCompletion::rethrowIfFailed() const
+{
+  std::exception_ptr error;
+  {
+    boost::lock_guard<boost::mutex> lock(errorLock_);
+    error = error_;
+  }
+  if (error)
+    std::rethrow_exception(error);
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned int numWorkers) :
+  pending_(0), activeLimit_(numWorkers), stopping_(false)
+{
+  if (numWorkers == 0)
+    numWorkers = 1;
+  // one deque per worker plus a shared injection queue for submissions from outside the pool
+  for (unsigned int i = 0; i <= numWorkers; ++i)
+    queues_.push_back(boost::make_shared<WorkQueue>());
+  for (unsigned int i = 0; i < numWorkers; ++i)
+    workers_.push_back(boost::make_shared<boost::thread>([this, i]() { workerLoop(static_cast<int>(i)); }));
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  stopping_ = true;
+  {
+    boost::lock_guard<boost::mutex> lock(sleepLock_);
+    wakeup_.notify_all();
+  }
+  for (auto& worker : workers_)
+    worker->join();
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::instance()
+{
+  static WorkStealingThreadPool* pool = []()
+  {
+    auto p = new WorkStealingThreadPool(std::max(1u, boost::thread::hardware_concurrency()));
+    p->setActiveWorkerLimit(Parallel::NumCores());
+    return p;
+  }();
+  return *pool;
+}
+
+void WorkStealingThreadPool::setActiveWorkerLimit(unsigned int limit)
+{
+  activeLimit_ = limit;
+  boost::lock_guard<boost::mutex> lock(sleepLock_);
+  wakeup_.notify_all();
+}
+
+int WorkStealingThreadPool::currentWorkerIndex()
+{
+  auto id = currentWorker.get();
+  return id ? id->index : -1;
+}
+
+WorkStealingThreadPool* WorkStealingThreadPool::currentPool()
+{
+  auto id = currentWorker.get();
+  return id ? id->pool : nullptr;
+}
+
+void WorkStealingThreadPool::enqueue(const Task& task)
+{
+  enqueue(std::vector<Task>(1, task));
+}
+
+void WorkStealingThreadPool::enqueue(const std::vector<Task>& tasks)
+{
+  if (tasks.empty())
+    return;
+
+  const int index = currentPool() == this ? currentWorkerIndex() : static_cast<int>(workers_.size());
+  {
+    auto& queue = *queues_[index];
+    boost::lock_guard<boost::mutex> lock(queue.lock);
+    queue.tasks.insert(queue.tasks.end(), tasks.begin(), tasks.end());
+  }
+  pending_ += tasks.size();
+
+  boost::lock_guard<boost::mutex> lock(sleepLock_);
+  wakeup_.notify_all();
+}
+
+void WorkStealingThreadPool::notifyCompletion()
+{
+  boost::lock_guard<boost::mutex> lock(sleepLock_);
+  wakeup_.notify_all();
+}
+
+bool WorkStealingThreadPool::tryPop(int index, Task& task)
+{
+  if (pending_ == 0)
+    return false;
+
+  const int numWorkers = static_cast<int>(workers_.size());
+  if (index >= 0)
+  {
+    auto& own = *queues_[index];
+    boost::lock_guard<boost::mutex> lock(own.lock);
+    if (!own.tasks.empty())
+    {
+      task.swap(own.tasks.back());
+      own.tasks.pop_back();
+      --pending_;
+      return true;
+    }
+  }
+
+  // injection queue first, then steal the oldest task from the other workers
+  for (int k = 0; k <= numWorkers; ++k)
+  {
+    const int victim = k == 0 ? numWorkers : (std::max(index, 0) + k) % numWorkers;
+    if (victim == index)
+      continue;
+    auto& queue = *queues_[victim];
+    boost::lock_guard<boost::mutex> lock(queue.lock);
+    if (!queue.tasks.empty())
+    {
+      task.swap(queue.tasks.front());
+      queue.tasks.pop_front();
+      --pending_;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WorkStealingThreadPool::tryRunOne(int index)
+{
+  Task task;
+  if (!tryPop(index, task))
+    return false;
+
+  try
+  {
+    task();
+  }
+  catch (...)
+  {
+    logCritical("Uncaught exception in thread pool task");
+  }
+  return true;
+}
+
+void WorkStealingThreadPool::workerLoop(int index)
+{
+  currentWorker.reset(new WorkerIdentity { this, index });
+
+  while (!stopping_)
+  {
+    if (index < static_cast<int>(activeLimit_) && tryRunOne(index))
+      continue;
+
+    boost::unique_lock<boost::mutex> lock(sleepLock_);
+    wakeup_.wait(lock, [this, index]() { return stopping_ || (pending_ > 0 && index < static_cast<int>(activeLimit_)); });
+  }
+}
+
+void WorkStealingThreadPool::helpUntil(const TaskCompletion& completion)
+{
+  const int index = currentPool() == this ? currentWorkerIndex() : -1;
+
+  while (!completion.ready())
+  {
+    if (tryRunOne(index))
+      continue;
+
+    boost::unique_lock<boost::mutex> lock(sleepLock_);
+    wakeup_.wait(lock, [this, &completion]() { return completion.ready() || pending_ > 0; });
+  }
+}
+
+TaskGroup::TaskGroup(WorkStealingThreadPool& pool) : pool_(pool), completion_(boost::make_shared<TaskCompletion>(pool, 0))
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+  // queued tasks may reference the creator's stack, so never leave them behind
+  boost::this_thread::disable_interruption noInterrupts;
+  completion_->wait();
+}
+
+void TaskGroup::run(const WorkStealingThreadPool::Task& task)
+{
+  run(std::vector<WorkStealingThreadPool::Task>(1, task));
+}
+
+void TaskGroup::run(const std::vector<WorkStealingThreadPool::Task>& tasks)
+{
+  auto completion = completion_;
+  std::vector<WorkStealingThreadPool::Task> wrapped;
+  wrapped.reserve(tasks.size());
+  for (const auto& task : tasks)
+  {
+    wrapped.push_back([completion, task]()
+    {
+      try
+      {
+        task();
+      }
+      catch (...)
+      {
+        completion->fail(std::current_exception());
+      }
+      completion->finishOne();
+    });
+  }
+  completion_->addOutstanding(wrapped.size());
+  pool_.enqueue(wrapped);
+}
+
+void TaskGroup::wait()
+{
+  completion_->wait();
+  completion_->rethrowIfFailed();
+}
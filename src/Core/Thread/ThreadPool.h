@@ -0,0 +1,208 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CORE_THREAD_THREADPOOL_H
+#define CORE_THREAD_THREADPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/utility/result_of.hpp>
+#include <exception>
+#include <vector>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  class WorkStealingThreadPool;
+
+  namespace PoolDetail
+  {
+    /// Completion state shared between a submitted task and whoever waits on it.
+    /// Counts outstanding work items so the same type serves single futures and task groups.
+    class SCISHARE TaskCompletion : boost::noncopyable
+    {
+    public:
+      TaskCompletion(WorkStealingThreadPool& pool, size_t outstanding);
+      virtual ~TaskCompletion() {}
+      void addOutstanding(size_t count);
+      void finishOne();
+      void fail(std::exception_ptr error);
+      bool ready() const;
+      /// Blocks until complete. Pool workers and pool-aware callers execute queued tasks while waiting,
+      /// so waiting inside a task never deadlocks the pool.
+      void wait() const;
+      void rethrowIfFailed() const;
+    private:
+      WorkStealingThreadPool& pool_;
+      boost::atomic<size_t> outstanding_;
+      mutable boost::mutex errorLock_;
+      std::exception_ptr error_;
+    };
+
+    template <typename T>
+    class FutureState : public TaskCompletion
+    {
+    public:
+      explicit FutureState(WorkStealingThreadPool& pool) : TaskCompletion(pool, 1) {}
+      template <class F>
+      void run(F& f) { value_ = f(); }
+      T value() const { return *value_; }
+    private:
+      boost::optional<T> value_;
+    };
+
+    template <>
+    class FutureState<void> : public TaskCompletion
+    {
+    public:
+      explicit FutureState(WorkStealingThreadPool& pool) : TaskCompletion(pool, 1) {}
+      template <class F>
+      void run(F& f) { f(); }
+      void value() const {}
+    };
+  }
+
+  /// Handle to the result of a task submitted to the WorkStealingThreadPool.
+  template <typename T>
+  class TaskFuture
+  {
+  public:
+    TaskFuture() {}
+    explicit TaskFuture(boost::shared_ptr<PoolDetail::FutureState<T>> state) : state_(state) {}
+    bool valid() const { return state_ != nullptr; }
+    bool ready() const { return state_ && state_->ready(); }
+    void wait() const { state_->wait(); }
+    /// Waits for the task, then returns its value or rethrows the exception it threw.
+    T get() const
+    {
+      state_->wait();
+      state_->rethrowIfFailed();
+      return state_->value();
+    }
+  private:
+    boost::shared_ptr<PoolDetail::FutureState<T>> state_;
+  };
+
+  /// Process-wide pool of worker threads, each owning a deque of tasks. Workers pop their own
+  /// deque LIFO and steal FIFO from the others when idle. Tasks submitted from a worker
+  /// (nested parallelism) go onto that worker's deque, so nesting never creates threads.
+  ///
+  /// Tasks run here must not block on each other except through TaskFuture/TaskGroup waits:
+  /// use Parallel::RunTasks for barrier-synchronized code that needs all tasks live at once.
+  class SCISHARE WorkStealingThreadPool : boost::noncopyable
+  {
+  public:
+    typedef boost::function<void()> Task;
+
+    explicit WorkStealingThreadPool(unsigned int numWorkers);
+    ~WorkStealingThreadPool();
+
+    /// Shared instance, sized to the hardware. Intentionally never destroyed, so detached
+    /// tasks cannot outlive it during static destruction.
+    static WorkStealingThreadPool& instance();
+
+    unsigned int size() const { return static_cast<unsigned int>(workers_.size()); }
+    /// Limits how many workers take tasks; the others park. Callers waiting on work always help,
+    /// so a limit of zero degrades to serial execution on the calling thread.
+    void setActiveWorkerLimit(unsigned int limit);
+    unsigned int activeWorkerLimit() const { return activeLimit_; }
+
+    template <class F>
+    TaskFuture<typename boost::result_of<F()>::type> submit(F f)
+    {
+      typedef typename boost::result_of<F()>::type Result;
+      auto state = boost::make_shared<PoolDetail::FutureState<Result>>(*this);
+      enqueue([state, f]() mutable
+      {
+        try
+        {
+          state->run(f);
+        }
+        catch (...)
+        {
+          state->fail(std::current_exception());
+        }
+        state->finishOne();
+      });
+      return TaskFuture<Result>(state);
+    }
+
+    void enqueue(const Task& task);
+    void enqueue(const std::vector<Task>& tasks);
+
+    /// Runs queued tasks on the calling thread until the completion is ready.
+    void helpUntil(const PoolDetail::TaskCompletion& completion);
+    /// Wakes threads parked in helpUntil; called when a completion becomes ready.
+    void notifyCompletion();
+
+    /// Index of the calling worker in its pool, or -1 when called from outside any pool.
+    static int currentWorkerIndex();
+    static WorkStealingThreadPool* currentPool();
+  private:
+    struct WorkQueue;
+    void workerLoop(int index);
+    bool tryRunOne(int index);
+    bool tryPop(int index, Task& task);
+
+    std::vector<boost::shared_ptr<WorkQueue>> queues_;
+    std::vector<boost::shared_ptr<boost::thread>> workers_;
+    boost::atomic<size_t> pending_;
+    boost::atomic<unsigned int> activeLimit_;
+    boost::atomic<bool> stopping_;
+    boost::mutex sleepLock_;
+    boost::condition_variable wakeup_;
+  };
+
+  /// Tracks a batch of tasks enqueued together; wait() helps run them and rethrows the first failure.
+  class SCISHARE TaskGroup : boost::noncopyable
+  {
+  public:
+    explicit TaskGroup(WorkStealingThreadPool& pool = WorkStealingThreadPool::instance());
+    ~TaskGroup();
+    void run(const WorkStealingThreadPool::Task& task);
+    void run(const std::vector<WorkStealingThreadPool::Task>& tasks);
+    void wait();
+  private:
+    WorkStealingThreadPool& pool_;
+    boost::shared_ptr<PoolDetail::TaskCompletion> completion_;
+  };
+
+}}}
+
+#endif
@@ -105,7 +105,7 @@ namespace
 
   private:
     DenseMatrixHandle underlying_;
-    boost::python::list pyMat_;
+    boost::python::object pyMat_;
   };
 
   class PyDatatypeSparseRowMatrix : public PyDatatype
@@ -127,7 +127,7 @@ namespace
 
   private:
     SparseRowMatrixHandle underlying_;
-    boost::python::list pyMat_;
+    boost::python::object pyMat_;
   };
 
   class PyDatatypeField : public PyDatatype
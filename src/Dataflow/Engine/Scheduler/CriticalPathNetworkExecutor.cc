@@ -0,0 +1,177 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Dataflow/Engine/Scheduler/CriticalPathNetworkExecutor.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/thread/thread.hpp>
+#include <queue>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  class CriticalPathDispatch
+  {
+  public:
+    CriticalPathDispatch(const CriticalPathExecutionOrder& order, const ExecutableLookup* lookup, size_t numThreads) :
+      order_(order), lookup_(lookup), remainingInputs_(order.size()), finished_(0)
+    {
+      for (size_t i = 0; i < order_.size(); ++i)
+      {
+        remainingInputs_[i] = order_.node(i).predecessorCount;
+        if (remainingInputs_[i] == 0)
+          pushReady(i);
+      }
+
+      boost::lock_guard<boost::mutex> lock(lock_);
+      for (size_t t = 0; t < std::min(numThreads, order_.size()); ++t)
+        threads_.push_back(workers_.create_thread([this, t]() { run(t); }));
+    }
+
+    void join()
+    {
+      workers_.join_all();
+    }
+
+    void interruptModule(const std::string& id)
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      auto it = running_.find(id);
+      if (it != running_.end())
+        threads_[it->second]->interrupt();
+    }
+  private:
+    typedef std::pair<double, size_t> PrioritizedModule;
+
+    void pushReady(size_t i)
+    {
+      ready_.push(PrioritizedModule(order_.node(i).priority, i));
+    }
+
+    void run(size_t thread)
+    {
+      while (true)
+      {
+        size_t next;
+        {
+          boost::unique_lock<boost::mutex> lock(lock_);
+          moduleReady_.wait(lock, [this]() { return !ready_.empty() || finished_ == order_.size(); });
+          if (ready_.empty())
+            return;
+          next = ready_.top().second;
+          ready_.pop();
+          running_[order_.node(next).id.id_] = thread;
+        }
+
+        const auto& id = order_.node(next).id;
+        auto exec = lookup_->lookupExecutable(id);
+        {
+          boost::signals2::scoped_connection timing(exec->connectExecuteEnds(
+            [](double seconds, const ModuleId& finished) { ModuleExecutionTimeHistory::Instance().record(finished, seconds); }));
+          exec->executeWithSignals();
+        }
+
+        boost::lock_guard<boost::mutex> lock(lock_);
+        running_.erase(id.id_);
+        // an interrupt that raced with the module finishing must not hit the next module on this thread
+        try
+        {
+          boost::this_thread::interruption_point();
+        }
+        catch (boost::thread_interrupted&)
+        {
+        }
+        ++finished_;
+        for (auto s : order_.node(next).successors)
+        {
+          if (--remainingInputs_[s] == 0)
+            pushReady(s);
+        }
+        moduleReady_.notify_all();
+      }
+    }
+
+    const CriticalPathExecutionOrder& order_;
+    const ExecutableLookup* lookup_;
+    std::vector<size_t> remainingInputs_;
+    std::priority_queue<PrioritizedModule> ready_;
+    std::map<std::string, size_t> running_;
+    size_t finished_;
+    boost::mutex lock_;
+    boost::condition_variable moduleReady_;
+    boost::thread_group workers_;
+    std::vector<boost::thread*> threads_;
+  };
+
+  class CriticalPathExecution : public WaitsForStartupInitialization
+  {
+  public:
+    CriticalPathExecution(const ExecutionContext& context, const NetworkInterface* network, const CriticalPathExecutionOrder& order,
+      Mutex* executionLock, size_t numThreads) :
+      lookup_(&context.lookup), bounds_(&context.bounds()), network_(network), order_(order),
+      executionLock_(executionLock), numThreads_(numThreads)
+    {
+    }
+
+    void operator()() const
+    {
+      Guard g(executionLock_->get());
+      ScopedExecutionBoundsSignaller signaller(bounds_, [=]() { return lookup_->errorCode(); });
+
+      waitForStartupInit(*lookup_);
+
+      CriticalPathDispatch dispatch(order_, lookup_, numThreads_);
+      boost::signals2::scoped_connection interrupts(network_->connectModuleInterrupted([&](const std::string& id) { dispatch.interruptModule(id); }));
+      dispatch.join();
+    }
+  private:
+    const ExecutableLookup* lookup_;
+    const ExecutionBounds* bounds_;
+    const NetworkInterface* network_;
+    CriticalPathExecutionOrder order_;
+    Mutex* executionLock_;
+    size_t numThreads_;
+  };
+}
+
+CriticalPathNetworkExecutor::CriticalPathNetworkExecutor(const NetworkInterface& network, size_t numThreads) :
+  network_(network), numThreads_(numThreads > 0 ? numThreads : std::max(2u, Parallel::NumCores()))
+{
+}
+
+void CriticalPathNetworkExecutor::execute(const ExecutionContext& context, CriticalPathExecutionOrder order, Mutex& executionLock)
+{
+  LOG_TRACE("CriticalPathNetworkExecutor order received: {}", order.size());
+
+  CriticalPathExecution runner(context, &network_, order, &executionLock, numThreads_);
+  boost::thread execution(runner);
+}
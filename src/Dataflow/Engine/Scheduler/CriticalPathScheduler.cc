@@ -0,0 +1,114 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Dataflow/Engine/Scheduler/CriticalPathScheduler.h>
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Network/NetworkInterface.h>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Engine::NetworkGraph;
+using namespace SCIRun::Dataflow::Networks;
+
+ModuleExecutionTimeHistory& ModuleExecutionTimeHistory::Instance()
+{
+  static ModuleExecutionTimeHistory instance_;
+  return instance_;
+}
+
+void ModuleExecutionTimeHistory::record(const ModuleId& id, double seconds)
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  auto it = seconds_.find(id.id_);
+  if (it == seconds_.end())
+    seconds_[id.id_] = seconds;
+  else
+    it->second = 0.5 * (it->second + seconds);
+}
+
+double ModuleExecutionTimeHistory::estimate(const ModuleId& id) const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  auto it = seconds_.find(id.id_);
+  if (it != seconds_.end())
+    return it->second;
+  if (seconds_.empty())
+    return 1.0;
+
+  double total = 0;
+  for (const auto& entry : seconds_)
+    total += entry.second;
+  return total / seconds_.size();
+}
+
+void ModuleExecutionTimeHistory::clear()
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  seconds_.clear();
+}
+
+CriticalPathScheduler::CriticalPathScheduler(const ModuleFilter& filter, const ModuleExecutionTimeHistory& history) :
+  filter_(filter), history_(history)
+{
+}
+
+CriticalPathExecutionOrder CriticalPathScheduler::schedule(const NetworkInterface& network) const
+{
+  NetworkGraphAnalyzer graphAnalyzer(network, filter_, true);
+  const DirectedGraph& g = graphAnalyzer.graph();
+
+  std::vector<CriticalPathExecutionOrder::Node> nodes(graphAnalyzer.moduleCount());
+  for (int v = 0; v < graphAnalyzer.moduleCount(); ++v)
+  {
+    auto& node = nodes[v];
+    node.id = graphAnalyzer.moduleAt(v);
+    node.predecessorCount = in_degree(v, g);
+    DirectedGraph::out_edge_iterator e, e_end;
+    for (boost::tie(e, e_end) = out_edges(v, g); e != e_end; ++e)
+      node.successors.push_back(target(*e, g));
+  }
+
+  // Walk the topological order backwards so every successor's path length is known.
+  std::vector<Vertex> order(graphAnalyzer.topologicalBegin(), graphAnalyzer.topologicalEnd());
+  for (auto i = order.rbegin(); i != order.rend(); ++i)
+  {
+    auto& node = nodes[*i];
+    double longestDownstream = 0;
+    for (auto s : node.successors)
+      longestDownstream = std::max(longestDownstream, nodes[s].priority);
+    node.priority = history_.estimate(node.id) + longestDownstream;
+  }
+
+  return CriticalPathExecutionOrder(nodes);
+}
+
+std::ostream& SCIRun::Dataflow::Engine::operator<<(std::ostream& out, const CriticalPathExecutionOrder& order)
+{
+  for (const auto& node : order.nodes())
+    out << node.priority << " " << node.id << std::endl;
+  return out;
+}
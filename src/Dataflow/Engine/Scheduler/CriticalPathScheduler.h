@@ -0,0 +1,94 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ENGINE_SCHEDULER_CRITICAL_PATH_SCHEDULER_H
+#define ENGINE_SCHEDULER_CRITICAL_PATH_SCHEDULER_H
+
+#include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <boost/thread/mutex.hpp>
+#include <vector>
+#include <map>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Smoothed wall time of each module's past executions, used to weight scheduling priorities.
+  class SCISHARE ModuleExecutionTimeHistory : boost::noncopyable
+  {
+  public:
+    static ModuleExecutionTimeHistory& Instance();
+    void record(const Networks::ModuleId& id, double seconds);
+    /// Falls back to the mean of all recorded modules, or 1 second with no history at all.
+    double estimate(const Networks::ModuleId& id) const;
+    void clear();
+  private:
+    mutable boost::mutex lock_;
+    std::map<std::string, double> seconds_;
+  };
+
+  /// Dependency graph of the modules to execute, each tagged with the weighted length of the
+  /// longest path from it to a sink. Modules with larger priority sit on the critical path.
+  class SCISHARE CriticalPathExecutionOrder
+  {
+  public:
+    struct Node
+    {
+      Networks::ModuleId id;
+      double priority;
+      size_t predecessorCount;
+      std::vector<size_t> successors;
+    };
+
+    CriticalPathExecutionOrder() {}
+    explicit CriticalPathExecutionOrder(const std::vector<Node>& nodes) : nodes_(nodes) {}
+    size_t size() const { return nodes_.size(); }
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const Node& node(size_t i) const { return nodes_[i]; }
+  private:
+    std::vector<Node> nodes_;
+  };
+
+  SCISHARE std::ostream& operator<<(std::ostream& out, const CriticalPathExecutionOrder& order);
+
+  class SCISHARE CriticalPathScheduler : public Scheduler<CriticalPathExecutionOrder>
+  {
+  public:
+    explicit CriticalPathScheduler(const Networks::ModuleFilter& filter,
+      const ModuleExecutionTimeHistory& history = ModuleExecutionTimeHistory::Instance());
+    virtual CriticalPathExecutionOrder schedule(const Networks::NetworkInterface& network) const override;
+  private:
+    Networks::ModuleFilter filter_;
+    const ModuleExecutionTimeHistory& history_;
+  };
+
+}}}
+
+#endif
@@ -30,8 +30,12 @@
 #define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKQUEUE_H
 
 #include <Dataflow/Network/NetworkFwd.h>
-#include <boost/next_prior.hpp>
-#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
 #include <Dataflow/Engine/Scheduler/share.h>
 
 namespace SCIRun {
@@ -39,11 +43,78 @@ namespace Dataflow {
 namespace Engine {
   namespace DynamicExecutor {
 
+    /// Multi-producer queue whose consumer spins briefly and then parks, so an idle scheduler
+    /// costs no CPU while modules run. close() releases consumers once the queue drains.
+    template <class Unit>
+    class BlockingWorkQueue : boost::noncopyable
+    {
+    public:
+      explicit BlockingWorkQueue(size_t spinCount = 200) : spinCount_(spinCount), size_(0), closed_(false) {}
+
+      void push(const Unit& unit)
+      {
+        {
+          boost::lock_guard<boost::mutex> lock(lock_);
+          units_.push_back(unit);
+          ++size_;
+        }
+        available_.notify_one();
+      }
+
+      bool tryPop(Unit& unit)
+      {
+        if (size_ == 0)
+          return false;
+        boost::lock_guard<boost::mutex> lock(lock_);
+        return popLocked(unit);
+      }
+
+      /// Returns false once the queue is closed and empty.
+      bool waitAndPop(Unit& unit)
+      {
+        for (size_t spin = 0; spin < spinCount_ && size_ == 0 && !closed_; ++spin)
+          boost::this_thread::yield();
+
+        boost::unique_lock<boost::mutex> lock(lock_);
+        available_.wait(lock, [this]() { return !units_.empty() || closed_; });
+        return popLocked(unit);
+      }
+
+      void close()
+      {
+        {
+          boost::lock_guard<boost::mutex> lock(lock_);
+          closed_ = true;
+        }
+        available_.notify_all();
+      }
+
+      bool closed() const { return closed_; }
+      bool empty() const { return size_ == 0; }
+    private:
+      bool popLocked(Unit& unit)
+      {
+        if (units_.empty())
+          return false;
+        unit = units_.front();
+        units_.pop_front();
+        --size_;
+        return true;
+      }
+
+      const size_t spinCount_;
+      boost::mutex lock_;
+      boost::condition_variable available_;
+      std::deque<Unit> units_;
+      boost::atomic<size_t> size_;
+      boost::atomic<bool> closed_;
+    };
+
     template <class Unit>
     class WorkQueue
     {
     public:
-      typedef boost::lockfree::spsc_queue<Unit> Impl;
+      typedef BlockingWorkQueue<Unit> Impl;
     };
 
     typedef WorkQueue<Networks::ModuleHandle>::Impl ModuleWorkQueue;
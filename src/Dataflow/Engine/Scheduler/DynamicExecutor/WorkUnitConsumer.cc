@@ -0,0 +1,167 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitConsumer.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Core::Thread;
+
+ExecutionThreadGroup::ExecutionThreadGroup(size_t numThreads) : nextThread_(0), outstanding_(0), stopping_(false)
+{
+  if (numThreads == 0)
+    numThreads = std::max(2u, Parallel::NumCores());
+
+  queues_.resize(numThreads);
+  for (size_t i = 0; i < numThreads; ++i)
+    threads_.push_back(boost::make_shared<boost::thread>([this, i]() { run(i); }));
+}
+
+ExecutionThreadGroup::~ExecutionThreadGroup()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+  for (auto& thread : threads_)
+    thread->join();
+}
+
+void ExecutionThreadGroup::startExecution(const ModuleExecutor& executor)
+{
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    const auto& id = executor.module_->get_id().id_;
+    auto known = affinity_.find(id);
+    size_t index;
+    if (known != affinity_.end())
+    {
+      index = known->second;
+    }
+    else
+    {
+      index = nextThread_++ % queues_.size();
+      affinity_[id] = index;
+    }
+    queues_[index].push_back(executor);
+    ++outstanding_;
+  }
+  workAvailable_.notify_all();
+}
+
+void ExecutionThreadGroup::joinAll()
+{
+  boost::unique_lock<boost::mutex> lock(lock_);
+  allFinished_.wait(lock, [this]() { return outstanding_ == 0; });
+}
+
+void ExecutionThreadGroup::clear()
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  affinity_.clear();
+  nextThread_ = 0;
+}
+
+bool ExecutionThreadGroup::interruptModule(const std::string& moduleId)
+{
+  // the worker only leaves runningByModuleId_ under lock_, so the module is still on that thread here
+  boost::lock_guard<boost::mutex> lock(lock_);
+  auto it = runningByModuleId_.find(moduleId);
+  if (it == runningByModuleId_.end())
+    return false;
+  threads_[it->second]->interrupt();
+  return true;
+}
+
+bool ExecutionThreadGroup::takeLocked(size_t index, boost::optional<ModuleExecutor>& executor)
+{
+  // own queue first, then steal the newest entry of the busiest-looking neighbor
+  for (size_t k = 0; k < queues_.size(); ++k)
+  {
+    auto& queue = queues_[(index + k) % queues_.size()];
+    if (!queue.empty())
+    {
+      if (k == 0)
+      {
+        executor = queue.front();
+        queue.pop_front();
+      }
+      else
+      {
+        executor = queue.back();
+        queue.pop_back();
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void ExecutionThreadGroup::run(size_t index)
+{
+  while (true)
+  {
+    boost::optional<ModuleExecutor> executor;
+    std::string moduleId;
+    {
+      boost::unique_lock<boost::mutex> lock(lock_);
+      // an idle worker must never die to an interrupt meant for a module
+      boost::this_thread::disable_interruption idle;
+      workAvailable_.wait(lock, [&]() { return stopping_ || takeLocked(index, executor); });
+      if (!executor)
+        return;
+      moduleId = executor->module_->get_id().id_;
+      runningByModuleId_[moduleId] = index;
+    }
+
+    try
+    {
+      executor->run();
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      runningByModuleId_.erase(moduleId);
+      // a module interrupted right as it finished must not leave the flag set for the next one
+      try
+      {
+        boost::this_thread::interruption_point();
+      }
+      catch (boost::thread_interrupted&)
+      {
+      }
+      if (--outstanding_ == 0)
+        allFinished_.notify_all();
+    }
+  }
+}
@@ -36,6 +36,9 @@
 #include <Core/Logging/Log.h>
 #include <Core/Thread/Mutex.h>
 #include <boost/thread/thread.hpp>
+#include <boost/optional.hpp>
+#include <deque>
+#include <map>
 
 #include <Dataflow/Engine/Scheduler/share.h>
 
@@ -44,50 +47,38 @@ namespace Dataflow {
 namespace Engine {
 namespace DynamicExecutor {
 
+  /// Fixed set of executor threads that run module executions. A module is queued on the thread
+  /// that last ran it, and idle threads steal from busy ones, so the thread count stays bounded
+  /// no matter how many modules the network has.
   class SCISHARE ExecutionThreadGroup : boost::noncopyable
   {
   public:
-    ExecutionThreadGroup()
-    {
-      clear();
-    }
-    void startExecution(const ModuleExecutor& executor)
-    {
-      auto thread = executeThreads_->create_thread(boost::bind(&ModuleExecutor::run, executor));
-      Core::Thread::Guard g(mapLock_->get());
-      threadsByModuleId_[executor.module_->get_id().id_] = thread;
-    }
-    void joinAll()
-    {
-      executeThreads_->join_all();
-    }
-    void clear()
-    {
-      executeThreads_.reset(new boost::thread_group);
-      threadsByModuleId_.clear();
-      std::ostringstream lockName;
-      lockName << "threadMap " << this;
-      mapLock_.reset(new Core::Thread::Mutex(lockName.str()));
-    }
-    boost::thread* getThreadForModule(const std::string& moduleId) const
-    {
-      if (!mapLock_)
-      {
-        return nullptr;
-      }
-      Core::Thread::Guard g(mapLock_->get());
-
-      auto it = threadsByModuleId_.find(moduleId);
-      if (it == threadsByModuleId_.end())
-        return nullptr;
-      if (!executeThreads_->is_thread_in(it->second))
-        return nullptr;
-      return it->second;
-    }
+    /// numThreads == 0 sizes the group from Parallel::NumCores().
+    explicit ExecutionThreadGroup(size_t numThreads = 0);
+    ~ExecutionThreadGroup();
+    void startExecution(const ModuleExecutor& executor);
+    /// Waits until every started execution has finished; the threads stay alive for reuse.
+    void joinAll();
+    /// Forgets module affinities; executions still in flight are unaffected.
+    void clear();
+    /// Interrupts the thread executing the module. Does nothing, and returns false, once the
+    /// module has finished, so a late request never reaches a thread running something else.
+    bool interruptModule(const std::string& moduleId);
+    size_t size() const { return threads_.size(); }
   private:
-    mutable boost::shared_ptr<boost::thread_group> executeThreads_;
-    std::map<std::string, boost::thread*> threadsByModuleId_;
-    mutable boost::shared_ptr<Core::Thread::Mutex> mapLock_;
+    void run(size_t index);
+    bool takeLocked(size_t index, boost::optional<ModuleExecutor>& executor);
+
+    std::vector<boost::shared_ptr<boost::thread>> threads_;
+    std::vector<std::deque<ModuleExecutor>> queues_;
+    std::map<std::string, size_t> affinity_;
+    std::map<std::string, size_t> runningByModuleId_;
+    size_t nextThread_;
+    size_t outstanding_;
+    bool stopping_;
+    mutable boost::mutex lock_;
+    boost::condition_variable workAvailable_;
+    boost::condition_variable allFinished_;
   };
 
   typedef boost::shared_ptr<ExecutionThreadGroup> ExecutionThreadGroupPtr;
@@ -114,30 +105,23 @@ namespace DynamicExecutor {
 
       //log_->trace_if(shouldLog_, "Consumer started.");
 
-      while (!producer_->isDone() || moreWork())
+      Networks::ModuleHandle unit;
+      while (work_->waitAndPop(unit))
       {
-        if (moreWork())
-        {
-          //log_->trace_if(shouldLog_, "\tConsumer thinks work queue is not empty.");
-          //log_->trace_if(shouldLog_, "\tConsumer accessing front of work queue.");
-
-          Networks::ModuleHandle unit;
-          work_->pop(unit);
+        //log_->trace_if(shouldLog_, "\tConsumer popping front of work queue.");
 
-          //log_->trace_if(shouldLog_, "\tConsumer popping front of work queue.");
-
-          if (unit)
-          {
-            //log_->trace_if(shouldLog_, "~~~Processing {}", unit->get_id());
+        if (unit)
+        {
+          //log_->trace_if(shouldLog_, "~~~Processing {}", unit->get_id());
 
-            ModuleExecutor executor(unit, lookup_, producer_);
-            executeThreadGroup_->startExecution(executor);
-          }
-          else
-          {
-            //log_->trace_if(shouldLog_, "\tConsumer received null module");
-          }
+          ModuleExecutor executor(unit, lookup_, producer_);
+          executeThreadGroup_->startExecution(executor);
+        }
+        else
+        {
+          //log_->trace_if(shouldLog_, "\tConsumer received null module");
         }
+        unit.reset();
       }
      // log_->trace_if(shouldLog_, "Consumer done.");
     }
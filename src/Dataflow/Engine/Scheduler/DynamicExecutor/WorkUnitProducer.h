@@ -98,7 +98,10 @@ namespace SCIRun {
                   }
                 }
               }
+              if (isDone())
+                work_->close();
             }
+            statusChanged_.notify_all();
           }
 
           void operator()() const
@@ -109,14 +112,17 @@ namespace SCIRun {
 
             enqueueReadyModules();
 
-            while (!badGroup_ && !isDone())
             {
-              boost::this_thread::sleep(boost::posix_time::milliseconds(100));
-              //std::cout << "producer thread waiting " << id_ << std::endl;
+              boost::unique_lock<boost::mutex> lock(enqueueLock_->get());
+              statusChanged_.wait(lock, [this]() { return badGroup_ || isDone(); });
             }
 
             if (badGroup_)
+            {
               std::cerr << "producer is done with bad group, something went wrong. probably a race condition..." << std::endl;
+              // Nothing more will be pushed, so release the consumer waiting on the queue.
+              work_->close();
+            }
 
             //log_->trace_if(shouldLog_, "Producer is done. {}", id_);
           }
@@ -137,6 +143,7 @@ namespace SCIRun {
           bool shouldLog_;
           size_t numModules_;
           mutable boost::thread::id id_;
+          mutable boost::condition_variable statusChanged_;
         };
 
         typedef boost::shared_ptr<ModuleProducer> ModuleProducerPtr;
@@ -57,7 +57,7 @@ namespace SCIRun {
           executeThreads_(threadGroup),
           lookup_(&context.lookup),
           bounds_(&context.bounds()),
-          work_(new DynamicExecutor::ModuleWorkQueue(numModules)),
+          work_(new DynamicExecutor::ModuleWorkQueue),
           producer_(new DynamicExecutor::ModuleProducer(context.addAdditionalFilter(ModuleWaitingFilter::Instance()),
             network, lock, work_, numModules)),
             consumer_(new DynamicExecutor::ModuleConsumer(work_, lookup_, producer_, executeThreads_)),
@@ -92,13 +92,7 @@ namespace SCIRun {
         void interruptModule(const std::string& id) const
         {
           if (executeThreads_)
-          {
-            auto thread = executeThreads_->getThreadForModule(id);
-            if (thread)
-            {
-              thread->interrupt();
-            }
-          }
+            executeThreads_->interruptModule(id);
         }
       private:
         mutable DynamicExecutor::ExecutionThreadGroupPtr executeThreads_;
@@ -126,7 +120,6 @@ void DynamicMultithreadedNetworkExecutor::execute(const ExecutionContext& contex
   //if (Log::get().verbose())
     LOG_TRACE("DMTNE::executeAll order received: {}", order);
 
-  threadGroup_->clear();
   DynamicMultithreadedNetworkExecutorImpl runner(context, &network_, &lock, order.size(), &executionLock, threadGroup_);
   boost::thread execution(runner);
 }
@@ -0,0 +1,163 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkQueue.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitConsumer.h>
+#include <Dataflow/Network/Tests/MockModule.h>
+#include <boost/thread/thread.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::Invoke;
+using ::testing::_;
+
+TEST(BlockingWorkQueueTests, PopsInFifoOrder)
+{
+  BlockingWorkQueue<int> queue;
+  queue.push(1);
+  queue.push(2);
+  int unit = 0;
+  EXPECT_TRUE(queue.tryPop(unit));
+  EXPECT_EQ(1, unit);
+  EXPECT_TRUE(queue.waitAndPop(unit));
+  EXPECT_EQ(2, unit);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.tryPop(unit));
+}
+
+TEST(BlockingWorkQueueTests, ConsumerDrainsQueueAfterClose)
+{
+  BlockingWorkQueue<int> queue;
+  std::vector<int> consumed;
+  boost::thread consumer([&]()
+  {
+    int unit;
+    while (queue.waitAndPop(unit))
+      consumed.push_back(unit);
+  });
+
+  for (int i = 0; i < 100; ++i)
+    queue.push(i);
+  queue.close();
+  consumer.join();
+
+  ASSERT_EQ(100, consumed.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, consumed[i]);
+}
+
+TEST(BlockingWorkQueueTests, CloseReleasesParkedConsumer)
+{
+  BlockingWorkQueue<int> queue(0);
+  bool popped = true;
+  boost::thread consumer([&]() { int unit; popped = queue.waitAndPop(unit); });
+  boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+  queue.close();
+  consumer.join();
+  EXPECT_FALSE(popped);
+  EXPECT_TRUE(queue.closed());
+}
+
+namespace
+{
+  class SingleModuleLookup : public ExecutableLookup
+  {
+  public:
+    explicit SingleModuleLookup(ModuleHandle module) : module_(module) {}
+    ExecutableObject* lookupExecutable(const ModuleId&) const override { return module_.get(); }
+    bool containsViewScene() const override { return false; }
+    int errorCode() const override { return 0; }
+  private:
+    ModuleHandle module_;
+  };
+
+  class NullProducer : public ProducerInterface
+  {
+  public:
+    bool isDone() const override { return true; }
+    void enqueueReadyModules() const override {}
+  };
+}
+
+TEST(ExecutionThreadGroupTests, InterruptArrivingAsModuleFinishesDoesNotKillTheWorker)
+{
+  std::atomic<int> completed(0);
+  auto module = boost::make_shared<NiceMock<MockModule>>();
+  ON_CALL(*module, get_id()).WillByDefault(Return(ModuleId("Mod:1")));
+  ON_CALL(*module, connectExecuteEnds(_)).WillByDefault(Return(boost::signals2::connection()));
+  ON_CALL(*module, executeWithSignals()).WillByDefault(Invoke([&]()
+  {
+    boost::this_thread::interruption_point();
+    ++completed;
+    return true;
+  }));
+  SingleModuleLookup lookup(module);
+  ModuleExecutor executor(module, &lookup, boost::make_shared<NullProducer>());
+
+  std::unique_ptr<ExecutionThreadGroup> group(new ExecutionThreadGroup(1));
+  std::atomic<bool> hammering(true);
+  boost::thread interrupter([&]()
+  {
+    while (hammering)
+      group->interruptModule("Mod:1");
+  });
+
+  boost::thread executions([&]()
+  {
+    for (int i = 0; i < 20000; ++i)
+    {
+      group->startExecution(executor);
+      group->joinAll();
+    }
+    hammering = false;
+    completed = 0;
+    group->startExecution(executor);
+    group->joinAll();
+  });
+
+  bool finished = executions.timed_join(boost::posix_time::seconds(30));
+  hammering = false;
+  interrupter.join();
+  if (!finished)
+  {
+    // the only worker died; leak the group rather than hang joining it
+    executions.detach();
+    group.release();
+    ::testing::Mock::AllowLeak(module.get());
+    FAIL() << "executions stopped completing after a late interrupt";
+  }
+  EXPECT_EQ(1, completed);
+  EXPECT_FALSE(group->interruptModule("Mod:1"));
+}
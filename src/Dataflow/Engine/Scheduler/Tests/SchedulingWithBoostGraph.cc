@@ -47,6 +47,8 @@
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathScheduler.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathExecutionStrategy.h>
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
@@ -298,6 +300,65 @@ TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorMultiThreaded)
   EXPECT_EQ(186, reportOutput.get<5>());
 }
 
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorCriticalPath)
+{
+  setupBasicNetwork();
+
+  CriticalPathExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, matrixMathNetwork);
+  Mutex m("exec");
+  strategy.execute(context, m);
+
+  /// @todo: let executor thread finish.  should be an event generated or something.
+  boost::this_thread::sleep(boost::posix_time::milliseconds(800));
+
+  ReportMatrixInfoAlgorithm::Outputs reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(3, reportOutput.get<1>());
+  EXPECT_EQ(3, reportOutput.get<2>());
+  EXPECT_EQ(9, reportOutput.get<3>());
+  EXPECT_EQ(22, reportOutput.get<4>());
+  EXPECT_EQ(186, reportOutput.get<5>());
+}
+
+TEST_F(SchedulingWithBoostGraph, CriticalPathPrioritiesFollowLongestDownstreamPath)
+{
+  setupBasicNetwork();
+
+  ModuleExecutionTimeHistory history;
+  auto prioritiesFor = [&]()
+  {
+    CriticalPathScheduler scheduler(ExecuteAllModules::Instance(), history);
+    auto order = scheduler.schedule(matrixMathNetwork);
+    std::map<std::string, double> priorities;
+    for (const auto& node : order.nodes())
+      priorities[node.id.id_] = node.priority;
+    return priorities;
+  };
+
+  {
+    auto priorities = prioritiesFor();
+    ASSERT_EQ(9u, priorities.size());
+    EXPECT_EQ(1, priorities["ReportMatrixInfo:7"]);
+    EXPECT_EQ(2, priorities["EvaluateLinearAlgebraBinary:6"]);
+    EXPECT_EQ(3, priorities["EvaluateLinearAlgebraUnary:2"]);
+    EXPECT_EQ(4, priorities["EvaluateLinearAlgebraUnary:3"]);
+    EXPECT_EQ(5, priorities["CreateMatrix:0"]);
+    EXPECT_EQ(5, priorities["CreateMatrix:1"]);
+  }
+
+  for (size_t i = 0; i < matrixMathNetwork.nmodules(); ++i)
+    history.record(matrixMathNetwork.module(i)->get_id(), 1);
+  // smoothed with the 1 second sample above: (1 + 19) / 2
+  history.record(ModuleId("EvaluateLinearAlgebraUnary:2"), 19);
+
+  {
+    auto priorities = prioritiesFor();
+    EXPECT_EQ(12, priorities["EvaluateLinearAlgebraUnary:2"]);
+    EXPECT_EQ(13, priorities["CreateMatrix:0"]);
+    EXPECT_EQ(5, priorities["CreateMatrix:1"]);
+  }
+}
+
 TEST_F(SchedulingWithBoostGraph, SerialNetworkOrder)
 {
   setupBasicNetwork();
@@ -48,6 +48,8 @@ namespace Networks {
     virtual void send(DatatypeSinkInterfaceHandle receiver) const = 0;
     virtual bool hasData() const = 0;
     virtual std::string describeData() const = 0;
+    /// Keep this source's cached data in memory regardless of the port cache budget.
+    virtual void setCachePinned(bool pinned) = 0;
   };
 
   typedef boost::signals2::signal<void(SCIRun::Core::Datatypes::DatatypeHandle)> DataHasChangedSignalType;
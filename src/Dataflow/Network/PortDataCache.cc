@@ -0,0 +1,375 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <Core/Datatypes/Datatype.h>
+#include <Core/Datatypes/Matrix.h>
+#include <Core/Algorithms/Describe/EstimateDatatypeMemory.h>
+#include <Core/Logging/Log.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <vector>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::General;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  const PersistentTypeID& datatypeTypeId()
+  {
+    // Lookup-only id: every spillable type registers "Datatype" as an ancestor.
+    // MatrixBase's id is a template static that is only registered once referenced,
+    // and the concrete matrix types chain through it.
+    (void)Matrix::type_id;
+    static PersistentTypeID id;
+    id.type = "Datatype";
+    return id;
+  }
+
+  bool isSpillable(const DatatypeHandle& data)
+  {
+    // Complex matrices share persistent class names with their real counterparts,
+    // so they would not round-trip through Pio.
+    if (boost::dynamic_pointer_cast<MatrixBase<complex>>(data))
+      return false;
+    return Persistent::is_base_of("Datatype", data->dynamic_type_name());
+  }
+}
+
+CachedPortData::CachedPortData(PortDataCache& cache) :
+  cache_(cache), bytes_(0), spillable_(false), pinned_(false), inLru_(false)
+{
+}
+
+CachedPortData::~CachedPortData()
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  if (data_)
+    cache_.release(*this);
+  removeSpillFile();
+}
+
+DatatypeHandle CachedPortData::get()
+{
+  DatatypeHandle data;
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    if (data_)
+    {
+      cache_.touch(*this);
+      return data_;
+    }
+    if (spillFile_.empty())
+      return nullptr;
+
+    data_ = cache_.read(spillFile_);
+    removeSpillFile();
+    if (!data_)
+    {
+      bytes_ = 0;
+      return nullptr;
+    }
+    cache_.admit(*this);
+    data = data_;
+  }
+  cache_.enforceBudget();
+  return data;
+}
+
+void CachedPortData::set(DatatypeHandle data)
+{
+  auto bytes = data ? EstimateDatatypeMemory().bytes(data) : 0;
+  auto spillable = data && bytes > 0 && isSpillable(data);
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    if (data_)
+      cache_.release(*this);
+    removeSpillFile();
+    data_ = data;
+    bytes_ = bytes;
+    spillable_ = spillable;
+    if (data_)
+      cache_.admit(*this);
+  }
+  cache_.enforceBudget();
+}
+
+void CachedPortData::clear()
+{
+  set(nullptr);
+}
+
+bool CachedPortData::hasData() const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  return data_ || !spillFile_.empty();
+}
+
+bool CachedPortData::resident() const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  return data_ != nullptr;
+}
+
+size_t CachedPortData::sizeInBytes() const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  return bytes_;
+}
+
+void CachedPortData::setPinned(bool pinned)
+{
+  pinned_ = pinned;
+  if (pinned)
+    get();
+  else
+    cache_.enforceBudget();
+}
+
+bool CachedPortData::pinned() const
+{
+  return pinned_;
+}
+
+bool CachedPortData::spill()
+{
+  boost::unique_lock<boost::mutex> lock(lock_, boost::try_to_lock);
+  if (!lock.owns_lock())
+    return false;
+
+  // Anyone else holding the data (a running module, a downstream sink mid-execution)
+  // keeps it alive anyway, so writing it out would not free anything.
+  if (!data_ || pinned_ || !spillable_ || data_.use_count() > 1)
+    return false;
+
+  auto file = cache_.nextSpillFile();
+  if (file.empty() || !cache_.write(file, data_))
+  {
+    spillable_ = false;
+    return false;
+  }
+
+  spillFile_ = file;
+  data_.reset();
+  cache_.release(*this);
+  return true;
+}
+
+void CachedPortData::removeSpillFile()
+{
+  if (spillFile_.empty())
+    return;
+  boost::system::error_code ec;
+  boost::filesystem::remove(spillFile_, ec);
+  spillFile_.clear();
+}
+
+PortDataCache& PortDataCache::Instance()
+{
+  // Intentionally leaked: port sources may outlive static destruction order.
+  static PortDataCache* instance = new PortDataCache;
+  return *instance;
+}
+
+PortDataCache::PortDataCache() : budget_(0), resident_(0), ownsScratch_(false), spillCount_(0)
+{
+}
+
+PortDataCache::~PortDataCache()
+{
+  if (ownsScratch_)
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(scratch_, ec);
+  }
+}
+
+CachedPortDataHandle PortDataCache::makeEntry()
+{
+  return boost::make_shared<CachedPortData>(*this);
+}
+
+void PortDataCache::setMemoryBudget(size_t bytes)
+{
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    budget_ = bytes;
+  }
+  enforceBudget();
+}
+
+size_t PortDataCache::memoryBudget() const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  return budget_;
+}
+
+size_t PortDataCache::residentBytes() const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  return resident_;
+}
+
+void PortDataCache::setScratchDirectory(const boost::filesystem::path& dir)
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  scratch_ = dir;
+  ownsScratch_ = false;
+}
+
+boost::filesystem::path PortDataCache::scratchDirectory() const
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  return scratch_;
+}
+
+void PortDataCache::enforceBudget()
+{
+  // Handles promoted from the LRU list are released only after the cache lock is dropped:
+  // if one turns out to be the last owner, ~CachedPortData calls release(), which locks it.
+  std::vector<CachedPortDataHandle> promoted;
+  std::vector<std::pair<CachedPortDataHandle, size_t>> candidates;
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    if (0 == budget_ || resident_ <= budget_)
+      return;
+
+    auto excess = resident_ - budget_;
+    size_t freed = 0;
+    for (auto it = lru_.rbegin(); it != lru_.rend() && freed < excess; ++it)
+    {
+      auto entry = it->lock();
+      if (!entry)
+        continue;
+      promoted.push_back(entry);
+      if (entry->spillable_ && !entry->pinned_)
+      {
+        size_t bytes = entry->bytes_;
+        freed += bytes;
+        candidates.emplace_back(entry, bytes);
+      }
+    }
+  }
+
+  // Spilling does file IO, so it runs outside the cache lock; spill() re-checks
+  // the entry state under the entry's own lock.
+  for (const auto& candidate : candidates)
+  {
+    if (!candidate.first->spill())
+      continue;
+    LOG_DEBUG("Port data cache spilled {} bytes, {} resident", candidate.second, residentBytes());
+    if (residentBytes() <= memoryBudget())
+      break;
+  }
+}
+
+void PortDataCache::admit(CachedPortData& entry)
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  entry.lruPosition_ = lru_.insert(lru_.begin(), entry.shared_from_this());
+  entry.inLru_ = true;
+  resident_ += entry.bytes_;
+}
+
+void PortDataCache::touch(CachedPortData& entry)
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  if (entry.inLru_)
+    lru_.splice(lru_.begin(), lru_, entry.lruPosition_);
+}
+
+void PortDataCache::release(CachedPortData& entry)
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  if (!entry.inLru_)
+    return;
+  lru_.erase(entry.lruPosition_);
+  entry.inLru_ = false;
+  resident_ -= entry.bytes_;
+}
+
+boost::filesystem::path PortDataCache::nextSpillFile()
+{
+  boost::lock_guard<boost::mutex> lock(lock_);
+  boost::system::error_code ec;
+  if (scratch_.empty())
+  {
+    scratch_ = boost::filesystem::temp_directory_path(ec) / boost::filesystem::unique_path("scirun-port-cache-%%%%-%%%%-%%%%");
+    ownsScratch_ = true;
+  }
+  if (!boost::filesystem::exists(scratch_, ec))
+    boost::filesystem::create_directories(scratch_, ec);
+  if (ec)
+  {
+    logWarning("Port data cache could not create scratch directory {}: {}", scratch_.string(), ec.message());
+    return boost::filesystem::path();
+  }
+  return scratch_ / ("port" + boost::lexical_cast<std::string>(spillCount_++) + ".bdt");
+}
+
+bool PortDataCache::write(const boost::filesystem::path& file, DatatypeHandle data) const
+{
+  auto stream = auto_ostream(file.string(), "Binary");
+  if (!stream || stream->error())
+  {
+    logWarning("Port data cache could not open {} for writing", file.string());
+    return false;
+  }
+  PersistentHandle handle = data;
+  stream->begin_cheap_delim();
+  stream->io(handle, datatypeTypeId());
+  stream->end_cheap_delim();
+  return !stream->error();
+}
+
+DatatypeHandle PortDataCache::read(const boost::filesystem::path& file) const
+{
+  try
+  {
+    auto stream = auto_istream(file.string());
+    if (!stream || stream->error())
+    {
+      logCritical("Port data cache could not reopen spilled data {}", file.string());
+      return nullptr;
+    }
+    PersistentHandle handle;
+    stream->begin_cheap_delim();
+    stream->io(handle, datatypeTypeId());
+    stream->end_cheap_delim();
+    return boost::dynamic_pointer_cast<Datatype>(handle);
+  }
+  catch (std::exception& e)
+  {
+    logCritical("Port data cache failed to reload {}: {}", file.string(), e.what());
+    return nullptr;
+  }
+}
@@ -0,0 +1,138 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef DATAFLOW_NETWORK_PORTDATACACHE_H
+#define DATAFLOW_NETWORK_PORTDATACACHE_H
+
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <list>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      class PortDataCache;
+
+      /// One cached output port value. While resident the datatype is held strongly; once the
+      /// cache evicts it the data lives in a scratch file and get() reloads it on demand.
+      /// Note that a reloaded datatype is a new object, so its id() differs from the original.
+      class SCISHARE CachedPortData : public boost::enable_shared_from_this<CachedPortData>, boost::noncopyable
+      {
+      public:
+        explicit CachedPortData(PortDataCache& cache);
+        ~CachedPortData();
+
+        Core::Datatypes::DatatypeHandle get();
+        void set(Core::Datatypes::DatatypeHandle data);
+        void clear();
+
+        bool hasData() const;
+        bool resident() const;
+        size_t sizeInBytes() const;
+
+        /// Pinned entries are never evicted; pinning a spilled entry reloads it.
+        void setPinned(bool pinned);
+        bool pinned() const;
+
+      private:
+        friend class PortDataCache;
+        bool spill();
+        void removeSpillFile();
+
+        PortDataCache& cache_;
+        mutable boost::mutex lock_;
+        Core::Datatypes::DatatypeHandle data_;
+        boost::filesystem::path spillFile_;
+        // written under lock_, but the cache reads it while only holding its own lock
+        boost::atomic<size_t> bytes_;
+        boost::atomic<bool> spillable_;
+        boost::atomic<bool> pinned_;
+
+        // guarded by the cache's lock
+        std::list<boost::weak_ptr<CachedPortData>>::iterator lruPosition_;
+        bool inLru_;
+      };
+
+      typedef boost::shared_ptr<CachedPortData> CachedPortDataHandle;
+
+      /// Memory budget for data cached on output ports. Entries are kept in LRU order; when the
+      /// resident total exceeds the budget, unpinned entries that no one else is holding are
+      /// written to the scratch directory in the binary Pio format and dropped from memory.
+      /// A budget of 0 (the default) disables eviction.
+      class SCISHARE PortDataCache : boost::noncopyable
+      {
+      public:
+        static PortDataCache& Instance();
+
+        PortDataCache();
+        ~PortDataCache();
+
+        CachedPortDataHandle makeEntry();
+
+        void setMemoryBudget(size_t bytes);
+        size_t memoryBudget() const;
+        size_t residentBytes() const;
+
+        void setScratchDirectory(const boost::filesystem::path& dir);
+        boost::filesystem::path scratchDirectory() const;
+
+        /// Evict least recently used entries until the resident total fits the budget.
+        void enforceBudget();
+
+      private:
+        friend class CachedPortData;
+        void admit(CachedPortData& entry);
+        void touch(CachedPortData& entry);
+        void release(CachedPortData& entry);
+        boost::filesystem::path nextSpillFile();
+        bool write(const boost::filesystem::path& file, Core::Datatypes::DatatypeHandle data) const;
+        Core::Datatypes::DatatypeHandle read(const boost::filesystem::path& file) const;
+
+        mutable boost::mutex lock_;
+        std::list<boost::weak_ptr<CachedPortData>> lru_;
+        size_t budget_;
+        size_t resident_;
+        boost::filesystem::path scratch_;
+        bool ownsScratch_;
+        size_t spillCount_;
+      };
+    }
+  }
+}
+
+#endif
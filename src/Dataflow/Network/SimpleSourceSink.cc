@@ -71,6 +71,15 @@ void SimpleSink::setGlobalPortCachingFlag(bool value)
   }
 }
 
+bool SimpleSink::globalContentHash_(false); /// hashing reads every value of large fields and matrices, so it is opt-in
+
+bool SimpleSink::globalContentHashFlag() { return globalContentHash_; }
+
+void SimpleSink::setGlobalContentHashFlag(bool value)
+{
+  globalContentHash_ = value;
+}
+
 void SimpleSink::invalidateAll()
 {
   for (auto sink : instances_)
@@ -83,21 +92,30 @@ DatatypeHandleOption SimpleSink::receive()
   {
     return strong;
   }
+  // the source's cache may have spilled the data; reloading yields a new object
+  if (auto provider = provider_.lock())
+  {
+    auto reloaded = provider->get();
+    weakData_ = reloaded;
+    if (reloaded)
+      return reloaded;
+  }
   return DatatypeHandleOption();
 }
 
-void SimpleSink::setData(DatatypeHandle data)
+void SimpleSink::setData(DatatypeHandle data, CachedPortDataHandle provider)
 {
-  if (auto strong = weakData_.lock())
-  {
-    if (data)
-    {
-      hasChanged_ = strong->id() != data->id();
-    }
-  }
-  else if (data)
+  provider_ = provider;
+  if (data)
   {
-    hasChanged_ = true;
+    // The previous object is usually gone by now (the source replaced it), so compare
+    // against what was recorded when it arrived.
+    auto hash = globalContentHash_ ? data->contentHash() : boost::none;
+    auto sameObject = lastId_ && *lastId_ == data->id() && !weakData_.expired();
+    auto sameValue = hash && lastHash_ && *hash == *lastHash_;
+    hasChanged_ = !(sameObject || sameValue);
+    lastId_ = data->id();
+    lastHash_ = hash;
   }
 
   weakData_ = data;
@@ -131,7 +149,7 @@ boost::signals2::connection SimpleSink::connectDataHasChanged(const DataHasChang
 
 void SimpleSource::cacheData(DatatypeHandle data)
 {
-  data_ = data;
+  cache_->set(data);
 }
 
 void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
@@ -140,15 +158,15 @@ void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
   if (!sink)
     THROW_INVALID_ARGUMENT("SimpleSource can only send to SimpleSinks");
 
-  sink->setData(data_);
+  sink->setData(cache_->get(), cache_);
 }
 
 bool SimpleSource::hasData() const
 {
-  return data_ != nullptr;
+  return cache_->hasData();
 }
 
-SimpleSource::SimpleSource()
+SimpleSource::SimpleSource() : cache_(PortDataCache::Instance().makeEntry())
 {
   instances_.insert(this);
 }
@@ -163,11 +181,16 @@ std::set<SimpleSource*> SimpleSource::instances_;
 void SimpleSource::clearAllSources()
 {
   for (auto source : instances_)
-    source->data_.reset();
+    source->cache_->clear();
 }
 
 std::string SimpleSource::describeData() const
 {
   DescribeDatatype dd;
-  return dd.describe(data_);
+  return dd.describe(cache_->get());
+}
+
+void SimpleSource::setCachePinned(bool pinned)
+{
+  cache_->setPinned(pinned);
 }
@@ -32,6 +32,8 @@
 #define DATAFLOW_NETWORK_SIMPLESOURCESINK_H
 
 #include <Dataflow/Network/DataflowInterfaces.h>
+#include <Core/Datatypes/Datatype.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <boost/function.hpp>
 #include <set>
 #include <Dataflow/Network/share.h>
@@ -53,7 +55,8 @@ namespace SCIRun
         Core::Datatypes::DatatypeHandleOption receive() override;
         DatatypeSinkInterface* clone() const override;
         bool hasChanged() const override;
-        void setData(Core::Datatypes::DatatypeHandle data);
+        /// The provider entry lets the sink reload data its source spilled to disk.
+        void setData(Core::Datatypes::DatatypeHandle data, CachedPortDataHandle provider = CachedPortDataHandle());
         void invalidateProvider() override { /*TODO*/ }
         boost::signals2::connection connectDataHasChanged(const DataHasChangedSignalType::slot_type& subscriber) override;
         void forceFireDataHasChanged() override;
@@ -61,12 +64,22 @@ namespace SCIRun
         static bool globalPortCachingFlag();
         static void setGlobalPortCachingFlag(bool value);
 
+        /// When set, data equal by content hash to the previous input does not count as a
+        /// change, even if it is a different object. Off by default, since each new input
+        /// is then hashed in full.
+        static bool globalContentHashFlag();
+        static void setGlobalContentHashFlag(bool value);
+
       private:
         WeakDatatypeHandle weakData_;
+        boost::weak_ptr<CachedPortData> provider_;
         mutable bool hasChanged_;
+        boost::optional<Core::Datatypes::Datatype::id_type> lastId_;
+        boost::optional<Core::Datatypes::Datatype::content_hash_type> lastHash_;
         DataHasChangedSignalType dataHasChanged_;
         bool checkForNewDataOnSetting_;
         static bool globalPortCaching_;
+        static bool globalContentHash_;
         static void invalidateAll();
         static std::set<SimpleSink*> instances_;
       };
@@ -94,10 +107,11 @@ namespace SCIRun
         virtual void send(DatatypeSinkInterfaceHandle receiver) const override;
         virtual bool hasData() const override;
         virtual std::string describeData() const override;
+        virtual void setCachePinned(bool pinned) override;
 
         static void clearAllSources();
       protected:
-        SCIRun::Core::Datatypes::DatatypeHandle data_;
+        CachedPortDataHandle cache_;
         static std::set<SimpleSource*> instances_;
       };
     }
@@ -32,6 +32,7 @@
 #include <Dataflow/Network/Tests/MockPorts.h>
 #include <Dataflow/Network/SimpleSourceSink.h>
 #include <Core/Datatypes/Scalar.h>
+#include <Core/Datatypes/DenseMatrix.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -103,6 +104,32 @@ TEST_F(InputPortTest, GetDataWaitsAndReceivesData)
   EXPECT_EQ(dataValue, (*data)->as<Int32>()->toInt());
 }
 
+TEST_F(InputPortTest, EqualContentIsNotReportedAsChanged)
+{
+  PortId id(0, "ForwardMatrix");
+  Port::ConstructionParams pcp(id, "Matrix", false);
+
+  boost::shared_ptr<SimpleSink> sink(new SimpleSink);
+  InputPortHandle inputPort(new InputPort(inputModule.get(), pcp, sink));
+  boost::shared_ptr<SimpleSource> source(new SimpleSource);
+  OutputPortHandle outputPort(new OutputPort(outputModule.get(), pcp, source));
+  Connection c(outputPort, inputPort, "test");
+
+  SimpleSink::setGlobalContentHashFlag(true);
+  outputPort->sendData(boost::make_shared<DenseMatrix>(3, 3, 1.0));
+  EXPECT_TRUE(inputPort->hasChanged());
+
+  outputPort->sendData(boost::make_shared<DenseMatrix>(3, 3, 1.0));
+  EXPECT_FALSE(inputPort->hasChanged());
+
+  outputPort->sendData(boost::make_shared<DenseMatrix>(3, 3, 2.0));
+  EXPECT_TRUE(inputPort->hasChanged());
+
+  SimpleSink::setGlobalContentHashFlag(false);
+  outputPort->sendData(boost::make_shared<DenseMatrix>(3, 3, 2.0));
+  EXPECT_TRUE(inputPort->hasChanged());
+}
+
 TEST_F(InputPortTest, CanClone)
 {
   PortId id(0, "ForwardMatrix");
@@ -137,6 +137,7 @@ namespace SCIRun {
           MOCK_CONST_METHOD1(send, void(DatatypeSinkInterfaceHandle));
           MOCK_CONST_METHOD0(hasData, bool());
           MOCK_CONST_METHOD0(describeData, std::string());
+          MOCK_METHOD1(setCachePinned, void(bool));
         };
 
         typedef boost::shared_ptr<MockDatatypeSource> MockDatatypeSourcePtr;
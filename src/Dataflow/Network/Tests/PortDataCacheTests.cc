@@ -0,0 +1,196 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/thread/thread.hpp>
+#include <atomic>
+#include <memory>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Dataflow::Networks;
+
+namespace
+{
+  const size_t matrixBytes = 10 * 10 * sizeof(double);
+}
+
+class PortDataCacheTests : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    cache_.setMemoryBudget(2 * matrixBytes + matrixBytes / 2);
+  }
+
+  static DenseMatrixHandle makeMatrix(double value)
+  {
+    return boost::make_shared<DenseMatrix>(10, 10, value);
+  }
+
+  PortDataCache cache_;
+};
+
+TEST_F(PortDataCacheTests, EvictsLeastRecentlyUsedEntryWhenOverBudget)
+{
+  auto a = cache_.makeEntry(), b = cache_.makeEntry(), c = cache_.makeEntry();
+  a->set(makeMatrix(1));
+  b->set(makeMatrix(2));
+  EXPECT_EQ(2 * matrixBytes, cache_.residentBytes());
+
+  a->get();
+  c->set(makeMatrix(3));
+
+  EXPECT_TRUE(a->resident());
+  EXPECT_FALSE(b->resident());
+  EXPECT_TRUE(b->hasData());
+  EXPECT_TRUE(c->resident());
+  EXPECT_EQ(2 * matrixBytes, cache_.residentBytes());
+  EXPECT_TRUE(boost::filesystem::exists(cache_.scratchDirectory()));
+}
+
+TEST_F(PortDataCacheTests, SpilledDataReloadsOnDemand)
+{
+  auto a = cache_.makeEntry(), b = cache_.makeEntry(), c = cache_.makeEntry();
+  a->set(makeMatrix(1));
+  b->set(makeMatrix(2));
+  c->set(makeMatrix(3));
+  ASSERT_FALSE(a->resident());
+
+  auto reloaded = boost::dynamic_pointer_cast<DenseMatrix>(a->get());
+  ASSERT_TRUE(reloaded != nullptr);
+  EXPECT_EQ(10, reloaded->rows());
+  EXPECT_EQ(10, reloaded->cols());
+  EXPECT_EQ(100.0, reloaded->sum());
+
+  EXPECT_TRUE(a->resident());
+  EXPECT_FALSE(b->resident());
+}
+
+TEST_F(PortDataCacheTests, PinnedAndReferencedEntriesAreNotEvicted)
+{
+  auto a = cache_.makeEntry(), b = cache_.makeEntry(), c = cache_.makeEntry();
+  a->set(makeMatrix(1));
+  a->setPinned(true);
+  auto held = makeMatrix(2);
+  b->set(held);
+  c->set(makeMatrix(3));
+
+  EXPECT_TRUE(a->resident());
+  EXPECT_TRUE(b->resident());
+  EXPECT_EQ(3 * matrixBytes, cache_.residentBytes());
+
+  held.reset();
+  cache_.enforceBudget();
+  EXPECT_FALSE(b->resident());
+
+  a->setPinned(false);
+  EXPECT_TRUE(a->resident());
+  EXPECT_EQ(2 * matrixBytes, cache_.residentBytes());
+}
+
+TEST_F(PortDataCacheTests, ZeroBudgetNeverEvicts)
+{
+  cache_.setMemoryBudget(0);
+  auto a = cache_.makeEntry(), b = cache_.makeEntry(), c = cache_.makeEntry();
+  a->set(makeMatrix(1));
+  b->set(makeMatrix(2));
+  c->set(makeMatrix(3));
+
+  EXPECT_TRUE(a->resident());
+  EXPECT_EQ(3 * matrixBytes, cache_.residentBytes());
+}
+
+TEST_F(PortDataCacheTests, EntryDroppedWhileBudgetIsEnforcedDoesNotDeadlock)
+{
+  cache_.setMemoryBudget(1);
+  // a long LRU list keeps enforceBudget holding the lock for most of each pass
+  std::unique_ptr<std::vector<CachedPortDataHandle>> held(new std::vector<CachedPortDataHandle>);
+  for (int i = 0; i < 1000; ++i)
+  {
+    held->push_back(cache_.makeEntry());
+    held->back()->setPinned(true);
+    held->back()->set(makeMatrix(i));
+  }
+  std::atomic<bool> running(true);
+  boost::thread enforcer([&]()
+  {
+    while (running)
+      cache_.enforceBudget();
+  });
+
+  // pinned entries stay on the LRU list, so enforceBudget keeps promoting them while
+  // this thread lets go of the only other reference
+  boost::thread owner([&]()
+  {
+    for (int i = 0; i < 20000; ++i)
+    {
+      auto entry = cache_.makeEntry();
+      entry->setPinned(true);
+      entry->set(makeMatrix(i));
+    }
+  });
+
+  bool finished = owner.timed_join(boost::posix_time::seconds(30));
+  running = false;
+  if (!finished)
+  {
+    // the cache lock is held forever; releasing the entries would block on it too
+    enforcer.detach();
+    owner.detach();
+    held.release();
+    FAIL() << "releasing an entry deadlocked against enforceBudget";
+  }
+  enforcer.join();
+  EXPECT_EQ(held->size() * matrixBytes, cache_.residentBytes());
+}
+
+TEST(SimpleSourceSinkCacheTests, SinkReloadsDataSpilledBySource)
+{
+  auto& cache = PortDataCache::Instance();
+  cache.setMemoryBudget(1);
+
+  SimpleSource source;
+  auto sink = boost::make_shared<SimpleSink>();
+  source.cacheData(boost::make_shared<DenseMatrix>(4, 4, 2.0));
+  source.send(sink);
+  cache.enforceBudget();
+  EXPECT_TRUE(source.hasData());
+  EXPECT_EQ(0u, cache.residentBytes());
+
+  auto data = sink->receive();
+  ASSERT_TRUE(data && *data);
+  auto matrix = boost::dynamic_pointer_cast<DenseMatrix>(*data);
+  ASSERT_TRUE(matrix != nullptr);
+  EXPECT_EQ(32.0, matrix->sum());
+
+  cache.setMemoryBudget(0);
+}
@@ -37,6 +37,7 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <limits>
 #include <glm/glm.hpp>
 #include <var-buffer/VarBuffer.hpp>
 #include <es-cereal/ComponentSerialize.hpp>
@@ -64,6 +65,7 @@ namespace SCIRun {
         RENDER_VBO_IBO,
         RENDER_RLIST_SPHERE,
         RENDER_RLIST_CYLINDER,
+        RENDER_INSTANCED,
       };
 
       // Could require rvalue references...
@@ -148,7 +150,8 @@ namespace SCIRun {
       /// Defines a Spire object 'pass'.
       struct SpireSubPass
       {
-        SpireSubPass() : renderType(RenderType::RENDER_VBO_IBO), scalar(0), mColorScheme(ColorScheme::COLOR_UNIFORM) {}
+        SpireSubPass() : renderType(RenderType::RENDER_VBO_IBO), scalar(0),
+          lodMinSize(0.0f), lodMaxSize(std::numeric_limits<float>::max()), mColorScheme(ColorScheme::COLOR_UNIFORM) {}
         SpireSubPass(const std::string& name, const std::string& vboName,
           const std::string& iboName, const std::string& program,
           ColorScheme scheme, const RenderState& state,
@@ -164,6 +167,8 @@ namespace SCIRun {
           ibo(ibo),
           text(text),
           scalar(1.0),
+          lodMinSize(0.0f),
+          lodMaxSize(std::numeric_limits<float>::max()),
           mColorScheme(scheme)
         {}
 
@@ -185,6 +190,18 @@ namespace SCIRun {
         SpireIBO			ibo;
         SpireText     text;//draw a string (usually single character) on geometry
         double        scalar;
+        /// Per-instance attributes for RENDER_INSTANCED passes. vboName and iboName then name
+        /// the prototype mesh, which is drawn once for each of instances.numElements entries.
+        SpireVBO      instances;
+        /// Projected sizes, in pixels across the bounding sphere of vbo, for which the pass is
+        /// drawn. The levels of detail of an object are passes with adjacent ranges.
+        float         lodMinSize;
+        float         lodMaxSize;
+
+        bool hasLevelOfDetail() const
+        {
+          return lodMinSize > 0.0f || lodMaxSize < std::numeric_limits<float>::max();
+        }
 
         struct Uniform
         {
@@ -29,6 +29,7 @@ DEALINGS IN THE SOFTWARE.
 #include <Graphics/Glyphs/GlyphGeom.h>
 #include <Core/Math/MiscMath.h>
 #include <Core/GeometryPrimitives/Transform.h>
+#include <sstream>
 
 using namespace SCIRun;
 using namespace Graphics;
@@ -36,7 +37,13 @@ using namespace Datatypes;
 using namespace Core::Geometry;
 using namespace Core::Datatypes;
 
-GlyphGeom::GlyphGeom() : numVBOElements_(0), lineIndex_(0)
+namespace
+{
+  // Position, three axis columns and RGBA color.
+  const size_t InstanceFloats = 16;
+}
+
+GlyphGeom::GlyphGeom() : numVBOElements_(0), lineIndex_(0), instanced_(false)
 {
 
 }
@@ -54,6 +61,13 @@ void GlyphGeom::getBufferInfo(int64_t& numVBOElements, std::vector<Vector>& poin
 void GlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& uniqueNodeID, const bool isTransparent, const double transparencyValue,
   const ColorScheme& colorScheme, RenderState state, const SpireIBO::PRIMITIVE& primIn, const BBox& bbox)
 {
+  if (!instances_.empty())
+  {
+    buildInstancedObjects(geom, uniqueNodeID, colorScheme, state, bbox);
+    if (points_.empty())
+      return;
+  }
+
   std::string vboName = uniqueNodeID + "VBO";
   std::string iboName = uniqueNodeID + "IBO";
   std::string passName = uniqueNodeID + "Pass";
@@ -206,9 +220,166 @@ void GlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& unique
   geom.passes().push_back(pass);
 }
 
+void GlyphGeom::buildInstancedObjects(GeometryObjectSpire& geom, const std::string& uniqueNodeID,
+  const ColorScheme& colorScheme, const RenderState& renderState, const BBox& bbox)
+{
+  RenderState state = renderState;
+  state.set(RenderState::IS_ON, true);
+  state.set(RenderState::HAS_DATA, true);
+
+  std::vector<SpireVBO::AttributeData> meshAttribs;
+  meshAttribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  meshAttribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+
+  std::vector<SpireVBO::AttributeData> instanceAttribs;
+  instanceAttribs.push_back(SpireVBO::AttributeData("aInstancePos", 3 * sizeof(float)));
+  instanceAttribs.push_back(SpireVBO::AttributeData("aInstanceAxisX", 3 * sizeof(float)));
+  instanceAttribs.push_back(SpireVBO::AttributeData("aInstanceAxisY", 3 * sizeof(float)));
+  instanceAttribs.push_back(SpireVBO::AttributeData("aInstanceAxisZ", 3 * sizeof(float)));
+  instanceAttribs.push_back(SpireVBO::AttributeData("aInstanceColor", 4 * sizeof(float)));
+
+  // Uniformly colored glyphs use the default color, as uDiffuseColor does on the tessellated path.
+  ColorRGB dft = state.defaultColor;
+
+  for (const auto& prototypeInstances : instances_)
+  {
+    const PrototypeKey& key = prototypeInstances.first;
+    const std::vector<float>& instances = prototypeInstances.second;
+
+    std::stringstream ss;
+    ss << "Instanced" << static_cast<int>(key.first) << "_" << key.second;
+    std::string prototypeID = uniqueNodeID + ss.str();
+    std::string vboName = prototypeID + "VBO";
+    std::string iboName = prototypeID + "IBO";
+    std::string instanceName = prototypeID + "InstanceVBO";
+    std::string passName = prototypeID + "Pass";
+
+    int64_t numVBOElements = 0;
+    std::vector<Vector> points;
+    std::vector<Vector> normals;
+    std::vector<uint32_t> indices;
+    generatePrototype(key.first, key.second, numVBOElements, points, normals, indices);
+
+    std::shared_ptr<spire::VarBuffer> vboBufferSPtr(new spire::VarBuffer(points.size() * 6 * sizeof(float)));
+    std::shared_ptr<spire::VarBuffer> iboBufferSPtr(new spire::VarBuffer(indices.size() * sizeof(uint32_t)));
+    std::shared_ptr<spire::VarBuffer> instanceBufferSPtr(new spire::VarBuffer(instances.size() * sizeof(float)));
+
+    auto vboBuffer = vboBufferSPtr.get();
+    auto iboBuffer = iboBufferSPtr.get();
+    auto instanceBuffer = instanceBufferSPtr.get();
+
+    for (auto a : indices)
+      iboBuffer->write(a);
+
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      vboBuffer->write(static_cast<float>(points[i].x()));
+      vboBuffer->write(static_cast<float>(points[i].y()));
+      vboBuffer->write(static_cast<float>(points[i].z()));
+      vboBuffer->write(static_cast<float>(normals[i].x()));
+      vboBuffer->write(static_cast<float>(normals[i].y()));
+      vboBuffer->write(static_cast<float>(normals[i].z()));
+    }
+
+    for (size_t i = 0; i < instances.size(); i += InstanceFloats)
+    {
+      for (size_t j = 0; j < 12; ++j)
+        instanceBuffer->write(instances[i + j]);
+      if (colorScheme == ColorScheme::COLOR_UNIFORM)
+      {
+        instanceBuffer->write(static_cast<float>(dft.r()));
+        instanceBuffer->write(static_cast<float>(dft.g()));
+        instanceBuffer->write(static_cast<float>(dft.b()));
+        instanceBuffer->write(static_cast<float>(dft.a()));
+      }
+      else
+      {
+        for (size_t j = 12; j < InstanceFloats; ++j)
+          instanceBuffer->write(instances[i + j]);
+      }
+    }
+
+    SpireVBO meshVBO(vboName, meshAttribs, vboBufferSPtr, numVBOElements, bbox, true);
+    SpireIBO meshIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBufferSPtr);
+    SpireVBO instanceVBO(instanceName, instanceAttribs, instanceBufferSPtr,
+      static_cast<int64_t>(instances.size() / InstanceFloats), bbox, true);
+
+    SpireSubPass pass(passName, vboName, iboName, "Shaders/DirPhongInstanced", colorScheme, state,
+      RenderType::RENDER_INSTANCED, meshVBO, meshIBO, SpireText());
+    pass.instances = instanceVBO;
+
+    pass.addUniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+    pass.addUniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f));
+    pass.addUniform("uSpecularPower", 32.0f);
+
+    geom.vbos().push_back(meshVBO);
+    geom.ibos().push_back(meshIBO);
+    geom.passes().push_back(pass);
+  }
+}
+
+void GlyphGeom::addInstance(Prototype prototype, double resolution, const Point& origin,
+  const Vector& axisX, const Vector& axisY, const Vector& axisZ, const ColorRGB& color)
+{
+  auto& instances = instances_[PrototypeKey(prototype, static_cast<int>(resolution))];
+  const double values[InstanceFloats] = {
+    origin.x(), origin.y(), origin.z(),
+    axisX.x(), axisX.y(), axisX.z(),
+    axisY.x(), axisY.y(), axisY.z(),
+    axisZ.x(), axisZ.y(), axisZ.z(),
+    color.r(), color.g(), color.b(), color.a() };
+  for (double v : values)
+    instances.push_back(static_cast<float>(v));
+}
+
+void GlyphGeom::addAxialInstance(Prototype prototype, const Point& p1, const Point& p2,
+  double radius, double resolution, const ColorRGB& color)
+{
+  // Prototypes run along z from 0 to 1 with unit radius.
+  Vector axis = p2 - p1;
+  Vector u(0, 0, 0), crx(0, 0, 0);
+  if (axis.length() > 0)
+  {
+    axis.normal().find_orthogonal(u, crx);
+    u *= radius;
+    crx *= radius;
+  }
+  addInstance(prototype, resolution, p1, u, crx, axis, color);
+}
+
+void GlyphGeom::generatePrototype(Prototype prototype, double resolution, int64_t& numVBOElements,
+  std::vector<Vector>& points, std::vector<Vector>& normals, std::vector<uint32_t>& indices)
+{
+  std::vector<ColorRGB> colors;
+  ColorRGB color;
+  Point origin(0, 0, 0), tip(0, 0, 1), mid(0, 0, 0.5);
+  switch (prototype)
+  {
+  case Prototype::SPHERE:
+    generateSphere(origin, 1.0, 1.0, resolution, color, numVBOElements, points, normals, indices, colors);
+    break;
+  case Prototype::CYLINDER:
+    generateCylinder(origin, tip, 1.0, 1.0, resolution, color, color, numVBOElements, points, normals, indices, colors);
+    break;
+  case Prototype::CONE:
+    generateCylinder(origin, tip, 1.0, 0.0, resolution, color, color, numVBOElements, points, normals, indices, colors);
+    break;
+  case Prototype::ARROW:
+    generateCylinder(origin, mid, 1.0 / 6.0, 1.0 / 6.0, resolution, color, color, numVBOElements, points, normals, indices, colors);
+    generateCylinder(mid, tip, 1.0, 0.0, resolution, color, color, numVBOElements, points, normals, indices, colors);
+    break;
+  }
+}
+
 void GlyphGeom::addArrow(const Point& p1, const Point& p2, double radius, double resolution,
   const ColorRGB& color1, const ColorRGB& color2)
 {
+  if (instanced_)
+  {
+    addAxialInstance(Prototype::ARROW, p1, p2, radius, resolution, color1);
+    return;
+  }
+
   double ratio = 0.5;
 
   Point mid(ratio * (p1.x() + p2.x()), ratio * (p1.y() + p2.y()), ratio * (p1.z() + p2.z()));
@@ -219,6 +390,11 @@ void GlyphGeom::addArrow(const Point& p1, const Point& p2, double radius, double
 
 void GlyphGeom::addSphere(const Point& p, double radius, double resolution, const ColorRGB& color)
 {
+  if (instanced_)
+  {
+    addInstance(Prototype::SPHERE, resolution, p, Vector(radius, 0, 0), Vector(0, radius, 0), Vector(0, 0, radius), color);
+    return;
+  }
   generateSphere(p, radius, radius, resolution, color, numVBOElements_, points_, normals_, indices_, colors_);
 }
 
@@ -230,12 +406,22 @@ void GlyphGeom::addEllipsoid(const Point& p, double radius1, double radius2, dou
 void GlyphGeom::addCylinder(const Point& p1, const Point& p2, double radius, double resolution,
                             const ColorRGB& color1, const ColorRGB& color2)
 {
+  if (instanced_)
+  {
+    addAxialInstance(Prototype::CYLINDER, p1, p2, radius, resolution, color1);
+    return;
+  }
   generateCylinder(p1, p2, radius, radius, resolution, color1, color2, numVBOElements_, points_, normals_, indices_, colors_);
 }
 
 void GlyphGeom::addCone(const Point& p1, const Point& p2, double radius, double resolution,
   const ColorRGB& color1, const ColorRGB& color2)
 {
+  if (instanced_)
+  {
+    addAxialInstance(Prototype::CONE, p1, p2, radius, resolution, color1);
+    return;
+  }
   //std::cout << "p1: " << p1 << " p2 " << p2 << " radius: " << radius << " resolution: " << resolution << " color1: " << color1 << " color2: " << color2 << std::endl;
   generateCylinder(p1, p2, radius, 0.0, resolution, color1, color2, numVBOElements_, points_, normals_, indices_, colors_);
 }
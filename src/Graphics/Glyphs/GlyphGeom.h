@@ -34,6 +34,7 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/Math/TrigTable.h>
 #include <Graphics/Datatypes/GeometryImpl.h>
 #include <Core/Datatypes/Color.h>
+#include <map>
 
 #include <Graphics/Glyphs/share.h>
 
@@ -75,6 +76,11 @@ namespace SCIRun {
         const Core::Datatypes::ColorRGB& color1, const Core::Datatypes::ColorRGB& color2);
       void addPoint(const Core::Geometry::Point& p, const Core::Datatypes::ColorRGB& color);
 
+      /// When enabled, arrows, spheres, cylinders and cones are recorded as instances of one
+      /// prototype mesh per shape and resolution instead of being tessellated one by one; each
+      /// instance takes the first color given. Lines, needles and points are not affected.
+      void setInstanced(bool instanced) { instanced_ = instanced; }
+
       //From SCIRun4
       void addArrow(const Core::Geometry::Point& center, const Core::Geometry::Vector& t, double radius, double length, int nu = 20, int nv = 0);
       void addBox(const Core::Geometry::Point& center, const Core::Geometry::Vector& t, double x_side, double y_side, double z_side);
@@ -82,6 +88,15 @@ namespace SCIRun {
       void addSphere(const Core::Geometry::Point& center, double radius, int nu=20, int nv=20, int half=0);
 
     private:
+      enum class Prototype
+      {
+        SPHERE,
+        CYLINDER,
+        CONE,
+        ARROW
+      };
+      typedef std::pair<Prototype, int> PrototypeKey;
+
       std::vector<SinCosTable> tables_;
       std::vector<Core::Geometry::Vector> points_;
       std::vector<Core::Geometry::Vector> normals_;
@@ -89,6 +104,19 @@ namespace SCIRun {
       std::vector<uint32_t> indices_;
       int64_t numVBOElements_;
       uint32_t lineIndex_;
+      bool instanced_;
+      /// Per-instance position, axes and color (16 floats each), keyed by prototype mesh.
+      std::map<PrototypeKey, std::vector<float>> instances_;
+
+      void addInstance(Prototype prototype, double resolution, const Core::Geometry::Point& origin,
+        const Core::Geometry::Vector& axisX, const Core::Geometry::Vector& axisY, const Core::Geometry::Vector& axisZ,
+        const Core::Datatypes::ColorRGB& color);
+      void addAxialInstance(Prototype prototype, const Core::Geometry::Point& p1, const Core::Geometry::Point& p2,
+        double radius, double resolution, const Core::Datatypes::ColorRGB& color);
+      void generatePrototype(Prototype prototype, double resolution, int64_t& numVBOElements,
+        std::vector<Core::Geometry::Vector>& points, std::vector<Core::Geometry::Vector>& normals, std::vector<uint32_t>& indices);
+      void buildInstancedObjects(Datatypes::GeometryObjectSpire& geom, const std::string& uniqueNodeID,
+        const Datatypes::ColorScheme& colorScheme, const RenderState& state, const Core::Geometry::BBox& bbox);
 
       void generateCylinder(const  Core::Geometry::Point& p1, const  Core::Geometry::Point& p2, double radius1, double radius2, double resolution, const Core::Datatypes::ColorRGB& color1, const Core::Datatypes::ColorRGB& color2,
         int64_t& numVBOElements, std::vector<Core::Geometry::Vector>& points, std::vector<Core::Geometry::Vector>& normals, std::vector<uint32_t>& indices, std::vector<Core::Datatypes::ColorRGB>& colors);
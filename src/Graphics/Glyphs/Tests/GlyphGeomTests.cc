@@ -0,0 +1,192 @@
+/*
+For more information, please see: http://software.sci.utah.edu
+
+The MIT License
+
+Copyright (c) 2015 Scientific Computing and Imaging Institute,
+University of Utah.
+
+License for the specific language governing rights and limitations under
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Graphics/Glyphs/GlyphGeom.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Graphics;
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  class StubIDGenerator : public Core::GeometryIDGenerator
+  {
+  public:
+    virtual std::string generateGeometryID(const std::string& tag) const override { return tag; }
+  };
+
+  const size_t InstanceFloats = 16;
+
+  class GlyphGeomTests : public ::testing::Test
+  {
+  protected:
+    GlyphGeomTests() : geom_(idGenerator_, "glyphs", true) {}
+
+    void build(GlyphGeom& glyphs, ColorScheme scheme, bool transparent = false)
+    {
+      glyphs.buildObject(geom_, "id", transparent, 0.5, scheme, state_, SpireIBO::PRIMITIVE::TRIANGLES,
+        BBox(Point(-1, -1, -1), Point(4, 4, 4)));
+    }
+
+    const SpireSubPass* findPass(const std::string& name) const
+    {
+      for (const auto& pass : geom_.passes())
+      {
+        if (pass.passName == name)
+          return &pass;
+      }
+      return nullptr;
+    }
+
+    static const float* instance(const SpireSubPass& pass, int i)
+    {
+      return reinterpret_cast<const float*>(pass.instances.data->getBuffer()) + i * InstanceFloats;
+    }
+
+    static void expectColor(const ColorRGB& expected, const float* values)
+    {
+      EXPECT_FLOAT_EQ(expected.r(), values[12]);
+      EXPECT_FLOAT_EQ(expected.g(), values[13]);
+      EXPECT_FLOAT_EQ(expected.b(), values[14]);
+      EXPECT_FLOAT_EQ(expected.a(), values[15]);
+    }
+
+    StubIDGenerator idGenerator_;
+    GeometryObjectSpire geom_;
+    RenderState state_;
+  };
+}
+
+TEST_F(GlyphGeomTests, InstancedGlyphsBuildOnePassPerPrototypeAndResolution)
+{
+  GlyphGeom glyphs;
+  glyphs.setInstanced(true);
+  glyphs.addSphere(Point(1, 2, 3), 0.5, 5, ColorRGB(1, 0, 0));
+  glyphs.addSphere(Point(0, 0, 0), 0.25, 5, ColorRGB(0, 1, 0));
+  glyphs.addSphere(Point(0, 0, 0), 0.25, 8, ColorRGB(0, 1, 0));
+  for (int i = 0; i < 3; ++i)
+    glyphs.addArrow(Point(i, 0, 0), Point(i, 0, 2), 0.5, 5, ColorRGB(0, 0, 1), ColorRGB(0, 0, 1));
+  glyphs.addCylinder(Point(0, 0, 0), Point(0, 3, 0), 0.1, 5, ColorRGB(1, 1, 0), ColorRGB(1, 1, 0));
+  glyphs.addCone(Point(0, 0, 0), Point(3, 0, 0), 0.1, 5, ColorRGB(0, 1, 1), ColorRGB(0, 1, 1));
+  build(glyphs, ColorScheme::COLOR_IN_SITU);
+
+  // spheres at two resolutions, arrows, cylinders and cones; nothing tessellated
+  ASSERT_EQ(5u, geom_.passes().size());
+  EXPECT_EQ(5u, geom_.vbos().size());
+  int64_t instances = 0;
+  for (const auto& pass : geom_.passes())
+  {
+    EXPECT_EQ(RenderType::RENDER_INSTANCED, pass.renderType) << pass.passName;
+    EXPECT_EQ("Shaders/DirPhongInstanced", pass.programName) << pass.passName;
+    ASSERT_TRUE(pass.instances.data != nullptr) << pass.passName;
+    EXPECT_EQ(pass.instances.numElements * InstanceFloats * sizeof(float), pass.instances.data->getBufferSize()) << pass.passName;
+    EXPECT_GT(pass.vbo.numElements, 0) << pass.passName;
+    instances += pass.instances.numElements;
+  }
+  EXPECT_EQ(8, instances);
+
+  auto spheres = findPass("idInstanced0_5Pass");
+  ASSERT_TRUE(spheres != nullptr);
+  ASSERT_EQ(2, spheres->instances.numElements);
+  const float expected[12] = { 1, 2, 3, 0.5f, 0, 0, 0, 0.5f, 0, 0, 0, 0.5f };
+  for (int j = 0; j < 12; ++j)
+    EXPECT_FLOAT_EQ(expected[j], instance(*spheres, 0)[j]) << j;
+  expectColor(ColorRGB(1, 0, 0), instance(*spheres, 0));
+
+  auto arrows = findPass("idInstanced3_5Pass");
+  ASSERT_TRUE(arrows != nullptr);
+  EXPECT_EQ(3, arrows->instances.numElements);
+  auto fineSpheres = findPass("idInstanced0_8Pass");
+  ASSERT_TRUE(fineSpheres != nullptr);
+  EXPECT_EQ(1, fineSpheres->instances.numElements);
+}
+
+TEST_F(GlyphGeomTests, UniformColorSchemeWritesTheDefaultColor)
+{
+  state_.defaultColor = ColorRGB(0.2, 0.4, 0.6);
+  GlyphGeom glyphs;
+  glyphs.setInstanced(true);
+  glyphs.addSphere(Point(0, 0, 0), 1, 5, ColorRGB(1, 0, 0));
+  glyphs.addCylinder(Point(0, 0, 0), Point(0, 0, 1), 1, 5, ColorRGB(0, 1, 0), ColorRGB(0, 1, 0));
+  build(glyphs, ColorScheme::COLOR_UNIFORM);
+
+  ASSERT_EQ(2u, geom_.passes().size());
+  for (const auto& pass : geom_.passes())
+  {
+    ASSERT_EQ(1, pass.instances.numElements);
+    expectColor(state_.defaultColor, instance(pass, 0));
+  }
+}
+
+TEST_F(GlyphGeomTests, GlyphsBuiltWithoutInstancingStayTessellated)
+{
+  // ShowFieldGlyphs turns instancing off for transparent glyphs, which are depth sorted per triangle
+  GlyphGeom glyphs;
+  glyphs.setInstanced(false);
+  glyphs.addSphere(Point(1, 2, 3), 0.5, 5, ColorRGB(1, 0, 0));
+  glyphs.addArrow(Point(0, 0, 0), Point(0, 0, 2), 0.5, 5, ColorRGB(0, 0, 1), ColorRGB(0, 0, 1));
+  build(glyphs, ColorScheme::COLOR_IN_SITU, true);
+
+  ASSERT_EQ(1u, geom_.passes().size());
+  const auto& pass = geom_.passes().front();
+  EXPECT_EQ(RenderType::RENDER_VBO_IBO, pass.renderType);
+  EXPECT_EQ(0, pass.instances.numElements);
+  EXPECT_NE("Shaders/DirPhongInstanced", pass.programName);
+
+  int64_t numVBOElements = 0;
+  std::vector<Vector> points, normals;
+  std::vector<ColorRGB> colors;
+  std::vector<uint32_t> indices;
+  glyphs.getBufferInfo(numVBOElements, points, normals, colors, indices);
+  EXPECT_GT(points.size(), 20u);
+  EXPECT_EQ(points.size(), colors.size());
+}
+
+TEST_F(GlyphGeomTests, InstancedArrowsAndCylindersUseTheFirstColorOnly)
+{
+  // setInstanced documents this: an instance carries a single color, so color2 is dropped
+  const ColorRGB color1(1, 0, 0), color2(0, 0, 1);
+  GlyphGeom glyphs;
+  glyphs.setInstanced(true);
+  glyphs.addArrow(Point(0, 0, 0), Point(0, 0, 2), 0.5, 5, color1, color2);
+  glyphs.addCylinder(Point(0, 0, 0), Point(0, 2, 0), 0.5, 5, color1, color2);
+  build(glyphs, ColorScheme::COLOR_MAP);
+
+  ASSERT_EQ(2u, geom_.passes().size());
+  for (const auto& pass : geom_.passes())
+  {
+    ASSERT_EQ(1, pass.instances.numElements) << pass.passName;
+    expectColor(color1, instance(pass, 0));
+  }
+}
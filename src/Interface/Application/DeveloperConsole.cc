@@ -39,6 +39,7 @@ DeveloperConsole::DeveloperConsole(QWidget* parent /* = 0 */) : QDockWidget(pare
   connect(parallelExecutionRadioButton_, SIGNAL(clicked()), this, SLOT(executorButtonClicked()));
   connect(improvedParallelExecutionRadioButton_, SIGNAL(clicked()), this, SLOT(executorButtonClicked()));
   connect(globalPortCacheButton_, SIGNAL(stateChanged(int)), this, SLOT(globalPortCacheButtonClicked()));
+  connect(globalContentHashButton_, SIGNAL(stateChanged(int)), this, SLOT(globalContentHashButtonClicked()));
 }
 
 void DeveloperConsole::updateNetworkViewLog(const QString& s)
@@ -60,3 +61,8 @@ void DeveloperConsole::globalPortCacheButtonClicked()
 {
   Q_EMIT globalPortCachingChanged(globalPortCacheButton_->isChecked());
 }
+
+void DeveloperConsole::globalContentHashButtonClicked()
+{
+  Q_EMIT globalContentHashingChanged(globalContentHashButton_->isChecked());
+}
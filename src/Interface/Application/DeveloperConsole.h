@@ -46,9 +46,11 @@ public:
 public Q_SLOTS:
   void executorButtonClicked();
   void globalPortCacheButtonClicked();
+  void globalContentHashButtonClicked();
 Q_SIGNALS:
   void executorChosen(int type);
   void globalPortCachingChanged(bool enable);
+  void globalContentHashingChanged(bool enable);
   void moduleHeightAdjusted(int delta);
   void moduleWidthAdjusted(int delta);
 };
@@ -31,6 +31,8 @@
 #include <boost/lambda/lambda.hpp>
 #include <boost/regex.hpp>
 #include <Dataflow/Network/Port.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/DataflowInterfaces.h>
 #include <Interface/Application/Port.h>
 #include <Interface/Application/Connection.h>
 #include <Interface/Application/PositionProvider.h>
@@ -120,22 +122,15 @@ namespace SCIRun {
       explicit PortActionsMenu(PortWidget* parent) :
         QMenu("Actions", parent), parent_(parent)
       {
-#if SCIRUN4_CODE_TO_BE_ENABLED_LATER
-        QList<QAction*> actions;
         if (!parent->isInput())
         {
-          auto pc = new QAction("Port Caching", parent);
+          auto pc = new QAction("Keep Data In Memory", parent);
+          pc->setToolTip("Exempt this port's data from the port cache memory budget");
           pc->setCheckable(true);
           connect(pc, SIGNAL(triggered(bool)), parent, SLOT(portCachingChanged(bool)));
-          //TODO for now: disable
-          pc->setEnabled(false);
-          //TODO:
-          //pc->setChecked(parent->getCached())...or something
-          actions.append(pc);
-          actions.append(separatorAction(parent));
+          addAction(pc);
+          addSeparator();
         }
-        addActions(actions);
-#endif
 
         base_ = new QMenu("Connect Module", parent);
         compatibleModuleActions_ = fillConnectToEmptyPortMenu(base_, Application::Instance().controller()->getAllAvailableModuleDescriptions(), parent);
@@ -727,8 +722,10 @@ void PortWidget::setHighlight(bool on, bool individual)
 
 void PortWidget::portCachingChanged(bool checked)
 {
-  //TODO
-  std::cout << "Port " << moduleId_.id_ << "::" << name().toStdString() << " Caching turned " << (checked ? "on." : "off.") << std::endl;
+  auto network = Application::Instance().controller()->getNetwork();
+  auto module = network ? network->lookupModule(moduleId_) : nullptr;
+  if (module && module->hasOutputPort(portId_))
+    module->getOutputPort(portId_)->source()->setCachePinned(checked);
 }
 
 void PortWidget::connectNewModule()
@@ -269,6 +269,7 @@ private Q_SLOTS:
   void setExecutor(int type);
   void setFocusOnFilterLine();
   void setGlobalPortCaching(bool enable);
+  void setGlobalContentHashing(bool enable);
   void setSelectMode(bool toggle);
   void showClipboardHelp();
   void showKeyboardShortcutsDialog();
@@ -361,6 +361,8 @@ void SCIRunMainWindow::setupDevConsole()
   actionDevConsole_->setShortcut(QKeySequence("`"));
   connect(devConsole_, SIGNAL(executorChosen(int)), this, SLOT(setExecutor(int)));
   connect(devConsole_, SIGNAL(globalPortCachingChanged(bool)), this, SLOT(setGlobalPortCaching(bool)));
+  devConsole_->globalContentHashButton_->setChecked(SimpleSink::globalContentHashFlag());
+  connect(devConsole_, SIGNAL(globalContentHashingChanged(bool)), this, SLOT(setGlobalContentHashing(bool)));
   //NetworkEditor::setViewUpdateFunc([this](const QString& s) { devConsole_->updateNetworkViewLog(s); });
 }
 
@@ -267,6 +267,12 @@ void SCIRunMainWindow::setGlobalPortCaching(bool enable)
   SimpleSink::setGlobalPortCachingFlag(enable);
 }
 
+void SCIRunMainWindow::setGlobalContentHashing(bool enable)
+{
+  LOG_DEBUG("Global content hashing flag set to {}", (enable ? "true" : "false"));
+  SimpleSink::setGlobalContentHashFlag(enable);
+}
+
 void SCIRunMainWindow::readDefaultNotePosition(int index)
 {
   Q_EMIT defaultNotePositionChanged(defaultNotePositionGetter_->position()); //TODO: unit test.
@@ -75,6 +75,7 @@
 #include <Interface/Modules/Fields/ProjectPointsOntoMeshDialog.h>
 #include <Interface/Modules/Fields/CalculateDistanceToFieldDialog.h>
 #include <Interface/Modules/Fields/CalculateDistanceToFieldBoundaryDialog.h>
+#include <Interface/Modules/Fields/CalculateSignedDistanceToFieldDialog.h>
 #include <Interface/Modules/Fields/MapFieldDataOntoElemsDialog.h>
 #include <Interface/Modules/Fields/MapFieldDataOntoNodesDialog.h>
 #include <Interface/Modules/Fields/MapFieldDataFromSourceToDestinationDialog.h>
@@ -169,6 +170,7 @@ void ModuleDialogFactory::addDialogsToMakerMap1()
     ADD_MODULE_DIALOG(ProjectPointsOntoMesh, ProjectPointsOntoMeshDialog)
     ADD_MODULE_DIALOG(CalculateDistanceToField, CalculateDistanceToFieldDialog)
     ADD_MODULE_DIALOG(CalculateDistanceToFieldBoundary, CalculateDistanceToFieldBoundaryDialog)
+    ADD_MODULE_DIALOG(CalculateSignedDistanceToField, CalculateSignedDistanceToFieldDialog)
 #if WITH_TETGEN
     ADD_MODULE_DIALOG(InterfaceWithTetGen, InterfaceWithTetGenDialog)
 #endif
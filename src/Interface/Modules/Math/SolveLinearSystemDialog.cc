@@ -50,6 +50,7 @@ namespace SCIRun {
       SolveLinearSystemDialogImpl()
       {
         solverNameLookup_.insert(StringPair("Conjugate Gradient (SCI)", "cg"));
+        solverNameLookup_.insert(StringPair("Pipelined Conjugate Gradient (SCI)", "pipecg"));
         solverNameLookup_.insert(StringPair("BiConjugate Gradient (SCI)", "bicg"));
         solverNameLookup_.insert(StringPair("Jacobi (SCI)", "jacobi"));
         solverNameLookup_.insert(StringPair("MINRES (SCI)", "minres"));
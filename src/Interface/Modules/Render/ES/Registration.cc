@@ -35,6 +35,8 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/SRRenderState.h"
 #include "comp/RenderList.h"
+#include "comp/RenderInstances.h"
+#include "comp/RenderLOD.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/StaticClippingPlanes.h"
 #include "comp/LightingUniforms.h"
@@ -64,6 +66,8 @@ void rendererRegisterAll(spire::Acorn& core)
   core.registerComponent<RenderBasicGeom>();
   core.registerComponent<SRRenderState>();
   core.registerComponent<RenderList>();
+  core.registerComponent<RenderInstances>();
+  core.registerComponent<RenderLOD>();
   core.registerComponent<Graphics::Datatypes::SpireSubPass>();
 }
 
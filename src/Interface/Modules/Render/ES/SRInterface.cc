@@ -60,6 +60,8 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/SRRenderState.h"
 #include "comp/RenderList.h"
+#include "comp/RenderInstances.h"
+#include "comp/RenderLOD.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/LightingUniforms.h"
 #include "comp/ClippingPlaneUniforms.h"
@@ -1032,6 +1034,28 @@ namespace SCIRun {
                 RENDERER_LOG("add texture");
                 addTextToEntity(entityID, pass.text);
               }
+              else if (pass.renderType == RenderType::RENDER_INSTANCED)
+              {
+                RENDERER_LOG("Draw the prototype mesh once per instance. The instance buffer is "
+                  "the entity's second VBO, which also keeps it alive through garbage collection.");
+                const auto& instanceVBO = pass.instances;
+                std::vector<std::tuple<std::string, size_t, bool>> attributeData;
+                for (const auto& attribData : instanceVBO.attributes)
+                {
+                  attributeData.push_back(std::make_tuple(attribData.name, attribData.sizeInBytes, attribData.normalize));
+                }
+                vboMan->addInMemoryVBO(instanceVBO.data->getBuffer(), instanceVBO.data->getBufferSize(),
+                  attributeData, instanceVBO.name);
+
+                addVBOToEntity(entityID, pass.vboName);
+                addVBOToEntity(entityID, instanceVBO.name);
+                addIBOToEntity(entityID, pass.iboName);
+
+                RenderInstances instances;
+                instances.data = instanceVBO.data;
+                instances.numInstances = instanceVBO.numElements;
+                mCore.addComponent(entityID, instances);
+              }
               else
               {
                 RENDERER_LOG("We will be constructing a render list from the VBO and IBO.");
@@ -1092,6 +1116,19 @@ namespace SCIRun {
               }
               mCore.addComponent(entityID, trafo);
 
+              if (pass.hasLevelOfDetail() && pass.vbo.boundingBox.valid())
+              {
+                RENDERER_LOG("Only draw this level of detail while the object has the matching size on screen.");
+                const auto& bbox = pass.vbo.boundingBox;
+                auto center = bbox.center();
+                RenderLOD lod;
+                lod.center = glm::vec3(center.x(), center.y(), center.z());
+                lod.radius = static_cast<float>(0.5 * bbox.diagonal().length());
+                lod.minSize = pass.lodMinSize;
+                lod.maxSize = pass.lodMaxSize;
+                mCore.addComponent(entityID, lod);
+              }
+
               RENDERER_LOG("Add lighting uniform checks");
               LightingUniforms lightUniforms;
               mCore.addComponent(entityID, lightUniforms);
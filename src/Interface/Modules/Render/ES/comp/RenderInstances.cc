@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <cstring>
+
+#include <gl-platform/GLPlatform.hpp>
+#include <es-render/VBOMan.hpp>
+
+#include "RenderInstances.h"
+
+// Instanced drawing entered core OpenGL in 3.3. Legacy OSX contexts only
+// expose it through the ARB extensions, and ES 2 does not have it at all.
+#if defined(USE_OPENGL_ES) || defined(EMSCRIPTEN)
+  #define SR_NO_INSTANCING
+#elif defined(GL_PLATFORM_USING_OSX)
+  #define SR_VERTEX_ATTRIB_DIVISOR glVertexAttribDivisorARB
+  #define SR_DRAW_ELEMENTS_INSTANCED glDrawElementsInstancedARB
+#else
+  #define SR_VERTEX_ATTRIB_DIVISOR glVertexAttribDivisor
+  #define SR_DRAW_ELEMENTS_INSTANCED glDrawElementsInstanced
+#endif
+
+namespace SCIRun {
+namespace Render {
+
+RenderInstances::RenderInstances() :
+  numInstances(0),
+  mMeshAttribSize(-1),
+  mMeshStride(0),
+  mInstanceAttribSize(-1),
+  mInstanceStride(0)
+{
+}
+
+bool RenderInstances::hardwareInstancing()
+{
+#ifdef SR_NO_INSTANCING
+  return false;
+#else
+  static const bool supported = []()
+  {
+    int major = 0, minor = 0;
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (version && std::sscanf(version, "%d.%d", &major, &minor) == 2 &&
+        (major > 3 || (major == 3 && minor >= 3)))
+    {
+      return true;
+    }
+    const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    return extensions &&
+      std::strstr(extensions, "GL_ARB_instanced_arrays") &&
+      std::strstr(extensions, "GL_ARB_draw_instanced");
+  }();
+  return supported;
+#endif
+}
+
+void RenderInstances::setup(GLuint meshVBO, GLuint instanceVBO, GLuint shaderID,
+                            const ren::StaticVBOMan& vboMan)
+{
+  std::vector<spire::ShaderAttribute> attribs = spire::getProgramAttributes(shaderID);
+  spire::sortAttributesAlphabetically(attribs);
+
+  // The shader's attributes are split between the two buffers, so each one
+  // only needs to satisfy part of them.
+  std::vector<spire::ShaderAttribute> meshAttribs =
+    vboMan.instance_->getVBOAttributes(meshVBO);
+  std::vector<spire::ShaderAttribute> instanceAttribs =
+    vboMan.instance_->getVBOAttributes(instanceVBO);
+
+  if (meshAttribs.size() + instanceAttribs.size() < attribs.size())
+  {
+    std::cerr << "RenderInstances: Unable to satisfy shader! Not enough attributes." << std::endl;
+  }
+
+  std::tuple<size_t, size_t> sizes = spire::buildPreappliedAttrib(
+    &meshAttribs[0], meshAttribs.size(), &attribs[0], attribs.size(),
+    mMeshAttribs, MaxNumAttributes);
+  mMeshAttribSize = static_cast<int>(std::get<0>(sizes));
+  mMeshStride = std::get<1>(sizes);
+
+  sizes = spire::buildPreappliedAttrib(
+    &instanceAttribs[0], instanceAttribs.size(), &attribs[0], attribs.size(),
+    mInstanceAttribs, MaxNumAttributes);
+  mInstanceAttribSize = static_cast<int>(std::get<0>(sizes));
+  mInstanceStride = std::get<1>(sizes);
+}
+
+void RenderInstances::draw(GLuint meshVBO, GLuint instanceVBO, const ren::IBO& ibo) const
+{
+  if (!isSetup())
+  {
+    std::cerr << "Attempted to draw uninitialized instances!" << std::endl;
+    return;
+  }
+
+  GL(glBindBuffer(GL_ARRAY_BUFFER, meshVBO));
+  spire::bindPreappliedAttrib(mMeshAttribs, static_cast<size_t>(mMeshAttribSize), mMeshStride);
+
+#ifndef SR_NO_INSTANCING
+  if (hardwareInstancing())
+  {
+    GL(glBindBuffer(GL_ARRAY_BUFFER, instanceVBO));
+    spire::bindPreappliedAttrib(mInstanceAttribs, static_cast<size_t>(mInstanceAttribSize),
+                                mInstanceStride);
+    for (int i = 0; i < mInstanceAttribSize; ++i)
+    {
+      GL(SR_VERTEX_ATTRIB_DIVISOR(static_cast<GLuint>(mInstanceAttribs[i].attribLoc), 1));
+    }
+
+    GL(SR_DRAW_ELEMENTS_INSTANCED(ibo.primMode, ibo.numPrims, ibo.primType, 0,
+                                  static_cast<GLsizei>(numInstances)));
+
+    for (int i = 0; i < mInstanceAttribSize; ++i)
+    {
+      GL(SR_VERTEX_ATTRIB_DIVISOR(static_cast<GLuint>(mInstanceAttribs[i].attribLoc), 0));
+    }
+    spire::unbindPreappliedAttrib(mInstanceAttribs, static_cast<size_t>(mInstanceAttribSize));
+  }
+  else
+#endif
+  {
+    // Without instanced arrays the instance attributes stay disabled and are
+    // fed to every vertex of the prototype as constants, one draw per instance.
+    const char* instance = data ? data->getBuffer() : nullptr;
+    for (int64_t i = 0; instance && i < numInstances; ++i, instance += mInstanceStride)
+    {
+      for (int a = 0; a < mInstanceAttribSize; ++a)
+      {
+        const spire::ShaderAttributeApplied& attrib = mInstanceAttribs[a];
+        const GLfloat* values = reinterpret_cast<const GLfloat*>(instance + attrib.offset);
+        GLuint loc = static_cast<GLuint>(attrib.attribLoc);
+        switch (attrib.numComps)
+        {
+          case 1: GL(glVertexAttrib1fv(loc, values)); break;
+          case 2: GL(glVertexAttrib2fv(loc, values)); break;
+          case 3: GL(glVertexAttrib3fv(loc, values)); break;
+          default: GL(glVertexAttrib4fv(loc, values)); break;
+        }
+      }
+      GL(glDrawElements(ibo.primMode, ibo.numPrims, ibo.primType, 0));
+    }
+  }
+
+  spire::unbindPreappliedAttrib(mMeshAttribs, static_cast<size_t>(mMeshAttribSize));
+  GL(glBindBuffer(GL_ARRAY_BUFFER, meshVBO));
+}
+
+} // namespace Render
+} // namespace SCIRun
@@ -0,0 +1,58 @@
+#ifndef INTERFACE_MODULES_RENDER_ES_COMP_RENDER_INSTANCES_H
+#define INTERFACE_MODULES_RENDER_ES_COMP_RENDER_INSTANCES_H
+
+#include <gl-shaders/GLShader.hpp>
+#include <es-cereal/ComponentSerialize.hpp>
+#include <es-render/comp/IBO.hpp>
+#include <es-render/comp/StaticVBOMan.hpp>
+#include <var-buffer/VarBuffer.hpp>
+
+namespace SCIRun {
+namespace Render {
+
+// Draws the entity's first VBO (the prototype mesh) once for every element of
+// its second VBO, whose attributes advance per instance instead of per vertex.
+struct RenderInstances
+{
+  // -- Data --
+  static const int MaxNumAttributes = 5;
+
+  std::shared_ptr<spire::VarBuffer> data; ///< Instance attributes, kept for the fallback path.
+  int64_t numInstances;
+
+  // -- Functions --
+  RenderInstances();
+
+  static const char* getName() {return "RenderInstances";}
+
+  /// True when the context can advance attributes per instance (GL 3.3 or the
+  /// ARB instanced array extensions). Otherwise each instance is drawn with
+  /// its attributes set as constants.
+  static bool hardwareInstancing();
+
+  bool isSetup() const {return mMeshAttribSize != -1;}
+
+  /// Matches the shader's attributes against the attributes of both buffers.
+  void setup(GLuint meshVBO, GLuint instanceVBO, GLuint shaderID, const ren::StaticVBOMan& vboMan);
+  void draw(GLuint meshVBO, GLuint instanceVBO, const ren::IBO& ibo) const;
+
+  bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
+  {
+    // Shouldn't need to serialize these values. They are context specific.
+    return true;
+  }
+
+private:
+  int     mMeshAttribSize;
+  size_t  mMeshStride;
+  int     mInstanceAttribSize;
+  size_t  mInstanceStride;
+
+  spire::ShaderAttributeApplied mMeshAttribs[MaxNumAttributes];
+  spire::ShaderAttributeApplied mInstanceAttribs[MaxNumAttributes];
+};
+
+} // namespace Render
+} // namespace SCIRun
+
+#endif
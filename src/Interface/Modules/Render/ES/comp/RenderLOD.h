@@ -0,0 +1,61 @@
+#ifndef INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LOD_H
+#define INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LOD_H
+
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <es-cereal/ComponentSerialize.hpp>
+#include <es-general/comp/StaticCamera.hpp>
+
+namespace SCIRun {
+namespace Render {
+
+// Marks the entity as one level of detail of an object. It is only drawn while
+// the object's bounding sphere covers between minSize and maxSize pixels.
+struct RenderLOD
+{
+  // -- Data --
+  glm::vec3 center;
+  float radius;
+  float minSize;
+  float maxSize;
+
+  // -- Functions --
+  RenderLOD() : center(0.0f), radius(0.0f), minSize(0.0f), maxSize(0.0f) {}
+
+  static const char* getName() {return "RenderLOD";}
+
+  /// Diameter of the bounding sphere on screen, in pixels.
+  float projectedSize(const glm::mat4& objectToWorld, const gen::StaticCameraData& camera) const
+  {
+    glm::mat4 objectToView = camera.worldToView * objectToWorld;
+    float scale = std::max(glm::length(glm::vec3(objectToView[0])),
+      std::max(glm::length(glm::vec3(objectToView[1])), glm::length(glm::vec3(objectToView[2]))));
+    float height = camera.aspect > 0.0f ? camera.winWidth / camera.aspect : camera.winWidth;
+    float size = radius * scale * camera.projection[1][1] * height;
+
+    // Perspective projections shrink the sphere with its distance.
+    if (camera.projection[3][3] == 0.0f)
+    {
+      glm::vec4 viewCenter = objectToView * glm::vec4(center, 1.0f);
+      size /= std::max(-viewCenter.z, camera.znear);
+    }
+    return size;
+  }
+
+  bool isVisible(const glm::mat4& objectToWorld, const gen::StaticCameraData& camera) const
+  {
+    float size = projectedSize(objectToWorld, camera);
+    return size >= minSize && size < maxSize;
+  }
+
+  bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
+  {
+    // Rebuilt from the geometry object whenever it is added.
+    return true;
+  }
+};
+
+} // namespace Render
+} // namespace SCIRun
+
+#endif
@@ -0,0 +1,67 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+// Uniforms
+uniform mat4    uProjIVObject;      // Projection transform * Inverse View
+uniform mat4    uObject;            // Object -> World
+uniform mat4    uInverseView;       // world -> view
+
+// Attributes of the prototype glyph mesh.
+attribute vec3  aPos;
+attribute vec3  aNormal;
+
+// Per-instance attributes. The three axis columns map the prototype onto the
+// glyph, so they carry its orientation and (possibly anisotropic) scale.
+attribute vec3  aInstancePos;
+attribute vec3  aInstanceAxisX;
+attribute vec3  aInstanceAxisY;
+attribute vec3  aInstanceAxisZ;
+attribute vec4  aInstanceColor;
+
+// Outputs to the fragment shader.
+varying vec3    vNormal;
+varying vec4    vColor;
+varying vec4    vPos;//for clipping plane calc
+varying vec4    vFogCoord;// for fog calculation
+
+void main( void )
+{
+  mat3 axes = mat3(aInstanceAxisX, aInstanceAxisY, aInstanceAxisZ);
+  // Normals transform with the cofactor matrix, which stays well defined for
+  // flat glyphs where the inverse transpose does not.
+  mat3 cofactor = mat3(cross(aInstanceAxisY, aInstanceAxisZ),
+                       cross(aInstanceAxisZ, aInstanceAxisX),
+                       cross(aInstanceAxisX, aInstanceAxisY));
+  vec3 pos = axes * aPos + aInstancePos;
+
+  vNormal  = normalize(vec3(uObject * vec4(cofactor * aNormal, 0.0)));
+  gl_Position = uProjIVObject * vec4(pos, 1.0);
+  vColor = aInstanceColor;
+  vPos = vec4(pos, 1.0);
+  vFogCoord = uInverseView * vPos;
+}
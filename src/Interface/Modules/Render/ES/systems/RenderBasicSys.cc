@@ -53,6 +53,8 @@
 #include "../comp/RenderBasicGeom.h"
 #include "../comp/SRRenderState.h"
 #include "../comp/RenderList.h"
+#include "../comp/RenderInstances.h"
+#include "../comp/RenderLOD.h"
 #include "../comp/StaticWorldLight.h"
 #include "../comp/StaticClippingPlanes.h"
 #include "../comp/LightingUniforms.h"
@@ -69,6 +71,8 @@ class RenderBasicSys :
                              RenderBasicGeom,   // TAG class
                              SRRenderState,
                              RenderList,
+                             RenderInstances,
+                             RenderLOD,
                              LightingUniforms,
                              ClippingPlaneUniforms,
                              gen::Transform,
@@ -95,6 +99,8 @@ public:
   bool isComponentOptional(uint64_t type) override
   {
     return spire::OptionalComponents<RenderList,
+                                  RenderInstances,
+                                  RenderLOD,
                                   ren::GLState,
                                   ren::StaticGLState,
                                   ren::CommonUniforms,
@@ -111,6 +117,8 @@ public:
       const spire::ComponentGroup<RenderBasicGeom>& geom,
       const spire::ComponentGroup<SRRenderState>& srstate,
       const spire::ComponentGroup<RenderList>& rlist,
+      const spire::ComponentGroup<RenderInstances>& instances,
+      const spire::ComponentGroup<RenderLOD>& lod,
       const spire::ComponentGroup<LightingUniforms>& lightUniforms,
       const spire::ComponentGroup<ClippingPlaneUniforms>& clippingPlaneUniforms,
       const spire::ComponentGroup<gen::Transform>& trafo,
@@ -144,20 +152,36 @@ public:
       return;
     }
 
+    // Another level of detail of the object is drawn at this size.
+    if (lod.size() > 0 && !lod.front().isVisible(trafo.front().transform, camera.front().data))
+    {
+      return;
+    }
+
     GLuint iboID = ibo.front().glid;
 
     // Setup *everything*. We don't want to enter multiple conditional
     // statements if we can avoid it. So we assume everything has not been
     // setup (including uniforms) if the simple geom hasn't been setup.
-    if (!geom.front().attribs.isSetup())
+    // Instanced geometry carries its attributes in the instances component.
+    bool isSetup = instances.size() > 0 ? instances.front().isSetup() : geom.front().attribs.isSetup();
+    if (!isSetup)
     {
       // We use const cast to get around a 'modify' call for 2 reasons:
       // 1) This is populating system specific GL data. It has no bearing on the
       //    actual simulation state.
       // 2) It is more correct than issuing a modify call. The data is used
       //    directly below to render geometry.
-      const_cast<RenderBasicGeom&>(geom.front()).attribs.setup(
-          vbo.front().glid, shader.front().glid, vboMan.front());
+      if (instances.size() > 0)
+      {
+        const_cast<RenderInstances&>(instances.front()).setup(
+            vbo.front().glid, vbo.back().glid, shader.front().glid, vboMan.front());
+      }
+      else
+      {
+        const_cast<RenderBasicGeom&>(geom.front()).attribs.setup(
+            vbo.front().glid, shader.front().glid, vboMan.front());
+      }
 
       /// \todo Optimize by pulling uniforms only once.
       if (commonUniforms.size() > 0)
@@ -249,9 +273,16 @@ public:
       GL(glBindTexture(tex.textureType, tex.glid));
     }
 
-    geom.front().attribs.bind();
+    if (instances.size() == 0)
+    {
+      geom.front().attribs.bind();
+    }
 
-    if (rlist.size() > 0)
+    if (instances.size() > 0)
+    {
+      instances.front().draw(vbo.front().glid, vbo.back().glid, ibo.front());
+    }
+    else if (rlist.size() > 0)
     {
       glm::mat4 rlistTrafo = trafo.front().transform;
 
@@ -384,7 +415,10 @@ public:
       GL(glBindTexture(tex.textureType, 0));
     }
 
-    geom.front().attribs.unbind();
+    if (instances.size() == 0)
+    {
+      geom.front().attribs.unbind();
+    }
 
     // Reapply the default state here -- only do this if static state is
     // present.
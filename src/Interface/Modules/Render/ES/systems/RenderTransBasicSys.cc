@@ -54,6 +54,7 @@
 #include "../comp/RenderBasicGeom.h"
 #include "../comp/SRRenderState.h"
 #include "../comp/RenderList.h"
+#include "../comp/RenderLOD.h"
 #include "../comp/StaticWorldLight.h"
 #include "../comp/StaticClippingPlanes.h"
 #include "../comp/LightingUniforms.h"
@@ -74,6 +75,7 @@ class RenderBasicSysTrans :
                              RenderBasicGeom,   // TAG class
                              SRRenderState,
                              RenderList,
+                             RenderLOD,
                              LightingUniforms,
                              ClippingPlaneUniforms,
                              gen::Transform,
@@ -102,6 +104,7 @@ public:
   bool isComponentOptional(uint64_t type) override
   {
     return spire::OptionalComponents<RenderList,
+                                  RenderLOD,
                                   ren::GLState,
                                   ren::StaticGLState,
                                   ren::CommonUniforms,
@@ -217,6 +220,7 @@ private:
       const spire::ComponentGroup<RenderBasicGeom>& geom,
       const spire::ComponentGroup<SRRenderState>& srstate,
       const spire::ComponentGroup<RenderList>& rlist,
+      const spire::ComponentGroup<RenderLOD>& lod,
       const spire::ComponentGroup<LightingUniforms>& lightUniforms,
       const spire::ComponentGroup<ClippingPlaneUniforms>& clippingPlaneUniforms,
       const spire::ComponentGroup<gen::Transform>& trafo,
@@ -258,6 +262,12 @@ private:
       return;
     }
 
+    // Another level of detail of the object is drawn at this size.
+    if (lod.size() > 0 && !lod.front().isVisible(trafo.front().transform, camera.front().data))
+    {
+      return;
+    }
+
     bool drawLines = (ibo.front().primMode == static_cast<int>(SpireIBO::PRIMITIVE::LINES));
     GLuint iboID = ibo.front().glid;
 
@@ -65,6 +65,7 @@ ShowFieldDialog::ShowFieldDialog(const std::string& name, ModuleStateHandle stat
   addCheckBoxManager(textAlwaysVisibleCheckBox_, ShowField::TextAlwaysVisible);
   addCheckBoxManager(renderIndicesLocationsCheckBox_, ShowField::RenderAsLocation);
   addCheckBoxManager(useFaceNormalsCheckBox_, ShowField::UseFaceNormals);
+  addCheckBoxManager(shareFaceVerticesCheckBox_, ShowField::ShareFaceVertices);
   addDoubleSpinBoxManager(transparencyDoubleSpinBox_, ShowField::FaceTransparencyValue);
   addDoubleSpinBoxManager(nodeTransparencyDoubleSpinBox_, ShowField::NodeTransparencyValue);
   addDoubleSpinBoxManager(edgeTransparencyDoubleSpinBox_, ShowField::EdgeTransparencyValue);
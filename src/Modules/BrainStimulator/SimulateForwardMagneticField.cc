@@ -28,6 +28,7 @@
 
 #include <Modules/BrainStimulator/SimulateForwardMagneticField.h>
 #include <Core/Algorithms/BrainStimulator/SimulateForwardMagneticFieldAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/SourceOctree.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/DenseMatrix.h>
@@ -53,6 +54,8 @@ SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo
 
 void SimulateForwardMagneticField::setStateDefaults()
 {
+  setStateBoolFromAlgo(Parameters::UseTreeCode);
+  setStateDoubleFromAlgo(Parameters::TreeCodeTolerance);
 }
 
 void SimulateForwardMagneticField::execute()
@@ -64,6 +67,8 @@ void SimulateForwardMagneticField::execute()
 
   if (needToExecute())
   {
+    setAlgoBoolFromState(Parameters::UseTreeCode);
+    setAlgoDoubleFromState(Parameters::TreeCodeTolerance);
      auto output = algo().run(make_input((ElectricField, EField)(ConductivityTensor, CondTensor)(DipoleSources, Dipoles)(DetectorLocations, Detectors)));
     sendOutputFromAlgorithm(MagneticField, output);
     sendOutputFromAlgorithm(MagneticFieldMagnitudes, output);
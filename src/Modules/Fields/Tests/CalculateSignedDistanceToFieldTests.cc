@@ -76,6 +76,7 @@ TEST_F(CalculateSignedDistanceToFieldModuleTests, MakesAlgoDecisionBasedOnValueP
       Mock::AllowLeak(mockAlgo.get());
       //std::cout << "1ref count of algo ptr: " << mockAlgo.use_count() << std::endl;
       {
+        EXPECT_CALL(*mockAlgo, set(Parameters::UseFastSweeping, _));
         EXPECT_CALL(*mockAlgo, set(CalculateSignedDistanceFieldAlgo::OutputValueField, connected));
         //std::cout << "2ref count of algo ptr: " << mockAlgo.use_count() << std::endl;
         csdf->execute();
@@ -89,6 +90,7 @@ TEST_F(CalculateSignedDistanceToFieldModuleTests, MakesAlgoDecisionBasedOnValueP
         connectDummyOutputConnection(csdf, 1);
         connected = true;
         //std::cout << "6ref count of algo ptr: " << mockAlgo.use_count() << std::endl;
+        EXPECT_CALL(*mockAlgo, set(Parameters::UseFastSweeping, _));
         EXPECT_CALL(*mockAlgo, set(CalculateSignedDistanceFieldAlgo::OutputValueField, connected));
         //std::cout << "7ref count of algo ptr: " << mockAlgo.use_count() << std::endl;
         csdf->execute();
@@ -58,6 +58,7 @@ void CalculateDistanceToField::setStateDefaults()
   setStateDoubleFromAlgo(Parameters::TruncateDistance);
   setStateStringFromAlgoOption(Parameters::BasisType);
   setStateStringFromAlgoOption(Parameters::OutputFieldDatatype);
+  setStateBoolFromAlgo(Parameters::UseFastSweeping);
 }
 
 void
@@ -74,6 +75,7 @@ CalculateDistanceToField::execute()
     setAlgoDoubleFromState(Parameters::TruncateDistance);
     setAlgoOptionFromState(Parameters::BasisType);
     setAlgoOptionFromState(Parameters::OutputFieldDatatype);
+    setAlgoBoolFromState(Parameters::UseFastSweeping);
 
     auto inputs = make_input((InputField, input)(ObjectField, object));
 
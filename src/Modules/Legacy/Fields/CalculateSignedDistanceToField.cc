@@ -33,12 +33,13 @@
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Modules::Fields;
 
 CalculateSignedDistanceToField::CalculateSignedDistanceToField()
-  : Module(ModuleLookupInfo("CalculateSignedDistanceToField", "ChangeFieldData", "SCIRun"), false)
+  : Module(ModuleLookupInfo("CalculateSignedDistanceToField", "ChangeFieldData", "SCIRun"))
 {
   INITIALIZE_PORT(InputField);
   INITIALIZE_PORT(ObjectField);
@@ -46,6 +47,11 @@ CalculateSignedDistanceToField::CalculateSignedDistanceToField()
   INITIALIZE_PORT(ValueField);
 }
 
+void CalculateSignedDistanceToField::setStateDefaults()
+{
+  setStateBoolFromAlgo(Parameters::UseFastSweeping);
+}
+
 void CalculateSignedDistanceToField::execute()
 {
   FieldHandle input = getRequiredInput(InputField);
@@ -55,6 +61,8 @@ void CalculateSignedDistanceToField::execute()
 
   if (needToExecute())
   {
+    setAlgoBoolFromState(Parameters::UseFastSweeping);
+
     auto inputs = make_input((InputField, input)(ObjectField, object));
 
     algo().set(CalculateSignedDistanceFieldAlgo::OutputValueField, value_connected);
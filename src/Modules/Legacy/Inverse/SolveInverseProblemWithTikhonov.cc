@@ -68,6 +68,7 @@ void SolveInverseProblemWithTikhonov::setStateDefaults()
 {
 	setStateStringFromAlgo(Parameters::TikhonovImplementation);
 	setStateStringFromAlgoOption(Parameters::RegularizationMethod);
+	setStateStringFromAlgoOption(Parameters::LambdaCornerSearch);
 	setStateIntFromAlgo(Parameters::regularizationChoice);
 	setStateDoubleFromAlgo(Parameters::LambdaFromDirectEntry);
 	setStateDoubleFromAlgo(Parameters::LambdaMin);
@@ -99,6 +100,7 @@ void SolveInverseProblemWithTikhonov::execute()
     state->setValue( Parameters::TikhonovImplementation, std::string("standardTikhonov") );
     setAlgoStringFromState(Parameters::TikhonovImplementation);
     setAlgoOptionFromState(Parameters::RegularizationMethod);
+    setAlgoOptionFromState(Parameters::LambdaCornerSearch);
     setAlgoIntFromState(Parameters::regularizationChoice);
     setAlgoDoubleFromState(Parameters::LambdaFromDirectEntry);
     setAlgoDoubleFromState(Parameters::LambdaMin);
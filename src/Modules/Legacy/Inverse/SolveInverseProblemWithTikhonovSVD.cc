@@ -73,6 +73,7 @@ void SolveInverseProblemWithTikhonovSVD::setStateDefaults()
 {
 	setStateStringFromAlgo(Parameters::TikhonovImplementation);
 	setStateStringFromAlgoOption(Parameters::RegularizationMethod);
+	setStateStringFromAlgoOption(Parameters::LambdaCornerSearch);
 	setStateDoubleFromAlgo(Parameters::LambdaFromDirectEntry);
 	setStateDoubleFromAlgo(Parameters::LambdaMin);
 	setStateDoubleFromAlgo(Parameters::LambdaMax);
@@ -106,6 +107,7 @@ void SolveInverseProblemWithTikhonovSVD::execute()
 		state->setValue( Parameters::TikhonovImplementation, std::string("TikhonovSVD") );
 		setAlgoStringFromState(Parameters::TikhonovImplementation);
 		setAlgoOptionFromState(Parameters::RegularizationMethod);
+		setAlgoOptionFromState(Parameters::LambdaCornerSearch);
 		setAlgoDoubleFromState(Parameters::LambdaFromDirectEntry);
 		setAlgoDoubleFromState(Parameters::LambdaMin);
 		setAlgoDoubleFromState(Parameters::LambdaMax);
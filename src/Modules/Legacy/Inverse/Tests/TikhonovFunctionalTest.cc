@@ -599,3 +599,86 @@ TEST_F(TikhonovFunctionalTest, loadIDNonSquaredMeasurementReguWithSquareOptionWr
     EXPECT_THROW(tikAlgImp->execute(), SCIRun::Core::DimensionMismatch);
 }
 */
+
+namespace
+{
+  // forward matrix with singular values decaying over six decades, and noisy data from a smooth source
+  void makeIllPosedProblem(int size, DenseMatrixHandle& forward, DenseMatrixHandle& measured)
+  {
+    DenseMatrix basis(size, size);
+    for (int i = 0; i < size; ++i)
+      for (int j = 0; j < size; ++j)
+        basis(i, j) = std::cos(M_PI * (i + 0.5) * j / size) * (j == 0 ? std::sqrt(1.0 / size) : std::sqrt(2.0 / size));
+
+    DenseColumnMatrix singularValues(size);
+    for (int i = 0; i < size; ++i)
+      singularValues[i] = std::pow(10.0, -6.0 * i / size);
+
+    forward.reset(new DenseMatrix(basis * singularValues.asDiagonal() * basis.transpose()));
+
+    DenseColumnMatrix source(size);
+    for (int i = 0; i < size; ++i)
+      source[i] = std::sin(M_PI * i / size);
+    DenseColumnMatrix noise(size);
+    for (int i = 0; i < size; ++i)
+      noise[i] = 1e-3 * std::sin(12.9898 * i * i + 78.233);
+
+    measured.reset(new DenseMatrix((*forward) * source + noise));
+  }
+}
+
+TEST(TikhonovAlgorithmTest, LambdaSweepFactorizationMatchesDirectSolve)
+{
+  DenseMatrixHandle forward, measured;
+  makeIllPosedProblem(40, forward, measured);
+  DenseMatrix identity = DenseMatrix::Identity(40, 40);
+
+  SolveInverseProblemWithStandardTikhonovImpl impl(*forward, *measured, identity, identity, TikhonovAlgoAbstractBase::automatic,
+    TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  TikhonovImpl& base = impl;
+
+  std::vector<DenseMatrix> direct;
+  for (double lambda : { 1e-5, 1e-3, 1e-1 })
+    direct.push_back(base.computeInverseSolution(lambda, false));
+
+  base.prepareLambdaSweep();
+
+  int i = 0;
+  for (double lambda : { 1e-5, 1e-3, 1e-1 })
+  {
+    auto swept = base.computeInverseSolution(lambda, false);
+    EXPECT_LT((swept - direct[i]).norm(), 1e-6 * direct[i].norm());
+    ++i;
+  }
+}
+
+TEST(TikhonovAlgorithmTest, GoldenSectionCornerAgreesWithGridCorner)
+{
+  DenseMatrixHandle forward, measured;
+  makeIllPosedProblem(60, forward, measured);
+  MatrixHandle identity(new DenseMatrix(DenseMatrix::Identity(60, 60)));
+
+  TikhonovAlgoAbstractBase algo;
+  algo.set(Parameters::TikhonovImplementation, std::string("standardTikhonov"));
+  algo.setOption(Parameters::RegularizationMethod, "lcurve");
+  algo.set(Parameters::LambdaMin, 1e-6);
+  algo.set(Parameters::LambdaMax, 1.0);
+  algo.set(Parameters::LambdaNum, 200);
+
+  AlgorithmInput input;
+  input[TikhonovAlgoAbstractBase::ForwardMatrix] = forward;
+  input[TikhonovAlgoAbstractBase::MeasuredPotentials] = measured;
+  input[TikhonovAlgoAbstractBase::WeightingInSourceSpace] = identity;
+  input[TikhonovAlgoAbstractBase::WeightingInSensorSpace] = identity;
+
+  auto grid = algo.run(input);
+  auto gridLambda = grid.get<DenseMatrix>(TikhonovAlgoAbstractBase::RegularizationParameter)->get(0, 0);
+
+  algo.setOption(Parameters::LambdaCornerSearch, "golden");
+  auto golden = algo.run(input);
+  auto goldenLambda = golden.get<DenseMatrix>(TikhonovAlgoAbstractBase::RegularizationParameter)->get(0, 0);
+  auto evaluated = golden.get<DenseMatrix>(TikhonovAlgoAbstractBase::LambdaArray);
+
+  EXPECT_LT(evaluated->nrows(), 200);
+  EXPECT_NEAR(std::log10(gridLambda), std::log10(goldenLambda), 0.5);
+}
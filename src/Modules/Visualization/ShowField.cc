@@ -29,9 +29,11 @@ DEALINGS IN THE SOFTWARE.
 #include <Modules/Visualization/ShowField.h>
 #include <Core/Datatypes/Geometry.h>
 #include <Core/Algorithms/Visualization/RenderFieldState.h>
+#include <Core/Algorithms/Visualization/ClusterSimplification.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Thread/Parallel.h>
 #include <Core/Datatypes/Color.h>
 #include <Core/Datatypes/ColorMap.h>
 #include <Core/GeometryPrimitives/Vector.h>
@@ -54,6 +56,68 @@ ALGORITHM_PARAMETER_DEF(Visualization, CylinderRadius);
 
 MODULE_INFO_DEF(ShowField, Visualization, SCIRun)
 
+namespace
+{
+  // Shared vertex faces with at least this many triangles also get simplified
+  // levels of detail, on clustering grids from the finest to the coarsest
+  // resolution. A level is drawn while its grid cells project to at most
+  // PixelsPerClusterCell pixels.
+  const size_t MinTrianglesForLevelsOfDetail = 100000;
+  const size_t FinestClusterResolution = 256;
+  const size_t CoarsestClusterResolution = 16;
+  const float PixelsPerClusterCell = 2.f;
+
+  // Hash of the nodes of one face. The hashes of all faces are summed, so the
+  // total does not depend on how the faces were split over threads.
+  uint64_t faceConnectivityHash(size_t face, const VMesh::Node::array_type& nodes)
+  {
+    uint64_t hash = face;
+    for (auto node : nodes)
+    {
+      hash = (hash ^ static_cast<uint64_t>(node)) * 0x100000001b3ULL;
+      hash ^= hash >> 29;
+    }
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    return hash ^ (hash >> 31);
+  }
+
+  // Area weighted average of the normals of the triangles around each vertex,
+  // which shades the surface smoothly. Vertex v sits at node vertexNodes[v],
+  // or at node v when vertexNodes is null.
+  std::vector<float> smoothVertexNormals(const std::vector<float>& positions, const uint32_t* vertexNodes,
+    size_t numVertices, const std::vector<uint32_t>& indices, float sign)
+  {
+    auto point = [&](uint32_t v)
+    {
+      const size_t n = vertexNodes ? vertexNodes[v] : v;
+      return Point(positions[3 * n], positions[3 * n + 1], positions[3 * n + 2]);
+    };
+    std::vector<Vector> sums(numVertices, Vector(0, 0, 0));
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+      Point p0 = point(indices[i]);
+      Vector norm = Cross(point(indices[i + 1]) - p0, point(indices[i + 2]) - p0);
+      sums[indices[i]] += norm;
+      sums[indices[i + 1]] += norm;
+      sums[indices[i + 2]] += norm;
+    }
+
+    std::vector<float> normals(3 * numVertices);
+    Parallel::For(0, numVertices, [&](size_t first, size_t last)
+    {
+      for (size_t v = first; v < last; ++v)
+      {
+        Vector norm = sums[v];
+        norm.safe_normalize();
+        normals[3 * v] = sign * static_cast<float>(norm.x());
+        normals[3 * v + 1] = sign * static_cast<float>(norm.y());
+        normals[3 * v + 2] = sign * static_cast<float>(norm.z());
+      }
+    });
+    return normals;
+  }
+}
+
 namespace SCIRun {
   namespace Modules {
     namespace Visualization {
@@ -64,12 +128,16 @@ class GeometryBuilder
 public:
   GeometryBuilder(const std::string& moduleId, ModuleStateHandle state) : moduleId_(moduleId), state_(state) {}
   /// Constructs a geometry object (essentially a spire object) from the given
-  /// field data.
+  /// field data. A preview only holds the coarsest level of detail of shared
+  /// vertex faces, clustered before anything else of the faces is built, and
+  /// is empty unless the faces are large enough for levels of detail and not
+  /// built yet.
   GeometryHandle buildGeometryObject(
     FieldHandle field,
     boost::optional<ColorMapHandle> colorMap,
     const GeometryIDGenerator& gid,
-    Interruptible* interruptible);
+    Interruptible* interruptible,
+    bool preview = false);
 
   /// Mesh construction. Any of the functions below can modify the renderState.
   /// This modified render state will be passed onto the renderer.
@@ -96,6 +164,30 @@ public:
     unsigned int approxDiv,
     const std::string& id);
 
+  /// Draws the faces from one vertex per mesh node and an index buffer. Only
+  /// used for uniform or node based coloring, since those give every corner
+  /// of a node the same color. Large meshes also get a pass for each level of
+  /// detail, and the renderer picks one by the size of the mesh on screen.
+  void renderFacesShared(
+    FieldHandle field,
+    boost::optional<ColorMapHandle> colorMap,
+    Interruptible* interruptible,
+    RenderState state, GeometryHandle geom,
+    ColorScheme colorScheme,
+    const std::string& id);
+
+  void addFacePass(
+    GeometryHandle geom,
+    const std::string& id,
+    std::shared_ptr<spire::VarBuffer> vboBuffer,
+    std::shared_ptr<spire::VarBuffer> iboBuffer,
+    int64_t numVBOElements,
+    const BBox& bbox,
+    bool withNormals,
+    bool invertNormals,
+    ColorScheme colorScheme,
+    const RenderState& state);
+
   void addFaceGeom(
     const std::vector<Point>  &points,
     const std::vector<Vector> &normals,
@@ -119,6 +211,45 @@ public:
   RenderState getEdgeRenderState(boost::optional<ColorMapHandle> colorMap);
   RenderState getFaceRenderState(boost::optional<ColorMapHandle> colorMap);
 private:
+  /// A simplified copy of the shared vertex faces, drawn with the colors of
+  /// the nodes that represent its vertex clusters.
+  struct SharedFaceLevel
+  {
+    size_t resolution = 0;
+    std::vector<uint32_t> nodes; ///< Mesh node of each vertex of the level.
+    std::shared_ptr<spire::VarBuffer> ibo;
+  };
+
+  /// Positions, normals and indices of the shared vertex faces. They only
+  /// depend on the mesh, so a new colormap or new data on the same mesh just
+  /// recomputes the colors. A preview stops after the triangles; the index
+  /// buffer, the levels and the normals are added for the full geometry.
+  struct SharedFaceGeometry
+  {
+    boost::weak_ptr<Mesh> mesh;
+    bool withNormals = false;
+    bool useMeshNormals = false;
+    bool invertNormals = false;
+    size_t numNodes = 0;
+    size_t numFaces = 0;
+    uint64_t connectivity = 0; ///< Sum of faceConnectivityHash over the faces.
+    BBox bbox;
+    std::vector<float> positions;
+    std::vector<uint32_t> triangles; ///< Only kept until ibo is made from them.
+    std::vector<float> normals;
+    std::shared_ptr<spire::VarBuffer> ibo; ///< Null until the full geometry is built.
+    std::vector<SharedFaceLevel> levels; ///< Finest to coarsest.
+  };
+
+  void buildSharedFaceTriangles(VMesh* mesh, Interruptible* interruptible);
+  void finishSharedFaceGeometry(VMesh* mesh, Interruptible* interruptible);
+  /// Meshes can be edited in place, so the same mesh pointer is not enough:
+  /// the node and face counts, the node positions and the nodes of every
+  /// face must match as well.
+  bool sharedFaceGeometryMatches(VMesh* mesh) const;
+
+  SharedFaceGeometry sharedFaces_;
+  bool previewOnly_ = false;
   float faceTransparencyValue_ = 0.65f;
   float edgeTransparencyValue_ = 0.65f;
   float nodeTransparencyValue_ = 0.65f;
@@ -184,6 +315,7 @@ void ShowField::setStateDefaults()
 
   state->setValue(UseFaceNormals, false);
   state->setValue(FaceInvertNormals, false);
+  state->setValue(ShareFaceVertices, false);
 
   state->setValue(FieldName, std::string());
 
@@ -219,6 +351,11 @@ void ShowField::execute()
   if (needToExecute())
   {
     updateAvailableRenderOptions(field);
+    // With Share Vertices on, a coarse version of a large mesh goes out
+    // first; the full object replaces it in the viewer once it is built.
+    auto preview = builder_->buildGeometryObject(field, colorMap, *this, this, true);
+    if (!preview->passes().empty())
+      sendOutput(SceneGraph, preview);
     auto geom = builder_->buildGeometryObject(field, colorMap, *this, this);
     sendOutput(SceneGraph, geom);
   }
@@ -344,7 +481,8 @@ RenderState GeometryBuilder::getFaceRenderState(boost::optional<boost::shared_pt
 GeometryHandle GeometryBuilder::buildGeometryObject(
   FieldHandle field,
   boost::optional<boost::shared_ptr<ColorMap>> colorMap,
-  const GeometryIDGenerator& gid, Interruptible* interruptible)
+  const GeometryIDGenerator& gid, Interruptible* interruptible,
+  bool preview)
 {
   // Function for reporting progress. TODO: use this variable somewhere!
   //auto progressFunc = getUpdaterFunc();
@@ -363,6 +501,13 @@ GeometryHandle GeometryBuilder::buildGeometryObject(
 
   auto geom(boost::make_shared<GeometryObjectSpire>(gid, idname, true));
 
+  previewOnly_ = preview;
+  if (preview)
+  {
+    showNodes = showEdges = false;
+    showFaces = showFaces && state_->getValue(ShowField::ShareFaceVertices).toBool();
+  }
+
   /// \todo Implement inputs_changes_ ? See old scirun ShowField.cc:293.
 
   /// \todo Mind material properties (simple since we already have implemented
@@ -423,7 +568,7 @@ void GeometryBuilder::renderFaces(
   {
     return renderFacesLinear(field, colorMap, interruptible, state, geom, approxDiv, id);
   }
-  else
+  else if (!previewOnly_)
   {
     std::cout << "Non linear faces not supported at this time." << std::endl;
   }
@@ -474,6 +619,15 @@ void GeometryBuilder::renderFacesLinear(
     colorScheme = ColorScheme::COLOR_IN_SITU;
   }
 
+  if (state_->getValue(ShowField::ShareFaceVertices).toBool() &&
+      (colorScheme == ColorScheme::COLOR_UNIFORM ||
+      (colorScheme == ColorScheme::COLOR_MAP && fld->basis_order() == 1)))
+  {
+    return renderFacesShared(field, colorMap, interruptible, state, geom, colorScheme, id);
+  }
+  if (previewOnly_)
+    return;
+
   // Three 32 bit ints to index into the VBO
   uint32_t iboSize = static_cast<uint32_t>(mesh->num_faces() * sizeof(uint32_t) * 3);
   //Seven floats per VBO: Pos (3) XYZ, and Color (4) RGBA
@@ -724,6 +878,22 @@ void GeometryBuilder::renderFacesLinear(
     ++numVBOElements;
   }
 
+  addFacePass(geom, id, vboBufferSPtr, iboBufferSPtr, numVBOElements, mesh->get_bounding_box(),
+    withNormals, invertNormals, colorScheme, state);
+}
+
+void GeometryBuilder::addFacePass(
+  GeometryHandle geom,
+  const std::string& id,
+  std::shared_ptr<spire::VarBuffer> vboBufferSPtr,
+  std::shared_ptr<spire::VarBuffer> iboBufferSPtr,
+  int64_t numVBOElements,
+  const BBox& bbox,
+  bool withNormals,
+  bool invertNormals,
+  ColorScheme colorScheme,
+  const RenderState& state)
+{
   std::stringstream ss;
   ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_;
 
@@ -856,7 +1026,7 @@ void GeometryBuilder::renderFacesLinear(
   }
 
   SpireVBO geomVBO(vboName, attribs, vboBufferSPtr,
-    numVBOElements, mesh->get_bounding_box(), true);
+    numVBOElements, bbox, true);
 
   geom->vbos().push_back(geomVBO);
 
@@ -880,6 +1050,347 @@ void GeometryBuilder::renderFacesLinear(
   ///       build up to geometry / tessellation shaders if support is present.
 }
 
+void GeometryBuilder::renderFacesShared(
+  FieldHandle field,
+  boost::optional<ColorMapHandle> colorMap,
+  Interruptible* interruptible,
+  RenderState state,
+  GeometryHandle geom,
+  ColorScheme colorScheme,
+  const std::string& id)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
+
+  bool withNormals = state.get(RenderState::USE_NORMALS);
+  bool useMeshNormals = withNormals && state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
+  bool invertNormals = state_->getValue(ShowField::FaceInvertNormals).toBool();
+
+  auto& shared = sharedFaces_;
+  if (shared.mesh.lock() != field->mesh() || shared.withNormals != withNormals ||
+      shared.useMeshNormals != useMeshNormals || shared.invertNormals != invertNormals ||
+      !sharedFaceGeometryMatches(mesh))
+  {
+    shared = SharedFaceGeometry();
+    shared.withNormals = withNormals;
+    shared.useMeshNormals = useMeshNormals;
+    shared.invertNormals = invertNormals;
+    buildSharedFaceTriangles(mesh, interruptible);
+    shared.mesh = field->mesh();
+  }
+
+  // Only worth previewing when the full geometry is still to come and large
+  // enough to get levels of detail.
+  if (previewOnly_)
+  {
+    if (shared.ibo || shared.triangles.size() / 3 < MinTrianglesForLevelsOfDetail)
+      return;
+  }
+  else if (!shared.ibo)
+  {
+    finishSharedFaceGeometry(mesh, interruptible);
+  }
+
+  const bool withColors = colorScheme == ColorScheme::COLOR_MAP;
+  const size_t stride = 3 + (withNormals ? 3 : 0) + (withColors ? 4 : 0);
+  ColorMapHandle map = withColors ? colorMap.get() : ColorMapHandle();
+
+  // Vertex v sits at node nodes[v], or at node v when nodes is null; its
+  // normal is normals[3 * v].
+  auto writeVertices = [&](const uint32_t* nodes, size_t numVertices, const std::vector<float>& normals,
+    std::vector<float>& vertices)
+  {
+    vertices.resize(numVertices * stride);
+    Parallel::For(0, numVertices, [&](size_t first, size_t last)
+    {
+      double sval;
+      Vector vval;
+      Tensor tval;
+      for (size_t v = first; v < last; ++v)
+      {
+        const size_t n = nodes ? nodes[v] : v;
+        float* vertex = &vertices[v * stride];
+        std::copy_n(&shared.positions[3 * n], 3, vertex);
+        vertex += 3;
+        if (withNormals)
+        {
+          std::copy_n(&normals[3 * v], 3, vertex);
+          vertex += 3;
+        }
+        if (withColors)
+        {
+          VMesh::Node::index_type node(static_cast<VMesh::index_type>(n));
+          ColorRGB color;
+          if (fld->is_scalar())
+          {
+            fld->get_value(sval, node);
+            color = map->valueToColor(sval);
+          }
+          else if (fld->is_vector())
+          {
+            fld->get_value(vval, node);
+            color = map->valueToColor(vval);
+          }
+          else if (fld->is_tensor())
+          {
+            fld->get_value(tval, node);
+            color = map->valueToColor(tval);
+          }
+          vertex[0] = static_cast<float>(color.r());
+          vertex[1] = static_cast<float>(color.g());
+          vertex[2] = static_cast<float>(color.b());
+          vertex[3] = 1.f;
+        }
+      }
+    });
+    interruptible->checkForInterruption();
+  };
+
+  auto makeVBO = [](const std::vector<float>& vertices)
+  {
+    std::shared_ptr<spire::VarBuffer> vbo(
+      new spire::VarBuffer(static_cast<uint32_t>(vertices.size() * sizeof(float))));
+    vbo->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+    return vbo;
+  };
+
+  std::vector<float> vertices;
+  if (previewOnly_)
+  {
+    // Just the coarsest level, clustered straight from the triangles
+    auto levels = buildClusterLevels(shared.positions.data(), shared.numNodes,
+      shared.triangles.data(), shared.triangles.size(), CoarsestClusterResolution, CoarsestClusterResolution);
+    interruptible->checkForInterruption();
+    if (levels.empty())
+      return;
+    const auto& coarsest = levels.front();
+
+    std::vector<float> normals;
+    if (withNormals)
+    {
+      const float sign = invertNormals ? -1.f : 1.f;
+      if (useMeshNormals)
+      {
+        normals.resize(3 * coarsest.vertices.size());
+        Vector norm;
+        for (size_t v = 0; v < coarsest.vertices.size(); ++v)
+        {
+          mesh->get_normal(norm, VMesh::Node::index_type(static_cast<VMesh::index_type>(coarsest.vertices[v])));
+          normals[3 * v] = sign * static_cast<float>(norm.x());
+          normals[3 * v + 1] = sign * static_cast<float>(norm.y());
+          normals[3 * v + 2] = sign * static_cast<float>(norm.z());
+        }
+      }
+      else
+      {
+        normals = smoothVertexNormals(shared.positions, coarsest.vertices.data(), coarsest.vertices.size(),
+          coarsest.indices, sign);
+      }
+    }
+
+    writeVertices(coarsest.vertices.data(), coarsest.vertices.size(), normals, vertices);
+    std::shared_ptr<spire::VarBuffer> ibo(
+      new spire::VarBuffer(static_cast<uint32_t>(coarsest.indices.size() * sizeof(uint32_t))));
+    ibo->writeBytes(reinterpret_cast<const char*>(coarsest.indices.data()), coarsest.indices.size() * sizeof(uint32_t));
+    addFacePass(geom, id + "LOD", makeVBO(vertices), ibo, static_cast<int64_t>(coarsest.vertices.size()),
+      shared.bbox, withNormals, invertNormals, colorScheme, state);
+    return;
+  }
+
+  writeVertices(nullptr, shared.numNodes, shared.normals, vertices);
+  addFacePass(geom, id, makeVBO(vertices), shared.ibo, static_cast<int64_t>(shared.numNodes), shared.bbox,
+    withNormals, invertNormals, colorScheme, state);
+  if (shared.levels.empty())
+    return;
+  geom->passes().back().lodMinSize = PixelsPerClusterCell * shared.levels.front().resolution;
+
+  // The levels reuse the vertices of the nodes that represent their clusters.
+  for (size_t i = 0; i < shared.levels.size(); ++i)
+  {
+    const auto& level = shared.levels[i];
+    std::vector<float> levelVertices(level.nodes.size() * stride);
+    Parallel::For(0, level.nodes.size(), [&](size_t first, size_t last)
+    {
+      for (size_t v = first; v < last; ++v)
+        std::copy_n(&vertices[level.nodes[v] * stride], stride, &levelVertices[v * stride]);
+    });
+
+    std::ostringstream levelID;
+    levelID << id << "LOD" << i;
+    addFacePass(geom, levelID.str(), makeVBO(levelVertices), level.ibo, static_cast<int64_t>(level.nodes.size()),
+      shared.bbox, withNormals, invertNormals, colorScheme, state);
+    auto& pass = geom->passes().back();
+    pass.lodMaxSize = PixelsPerClusterCell * level.resolution;
+    if (i + 1 < shared.levels.size())
+      pass.lodMinSize = PixelsPerClusterCell * shared.levels[i + 1].resolution;
+  }
+}
+
+bool GeometryBuilder::sharedFaceGeometryMatches(VMesh* mesh) const
+{
+  const auto& shared = sharedFaces_;
+  VMesh::Face::size_type numFaces;
+  mesh->size(numFaces);
+  if (shared.numNodes != static_cast<size_t>(mesh->num_nodes()) || shared.numFaces != static_cast<size_t>(numFaces))
+    return false;
+
+  const bool samePositions = Parallel::Reduce(size_t(0), shared.numNodes, true, [&](size_t first, size_t last, bool same)
+  {
+    Point p;
+    for (size_t n = first; n < last && same; ++n)
+    {
+      mesh->get_point(p, VMesh::Node::index_type(static_cast<VMesh::index_type>(n)));
+      same = shared.positions[3 * n] == static_cast<float>(p.x()) &&
+        shared.positions[3 * n + 1] == static_cast<float>(p.y()) &&
+        shared.positions[3 * n + 2] == static_cast<float>(p.z());
+    }
+    return same;
+  }, [](bool lhs, bool rhs) { return lhs && rhs; });
+  if (!samePositions)
+    return false;
+
+  const auto connectivity = Parallel::Reduce(size_t(0), shared.numFaces, uint64_t(0), [&](size_t first, size_t last, uint64_t hash)
+  {
+    VMesh::Node::array_type nodes;
+    for (size_t f = first; f < last; ++f)
+    {
+      mesh->get_nodes(nodes, VMesh::Face::index_type(static_cast<VMesh::index_type>(f)));
+      hash += faceConnectivityHash(f, nodes);
+    }
+    return hash;
+  }, [](uint64_t lhs, uint64_t rhs) { return lhs + rhs; });
+  return connectivity == shared.connectivity;
+}
+
+void GeometryBuilder::buildSharedFaceTriangles(VMesh* mesh, Interruptible* interruptible)
+{
+  auto& shared = sharedFaces_;
+
+  VMesh::Face::size_type numFaces;
+  mesh->size(numFaces);
+  shared.numNodes = static_cast<size_t>(mesh->num_nodes());
+  shared.numFaces = static_cast<size_t>(numFaces);
+  shared.bbox = mesh->get_bounding_box();
+  if (shared.useMeshNormals) { mesh->synchronize(Mesh::NORMALS_E); }
+
+  shared.positions.resize(3 * shared.numNodes);
+  Parallel::For(0, shared.numNodes, [&](size_t first, size_t last)
+  {
+    Point p;
+    for (size_t n = first; n < last; ++n)
+    {
+      mesh->get_point(p, VMesh::Node::index_type(static_cast<VMesh::index_type>(n)));
+      shared.positions[3 * n] = static_cast<float>(p.x());
+      shared.positions[3 * n + 1] = static_cast<float>(p.y());
+      shared.positions[3 * n + 2] = static_cast<float>(p.z());
+    }
+  });
+  interruptible->checkForInterruption();
+
+  // Every chunk of faces triangulates into its own index list; the lists are
+  // joined in face order afterwards, so the result is the same as a serial walk.
+  const auto chunks = Parallel::Partition(0, static_cast<size_t>(numFaces));
+  std::vector<std::vector<uint32_t>> chunkIndices(chunks.size());
+  std::vector<uint64_t> chunkConnectivity(chunks.size(), 0);
+  Parallel::For(0, chunks.size(), [&](size_t firstChunk, size_t lastChunk)
+  {
+    VMesh::Node::array_type nodes;
+    for (size_t c = firstChunk; c < lastChunk; ++c)
+    {
+      auto& indices = chunkIndices[c];
+      indices.reserve(3 * (chunks[c].second - chunks[c].first));
+      for (size_t f = chunks[c].first; f < chunks[c].second; ++f)
+      {
+        mesh->get_nodes(nodes, VMesh::Face::index_type(static_cast<VMesh::index_type>(f)));
+        chunkConnectivity[c] += faceConnectivityHash(f, nodes);
+        if (nodes.size() == 4)
+        {
+          const uint32_t quad[] = { 0, 1, 2, 2, 3, 0 };
+          for (auto corner : quad)
+            indices.push_back(static_cast<uint32_t>(nodes[corner]));
+        }
+        else
+        {
+          for (size_t i = 2; i < nodes.size(); ++i)
+          {
+            indices.push_back(static_cast<uint32_t>(nodes[0]));
+            indices.push_back(static_cast<uint32_t>(nodes[i - 1]));
+            indices.push_back(static_cast<uint32_t>(nodes[i]));
+          }
+        }
+      }
+    }
+  }, 1);
+  interruptible->checkForInterruption();
+
+  for (auto hash : chunkConnectivity)
+    shared.connectivity += hash;
+
+  size_t numIndices = 0;
+  for (const auto& indices : chunkIndices)
+    numIndices += indices.size();
+  shared.triangles.reserve(numIndices);
+  for (auto& indices : chunkIndices)
+  {
+    shared.triangles.insert(shared.triangles.end(), indices.begin(), indices.end());
+    std::vector<uint32_t>().swap(indices);
+  }
+}
+
+void GeometryBuilder::finishSharedFaceGeometry(VMesh* mesh, Interruptible* interruptible)
+{
+  auto& shared = sharedFaces_;
+  shared.levels.clear();
+
+  const size_t numIndices = shared.triangles.size();
+  if (numIndices / 3 >= MinTrianglesForLevelsOfDetail)
+  {
+    auto levels = buildClusterLevels(shared.positions.data(), shared.numNodes,
+      shared.triangles.data(), numIndices, FinestClusterResolution, CoarsestClusterResolution);
+    for (auto& level : levels)
+    {
+      SharedFaceLevel faceLevel;
+      faceLevel.resolution = level.resolution;
+      faceLevel.nodes = std::move(level.vertices);
+      faceLevel.ibo.reset(new spire::VarBuffer(static_cast<uint32_t>(level.indices.size() * sizeof(uint32_t))));
+      faceLevel.ibo->writeBytes(reinterpret_cast<const char*>(level.indices.data()),
+        level.indices.size() * sizeof(uint32_t));
+      shared.levels.push_back(std::move(faceLevel));
+    }
+    interruptible->checkForInterruption();
+  }
+
+  if (shared.withNormals)
+  {
+    const float sign = shared.invertNormals ? -1.f : 1.f;
+    if (shared.useMeshNormals)
+    {
+      shared.normals.resize(3 * shared.numNodes);
+      Parallel::For(0, shared.numNodes, [&](size_t first, size_t last)
+      {
+        Vector norm;
+        for (size_t n = first; n < last; ++n)
+        {
+          mesh->get_normal(norm, VMesh::Node::index_type(static_cast<VMesh::index_type>(n)));
+          shared.normals[3 * n] = sign * static_cast<float>(norm.x());
+          shared.normals[3 * n + 1] = sign * static_cast<float>(norm.y());
+          shared.normals[3 * n + 2] = sign * static_cast<float>(norm.z());
+        }
+      });
+    }
+    else
+    {
+      shared.normals = smoothVertexNormals(shared.positions, nullptr, shared.numNodes, shared.triangles, sign);
+    }
+  }
+
+  // Set last: an interrupted build is finished again by the next execution.
+  shared.ibo.reset(new spire::VarBuffer(static_cast<uint32_t>(numIndices * sizeof(uint32_t))));
+  if (numIndices > 0)
+    shared.ibo->writeBytes(reinterpret_cast<const char*>(shared.triangles.data()), numIndices * sizeof(uint32_t));
+  std::vector<uint32_t>().swap(shared.triangles);
+}
+
 // This function needs to be reorganized.
 // The fact that we are only rendering triangles helps us dramatically and
 // we get rid of the quads renderer pointers. Additionally, we can re-order
@@ -1498,3 +2009,4 @@ const AlgorithmParameterName ShowField::TextSize("TextSize");
 const AlgorithmParameterName ShowField::TextPrecision("TextPrecision");
 const AlgorithmParameterName ShowField::TextColoring("TextColoring");
 const AlgorithmParameterName ShowField::UseFaceNormals("UseFaceNormals");
+const AlgorithmParameterName ShowField::ShareFaceVertices("ShareFaceVertices");
@@ -104,6 +104,7 @@ namespace SCIRun {
         static const Core::Algorithms::AlgorithmParameterName TextPrecision;
         static const Core::Algorithms::AlgorithmParameterName TextColoring;
         static const Core::Algorithms::AlgorithmParameterName UseFaceNormals;
+        static const Core::Algorithms::AlgorithmParameterName ShareFaceVertices;
 
 
         INPUT_PORT(0, Field, Field);
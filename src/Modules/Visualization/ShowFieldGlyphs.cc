@@ -341,6 +341,9 @@ void GlyphBuilder::renderVectors(
   if (resolution < 3) resolution = 5;
 
   GlyphGeom glyphs;
+  // Opaque surface glyphs share one prototype mesh per shape; transparent ones stay
+  // tessellated so they can be depth sorted.
+  glyphs.setInstanced(!renState.get(RenderState::USE_TRANSPARENT_EDGES));
   auto facade(field->mesh()->getFacade());
 
   //Temporary fix for cloud field data until after IBBM
@@ -553,6 +556,7 @@ void GlyphBuilder::renderScalars(
   }
 
   GlyphGeom glyphs;
+  glyphs.setInstanced(!renState.get(RenderState::USE_TRANSPARENT_NODES));
   auto facade(field->mesh()->getFacade());
 
   bool done = false;
@@ -713,6 +717,7 @@ void GlyphBuilder::renderTensors(
   SpireIBO::PRIMITIVE primIn = SpireIBO::PRIMITIVE::TRIANGLES;;
 
   GlyphGeom glyphs;
+  glyphs.setInstanced(!renState.get(RenderState::USE_TRANSPARENCY));
   auto facade(field->mesh()->getFacade());
   // Render linear data
   if (finfo.is_linear())
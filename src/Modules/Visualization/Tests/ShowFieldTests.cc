@@ -33,6 +33,11 @@
 #include <Core/Utils/Exception.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
@@ -44,6 +49,8 @@ using namespace SCIRun::Modules::Visualization;
 using namespace SCIRun::Core;
 using namespace SCIRun;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Graphics::Datatypes;
 using ::testing::Values;
 using ::testing::Combine;
 using ::testing::Range;
@@ -128,3 +135,137 @@ TEST_F(ShowFieldStateGeometryNameSynchronizationTest, GeometryNameSynchronizesWi
   EXPECT_NE(hash1, addInputShouldBeDifferent);
   EXPECT_NE(inputChangeShouldBeDifferent, hash1);
 }
+
+class ShowFieldSharedFaceVerticesTest : public ModuleTest
+{
+protected:
+  virtual void SetUp()
+  {
+    LogSettings::Instance().setVerbose(false);
+    showField = makeModule("ShowField");
+    showField->setStateDefaults();
+    auto state = showField->get_state();
+    state->setValue(ShowField::ShareFaceVertices, true);
+    state->setValue(ShowField::ShowNodes, false);
+    state->setValue(ShowField::ShowEdges, false);
+    state->setValue(ShowField::FacesColoring, 1);
+
+    cube = CubeTriSurfLinearBasis(DOUBLE_E);
+    cube->vfield()->resize_values();
+    for (VMesh::index_type i = 0; i < cube->vfield()->num_values(); ++i)
+      cube->vfield()->set_value(static_cast<double>(i), i);
+    stubPortNWithThisData(showField, 0, cube);
+    stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Rainbow"));
+  }
+
+  GeometryObjectSpire& executeAndGetGeometry()
+  {
+    showField->execute();
+    geometry = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+    EXPECT_TRUE(geometry != nullptr);
+    EXPECT_EQ(1u, geometry->ibos().size());
+    EXPECT_EQ(1u, geometry->vbos().size());
+    return *geometry;
+  }
+
+  UseRealModuleStateFactory f;
+  ModuleHandle showField;
+  FieldHandle cube;
+  boost::shared_ptr<GeometryObjectSpire> geometry;
+};
+
+TEST_F(ShowFieldSharedFaceVerticesTest, OneVertexPerNodeAndThreeIndicesPerTriangle)
+{
+  auto& geom = executeAndGetGeometry();
+
+  EXPECT_EQ(cube->vmesh()->num_nodes(), geom.vbos().front().numElements);
+  EXPECT_EQ(3 * cube->vmesh()->num_faces() * sizeof(uint32_t), geom.ibos().front().data->getBufferSize());
+  auto indices = reinterpret_cast<const uint32_t*>(geom.ibos().front().data->getBuffer());
+  for (size_t i = 0; i < 3 * static_cast<size_t>(cube->vmesh()->num_faces()); ++i)
+    EXPECT_LT(indices[i], static_cast<uint32_t>(cube->vmesh()->num_nodes()));
+}
+
+TEST_F(ShowFieldSharedFaceVerticesTest, ColorMapChangeReusesIndexBuffer)
+{
+  auto ibo = executeAndGetGeometry().ibos().front().data;
+  auto vbo = geometry->vbos().front().data;
+
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale"));
+  auto& geom = executeAndGetGeometry();
+
+  EXPECT_EQ(ibo, geom.ibos().front().data);
+  EXPECT_NE(vbo, geom.vbos().front().data);
+}
+
+TEST_F(ShowFieldSharedFaceVerticesTest, MeshEditedInPlaceIsRebuilt)
+{
+  auto ibo = executeAndGetGeometry().ibos().front().data;
+
+  cube->vmesh()->set_point(Point(-3, 0, 0), VMesh::Node::index_type(0));
+  auto& geom = executeAndGetGeometry();
+
+  EXPECT_NE(ibo, geom.ibos().front().data);
+  auto firstVertex = reinterpret_cast<const float*>(geom.vbos().front().data->getBuffer());
+  EXPECT_EQ(-3.f, firstVertex[0]);
+}
+
+TEST_F(ShowFieldSharedFaceVerticesTest, MeshRewiredInPlaceIsRebuilt)
+{
+  auto ibo = executeAndGetGeometry().ibos().front().data;
+
+  // same counts and positions, but the first face now winds the other way
+  VMesh::Node::array_type nodes;
+  cube->vmesh()->get_nodes(nodes, VMesh::Face::index_type(0));
+  std::swap(nodes[1], nodes[2]);
+  cube->vmesh()->set_nodes(nodes, VMesh::Face::index_type(0));
+  auto& geom = executeAndGetGeometry();
+
+  EXPECT_NE(ibo, geom.ibos().front().data);
+  auto indices = reinterpret_cast<const uint32_t*>(geom.ibos().front().data->getBuffer());
+  EXPECT_EQ(static_cast<uint32_t>(nodes[1]), indices[1]);
+  EXPECT_EQ(static_cast<uint32_t>(nodes[2]), indices[2]);
+}
+
+TEST_F(ShowFieldSharedFaceVerticesTest, LargeMeshGetsLevelsOfDetail)
+{
+  // a wavy 241x241 height field has enough triangles for levels of detail
+  const int size = 241;
+  FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+  auto surface = CreateField(fi);
+  auto mesh = surface->vmesh();
+  for (int j = 0; j < size; ++j)
+    for (int i = 0; i < size; ++i)
+      mesh->add_point(Point(i, j, 4 * std::sin(0.1 * i) * std::cos(0.1 * j)));
+  VMesh::Node::array_type tri(3);
+  for (int j = 0; j + 1 < size; ++j)
+  {
+    for (int i = 0; i + 1 < size; ++i)
+    {
+      const VMesh::index_type n = i + size * j;
+      tri[0] = n; tri[1] = n + 1; tri[2] = n + size + 1;
+      mesh->add_elem(tri);
+      tri[0] = n; tri[1] = n + size + 1; tri[2] = n + size;
+      mesh->add_elem(tri);
+    }
+  }
+  surface->vfield()->resize_values();
+  stubPortNWithThisData(showField, 0, surface);
+
+  showField->execute();
+  auto geom = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(geom != nullptr);
+  ASSERT_GT(geom->passes().size(), 1u);
+  ASSERT_EQ(geom->passes().size(), geom->ibos().size());
+
+  // the full mesh is drawn when close, each coarser level further away
+  const std::vector<SpireSubPass> passes(geom->passes().begin(), geom->passes().end());
+  const std::vector<SpireIBO> ibos(geom->ibos().begin(), geom->ibos().end());
+  EXPECT_GT(passes.front().lodMinSize, 0.f);
+  EXPECT_EQ(2u * (size - 1) * (size - 1) * 3 * sizeof(uint32_t), ibos.front().data->getBufferSize());
+  for (size_t i = 1; i < passes.size(); ++i)
+  {
+    EXPECT_EQ(passes[i - 1].lodMinSize, passes[i].lodMaxSize);
+    EXPECT_LE(2 * ibos[i].data->getBufferSize(), ibos[i - 1].data->getBufferSize());
+  }
+  EXPECT_EQ(0.f, passes.back().lodMinSize);
+}
@@ -84,7 +84,7 @@ private:
 class TestSimpleSource : public SimpleSource
 {
 public:
-  DatatypeHandle getDataForTesting() const { return data_; }
+  DatatypeHandle getDataForTesting() const { return cache_->get(); }
 };
 
 class MockAlgorithmFactory : public AlgorithmFactory